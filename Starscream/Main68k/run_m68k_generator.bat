@@ -1,5 +1,6 @@
 @rem Main 68000 compilation (Main68k\star.c has been compiled before)
 
 Release\MainStar.exe main68k.asm -hog -name main68k_
+Release\MainStar.exe main68kc.cpp -cpp -name main68kc_
 
 @pause
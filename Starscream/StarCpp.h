@@ -0,0 +1,1983 @@
+/*
+** Starscream 680x0 emulation library - C++ output runtime
+**
+** The sources generated with the -cpp option (see STARDOC.TXT) define
+** STAR_ID, STAR_SUB68K and the memory functions, include this file, then
+** define one function per opcode routine which calls one of the templates
+** below with the same cycle counts as the assembly version, and finally
+** star_buildtable().
+**
+** This follows the assembly output instruction for instruction, including
+** the x86 behaviours it depends on (shift/rotate counts of 32 and more,
+** DAA/DAS, the order of memory accesses and the airlock fields), so the two
+** can be run side by side and compared.  68000 only.
+*/
+
+#include <stddef.h>
+#include <string.h>
+
+#include "../src/Star_68k.h"
+
+#ifndef STAR_HOOKS
+#define STAR_HOOKS 1
+#endif
+
+#ifndef STAR_SUB68K
+#define STAR_SUB68K 0
+#endif
+
+#define STAR_API extern "C"
+
+/* interrupts[0] bit set by STOP */
+#if STAR_SUB68K
+#define STAR_STOPPED 0x01
+#else
+#define STAR_STOPPED 0x10
+#endif
+
+/* Effective address modes, same order as in Star.c */
+enum {
+	EA_DREG, EA_AREG, EA_AIND, EA_AINC, EA_ADEC, EA_ADSP,
+	EA_AXDP, EA_ABSW, EA_ABSL, EA_PCDP, EA_PCXD, EA_IMMD
+};
+
+/* ALU operations */
+enum { OP_ADD, OP_SUB, OP_CMP, OP_AND, OP_OR, OP_EOR };
+
+/* Shift/rotate kinds of the lsx/asx/rox/rxx routines */
+enum { SH_LS, SH_AS, SH_RO, SH_RX };
+
+/* Bit operations, in the order of main_cc in the bitop routines */
+enum { BIT_TST, BIT_CHG, BIT_CLR, BIT_SET };
+
+/* What the exec loop does after an instruction */
+enum { STAR_FLOW_NEXT, STAR_FLOW_CHECKPOINT, STAR_FLOW_EXIT };
+
+#define STAR_MASK(s)	((s) == 1 ? 0xFFu : (s) == 2 ? 0xFFFFu : 0xFFFFFFFFu)
+#define STAR_MSB(s)	((s) * 8 - 1)
+#define STAR_R(r)	((r) < 0 ? (int)(star_op & 7) : (r))
+
+S68000CONTEXT STAR_ID(context);
+#define star_ctx STAR_ID(context)
+
+struct star_tableentry {
+	void (*handler)(void);
+	unsigned count;
+};
+
+static void (*star_jmptbl[0x10000])(void);
+
+/*
+** What the assembly keeps in registers: the opcode (bx), the based PC (esi),
+** the fetch base (ebp), the cycle counter (edi) and the flags (ah/al).
+** X stays in the context, as in the assembly.
+*/
+static unsigned star_op;
+static size_t star_pc, star_base;
+static int star_cycles;
+static unsigned star_n, star_z, star_v, star_c;
+static int star_flow;
+static unsigned star_exitcode;
+
+static void star_buildtable(void);
+
+/***************************************************************************/
+/*
+** Registers, flags and SR
+*/
+
+static inline unsigned &star_reg(int n)
+{
+	return n < 8 ? star_ctx.dreg[n] : star_ctx.areg[n - 8];
+}
+
+#define star_a7 star_ctx.areg[7]
+
+static inline unsigned star_getpc(void)
+{
+	return (unsigned)(star_pc - star_base);
+}
+
+static inline unsigned star_fetch16(void)
+{
+	unsigned w = *(unsigned short *)star_pc;
+	star_pc += 2;
+	return w;
+}
+
+static inline unsigned star_fetch32(void)
+{
+	unsigned l = *(unsigned short *)star_pc << 16;
+	l |= *(unsigned short *)(star_pc + 2);
+	star_pc += 4;
+	return l;
+}
+
+static inline unsigned star_ccr2cl(void)
+{
+	return (star_ctx.xflag << 4) | (star_n << 3) | (star_z << 2) | (star_v << 1) | star_c;
+}
+
+static inline void star_cl2ccr(unsigned cl)
+{
+	star_ctx.xflag = (cl >> 4) & 1;
+	star_n = (cl >> 3) & 1;
+	star_z = (cl >> 2) & 1;
+	star_v = (cl >> 1) & 1;
+	star_c = cl & 1;
+}
+
+static inline void star_cache_ccr(void)
+{
+	star_cl2ccr(star_ctx.sr & 0xFF);
+}
+
+static inline void star_writeback_ccr(void)
+{
+	star_ctx.sr = (unsigned short)((star_ctx.sr & 0xFF00) | star_ccr2cl());
+}
+
+static inline unsigned star_sr2cx(void)
+{
+	return (star_ctx.sr & 0xFF00) | star_ccr2cl();
+}
+
+static void star_setmaps(int supervisor)
+{
+	if(supervisor) {
+		star_ctx.fetch = star_ctx.s_fetch;
+		star_ctx.readbyte = star_ctx.s_readbyte;
+		star_ctx.readword = star_ctx.s_readword;
+		star_ctx.writebyte = star_ctx.s_writebyte;
+		star_ctx.writeword = star_ctx.s_writeword;
+	} else {
+		star_ctx.fetch = star_ctx.u_fetch;
+		star_ctx.readbyte = star_ctx.u_readbyte;
+		star_ctx.readword = star_ctx.u_readword;
+		star_ctx.writebyte = star_ctx.u_writebyte;
+		star_ctx.writeword = star_ctx.u_writeword;
+	}
+}
+
+/* Switch between the user and supervisor stack pointers and memory maps */
+static void star_swapmaps(int supervisor)
+{
+	unsigned t = star_a7;
+	star_a7 = star_ctx.asp;
+	star_ctx.asp = t;
+	star_setmaps(supervisor);
+}
+
+/* Set SR from a word; like the assembly, the low byte of sr is not written */
+static void star_cx2sr(unsigned cx)
+{
+	if((cx ^ star_ctx.sr) & 0x2000)
+		star_swapmaps(cx & 0x2000);
+	star_ctx.sr = (unsigned short)((star_ctx.sr & 0x00FF) | (cx & 0xA700));
+	star_cl2ccr(cx & 0xFF);
+}
+
+static void star_supervisor(void)
+{
+	if(!(star_ctx.sr & 0x2000)) {
+		star_swapmaps(1);
+		star_ctx.sr |= 0x2000;
+	}
+}
+
+/* Conditions 2-F of Bcc/DBcc/Scc */
+static inline unsigned star_cond(int cc)
+{
+	switch(cc) {
+	case 0x2: return !star_c && !star_z;
+	case 0x3: return star_c || star_z;
+	case 0x4: return !star_c;
+	case 0x5: return star_c;
+	case 0x6: return !star_z;
+	case 0x7: return star_z;
+	case 0x8: return !star_v;
+	case 0x9: return star_v;
+	case 0xA: return !star_n;
+	case 0xB: return star_n;
+	case 0xC: return star_n == star_v;
+	case 0xD: return star_n != star_v;
+	case 0xE: return !star_z && star_n == star_v;
+	default:  return star_z || star_n != star_v;
+	}
+}
+
+template<int SIZE> static inline void star_flags_nz(unsigned r)
+{
+	star_n = (r >> STAR_MSB(SIZE)) & 1;
+	star_z = (r & STAR_MASK(SIZE)) == 0;
+}
+
+/* N and Z of the result, V and C cleared */
+template<int SIZE> static inline void star_flags_logic(unsigned r)
+{
+	star_flags_nz<SIZE>(r);
+	star_v = 0;
+	star_c = 0;
+}
+
+/* x86 adc and sbb: result and N, Z, V, C */
+template<int SIZE> static inline unsigned star_adc(unsigned d, unsigned s, unsigned x)
+{
+	unsigned long long t = (unsigned long long)(d & STAR_MASK(SIZE)) + (s & STAR_MASK(SIZE)) + x;
+	unsigned r = (unsigned)t & STAR_MASK(SIZE);
+	star_c = (unsigned)(t >> (SIZE * 8)) & 1;
+	star_v = ((~(d ^ s) & (d ^ r)) >> STAR_MSB(SIZE)) & 1;
+	star_flags_nz<SIZE>(r);
+	return r;
+}
+
+template<int SIZE> static inline unsigned star_sbb(unsigned d, unsigned s, unsigned x)
+{
+	unsigned r = (d - s - x) & STAR_MASK(SIZE);
+	star_c = (unsigned long long)(d & STAR_MASK(SIZE)) < (unsigned long long)(s & STAR_MASK(SIZE)) + x;
+	star_v = (((d ^ s) & (d ^ r)) >> STAR_MSB(SIZE)) & 1;
+	star_flags_nz<SIZE>(r);
+	return r;
+}
+
+template<int SIZE, int OP> static inline unsigned star_alu(unsigned d, unsigned s)
+{
+	switch(OP) {
+	case OP_ADD: return star_adc<SIZE>(d, s, 0);
+	case OP_SUB:
+	case OP_CMP: return star_sbb<SIZE>(d, s, 0);
+	case OP_AND: d &= s; break;
+	case OP_OR:  d |= s; break;
+	default:     d ^= s; break;
+	}
+	star_flags_logic<SIZE>(d);
+	return d;
+}
+
+/* Z after ADDX/SUBX/ABCD/SBCD/NEGX: cleared if nonzero, unchanged otherwise */
+static inline void star_adjzero(unsigned oldz)
+{
+	star_z &= oldz;
+}
+
+/* x86 DAA/DAS on al with the AF and CF of the preceding adc/sbb */
+static inline unsigned star_daa(unsigned al, unsigned af, unsigned cf)
+{
+	unsigned old = al, c = 0;
+	if((al & 0xF) > 9 || af) {
+		c = cf || al + 6 > 0xFF;
+		al = (al + 6) & 0xFF;
+	}
+	if(old > 0x99 || cf) {
+		al = (al + 0x60) & 0xFF;
+		c = 1;
+	} else {
+		c = 0;
+	}
+	star_c = c;
+	star_flags_nz<1>(al);
+	return al;
+}
+
+static inline unsigned star_das(unsigned al, unsigned af, unsigned cf)
+{
+	unsigned old = al, c = 0;
+	if((al & 0xF) > 9 || af) {
+		c = cf || al < 6;
+		al = (al - 6) & 0xFF;
+	}
+	if(old > 0x99 || cf) {
+		al = (al - 0x60) & 0xFF;
+		c = 1;
+	}
+	star_c = c;
+	star_flags_nz<1>(al);
+	return al;
+}
+
+/*
+** x86 shifts and rotates of a SIZE operand by count (1-31), with the carry
+** in and out in cf.  As on x86, RCL/RCR of a byte or word rotate by count
+** mod 9/17 and leave CF alone when that is 0.
+*/
+template<int SIZE> static unsigned star_x86_shift(int kind, int left, unsigned v, unsigned count, unsigned &cf)
+{
+	const unsigned bits = SIZE * 8;
+	unsigned long long t;
+	unsigned i, n;
+
+	v &= STAR_MASK(SIZE);
+	switch(kind) {
+	case SH_LS:
+	case SH_AS:
+		if(left) {
+			t = (unsigned long long)v << count;
+			cf = (unsigned)(t >> bits) & 1;
+			return (unsigned)t & STAR_MASK(SIZE);
+		}
+		if(kind == SH_AS) {
+			long long s = (long long)(v ^ (1u << (bits - 1))) - (1ll << (bits - 1));
+			cf = (unsigned)(s >> (count - 1)) & 1;
+			return (unsigned)(s >> count) & STAR_MASK(SIZE);
+		}
+		t = v;
+		cf = (unsigned)(t >> (count - 1)) & 1;
+		return (unsigned)(t >> count);
+	case SH_RO:
+		n = count % bits;
+		if(left) {
+			if(n) v = ((v << n) | (v >> (bits - n))) & STAR_MASK(SIZE);
+			cf = v & 1;
+		} else {
+			if(n) v = ((v >> n) | (v << (bits - n))) & STAR_MASK(SIZE);
+			cf = v >> (bits - 1);
+		}
+		return v;
+	default:
+		n = SIZE == 1 ? count % 9 : SIZE == 2 ? count % 17 : count;
+		for(i = 0; i < n; i++) {
+			unsigned out;
+			if(left) {
+				out = v >> (bits - 1);
+				v = ((v << 1) | cf) & STAR_MASK(SIZE);
+			} else {
+				out = v & 1;
+				v = (v >> 1) | (cf << (bits - 1));
+			}
+			cf = out;
+		}
+		return v;
+	}
+}
+
+/***************************************************************************/
+/*
+** Memory
+*/
+
+static inline void star_airlock_exit(void)
+{
+	star_ctx.io_cycle_counter = star_cycles;
+	star_ctx.io_fetchbase = (unsigned)star_base;
+	star_ctx.io_fetchbased_pc = (unsigned)star_pc;
+}
+
+static inline void star_airlock_enter(void)
+{
+	star_cycles = (int)star_ctx.io_cycle_counter;
+}
+
+#if STAR_HOOKS
+/* The main 68000 skips the hook calls while hook_enabled is 0 */
+#ifndef STAR_HOOK_ENABLED
+#define STAR_HOOK_ENABLED 1
+#endif
+
+static inline void star_hook_set(unsigned a, unsigned v)
+{
+	STAR_HOOK(hook_address) = a & 0xFFFFFF;
+	STAR_HOOK(hook_pc) = star_getpc() - 2;
+	STAR_HOOK(hook_value) = v;
+}
+#define STAR_HOOK_READ(f, a, v)		(STAR_HOOK_ENABLED ? (star_hook_set(a, v), STAR_HOOK(f)()) : (void)0)
+#if STAR_SUB68K
+#define STAR_HOOK_WRITE_PRE(a, v)
+#define STAR_HOOK_WRITE(f, a, v)	(star_hook_set(a, v), STAR_HOOK(f)())
+#else
+#define STAR_HOOK_WRITE_PRE(a, v)	star_hook_set(a, v)
+#define STAR_HOOK_WRITE(f, a, v)	(STAR_HOOK_ENABLED ? STAR_HOOK(f)() : (void)0)
+#endif
+#else
+#define STAR_HOOK_READ(f, a, v)
+#define STAR_HOOK_WRITE_PRE(a, v)
+#define STAR_HOOK_WRITE(f, a, v)
+#endif
+
+static unsigned star_readbyte(unsigned a)
+{
+	unsigned v;
+	star_ctx.access_address = a;
+	a &= 0xFFFFFF;
+#ifdef STAR_RAM
+	if(a >= 0xE00000) {
+		v = STAR_RAM[(a & 0xFFFF) ^ 1];
+	} else
+#endif
+#ifdef STAR_READ_PAGE
+	if(STAR_READ_PAGE[a >> 16]) {
+		v = STAR_READ_PAGE[a >> 16][(a & 0xFFFF) ^ 1];
+	} else
+#endif
+	{
+		star_airlock_exit();
+		v = (unsigned char)STAR_READ_BYTE(a);
+		star_airlock_enter();
+	}
+	STAR_HOOK_READ(hook_read_byte, a, v);
+	return v;
+}
+
+static unsigned star_readword(unsigned a)
+{
+	unsigned v;
+	star_ctx.access_address = a;
+	a &= 0xFFFFFF;
+#ifdef STAR_RAM
+	if(a >= 0xE00000) {
+		v = *(unsigned short *)&STAR_RAM[a & 0xFFFF];
+	} else
+#endif
+#ifdef STAR_READ_PAGE
+	if(STAR_READ_PAGE[a >> 16]) {
+		v = *(unsigned short *)&STAR_READ_PAGE[a >> 16][a & 0xFFFF];
+	} else
+#endif
+	{
+		star_airlock_exit();
+		v = (unsigned short)STAR_READ_WORD(a);
+		star_airlock_enter();
+	}
+	STAR_HOOK_READ(hook_read_word, a, v);
+	return v;
+}
+
+/* dec: the low word first, as -(An) does on the main 68000 */
+static unsigned star_readlong_io(unsigned a, int dec)
+{
+	unsigned v;
+	star_ctx.access_address = a;
+	a &= 0xFFFFFF;
+#ifdef STAR_RAM
+	if(a >= 0xE00000) {
+		v = *(unsigned short *)&STAR_RAM[a & 0xFFFF] << 16;
+		v |= *(unsigned short *)&STAR_RAM[(a + 2) & 0xFFFF];
+	} else
+#endif
+#ifdef STAR_READ_PAGE
+	/* both words in the same page */
+	if(STAR_READ_PAGE[a >> 16] && (a & 0xFFFF) <= 0xFFFC) {
+		v = *(unsigned short *)&STAR_READ_PAGE[a >> 16][a & 0xFFFF] << 16;
+		v |= *(unsigned short *)&STAR_READ_PAGE[a >> 16][(a + 2) & 0xFFFF];
+	} else
+#endif
+	{
+		star_airlock_exit();
+		if(dec) {
+			v = (unsigned short)STAR_READ_WORD(a + 2);
+			v |= (unsigned short)STAR_READ_WORD(a) << 16;
+		} else {
+			v = (unsigned short)STAR_READ_WORD(a) << 16;
+			v |= (unsigned short)STAR_READ_WORD(a + 2);
+		}
+		star_airlock_enter();
+	}
+	STAR_HOOK_READ(hook_read_dword, a, v);
+	return v;
+}
+
+static void star_writebyte(unsigned a, unsigned v)
+{
+	v &= 0xFF;
+	star_ctx.access_address = a;
+	a &= 0xFFFFFF;
+	STAR_HOOK_WRITE_PRE(a, v);
+#ifdef STAR_RAM
+	if(a >= 0xE00000) {
+		STAR_RAM[(a & 0xFFFF) ^ 1] = (unsigned char)v;
+	} else
+#endif
+	{
+		star_airlock_exit();
+		STAR_WRITE_BYTE(a, (unsigned char)v);
+		star_airlock_enter();
+	}
+	STAR_HOOK_WRITE(hook_write_byte, a, v);
+}
+
+static void star_writeword(unsigned a, unsigned v)
+{
+	v &= 0xFFFF;
+	star_ctx.access_address = a;
+	a &= 0xFFFFFF;
+	STAR_HOOK_WRITE_PRE(a, v);
+#ifdef STAR_RAM
+	if(a >= 0xE00000) {
+		*(unsigned short *)&STAR_RAM[a & 0xFFFF] = (unsigned short)v;
+	} else
+#endif
+	{
+		star_airlock_exit();
+		STAR_WRITE_WORD(a, (unsigned short)v);
+		star_airlock_enter();
+	}
+	STAR_HOOK_WRITE(hook_write_word, a, v);
+}
+
+/* dec: the low word first */
+static void star_writelong_io(unsigned a, unsigned v, int dec)
+{
+	star_ctx.access_address = a;
+	a &= 0xFFFFFF;
+	STAR_HOOK_WRITE_PRE(a, v);
+#ifdef STAR_RAM
+	if(a >= 0xE00000) {
+		*(unsigned short *)&STAR_RAM[a & 0xFFFF] = (unsigned short)(v >> 16);
+		*(unsigned short *)&STAR_RAM[(a + 2) & 0xFFFF] = (unsigned short)v;
+	} else
+#endif
+	{
+		star_airlock_exit();
+		if(dec) {
+			STAR_WRITE_WORD(a + 2, (unsigned short)v);
+			STAR_WRITE_WORD(a, (unsigned short)(v >> 16));
+		} else {
+			STAR_WRITE_WORD(a, (unsigned short)(v >> 16));
+			STAR_WRITE_WORD(a + 2, (unsigned short)v);
+		}
+		star_airlock_enter();
+	}
+	STAR_HOOK_WRITE(hook_write_dword, a, v);
+}
+
+/* The sub 68000 has no readmemorydec/writememorydec */
+#if STAR_SUB68K
+#define STAR_DEC 0
+#else
+#define STAR_DEC 1
+#endif
+
+template<int SIZE> static inline unsigned star_read(unsigned a, int dec)
+{
+	if(SIZE == 1) return star_readbyte(a);
+	if(SIZE == 2) return star_readword(a);
+	return star_readlong_io(a, dec & STAR_DEC);
+}
+
+template<int SIZE> static inline void star_write(unsigned a, unsigned v, int dec)
+{
+	if(SIZE == 1) star_writebyte(a, v);
+	else if(SIZE == 2) star_writeword(a, v);
+	else star_writelong_io(a, v, dec & STAR_DEC);
+}
+
+/***************************************************************************/
+/*
+** Effective addresses.  REG is the register of the mode, -1 for Op & 7.
+*/
+
+static unsigned star_decode_ext(void)
+{
+	unsigned ext = star_fetch16();
+	unsigned r = star_reg(ext >> 12);
+	if(!(ext & 0x800)) r = (unsigned)(short)r;
+	return r + (unsigned)(signed char)ext;
+}
+
+template<int SIZE, int EA, int REG> static inline unsigned star_ea_step(void)
+{
+	if(SIZE == 1 && STAR_R(REG) == 7) return 2;
+	return SIZE;
+}
+
+template<int SIZE, int EA, int REG> static unsigned star_precalc(void)
+{
+	unsigned a, pc;
+	switch(EA) {
+	case EA_AIND:
+	case EA_AINC: return star_ctx.areg[STAR_R(REG)];
+	case EA_ADEC: return star_ctx.areg[STAR_R(REG)] - star_ea_step<SIZE, EA, REG>();
+	case EA_ADSP:
+		a = star_ctx.areg[STAR_R(REG)];
+		return a + (unsigned)(short)star_fetch16();
+	case EA_AXDP:
+		a = star_ctx.areg[STAR_R(REG)];
+		return a + star_decode_ext();
+	case EA_ABSW: return (unsigned)(short)star_fetch16();
+	case EA_ABSL: return star_fetch32();
+	case EA_PCDP:
+		pc = star_getpc();
+		return pc + (unsigned)(short)star_fetch16();
+	case EA_PCXD:
+		pc = star_getpc();
+		return star_decode_ext() + pc;
+	default: return 0;
+	}
+}
+
+template<int SIZE, int EA, int REG> static inline void star_postcalc(unsigned a)
+{
+	if(EA == EA_AINC) star_ctx.areg[STAR_R(REG)] = a + star_ea_step<SIZE, EA, REG>();
+	else if(EA == EA_ADEC) star_ctx.areg[STAR_R(REG)] = a;
+}
+
+/* Registers give all 32 bits, immediates the word or long */
+template<int SIZE, int EA, int REG> static inline unsigned star_ea_read(unsigned a)
+{
+	switch(EA) {
+	case EA_DREG: return star_ctx.dreg[STAR_R(REG)];
+	case EA_AREG: return star_ctx.areg[STAR_R(REG)];
+	case EA_IMMD: return SIZE == 4 ? star_fetch32() : star_fetch16();
+	default: return star_read<SIZE>(a, EA == EA_ADEC);
+	}
+}
+
+template<int SIZE> static inline void star_dreg_store(unsigned &r, unsigned v)
+{
+	r = (r & ~STAR_MASK(SIZE)) | (v & STAR_MASK(SIZE));
+}
+
+template<int SIZE, int EA, int REG> static inline void star_ea_write(unsigned a, unsigned v)
+{
+	if(EA == EA_DREG) star_dreg_store<SIZE>(star_ctx.dreg[STAR_R(REG)], v);
+	else star_write<SIZE>(a, v, EA == EA_ADEC);
+}
+
+template<int SIZE, int EA, int REG> static inline unsigned star_load(void)
+{
+	unsigned a = star_precalc<SIZE, EA, REG>();
+	unsigned v = star_ea_read<SIZE, EA, REG>(a);
+	star_postcalc<SIZE, EA, REG>(a);
+	return v;
+}
+
+/* Word loads for MOVEA/ADDA/SUBA/CMPA.W, sign extended */
+template<int SIZE, int EA, int REG> static inline unsigned star_load_signed(void)
+{
+	unsigned v = star_load<SIZE, EA, REG>();
+	return SIZE == 2 ? (unsigned)(short)v : v;
+}
+
+template<int SIZE, int EA, int REG> static inline void star_store(unsigned v)
+{
+	unsigned a = star_precalc<SIZE, EA, REG>();
+	star_ea_write<SIZE, EA, REG>(a, v);
+	star_postcalc<SIZE, EA, REG>(a);
+}
+
+static inline void star_push_long(unsigned v)
+{
+	unsigned a = star_a7 - 4;
+	star_write<4>(a, v, 1);
+	star_a7 = a;
+}
+
+/***************************************************************************/
+/*
+** Program counter, exceptions and interrupts
+*/
+
+static void star_basefunction(unsigned pc)
+{
+	unsigned a = pc & 0xFFFFFF;
+	unsigned garbage = pc & 0xFF000000;
+	struct STARSCREAM_PROGRAMREGION *r;
+
+	for(r = star_ctx.fetch; ; r++) {
+		if(a >= r->lowaddr && a <= r->highaddr) {
+			star_ctx.fetch_region_start = r->lowaddr | garbage;
+			star_ctx.fetch_region_end = r->highaddr | garbage;
+			star_base = r->offset - garbage;
+			return;
+		}
+		if(r->lowaddr == 0xFFFFFFFF) break;
+	}
+	/* Out of range: force a context switch */
+	star_base = 0;
+	star_ctx.fetch_region_start = 0xFFFFFFFF;
+	star_ctx.fetch_region_end = 0;
+	star_cycles -= star_ctx.cycles_needed;
+	star_ctx.cycles_needed = 0;
+	star_ctx.execinfo |= 2;
+}
+
+static void star_cached_rebase(unsigned pc)
+{
+	if(pc < star_ctx.fetch_region_start || pc > star_ctx.fetch_region_end)
+		star_basefunction(pc);
+	star_pc = star_base + pc;
+}
+
+static void star_uncached_rebase(void)
+{
+	unsigned pc = star_getpc();
+	star_basefunction(pc);
+	star_pc = star_base + pc;
+}
+
+/* Group 1 and 2 exceptions: stacks PC and SR, returns the new PC */
+static unsigned star_exception(unsigned vector)
+{
+	unsigned newpc, oldsr, a;
+
+	star_ctx.interrupts[0] &= ~STAR_STOPPED;
+	newpc = star_read<4>(vector, 0);
+	oldsr = star_sr2cx();
+	star_supervisor();
+	star_ctx.sr &= 0x27FF;
+	star_ctx.trace_trickybit = 0;
+	a = star_a7 - 4;
+	star_write<4>(a, star_getpc(), 0);
+	a -= 2;
+	star_write<2>(a, oldsr, 0);
+	star_a7 = a;
+	return newpc;
+}
+
+static void star_privilege_violation(void)
+{
+	star_pc -= 2;
+	star_cached_rebase(star_exception(0x20));
+	star_cycles -= 34;
+}
+
+#define STAR_SUPERVISOR_ONLY \
+	if(!(star_ctx.sr & 0x2000)) { \
+		star_privilege_violation(); \
+		return; \
+	}
+
+static void star_invalidins(void)
+{
+	star_pc -= 2;
+	star_exitcode = star_getpc() & 0xFFFFFF;
+	star_flow = STAR_FLOW_EXIT;
+}
+
+static inline void star_ret_timing(int n)
+{
+	star_cycles -= n;
+}
+
+static inline void star_ret_timing_checkpoint(int n)
+{
+	star_cycles -= n;
+	star_flow = STAR_FLOW_CHECKPOINT;
+}
+
+/* Leaves the PC unbased (base 0) for an uncached rebase */
+static void star_flush_interrupts(void)
+{
+	unsigned level;
+
+	star_pc -= star_base;
+	star_base = 0;
+#if STAR_SUB68K
+	{
+		unsigned ppl = (star_ctx.sr >> 8) & 7;
+		unsigned bit = 0x80;
+
+		level = 7;
+		do {
+			if(star_ctx.interrupts[0] & bit) {
+				star_ctx.save_01 = (star_ctx.save_01 & 0xFFFF0000) | level;
+				star_ctx.interrupts[0] &= ~bit;
+				star_pc = star_exception(star_ctx.interrupts[level] * 4);
+				star_ctx.sr &= 0xF8FF;
+				star_cycles -= 44;
+				star_ctx.sr |= level << 8;
+				break;
+			}
+			bit >>= 1;
+		} while(--level && level > ppl);
+	}
+#else
+	level = star_ctx.interrupts[0] & 7;
+	if(level) {
+		star_pc = star_exception(0x60 + level * 4);
+		star_ctx.sr = (unsigned short)((star_ctx.sr & 0xF8FF) | ((star_ctx.interrupts[0] & 7) << 8));
+		star_cycles -= 44;
+		star_ctx.interrupts[0] = STAR_INT_ACK();
+	}
+#endif
+}
+
+/* Is an interrupt above the PPL pending?  main checks at exec entry use the unmasked byte */
+static inline int star_interrupt_pending(int masked)
+{
+	unsigned ppl = (star_ctx.sr >> 8) & 7;
+	unsigned ch = star_ctx.interrupts[0];
+#if STAR_SUB68K
+	(void)masked;
+	return (ch & 0x80) || (ch >> (ppl + 1));
+#else
+	if(masked) ch &= 7;
+	return ch == 7 || ppl < ch;
+#endif
+}
+
+static void star_decompress(const struct star_tableentry *t)
+{
+	unsigned n = 0, i;
+
+	for(; n < 0x10000; t++) {
+		for(i = 0; i < t->count; i++)
+			star_jmptbl[n++] = t->handler;
+	}
+}
+
+/***************************************************************************/
+/*
+** Instructions.  The template arguments are the generator's main_size,
+** main_eamode, main_destmode, main_reg, main_cc, main_dr, main_ir and
+** main_qv for the routine; c0-c2 are its ret_timing values in order.
+*/
+
+#define STAR_INSN(name) \
+	template<int SIZE, int EA, int DEST, int REG, int CC, int DR, int IR, int QV> \
+	static void name(int c0, int c1 = 0, int c2 = 0)
+
+#define STAR_UNUSED (void)c1; (void)c2
+
+STAR_INSN(i_move)
+{
+	unsigned v = star_load<SIZE, EA, -1>();
+	STAR_UNUSED;
+	star_store<SIZE, DEST, REG>(v);
+	star_flags_logic<SIZE>(v);
+	star_ret_timing(c0);
+}
+
+STAR_INSN(i_moveq)
+{
+	STAR_UNUSED;
+	star_ctx.dreg[REG] = (unsigned)(signed char)star_op;
+	star_flags_logic<1>(star_op);
+	star_ret_timing(c0);
+}
+
+STAR_INSN(i_movea)
+{
+	STAR_UNUSED;
+	star_ctx.areg[REG] = star_load_signed<SIZE, EA, -1>();
+	star_ret_timing(c0);
+}
+
+STAR_INSN(i_adda)
+{
+	STAR_UNUSED;
+	star_ctx.areg[REG] += star_load_signed<SIZE, EA, -1>();
+	star_ret_timing(c0);
+}
+
+STAR_INSN(i_suba)
+{
+	STAR_UNUSED;
+	star_ctx.areg[REG] -= star_load_signed<SIZE, EA, -1>();
+	star_ret_timing(c0);
+}
+
+STAR_INSN(i_cmpa)
+{
+	unsigned s = star_load_signed<SIZE, EA, -1>();
+	STAR_UNUSED;
+	star_sbb<4>(star_ctx.areg[REG], s, 0);
+	star_ret_timing(c0);
+}
+
+STAR_INSN(i_move_to_sr)
+{
+	STAR_UNUSED;
+	STAR_SUPERVISOR_ONLY
+	star_cx2sr(star_load<2, EA, -1>() & 0xFFFF);
+	star_ret_timing_checkpoint(c0);
+}
+
+STAR_INSN(i_move_to_ccr)
+{
+	STAR_UNUSED;
+	star_cl2ccr(star_load<2, EA, -1>() & 0xFF);
+	star_ret_timing(c0);
+}
+
+STAR_INSN(i_move_from_sr)
+{
+	STAR_UNUSED;
+	star_store<2, EA, -1>(star_sr2cx());
+	star_ret_timing(c0);
+}
+
+template<int OP> static inline void star_ccr_op(int c0)
+{
+	unsigned cl = star_ccr2cl(), imm = star_fetch16() & 0xFF;
+	if(OP == OP_OR) cl |= imm;
+	else if(OP == OP_AND) cl &= imm;
+	else cl ^= imm;
+	star_cl2ccr(cl);
+	star_ret_timing(c0);
+}
+
+template<int OP> static inline void star_sr_op(int c0)
+{
+	unsigned cx, imm;
+	STAR_SUPERVISOR_ONLY
+	cx = star_sr2cx();
+	imm = star_fetch16();
+	if(OP == OP_OR) cx |= imm;
+	else if(OP == OP_AND) cx &= imm;
+	else cx ^= imm;
+	star_cx2sr(cx);
+	star_ret_timing_checkpoint(c0);
+}
+
+STAR_INSN(i_ori_ccr)  { STAR_UNUSED; star_ccr_op<OP_OR>(c0); }
+STAR_INSN(i_andi_ccr) { STAR_UNUSED; star_ccr_op<OP_AND>(c0); }
+STAR_INSN(i_eori_ccr) { STAR_UNUSED; star_ccr_op<OP_EOR>(c0); }
+STAR_INSN(i_ori_sr)   { STAR_UNUSED; star_sr_op<OP_OR>(c0); }
+STAR_INSN(i_andi_sr)  { STAR_UNUSED; star_sr_op<OP_AND>(c0); }
+STAR_INSN(i_eori_sr)  { STAR_UNUSED; star_sr_op<OP_EOR>(c0); }
+
+STAR_INSN(i_clr)
+{
+	STAR_UNUSED;
+	star_store<SIZE, EA, -1>(0);
+	star_flags_logic<SIZE>(0);
+	star_ret_timing(c0);
+}
+
+STAR_INSN(i_tst)
+{
+	STAR_UNUSED;
+	star_flags_logic<SIZE>(star_load<SIZE, EA, -1>());
+	star_ret_timing(c0);
+}
+
+template<int SIZE, int EA, int QV, int OP> static inline void star_quick(int c0)
+{
+	unsigned q = QV ? QV : 8, a, v;
+	int r = star_op & 7;
+
+	if(EA == EA_AREG) {
+		if(OP == OP_ADD) star_ctx.areg[r] += q;
+		else star_ctx.areg[r] -= q;
+	} else if(EA == EA_DREG) {
+		v = star_alu<SIZE, OP>(star_ctx.dreg[r], q);
+		star_ctx.xflag = (unsigned char)star_c;
+		star_dreg_store<SIZE>(star_ctx.dreg[r], v);
+	} else {
+		a = star_precalc<SIZE, EA, -1>();
+		v = star_alu<SIZE, OP>(star_ea_read<SIZE, EA, -1>(a), q);
+		star_ctx.xflag = (unsigned char)star_c;
+		star_ea_write<SIZE, EA, -1>(a, v);
+		star_postcalc<SIZE, EA, -1>(a);
+	}
+	star_ret_timing(c0);
+}
+
+STAR_INSN(i_addq) { STAR_UNUSED; star_quick<SIZE, EA, QV, OP_ADD>(c0); }
+STAR_INSN(i_subq) { STAR_UNUSED; star_quick<SIZE, EA, QV, OP_SUB>(c0); }
+
+/* <ea> op Dn -> Dn */
+template<int SIZE, int EA, int REG, int OP> static inline void star_op_to_dn(int c0)
+{
+	unsigned s = star_load<SIZE, EA, -1>();
+	unsigned r = star_alu<SIZE, OP>(star_ctx.dreg[REG], s);
+	if(OP != OP_CMP) star_dreg_store<SIZE>(star_ctx.dreg[REG], r);
+	if(OP == OP_ADD || OP == OP_SUB) star_ctx.xflag = (unsigned char)star_c;
+	star_ret_timing(c0);
+}
+
+STAR_INSN(i_cmp_dn) { STAR_UNUSED; star_op_to_dn<SIZE, EA, REG, OP_CMP>(c0); }
+STAR_INSN(i_add_dn) { STAR_UNUSED; star_op_to_dn<SIZE, EA, REG, OP_ADD>(c0); }
+STAR_INSN(i_sub_dn) { STAR_UNUSED; star_op_to_dn<SIZE, EA, REG, OP_SUB>(c0); }
+STAR_INSN(i_and_dn) { STAR_UNUSED; star_op_to_dn<SIZE, EA, REG, OP_AND>(c0); }
+STAR_INSN(i_or_dn)  { STAR_UNUSED; star_op_to_dn<SIZE, EA, REG, OP_OR>(c0); }
+
+/* Dn op <ea> -> <ea> */
+template<int SIZE, int EA, int REG, int OP> static inline void star_op_to_ea(int c0)
+{
+	unsigned a = star_precalc<SIZE, EA, -1>();
+	unsigned r = star_alu<SIZE, OP>(star_ea_read<SIZE, EA, -1>(a), star_ctx.dreg[REG]);
+	if(OP == OP_ADD || OP == OP_SUB) star_ctx.xflag = (unsigned char)star_c;
+	star_ea_write<SIZE, EA, -1>(a, r);
+	star_postcalc<SIZE, EA, -1>(a);
+	star_ret_timing(c0);
+}
+
+STAR_INSN(i_eor_ea) { STAR_UNUSED; star_op_to_ea<SIZE, EA, REG, OP_EOR>(c0); }
+STAR_INSN(i_add_ea) { STAR_UNUSED; star_op_to_ea<SIZE, EA, REG, OP_ADD>(c0); }
+STAR_INSN(i_sub_ea) { STAR_UNUSED; star_op_to_ea<SIZE, EA, REG, OP_SUB>(c0); }
+STAR_INSN(i_and_ea) { STAR_UNUSED; star_op_to_ea<SIZE, EA, REG, OP_AND>(c0); }
+STAR_INSN(i_or_ea)  { STAR_UNUSED; star_op_to_ea<SIZE, EA, REG, OP_OR>(c0); }
+
+/* #imm op <ea> -> <ea> */
+template<int SIZE, int EA, int OP> static inline void star_im_to_ea(int c0)
+{
+	unsigned imm = SIZE == 4 ? star_fetch32() : star_fetch16();
+	unsigned a, r;
+
+	if(EA == EA_DREG) {
+		unsigned &d = star_ctx.dreg[star_op & 7];
+		r = star_alu<SIZE, OP>(d, imm);
+		if(OP != OP_CMP) star_dreg_store<SIZE>(d, r);
+	} else {
+		a = star_precalc<SIZE, EA, -1>();
+		r = star_alu<SIZE, OP>(star_ea_read<SIZE, EA, -1>(a), imm);
+		if(OP != OP_CMP) star_ea_write<SIZE, EA, -1>(a, r);
+		star_postcalc<SIZE, EA, -1>(a);
+	}
+	if(OP == OP_ADD || OP == OP_SUB) star_ctx.xflag = (unsigned char)star_c;
+	star_ret_timing(c0);
+}
+
+STAR_INSN(i_addi) { STAR_UNUSED; star_im_to_ea<SIZE, EA, OP_ADD>(c0); }
+STAR_INSN(i_subi) { STAR_UNUSED; star_im_to_ea<SIZE, EA, OP_SUB>(c0); }
+STAR_INSN(i_cmpi) { STAR_UNUSED; star_im_to_ea<SIZE, EA, OP_CMP>(c0); }
+STAR_INSN(i_andi) { STAR_UNUSED; star_im_to_ea<SIZE, EA, OP_AND>(c0); }
+STAR_INSN(i_ori)  { STAR_UNUSED; star_im_to_ea<SIZE, EA, OP_OR>(c0); }
+STAR_INSN(i_eori) { STAR_UNUSED; star_im_to_ea<SIZE, EA, OP_EOR>(c0); }
+
+/*
+** Register shifts and rotates.  Counts of 32 or more are done in chunks of
+** 31 like the assembly, with its carry-ins (X for the first chunk of ROXd,
+** 0 for the middle ones, 1 for the last).
+*/
+template<int SIZE, int KIND, int REG, int DR, int IR, int QV> static inline void star_flick_reg(int c0, int c1)
+{
+	static const unsigned quickvalue[8] = { 8, 1, 2, 3, 4, 5, 6, 7 };
+	unsigned &d = star_ctx.dreg[star_op & 7];
+	unsigned v = d & STAR_MASK(SIZE), count, cf, i;
+
+	if(IR) {
+		count = star_ctx.dreg[REG] & 63;
+		if(!count) {
+			star_flags_nz<SIZE>(v);
+			star_v = 0;
+			star_c = KIND == SH_RX ? star_ctx.xflag : 0;
+			star_ret_timing(c0);
+			return;
+		}
+		star_cycles -= count * 2;
+	} else {
+		count = quickvalue[REG];
+	}
+
+	if(KIND == SH_AS && DR) {
+		unsigned vf = 0;
+		for(i = 0; i < count; i++) {
+			unsigned r = (v + v) & STAR_MASK(SIZE);
+			star_c = v >> STAR_MSB(SIZE);
+			vf |= ((v ^ r) >> STAR_MSB(SIZE)) & 1;
+			v = r;
+		}
+		star_flags_nz<SIZE>(v);
+		star_v = vf;
+		star_ctx.xflag = (unsigned char)star_c;
+	} else {
+		cf = star_ctx.xflag;
+		if(count < 32) {
+			v = star_x86_shift<SIZE>(KIND, DR, v, count, cf);
+		} else {
+			v = star_x86_shift<SIZE>(KIND, DR, v, 31, cf);
+			count -= 31;
+			while(count >= 32) {
+				cf = 0;
+				v = star_x86_shift<SIZE>(KIND, DR, v, 31, cf);
+				count -= 31;
+			}
+			cf = 1;
+			v = star_x86_shift<SIZE>(KIND, DR, v, count, cf);
+		}
+		star_c = cf;
+		star_flags_nz<SIZE>(v);
+		star_v = 0;
+		if(KIND != SH_RO) star_ctx.xflag = (unsigned char)cf;
+	}
+	star_dreg_store<SIZE>(d, v);
+	star_ret_timing(IR ? c1 : c0);
+}
+
+STAR_INSN(i_lsx_reg) { (void)c2; star_flick_reg<SIZE, SH_LS, REG, DR, IR, QV>(c0, c1); }
+STAR_INSN(i_asx_reg) { (void)c2; star_flick_reg<SIZE, SH_AS, REG, DR, IR, QV>(c0, c1); }
+STAR_INSN(i_rox_reg) { (void)c2; star_flick_reg<SIZE, SH_RO, REG, DR, IR, QV>(c0, c1); }
+STAR_INSN(i_rxx_reg) { (void)c2; star_flick_reg<SIZE, SH_RX, REG, DR, IR, QV>(c0, c1); }
+
+/* Memory shifts and rotates, word by 1 */
+template<int EA, int KIND, int DR> static inline void star_flick_mem(int c0)
+{
+	unsigned a = star_precalc<2, EA, -1>();
+	unsigned v = star_ea_read<2, EA, -1>(a) & 0xFFFF;
+	unsigned cf = star_ctx.xflag;
+
+	if(KIND == SH_AS && DR) {
+		unsigned r = (v << 1) & 0xFFFF;
+		star_v = ((v ^ r) >> 15) & 1;
+		cf = v >> 15;
+		v = r;
+	} else {
+		v = star_x86_shift<2>(KIND, DR, v, 1, cf);
+		star_v = 0;
+	}
+	star_c = cf;
+	star_flags_nz<2>(v);
+	if(KIND != SH_RO) star_ctx.xflag = (unsigned char)cf;
+	star_ea_write<2, EA, -1>(a, v);
+	star_postcalc<2, EA, -1>(a);
+	star_ret_timing(c0);
+}
+
+STAR_INSN(i_lsx_mem) { STAR_UNUSED; star_flick_mem<EA, SH_LS, DR>(c0); }
+STAR_INSN(i_asx_mem) { STAR_UNUSED; star_flick_mem<EA, SH_AS, DR>(c0); }
+STAR_INSN(i_rox_mem) { STAR_UNUSED; star_flick_mem<EA, SH_RO, DR>(c0); }
+STAR_INSN(i_rxx_mem) { STAR_UNUSED; star_flick_mem<EA, SH_RX, DR>(c0); }
+
+/* Branches.  The taken paths of Bcc/DBcc are those of BRA (10 cycles). */
+static inline void star_bra_b(void)
+{
+	star_pc += (signed char)star_op;
+	star_ret_timing(10);
+}
+
+static inline void star_bra_w(void)
+{
+	star_pc += (short)*(unsigned short *)star_pc;
+	star_ret_timing(10);
+}
+
+STAR_INSN(i_bra_b) { STAR_UNUSED; (void)c0; star_bra_b(); }
+STAR_INSN(i_bra_w) { STAR_UNUSED; (void)c0; star_bra_w(); }
+
+STAR_INSN(i_bsr_b)
+{
+	unsigned ret = star_getpc();
+	STAR_UNUSED;
+	star_pc += (signed char)star_op;
+	star_push_long(ret);
+	star_ret_timing(c0);
+}
+
+STAR_INSN(i_bsr_w)
+{
+	unsigned ret = star_getpc() + 2;
+	STAR_UNUSED;
+	star_pc += (short)*(unsigned short *)star_pc;
+	star_push_long(ret);
+	star_ret_timing(c0);
+}
+
+STAR_INSN(i_bcc_b)
+{
+	STAR_UNUSED;
+	if(star_cond(CC)) star_bra_b();
+	else star_ret_timing(c0);
+}
+
+STAR_INSN(i_bcc_w)
+{
+	STAR_UNUSED;
+	if(star_cond(CC)) {
+		star_bra_w();
+	} else {
+		star_pc += 2;
+		star_ret_timing(c0);
+	}
+}
+
+static inline void star_dbra(int c0)
+{
+	unsigned &d = star_ctx.dreg[star_op & 7];
+	unsigned w = d & 0xFFFF;
+	star_dreg_store<2>(d, w - 1);
+	if(w) {
+		star_bra_w();
+	} else {
+		star_pc += 2;
+		star_ret_timing(c0);
+	}
+}
+
+STAR_INSN(i_dbra) { STAR_UNUSED; star_dbra(c0); }
+
+STAR_INSN(i_dbtr)
+{
+	STAR_UNUSED;
+	star_pc += 2;
+	star_ret_timing(c0);
+}
+
+/* A false condition takes the DBRA path with its own timings */
+STAR_INSN(i_dbcc)
+{
+	STAR_UNUSED;
+	if(star_cond(CC)) {
+		star_pc += 2;
+		star_ret_timing(c0);
+	} else {
+		star_dbra(14);
+	}
+}
+
+STAR_INSN(i_scc)
+{
+	unsigned t;
+	STAR_UNUSED;
+	if(CC > 1) {
+		t = star_cond(CC);
+		if(EA == EA_DREG) star_cycles -= t * 2;
+	} else {
+		t = CC == 0;
+	}
+	star_store<1, EA, -1>(t ? 0xFF : 0);
+	star_ret_timing(c0);
+}
+
+template<int EA, int OP> static inline void star_bitop(unsigned bit, int c0)
+{
+	unsigned a, v, m;
+
+	if(EA == EA_DREG) {
+		unsigned &d = star_ctx.dreg[star_op & 7];
+		m = 1u << (bit & 31);
+		star_z = !(d & m);
+		if(OP == BIT_CHG) d ^= m;
+		else if(OP == BIT_CLR) d &= ~m;
+		else if(OP == BIT_SET) d |= m;
+	} else {
+		m = 1u << (bit & 7);
+		a = star_precalc<1, EA, -1>();
+		v = star_ea_read<1, EA, -1>(a);
+		star_z = !(v & m);
+		if(OP != BIT_TST) {
+			if(OP == BIT_CHG) v ^= m;
+			else if(OP == BIT_CLR) v &= ~m;
+			else v |= m;
+			star_ea_write<1, EA, -1>(a, v);
+		}
+		star_postcalc<1, EA, -1>(a);
+	}
+	star_ret_timing(c0);
+}
+
+STAR_INSN(i_bitop_imm)
+{
+	unsigned bit = star_fetch16() & 0xFF;
+	STAR_UNUSED;
+	star_bitop<EA, CC>(bit, c0);
+}
+
+STAR_INSN(i_bitop_reg)
+{
+	STAR_UNUSED;
+	star_bitop<EA, CC>(star_ctx.dreg[REG] & 0xFF, c0);
+}
+
+STAR_INSN(i_jmp)
+{
+	STAR_UNUSED;
+	star_cached_rebase(star_precalc<0, EA, -1>());
+	star_ret_timing(c0);
+}
+
+STAR_INSN(i_jsr)
+{
+	unsigned a = star_precalc<0, EA, -1>();
+	unsigned ret = star_getpc();
+	STAR_UNUSED;
+	star_cached_rebase(a);
+	star_push_long(ret);
+	star_ret_timing(c0);
+}
+
+STAR_INSN(i_rts)
+{
+	STAR_UNUSED;
+	star_cached_rebase(star_load<4, EA_AINC, 7>());
+	star_ret_timing(c0);
+}
+
+STAR_INSN(i_rtr)
+{
+	STAR_UNUSED;
+	star_cl2ccr(star_load<2, EA_AINC, 7>() & 0xFF);
+	star_cached_rebase(star_load<4, EA_AINC, 7>());
+	star_ret_timing(c0);
+}
+
+STAR_INSN(i_rte)
+{
+	unsigned a, w;
+	STAR_UNUSED;
+	STAR_SUPERVISOR_ONLY
+	a = star_a7;
+	w = star_read<2>(a, 0);
+	star_cx2sr(w);
+	if(w & 0x2000) star_a7 += 6;
+	else star_ctx.asp += 6;
+	star_cached_rebase(star_read<4>(a + 2, 0));
+	star_ret_timing_checkpoint(c0);
+}
+
+STAR_INSN(i_lea)
+{
+	STAR_UNUSED;
+	star_ctx.areg[REG] = star_precalc<0, EA, -1>();
+	star_ret_timing(c0);
+}
+
+STAR_INSN(i_pea)
+{
+	STAR_UNUSED;
+	star_push_long(star_precalc<0, EA, -1>());
+	star_ret_timing(c0);
+}
+
+STAR_INSN(i_nop)
+{
+	STAR_UNUSED;
+	star_ret_timing(c0);
+}
+
+/* MOVEM mask bit 0 is D0 ... bit 15 is A7, except for -(An) */
+template<int SIZE> static inline unsigned star_movem_load(unsigned mask, unsigned a)
+{
+	int i;
+	for(i = 0; i < 16; i++) {
+		if(mask & (1 << i)) {
+			unsigned v = star_read<SIZE>(a, 0);
+			star_reg(i) = SIZE == 2 ? (unsigned)(short)v : v;
+			a += SIZE;
+			star_cycles -= SIZE * 2;
+		}
+	}
+	return a;
+}
+
+STAR_INSN(i_movem_control)
+{
+	unsigned mask = star_fetch16(), a;
+	int i;
+	STAR_UNUSED;
+	a = star_precalc<0, EA, -1>();
+	if(DR) {
+		star_movem_load<SIZE>(mask, a);
+	} else {
+		for(i = 0; i < 16; i++) {
+			if(mask & (1 << i)) {
+				star_write<SIZE>(a, star_reg(i), 0);
+				a += SIZE;
+				star_cycles -= SIZE * 2;
+			}
+		}
+	}
+	star_ret_timing(c0);
+}
+
+STAR_INSN(i_movem_postinc)
+{
+	int r = star_op & 7;
+	unsigned mask = star_fetch16();
+	STAR_UNUSED;
+	star_ctx.areg[r] = star_movem_load<SIZE>(mask, star_ctx.areg[r]);
+	star_ret_timing(c0);
+}
+
+STAR_INSN(i_movem_predec)
+{
+	int r = star_op & 7, i;
+	unsigned mask = star_fetch16(), a = star_ctx.areg[r];
+	STAR_UNUSED;
+	for(i = 15; i >= 0; i--) {
+		if(mask & (1 << (15 - i))) {
+			unsigned v = star_reg(i);
+			a -= SIZE;
+			star_cycles -= SIZE * 2;
+			star_write<SIZE>(a, v, 0);
+		}
+	}
+	star_ctx.areg[r] = a;
+	star_ret_timing(c0);
+}
+
+STAR_INSN(i_link)
+{
+	int r = star_op & 7;
+	STAR_UNUSED;
+	star_push_long(star_ctx.areg[r]);
+	star_ctx.areg[r] = star_a7;
+	star_a7 += (short)star_fetch16();
+	star_ret_timing(c0);
+}
+
+STAR_INSN(i_unlk)
+{
+	int r = star_op & 7;
+	STAR_UNUSED;
+	star_a7 = star_ctx.areg[r];
+	star_ctx.areg[r] = star_load<4, EA_AINC, 7>();
+	star_ret_timing(c0);
+}
+
+STAR_INSN(i_move_from_usp)
+{
+	STAR_UNUSED;
+	STAR_SUPERVISOR_ONLY
+	star_ctx.areg[star_op & 7] = star_ctx.asp;
+	star_ret_timing(c0);
+}
+
+STAR_INSN(i_move_to_usp)
+{
+	STAR_UNUSED;
+	STAR_SUPERVISOR_ONLY
+	star_ctx.asp = star_ctx.areg[star_op & 7];
+	star_ret_timing(c0);
+}
+
+STAR_INSN(i_trap)
+{
+	STAR_UNUSED;
+	star_cached_rebase(star_exception(0x80 + (star_op & 15) * 4));
+	star_ret_timing(c0);
+}
+
+STAR_INSN(i_trapv)
+{
+	(void)c2;
+	if(!star_v) {
+		star_ret_timing(c0);
+		return;
+	}
+	star_cached_rebase(star_exception(0x1C));
+	star_ret_timing(c1);
+}
+
+STAR_INSN(i_stop)
+{
+	STAR_UNUSED;
+	STAR_SUPERVISOR_ONLY
+	star_cx2sr(star_fetch16());
+	star_ctx.interrupts[0] |= STAR_STOPPED;
+	star_cycles -= 4;
+	if(star_cycles >= 0) star_cycles = -1;
+	star_ret_timing(c0);
+}
+
+STAR_INSN(i_extbw)
+{
+	unsigned &d = star_ctx.dreg[star_op & 7];
+	STAR_UNUSED;
+	star_dreg_store<2>(d, (unsigned)(signed char)d);
+	star_flags_logic<2>(d);
+	star_ret_timing(c0);
+}
+
+STAR_INSN(i_extwl)
+{
+	unsigned &d = star_ctx.dreg[star_op & 7];
+	STAR_UNUSED;
+	d = (unsigned)(short)d;
+	star_flags_logic<4>(d);
+	star_ret_timing(c0);
+}
+
+STAR_INSN(i_swap)
+{
+	unsigned &d = star_ctx.dreg[star_op & 7];
+	STAR_UNUSED;
+	d = (d >> 16) | (d << 16);
+	star_flags_logic<4>(d);
+	star_ret_timing(c0);
+}
+
+/* MULU/MULS (CC = 1): 2 cycles per 1 bit / per 01 or 10 pair of the source */
+STAR_INSN(i_mul)
+{
+	unsigned s = star_load<2, EA, -1>() & 0xFFFF, d, t, n = 0;
+	STAR_UNUSED;
+	t = CC ? (s ^ (s << 1)) & 0xFFFF : s;
+	for(; t; t &= t - 1)
+		n++;
+	star_cycles -= n * 2;
+	d = star_ctx.dreg[REG];
+	if(CC) d = (unsigned)((int)(short)s * (int)(short)d);
+	else d = s * (d & 0xFFFF);
+	star_ctx.dreg[REG] = d;
+	star_flags_logic<4>(d);
+	star_ret_timing(c0);
+}
+
+/* DIVU/DIVS (CC = 1); $80000000 / -1 overflows instead of faulting like idiv */
+STAR_INSN(i_div)
+{
+	unsigned s = star_load<2, EA, -1>() & 0xFFFF;
+	unsigned d = star_ctx.dreg[REG], q, r;
+
+	if(!s) {
+		star_cached_rebase(star_exception(0x14));
+		star_ret_timing(c0);
+		return;
+	}
+	if(CC) {
+		long long sq = (long long)(int)d / (short)s;
+		if(sq < -32768 || sq > 32767) goto overflow;
+		q = (unsigned)sq;
+		r = (unsigned)((long long)(int)d % (short)s);
+	} else {
+		if(d / s > 0xFFFF) goto overflow;
+		q = d / s;
+		r = d % s;
+	}
+	star_ctx.dreg[REG] = (r << 16) | (q & 0xFFFF);
+	star_flags_logic<2>(q);
+	star_ret_timing(c1);
+	return;
+
+overflow:
+	star_n = 0;
+	star_z = 0;
+	star_c = 0;
+	star_v = 1;
+	star_ret_timing(c2);
+}
+
+template<int SIZE, int EA, int OP> static inline void star_unary(int c0)
+{
+	unsigned a = star_precalc<SIZE, EA, -1>();
+	unsigned v = star_ea_read<SIZE, EA, -1>(a), oldz = star_z;
+
+	if(OP == OP_SUB) {
+		v = star_sbb<SIZE>(0, v, 0);
+		star_ctx.xflag = (unsigned char)star_c;
+	} else if(OP == OP_CMP) {
+		v = star_sbb<SIZE>(0, v, star_ctx.xflag);
+		star_ctx.xflag = (unsigned char)star_c;
+		star_adjzero(oldz);
+	} else {
+		v = ~v & STAR_MASK(SIZE);
+		star_flags_logic<SIZE>(v);
+	}
+	star_ea_write<SIZE, EA, -1>(a, v);
+	star_postcalc<SIZE, EA, -1>(a);
+	star_ret_timing(c0);
+}
+
+STAR_INSN(i_neg)  { STAR_UNUSED; star_unary<SIZE, EA, OP_SUB>(c0); }
+STAR_INSN(i_negx) { STAR_UNUSED; star_unary<SIZE, EA, OP_CMP>(c0); }
+STAR_INSN(i_not)  { STAR_UNUSED; star_unary<SIZE, EA, OP_EOR>(c0); }
+
+/* Like the assembly, NBCD subtracts X from 0 whatever the operand */
+STAR_INSN(i_nbcd)
+{
+	unsigned a = star_precalc<1, EA, -1>(), oldz = star_z, x = star_ctx.xflag, v;
+	STAR_UNUSED;
+	star_ea_read<1, EA, -1>(a);
+	v = star_das((0 - x) & 0xFF, x, x);
+	star_v = 0;
+	star_ctx.xflag = (unsigned char)star_c;
+	star_adjzero(oldz);
+	star_ea_write<1, EA, -1>(a, v);
+	star_postcalc<1, EA, -1>(a);
+	star_ret_timing(c0);
+}
+
+/* The main 68000 only writes the result back to a data register */
+STAR_INSN(i_tas)
+{
+	unsigned a = star_precalc<1, EA, -1>();
+	unsigned v = star_ea_read<1, EA, -1>(a);
+	STAR_UNUSED;
+	star_flags_logic<1>(v);
+	if(STAR_SUB68K || EA == EA_DREG) {
+		star_ea_write<1, EA, -1>(a, v | 0x80);
+		star_postcalc<1, EA, -1>(a);
+	}
+	star_ret_timing(c0);
+}
+
+/* DR and IR are 0 or 32 as in the generator */
+STAR_INSN(i_exg)
+{
+	unsigned &x = star_reg(REG + (DR ? 8 : 0));
+	unsigned &y = star_reg((star_op & 7) + (IR ? 8 : 0));
+	unsigned t = x;
+	STAR_UNUSED;
+	x = y;
+	y = t;
+	star_ret_timing(c0);
+}
+
+STAR_INSN(i_cmpm)
+{
+	unsigned s = star_load<SIZE, EA_AINC, -1>();
+	unsigned d = star_load<SIZE, EA_AINC, REG>();
+	STAR_UNUSED;
+	star_sbb<SIZE>(d, s, 0);
+	star_ret_timing(c0);
+}
+
+/* ADDX/SUBX/ABCD/SBCD: Dx op Dy or -(Ax) op -(Ay), with X */
+template<int SIZE, int OP, int BCD> static inline unsigned star_xop(unsigned d, unsigned s)
+{
+	unsigned x = star_ctx.xflag, r, af;
+
+	if(OP == OP_ADD) {
+		r = star_adc<SIZE>(d, s, x);
+		if(BCD) {
+			af = ((d ^ s ^ r) >> 4) & 1;
+			r = star_daa(r, af, star_c);
+		}
+	} else {
+		r = star_sbb<SIZE>(d, s, x);
+		if(BCD) {
+			af = ((d ^ s ^ r) >> 4) & 1;
+			r = star_das(r, af, star_c);
+		}
+	}
+	if(BCD) star_v = 0;
+	star_ctx.xflag = (unsigned char)star_c;
+	return r;
+}
+
+template<int SIZE, int REG, int OP, int BCD> static inline void star_xop_dreg(int c0)
+{
+	unsigned oldz = star_z;
+	unsigned &d = star_ctx.dreg[REG];
+	star_dreg_store<SIZE>(d, star_xop<SIZE, OP, BCD>(d, star_ctx.dreg[star_op & 7]));
+	star_adjzero(oldz);
+	star_ret_timing(c0);
+}
+
+template<int SIZE, int REG, int OP, int BCD> static inline void star_xop_adec(int c0)
+{
+	unsigned oldz = star_z;
+	unsigned s = star_load<SIZE, EA_ADEC, -1>();
+	unsigned a = star_precalc<SIZE, EA_ADEC, REG>();
+	unsigned r = star_xop<SIZE, OP, BCD>(star_ea_read<SIZE, EA_ADEC, REG>(a), s);
+	star_adjzero(oldz);
+	star_ea_write<SIZE, EA_ADEC, REG>(a, r);
+	star_postcalc<SIZE, EA_ADEC, REG>(a);
+	star_ret_timing(c0);
+}
+
+STAR_INSN(i_addx_dreg) { STAR_UNUSED; star_xop_dreg<SIZE, REG, OP_ADD, 0>(c0); }
+STAR_INSN(i_subx_dreg) { STAR_UNUSED; star_xop_dreg<SIZE, REG, OP_SUB, 0>(c0); }
+STAR_INSN(i_abcd_dreg) { STAR_UNUSED; star_xop_dreg<1, REG, OP_ADD, 1>(c0); }
+STAR_INSN(i_sbcd_dreg) { STAR_UNUSED; star_xop_dreg<1, REG, OP_SUB, 1>(c0); }
+STAR_INSN(i_addx_adec) { STAR_UNUSED; star_xop_adec<SIZE, REG, OP_ADD, 0>(c0); }
+STAR_INSN(i_subx_adec) { STAR_UNUSED; star_xop_adec<SIZE, REG, OP_SUB, 0>(c0); }
+STAR_INSN(i_abcd_adec) { STAR_UNUSED; star_xop_adec<1, REG, OP_ADD, 1>(c0); }
+STAR_INSN(i_sbcd_adec) { STAR_UNUSED; star_xop_adec<1, REG, OP_SUB, 1>(c0); }
+
+STAR_INSN(i_movep_mem2reg)
+{
+	unsigned a = star_ctx.areg[star_op & 7] + (unsigned)(short)star_fetch16(), v = 0;
+	int i;
+	STAR_UNUSED;
+	for(i = 0; i < SIZE; i++, a += 2)
+		v = (v << 8) | star_read<1>(a, 0);
+	star_dreg_store<SIZE>(star_ctx.dreg[REG], v);
+	star_ret_timing(c0);
+}
+
+STAR_INSN(i_movep_reg2mem)
+{
+	unsigned a = star_ctx.areg[star_op & 7] + (unsigned)(short)star_fetch16();
+	unsigned v = star_ctx.dreg[REG];
+	int i;
+	STAR_UNUSED;
+	for(i = SIZE - 1; i >= 0; i--, a += 2)
+		star_write<1>(a, v >> (i * 8), 0);
+	star_ret_timing(c0);
+}
+
+STAR_INSN(i_chk)
+{
+	int s = (short)star_load<2, EA, -1>();
+	int d = (short)star_ctx.dreg[REG];
+	(void)c2;
+	star_n = 0;
+	star_z = 0;
+	star_v = 0;
+	star_c = 0;
+	if(d < 0) {
+		star_n = 1;
+	} else if(d <= s) {
+		star_ret_timing(c0);
+		return;
+	}
+	star_cached_rebase(star_exception(0x18));
+	star_ret_timing(c1);
+}
+
+template<unsigned VECTOR> static inline void star_trap_insn(int c0)
+{
+	star_pc -= 2;
+	star_cached_rebase(star_exception(VECTOR));
+	star_ret_timing(c0);
+}
+
+STAR_INSN(i_illegal) { STAR_UNUSED; star_trap_insn<0x10>(c0); }
+STAR_INSN(i_aline)   { STAR_UNUSED; star_trap_insn<0x28>(c0); }
+STAR_INSN(i_fline)   { STAR_UNUSED; star_trap_insn<0x2C>(c0); }
+
+STAR_INSN(i_reset)
+{
+	STAR_UNUSED;
+	STAR_SUPERVISOR_ONLY
+	if(!star_ctx.resethandler) {
+		star_invalidins();
+		return;
+	}
+	star_airlock_exit();
+	star_ctx.resethandler();
+	star_airlock_enter();
+	star_ret_timing(c0);
+}
+
+/***************************************************************************/
+/*
+** Interface
+*/
+
+STAR_API int STAR_ID(init)(void)
+{
+	star_buildtable();
+	return 0;
+}
+
+STAR_API unsigned STAR_ID(reset)(void)
+{
+	size_t base = star_base;
+	unsigned pc;
+
+	if((star_ctx.execinfo & 1) || !star_ctx.s_fetch) return 1;
+	star_ctx.execinfo = 0;
+	memset(star_ctx.dreg, 0, sizeof(star_ctx.dreg));
+	memset(star_ctx.areg, 0, sizeof(star_ctx.areg));
+	star_ctx.asp = 0;
+	star_ctx.sr = 0x2700;
+	star_setmaps(1);
+	star_ctx.pc = 1;
+	star_ctx.interrupts[0] = STAR_STOPPED;
+	star_basefunction(0);
+	if(star_ctx.execinfo & 2) {
+		star_base = base;
+		return 1;
+	}
+	star_a7 = *(unsigned short *)star_base << 16 | *(unsigned short *)(star_base + 2);
+	pc = *(unsigned short *)(star_base + 4) << 16 | *(unsigned short *)(star_base + 6);
+	star_ctx.pc = pc;
+	star_ctx.interrupts[0] = STAR_SUB68K ? (unsigned char)(pc & 1) : 0;
+	star_base = base;
+	return 0 - (pc & 1);
+}
+
+STAR_API unsigned STAR_ID(exec)(int n)
+{
+	unsigned code, cycles;
+
+	if((unsigned)n <= star_ctx.odometer) return 0x80000003;
+	cycles = (unsigned)n - star_ctx.odometer;
+	if(star_ctx.interrupts[0] & STAR_STOPPED) {
+		if(star_ctx.pc & 1) return 0xFFFFFFFF;
+		star_ctx.odometer += cycles;
+		return 0x80000004;
+	}
+
+	star_ctx.cycles_needed = cycles;
+	star_cycles = (int)cycles - 1;
+	star_cache_ccr();
+	star_base = 0;
+	star_pc = star_ctx.pc;
+	star_ctx.execinfo = 1;
+	star_uncached_rebase();
+	if(star_ctx.execinfo & 2) {
+		code = 0x80000001;
+		goto execexit;
+	}
+	star_ctx.cycles_leftover = 0;
+
+checkpoint:
+	if(star_cycles < 0) goto execquit;
+	if(star_interrupt_pending(0)) {
+		star_flush_interrupts();
+		star_uncached_rebase();
+		if(star_cycles < 0) goto execquit;
+		if(star_ctx.execinfo & 2) goto bounderror;
+	}
+#if STAR_SUB68K
+	star_ctx.trace_trickybit = (unsigned char)((star_ctx.sr >> 8) & 0x80);
+	if(star_ctx.trace_trickybit) {
+		star_ctx.cycles_leftover += star_cycles + 1;
+		star_cycles = -1;
+	}
+#endif
+
+	for(;;) {
+		star_op = *(unsigned short *)star_pc;
+		star_pc += 2;
+#if STAR_HOOKS
+		if(STAR_HOOK_ENABLED) {
+			star_writeback_ccr();
+			STAR_HOOK(hook_pc) = star_getpc() - 2;
+			STAR_HOOK(hook_exec)();
+		}
+#endif
+		star_jmptbl[star_op]();
+		if(star_flow) {
+			if(star_flow == STAR_FLOW_EXIT) {
+				star_flow = STAR_FLOW_NEXT;
+				code = star_exitcode;
+				goto execexit;
+			}
+			star_flow = STAR_FLOW_NEXT;
+			goto checkpoint;
+		}
+		if(star_cycles >= 0) continue;
+
+execquit:
+#if STAR_SUB68K
+		if(star_ctx.trace_trickybit) {
+			star_cached_rebase(star_exception(0x24));
+			star_cycles -= 34;
+		}
+#endif
+		if(star_interrupt_pending(1)) {
+			star_flush_interrupts();
+			star_uncached_rebase();
+			if(star_ctx.execinfo & 2) goto bounderror;
+		}
+		star_cycles += star_ctx.cycles_leftover;
+		star_ctx.cycles_leftover = 0;
+		if(star_cycles < 0) break;
+	}
+	code = 0x80000000;
+	goto execexit;
+
+bounderror:
+	code = 0x80000001;
+
+execexit:
+	star_ctx.pc = star_getpc();
+	star_writeback_ccr();
+	star_cycles++;
+	star_ctx.odometer += star_ctx.cycles_needed - star_cycles;
+	star_ctx.execinfo = 0;
+	star_ctx.cycles_needed = 0;
+	star_ctx.io_cycle_counter = 0xFFFFFFFF;
+	return code;
+}
+
+#if STAR_SUB68K
+STAR_API int STAR_ID(interrupt)(int level, int vector)
+{
+	if(level < 1 || level > 7 || vector < -2 || vector > 255) return 2;
+	if(vector == -2) vector = 0x18;
+	else if(vector < 0) vector = level + 0x18;
+	if(star_ctx.interrupts[0] & (1 << level)) return 1;
+	star_ctx.interrupts[0] |= 1 << level;
+	star_ctx.interrupts[level] = (unsigned char)vector;
+	star_ctx.interrupts[0] &= ~STAR_STOPPED;
+	star_ctx.cycles_leftover += star_ctx.io_cycle_counter + 1;
+	star_ctx.io_cycle_counter = 0xFFFFFFFF;
+	return 0;
+}
+#else
+STAR_API int STAR_ID(interrupt)(int level, int vector)
+{
+	(void)vector;
+	star_ctx.interrupts[0] = (unsigned char)level;
+	star_ctx.cycles_leftover += star_ctx.io_cycle_counter + 1;
+	star_ctx.io_cycle_counter = 0xFFFFFFFF;
+	return 0;
+}
+#endif
+
+STAR_API void STAR_ID(flushInterrupts)(void)
+{
+	if(star_ctx.execinfo & 1) return;
+#if !STAR_SUB68K
+	if(!star_interrupt_pending(0)) return;
+#endif
+	star_pc = star_ctx.pc;
+	star_base = 0;
+	star_cycles = 0;
+#if STAR_SUB68K
+	star_cache_ccr();
+#endif
+	star_flush_interrupts();
+	star_ctx.odometer -= star_cycles;
+	star_ctx.pc = star_getpc();
+#if STAR_SUB68K
+	star_writeback_ccr();
+#endif
+}
+
+STAR_API int STAR_ID(GetContextSize)(void)
+{
+	return sizeof(S68000CONTEXT);
+}
+
+STAR_API void STAR_ID(GetContext)(void *context)
+{
+	memcpy(context, &star_ctx, sizeof(S68000CONTEXT));
+}
+
+STAR_API void STAR_ID(SetContext)(void *context)
+{
+	memcpy(&star_ctx, context, sizeof(S68000CONTEXT));
+}
+
+STAR_API int STAR_ID(fetch)(unsigned address)
+{
+	struct STARSCREAM_PROGRAMREGION *fetch = star_ctx.fetch;
+	unsigned start = star_ctx.fetch_region_start, end = star_ctx.fetch_region_end;
+	unsigned char execinfo = star_ctx.execinfo;
+	size_t base = star_base;
+	int cycles = star_cycles, r;
+
+	star_ctx.fetch = star_ctx.s_fetch;
+	star_ctx.execinfo &= ~2;
+	star_basefunction(address);
+	if(star_ctx.execinfo & 2) r = -1;
+	else r = *(unsigned short *)(star_base + address);
+	star_ctx.fetch = fetch;
+	star_ctx.fetch_region_start = start;
+	star_ctx.fetch_region_end = end;
+	star_ctx.execinfo = execinfo;
+	star_base = base;
+	star_cycles = cycles;
+	return r;
+}
+
+STAR_API unsigned STAR_ID(readOdometer)(void)
+{
+	return star_ctx.cycles_needed - star_ctx.io_cycle_counter - 1 - star_ctx.cycles_leftover + star_ctx.odometer;
+}
+
+STAR_API unsigned STAR_ID(tripOdometer)(void)
+{
+	unsigned odometer = STAR_ID(readOdometer)();
+	star_ctx.cycles_needed = star_ctx.io_cycle_counter + 1;
+	star_ctx.odometer = 0;
+	return odometer;
+}
+
+STAR_API unsigned STAR_ID(controlOdometer)(int n)
+{
+	return n ? STAR_ID(tripOdometer)() : STAR_ID(readOdometer)();
+}
+
+STAR_API void STAR_ID(releaseTimeslice)(void)
+{
+	star_ctx.io_cycle_counter -= star_ctx.cycles_needed;
+	star_ctx.cycles_needed = 0;
+}
+
+#if !STAR_SUB68K
+STAR_API void STAR_ID(releaseCycles)(int cycles)
+{
+	star_ctx.io_cycle_counter -= cycles;
+}
+#endif
+
+STAR_API void STAR_ID(addCycles)(int cycles)
+{
+	star_ctx.odometer += cycles;
+}
+
+STAR_API unsigned STAR_ID(readPC)(void)
+{
+	if(star_ctx.execinfo & 1)
+		return star_ctx.io_fetchbased_pc - star_ctx.io_fetchbase;
+	return star_ctx.pc;
+}
@@ -153,6 +153,7 @@ static int hog         = -1;
 static int addressbits = -1;
 static int cputype     = -1;
 static int quiet       = 0;
+static int cpp         = 0;
 static char *sourcename = NULL;
 
 /* This counts the number of instruction handling routines.  There's not much
@@ -200,9 +201,21 @@ static int main_dr;               /* Direction (right or left) */
 static int main_ir;               /* Immediate or register (for shifts) */
 static int main_qv;               /* Quick value */
 
+/*
+** C++ output (-cpp).  The instruction handling routines are still run, but
+** with emit() switched off; their ret_timing values are collected and each
+** routine becomes a call to the template of the same name in StarCpp.h.
+*/
+static int cpp_capture;
+static int cpp_ncycles;
+static int cpp_cycles[3];
+static int cpp_first, cpp_last;
+static char cpp_illegal[5];
+
 /* Emit a line of code (format string with other junk) */
 static void emit(const char *fmt, ...) {
 	va_list a;
+	if(cpp_capture) return;
 	va_start(a, fmt);
 	if(codefile) {
 		vfprintf(codefile, fmt, a);
@@ -1313,7 +1326,17 @@ emit("or [__sr + 1], dl\n");			// Stef Add (Gens)
 
 /***************************************************************************/
 
+static void cpp_timing(int n) {
+	if(!cpp_capture) return;
+	if(cpp_ncycles == 3) {
+		fprintf(stderr, "Bad news: more than 3 ret_timing values in one routine\n");
+		exit(1);
+	}
+	cpp_cycles[cpp_ncycles++] = n;
+}
+
 static void ret_timing(int n) {
+	cpp_timing(n);
 	if(n) {
 		emit("sub edi,%s%d\n", (n < 128) ? "byte " : "", n);
 	} else {
@@ -1362,6 +1385,7 @@ static void ret_timing(int n) {
 **  will clear the trace tricky bit as well as the trace flag.
 */
 static void ret_timing_checkpoint(int n) {
+	cpp_timing(n);
 	if(n) {
 		emit("sub edi,%s%d\n", (n < 128) ? "byte " : "", n);
 	} else {
@@ -4500,6 +4524,12 @@ static int test(int n, int m, int op) {
 	unique[n] = (m >> 16) & 1;
 	rproc[n] = n;
 	t = (m ^ 0xFFFF) & 0xFFF;
+	routine_counter++;
+	if(cpp) {
+		cpp_first = n;
+		cpp_last = op + t;
+		return 1;
+	}
 	if(!t) {
 		emit("; Opcode %04X\n", n);
 	} else {
@@ -4507,10 +4537,80 @@ static int test(int n, int m, int op) {
 	}
 /*	align(4);*/
 	emit("%c%03X:\n", ((n >> 12) & 0xF) + 'K', n & 0xFFF);
-	routine_counter++;
 	return 1;
 }
 
+/* Template names for the C++ output */
+#define CPPNAME(name) { name, #name }
+static struct { void (*proc)(void); char *name; } cpp_names[] = {
+	CPPNAME(i_move), CPPNAME(i_moveq), CPPNAME(i_movea), CPPNAME(i_adda),
+	CPPNAME(i_suba), CPPNAME(i_cmpa), CPPNAME(i_move_to_sr),
+	CPPNAME(i_move_to_ccr), CPPNAME(i_move_from_sr), CPPNAME(i_ori_ccr),
+	CPPNAME(i_andi_ccr), CPPNAME(i_eori_ccr), CPPNAME(i_ori_sr),
+	CPPNAME(i_andi_sr), CPPNAME(i_eori_sr), CPPNAME(i_clr), CPPNAME(i_tst),
+	CPPNAME(i_addq), CPPNAME(i_subq), CPPNAME(i_cmp_dn), CPPNAME(i_add_dn),
+	CPPNAME(i_sub_dn), CPPNAME(i_and_dn), CPPNAME(i_or_dn),
+	CPPNAME(i_eor_ea), CPPNAME(i_add_ea), CPPNAME(i_sub_ea),
+	CPPNAME(i_and_ea), CPPNAME(i_or_ea), CPPNAME(i_addi), CPPNAME(i_subi),
+	CPPNAME(i_cmpi), CPPNAME(i_andi), CPPNAME(i_ori), CPPNAME(i_eori),
+	CPPNAME(i_lsx_reg), CPPNAME(i_asx_reg), CPPNAME(i_rox_reg),
+	CPPNAME(i_rxx_reg), CPPNAME(i_lsx_mem), CPPNAME(i_asx_mem),
+	CPPNAME(i_rox_mem), CPPNAME(i_rxx_mem), CPPNAME(i_bra_b),
+	CPPNAME(i_bra_w), CPPNAME(i_bsr_b), CPPNAME(i_bsr_w), CPPNAME(i_bcc_b),
+	CPPNAME(i_bcc_w), CPPNAME(i_dbra), CPPNAME(i_dbtr), CPPNAME(i_dbcc),
+	CPPNAME(i_scc), CPPNAME(i_bitop_imm), CPPNAME(i_bitop_reg),
+	CPPNAME(i_jmp), CPPNAME(i_jsr), CPPNAME(i_rts), CPPNAME(i_rtr),
+	CPPNAME(i_rte), CPPNAME(i_lea), CPPNAME(i_pea), CPPNAME(i_nop),
+	CPPNAME(i_movem_control), CPPNAME(i_movem_postinc),
+	CPPNAME(i_movem_predec), CPPNAME(i_link), CPPNAME(i_unlk),
+	CPPNAME(i_move_from_usp), CPPNAME(i_move_to_usp), CPPNAME(i_trap),
+	CPPNAME(i_trapv), CPPNAME(i_stop), CPPNAME(i_extbw), CPPNAME(i_extwl),
+	CPPNAME(i_swap), CPPNAME(i_mul), CPPNAME(i_div), CPPNAME(i_neg),
+	CPPNAME(i_negx), CPPNAME(i_nbcd), CPPNAME(i_tas), CPPNAME(i_not),
+	CPPNAME(i_exg), CPPNAME(i_cmpm), CPPNAME(i_addx_dreg),
+	CPPNAME(i_addx_adec), CPPNAME(i_subx_dreg), CPPNAME(i_subx_adec),
+	CPPNAME(i_abcd_dreg), CPPNAME(i_abcd_adec), CPPNAME(i_sbcd_dreg),
+	CPPNAME(i_sbcd_adec), CPPNAME(i_movep_mem2reg),
+	CPPNAME(i_movep_reg2mem), CPPNAME(i_chk), CPPNAME(i_illegal),
+	CPPNAME(i_aline), CPPNAME(i_fline), CPPNAME(i_reset),
+	{ NULL, NULL }
+};
+
+static char *cpp_eaname[12] = {
+	"EA_DREG", "EA_AREG", "EA_AIND", "EA_AINC", "EA_ADEC", "EA_ADSP",
+	"EA_AXDP", "EA_ABSW", "EA_ABSL", "EA_PCDP", "EA_PCXD", "EA_IMMD"
+};
+
+/* Emit the C++ function for the routine of opcode n */
+static void cpp_routine(int n, void (*proc)(void)) {
+	char label[5];
+	int i;
+
+	for(i = 0; cpp_names[i].proc != proc; i++) {
+		if(!cpp_names[i].proc) {
+			fprintf(stderr, "Bad news: no C++ template for opcode %04X\n", n);
+			exit(1);
+		}
+	}
+	sprintf(label, "%c%03X", ((n >> 12) & 0xF) + 'K', n & 0xFFF);
+	if(proc == i_illegal && !cpp_illegal[0]) strcpy(cpp_illegal, label);
+
+	if(cpp_first == cpp_last) {
+		emit("/* Opcode %04X */\n", n);
+	} else {
+		emit("/* Opcodes %04X - %04X */\n", cpp_first, cpp_last);
+	}
+	emit("static void %s(void) { %s<%d, %s, %s, %d, %d, %d, %d, %d>(",
+		label, cpp_names[i].name, main_size,
+		cpp_eaname[main_eamode], cpp_eaname[main_destmode],
+		main_reg, main_cc, main_dr, main_ir, main_qv
+	);
+	for(i = 0; i < cpp_ncycles; i++) {
+		emit("%s%d", i ? ", " : "", cpp_cycles[i]);
+	}
+	emit("); }\n");
+}
+
 /* Instruction definition routine */
 static void idef(
 	int n, int mask, int op, void(*proc)(void)
@@ -4523,7 +4623,11 @@ static void idef(
 			loop_t_cycles = 10;
 			loop_x_cycles = 16;
 		}
+		cpp_capture = cpp;
+		cpp_ncycles = 0;
 		proc();
+		cpp_capture = 0;
+		if(cpp) cpp_routine(n, proc);
 		if(cputype == 68010) {
 			if(loop_c_cycles > 14) {
 				fprintf(stderr,
@@ -5014,6 +5118,57 @@ static void tableentry(int last, int rl) {
 	if(cputype == 68010) emit("db %d\n", loopinfo[last]);
 }
 
+/*
+** C++ output: the prologue up to the runtime, and the jump table
+*/
+static void cpp_prefixes(void) {
+	emit("/*\n");
+	emit("** Generated by STARSCREAM version " VERSION "\n");
+	emit("** C++ output, compiled with Starscream/StarCpp.h\n");
+	emit("**\n");
+	emit("** Options:\n");
+	optiondump(codefile, "** *  ");
+	emit("*/\n\n");
+	emit("#define STAR_ID(name) %s##name\n", sourcename);
+	emit("#define STAR_SUB68K %d\n\n", 1);
+	emit("#ifndef STAR_READ_BYTE\n");
+	emit("extern \"C\" {\n");
+	emit("unsigned char S68K_RB(unsigned int Adr);\n");
+	emit("unsigned short S68K_RW(unsigned int Adr);\n");
+	emit("void S68K_WB(unsigned int Adr, unsigned char Data);\n");
+	emit("void S68K_WW(unsigned int Adr, unsigned short Data);\n");
+	emit("}\n");
+	emit("#define STAR_READ_BYTE S68K_RB\n");
+	emit("#define STAR_READ_WORD S68K_RW\n");
+	emit("#define STAR_WRITE_BYTE S68K_WB\n");
+	emit("#define STAR_WRITE_WORD S68K_WW\n");
+	emit("#endif\n\n");
+	emit("#if !defined(STAR_HOOKS) || STAR_HOOKS\n");
+	emit("#define STAR_HOOK(name) name##_cd\n");
+	emit("extern \"C\" {\n");
+	emit("extern unsigned int STAR_HOOK(hook_address), STAR_HOOK(hook_value), STAR_HOOK(hook_pc);\n");
+	emit("void STAR_HOOK(hook_exec)();\n");
+	emit("void STAR_HOOK(hook_read_byte)();\n");
+	emit("void STAR_HOOK(hook_read_word)();\n");
+	emit("void STAR_HOOK(hook_read_dword)();\n");
+	emit("void STAR_HOOK(hook_write_byte)();\n");
+	emit("void STAR_HOOK(hook_write_word)();\n");
+	emit("void STAR_HOOK(hook_write_dword)();\n");
+	emit("}\n");
+	emit("#endif\n\n");
+	emit("#include \"../StarCpp.h\"\n\n");
+}
+
+static void cpp_tableentry(int last, int rl) {
+	if(last == -1) {
+		emit("\t{ %s, %d },\n", cpp_illegal, rl);
+	} else {
+		emit("\t{ %c%03X, %d },\n",
+			((last >> 12) & 0xF) + 'K', last & 0xFFF, rl
+		);
+	}
+}
+
 /* Return the next parameter (or NULL if there isn't one */
 static char *getparameter(int *ip, int argc, char **argv) {
 	int i;
@@ -5046,6 +5201,7 @@ int main(int argc, char **argv) {
 			} else if(!strcmp("nohog"      , a)) { hog = 0;
 			} else if(!strcmp("hog"        , a)) { hog = 1;
 			} else if(!strcmp("quiet"      , a)) { quiet = 1;
+			} else if(!strcmp("cpp"        , a)) { cpp = 1;
 			} else if(!strcmp("addressbits", a)) {
 				int n;
 				char *s = getparameter(&i, argc, argv);
@@ -5132,6 +5288,10 @@ int main(int argc, char **argv) {
 		sprintf(default_sourcename, "s%d", cputype);
 		sourcename = default_sourcename;
 	}
+	if(cpp && (cputype != 68000 || addressbits != 24)) {
+		fprintf(stderr, "The C++ output is only for the 68000 with 24-bit addresses\n");
+		return 1;
+	}
 
 	/* Prepare to generate the code file */
 	linenum = 0;
@@ -5149,7 +5309,11 @@ int main(int argc, char **argv) {
 		);
 		optiondump(stderr, " *  ");
 	}
-	prefixes();
+	if(cpp) {
+		cpp_prefixes();
+	} else {
+		prefixes();
+	}
 	for(i = 0; i < 0x10000; i++) rproc[i] = -1;
 	/* Clear loop timings for 68010 */
 	if(cputype == 68010) {
@@ -5179,6 +5343,32 @@ int main(int argc, char **argv) {
 	*/
 	if(!quiet)
 		fprintf(stderr, "Building table: ");
+	if(cpp) {
+		emit("\nstatic const struct star_tableentry star_jmptblcomp[] = {\n");
+		last = -2;
+		rl = 0;
+		for(i = 0; i < 0x10000; i++) {
+			j = rproc[i];
+			if(j == last) {
+				rl++;
+			} else {
+				if(rl) cpp_tableentry(last, rl);
+				rl = 1;
+				last = j;
+			}
+		}
+		cpp_tableentry(last, rl);
+		emit("};\n\n");
+		emit("static void star_buildtable(void)\n{\n");
+		emit("\tstar_decompress(star_jmptblcomp);\n");
+		emit("}\n");
+		if(!quiet) {
+			fprintf(stderr, "done\n");
+			fprintf(stderr, "routine_counter = %d\n", routine_counter);
+		}
+		fclose(codefile);
+		return 0;
+	}
 	emit("section .bss\n");
 	emit("bits 32\n");
 	align(4);
@@ -23,6 +23,8 @@ struct ArchiveFormatInfo
 };
 
 static std::vector<ArchiveFormatInfo> s_formatInfos;
+static size_t s_maxSignatureSize;
+static void InitDecoderOnce();
 
 static std::string wstrToStr(const wchar_t* wstr)
 {
@@ -51,7 +53,7 @@ static std::vector<std::string> tokenize(const std::string & str, const std::str
 static std::string s_supportedFormatsFilter;
 const char* GetSupportedFormatsFilter()
 {
-	assert(!s_formatInfos.empty());
+	InitDecoderOnce();
 	if(s_supportedFormatsFilter.empty())
 	{
 		s_supportedFormatsFilter = "";
@@ -98,52 +100,41 @@ void InitDecoder()
 			memset(&info.guid, 0, 16);
 
 		s_formatInfos.push_back(info);
+		if(info.signature.size() > s_maxSignatureSize)
+			s_maxSignatureSize = info.signature.size();
 
 		VariantClear((VARIANTARG*)&var);
 	}
 }
 
+// the handlers are enumerated when the first file is looked at, not at startup
+static void InitDecoderOnce()
+{
+	if(s_formatInfos.empty())
+		InitDecoder();
+}
+
 void CleanupDecoder()
 {
 	s_formatInfos.clear();
 	s_supportedFormatsFilter.clear();
+	s_maxSignatureSize = 0;
 }
 
-#include "7z/CPP/7zip/Archive/Zip/ZipHandler.h"
-
-
-ArchiveFile::ArchiveFile(const char* filename)
+// returns the index of the format of an archive that starts with header, or -1 if it isn't one.
+// formats without a signature are recognized by the extension of filename
+static int DetectArchiveType(const char* filename, const unsigned char* header, int headerSize)
 {
-	assert(!s_formatInfos.empty());
-
-	m_typeIndex = -1;
-	m_numItems = 0;
-	m_items = NULL;
-	m_filename = NULL;
-
-	FILE* file = fopen(filename, "rb");
-	if(!file)
-		return;
-
-	m_filename = new char[strlen(filename)+1];
-	strcpy(m_filename, filename);
-
-	// detect archive type using format signature in file
-	for(size_t i = 0; i < s_formatInfos.size() && m_typeIndex < 0; i++)
+	for(size_t i = 0; i < s_formatInfos.size(); i++)
 	{
-		fseek(file, 0, SEEK_SET);
-		
 		std::string& formatSig = s_formatInfos[i].signature;
 		int len = formatSig.size();
 
-		if(len == 0)
+		if(len == 0 || len > headerSize)
 			continue; // because some formats have no signature
 
-		char* fileSig = (char*)_alloca(len);
-		fread(fileSig, 1, len, file);
-
-		if(!memcmp(formatSig.c_str(), fileSig, len))
-			m_typeIndex = i;
+		if(!memcmp(formatSig.c_str(), header, len))
+			return i;
 	}
 
 	// if no signature match has been found, detect archive type using filename.
@@ -151,7 +142,7 @@ ArchiveFile::ArchiveFile(const char* filename)
 	const char* fileExt = strrchr(filename, '.');
 	if(fileExt++)
 	{
-		for(size_t i = 0; i < s_formatInfos.size() && m_typeIndex < 0; i++)
+		for(size_t i = 0; i < s_formatInfos.size(); i++)
 		{
 			if(s_formatInfos[i].signature.empty())
 			{
@@ -159,15 +150,45 @@ ArchiveFile::ArchiveFile(const char* filename)
 				for(size_t j = 0; j < formatExts.size(); j++)
 				{
 					if(!_stricmp(formatExts[j].c_str(), fileExt))
-					{
-						m_typeIndex = i;
-						break;
-					}
+						return i;
 				}
 			}
 		}
 	}
 
+	return -1;
+}
+
+bool IsArchiveData(const char* filename, const unsigned char* data, int size)
+{
+	InitDecoderOnce();
+	return DetectArchiveType(filename, data, size) >= 0;
+}
+
+#include "7z/CPP/7zip/Archive/Zip/ZipHandler.h"
+
+
+ArchiveFile::ArchiveFile(const char* filename)
+{
+	InitDecoderOnce();
+
+	m_typeIndex = -1;
+	m_numItems = 0;
+	m_items = NULL;
+	m_filename = NULL;
+
+	FILE* file = fopen(filename, "rb");
+	if(!file)
+		return;
+
+	m_filename = new char[strlen(filename)+1];
+	strcpy(m_filename, filename);
+
+	// detect archive type using the format signatures, from one read of the start of the file
+	unsigned char* header = (unsigned char*)_alloca(s_maxSignatureSize + 1);
+	int headerSize = fread(header, 1, s_maxSignatureSize, file);
+	m_typeIndex = DetectArchiveType(filename, header, headerSize);
+
 	if(m_typeIndex < 0)
 	{
 		// uncompressed
@@ -8,6 +8,7 @@
 void InitDecoder();
 void CleanupDecoder();
 const char* GetSupportedFormatsFilter();
+bool IsArchiveData(const char* filename, const unsigned char* data, int size); // data is the file (or its start) and filename its name
 
 // simplest way of extracting a file after calling InitDecoder():
 // int size = ArchiveFile(filename).ExtractItem(0, buf, sizeof(buf));
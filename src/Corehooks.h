@@ -9,6 +9,7 @@ extern "C" {
 	extern uint32 hook_value_cd;
 	extern uint32 hook_pc;
 	extern uint32 hook_pc_cd;
+	extern uint32 hook_enabled;
 	
 	void hook_read_byte();
 	void hook_read_byte_cd();
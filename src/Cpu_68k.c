@@ -23,13 +23,13 @@ struct S68000CONTEXT Context_68K;
 
 struct STARSCREAM_PROGRAMREGION M68K_Fetch[] =
 {
-	{0x000000, 0x3FFFFF, (unsigned)0x000000},
-	{0xFF0000, 0xFFFFFF, (unsigned)&Ram_68k[0] - 0xFF0000},
-	{0xF00000, 0xF0FFFF, (unsigned)&Ram_68k[0] - 0xF00000},
-	{0xEF0000, 0xEFFFFF, (unsigned)&Ram_68k[0] - 0xEF0000},
-	{-1, -1, (unsigned) NULL},
-	{-1, -1, (unsigned) NULL},
-	{-1, -1, (unsigned) NULL}
+	{0x000000, 0x3FFFFF, (size_t)0x000000},
+	{0xFF0000, 0xFFFFFF, (size_t)&Ram_68k[0] - 0xFF0000},
+	{0xF00000, 0xF0FFFF, (size_t)&Ram_68k[0] - 0xF00000},
+	{0xEF0000, 0xEFFFFF, (size_t)&Ram_68k[0] - 0xEF0000},
+	{-1, -1, (size_t) NULL},
+	{-1, -1, (size_t) NULL},
+	{-1, -1, (size_t) NULL}
 };
 		
 struct STARSCREAM_DATAREGION M68K_Read_Byte[5] =
@@ -65,9 +65,9 @@ struct STARSCREAM_DATAREGION M68K_Write_Word[] =
 
 struct STARSCREAM_PROGRAMREGION S68K_Fetch[] =
 {
-	{0x000000, 0x07FFFF, (unsigned)&Ram_Prg[0]},
-	{-1, -1, (unsigned) NULL},
-	{-1, -1, (unsigned) NULL}
+	{0x000000, 0x07FFFF, (size_t)&Ram_Prg[0]},
+	{-1, -1, (size_t) NULL},
+	{-1, -1, (size_t) NULL}
 };
 		
 struct STARSCREAM_DATAREGION S68K_Read_Byte[] =
@@ -161,25 +161,25 @@ void M68K_Reset(int System_ID, char Hard)
 
 		M68K_Fetch[0].lowaddr = 0x000000;
 		M68K_Fetch[0].highaddr = Rom_Size - 1;
-		M68K_Fetch[0].offset = (unsigned) &Rom_Data[0] - 0x000000;
+		M68K_Fetch[0].offset = (size_t) &Rom_Data[0] - 0x000000;
 
 		M68K_Fetch[1].lowaddr = 0xFF0000;
 		M68K_Fetch[1].highaddr = 0xFFFFFF;
-		M68K_Fetch[1].offset = (unsigned)&Ram_68k[0] - 0xFF0000;
+		M68K_Fetch[1].offset = (size_t)&Ram_68k[0] - 0xFF0000;
 
 		if (System_ID == GENESIS)
 		{
 			M68K_Fetch[2].lowaddr = 0xF00000;
 			M68K_Fetch[2].highaddr = 0xF0FFFF;
-			M68K_Fetch[2].offset = (unsigned)&Ram_68k[0] - 0xF00000;
+			M68K_Fetch[2].offset = (size_t)&Ram_68k[0] - 0xF00000;
 			
 			M68K_Fetch[3].lowaddr = 0xEF0000;
 			M68K_Fetch[3].highaddr = 0xEFFFFF;
-			M68K_Fetch[3].offset = (unsigned)&Ram_68k[0] - 0xEF0000;
+			M68K_Fetch[3].offset = (size_t)&Ram_68k[0] - 0xEF0000;
 
 			M68K_Fetch[4].lowaddr = -1;
 			M68K_Fetch[4].highaddr = -1;
-			M68K_Fetch[4].offset = (unsigned) NULL;
+			M68K_Fetch[4].offset = (size_t) NULL;
 
 
 		}
@@ -189,15 +189,15 @@ void M68K_Reset(int System_ID, char Hard)
 
 			M68K_Fetch[2].lowaddr = 0xF00000;
 			M68K_Fetch[2].highaddr = 0xF0FFFF;
-			M68K_Fetch[2].offset = (unsigned)&Ram_68k[0] - 0xF00000;
+			M68K_Fetch[2].offset = (size_t)&Ram_68k[0] - 0xF00000;
 			
 			M68K_Fetch[3].lowaddr = 0xEF0000;
 			M68K_Fetch[3].highaddr = 0xEFFFFF;
-			M68K_Fetch[3].offset = (unsigned)&Ram_68k[0] - 0xEF0000;
+			M68K_Fetch[3].offset = (size_t)&Ram_68k[0] - 0xEF0000;
  
 			M68K_Fetch[4].lowaddr = -1;
 			M68K_Fetch[4].highaddr = -1;
-			M68K_Fetch[4].offset = (unsigned) NULL;
+			M68K_Fetch[4].offset = (size_t) NULL;
 		}
 		else if (System_ID == SEGACD)
 		{
@@ -211,20 +211,21 @@ void M68K_Reset(int System_ID, char Hard)
  
 			M68K_Fetch[4].lowaddr = 0xF00000;
 			M68K_Fetch[4].highaddr = 0xF0FFFF;
-			M68K_Fetch[4].offset = (unsigned)&Ram_68k[0] - 0xF00000;
+			M68K_Fetch[4].offset = (size_t)&Ram_68k[0] - 0xF00000;
 			
 			M68K_Fetch[5].lowaddr = 0xEF0000;
 			M68K_Fetch[5].highaddr = 0xEFFFFF;
-			M68K_Fetch[5].offset = (unsigned)&Ram_68k[0] - 0xEF0000;
+			M68K_Fetch[5].offset = (size_t)&Ram_68k[0] - 0xEF0000;
  
 			M68K_Fetch[6].lowaddr = -1;
 			M68K_Fetch[6].highaddr = -1;
-			M68K_Fetch[6].offset = (unsigned) NULL;
+			M68K_Fetch[6].offset = (size_t) NULL;
 		}
  	}
  	main68k_reset();
  
  	Init_Memory_M68K(System_ID);
+	M68K_Set_Read_Pages();
 }
 
 
@@ -263,7 +264,7 @@ void M68K_32X_Mode()
 		{
 			M68K_Fetch[0].lowaddr = 0x880000;
 			M68K_Fetch[0].highaddr = 0x8FFFFF;
-			M68K_Fetch[0].offset = (unsigned) &Rom_Data[0] - 0x880000;
+			M68K_Fetch[0].offset = (size_t) &Rom_Data[0] - 0x880000;
 
 			M68K_Fetch[1].lowaddr = 0x900000;
 			M68K_Fetch[1].highaddr = 0x9FFFFF;
@@ -271,23 +272,23 @@ void M68K_32X_Mode()
 
 			M68K_Fetch[2].lowaddr = 0xFF0000;
 			M68K_Fetch[2].highaddr = 0xFFFFFF;
-			M68K_Fetch[2].offset = (unsigned) &Ram_68k[0] - 0xFF0000;
+			M68K_Fetch[2].offset = (size_t) &Ram_68k[0] - 0xFF0000;
 
 			M68K_Fetch[3].lowaddr = 0x00;
 			M68K_Fetch[3].highaddr = 0xFF;
-			M68K_Fetch[3].offset = (unsigned)&_32X_Genesis_Rom[0] - 0x000000;
+			M68K_Fetch[3].offset = (size_t)&_32X_Genesis_Rom[0] - 0x000000;
 
 			M68K_Fetch[4].lowaddr = 0xEF0000;
 			M68K_Fetch[4].highaddr = 0xEFFFFF;
-			M68K_Fetch[4].offset = (unsigned) &Ram_68k[0] - 0xEF0000;
+			M68K_Fetch[4].offset = (size_t) &Ram_68k[0] - 0xEF0000;
 
 			M68K_Fetch[5].lowaddr = 0xF00000;
 			M68K_Fetch[5].highaddr = 0xF0FFFF;
-			M68K_Fetch[5].offset = (unsigned) &Ram_68k[0] - 0xF00000;
+			M68K_Fetch[5].offset = (size_t) &Ram_68k[0] - 0xF00000;
 		
 			M68K_Fetch[6].lowaddr = -1;
 			M68K_Fetch[6].highaddr = -1;
-			M68K_Fetch[6].offset = (unsigned) NULL;
+			M68K_Fetch[6].offset = (size_t) NULL;
 
 			M68K_Read_Byte_Table[0] = _32X_M68K_Read_Byte_Table[4 * 2];
 			M68K_Read_Word_Table[0] = _32X_M68K_Read_Word_Table[4 * 2];
@@ -296,27 +297,27 @@ void M68K_32X_Mode()
 		{
 			M68K_Fetch[0].lowaddr = 0x000100;
 			M68K_Fetch[0].highaddr = Rom_Size - 1;
-			M68K_Fetch[0].offset = (unsigned) &Rom_Data[0] - 0x000000;
+			M68K_Fetch[0].offset = (size_t) &Rom_Data[0] - 0x000000;
 
 			M68K_Fetch[1].lowaddr = 0xFF0000;
 			M68K_Fetch[1].highaddr = 0xFFFFFF;
-			M68K_Fetch[1].offset = (unsigned) &Ram_68k[0] - 0xFF0000;
+			M68K_Fetch[1].offset = (size_t) &Ram_68k[0] - 0xFF0000;
 
 			M68K_Fetch[2].lowaddr = 0x00;
 			M68K_Fetch[2].highaddr = 0xFF;
-			M68K_Fetch[2].offset = (unsigned)&_32X_Genesis_Rom[0] - 0x000000;
+			M68K_Fetch[2].offset = (size_t)&_32X_Genesis_Rom[0] - 0x000000;
 
 			M68K_Fetch[3].lowaddr = 0xF00000;
 			M68K_Fetch[3].highaddr = 0xF0FFFF;
-			M68K_Fetch[3].offset = (unsigned) &Ram_68k[0] - 0xF00000;
+			M68K_Fetch[3].offset = (size_t) &Ram_68k[0] - 0xF00000;
 		
 			M68K_Fetch[4].lowaddr = 0xEF0000;
 			M68K_Fetch[4].highaddr = 0xEFFFFF;
-			M68K_Fetch[4].offset = (unsigned) &Ram_68k[0] - 0xEF0000;
+			M68K_Fetch[4].offset = (size_t) &Ram_68k[0] - 0xEF0000;
 
 			M68K_Fetch[5].lowaddr = -1;
 			M68K_Fetch[5].highaddr = -1;
-			M68K_Fetch[5].offset = (unsigned) NULL;
+			M68K_Fetch[5].offset = (size_t) NULL;
 
 			M68K_Read_Byte_Table[0] = _32X_M68K_Read_Byte_Table[4 * 2 + 1];
 			M68K_Read_Word_Table[0] = _32X_M68K_Read_Word_Table[4 * 2 + 1];
@@ -326,27 +327,29 @@ void M68K_32X_Mode()
 	{
 		M68K_Fetch[0].lowaddr = 0x000000;
 		M68K_Fetch[0].highaddr = Rom_Size - 1;
-		M68K_Fetch[0].offset = (unsigned) &Rom_Data[0] - 0x000000;
+		M68K_Fetch[0].offset = (size_t) &Rom_Data[0] - 0x000000;
 
 		M68K_Fetch[1].lowaddr = 0xFF0000;
 		M68K_Fetch[1].highaddr = 0xFFFFFF;
-		M68K_Fetch[1].offset = (unsigned) &Ram_68k[0] - 0xFF0000;
+		M68K_Fetch[1].offset = (size_t) &Ram_68k[0] - 0xFF0000;
 
 		M68K_Fetch[2].lowaddr = 0xF00000;
 		M68K_Fetch[2].highaddr = 0xF0FFFF;
-		M68K_Fetch[2].offset = (unsigned) &Ram_68k[0] - 0xF00000;
+		M68K_Fetch[2].offset = (size_t) &Ram_68k[0] - 0xF00000;
 		
 		M68K_Fetch[3].lowaddr = 0xEF0000;
 		M68K_Fetch[3].highaddr = 0xEFFFFF;
-		M68K_Fetch[3].offset = (unsigned) &Ram_68k[0] - 0xEF0000;
+		M68K_Fetch[3].offset = (size_t) &Ram_68k[0] - 0xEF0000;
 
 		M68K_Fetch[4].lowaddr = -1;
 		M68K_Fetch[4].highaddr = -1;
-		M68K_Fetch[4].offset = (unsigned) NULL;
+		M68K_Fetch[4].offset = (size_t) NULL;
 
 		M68K_Read_Byte_Table[0] = _32X_M68K_Read_Byte_Table[0];
 		M68K_Read_Word_Table[0] = _32X_M68K_Read_Word_Table[0];
 	}
+
+	M68K_Set_Read_Pages();
 }
 
 
@@ -357,12 +360,14 @@ void M68K_Set_32X_Rom_Bank()
 {
 	if (_32X_ADEN && !_32X_RV)
 	{
-		M68K_Fetch[1].offset = (unsigned) &Rom_Data[Bank_SH2 << 20] - 0x900000;
+		M68K_Fetch[1].offset = (size_t) &Rom_Data[Bank_SH2 << 20] - 0x900000;
 
 		M68K_Read_Byte_Table[(9 * 2) + 0] = _32X_M68K_Read_Byte_Table[(Bank_SH2 << 1) + 0];
 		M68K_Read_Byte_Table[(9 * 2) + 1] = _32X_M68K_Read_Byte_Table[(Bank_SH2 << 1) + 1];
 		M68K_Read_Word_Table[(9 * 2) + 0] = _32X_M68K_Read_Word_Table[(Bank_SH2 << 1) + 0];
 		M68K_Read_Word_Table[(9 * 2) + 1] = _32X_M68K_Read_Word_Table[(Bank_SH2 << 1) + 1];
+
+		M68K_Set_Read_Pages();
 	}
 	else
 	{
@@ -372,12 +377,43 @@ void M68K_Set_32X_Rom_Bank()
 }
 
 
+/*** M68K_Set_Read_Pages - rebuild the direct read pages  ***
+ *** - Called each time M68K_Read_Byte/Word_Table change - ***/
+
+void M68K_Set_Read_Pages()
+{
+	unsigned char *base;
+	int i, j, rom;
+
+	// only the plain ROM handlers (Genesis table 0x00-0x0B) go direct,
+	// Rom4 checks SRAM and everything else has side effects
+
+	for(i = 0; i < 0x20; i++)
+	{
+		base = NULL;
+
+		for(rom = 0; rom < 0x0C; rom++)
+		{
+			if ((rom != 4) && (M68K_Read_Byte_Table[i] == Genesis_M68K_Read_Byte_Table[rom])
+				&& (M68K_Read_Word_Table[i] == Genesis_M68K_Read_Word_Table[rom]))
+			{
+				base = &Rom_Data[rom << 19];
+				break;
+			}
+		}
+
+		for(j = 0; j < 8; j++)
+			M68K_Read_Page[(i << 3) + j] = base ? base + (j << 16) : NULL;
+	}
+}
+
+
 /*** M68K_Set_Prg_Ram - modify bank Prg_Ram fetch ***
  ***   - Called only during SEGA CD emulation -   ***/
 
 void M68K_Set_Prg_Ram()
 {
-	M68K_Fetch[3].offset = (unsigned) &Ram_Prg[Bank_M68K] - 0x020000;
+	M68K_Fetch[3].offset = (size_t) &Ram_Prg[Bank_M68K] - 0x020000;
 }
 
 
@@ -391,49 +427,49 @@ void MS68K_Set_Word_Ram(void)
 		case 0:		// Mode 2M -> Assigned to Main CPU
 			M68K_Fetch[2].lowaddr = 0x200000;
 			M68K_Fetch[2].highaddr = 0x23FFFF;
-			M68K_Fetch[2].offset = (unsigned) &Ram_Word_2M[0] - 0x200000;
+			M68K_Fetch[2].offset = (size_t) &Ram_Word_2M[0] - 0x200000;
 
 //			S68K_Fetch[1].lowaddr = -1;
 //			S68K_Fetch[1].highaddr = -1;		
-//			S68K_Fetch[1].offset = (unsigned) NULL;
+//			S68K_Fetch[1].offset = (size_t) NULL;
 
 			S68K_Fetch[1].lowaddr = 0x080000;		// why not after all...
 			S68K_Fetch[1].highaddr = 0x0BFFFF;		
-			S68K_Fetch[1].offset = (unsigned) &Ram_Word_2M[0] - 0x080000;
+			S68K_Fetch[1].offset = (size_t) &Ram_Word_2M[0] - 0x080000;
 			break;
 
 		case 1:		// Mode 2M -> Assigned to Sub CPU
 //			M68K_Fetch[2].lowaddr = -1;
 //			M68K_Fetch[2].highaddr = -1;
-//			M68K_Fetch[2].offset = (unsigned) NULL;
+//			M68K_Fetch[2].offset = (size_t) NULL;
 
 			M68K_Fetch[2].lowaddr = 0x200000;		// why not after all...
 			M68K_Fetch[2].highaddr = 0x23FFFF;
-			M68K_Fetch[2].offset = (unsigned) &Ram_Word_2M[0] - 0x200000;
+			M68K_Fetch[2].offset = (size_t) &Ram_Word_2M[0] - 0x200000;
 
 			S68K_Fetch[1].lowaddr = 0x080000;
 			S68K_Fetch[1].highaddr = 0x0BFFFF;		
-			S68K_Fetch[1].offset = (unsigned) &Ram_Word_2M[0] - 0x080000;
+			S68K_Fetch[1].offset = (size_t) &Ram_Word_2M[0] - 0x080000;
 			break;
 
 		case 2:		// Mode 1M -> Bank 0 to Main CPU
 			M68K_Fetch[2].lowaddr = 0x200000;			// Bank 0
 			M68K_Fetch[2].highaddr = 0x21FFFF;
-			M68K_Fetch[2].offset = (unsigned) &Ram_Word_1M[0] - 0x200000;
+			M68K_Fetch[2].offset = (size_t) &Ram_Word_1M[0] - 0x200000;
 
 			S68K_Fetch[1].lowaddr = 0x0C0000;			// Bank 1
 			S68K_Fetch[1].highaddr = 0x0DFFFF;		
-			S68K_Fetch[1].offset = (unsigned) &Ram_Word_1M[0x20000] - 0x0C0000;
+			S68K_Fetch[1].offset = (size_t) &Ram_Word_1M[0x20000] - 0x0C0000;
 			break;
 
 		case 3:		// Mode 1M -> Bank 0 to Sub CPU
 			M68K_Fetch[2].lowaddr = 0x200000;			// Bank 1
 			M68K_Fetch[2].highaddr = 0x21FFFF;
-			M68K_Fetch[2].offset = (unsigned) &Ram_Word_1M[0x20000] - 0x200000;
+			M68K_Fetch[2].offset = (size_t) &Ram_Word_1M[0x20000] - 0x200000;
 
 			S68K_Fetch[1].lowaddr = 0x0C0000;			// Bank 0
 			S68K_Fetch[1].highaddr = 0x0DFFFF;		
-			S68K_Fetch[1].offset = (unsigned) &Ram_Word_1M[0] - 0x0C0000;
+			S68K_Fetch[1].offset = (size_t) &Ram_Word_1M[0] - 0x0C0000;
 			break;
 	}
 }
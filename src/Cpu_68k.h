@@ -17,6 +17,7 @@ void M68K_Reset_CPU();
 void S68K_Reset_CPU();
 void M68K_32X_Mode();
 void M68K_Set_32X_Rom_Bank();
+void M68K_Set_Read_Pages();
 void M68K_Set_Prg_Ram();
 void MS68K_Set_Word_Ram();
 
@@ -24,6 +24,11 @@
 #include "drawutil.h"
 #include "luascript.h"
 #include "automation.h"
+#include "plugin.h"
+#include "ram_history.h"
+#include "frame_prof.h"
+#include "state_hash.h"
+#include "startup_prof.h"
 
 LPDIRECTDRAW lpDD_Init;
 LPDIRECTDRAW4 lpDD;
@@ -137,6 +142,8 @@ int Update_Frame_Hook()
 	// because it needs to run immediately before SetCurrentInputCondensed() might get called
 	// in order for joypad.get() and joypad.set() to work as expected
 
+	Frame_Prof_Begin();
+
 	#ifdef SONICCAMHACK
 	int retval = SonicCamHack();
 	#else
@@ -176,6 +183,21 @@ int Update_Frame_Hook()
 
 	CallRegisteredLuaFunctions(LUACALL_AFTEREMULATION);
 
+	if (PluginFrameHooksActive)
+		Plugin_FrameHook(FrameCount);
+
+	if (RamHistory_OnFrame(FrameCount))
+	{
+		ExitReason = "ramhist_done";
+		PostMessage(HWnd, WM_CLOSE, 0, 0);
+	}
+
+	if (State_Hash_OnFrame(FrameCount))
+	{
+		ExitReason = "hash_diverged";
+		PostMessage(HWnd, WM_CLOSE, 0, 0);
+	}
+
 	CallRegisteredLuaFunctions(LUACALL_AFTEREMULATIONGUI);
 
 	// Automation: capture/compare screenshots
@@ -185,6 +207,7 @@ int Update_Frame_Hook()
 		(VDP_REG_SET4 & 0x1) ? 1 : 0,
 		(VDP_REG_SET2 & 0x8) ? 1 : 0);
 
+	Frame_Prof_End();
 	return retval;
 }
 int Update_Frame_Fast_Hook()
@@ -193,9 +216,27 @@ int Update_Frame_Fast_Hook()
 	// because it needs to run immediately before SetCurrentInputCondensed() might get called
 	// in order for joypad.get() and joypad.set() to work as expected
 
+	Frame_Prof_Begin();
+
 	int retval = Update_Frame_Fast();
 
 	CallRegisteredLuaFunctions(LUACALL_AFTEREMULATION);
+
+	if (PluginFrameHooksActive)
+		Plugin_FrameHook(FrameCount);
+
+	if (RamHistory_OnFrame(FrameCount))
+	{
+		ExitReason = "ramhist_done";
+		PostMessage(HWnd, WM_CLOSE, 0, 0);
+	}
+
+	if (State_Hash_OnFrame(FrameCount))
+	{
+		ExitReason = "hash_diverged";
+		PostMessage(HWnd, WM_CLOSE, 0, 0);
+	}
+
 	Update_RAM_Search();
 	
 	// Handle frame-based tracing even in fast mode
@@ -204,6 +245,7 @@ int Update_Frame_Fast_Hook()
 		Trace_OnFrame(FrameCount);
 	}
 	
+	Frame_Prof_End();
 	return retval;
 }
 
@@ -264,6 +306,35 @@ int Init_DDraw(HWND hWnd)
 	if (Full_Screen) Rend = Render_FS;
 	else Rend = Render_W;
 
+	// -batch shows nothing (Flip and the clears bail without lpDD), the screen is only
+	// rendered to MD_Screen/MD_Screen32 in the pixel format of the display mode
+	if (Batch_Startup)
+	{
+		DEVMODE dm;
+
+		memset(&dm, 0, sizeof(dm));
+		dm.dmSize = sizeof(dm);
+		EnumDisplaySettings(NULL, ENUM_CURRENT_SETTINGS, &dm);
+
+		if (!(Mode_555 & 2))
+		{
+			Mode_555 = (dm.dmBitsPerPel == 15) ? 1 : 0;
+			Recalculate_Palettes();
+		}
+
+		Bits32 = (dm.dmBitsPerPel > 16) ? 1 : 0;
+
+		if(Bits32 && !oldBits32)
+			for(int i = 0 ; i < 336 * 240 ; i++)
+				MD_Screen32[i] = DrawUtil::Pix16To32(MD_Screen[i]);
+
+		if(!Bits32 && oldBits32)
+			for(int i = 0 ; i < 336 * 240 ; i++)
+				MD_Screen[i] = DrawUtil::Pix32To16(MD_Screen32[i]);
+
+		return 1;
+	}
+
 	if (FAILED(DirectDrawCreate(NULL, &lpDD_Init, NULL)))
 		return Init_Fail(hWnd, "Error with DirectDrawCreate !");
 
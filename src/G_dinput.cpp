@@ -1285,16 +1285,23 @@ void Update_Input()
 	HRESULT rval;
 	int i;
 
-	rval = lpDIDKeyboard->GetDeviceState(256, &Keys);
-
-	if ((rval == DIERR_INPUTLOST) | (rval == DIERR_NOTACQUIRED))
+	if (!lpDIDKeyboard)	// -batch runs without DirectInput
+	{
+		memset(Keys, 0, sizeof(Keys));
+	}
+	else
 	{
-		Restore_Input();
-
 		rval = lpDIDKeyboard->GetDeviceState(256, &Keys);
+
 		if ((rval == DIERR_INPUTLOST) | (rval == DIERR_NOTACQUIRED))
 		{
-			memset(Keys, 0, sizeof(Keys));
+			Restore_Input();
+
+			rval = lpDIDKeyboard->GetDeviceState(256, &Keys);
+			if ((rval == DIERR_INPUTLOST) | (rval == DIERR_NOTACQUIRED))
+			{
+				memset(Keys, 0, sizeof(Keys));
+			}
 		}
 	}
 
@@ -34,6 +34,12 @@
 #include "vdp_32X.h"
 #include "LC89510.h"
 #include "gfx_cd.h"
+#include "m68k_verify.h"
+#include "z80_verify.h"
+#include "frame_prof.h"
+#include "state_hash.h"
+#include "startup_prof.h"
+#include "orchestrator.h"
 #include "cd_aspi.h"
 #include "net.h"
 #include "pcm.h"
@@ -41,6 +47,7 @@
 #include "CCnet.h"
 #include "wave.h"
 #include "ram_search.h"
+#include "ram_history.h"
 #include "movie.h"
 #include "ramwatch.h"
 #include "luascript.h"
@@ -62,6 +69,7 @@ extern "C" void Read_To_68K_Space(int adr);
 #define uint32 unsigned int
 
 #include "tracer.h"
+#include "plugin.h"
 bool trace_map=0;
 bool hook_trace=0;
 bool trace_indent=false;
@@ -1834,7 +1842,7 @@ BOOL Init(HINSTANCE hInst, int nCmdShow)
 
 	timeBeginPeriod(1);
 
-	InitDecoder();
+	// the archive handlers are loaded when the first file is opened (7zip.cpp)
 
 	Net_Play = 0;
 	Full_Screen = -1;
@@ -1915,6 +1923,7 @@ BOOL Init(HINSTANCE hInst, int nCmdShow)
 		NULL);
 
 	if (!HWnd) return FALSE;
+	Startup_Mark("window");
 
 	Identify_CPU();
 	i = GetVersion();
@@ -1935,30 +1944,46 @@ BOOL Init(HINSTANCE hInst, int nCmdShow)
 	M68K_Init();
 	S68K_Init();
 	Z80_Init();
+	Startup_Mark("cpus");
 
 	YM2612_Init(CLOCK_NTSC / 7, Sound_Rate, YM2612_Improv);
 	PSG_Init(CLOCK_NTSC / 15, Sound_Rate);
 	PWM_Init();
+	Startup_Mark("sound_chips");
 
 	Build_Main_Menu(); // needs to be before config is loaded so Gens_Menu_Width is valid when the render mode gets set
+	Startup_Mark("menu");
 
 	strcpy(Str_Tmp, Gens_Path);
 	strcat(Str_Tmp, "\\gens.cfg");
 	Load_Config(Str_Tmp, NULL);
+	Startup_Mark("config");
 
-	ShowWindow(HWnd, nCmdShow);
-
-	if (!Init_Input(hInst, HWnd))
+	if (Batch_Startup)
 	{
-		End_Sound();
-		End_DDraw();
-		return FALSE;
+		Sound_Enable = 0; // same as -nosound, DirectSound is only opened when a game starts with sound on
+	}
+	else
+	{
+		ShowWindow(HWnd, nCmdShow);
+		Startup_Mark("show_window");
+
+		if (!Init_Input(hInst, HWnd))
+		{
+			End_Sound();
+			End_DDraw();
+			return FALSE;
+		}
+		Startup_Mark("input");
 	}
 
 	Init_CD_Driver();
+	Startup_Mark("cd_driver");
 	Init_Network();
+	Startup_Mark("network");
 	Init_Tab();
 	Build_Main_Menu();
+	Startup_Mark("tables");
 
 	DragAcceptFiles(HWnd, TRUE);
 
@@ -1994,6 +2019,15 @@ BOOL Init(HINSTANCE hInst, int nCmdShow)
 
 void End_All(void)
 {
+	GFX_CD_Verify_Report();
+	M68K_Verify_Report();
+	Z80_Verify_Report();
+	Frame_Prof_Close();
+	State_Hash_Close();
+	RamHistory_Finish();
+	Orchestrator_Worker_Close();
+	VDP_Render_Stop();
+	Plugin_UnloadAll();
 	Free_Rom(Game);
 	End_DDraw();
 	End_Input();
@@ -2186,12 +2220,19 @@ int PASCAL WinMain(HINSTANCE hInst,	HINSTANCE hPrevInst, LPSTR lpCmdLine, int nC
 	MSG msg;
 	long int OldFrame=-1;//Modif
 
+	Startup_Begin();
+
+	// has to be known before Init, the rest of the command line is parsed after it
+	// (the orchestrator never emulates, its workers get -batch)
+	Batch_Startup = strstr(lpCmdLine, "-batch") != NULL || strstr(lpCmdLine, "-variants") != NULL;
+
 	InitMovie(&MainMovie);
 
 	Init(hInst, nCmdShow);
 
 	// Have to do it *before* load by command line
 	Init_Genesis_Bios();
+	Startup_Mark("bios");
 
 	if (lpCmdLine[0])ParseCmdLine(lpCmdLine, HWnd);
 
@@ -2242,7 +2283,7 @@ int PASCAL WinMain(HINSTANCE hInst,	HINSTANCE hPrevInst, LPSTR lpCmdLine, int nC
 						if(frameadvSkipLag)
 						{
 							frameadvSkipLag_Rewind_Input_Buffer[frameadvSkipLag_Rewind_State_Buffer_Index%2] = GetLastInputCondensed();
-							Save_State_To_Buffer(frameadvSkipLag_Rewind_State_Buffer[frameadvSkipLag_Rewind_State_Buffer_Index++%2]);
+							Save_Snapshot_To_Buffer(frameadvSkipLag_Rewind_State_Buffer[frameadvSkipLag_Rewind_State_Buffer_Index++%2]);
 							frameadvSkipLag_Rewind_State_Buffer_Valid = true;
 						}
 
@@ -2309,7 +2350,7 @@ int PASCAL WinMain(HINSTANCE hInst,	HINSTANCE hPrevInst, LPSTR lpCmdLine, int nC
 
 					frameadvSkipLag_Rewind_Input_Buffer[frameadvSkipLag_Rewind_State_Buffer_Index%2] = GetLastInputCondensed();
 					SetNextInputCondensed(frameadvSkipLag_Rewind_Input_Buffer[frameadvSkipLag_Rewind_State_Buffer_Index%2]); // to reduce user confusion, this line prevents the input display from changing more than once per frame advance by applying the initially accepted input to all following auto-skipped lag frames
-					Save_State_To_Buffer(frameadvSkipLag_Rewind_State_Buffer[frameadvSkipLag_Rewind_State_Buffer_Index++%2]);
+					Save_Snapshot_To_Buffer(frameadvSkipLag_Rewind_State_Buffer[frameadvSkipLag_Rewind_State_Buffer_Index++%2]);
 					frameadvSkipLag_Rewind_State_Buffer_Valid = true;
 
 					// update the graphics in case they're changing during non-input frames
@@ -2339,7 +2380,7 @@ int PASCAL WinMain(HINSTANCE hInst,	HINSTANCE hPrevInst, LPSTR lpCmdLine, int nC
 						Do_VDP_Only();
 	#else
 						// re-run the last frame to generate its graphics properly
-						Load_State_From_Buffer(frameadvSkipLag_Rewind_State_Buffer[frameadvSkipLag_Rewind_State_Buffer_Index%2]);
+						Load_Snapshot_From_Buffer(frameadvSkipLag_Rewind_State_Buffer[frameadvSkipLag_Rewind_State_Buffer_Index%2]);
 						SetNextInputCondensed(frameadvSkipLag_Rewind_Input_Buffer[(frameadvSkipLag_Rewind_State_Buffer_Index+1)%2]); // being careful to re-run the last frame with the same input as before
 						Update_Emulation_One(HWnd);
 	#endif
@@ -2389,9 +2430,13 @@ int PASCAL WinMain(HINSTANCE hInst,	HINSTANCE hPrevInst, LPSTR lpCmdLine, int nC
 
 	End_Sound(); //Modif N - making sure sound doesn't stutter upon exit
 
-	strcpy(Str_Tmp, Gens_Path);
-	strcat(Str_Tmp, "Gens.cfg");
-	Save_Config(Str_Tmp);
+	// a batch run turned the sound off itself, and parallel workers would all write the same file
+	if (!Batch_Startup)
+	{
+		strcpy(Str_Tmp, Gens_Path);
+		strcat(Str_Tmp, "Gens.cfg");
+		Save_Config(Str_Tmp);
+	}
 
 	End_All(); //Modif N
 
@@ -16,6 +16,9 @@
 #include "z80.h"
 #include "vdp_io.h"
 #include "vdp_rend.h"
+#include "pixconv.h"
+#include "idle_loop.h"
+#include "frame_prof.h"
 #include "vdp_32X.h"
 #include "io.h"
 #include "misc.h"
@@ -33,6 +36,7 @@
 #include "scrshot.h"
 #include "ram_search.h"
 #include "luascript.h"
+#include "tracer.h"
 
 
 // uncomment this to run a simple test every frame for potential desyncs
@@ -1034,13 +1038,11 @@ void Render_MD_Screen_()
 	int Line;
 	for(Line = 0; Line < VDP_Num_Vis_Lines; Line++)
 	{
-		for (unsigned long Pixel = TAB336[Line] + 8; Pixel < TAB336[Line] + 336; Pixel++)
-		{
-			if (bits == 32)
-				MD_Screen32[Pixel] = Palette32[Screen_16X[Pixel]];
-			if (bits == 16)
-				MD_Screen[Pixel] = Palette[Screen_16X[Pixel]];
-		}
+		unsigned long Pixel = TAB336[Line] + 8;
+		if (bits == 32)
+			PixConv_Pal32(&MD_Screen32[Pixel], &Screen_16X[Pixel], Palette32, 336 - 8);
+		if (bits == 16)
+			PixConv_Pal16(&MD_Screen[Pixel], &Screen_16X[Pixel], Palette, 336 - 8);
 	}
 	// fixes for filters
 	// bottom row
@@ -1074,6 +1076,8 @@ void Render_MD_Screen_()
 
 void Render_MD_Screen()
 {
+	PROF_SCOPE(PROF_SCREEN);
+
 	if (Bits32)
 		Render_MD_Screen_<32>();
 	else
@@ -1197,6 +1201,8 @@ void Render_MD_Screen32X_2()
 
 void Render_MD_Screen32X()
 {
+	PROF_SCOPE(PROF_SCREEN);
+
 	if (!_32X_Plane_On)
 		Render_MD_Screen();
 	else if (Bits32)
@@ -1221,6 +1227,7 @@ int Do_Genesis_Frame(bool fast)
 
 	if(!disableSound)
 	{
+		PROF_SCOPE(PROF_SOUND);
 		YM_Buf[0] = PSG_Buf[0] = LeftAudioBuffer();
 		YM_Buf[1] = PSG_Buf[1] = RightAudioBuffer();
 	}
@@ -1232,6 +1239,7 @@ int Do_Genesis_Frame(bool fast)
 	z80_Clear_Odo(&M_Z80);
 
 	Patch_Codes();
+	Update_Hook_Enabled();
 
 	VRam_Flag = 1;
 
@@ -1249,6 +1257,7 @@ int Do_Genesis_Frame(bool fast)
 	{
 		if(!disableSound)
 		{
+			PROF_SCOPE(PROF_SOUND);
 			buf[0] = LeftAudioBuffer() + Sound_Extrapol[VDP_Current_Line][0];
 			buf[1] = RightAudioBuffer() + Sound_Extrapol[VDP_Current_Line][0];
 			YM2612_DacAndTimers_Update(buf, Sound_Extrapol[VDP_Current_Line][1]);
@@ -1262,7 +1271,7 @@ int Do_Genesis_Frame(bool fast)
 		if (DMAT_Length) main68k_addCycles(Update_DMA());
 		VDP_Status |= 0x0004;			// HBlank = 1
 //		main68k_exec(Cycles_M68K - 436);
-		main68k_exec(Cycles_M68K - 404);
+		Idle_M68K_Exec(Cycles_M68K - 404);
 		VDP_Status &= 0xFFFB;			// HBlank = 0
 
 		if (--HInt_Counter < 0)
@@ -1273,13 +1282,14 @@ int Do_Genesis_Frame(bool fast)
 		}
 
 		if (!fast)
-			Render_Line();
+			Render_Line_Selected();
 
-		main68k_exec(Cycles_M68K);
-		if (Z80_State == 3) z80_Exec(&M_Z80, Cycles_Z80);
+		Idle_M68K_Exec(Cycles_M68K);
+		if (Z80_State == 3) Idle_Z80_Exec(Cycles_Z80);
 		else z80_Set_Odo(&M_Z80, Cycles_Z80);
 	}
 
+	VDP_Render_Sync();				// lines still being rendered on the render thread
 	if (!fast)
 	{
 		FakeVDPScreen = false;
@@ -1288,6 +1298,7 @@ int Do_Genesis_Frame(bool fast)
 
 	if(!disableSound)
 	{
+		PROF_SCOPE(PROF_SOUND);
 		buf[0] = LeftAudioBuffer() + Sound_Extrapol[VDP_Current_Line][0];
 		buf[1] = RightAudioBuffer() + Sound_Extrapol[VDP_Current_Line][0];
 		YM2612_DacAndTimers_Update(buf, Sound_Extrapol[VDP_Current_Line][1]);
@@ -1306,8 +1317,8 @@ int Do_Genesis_Frame(bool fast)
 	}
 
 	VDP_Status |= 0x000C;			// VBlank = 1 et HBlank = 1 (retour de balayage vertical en cours)
-	main68k_exec(Cycles_M68K - 360);
-	if (Z80_State == 3) z80_Exec(&M_Z80, Cycles_Z80 - 168);
+	Idle_M68K_Exec(Cycles_M68K - 360);
+	if (Z80_State == 3) Idle_Z80_Exec(Cycles_Z80 - 168);
 	else z80_Set_Odo(&M_Z80, Cycles_Z80 - 168);
 
 	VDP_Status &= 0xFFFB;			// HBlank = 0
@@ -1317,14 +1328,15 @@ int Do_Genesis_Frame(bool fast)
 	Update_IRQ_Line();
 	z80_Interrupt(&M_Z80, 0xFF);
 
-	main68k_exec(Cycles_M68K);
-	if (Z80_State == 3) z80_Exec(&M_Z80, Cycles_Z80);
+	Idle_M68K_Exec(Cycles_M68K);
+	if (Z80_State == 3) Idle_Z80_Exec(Cycles_Z80);
 	else z80_Set_Odo(&M_Z80, Cycles_Z80);
 
 	for(VDP_Current_Line++; VDP_Current_Line < VDP_Num_Lines; VDP_Current_Line++)
 	{
 		if(!disableSound)
 		{
+			PROF_SCOPE(PROF_SOUND);
 			buf[0] = LeftAudioBuffer() + Sound_Extrapol[VDP_Current_Line][0];
 			buf[1] = RightAudioBuffer() + Sound_Extrapol[VDP_Current_Line][0];
 			YM2612_DacAndTimers_Update(buf, Sound_Extrapol[VDP_Current_Line][1]);
@@ -1338,21 +1350,23 @@ int Do_Genesis_Frame(bool fast)
 		if (DMAT_Length) main68k_addCycles(Update_DMA());
 		VDP_Status |= 0x0004;					// HBlank = 1
 //		main68k_exec(Cycles_M68K - 436);
-		main68k_exec(Cycles_M68K - 404);
+		Idle_M68K_Exec(Cycles_M68K - 404);
 		VDP_Status &= 0xFFFB;					// HBlank = 0
 
-		main68k_exec(Cycles_M68K);
-		if (Z80_State == 3) z80_Exec(&M_Z80, Cycles_Z80);
+		Idle_M68K_Exec(Cycles_M68K);
+		if (Z80_State == 3) Idle_Z80_Exec(Cycles_Z80);
 		else z80_Set_Odo(&M_Z80, Cycles_Z80);
 	}
 
 	if(!disableSound)
 	{
+		PROF_SCOPE(PROF_SOUND);
 		PSG_Special_Update();
 		YM2612_Special_Update();
 	}
 	if(!disableSound && !disableSound2)
 	{
+		PROF_SCOPE(PROF_SOUND);
 		if (WAV_Dumping) Update_WAV_Dump();
 		if (AVISound!=0 && AVIRecording!=0 && (AVIWaitMovie==0 || MainMovie.Status == MOVIE_PLAYING || MainMovie.Status == MOVIE_FINISHED)) Update_WAV_Dump_AVI();
 		if (GYM_Dumping) Update_GYM_Dump((unsigned char) 0, (unsigned char) 0, (unsigned char) 0);
@@ -1402,7 +1416,8 @@ int Do_VDP_Refresh()
 		{
 			if(FakeVDPScreen)
 				for(VDP_Current_Line = 0; VDP_Current_Line < VDP_Num_Vis_Lines; VDP_Current_Line++)
-					Render_Line();
+					Render_Line_Selected();
+			VDP_Render_Sync();
 			Render_MD_Screen();
 		}
 		else // emulation hasn't started so just set all pixels to black
@@ -1725,6 +1740,105 @@ void Reset_32X()
 	for(i = 0; i < 0x400; i++) _32X_MSH2_Rom[i + 0x36C] = _32X_Rom[i + 0x400];
 }
 
+// main68k_exec / sub68k_exec / z80_Exec(&M_Z80) with their time charged to the profiler (frame_prof.h),
+// the Genesis frame gets it through the Idle_*_Exec functions
+static inline void Prof_M68K_Exec(int Odo)
+{
+	PROF_SCOPE(PROF_M68K);
+	main68k_exec(Odo);
+}
+
+static inline void Prof_S68K_Exec(int Odo)
+{
+	PROF_SCOPE(PROF_S68K);
+	sub68k_exec(Odo);
+}
+
+static inline void Prof_Z80_Exec(int Odo)
+{
+	PROF_SCOPE(PROF_Z80);
+	z80_Exec(&M_Z80, Odo);
+}
+
+// 32X CPU interleaving (-32x-sync)
+// Strict: the 68000, both SH2 and the PWM timer take turns of p_i/p_j/p_k/p_l cycles.
+// Adaptive: a turn gets twice as long, up to about a line, after each turn in which none of them
+// touched the 32X system registers (communication ports, interrupt control, DREQ, PWM) or handed
+// SDRAM / frame buffer data to another CPU, and goes back to the strict length after one that did.
+// It starts over every frame, so it only depends on the emulated state and movies / savestates stay
+// in sync with the same setting.
+int _32X_Sync = _32X_SYNC_STRICT;
+static int _32X_Turn_Length;
+
+// Hand-offs through shared memory, tracked by 16 byte line over the SDRAM and both frame buffers.
+// A line one CPU wrote this frame and another one then reads, or one another CPU read or wrote that
+// is then written, counts as a sync hit. Each CPU's first read of a line since the last write is the
+// only one looked at, private data and data nobody writes during the frame never count.
+#define SYNC_LINES (0x80000 >> 4)
+static unsigned char Sync_Writer[SYNC_LINES];		// CPU + 1 of the last write this frame, 0 for none
+static unsigned char Sync_Readers[SYNC_LINES];		// CPUs (bit per CPU) that read it since
+
+extern "C" void _32X_Sync_Shared(unsigned int offset, int access)
+{
+	const unsigned int line = (offset >> 4) & (SYNC_LINES - 1);
+	const unsigned char self = (unsigned char)((access >> 1) + 1);
+	const unsigned char bit = (unsigned char)(1 << (access >> 1));
+	const unsigned char writer = Sync_Writer[line];
+
+	if (access & 1)
+	{
+		if ((writer && writer != self) || (Sync_Readers[line] & ~bit))
+			_32X_Sync_Hits++;
+		Sync_Writer[line] = self;
+		Sync_Readers[line] = 0;
+	}
+	else if (!(Sync_Readers[line] & bit))
+	{
+		Sync_Readers[line] |= bit;
+		if (writer && writer != self)
+			_32X_Sync_Hits++;
+	}
+}
+
+// Run the turns ending before the 68000 odometer End, i/j/k/l are the ends of the next turn.
+// A turn longer than the strict one is cut at End (the SH2 and PWM ends in proportion), so the CPUs
+// reach the end of the line together and the strict tail after the loop stays under p_i cycles.
+static void Exec_32X_Turns(int &i, int &j, int &k, int &l, int End, int p_i, int p_j, int p_k, int p_l)
+{
+	int over;
+
+	while (i < End || (i == End && _32X_Turn_Length > 1))
+	{
+		Prof_M68K_Exec(i);
+		Idle_SH2_Exec(&M_SH2, j);
+		Idle_SH2_Exec(&S_SH2, k);
+		PWM_Update_Timer(l);
+
+		if (_32X_Sync == _32X_SYNC_ADAPTIVE)
+		{
+			if (_32X_Sync_Hits)
+				_32X_Turn_Length = 1;
+			else if (p_i * _32X_Turn_Length * 2 <= CPL_M68K)
+				_32X_Turn_Length *= 2;
+			_32X_Sync_Hits = 0;
+		}
+
+		i += p_i * _32X_Turn_Length;
+		j += p_j * _32X_Turn_Length;
+		k += p_k * _32X_Turn_Length;
+		l += p_l * _32X_Turn_Length;
+
+		over = i - End;
+		if (_32X_Turn_Length > 1 && over > 0 && over < p_i * _32X_Turn_Length)
+		{
+			i = End;
+			j -= over * p_j / p_i;
+			k -= over * p_k / p_i;
+			l -= over * p_l / p_i;
+		}
+	}
+}
+
 int Do_32X_Frame(bool fast)
 {
 	struct Scope { Scope(){Inside_Frame=1;} ~Scope(){Inside_Frame=0;}} scope;	
@@ -1738,6 +1852,7 @@ int Do_32X_Frame(bool fast)
 
 	if(!disableSound)
 	{
+		PROF_SCOPE(PROF_SOUND);
 		YM_Buf[0] = PSG_Buf[0] = LeftAudioBuffer();
 		YM_Buf[1] = PSG_Buf[1] = RightAudioBuffer();
 	}
@@ -1755,6 +1870,7 @@ int Do_32X_Frame(bool fast)
 	PWM_Clear_Timer();
 
 	Patch_Codes();
+	Update_Hook_Enabled();
 
 	VRam_Flag = 1;
 
@@ -1766,6 +1882,14 @@ int Do_32X_Frame(bool fast)
 
 	HInt_Counter = VDP_Reg.H_Int;					// Hint_Counter = step d'interruption H
 	HInt_Counter_32X = _32X_HIC;
+	_32X_Turn_Length = 1;
+	_32X_Sync_Hits = 0;
+	_32X_Sync_Track = (_32X_Sync == _32X_SYNC_ADAPTIVE);
+	if (_32X_Sync_Track)
+	{
+		memset(Sync_Writer, 0, sizeof(Sync_Writer));
+		memset(Sync_Readers, 0, sizeof(Sync_Readers));
+	}
 
 	p_i = 84;
 	p_j = (p_i * CPL_MSH2) / CPL_M68K;
@@ -1779,6 +1903,7 @@ int Do_32X_Frame(bool fast)
 	{
 		if(!disableSound)
 		{
+			PROF_SCOPE(PROF_SOUND);
 			buf[0] = LeftAudioBuffer() + Sound_Extrapol[VDP_Current_Line][0];
 			buf[1] = RightAudioBuffer() + Sound_Extrapol[VDP_Current_Line][0];
 			YM2612_DacAndTimers_Update(buf, Sound_Extrapol[VDP_Current_Line][1]);
@@ -1802,9 +1927,9 @@ int Do_32X_Frame(bool fast)
 		VDP_Status |= 0x0004;			// HBlank = 1
 		_32X_VDP.State |= 0x6000;
 
-		main68k_exec(i - p_i);
-		SH2_Exec(&M_SH2, j - p_j);
-		SH2_Exec(&S_SH2, k - p_k);
+		Prof_M68K_Exec(i - p_i);
+		Idle_SH2_Exec(&M_SH2, j - p_j);
+		Idle_SH2_Exec(&S_SH2, k - p_k);
 		PWM_Update_Timer(l - p_l);
 
 		VDP_Status &= ~0x0004;			// HBlank = 0
@@ -1825,7 +1950,10 @@ int Do_32X_Frame(bool fast)
 		}
 
 		if (!fast)
+		{
+			PROF_SCOPE(PROF_LINE);
 			Render_Line_32X();
+		}
 
 #ifdef _DEBUG
 		static int _32X_Prev_Rend_Mode = -1;
@@ -1840,23 +1968,13 @@ int Do_32X_Frame(bool fast)
 
 		/* instruction by instruction execution */
 		
-		while (i < Cycles_M68K)
-		{
-			main68k_exec(i);
-			SH2_Exec(&M_SH2, j);
-			SH2_Exec(&S_SH2, k);
-			PWM_Update_Timer(l);
-			i += p_i;
-			j += p_j;
-			k += p_k;
-			l += p_l;
-		}
+		Exec_32X_Turns(i, j, k, l, Cycles_M68K, p_i, p_j, p_k, p_l);
 
-		main68k_exec(Cycles_M68K);
-		SH2_Exec(&M_SH2, Cycles_MSH2);
-		SH2_Exec(&S_SH2, Cycles_SSH2);
+		Prof_M68K_Exec(Cycles_M68K);
+		Idle_SH2_Exec(&M_SH2, Cycles_MSH2);
+		Idle_SH2_Exec(&S_SH2, Cycles_SSH2);
 		PWM_Update_Timer(PWM_Cycles);
-		if (Z80_State == 3) z80_Exec(&M_Z80, Cycles_Z80);
+		if (Z80_State == 3) Prof_Z80_Exec(Cycles_Z80);
 		else z80_Set_Odo(&M_Z80, Cycles_Z80);
 	}
 
@@ -1868,6 +1986,7 @@ int Do_32X_Frame(bool fast)
 
 	if(!disableSound)
 	{
+		PROF_SCOPE(PROF_SOUND);
 		buf[0] = LeftAudioBuffer() + Sound_Extrapol[VDP_Current_Line][0];
 		buf[1] = RightAudioBuffer() + Sound_Extrapol[VDP_Current_Line][0];
 		YM2612_DacAndTimers_Update(buf, Sound_Extrapol[VDP_Current_Line][1]);
@@ -1909,20 +2028,10 @@ int Do_32X_Frame(bool fast)
 
 	_32X_Set_FB();
 
-	while (i < (Cycles_M68K - 360))
-	{
-		main68k_exec(i);
-		SH2_Exec(&M_SH2, j);
-		SH2_Exec(&S_SH2, k);
-		PWM_Update_Timer(l);
-		i += p_i;
-		j += p_j;
-		k += p_k;
-		l += p_l;
-	}
+	Exec_32X_Turns(i, j, k, l, Cycles_M68K - 360, p_i, p_j, p_k, p_l);
 
-	main68k_exec(Cycles_M68K - 360);
-	if (Z80_State == 3) z80_Exec(&M_Z80, Cycles_Z80 - 168);
+	Prof_M68K_Exec(Cycles_M68K - 360);
+	if (Z80_State == 3) Prof_Z80_Exec(Cycles_Z80 - 168);
 	else z80_Set_Odo(&M_Z80, Cycles_Z80 - 168);
 
 	VDP_Status &= ~0x0004;			// HBlank = 0
@@ -1935,29 +2044,20 @@ int Do_32X_Frame(bool fast)
 	if (_32X_SINT & 0x08) SH2_Interrupt(&S_SH2, 12);
 	z80_Interrupt(&M_Z80, 0xFF);
 
-	while (i < Cycles_M68K)
-	{
-		main68k_exec(i);
-		SH2_Exec(&M_SH2, j);
-		SH2_Exec(&S_SH2, k);
-		PWM_Update_Timer(l);
-		i += p_i;
-		j += p_j;
-		k += p_k;
-		l += p_l;
-	}
+	Exec_32X_Turns(i, j, k, l, Cycles_M68K, p_i, p_j, p_k, p_l);
 
-	main68k_exec(Cycles_M68K);
-	SH2_Exec(&M_SH2, Cycles_MSH2);
-	SH2_Exec(&S_SH2, Cycles_SSH2);
+	Prof_M68K_Exec(Cycles_M68K);
+	Idle_SH2_Exec(&M_SH2, Cycles_MSH2);
+	Idle_SH2_Exec(&S_SH2, Cycles_SSH2);
 	PWM_Update_Timer(PWM_Cycles);
-	if (Z80_State == 3) z80_Exec(&M_Z80, Cycles_Z80);
+	if (Z80_State == 3) Prof_Z80_Exec(Cycles_Z80);
 	else z80_Set_Odo(&M_Z80, Cycles_Z80);
 
 	for(VDP_Current_Line++; VDP_Current_Line < VDP_Num_Lines; VDP_Current_Line++)
 	{
 		if(!disableSound)
 		{
+			PROF_SCOPE(PROF_SOUND);
 			buf[0] = LeftAudioBuffer() + Sound_Extrapol[VDP_Current_Line][0];
 			buf[1] = RightAudioBuffer() + Sound_Extrapol[VDP_Current_Line][0];
 			YM2612_DacAndTimers_Update(buf, Sound_Extrapol[VDP_Current_Line][1]);
@@ -1981,9 +2081,9 @@ int Do_32X_Frame(bool fast)
 		VDP_Status |= 0x0004;			// HBlank = 1
 		_32X_VDP.State |= 0x6000;
 
-		main68k_exec(i - p_i);
-		SH2_Exec(&M_SH2, j - p_j);
-		SH2_Exec(&S_SH2, k - p_k);
+		Prof_M68K_Exec(i - p_i);
+		Idle_SH2_Exec(&M_SH2, j - p_j);
+		Idle_SH2_Exec(&S_SH2, k - p_k);
 		PWM_Update_Timer(l - p_l);
 
 		VDP_Status &= ~0x0004;			// HBlank = 0
@@ -1998,33 +2098,25 @@ int Do_32X_Frame(bool fast)
 
 		/* instruction by instruction execution */
 		
-		while (i < Cycles_M68K)
-		{
-			main68k_exec(i);
-			SH2_Exec(&M_SH2, j);
-			SH2_Exec(&S_SH2, k);
-			PWM_Update_Timer(l);
-			i += p_i;
-			j += p_j;
-			k += p_k;
-			l += p_l;
-		}
+		Exec_32X_Turns(i, j, k, l, Cycles_M68K, p_i, p_j, p_k, p_l);
 
-		main68k_exec(Cycles_M68K);
-		SH2_Exec(&M_SH2, Cycles_MSH2);
-		SH2_Exec(&S_SH2, Cycles_SSH2);
+		Prof_M68K_Exec(Cycles_M68K);
+		Idle_SH2_Exec(&M_SH2, Cycles_MSH2);
+		Idle_SH2_Exec(&S_SH2, Cycles_SSH2);
 		PWM_Update_Timer(PWM_Cycles);
-		if (Z80_State == 3) z80_Exec(&M_Z80, Cycles_Z80);
+		if (Z80_State == 3) Prof_Z80_Exec(Cycles_Z80);
 		else z80_Set_Odo(&M_Z80, Cycles_Z80);
 	}
 
 	if(!disableSound)
 	{
+		PROF_SCOPE(PROF_SOUND);
 		PSG_Special_Update();
 		YM2612_Special_Update();
 	}
 	if(!disableSound && !disableSound2)
 	{
+		PROF_SCOPE(PROF_SOUND);
 		if (WAV_Dumping) Update_WAV_Dump();
 		if (AVISound!=0 && AVIRecording!=0 && (AVIWaitMovie==0 || MainMovie.Status == MOVIE_PLAYING || MainMovie.Status == MOVIE_FINISHED)) Update_WAV_Dump_AVI();
 		if (GYM_Dumping) Update_GYM_Dump((unsigned char) 0, (unsigned char) 0, (unsigned char) 0);
@@ -2321,6 +2413,7 @@ int Do_SegaCD_Frame(bool fast)
 
 	if(!disableSound)
 	{
+		PROF_SCOPE(PROF_SOUND);
 		YM_Buf[0] = PSG_Buf[0] = LeftAudioBuffer();
 		YM_Buf[1] = PSG_Buf[1] = RightAudioBuffer();
 	}
@@ -2333,6 +2426,7 @@ int Do_SegaCD_Frame(bool fast)
 	z80_Clear_Odo(&M_Z80);
 
 	Patch_Codes();
+	Update_Hook_Enabled();
 
 	VRam_Flag = 1;
 
@@ -2350,6 +2444,7 @@ int Do_SegaCD_Frame(bool fast)
 	{
 		if(!disableSound)
 		{
+			PROF_SCOPE(PROF_SOUND);
 			buf[0] = LeftAudioBuffer() + Sound_Extrapol[VDP_Current_Line][0];
 			buf[1] = RightAudioBuffer() + Sound_Extrapol[VDP_Current_Line][0];
 			if (PCM_Enable) Update_PCM(buf, Sound_Extrapol[VDP_Current_Line][1]);
@@ -2365,7 +2460,7 @@ int Do_SegaCD_Frame(bool fast)
 		if (S68K_State == 1) Cycles_S68K += CPL_S68K;
 		if (DMAT_Length) main68k_addCycles(Update_DMA());
 		VDP_Status |= 0x0004;			// HBlank = 1
-		main68k_exec(Cycles_M68K - 404);
+		Prof_M68K_Exec(Cycles_M68K - 404);
 		VDP_Status &= 0xFFFB;			// HBlank = 0
 
 		if (--HInt_Counter < 0)
@@ -2376,16 +2471,17 @@ int Do_SegaCD_Frame(bool fast)
 		}
 
 		if (!fast)
-			Render_Line();
+			Render_Line_Selected();
 
-		main68k_exec(Cycles_M68K);
-		sub68k_exec(Cycles_S68K);
-		if (Z80_State == 3) z80_Exec(&M_Z80, Cycles_Z80);
+		Prof_M68K_Exec(Cycles_M68K);
+		Prof_S68K_Exec(Cycles_S68K);
+		if (Z80_State == 3) Prof_Z80_Exec(Cycles_Z80);
 		else z80_Set_Odo(&M_Z80, Cycles_Z80);
 
 		Update_SegaCD_Timer();
 	}
 
+	VDP_Render_Sync();				// lines still being rendered on the render thread
 	if (!fast)
 	{
 		FakeVDPScreen = false;
@@ -2394,6 +2490,7 @@ int Do_SegaCD_Frame(bool fast)
 
 	if(!disableSound)
 	{
+		PROF_SCOPE(PROF_SOUND);
 		buf[0] = LeftAudioBuffer() + Sound_Extrapol[VDP_Current_Line][0];
 		buf[1] = RightAudioBuffer() + Sound_Extrapol[VDP_Current_Line][0];
 		if (PCM_Enable) Update_PCM(buf, Sound_Extrapol[VDP_Current_Line][1]);
@@ -2415,9 +2512,9 @@ int Do_SegaCD_Frame(bool fast)
 	}
 
 	VDP_Status |= 0x000C;				// VBlank = 1 et HBlank = 1 (retour de balayage vertical en cours)
-	main68k_exec(Cycles_M68K - 360);
-	sub68k_exec(Cycles_S68K - 586);
-	if (Z80_State == 3) z80_Exec(&M_Z80, Cycles_Z80 - 168);
+	Prof_M68K_Exec(Cycles_M68K - 360);
+	Prof_S68K_Exec(Cycles_S68K - 586);
+	if (Z80_State == 3) Prof_Z80_Exec(Cycles_Z80 - 168);
 	else z80_Set_Odo(&M_Z80, Cycles_Z80 - 168);
 
 	VDP_Status &= 0xFFFB;				// HBlank = 0
@@ -2426,9 +2523,9 @@ int Do_SegaCD_Frame(bool fast)
 	Update_IRQ_Line();
 	z80_Interrupt(&M_Z80, 0xFF);
 
-	main68k_exec(Cycles_M68K);
-	sub68k_exec(Cycles_S68K);
-	if (Z80_State == 3) z80_Exec(&M_Z80, Cycles_Z80);
+	Prof_M68K_Exec(Cycles_M68K);
+	Prof_S68K_Exec(Cycles_S68K);
+	if (Z80_State == 3) Prof_Z80_Exec(Cycles_Z80);
 	else z80_Set_Odo(&M_Z80, Cycles_Z80);
 
 	Update_SegaCD_Timer();
@@ -2437,6 +2534,7 @@ int Do_SegaCD_Frame(bool fast)
 	{
 		if(!disableSound)
 		{
+			PROF_SCOPE(PROF_SOUND);
 			buf[0] = LeftAudioBuffer() + Sound_Extrapol[VDP_Current_Line][0];
 			buf[1] = RightAudioBuffer() + Sound_Extrapol[VDP_Current_Line][0];
 			if (PCM_Enable) Update_PCM(buf, Sound_Extrapol[VDP_Current_Line][1]);
@@ -2452,12 +2550,12 @@ int Do_SegaCD_Frame(bool fast)
 		if (S68K_State == 1) Cycles_S68K += CPL_S68K;
 		if (DMAT_Length) main68k_addCycles(Update_DMA());
 		VDP_Status |= 0x0004;					// HBlank = 1
-		main68k_exec(Cycles_M68K - 404);
+		Prof_M68K_Exec(Cycles_M68K - 404);
 		VDP_Status &= 0xFFFB;					// HBlank = 0
 
-		main68k_exec(Cycles_M68K);
-		sub68k_exec(Cycles_S68K);
-		if (Z80_State == 3) z80_Exec(&M_Z80, Cycles_Z80);
+		Prof_M68K_Exec(Cycles_M68K);
+		Prof_S68K_Exec(Cycles_S68K);
+		if (Z80_State == 3) Prof_Z80_Exec(Cycles_Z80);
 		else z80_Set_Odo(&M_Z80, Cycles_Z80);
 
 		Update_SegaCD_Timer();
@@ -2465,6 +2563,7 @@ int Do_SegaCD_Frame(bool fast)
 
 	if(!disableSound)
 	{
+		PROF_SCOPE(PROF_SOUND);
 		buf[0] = LeftAudioBuffer();
 		buf[1] = RightAudioBuffer();
 
@@ -2474,6 +2573,7 @@ int Do_SegaCD_Frame(bool fast)
 	}
 	if(!disableSound && !disableSound2)
 	{
+		PROF_SCOPE(PROF_SOUND);
 		if (WAV_Dumping) Update_WAV_Dump();
 		if (AVISound!=0 && AVIRecording!=0 && (AVIWaitMovie==0 || MainMovie.Status == MOVIE_PLAYING || MainMovie.Status == MOVIE_FINISHED)) Update_WAV_Dump_AVI();
 		if (GYM_Dumping) Update_GYM_Dump((unsigned char) 0, (unsigned char) 0, (unsigned char) 0);
@@ -2509,6 +2609,7 @@ int Do_SegaCD_Frame_Cycle_Accurate(bool fast)
 
 	if(!disableSound)
 	{
+		PROF_SCOPE(PROF_SOUND);
 		YM_Buf[0] = PSG_Buf[0] = LeftAudioBuffer();
 		YM_Buf[1] = PSG_Buf[1] = RightAudioBuffer();
 	}
@@ -2521,6 +2622,7 @@ int Do_SegaCD_Frame_Cycle_Accurate(bool fast)
 	z80_Clear_Odo(&M_Z80);
 
 	Patch_Codes();
+	Update_Hook_Enabled();
 
 	VRam_Flag = 1;
 
@@ -2538,6 +2640,7 @@ int Do_SegaCD_Frame_Cycle_Accurate(bool fast)
 	{
 		if(!disableSound)
 		{
+			PROF_SCOPE(PROF_SOUND);
 			buf[0] = LeftAudioBuffer() + Sound_Extrapol[VDP_Current_Line][0];
 			buf[1] = RightAudioBuffer() + Sound_Extrapol[VDP_Current_Line][0];
 			if (PCM_Enable) Update_PCM(buf, Sound_Extrapol[VDP_Current_Line][1]);
@@ -2561,18 +2664,18 @@ int Do_SegaCD_Frame_Cycle_Accurate(bool fast)
 		
 		while (i < (Cycles_M68K - 404))
 		{
-			main68k_exec(i);
+			Prof_M68K_Exec(i);
 			i += 24;
 
 			if (j < (Cycles_S68K - 658))
 			{
-				sub68k_exec(j);
+				Prof_S68K_Exec(j);
 				j += 39;
 			}
 		}
 
-		main68k_exec(Cycles_M68K - 404);
-		sub68k_exec(Cycles_S68K - 658);
+		Prof_M68K_Exec(Cycles_M68K - 404);
+		Prof_S68K_Exec(Cycles_S68K - 658);
 
 		/* end instruction by instruction execution */
 
@@ -2586,33 +2689,34 @@ int Do_SegaCD_Frame_Cycle_Accurate(bool fast)
 		}
 
 		if (!fast)
-			Render_Line();
+			Render_Line_Selected();
 
 		/* instruction by instruction execution */
 		
 		while (i < Cycles_M68K)
 		{
-			main68k_exec(i);
+			Prof_M68K_Exec(i);
 			i += 24;
 
 			if (j < Cycles_S68K)
 			{
-				sub68k_exec(j);
+				Prof_S68K_Exec(j);
 				j += 39;
 			}
 		}
 
-		main68k_exec(Cycles_M68K);
-		sub68k_exec(Cycles_S68K);
+		Prof_M68K_Exec(Cycles_M68K);
+		Prof_S68K_Exec(Cycles_S68K);
 
 		/* end instruction by instruction execution */
 
-		if (Z80_State == 3) z80_Exec(&M_Z80, Cycles_Z80);
+		if (Z80_State == 3) Prof_Z80_Exec(Cycles_Z80);
 		else z80_Set_Odo(&M_Z80, Cycles_Z80);
 
 		Update_SegaCD_Timer();
 	}
 
+	VDP_Render_Sync();				// lines still being rendered on the render thread
 	if (!fast)
 	{
 		FakeVDPScreen = false;
@@ -2621,6 +2725,7 @@ int Do_SegaCD_Frame_Cycle_Accurate(bool fast)
 
 	if(!disableSound)
 	{
+		PROF_SCOPE(PROF_SOUND);
 		buf[0] = LeftAudioBuffer() + Sound_Extrapol[VDP_Current_Line][0];
 		buf[1] = RightAudioBuffer() + Sound_Extrapol[VDP_Current_Line][0];
 		if (PCM_Enable) Update_PCM(buf, Sound_Extrapol[VDP_Current_Line][1]);
@@ -2650,22 +2755,22 @@ int Do_SegaCD_Frame_Cycle_Accurate(bool fast)
 
 	while (i < (Cycles_M68K - 360))
 	{
-		main68k_exec(i);
+		Prof_M68K_Exec(i);
 		i += 24;
 
 		if (j < (Cycles_S68K - 586))
 		{
-			sub68k_exec(j);
+			Prof_S68K_Exec(j);
 			j += 39;
 		}
 	}
 
-	main68k_exec(Cycles_M68K - 360);
-	sub68k_exec(Cycles_S68K - 586);
+	Prof_M68K_Exec(Cycles_M68K - 360);
+	Prof_S68K_Exec(Cycles_S68K - 586);
 
 	/* end instruction by instruction execution */
 
-	if (Z80_State == 3) z80_Exec(&M_Z80, Cycles_Z80 - 168);
+	if (Z80_State == 3) Prof_Z80_Exec(Cycles_Z80 - 168);
 	else z80_Set_Odo(&M_Z80, Cycles_Z80 - 168);
 
 	VDP_Status &= 0xFFFB;				// HBlank = 0
@@ -2678,22 +2783,22 @@ int Do_SegaCD_Frame_Cycle_Accurate(bool fast)
 		
 	while (i < Cycles_M68K)
 	{
-		main68k_exec(i);
+		Prof_M68K_Exec(i);
 		i += 24;
 
 		if (j < Cycles_S68K)
 		{
-			sub68k_exec(j);
+			Prof_S68K_Exec(j);
 			j += 39;
 		}
 	}
 
-	main68k_exec(Cycles_M68K);
-	sub68k_exec(Cycles_S68K);
+	Prof_M68K_Exec(Cycles_M68K);
+	Prof_S68K_Exec(Cycles_S68K);
 
 	/* end instruction by instruction execution */
 
-	if (Z80_State == 3) z80_Exec(&M_Z80, Cycles_Z80);
+	if (Z80_State == 3) Prof_Z80_Exec(Cycles_Z80);
 	else z80_Set_Odo(&M_Z80, Cycles_Z80);
 
 	Update_SegaCD_Timer();
@@ -2702,6 +2807,7 @@ int Do_SegaCD_Frame_Cycle_Accurate(bool fast)
 	{
 		if(!disableSound)
 		{
+			PROF_SCOPE(PROF_SOUND);
 			buf[0] = LeftAudioBuffer() + Sound_Extrapol[VDP_Current_Line][0];
 			buf[1] = RightAudioBuffer() + Sound_Extrapol[VDP_Current_Line][0];
 			if (PCM_Enable) Update_PCM(buf, Sound_Extrapol[VDP_Current_Line][1]);
@@ -2725,18 +2831,18 @@ int Do_SegaCD_Frame_Cycle_Accurate(bool fast)
 		
 		while (i < (Cycles_M68K - 404))
 		{
-			main68k_exec(i);
+			Prof_M68K_Exec(i);
 			i += 24;
 
 			if (j < (Cycles_S68K - 658))
 			{
-				sub68k_exec(j);
+				Prof_S68K_Exec(j);
 				j += 39;
 			}
 		}
 
-		main68k_exec(Cycles_M68K - 404);
-		sub68k_exec(Cycles_S68K - 658);
+		Prof_M68K_Exec(Cycles_M68K - 404);
+		Prof_S68K_Exec(Cycles_S68K - 658);
 
 		/* end instruction by instruction execution */
 
@@ -2746,22 +2852,22 @@ int Do_SegaCD_Frame_Cycle_Accurate(bool fast)
 		
 		while (i < Cycles_M68K)
 		{
-			main68k_exec(i);
+			Prof_M68K_Exec(i);
 			i += 24;					// Chuck Rock intro need faster timing ... strange.
 
 			if (j < Cycles_S68K)
 			{
-				sub68k_exec(j);
+				Prof_S68K_Exec(j);
 				j += 39;
 			}
 		}
 
-		main68k_exec(Cycles_M68K);
-		sub68k_exec(Cycles_S68K);
+		Prof_M68K_Exec(Cycles_M68K);
+		Prof_S68K_Exec(Cycles_S68K);
 
 		/* end instruction by instruction execution */
 
-		if (Z80_State == 3) z80_Exec(&M_Z80, Cycles_Z80);
+		if (Z80_State == 3) Prof_Z80_Exec(Cycles_Z80);
 		else z80_Set_Odo(&M_Z80, Cycles_Z80);
 
 		Update_SegaCD_Timer();
@@ -2769,6 +2875,7 @@ int Do_SegaCD_Frame_Cycle_Accurate(bool fast)
 
 	if(!disableSound)
 	{
+		PROF_SCOPE(PROF_SOUND);
 		buf[0] = LeftAudioBuffer();
 		buf[1] = RightAudioBuffer();
 
@@ -2778,6 +2885,7 @@ int Do_SegaCD_Frame_Cycle_Accurate(bool fast)
 	}
 	if(!disableSound && !disableSound2)
 	{
+		PROF_SCOPE(PROF_SOUND);
 		if (WAV_Dumping) Update_WAV_Dump();
 		if (AVISound!=0 && AVIRecording!=0 && (AVIWaitMovie==0 || MainMovie.Status == MOVIE_PLAYING || MainMovie.Status == MOVIE_FINISHED)) Update_WAV_Dump_AVI();
 		if (GYM_Dumping) Update_GYM_Dump((unsigned char) 0, (unsigned char) 0, (unsigned char) 0);
@@ -5,6 +5,7 @@
 
 	extern _Write_To_68K_Space
 	extern _Read_To_68K_Space
+	extern _M68K_Set_Read_Pages
 
 section .data align=64
 
@@ -396,6 +397,12 @@ section .data align=64
 	DECL M68K_Write_Word_Table
 		times 16	dd M68K_Write_Bad
 
+	; Direct read pages, one per 64 KB, built by M68K_Set_Read_Pages (Cpu_68k.c)
+	; from the read tables above : a ROM page points in Rom_Data, 0 = use M68K_RB/RW
+
+	DECL M68K_Read_Page
+		times 256	dd 0
+
 section .bss align=64
 
 	extern Ram_Z80
@@ -413,6 +420,9 @@ section .bss align=64
 	extern M_Z80
 
 	extern _32X_Comm
+	extern _32X_Sync_Hits
+	extern _32X_Sync_Track
+	extern __32X_Sync_Shared
 	extern _32X_ADEN
 	extern _32X_RES
 	extern _32X_FM
@@ -1721,6 +1731,9 @@ section .text align=64
 		mov [M68K_Read_Byte_Table + ebx * 4], ecx
 		mov ecx, [Genesis_M68K_Read_Word_Table + eax * 4]
 		mov [M68K_Read_Word_Table + ebx * 4], ecx
+		push edx
+		call _M68K_Set_Read_Pages
+		pop edx
 
 ;		pop ecx
 ;		pop ebx
@@ -1994,6 +2007,9 @@ section .text align=64
 		mov [M68K_Read_Byte_Table + ebx * 4], ecx
 		mov ecx, [Genesis_M68K_Read_Word_Table + eax * 4]
 		mov [M68K_Read_Word_Table + ebx * 4], ecx
+		push edx
+		call _M68K_Set_Read_Pages
+		pop edx
 
 ;		pop ecx
 ;		pop ebx
@@ -17,10 +17,14 @@ extern unsigned int _32X_M68K_Read_Word_Table[0x20];
 extern unsigned int _32X_M68K_Write_Byte_Table[0x10];
 extern unsigned int _32X_M68K_Write_Word_Table[0x10];
 
+extern unsigned int Genesis_M68K_Read_Byte_Table[0x20];
+extern unsigned int Genesis_M68K_Read_Word_Table[0x20];
+
 extern unsigned int M68K_Read_Byte_Table[0x20];
 extern unsigned int M68K_Read_Word_Table[0x20];
 extern unsigned int M68K_Write_Byte_Table[0x10];
 extern unsigned int M68K_Write_Word_Table[0x10];
+extern unsigned char *M68K_Read_Page[0x100];
 
 extern unsigned int Rom_Size;
 
@@ -231,8 +231,8 @@ section .text align=64
 
 	extern _sub68k_interrupt
 	extern _Write_PCM_Reg
-	extern _Calcul_Rot_Comp
-	extern _Update_Rot
+	extern _Calcul_Rot_Comp_Selected
+	extern _Update_Rot_Selected
 	extern _CDC_Read_Reg
 	extern _CDC_Write_Reg
 	extern _CDD_Processing
@@ -2783,7 +2783,7 @@ add esp, 4
 		mov ah, al
 		and ax, 0xFFFE
 		mov [Rot_Comp.Reg_66], ax
-		call _Calcul_Rot_Comp
+		call _Calcul_Rot_Comp_Selected
 		pop ecx
 		pop ebx
 		ret
@@ -3485,7 +3485,7 @@ add esp, 4
 	.Reg_Vector_Adr
 		and ax, 0xFFFE
 		mov [Rot_Comp.Reg_66], ax
-		call _Calcul_Rot_Comp
+		call _Calcul_Rot_Comp_Selected
 		pop ecx
 		pop ebx
 		ret
@@ -3551,7 +3551,7 @@ add esp, 4
 		test dword [Rot_Comp.Reg_58], 0x8000
 		jz short .GFX_Terminated
 
-		call _Update_Rot
+		call _Update_Rot_Selected
 
 	.GFX_Terminated
 		mov eax, [Memory_Control_Status]
@@ -258,15 +258,50 @@ section .bss align=64
 	DECL Cycles_SSH2
 	resd 1
 
+	DECL _32X_Sync_Hits		; 32X system register accesses, for the adaptive sync of Do_32X_Frame
+	resd 1
+
+	DECL _32X_Sync_Track	; report SDRAM and frame buffer accesses to _32X_Sync_Shared
+	resd 1
+
 
 section .text align=64
 
 	extern _Write_To_68K_Space
 	extern __32X_Set_FB
+	extern __32X_Sync_Shared
 	extern SH2_DMA0_Request
 	extern @PWM_Set_Cycle@4
 	extern @PWM_Set_Int@4
 
+; SDRAM and frame buffer accesses for the adaptive 32X sync
+; %1 = address mask, %2 = offset (SDRAM 0, frame buffer 0 0x40000, frame buffer 1 0x60000), %3 = 1 for writes
+
+%macro SYNC_SHARED 3
+	test byte [_32X_Sync_Track], 1
+	jz short %%done
+
+	push eax
+	push ecx
+	push edx
+	xor eax, eax
+	cmp ebp, M_SH2
+	setne al				; 0 = master, 1 = slave
+	lea eax, [eax * 2 + %3]
+	and ecx, %1
+	add ecx, %2
+	push eax
+	push ecx
+	call __32X_Sync_Shared
+	add esp, 8
+	pop edx
+	pop ecx
+	pop eax
+
+%%done
+%endmacro
+
+
 ;*********************
 ;
 ;	READ FUNCTIONS
@@ -354,6 +389,7 @@ section .text align=64
 	ALIGN32
 	
 	DECLF SH2_Read_Byte_FB0, 4
+		SYNC_SHARED 0x1FFFF, 0x40000, 0
 		and ecx, 0x1FFFF
 		mov edx, [ebp + SH2.Cycle_IO]
 		xor ecx, byte 1
@@ -366,6 +402,7 @@ section .text align=64
 	ALIGN32
 	
 	DECLF SH2_Read_Byte_FB1, 4
+		SYNC_SHARED 0x1FFFF, 0x60000, 0
 		and ecx, 0x1FFFF
 		mov edx, [ebp + SH2.Cycle_IO]
 		xor ecx, byte 1
@@ -378,6 +415,7 @@ section .text align=64
 	ALIGN32
 	
 	DECLF SH2_Read_Byte_Ram, 4
+		SYNC_SHARED 0x3FFFF, 0, 0
 		and ecx, 0x3FFFF
 		mov al, [_32X_Ram + ecx]
 		ret
@@ -473,6 +511,7 @@ section .text align=64
 	ALIGN32
 	
 	DECLF SH2_Read_Word_FB0, 4
+		SYNC_SHARED 0x1FFFF, 0x40000, 0
 		mov edx, [ebp + SH2.Cycle_IO]
 		and ecx, 0x1FFFE
 		sub edx, byte 5
@@ -484,6 +523,7 @@ section .text align=64
 	ALIGN32
 	
 	DECLF SH2_Read_Word_FB1, 4
+		SYNC_SHARED 0x1FFFF, 0x60000, 0
 		mov edx, [ebp + SH2.Cycle_IO]
 		and ecx, 0x1FFFE
 		sub edx, byte 5
@@ -495,6 +535,7 @@ section .text align=64
 	ALIGN32
 	
 	DECLF SH2_Read_Word_Ram, 4
+		SYNC_SHARED 0x3FFFF, 0, 0
 		and ecx, 0x3FFFE
 		mov ah, [_32X_Ram + ecx + 0]
 		mov al, [_32X_Ram + ecx + 1]
@@ -617,6 +658,7 @@ section .text align=64
 	ALIGN32
 	
 	DECLF SH2_Read_Long_FB0, 4
+		SYNC_SHARED 0x1FFFF, 0x40000, 0
 		mov edx, [ebp + SH2.Cycle_IO]
 		and ecx, 0x1FFFC
 		sub edx, byte 5
@@ -629,6 +671,7 @@ section .text align=64
 	ALIGN32
 	
 	DECLF SH2_Read_Long_FB1, 4
+		SYNC_SHARED 0x1FFFF, 0x60000, 0
 		mov edx, [ebp + SH2.Cycle_IO]
 		and ecx, 0x1FFFC
 		sub edx, byte 5
@@ -641,6 +684,7 @@ section .text align=64
 	ALIGN32
 	
 	DECLF SH2_Read_Long_Ram, 4
+		SYNC_SHARED 0x3FFFF, 0, 0
 		and ecx, 0x3FFFC
 		mov eax, [_32X_Ram + ecx]
 		bswap eax
@@ -710,6 +754,7 @@ section .text align=64
 	ALIGN32
 	
 	DECLF SH2_Write_Byte_FB0, 8
+		SYNC_SHARED 0x1FFFF, 0x40000, 1
 		and ecx, 0x1FFFF
 		test dl, dl
 		jz short .blank
@@ -724,6 +769,7 @@ section .text align=64
 	ALIGN32
 	
 	DECLF SH2_Write_Byte_FB1, 8
+		SYNC_SHARED 0x1FFFF, 0x60000, 1
 		and ecx, 0x1FFFF
 		test dl, dl
 		jz short .blank
@@ -738,6 +784,7 @@ section .text align=64
 	ALIGN32
 	
 	DECLF SH2_Write_Byte_Ram, 8
+		SYNC_SHARED 0x3FFFF, 0, 1
 		and ecx, 0x3FFFF
 		mov [_32X_Ram + ecx], dl
 		ret
@@ -808,6 +855,7 @@ section .text align=64
 	ALIGN32
 	
 	DECLF SH2_Write_Word_FB0, 8
+		SYNC_SHARED 0x1FFFF, 0x40000, 1
 		and ecx, 0x3FFFE
 		test ecx, 0x20000
 		jnz short .overwrite
@@ -835,6 +883,7 @@ section .text align=64
 	ALIGN32
 	
 	DECLF SH2_Write_Word_FB1, 8
+		SYNC_SHARED 0x1FFFF, 0x60000, 1
 		and ecx, 0x3FFFE
 		test ecx, 0x20000
 		jnz short .overwrite
@@ -863,6 +912,7 @@ section .text align=64
 	ALIGN32
 	
 	DECLF SH2_Write_Word_Ram, 8
+		SYNC_SHARED 0x3FFFF, 0, 1
 		and ecx, 0x3FFFE
 		mov [_32X_Ram + ecx + 0], dh
 		mov [_32X_Ram + ecx + 1], dl
@@ -970,6 +1020,7 @@ section .text align=64
 	ALIGN32
 	
 	DECLF SH2_Write_Long_FB0, 8
+		SYNC_SHARED 0x1FFFF, 0x40000, 1
 		mov eax, edx
 		and ecx, 0x3FFFC
 		rol edx, 16
@@ -1012,6 +1063,7 @@ section .text align=64
 	ALIGN32
 	
 	DECLF SH2_Write_Long_FB1, 8
+		SYNC_SHARED 0x1FFFF, 0x60000, 1
 		mov eax, edx
 		and ecx, 0x3FFFC
 		rol edx, 16
@@ -1054,6 +1106,7 @@ section .text align=64
 	ALIGN32
 	
 	DECLF SH2_Write_Long_Ram, 8
+		SYNC_SHARED 0x3FFFF, 0, 1
 		and ecx, 0x3FFFC
 		bswap edx
 		mov [_32X_Ram + ecx], edx
@@ -1089,6 +1142,7 @@ section .text align=64
 
 	MSH2_Read_Byte_32X_Reg
 
+		inc dword [_32X_Sync_Hits]
 		mov edx, [ebp + SH2.Cycle_IO]
 		and ecx, 0x3F
 		sub edx, byte 10
@@ -1216,6 +1270,7 @@ section .text align=64
 
 	SSH2_Read_Byte_32X_Reg
 
+		inc dword [_32X_Sync_Hits]
 		mov edx, [ebp + SH2.Cycle_IO]
 		and ecx, 0x3F
 		sub edx, byte 10
@@ -1346,6 +1401,7 @@ section .text align=64
 
 	MSH2_Read_Word_32X_Reg
 
+		inc dword [_32X_Sync_Hits]
 		mov edx, [ebp + SH2.Cycle_IO]
 		and ecx, 0x3E
 		sub edx, byte 16
@@ -1550,6 +1606,7 @@ section .text align=64
 
 	SSH2_Read_Word_32X_Reg
 
+		inc dword [_32X_Sync_Hits]
 		mov edx, [ebp + SH2.Cycle_IO]
 		and ecx, 0x3E
 		sub edx, byte 14
@@ -1648,6 +1705,7 @@ section .text align=64
 
 	MSH2_Write_Byte_32X_Reg
 
+		inc dword [_32X_Sync_Hits]
 ;pushad
 ;push edx
 ;push ecx
@@ -1832,6 +1890,7 @@ section .text align=64
 
 	SSH2_Write_Byte_32X_Reg
 
+		inc dword [_32X_Sync_Hits]
 ;pushad
 ;push edx
 ;push ecx
@@ -1957,6 +2016,7 @@ section .text align=64
 
 	MSH2_Write_Word_32X_Reg
 
+		inc dword [_32X_Sync_Hits]
 ;pushad
 ;push edx
 ;push ecx
@@ -2086,6 +2146,7 @@ section .text align=64
 
 	SSH2_Write_Word_32X_Reg
 
+		inc dword [_32X_Sync_Hits]
 ;pushad
 ;push edx
 ;push ecx
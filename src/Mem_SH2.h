@@ -40,6 +40,12 @@ extern unsigned int CPL_SSH2;
 extern unsigned int CPL_MSH2;
 extern int Cycles_MSH2;
 extern int Cycles_SSH2;
+extern unsigned int _32X_Sync_Hits;	// 68000 and SH2 accesses to the 32X system registers
+extern unsigned int _32X_Sync_Track;	// SDRAM and frame buffer accesses go through _32X_Sync_Shared
+
+// A CPU (0 master SH2, 1 slave SH2, 2 68000) read (access = cpu * 2) or wrote (cpu * 2 + 1)
+// offset: SDRAM 0-0x3FFFF, frame buffer 0 0x40000-0x5FFFF, frame buffer 1 0x60000-0x7FFFF
+void _32X_Sync_Shared(unsigned int offset, int access);
 
 
 UINT8 FASTCALL MSH2_Read_Byte_00(UINT32 adr);
@@ -12,6 +12,7 @@
 #include "G_dsound.h"
 #include "resource.h"
 #include "OpenArchive.h"
+#include "zlib.h"
 
 LRESULT CALLBACK ArchiveFileChooser(HWND hDlg, UINT uMsg, WPARAM wParam, LPARAM lParam);
 static int s_archiveFileChooserResult = -1;
@@ -371,6 +372,134 @@ void ReleaseTempFileCategory(const char* cat, const char* exceptionFilename)
 
 
 
+const char* GetTempFileWithData(const char* category, const char* extension, const unsigned char* data, int size)
+{
+	const char* filename = s_tempFiles.GetFile(category, extension);
+
+	DWORD attributes = GetFileAttributes(filename);
+	SetFileAttributes(filename, attributes & ~FILE_ATTRIBUTE_READONLY); // temporarily remove read-only attribute so we can write it
+
+	FILE* file = fopen(filename, "wb");
+	bool ok = file && fwrite(data, 1, size, file) == (size_t)size;
+	if(file)
+		ok = !fclose(file) && ok;
+
+	SetFileAttributes(filename, attributes); // restore read-only attribute
+
+	if(!ok)
+	{
+		s_tempFiles.ReleaseFile(filename);
+		return NULL;
+	}
+	return filename;
+}
+
+
+
+static char s_archiveCacheDir [1024];
+
+void SetArchiveCacheDir(const char* dir)
+{
+	s_archiveCacheDir[0] = 0;
+	if(!dir || !*dir)
+		return;
+	strncpy(s_archiveCacheDir, dir, 1000);
+	s_archiveCacheDir[1000] = 0;
+	CreateDirectory(s_archiveCacheDir, NULL); // fails harmlessly if it's already there
+}
+
+// the cache file of an archive item is named after the contents of the archive (crc32 and size)
+// and the item, so a renamed or moved archive still finds it and a changed one doesn't
+static bool GetArchiveCacheName(const char* archiveName, int item, int itemSize, char* cacheName)
+{
+	FILE* file = fopen(archiveName, "rb");
+	if(!file)
+		return false;
+
+	unsigned char buf [65536];
+	uLong crc = crc32(0L, Z_NULL, 0);
+	unsigned long size = 0;
+	size_t n;
+	while((n = fread(buf, 1, sizeof(buf), file)) > 0)
+	{
+		crc = crc32(crc, buf, n);
+		size += n;
+	}
+	fclose(file);
+
+	_snprintf(cacheName, 1024, "%s\\%08lX-%lX-%d-%X.bin", s_archiveCacheDir, crc, size, item, itemSize);
+	cacheName[1023] = 0;
+	return true;
+}
+
+static bool ReadArchiveCache(const char* cacheName, unsigned char* data, int size)
+{
+	FILE* file = fopen(cacheName, "rb");
+	if(!file)
+		return false;
+
+	fseek(file, 0, SEEK_END);
+	bool ok = ftell(file) == size;
+	fseek(file, 0, SEEK_SET);
+	ok = ok && fread(data, 1, size, file) == (size_t)size;
+	fclose(file);
+	return ok;
+}
+
+static void WriteArchiveCache(const char* cacheName, const unsigned char* data, int size)
+{
+	// written under a name of our own first, so other instances sharing the cache never read half a file
+	char tempName [1040];
+	sprintf(tempName, "%s.%lu", cacheName, GetCurrentProcessId());
+
+	FILE* file = fopen(tempName, "wb");
+	if(!file)
+		return;
+	bool ok = fwrite(data, 1, size, file) == (size_t)size;
+	ok = !fclose(file) && ok;
+
+	if(!ok || !MoveFileEx(tempName, cacheName, MOVEFILE_REPLACE_EXISTING))
+		_unlink(tempName);
+}
+
+
+
+// picks the item of the archive to go on with: the one the next part of the logical path names
+// (bar is advanced past it), or else the one the user chooses
+static int ChooseNextItem(ArchiveFile& archive, char*& bar, const char** ignoreExtensions, int numIgnoreExtensions)
+{
+	int item = -1;
+	bool forceManual = false;
+	if(bar && *bar) // try following the in-archive part of the logical path
+	{
+		char* bar2 = strchr(bar, '|');
+		if(bar2) *bar2++ = 0;
+		int numItems = archive.GetNumItems();
+		for(int i = 0; i < numItems; i++)
+		{
+			if(archive.GetItemSize(i))
+			{
+				const char* itemName = archive.GetItemName(i);
+				if(!_stricmp(itemName, bar))
+				{
+					item = i; // match found, now we'll auto-follow the path
+					break;
+				}
+			}
+		}
+		if(item < 0)
+		{
+			forceManual = true; // we don't want it choosing something else without user permission
+			bar = NULL; // remaining archive path is invalid
+		}
+		else
+			bar = bar2; // advance to next archive path part
+	}
+	if(item < 0)
+		item = ChooseItemFromArchive(archive, !forceManual, ignoreExtensions, numIgnoreExtensions);
+	return item;
+}
+
 // example input Name:          "C:\games.zip"
 // example output LogicalName:  "C:\games.zip|Sonic.smd"
 // example output PhysicalName: "C:\Documents and Settings\User\Local Settings\Temp\Gens\dec3.tmp"
@@ -398,35 +527,7 @@ bool ObtainFile(const char* Name, char *const & LogicalName, char *const & Physi
 		}
 		else
 		{
-			int item = -1;
-			bool forceManual = false;
-			if(bar && *bar) // try following the in-archive part of the logical path
-			{
-				char* bar2 = strchr(bar, '|');
-				if(bar2) *bar2++ = 0;
-				int numItems = archive.GetNumItems();
-				for(int i = 0; i < numItems; i++)
-				{
-					if(archive.GetItemSize(i))
-					{
-						const char* itemName = archive.GetItemName(i);
-						if(!_stricmp(itemName, bar))
-						{
-							item = i; // match found, now we'll auto-follow the path
-							break;
-						}
-					}
-				}
-				if(item < 0)
-				{
-					forceManual = true; // we don't want it choosing something else without user permission
-					bar = NULL; // remaining archive path is invalid
-				}
-				else
-					bar = bar2; // advance to next archive path part
-			}
-			if(item < 0)
-				item = ChooseItemFromArchive(archive, !forceManual, ignoreExtensions, numIgnoreExtensions);
+			int item = ChooseNextItem(archive, bar, ignoreExtensions, numIgnoreExtensions);
 
 			const char* TempFileName = s_tempFiles.GetFile(category, strrchr(archive.GetItemName(item), '.'));
 			if(!archive.ExtractItem(item, TempFileName))
@@ -438,6 +539,93 @@ bool ObtainFile(const char* Name, char *const & LogicalName, char *const & Physi
 	}
 }
 
+bool ObtainFileData(const char* Name, char *const & LogicalName, char *const & PhysicalName, unsigned char*& Data, int& DataSize, int maxDataSize, const char* category, const char** ignoreExtensions, int numIgnoreExtensions)
+{
+	Data = NULL;
+	DataSize = 0;
+
+	char ArchivePaths [1024];
+	strcpy(LogicalName, Name);
+	strcpy(PhysicalName, Name);
+	strcpy(ArchivePaths, Name);
+	char* bar = strchr(ArchivePaths, '|');
+	if(bar)
+	{
+		PhysicalName[bar - ArchivePaths] = 0; // doesn't belong in the physical name
+		LogicalName[bar - ArchivePaths] = 0; // we'll reconstruct the logical name as we go
+		*bar++ = 0; // bar becomes the next logical archive path component
+	}
+
+	while(true)
+	{
+		ArchiveFile archive (PhysicalName);
+		if(!archive.IsCompressed())
+			return archive.GetNumItems() > 0;
+
+		int item = ChooseNextItem(archive, bar, ignoreExtensions, numIgnoreExtensions);
+		if(item < 0)
+		{
+			s_tempFiles.ReleaseFile(PhysicalName);
+			return false;
+		}
+		const char* itemName = archive.GetItemName(item);
+		int itemSize = archive.GetItemSize(item);
+
+		if(itemSize > maxDataSize)
+		{
+			// too big for the caller's buffer, same as ObtainFile()
+			const char* TempFileName = s_tempFiles.GetFile(category, strrchr(itemName, '.'));
+			if(!archive.ExtractItem(item, TempFileName))
+				s_tempFiles.ReleaseFile(TempFileName);
+			s_tempFiles.ReleaseFile(PhysicalName);
+			strcpy(PhysicalName, TempFileName);
+			_snprintf(LogicalName + strlen(LogicalName), 1024 - (strlen(LogicalName)+1), "|%s", itemName);
+			continue;
+		}
+
+		unsigned char* data = new unsigned char [itemSize];
+		char cacheName [1024];
+		bool cacheable = *s_archiveCacheDir && GetArchiveCacheName(PhysicalName, item, itemSize, cacheName);
+		bool ok = cacheable && ReadArchiveCache(cacheName, data, itemSize);
+		if(!ok)
+		{
+			ok = archive.ExtractItem(item, data, itemSize) == itemSize;
+			if(ok && cacheable)
+				WriteArchiveCache(cacheName, data, itemSize);
+		}
+
+		const char* TempFileName = NULL;
+		if(ok && IsArchiveData(itemName, data, itemSize))
+		{
+			// an archive within the archive, opened from a temporary file on the next pass
+			TempFileName = GetTempFileWithData(category, strrchr(itemName, '.'), data, itemSize);
+			delete[] data;
+			data = NULL;
+			ok = TempFileName != NULL;
+		}
+
+		char prevName [1024];
+		strcpy(prevName, PhysicalName);
+		strcpy(PhysicalName, TempFileName ? TempFileName : "");
+		s_tempFiles.ReleaseFile(prevName);
+
+		if(!ok)
+		{
+			delete[] data;
+			return false;
+		}
+
+		_snprintf(LogicalName + strlen(LogicalName), 1024 - (strlen(LogicalName)+1), "|%s", itemName);
+
+		if(data)
+		{
+			Data = data;
+			DataSize = itemSize;
+			return true;
+		}
+	}
+}
+
 
 
 struct ControlLayoutInfo
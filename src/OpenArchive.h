@@ -20,6 +20,22 @@
 // assumes the three name arguments are distinct character buffers with exactly 1024 bytes each
 bool ObtainFile(const char* Name, char *const & LogicalName, char *const & PhysicalName, const char* category=NULL, const char** ignoreExtensions=NULL, int numIgnoreExtensions=0);
 
+// ObtainFileData()
+// same as ObtainFile(), except that a file found in an archive is extracted straight into memory
+// instead of to a temporary file that then has to be read back.
+// if that happened, Data is the file's contents (DataSize bytes, free it with delete[])
+// and PhysicalName is empty; otherwise Data is NULL and PhysicalName is a file as with ObtainFile().
+// files bigger than maxDataSize still go to a temporary file.
+// with an archive cache directory set, the extracted data is also kept there and read back
+// from it the next time instead of decompressing the archive again.
+bool ObtainFileData(const char* Name, char *const & LogicalName, char *const & PhysicalName, unsigned char*& Data, int& DataSize, int maxDataSize, const char* category=NULL, const char** ignoreExtensions=NULL, int numIgnoreExtensions=0);
+
+// SetArchiveCacheDir()
+// directory where ObtainFileData() keeps the files it extracted, under names made from a crc32
+// of the whole archive and the item, so it is safe to share between instances and to keep around.
+// NULL or "" turns the cache off (the default)
+void SetArchiveCacheDir(const char* dir);
+
 // ReleaseTempFileCategory()
 // this is for deleting the temporary files that ObtainFile() can create.
 // using it is optional because they will auto-delete on proper shutdown of the program,
@@ -38,6 +54,7 @@ void SetArchiveParentHWND(void* hwnd=NULL);
 // but they could be generally useful outside of that
 const char* GetTempFile(const char* category=NULL, const char* extension=NULL); // creates a temp file and returns a path to it.  extension if any should include the '.'
 void ReleaseTempFile(const char* filename); // deletes a particular temporary file, by filename
+const char* GetTempFileWithData(const char* category, const char* extension, const unsigned char* data, int size); // GetTempFile() with data written to it, or NULL if that failed
 int ChooseItemFromArchive(ArchiveFile& archive, bool autoChooseIfOnly1=true, const char** ignoreExtensions=0, int numIgnoreExtensions=0); // gets an index to a file within an already-open archive, using the file chooser if there's more than one choice
 
 #endif
@@ -14,6 +14,19 @@
 #include "automation.h"
 #include "state_dump.h"
 #include "bintrace.h"
+#include "plugin.h"
+#include "ram_history.h"
+#include "vdp_rend.h"
+#include "idle_loop.h"
+#include "gfx_cd.h"
+#include "m68k_verify.h"
+#include "z80_verify.h"
+#include "frame_prof.h"
+#include "bench.h"
+#include "state_hash.h"
+#include "OpenArchive.h"
+#include "startup_prof.h"
+#include "orchestrator.h"
 #include "gens.h"
 
 using namespace std;
@@ -37,7 +50,8 @@ void ParseCmdLine(LPSTR lpCmdLine, HWND HWnd)
 		"-screenshot-interval", "-screenshot-dir", "-reference-dir", "-max-frames", "-max-diffs", "-max-memory-diffs", "-frameskip", "-turbo", "-nosound", "-window-x", "-window-y", "-diff-color",
 		"-dump-state-dir", "-dump-state-interval", "-dump-state-start", "-dump-state-end", "-save-state-dumps", "-compare-state-dumps", "-memory-after-visual", "-no-memory-diffs",
 		"-trace-breakpoint", "-trace-frames", "-trace-log", "-trace-start", "-trace-end",
-		"-bintrace", "-bintrace-start", "-bintrace-end", "-bintrace-vdp", "-bintrace-dma", ""};	//Hint:  to add new commandlines, start by inserting them here.
+		"-bintrace", "-bintrace-start", "-bintrace-end", "-bintrace-vdp", "-bintrace-dma",
+		"-plugin", "-ramhist-frames", "-ramhist-range", "-ramhist-query", "-ramhist-out", "-vdp-renderer", "-idle-skip", "-32x-sync", "-scd-gfx", "-m68k-core", "-z80-core", "-profile-out", "-profile-frames", "-bench-out", "-bench-frames", "-hash-out", "-hash-check", "-hash-ignore", "-archive-cache", "-batch", "-startup-report", "-variants", "-results", "-workers", "-worker-slot", "-worker-timeout", ""};	//Hint:  to add new commandlines, start by inserting them here.
 
 	//Strings that will get parsed:
 	string CfgToLoad = "";		//Cfg filename
@@ -86,6 +100,49 @@ void ParseCmdLine(LPSTR lpCmdLine, HWND HWnd)
 	string BinTraceVDPStr = "";			// Log VDP accesses (1 = yes, 0 = no)
 	string BinTraceDMAStr = "";			// Log DMA transfers (1 = yes, 0 = no)
 
+	// Native plugins
+	vector<string> PluginsToLoad;		// Plugin DLL filenames
+
+	// RAM history parameters
+	string RamHistFramesStr = "";		// Frames to record, START-END
+	string RamHistRangeStr = "";		// Hardware range to record, ADDRESS:SIZE (hex)
+	string RamHistQueryStr = "";		// Query to run when recording ends
+	string RamHistOutStr = "";			// Output file for the matching addresses
+
+	// Renderer selection
+	string VDPRendererStr = "";			// Genesis line renderer: asm, c, thread or verify
+	string IdleSkipStr = "";			// Idle loop skipping: off, on or verify
+	string SyncStr32X = "";				// 32X CPU interleaving: strict or adaptive
+	string GFXCDStr = "";				// Sega CD stamp rotation/scaling: asm, c or verify
+	string M68KCoreStr = "";			// Main 68000 core: asm or verify
+	string Z80CoreStr = "";			// Z80 core: asm, c or verify
+
+	// Frame profiler
+	string ProfileOutStr = "";			// CSV or JSON file for the per-frame stage times
+	string ProfileFramesStr = "";		// Frames per row
+
+	// Benchmark suite
+	string BenchOutStr = "";			// JSON file for the replay and hot path timings
+	string BenchFramesStr = "";			// Frames replayed per variant
+
+	// Determinism checker
+	string HashOutStr = "";				// Per-frame state hashes of this run
+	string HashCheckStr = "";			// Hashes of a previous run to compare with
+	string HashIgnoreStr = "";			// Sections that aren't compared
+
+	// Archive cache
+	string ArchiveCacheStr = "";		// Directory for files extracted from archives
+
+	// Batch startup
+	string StartupReportStr = "";		// CSV or JSON file for the startup stage times
+
+	// Variant orchestrator
+	string VariantsStr = "";			// Manifest of ROM variants to run in worker processes
+	string ResultsStr = "";				// CSV or JSON file for the results of all variants
+	string WorkersStr = "";				// Number of worker processes (default: one per core)
+	string WorkerSlotStr = "";			// Given to the workers by the orchestrator
+	string WorkerTimeoutStr = "";		// Seconds before a worker is killed (default: no limit)
+
 	//Temps for finding string list
 	int commandBegin = 0;	//Beginning of Command
 	int commandEnd = 0;		//End of Command
@@ -235,7 +292,84 @@ void ParseCmdLine(LPSTR lpCmdLine, HWND HWnd)
 		case 36: //-bintrace-dma
 			BinTraceDMAStr = newCommand;
 			break;
-		case 37: //  (a filename on its own, this must come BEFORE any other options on the commandline)
+		case 37: //-plugin
+			PluginsToLoad.push_back(newCommand);
+			break;
+		case 38: //-ramhist-frames
+			RamHistFramesStr = newCommand;
+			break;
+		case 39: //-ramhist-range
+			RamHistRangeStr = newCommand;
+			break;
+		case 40: //-ramhist-query
+			RamHistQueryStr = newCommand;
+			break;
+		case 41: //-ramhist-out
+			RamHistOutStr = newCommand;
+			break;
+		case 42: //-vdp-renderer
+			VDPRendererStr = newCommand;
+			break;
+		case 43: //-idle-skip
+			IdleSkipStr = newCommand;
+			break;
+		case 44: //-32x-sync
+			SyncStr32X = newCommand;
+			break;
+		case 45: //-scd-gfx
+			GFXCDStr = newCommand;
+			break;
+		case 46: //-m68k-core
+			M68KCoreStr = newCommand;
+			break;
+		case 47: //-z80-core
+			Z80CoreStr = newCommand;
+			break;
+		case 48: //-profile-out
+			ProfileOutStr = newCommand;
+			break;
+		case 49: //-profile-frames
+			ProfileFramesStr = newCommand;
+			break;
+		case 50: //-bench-out
+			BenchOutStr = newCommand;
+			break;
+		case 51: //-bench-frames
+			BenchFramesStr = newCommand;
+			break;
+		case 52: //-hash-out
+			HashOutStr = newCommand;
+			break;
+		case 53: //-hash-check
+			HashCheckStr = newCommand;
+			break;
+		case 54: //-hash-ignore
+			HashIgnoreStr = newCommand;
+			break;
+		case 55: //-archive-cache
+			ArchiveCacheStr = newCommand;
+			break;
+		case 56: //-batch (already applied in WinMain, Init needs it)
+			break;
+		case 57: //-startup-report
+			StartupReportStr = newCommand;
+			break;
+		case 58: //-variants
+			VariantsStr = newCommand;
+			break;
+		case 59: //-results
+			ResultsStr = newCommand;
+			break;
+		case 60: //-workers
+			WorkersStr = newCommand;
+			break;
+		case 61: //-worker-slot
+			WorkerSlotStr = newCommand;
+			break;
+		case 62: //-worker-timeout
+			WorkerTimeoutStr = newCommand;
+			break;
+		case 63: //  (a filename on its own, this must come BEFORE any other options on the commandline)
 			if(newCommand[0] != '-')
 				FileToLoad = newCommand;
 			break;
@@ -243,6 +377,35 @@ void ParseCmdLine(LPSTR lpCmdLine, HWND HWnd)
 	}
 	//--------------------------------------------------------------------------------------------
 	//Execute commands
+
+	// this process only hands the variants out, the workers run the rest of the command line
+	if (VariantsStr[0])
+	{
+		Orchestrator_Run(VariantsStr.c_str(), ResultsStr.c_str(), WorkersStr[0] ? atoi(WorkersStr.c_str()) : 0,
+			WorkerTimeoutStr[0] ? atoi(WorkerTimeoutStr.c_str()) : 0,
+			ReferenceDirStr.c_str(), ScreenshotDirStr[0] ? ScreenshotDirStr.c_str() : ".", argumentList.c_str());
+		PostMessage(HWnd, WM_CLOSE, 0, 0);
+		return;
+	}
+
+	// before anything is opened, archives included
+	if (ArchiveCacheStr[0])
+		SetArchiveCacheDir(ArchiveCacheStr.c_str());
+
+	// the variant is a patch applied while the ROM loads
+	if (WorkerSlotStr[0] && !Orchestrator_Worker_Open(WorkerSlotStr.c_str()))
+	{
+		PostMessage(HWnd, WM_CLOSE, 0, 0);
+		return;
+	}
+
+	// Plugins go first so their hooks see the ROM boot
+	for(unsigned int i = 0; i < PluginsToLoad.size(); i++)
+	{
+		if(PluginsToLoad[i][0])
+			Plugin_Load(PluginsToLoad[i].c_str());
+	}
+	Startup_Mark("plugins");
 	
 	// anything (rom, movie, cfg, luascript, etc.)
 	if (FileToLoad[0])
@@ -264,6 +427,7 @@ void ParseCmdLine(LPSTR lpCmdLine, HWND HWnd)
 	{
 		GensLoadRom(RomToLoad.c_str());
 	}
+	Startup_Mark("rom");
 	
 	//Movie
 	if (MovieToLoad[0]) GensPlayMovie(MovieToLoad.c_str(), 1);
@@ -521,6 +685,129 @@ void ParseCmdLine(LPSTR lpCmdLine, HWND HWnd)
 		BinTrace_Init(BinTracePath);
 	}
 
+	// RAM history parameters (recording starts in RamHistory_OnFrame)
+	if (RamHistRangeStr[0])
+	{
+		unsigned int address = 0, size = 0;
+		if (sscanf(RamHistRangeStr.c_str(), "%x:%x", &address, &size) == 2)
+		{
+			RamHistoryAddress = address;
+			RamHistorySize = size;
+		}
+	}
+
+	if (RamHistQueryStr[0])
+	{
+		strncpy(RamHistoryQueryText, RamHistQueryStr.c_str(), sizeof(RamHistoryQueryText) - 1);
+		RamHistoryQueryText[sizeof(RamHistoryQueryText) - 1] = '\0';
+	}
+
+	if (RamHistOutStr[0])
+	{
+		strncpy(RamHistoryOutPath, RamHistOutStr.c_str(), sizeof(RamHistoryOutPath) - 1);
+		RamHistoryOutPath[sizeof(RamHistoryOutPath) - 1] = '\0';
+	}
+
+	if (RamHistFramesStr[0])
+	{
+		int start = 0, end = 0;
+		if (sscanf(RamHistFramesStr.c_str(), "%d-%d", &start, &end) >= 1 && start >= 0)
+		{
+			RamHistoryStartFrame = start;
+			RamHistoryEndFrame = end;
+		}
+	}
+
+	if (VDPRendererStr[0])
+	{
+		if (VDPRendererStr == "c")
+			VDP_Renderer = VDP_RENDERER_C;
+		else if (VDPRendererStr == "verify")
+			VDP_Renderer = VDP_RENDERER_VERIFY;
+		else if (VDPRendererStr == "asm")
+			VDP_Renderer = VDP_RENDERER_ASM;
+		else if (VDPRendererStr == "thread")
+			VDP_Renderer = VDP_RENDERER_THREAD;
+		else
+			fprintf(stderr, "unknown renderer \"%s\" (use asm, c, thread or verify)\n", VDPRendererStr.c_str());
+	}
+
+	if (IdleSkipStr[0])
+	{
+		if (IdleSkipStr == "on")
+			Idle_Skip = IDLE_SKIP_ON;
+		else if (IdleSkipStr == "verify")
+			Idle_Skip = IDLE_SKIP_VERIFY;
+		else if (IdleSkipStr == "off")
+			Idle_Skip = IDLE_SKIP_OFF;
+		else
+			fprintf(stderr, "unknown idle skip mode \"%s\" (use off, on or verify)\n", IdleSkipStr.c_str());
+	}
+
+	if (SyncStr32X[0])
+	{
+		if (SyncStr32X == "adaptive")
+			_32X_Sync = _32X_SYNC_ADAPTIVE;
+		else if (SyncStr32X == "strict")
+			_32X_Sync = _32X_SYNC_STRICT;
+		else
+			fprintf(stderr, "unknown 32X sync mode \"%s\" (use strict or adaptive)\n", SyncStr32X.c_str());
+	}
+
+	if (GFXCDStr[0])
+	{
+		if (GFXCDStr == "c")
+			GFX_CD_Renderer = GFX_CD_RENDERER_C;
+		else if (GFXCDStr == "verify")
+			GFX_CD_Renderer = GFX_CD_RENDERER_VERIFY;
+		else if (GFXCDStr == "asm")
+			GFX_CD_Renderer = GFX_CD_RENDERER_ASM;
+		else
+			fprintf(stderr, "unknown Sega CD graphics mode \"%s\" (use asm, c or verify)\n", GFXCDStr.c_str());
+	}
+
+	if (M68KCoreStr[0])
+	{
+		if (M68KCoreStr == "verify")
+			M68K_Core = M68K_CORE_VERIFY;
+		else if (M68KCoreStr == "asm")
+			M68K_Core = M68K_CORE_ASM;
+		else
+			fprintf(stderr, "unknown 68000 core \"%s\" (use asm or verify)\n", M68KCoreStr.c_str());
+	}
+
+	if (Z80CoreStr[0])
+	{
+		if (Z80CoreStr == "c")
+			Z80_Core = Z80_CORE_C;
+		else if (Z80CoreStr == "verify")
+			Z80_Core = Z80_CORE_VERIFY;
+		else if (Z80CoreStr == "asm")
+			Z80_Core = Z80_CORE_ASM;
+		else
+			fprintf(stderr, "unknown Z80 core \"%s\" (use asm, c or verify)\n", Z80CoreStr.c_str());
+	}
+
+	if (ProfileOutStr[0])
+		Frame_Prof_Open(ProfileOutStr.c_str(), ProfileFramesStr[0] ? atoi(ProfileFramesStr.c_str()) : 0);
+
+	if (HashIgnoreStr[0])
+		State_Hash_Ignore(HashIgnoreStr.c_str());
+	if (HashOutStr[0] || HashCheckStr[0])
+		State_Hash_Open(HashOutStr.c_str(), HashCheckStr.c_str());
+
+	// up to here is startup, the first frame comes next (or the benchmark)
+	Startup_Mark("cmdline");
+	if (StartupReportStr[0])
+		Startup_Report(StartupReportStr.c_str());
+
+	// Last, so the replay runs with the movie, scripts and modes set above, then quits
+	if (BenchOutStr[0])
+	{
+		Bench_Run(BenchOutStr.c_str(), BenchFramesStr[0] ? atoi(BenchFramesStr.c_str()) : 0);
+		PostMessage(HWnd, WM_CLOSE, 0, 0);
+	}
+
 
 /* OLD CODE	
 		char Str_Tmpy[1024];
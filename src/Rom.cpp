@@ -39,6 +39,10 @@ char _32X_Master_Bios[1024];
 char _32X_Slave_Bios[1024];
 char Genesis_Bios[1024];
 
+// IPS patch applied to each Genesis or 32X ROM as it's loaded (orchestrator variants)
+static const unsigned char *Rom_Patch = NULL;
+static int Rom_Patch_Size = 0;
+
 
 void Get_Name_From_Path(char *Full_Path, char *Name)
 {
@@ -163,10 +167,10 @@ void Update_CD_Rom_Name(char *Name)
 }
 
 
+static int Detect_Format_Header(const char *Name, const char *buf);
+
 int Detect_Format(char *FileName)
 {
-	int i;
-	
 	char Name [1024];
 	strncpy(Name, FileName, 1024);
 	Name[1023] = '\0';
@@ -222,6 +226,24 @@ int Detect_Format(char *FileName)
 		fclose(f);
 	}
 
+	return Detect_Format_Header(Name, buf);
+}
+
+
+int Detect_Format_Data(char *Name, unsigned char *Data, int Size)
+{
+	char buf [1024] = {0};
+
+	memcpy(buf, Data, Size < 1024 ? Size : 1024);
+
+	return Detect_Format_Header(Name, buf);
+}
+
+
+static int Detect_Format_Header(const char *Name, const char *buf)
+{
+	int i;
+
 	if (!strnicmp("SEGADISCSYSTEM", &buf[0x00], 14)) return SEGACD_IMAGE;		// Sega CD (ISO)
 	if (!strnicmp("SEGADISCSYSTEM", &buf[0x10], 14)) return SEGACD_IMAGE + 1;	// Sega CD (BIN)
 
@@ -365,6 +387,21 @@ static const char* s_nonRomExtensions [] = {"txt", "nfo", "htm", "html", "jpg",
 
 
 
+static void Apply_Rom_Patch(void)
+{
+	switch (IPS_Patch_Data(Rom_Patch, Rom_Patch_Size))
+	{
+		case 0:
+			break;
+		case 4:
+			fprintf(stderr, "rom: the IPS patch goes past %u MB, the bytes past that aren't applied\n", (unsigned int)(sizeof(Rom_Data) >> 20));
+			break;
+		default:
+			fprintf(stderr, "rom: broken IPS patch, applied up to where it breaks\n");
+			break;
+	}
+}
+
 int Get_Rom(HWND hWnd)
 {
 	char Name[1024];
@@ -427,15 +464,21 @@ int Get_Rom(HWND hWnd)
 
 
 	char LogicalName[1024], PhysicalName[1024];
-	if(!ObtainFile(Name, LogicalName, PhysicalName, "rom", s_nonRomExtensions, sizeof(s_nonRomExtensions)/sizeof(*s_nonRomExtensions)))
+	unsigned char *Data;
+	int Data_Size;
+	if(!ObtainFileData(Name, LogicalName, PhysicalName, Data, Data_Size, sizeof(Rom_Data), "rom", s_nonRomExtensions, sizeof(s_nonRomExtensions)/sizeof(*s_nonRomExtensions)))
 		return 0;
 
 	Free_Rom(Game);
 	ReleaseTempFileCategory("rom", PhysicalName); // delete the old temporary file if any
 
-	sys = Detect_Format(PhysicalName);
+	sys = Data ? Detect_Format_Data(LogicalName, Data, Data_Size) : Detect_Format(PhysicalName);
 
-	if (sys < 1) return -1;
+	if (sys < 1)
+	{
+		delete[] Data;
+		return -1;
+	}
 
 	File_Type_Index = ofn.nFilterIndex;
 
@@ -451,9 +494,20 @@ int Get_Rom(HWND hWnd)
 
 	if ((sys >> 1) < 3)		// Have to load a rom
 	{
-		Game = Load_Rom(hWnd, PhysicalName, sys & 1);
+		if (Data) Game = Load_Rom_Data(Data, Data_Size, sys & 1);
+		else Game = Load_Rom(hWnd, PhysicalName, sys & 1);
 		ReleaseTempFileCategory("rom"); // delete the temp file right away since it's fully in memory now
+
+		// still in file order here, Init_Genesis and Init_32X byteswap it
+		if (Game && Rom_Patch)
+			Apply_Rom_Patch();
 	}
+	else if (Data)		// the CD code reads the image itself
+	{
+		const char *Temp_Name = GetTempFileWithData("rom", strrchr(LogicalName, '.'), Data, Data_Size);
+		strcpy(PhysicalName, Temp_Name ? Temp_Name : "");
+	}
+	delete[] Data;
 
 	switch (sys >> 1)
 	{
@@ -494,15 +548,21 @@ int Pre_Load_Rom(HWND hWnd, const char *NameTemp)
 	SetCurrentDirectory(Gens_Path);
 
 	char LogicalName[1024], PhysicalName[1024];
-	if(!ObtainFile(Name, LogicalName, PhysicalName, "rom", s_nonRomExtensions, sizeof(s_nonRomExtensions)/sizeof(*s_nonRomExtensions)))
+	unsigned char *Data;
+	int Data_Size;
+	if(!ObtainFileData(Name, LogicalName, PhysicalName, Data, Data_Size, sizeof(Rom_Data), "rom", s_nonRomExtensions, sizeof(s_nonRomExtensions)/sizeof(*s_nonRomExtensions)))
 		return 0;
 
 	Free_Rom(Game);
 	ReleaseTempFileCategory("rom", PhysicalName); // delete the old temporary file if any
 
-	sys = Detect_Format(PhysicalName);
+	sys = Data ? Detect_Format_Data(LogicalName, Data, Data_Size) : Detect_Format(PhysicalName);
 
-	if (sys < 1) return -1;
+	if (sys < 1)
+	{
+		delete[] Data;
+		return -1;
+	}
 
 	Update_Recent_Rom(LogicalName);
 	Update_Rom_Dir(LogicalName);
@@ -510,9 +570,20 @@ int Pre_Load_Rom(HWND hWnd, const char *NameTemp)
 
 	if ((sys >> 1) < 3)		// Have to load a rom
 	{
-		Game = Load_Rom(hWnd, PhysicalName, sys & 1);
+		if (Data) Game = Load_Rom_Data(Data, Data_Size, sys & 1);
+		else Game = Load_Rom(hWnd, PhysicalName, sys & 1);
 		ReleaseTempFileCategory("rom"); // delete the temp file right away since it's fully in memory now
+
+		// still in file order here, Init_Genesis and Init_32X byteswap it
+		if (Game && Rom_Patch)
+			Apply_Rom_Patch();
 	}
+	else if (Data)		// the CD code reads the image itself
+	{
+		const char *Temp_Name = GetTempFileWithData("rom", strrchr(LogicalName, '.'), Data, Data_Size);
+		strcpy(PhysicalName, Temp_Name ? Temp_Name : "");
+	}
+	delete[] Data;
 
 	switch (sys >> 1)
 	{
@@ -571,14 +642,18 @@ Rom *Load_Bios(HWND hWnd, char *Name)
 	SetCurrentDirectory(Gens_Path);
 
 	char LogicalName[1024], PhysicalName[1024];
-	if(!ObtainFile(Name, LogicalName, PhysicalName, "bios", s_nonRomExtensions, sizeof(s_nonRomExtensions)/sizeof(*s_nonRomExtensions)))
+	unsigned char *Data;
+	int Data_Size;
+	if(!ObtainFileData(Name, LogicalName, PhysicalName, Data, Data_Size, sizeof(Rom_Data), "bios", s_nonRomExtensions, sizeof(s_nonRomExtensions)/sizeof(*s_nonRomExtensions)))
 		return 0;
 
 	Free_Rom(Game);
 	ReleaseTempFileCategory("bios", PhysicalName); // delete the old temporary file if any
 
-	Game = Load_Rom(hWnd, PhysicalName, 0);
+	if (Data) Game = Load_Rom_Data(Data, Data_Size, 0);
+	else Game = Load_Rom(hWnd, PhysicalName, 0);
 	ReleaseTempFileCategory("bios"); // delete the temp file right away since it's fully in memory now
+	delete[] Data;
 
 	return Game;
 }
@@ -613,6 +688,31 @@ Rom *Load_Rom(HWND hWnd, char *Name, int inter)
 
 	return My_Rom;
 }
+
+// Rom already extracted to memory (ObtainFileData), copied in once the previous game is freed
+Rom *Load_Rom_Data(unsigned char *Data, int Size, int inter)
+{
+	memset(Rom_Data, 0, sizeof(Rom_Data));
+	Rom_Size = 0;
+
+	if(Size <= sizeof(Rom_Data))
+	{
+		memcpy(Rom_Data, Data, Size);
+		Rom_Size = Size;
+	}
+
+	My_Rom = (Rom*) malloc(sizeof(Rom));
+	// freed later in Free_Rom
+
+	if(!Rom_Size || !My_Rom)
+		return NULL;
+
+	if (inter) De_Interleave();
+
+	Fill_Infos();
+
+	return My_Rom;
+}
  
 
 
@@ -735,6 +835,65 @@ int IPS_Patching(void)
 }
 
 
+// A patched byte past the end of the ROM makes it longer, up to the size of Rom_Data
+static int IPS_Put(unsigned int adr, unsigned char data)
+{
+	if (adr >= sizeof(Rom_Data))
+		return 0;
+	if (adr >= Rom_Size)
+		Rom_Size = (adr + 2) & ~1;		// Init_Genesis byteswaps whole words
+	Rom_Data[adr] = data;
+	return 1;
+}
+
+int IPS_Patch_Data(const unsigned char *Data, int Size)
+{
+	unsigned int adr, len, i;
+	int pos = 5, ok = 1;
+
+	if (Size < 5 || memcmp(Data, "PATCH", 5))
+		return 2;
+
+	while (pos + 3 <= Size && memcmp(Data + pos, "EOF", 3))
+	{
+		adr = (Data[pos] << 16) | (Data[pos + 1] << 8) | Data[pos + 2];
+		if (pos + 5 > Size)
+			return 3;
+		len = (Data[pos + 3] << 8) | Data[pos + 4];
+		pos += 5;
+
+		if (len)
+		{
+			if (pos + (int) len > Size)
+				return 3;
+			for(i = 0; i < len; i++, adr++)
+				ok &= IPS_Put(adr, Data[pos + i]);
+			pos += len;
+		}
+		else	// run: 16-bit count, then the byte to repeat
+		{
+			if (pos + 3 > Size)
+				return 3;
+			len = (Data[pos] << 8) | Data[pos + 1];
+			for(i = 0; i < len; i++, adr++)
+				ok &= IPS_Put(adr, Data[pos + 2]);
+			pos += 3;
+		}
+	}
+
+	if (pos + 3 > Size)
+		return 3;
+	return ok ? 0 : 4;
+}
+
+
+void Set_Rom_Patch(const unsigned char *Data, int Size)
+{
+	Rom_Patch = Data;
+	Rom_Patch_Size = Size;
+}
+
+
 void Free_Rom(Rom *Rom_MD)
 {
 	if (Game == NULL) return;
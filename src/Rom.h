@@ -54,15 +54,22 @@ void Get_Name_From_Path(char *Full_Path, char *Name);
 void Get_Dir_From_Path(char *Full_Path, char *Dir);
 void Update_CD_Rom_Name(char *Name);
 int Detect_Format(char *Name);
+int Detect_Format_Data(char *Name, unsigned char *Data, int Size);
 int Get_Rom(HWND hWnd);
 int Pre_Load_Rom(HWND hWnd, const char *Name);
 int Load_Rom_CC(char *Name, int Size);
 struct Rom *Load_Bios(HWND hWnd, char *Name);
 struct Rom *Load_Rom(HWND hWnd, char *Name, int inter);
+struct Rom *Load_Rom_Data(unsigned char *Data, int Size, int inter);
 //struct Rom *Load_Rom_Zipped(HWND hWnd, char *Name, int inter);
 void Fix_Checksum(void);
 unsigned int Calculate_CRC32(void);
 int IPS_Patching();
+// Same return codes as IPS_Patching, for an IPS file already in memory; patches Rom_Data in file order.
+// Records past the end of the ROM make it longer (Rom_Size), 4 if some go past the end of Rom_Data.
+int IPS_Patch_Data(const unsigned char *Data, int Size);
+// Patch every Genesis or 32X ROM loaded from now on (NULL for none); Data has to stay valid
+void Set_Rom_Patch(const unsigned char *Data, int Size);
 void Free_Rom(struct Rom *Rom_Name);
 
 #ifdef __cplusplus
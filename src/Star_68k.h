@@ -9,6 +9,8 @@
 #ifndef __STARCPU_H__
 #define __STARCPU_H__
 
+#include <stddef.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -17,7 +19,7 @@ extern "C" {
 struct STARSCREAM_PROGRAMREGION {
 	unsigned lowaddr;
 	unsigned highaddr;
-	unsigned offset;
+	size_t   offset;
 };
 
 struct STARSCREAM_DATAREGION {
@@ -122,7 +124,7 @@ unsigned SN##readOdometer     (void);                         \
 unsigned SN##tripOdometer     (void);                         \
 unsigned SN##controlOdometer  (int n);                        \
 void     SN##releaseTimeslice (void);                         \
-void     SN##releaseCycles    (void);                         \
+void     SN##releaseCycles    (int cycles);                   \
 void     SN##addCycles        (int cycles);                   \
 unsigned SN##readPC           (void);                         \
 
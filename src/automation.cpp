@@ -15,6 +15,7 @@
 #include "scrshot.h"
 #include "png.h"
 #include "drawutil.h"
+#include "pixconv.h"
 #include "movie.h"
 #include "vdp_io.h"
 #include "Mem_M68k.h"
@@ -22,6 +23,8 @@
 #include "Mem_Z80.h"
 #include "ym2612.h"
 #include "psg.h"
+#include "frame_prof.h"
+#include "orchestrator.h"
 
 // External function from scrshot.cpp
 extern bool write_png(void* data, int X, int Y, FILE* fp);
@@ -45,6 +48,9 @@ char ReferenceDir[1024] = "";
 unsigned char DiffColor[4] = {255, 0, 255, 255};  // BGRA: Pink (magenta) by default
 int CompareStateDumpsMode = 0;
 int NoMemoryDiffs = 0;  // When 1, don't save memory diff files (visual-only mode)
+int FirstDiffFrame = -1;
+int FirstMemoryDiffFrame = -1;
+const char* ExitReason = NULL;
 
 // Trace automation variables
 unsigned int TraceBreakpointPC = 0;    // PC address to trigger trace (0 = disabled)
@@ -71,6 +77,9 @@ void Automation_Init()
     DiffCount = 0;
     MaxMemoryDiffs = 10;
     MemoryDiffCount = 0;
+    FirstDiffFrame = -1;
+    FirstMemoryDiffFrame = -1;
+    ExitReason = NULL;
     SaveMemoryOnlyAfterVisual = 0;
     strcpy(ScreenshotDir, ".");
     ReferenceDir[0] = '\0';
@@ -95,14 +104,15 @@ void Automation_Reset()
 {
     DiffCount = 0;
     MemoryDiffCount = 0;
+    FirstDiffFrame = -1;
+    FirstMemoryDiffFrame = -1;
 }
 
 // Write current frame to BGRA buffer (based on WriteFrame from scrshot.cpp)
 // Buffer is filled bottom-to-top (BMP order) - write_png will flip it
 static void WriteFrameToBGRA(void* Screen, unsigned char* Dest, int mode, int Hmode, int Vmode, int X, int Y)
 {
-    int i, j;
-    unsigned int tmp;
+    int j;
     unsigned char *Src = (unsigned char *)(Screen);
 
     int srcWidth = Hmode ? 320 : 256;
@@ -115,34 +125,15 @@ static void WriteFrameToBGRA(void* Screen, unsigned char* Dest, int mode, int Hm
 
     // Write bottom row of screen to beginning of buffer (BMP order)
     // write_png will flip rows when writing PNG
+    // Each BGRA pixel is one little endian 0xAARRGGBB word, converted a whole row at a time
     for(j = 0; j < srcHeight; j++)
     {
-        unsigned char* dstPtr = Dest + j * srcWidth * 4;  // Sequential rows in buffer
+        unsigned int* dstPtr = (unsigned int*)(Dest + j * srcWidth * 4);  // Sequential rows in buffer
 
-        for(i = 0; i < srcWidth; i++)
-        {
-            // Read pixel based on mode
-            if(mode & 2) // 32-bit
-            {
-                tmp = *(unsigned int*)&(Src[4 * i]);
-            }
-            else if(!(mode & 1)) // 16-bit 565
-            {
-                unsigned short pix = Src[2 * i] + (Src[2 * i + 1] << 8);
-                tmp = DrawUtil::Pix16To32((pix16)pix) | 0xFF000000;
-            }
-            else // 16-bit 555
-            {
-                unsigned short pix = Src[2 * i] + (Src[2 * i + 1] << 8);
-                tmp = DrawUtil::Pix15To32((pix15)pix) | 0xFF000000;
-            }
-
-            // Write BGRA
-            dstPtr[4 * i + 0] = (tmp >>  0) & 0xFF; // B
-            dstPtr[4 * i + 1] = (tmp >>  8) & 0xFF; // G
-            dstPtr[4 * i + 2] = (tmp >> 16) & 0xFF; // R
-            dstPtr[4 * i + 3] = 0xFF;               // A (opaque)
-        }
+        if(mode & 2) // 32-bit
+            PixConv_32To32(dstPtr, (unsigned int*)Src, srcWidth);
+        else // 16-bit 565, or 555 with mode & 1
+            PixConv_16To32(dstPtr, (unsigned short*)Src, srcWidth, mode & 1);
 
         Src -= 336 * bytesPerPixel; // Move to previous row (going up on screen)
     }
@@ -181,43 +172,63 @@ int Save_Shot_To_File(void* screen, int mode, int Hmode, int Vmode, const char*
     return result ? 1 : 0;
 }
 
-bool Load_PNG(const char* path, unsigned char* buffer, int bufferSize, int* width, int* height)
+// Reads a PNG held in memory (reference data shared by the orchestrator)
+struct PNG_Memory_Reader
 {
-    FILE* fp = fopen(path, "rb");
-    if (!fp) return false;
+    const unsigned char* data;
+    size_t size;
+    size_t pos;
+};
+
+static void PNGAPI Read_PNG_Memory(png_structp png_ptr, png_bytep out, png_size_t length)
+{
+    PNG_Memory_Reader* reader = (PNG_Memory_Reader*)png_get_io_ptr(png_ptr);
+    if (length > reader->size - reader->pos)
+        png_error(png_ptr, "truncated PNG");
+    memcpy(out, reader->data + reader->pos, length);
+    reader->pos += length;
+}
+
+// Decode a PNG from fp, or from data/size when fp is NULL
+static bool Read_PNG(FILE* fp, const unsigned char* data, int size, unsigned char* buffer, int bufferSize, int* width, int* height)
+{
+    PNG_Memory_Reader reader = {data, (size_t)size, 8};
 
     // Check PNG signature
     unsigned char header[8];
-    fread(header, 1, 8, fp);
-    if (png_sig_cmp(header, 0, 8))
+    if (fp)
     {
-        fclose(fp);
-        return false;
+        if (fread(header, 1, 8, fp) != 8) return false;
     }
+    else
+    {
+        if (size < 8) return false;
+        memcpy(header, data, 8);
+    }
+    if (png_sig_cmp(header, 0, 8))
+        return false;
 
     png_structp png_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING, NULL, NULL, NULL);
     if (!png_ptr)
-    {
-        fclose(fp);
         return false;
-    }
 
     png_infop info_ptr = png_create_info_struct(png_ptr);
     if (!info_ptr)
     {
         png_destroy_read_struct(&png_ptr, NULL, NULL);
-        fclose(fp);
         return false;
     }
 
     if (setjmp(png_jmpbuf(png_ptr)))
     {
         png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
-        fclose(fp);
         return false;
     }
 
-    png_init_io(png_ptr, fp);
+    if (fp)
+        png_init_io(png_ptr, fp);
+    else
+        png_set_read_fn(png_ptr, &reader, Read_PNG_Memory);
     png_set_sig_bytes(png_ptr, 8);
     png_read_info(png_ptr, info_ptr);
 
@@ -248,7 +259,6 @@ bool Load_PNG(const char* path, unsigned char* buffer, int bufferSize, int* widt
     if (rowBytes * (*height) > bufferSize)
     {
         png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
-        fclose(fp);
         return false;
     }
 
@@ -259,23 +269,30 @@ bool Load_PNG(const char* path, unsigned char* buffer, int bufferSize, int* widt
     }
 
     png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
-    fclose(fp);
     return true;
 }
 
-bool Compare_With_Reference(void* screen, int mode, int Hmode, int Vmode, const char* refPath)
+bool Load_PNG(const char* path, unsigned char* buffer, int bufferSize, int* width, int* height)
+{
+    FILE* fp = fopen(path, "rb");
+    if (!fp) return false;
+
+    bool result = Read_PNG(fp, NULL, 0, buffer, bufferSize, width, height);
+    fclose(fp);
+    return result;
+}
+
+bool Load_PNG_Data(const unsigned char* data, int size, unsigned char* buffer, int bufferSize, int* width, int* height)
+{
+    return Read_PNG(NULL, data, size, buffer, bufferSize, width, height);
+}
+
+// Compare current screen with the reference already decoded into RefBuffer
+static bool Compare_With_RefBuffer(void* screen, int mode, int Hmode, int Vmode, int refWidth, int refHeight)
 {
     int X = Hmode ? 320 : 256;
     int Y = Vmode ? 240 : 224;
 
-    // Load reference PNG
-    int refWidth, refHeight;
-    if (!Load_PNG(refPath, RefBuffer, sizeof(RefBuffer), &refWidth, &refHeight))
-    {
-        // Reference file not found - treat as difference
-        return false;
-    }
-
     // Check dimensions match
     if (refWidth != X || refHeight != Y)
     {
@@ -310,6 +327,26 @@ bool Compare_With_Reference(void* screen, int mode, int Hmode, int Vmode, const
     return !hasDiff;  // true if screens match
 }
 
+bool Compare_With_Reference(void* screen, int mode, int Hmode, int Vmode, const char* refPath)
+{
+    // Load reference PNG
+    int refWidth, refHeight;
+    if (!Load_PNG(refPath, RefBuffer, sizeof(RefBuffer), &refWidth, &refHeight))
+    {
+        // Reference file not found - treat as difference
+        return false;
+    }
+    return Compare_With_RefBuffer(screen, mode, Hmode, Vmode, refWidth, refHeight);
+}
+
+bool Compare_With_Reference_Data(void* screen, int mode, int Hmode, int Vmode, const unsigned char* png, int pngSize)
+{
+    int refWidth, refHeight;
+    if (!Load_PNG_Data(png, pngSize, RefBuffer, sizeof(RefBuffer), &refWidth, &refHeight))
+        return false;
+    return Compare_With_RefBuffer(screen, mode, Hmode, Vmode, refWidth, refHeight);
+}
+
 // Save diff visualization image (reference with diff pixels highlighted)
 bool Save_Diff_Image(int X, int Y, const char* filename)
 {
@@ -344,7 +381,7 @@ static const char* GetSectionName(unsigned int section_id)
 // Compare section data and write diffs to file
 // Returns number of differing bytes
 static int Compare_Section_And_Write(FILE* fp, const char* sectionName,
-                                     unsigned char* refData, unsigned char* currentData, int size)
+                                     const unsigned char* refData, unsigned char* currentData, int size)
 {
     int diffCount = 0;
     for (int i = 0; i < size; i++)
@@ -361,7 +398,7 @@ static int Compare_Section_And_Write(FILE* fp, const char* sectionName,
 }
 
 // Read little-endian 32-bit integer from buffer
-static unsigned int Read_LE_U32(unsigned char* buf)
+static unsigned int Read_LE_U32(const unsigned char* buf)
 {
     return buf[0] | (buf[1] << 8) | (buf[2] << 16) | (buf[3] << 24);
 }
@@ -449,38 +486,19 @@ static void Collect_Current_CRAM(unsigned char* buffer)
     }
 }
 
-// Compare full genstate file with current emulator state
+// Compare a genstate image in memory with current emulator state
 // Writes all diffs to CSV file with section information
 // Returns total number of differing bytes across all sections
-int Compare_Full_State_And_Save_Diff(const char* refStatePath, const char* directory, const char* basename)
+static int Compare_Full_State_Data_And_Save_Diff(const unsigned char* fileData, long fileSize, const char* directory, const char* basename)
 {
-    FILE* refFile = fopen(refStatePath, "rb");
-    if (!refFile) return 0;
-
-    // Get file size
-    fseek(refFile, 0, SEEK_END);
-    long fileSize = ftell(refFile);
-    fseek(refFile, 0, SEEK_SET);
-
-    // Read entire file
-    unsigned char* fileData = new unsigned char[fileSize];
-    if (fread(fileData, 1, fileSize, refFile) != (size_t)fileSize)
-    {
-        delete[] fileData;
-        fclose(refFile);
-        return 0;
-    }
-    fclose(refFile);
+    if (fileSize < 64) return 0;
 
     // Open diff output file
     char diffFilename[1280];
     sprintf(diffFilename, "%s\\%s_memdiff.csv", directory, basename);
     FILE* diffFile = fopen(diffFilename, "w");
     if (!diffFile)
-    {
-        delete[] fileData;
         return 0;
-    }
 
     // Write CSV header
     fprintf(diffFile, "section,address,expected,actual,diff\n");
@@ -488,21 +506,22 @@ int Compare_Full_State_And_Save_Diff(const char* refStatePath, const char* direc
     int totalDiffs = 0;
 
     // Parse section table (starts at offset 64, after header)
-    unsigned char* sectionTable = fileData + 64;
+    const unsigned char* sectionTable = fileData + 64;
     int sectionIndex = 0;
 
     while (true)
     {
-        unsigned char* entry = sectionTable + sectionIndex * 16;
+        const unsigned char* entry = sectionTable + sectionIndex * 16;
         unsigned int section_id = Read_LE_U32(entry);
         unsigned int offset = Read_LE_U32(entry + 4);
         unsigned int size = Read_LE_U32(entry + 8);
 
         // End marker (all zeros)
         if (section_id == 0 && offset == 0 && size == 0) break;
+        if (offset > (unsigned int)fileSize || size > (unsigned int)fileSize - offset) break;
 
         // Get reference data pointer
-        unsigned char* refData = fileData + offset;
+        const unsigned char* refData = fileData + offset;
         const char* sectionName = GetSectionName(section_id);
 
         // Get current data based on section type
@@ -575,7 +594,6 @@ int Compare_Full_State_And_Save_Diff(const char* refStatePath, const char* direc
     }
 
     fclose(diffFile);
-    delete[] fileData;
 
     // Delete empty diff file
     if (totalDiffs == 0)
@@ -586,8 +604,37 @@ int Compare_Full_State_And_Save_Diff(const char* refStatePath, const char* direc
     return totalDiffs;
 }
 
+// Compare full genstate file with current emulator state
+// Returns total number of differing bytes across all sections
+int Compare_Full_State_And_Save_Diff(const char* refStatePath, const char* directory, const char* basename)
+{
+    FILE* refFile = fopen(refStatePath, "rb");
+    if (!refFile) return 0;
+
+    // Get file size
+    fseek(refFile, 0, SEEK_END);
+    long fileSize = ftell(refFile);
+    fseek(refFile, 0, SEEK_SET);
+
+    // Read entire file
+    unsigned char* fileData = new unsigned char[fileSize];
+    if (fread(fileData, 1, fileSize, refFile) != (size_t)fileSize)
+    {
+        delete[] fileData;
+        fclose(refFile);
+        return 0;
+    }
+    fclose(refFile);
+
+    int totalDiffs = Compare_Full_State_Data_And_Save_Diff(fileData, fileSize, directory, basename);
+    delete[] fileData;
+    return totalDiffs;
+}
+
 void Automation_OnFrame(int frameCount, void* screen, int mode, int Hmode, int Vmode)
 {
+    PROF_SCOPE(PROF_AUTOMATION);
+
     // Process state dumps (independent of screenshot automation)
     StateDump_OnFrame(frameCount);
 
@@ -616,6 +663,7 @@ void Automation_OnFrame(int frameCount, void* screen, int mode, int Hmode, int V
         if (BinTraceEndFrame > 0 && frameCount > BinTraceEndFrame)
         {
             BinTrace_Close();
+            ExitReason = "bintrace_end";
             PostMessage(HWnd, WM_CLOSE, 0, 0);
             return;
         }
@@ -628,6 +676,7 @@ void Automation_OnFrame(int frameCount, void* screen, int mode, int Hmode, int V
     if (MaxFrames > 0 && frameCount >= MaxFrames)
     {
         // Post close message to end emulation
+        ExitReason = "max_frames";
         PostMessage(HWnd, WM_CLOSE, 0, 0);
         return;
     }
@@ -635,6 +684,7 @@ void Automation_OnFrame(int frameCount, void* screen, int mode, int Hmode, int V
     // If no max frames limit, close when movie finishes
     if (MaxFrames == 0 && MainMovie.Status == MOVIE_FINISHED)
     {
+        ExitReason = "movie_end";
         PostMessage(HWnd, WM_CLOSE, 0, 0);
         return;
     }
@@ -670,13 +720,25 @@ void Automation_OnFrame(int frameCount, void* screen, int mode, int Hmode, int V
         bool screenshotDiff = false;
         bool memoryDiff = false;
 
+        // Reference data shared by the orchestrator, when this is one of its workers
+        const unsigned char* refData;
+        int refSize;
+
         // 1. SCREENSHOT COMPARISON
         char refPath[1024];
         sprintf(refPath, "%s\\%06d.png", ReferenceDir, frameCount);
 
-        if (!Compare_With_Reference(screen, mode, Hmode, Vmode, refPath))
+        bool screenshotSame;
+        if (Orchestrator_Reference(frameCount, ".png", &refData, &refSize))
+            screenshotSame = Compare_With_Reference_Data(screen, mode, Hmode, Vmode, refData, refSize);
+        else
+            screenshotSame = Compare_With_Reference(screen, mode, Hmode, Vmode, refPath);
+
+        if (!screenshotSame)
         {
             screenshotDiff = true;
+            if (FirstDiffFrame < 0)
+                FirstDiffFrame = frameCount;
 
             // Save current screenshot
             Save_Shot_To_File(screen, mode, Hmode, Vmode, filename);
@@ -717,11 +779,17 @@ void Automation_OnFrame(int frameCount, void* screen, int mode, int Hmode, int V
             sprintf(refStatePath, "%s\\%06d.genstate", ReferenceDir, frameCount);
 
             // Compare full state and save diff CSV (section, address, expected, actual)
-            int stateDiffs = Compare_Full_State_And_Save_Diff(refStatePath, ScreenshotDir, basename);
+            int stateDiffs;
+            if (Orchestrator_Reference(frameCount, ".genstate", &refData, &refSize))
+                stateDiffs = Compare_Full_State_Data_And_Save_Diff(refData, refSize, ScreenshotDir, basename);
+            else
+                stateDiffs = Compare_Full_State_And_Save_Diff(refStatePath, ScreenshotDir, basename);
 
             if (stateDiffs > 0)
             {
                 memoryDiff = true;
+                if (FirstMemoryDiffFrame < 0)
+                    FirstMemoryDiffFrame = frameCount;
                 MemoryDiffCount++;
 
                 // Save current state dump for full state analysis
@@ -747,6 +815,7 @@ void Automation_OnFrame(int frameCount, void* screen, int mode, int Hmode, int V
             (MaxMemoryDiffs > 0 && MemoryDiffCount >= MaxMemoryDiffs))
         {
             // Exceeded diff limit - early exit
+            ExitReason = "max_diffs";
             PostMessage(HWnd, WM_CLOSE, 0, 0);
         }
     }
@@ -845,6 +914,7 @@ void Trace_OnFrame(int frameCount)
                 fprintf(TraceLogFile, "\n# WARNING: Trace stopped at %d frames limit\n", maxTraceFrames);
             }
             Trace_Close();
+            ExitReason = "trace_end";
             PostMessage(HWnd, WM_CLOSE, 0, 0);
             return;
         }
@@ -876,6 +946,7 @@ void Trace_OnFrame(int frameCount)
         Trace_Close();
         
         // Exit emulator after trace complete
+        ExitReason = "trace_end";
         PostMessage(HWnd, WM_CLOSE, 0, 0);
     }
 }
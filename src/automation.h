@@ -16,6 +16,9 @@ extern char ScreenshotDir[1024];   // Directory to save screenshots
 extern char ReferenceDir[1024];    // Reference screenshots dir (empty = record mode)
 extern unsigned char DiffColor[4]; // BGRA color for diff highlighting (default: pink)
 extern int CompareStateDumpsMode;  // Compare memory dumps instead of screenshots (0 = disabled)
+extern int FirstDiffFrame;         // Frame of the first screenshot difference (-1 = none yet)
+extern int FirstMemoryDiffFrame;   // Frame of the first memory difference (-1 = none yet)
+extern const char* ExitReason;     // Why the run was stopped (max_frames, movie_end, max_diffs, ...), NULL if it wasn't
 
 // Trace automation parameters
 extern unsigned int TraceBreakpointPC;    // PC address to trigger trace (0 = disabled)
@@ -49,9 +52,13 @@ int Save_Shot_To_File(void* screen, int mode, int Hmode, int Vmode, const char*
 // Returns: true if screens match, false if different
 bool Compare_With_Reference(void* screen, int mode, int Hmode, int Vmode, const char* refPath);
 
+// Same with the reference PNG already in memory
+bool Compare_With_Reference_Data(void* screen, int mode, int Hmode, int Vmode, const unsigned char* png, int pngSize);
+
 // Load PNG file into BGRA buffer
 // Returns: true on success, fills buffer and sets width/height
 bool Load_PNG(const char* path, unsigned char* buffer, int bufferSize, int* width, int* height);
+bool Load_PNG_Data(const unsigned char* data, int size, unsigned char* buffer, int bufferSize, int* width, int* height);
 
 // Trace automation functions
 // Called before each instruction to check for breakpoint
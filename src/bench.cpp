@@ -0,0 +1,306 @@
+// Benchmark suite (-bench-out)
+// The replay part saves the state once and then, for each variant, loads it back, rewinds FrameCount
+// and runs the same frames again: the movie input is read at FrameCount, so every variant emulates
+// exactly the same frames. The variants take out the screen rendering (Update_Frame_Fast), the sound
+// (disableSound) and the frame hooks (Lua, plugins, automation, RAM search) one at a time, then all three.
+// Then each line renderer replays the same frames with rendering only, the time per frame it adds to the
+// core variant is what it costs.
+// The micro part calls each hot path a fixed number of times on the state the replay started from and
+// the last rendered screen, and that state is loaded back at the end. Nothing is shown or flipped while timing.
+
+#include <windows.h>
+#include <stdio.h>
+#include <string.h>
+#include "bench.h"
+#include "gens.h"
+#include "G_ddraw.h"
+#include "G_dsound.h"
+#include "vdp_io.h"
+#include "vdp_rend.h"
+#include "Mem_M68k.h"
+#include "save.h"
+#include "movie.h"
+#include "Rom.h"
+#include "ym2612.h"
+#include "psg.h"
+#include "automation.h"
+#include "bintrace.h"
+#include "ram_search.h"
+
+extern "C" int disableSound;
+extern unsigned long FrameCount;
+extern int Update_Frame_Hook();
+extern int Update_Frame_Fast_Hook();
+extern void UpdateInput();
+extern int write_png(void* data, int X, int Y, void* buffer, int size);
+
+static const struct
+{
+	const char *Name;
+	int Render, Sound, Hooks;
+} Variant[] =
+{
+	{"full",		1, 1, 1},
+	{"no_render",	0, 1, 1},
+	{"no_sound",	1, 0, 1},
+	{"no_hooks",	1, 1, 0},
+	{"core",		0, 0, 0},
+};
+#define CORE_VARIANT 4
+
+static const struct
+{
+	const char *Name;
+	int Renderer;
+} Renderer[] =
+{
+	{"asm",		VDP_RENDERER_ASM},
+	{"c",		VDP_RENDERER_C},
+	{"thread",	VDP_RENDERER_THREAD},
+};
+
+ALIGN16 static unsigned char Start_State[MAX_STATE_FILE_LENGTH];
+ALIGN16 static unsigned char Bench_State[MAX_STATE_FILE_LENGTH];
+static unsigned char Shot[320 * 240 * 4];
+static unsigned char Png[320 * 240 * 4 + 4096];
+static int Sound_L[882], Sound_R[882];
+
+static LARGE_INTEGER Freq;
+
+static double Seconds_Since(const LARGE_INTEGER *start)
+{
+	LARGE_INTEGER now;
+
+	QueryPerformanceCounter(&now);
+	return (double)(now.QuadPart - start->QuadPart) / (double)Freq.QuadPart;
+}
+
+static const char *System_Name(void)
+{
+	if(_32X_Started)
+		return "32x";
+	if(SegaCD_Started)
+		return "segacd";
+	return "genesis";
+}
+
+static void Write_String(FILE *f, const char *s)
+{
+	fputc('"', f);
+	for(; *s; s++)
+	{
+		if(*s == '"' || *s == '\\')
+			fprintf(f, "\\%c", *s);
+		else if((unsigned char)*s < 0x20)
+			fprintf(f, "\\u%04x", *s);
+		else
+			fputc(*s, f);
+	}
+	fputc('"', f);
+}
+
+static double Replay(int render, int sound, int hooks, unsigned long start, int frames)
+{
+	LARGE_INTEGER t0;
+	int disable = disableSound;
+	int i;
+
+	Load_State_From_Buffer(Start_State);
+	FrameCount = start;
+	disableSound = disable || !sound;
+
+	QueryPerformanceCounter(&t0);
+	for(i = 0; i < frames; i++)
+	{
+		UpdateInput();
+		FrameCount++;
+		if(hooks)
+		{
+			if(render)
+				Update_Frame_Hook();
+			else
+				Update_Frame_Fast_Hook();
+		}
+		else
+		{
+			if(render)
+				Update_Frame();
+			else
+				Update_Frame_Fast();
+		}
+	}
+	VDP_Render_Sync();
+	double s = Seconds_Since(&t0);
+
+	disableSound = disable;
+	return s;
+}
+
+static int Micro_Rows;
+
+static void Micro_Row(FILE *f, const char *name, int calls, const LARGE_INTEGER *t0)
+{
+	double s = Seconds_Since(t0);
+
+	fprintf(f, "%s\n{\"name\":\"%s\",\"calls\":%d,\"seconds\":%.6f,\"us_per_call\":%.3f}",
+		Micro_Rows++ ? "," : "", name, calls, s, s * 1000000.0 / calls);
+}
+
+static void Micro(FILE *f)
+{
+	LARGE_INTEGER t0;
+	char png_path[MAX_PATH], trace_path[MAX_PATH];
+	void *screen = Bits32 ? (void*)MD_Screen32 : (void*)MD_Screen;
+	int mode = (Bits32 ? 2 : 0) | (Mode_555 ? 1 : 0);
+	int hmode = (VDP_REG_SET4 & 0x1) ? 1 : 0;
+	int vmode = (VDP_REG_SET2 & 0x8) ? 1 : 0;
+	int *sound[2] = {Sound_L, Sound_R};
+	int width, height, i;
+
+	GetTempPathA(MAX_PATH - 32, png_path);
+	strcpy(trace_path, png_path);
+	strcat(png_path, "gens_bench.png");
+	strcat(trace_path, "gens_bench.trc");
+
+	// the reference is the screen itself, so the compare goes through every pixel
+	if(Save_Shot_To_File(screen, mode, hmode, vmode, png_path) && Load_PNG(png_path, Shot, sizeof(Shot), &width, &height))
+	{
+		QueryPerformanceCounter(&t0);
+		for(i = 0; i < 100; i++)
+			Load_PNG(png_path, Shot, sizeof(Shot), &width, &height);
+		Micro_Row(f, "Load_PNG", 100, &t0);
+
+		QueryPerformanceCounter(&t0);
+		for(i = 0; i < 100; i++)
+			write_png(Shot, width, height, Png, sizeof(Png));
+		Micro_Row(f, "write_png", 100, &t0);
+
+		QueryPerformanceCounter(&t0);
+		for(i = 0; i < 100; i++)
+			Compare_With_Reference(screen, mode, hmode, vmode, png_path);
+		Micro_Row(f, "Compare_With_Reference", 100, &t0);
+
+		DeleteFileA(png_path);
+	}
+	else
+	{
+		fprintf(stderr, "bench: can't write %s, PNG benchmarks skipped\n", png_path);
+		DeleteFileA(png_path);
+	}
+
+	// a -bintrace run keeps its own trace
+	if(!BinTraceActive)
+	{
+		BinTrace_Init(trace_path);
+		QueryPerformanceCounter(&t0);
+		for(i = 0; i < 1000000; i++)	// runs of 16 sequential words, the way the 68000 copies
+			BinTrace_MemAccess((i & 0x100) ? EVT_WRITE : EVT_READ, 0x000200 + (i & 0xFE),
+				0xFF0000 + (((i >> 4) * 0x2468 + (i & 15) * 2) & 0xFFFE), i & 0xFFFF, 2);
+		BinTrace_Close();
+		Micro_Row(f, "BinTrace_MemAccess", 1000000, &t0);
+		DeleteFileA(trace_path);
+	}
+
+	// every RAM byte goes through UpdateRegionT each call, with a few changes like a frame would have
+	ResetMemoryRegions();
+	signal_new_frame();
+	QueryPerformanceCounter(&t0);
+	for(i = 0; i < 1000; i++)
+	{
+		Ram_68k[(i * 0x1F3) & 0xFFFF]++;
+		signal_new_frame();
+	}
+	Micro_Row(f, "UpdateRegionT", 1000, &t0);
+	reset_address_info();
+
+	// one frame of sound per call
+	QueryPerformanceCounter(&t0);
+	for(i = 0; i < 1000; i++)
+		YM2612_Update(sound, Seg_Length);
+	Micro_Row(f, "YM2612_Update", 1000, &t0);
+
+	QueryPerformanceCounter(&t0);
+	for(i = 0; i < 1000; i++)
+		PSG_Update(sound, Seg_Length);
+	Micro_Row(f, "PSG_Update", 1000, &t0);
+
+	QueryPerformanceCounter(&t0);
+	for(i = 0; i < 200; i++)
+		Save_State_To_Buffer(Bench_State);
+	Micro_Row(f, "Save_State_To_Buffer", 200, &t0);
+}
+
+int Bench_Run(const char *path, int frames)
+{
+	FILE *f;
+	unsigned long start = FrameCount;
+	double s, core = 0;
+	int renderer = VDP_Renderer;
+	int v;
+
+	if(!Game)
+	{
+		fprintf(stderr, "bench: no game loaded\n");
+		return 0;
+	}
+	f = fopen(path, "w");
+	if(!f)
+	{
+		fprintf(stderr, "bench: can't create %s\n", path);
+		return 0;
+	}
+	QueryPerformanceFrequency(&Freq);
+
+	if(frames <= 0)
+		frames = 600;
+	// stop before the end of the movie, where playback would close it or ask to record
+	if(MainMovie.Status == MOVIE_PLAYING && start + frames >= MainMovie.LastFrame)
+	{
+		frames = MainMovie.LastFrame > start + 1 ? MainMovie.LastFrame - start - 1 : 0;
+		fprintf(stderr, "bench: the movie ends after %d frames\n", frames);
+	}
+
+	Save_State_To_Buffer(Start_State);
+	Clear_Sound_Buffer();
+
+	fprintf(f, "{\"game\":");
+	Write_String(f, Game->Rom_Name_W);
+	fprintf(f, ",\"movie\":");
+	Write_String(f, MainMovie.Status == MOVIE_PLAYING ? MainMovie.FileName : "");
+	fprintf(f, ",\"system\":\"%s\",\"start_frame\":%lu,\"frames\":%d,\"replay\":[", System_Name(), start, frames);
+
+	for(v = 0; v < (int)(sizeof(Variant) / sizeof(Variant[0])) && frames; v++)
+	{
+		s = Replay(Variant[v].Render, Variant[v].Sound, Variant[v].Hooks, start, frames);
+		if(v == CORE_VARIANT)
+			core = s;
+		fprintf(f, "%s\n{\"variant\":\"%s\",\"render\":%d,\"sound\":%d,\"hooks\":%d,\"seconds\":%.6f,\"fps\":%.1f}",
+			v ? "," : "", Variant[v].Name, Variant[v].Render, Variant[v].Sound, Variant[v].Hooks, s, s > 0 ? frames / s : 0.0);
+	}
+
+	// 32X lines are always drawn by the asm, so this compares the Genesis layers only
+	fprintf(f, "\n],\"renderers\":[");
+	for(v = 0; v < (int)(sizeof(Renderer) / sizeof(Renderer[0])) && frames; v++)
+	{
+		VDP_Renderer = Renderer[v].Renderer;
+		s = Replay(1, 0, 0, start, frames);
+		fprintf(f, "%s\n{\"renderer\":\"%s\",\"seconds\":%.6f,\"fps\":%.1f,\"render_ms_per_frame\":%.4f}",
+			v ? "," : "", Renderer[v].Name, s, s > 0 ? frames / s : 0.0, (s - core) * 1000.0 / frames);
+	}
+	VDP_Renderer = renderer;
+	if(renderer != VDP_RENDERER_THREAD)
+		VDP_Render_Stop();		// don't leave it spinning during the micro benchmarks
+
+	fprintf(f, "\n],\"micro\":[");
+	Load_State_From_Buffer(Start_State);
+	FrameCount = start;
+	Micro_Rows = 0;
+	Micro(f);
+	fprintf(f, "\n]}\n");
+	fclose(f);
+
+	Load_State_From_Buffer(Start_State);
+	FrameCount = start;
+	Clear_Sound_Buffer();
+	return 1;
+}
@@ -0,0 +1,10 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+// Benchmark suite (bench.cpp)
+// Replays the loaded game (and movie) for Frames frames once per variant, from the same state each time,
+// then times the hot paths on fixed inputs, and writes the results as JSON to path.
+// Returns 0 if nothing was run (no game loaded, can't create path).
+int Bench_Run(const char *path, int frames);
+
+#endif
@@ -1,4 +1,6 @@
 #include <stdio.h>
+#include <stdlib.h>
+#include <io.h>
 #include <windows.h>
 #include "cd_sys.h"
 #include "cd_file.h"
@@ -93,6 +95,107 @@ void MakeFilename(char* filenameWithPath, int bufferSize, const char* otherFileI
 }
 
 
+// Sectors of ISO/BIN tracks are read through FILE_Read_Track instead of fseek + fread on every sector:
+// the image is mapped in memory (its pages are shared with other instances using the same image),
+// and if that fails (not enough address space for a large BIN) it is read CD_READ_AHEAD bytes at a time.
+#define CD_READ_AHEAD (64 * 2352)
+
+// first track reading from the same file as track index
+static int Track_File_Owner(int index)
+{
+	int i;
+
+	for(i = 0; i < index; i++)
+		if(Tracks[i].F == Tracks[index].F)
+			return i;
+	return index;
+}
+
+static void Map_Track(struct _file_track *t)
+{
+	HANDLE file = (HANDLE) _get_osfhandle(_fileno(t->F));
+	DWORD size = GetFileSize(file, NULL);
+
+	t->Map_Size = 0;
+	if(size == INVALID_FILE_SIZE || size == 0 || size > 0x7FFFFFFF)
+		return;
+
+	t->Map_Handle = CreateFileMapping(file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if(t->Map_Handle == NULL)
+		return;
+
+	t->Map = (const unsigned char *) MapViewOfFile(t->Map_Handle, FILE_MAP_READ, 0, 0, 0);
+	if(t->Map == NULL)
+	{
+		CloseHandle(t->Map_Handle);
+		t->Map_Handle = NULL;
+		return;
+	}
+	t->Map_Size = size;
+}
+
+static void Unmap_Track(struct _file_track *t)
+{
+	if(t->Map) UnmapViewOfFile(t->Map);
+	if(t->Map_Handle) CloseHandle(t->Map_Handle);
+	if(t->Cache) free(t->Cache);
+	t->Map = NULL;
+	t->Map_Handle = NULL;
+	t->Map_Size = 0;
+	t->Cache = NULL;
+	t->Cache_Pos = 0;
+	t->Cache_Len = 0;
+}
+
+// Copy size bytes at offset pos of the file of track index to dest, returns the number of bytes
+// copied (less than size past the end of the file, like fread)
+int FILE_Read_Track(int index, int pos, void *dest, int size)
+{
+	struct _file_track *t;
+	int len;
+
+	if(Tracks[index].F == NULL || pos < 0 || size <= 0) return 0;
+
+	t = &Tracks[Track_File_Owner(index)];
+
+	if(t->Map == NULL && t->Cache == NULL)
+	{
+		Map_Track(t);
+		if(t->Map == NULL && (t->Cache = (unsigned char *) malloc(CD_READ_AHEAD)) == NULL)
+		{
+			fseek(t->F, pos, SEEK_SET);
+			return fread(dest, 1, size, t->F);
+		}
+	}
+
+	if(t->Map)
+	{
+		if(pos >= t->Map_Size) return 0;
+		len = t->Map_Size - pos < size ? t->Map_Size - pos : size;
+		memcpy(dest, t->Map + pos, len);
+		return len;
+	}
+
+	if(size > CD_READ_AHEAD)
+	{
+		fseek(t->F, pos, SEEK_SET);
+		return fread(dest, 1, size, t->F);
+	}
+
+	if(pos < t->Cache_Pos || pos + size > t->Cache_Pos + t->Cache_Len)
+	{
+		fseek(t->F, pos, SEEK_SET);
+		t->Cache_Pos = pos;
+		t->Cache_Len = fread(t->Cache, 1, CD_READ_AHEAD, t->F);
+	}
+
+	len = t->Cache_Pos + t->Cache_Len - pos;
+	if(len > size) len = size;
+	if(len <= 0) return 0;
+	memcpy(dest, t->Cache + (pos - t->Cache_Pos), len);
+	return len;
+}
+
 int Load_ISO(char *buf, char *iso_name)
 {
 	HANDLE File_Size;
@@ -120,8 +223,8 @@ int Load_ISO(char *buf, char *iso_name)
 	else Tracks[0].Length /= 2352;								// size in sectors
 	CloseHandle(File_Size);
 
+	Unmap_Track(&Tracks[0]);
 	Tracks[0].F = fopen(iso_name, "rb");
-	Tracks[0].F_decoded = NULL;
 
 	if (Tracks[0].F == NULL)
 	{
@@ -210,7 +313,6 @@ int Load_ISO(char *buf, char *iso_name)
 									Tracks[i].F = tmp_file;
 								else
 									Tracks[i].F = Tracks[0].F;
-								Tracks[i].F_decoded = NULL;
 
 								strncpy(Tracks[i].filename, g_cuefile_TOC_filenames[i], 512);
 								Tracks[i].filename[511] = 0;
@@ -276,7 +378,6 @@ int Load_ISO(char *buf, char *iso_name)
 								Tracks[i].Type = TYPE_ISO;
 								Tracks[i].Length = 0;
 								Tracks[i].F = NULL;
-								Tracks[i].F_decoded = NULL;
 								if(g_cuefile_TOC_filetype[i] == TYPE_WAV)
 								{
 									if(tmp_file)
@@ -338,7 +439,6 @@ int Load_ISO(char *buf, char *iso_name)
 						CloseHandle(File_Size);
 
 						Tracks[num_track - SCD.TOC.First_Track].F = tmp_file; 
-						Tracks[num_track - SCD.TOC.First_Track].F_decoded = NULL;
 
 						strncpy(Tracks[num_track - SCD.TOC.First_Track].filename, tmp_name, 512);
 						Tracks[num_track - SCD.TOC.First_Track].filename[511] = 0;
@@ -495,11 +595,9 @@ void Unload_ISO(void)
 	{
 		for(i = 0; i < 100; i++)
 		{
+			Unmap_Track(&Tracks[i]);
 			if (Tracks[i].F) fclose(Tracks[i].F);
-			if (Tracks[i].F_decoded)
-				fclose(Tracks[i].F_decoded);
 			Tracks[i].F = NULL;
-			Tracks[i].F_decoded = NULL;
 			Tracks[i].Length = 0;
 			Tracks[i].Type = 0;
 			Tracks[i].filename[0] = 0;
@@ -790,8 +888,7 @@ int FILE_Read_One_LBA_CDC(void)
 		//       but I don't know what the condition is supposed to be (maybe !(CDC.CTRL.B.B1 & 0x20))
 		//memset(cp_buf, 0, 2048);
 
-		fseek(Tracks[0].F, where_read, SEEK_SET);
-		fread(cp_buf, 1, 2048, Tracks[0].F);
+		FILE_Read_Track(0, where_read, cp_buf, 2048);
 
 #ifdef DEBUG_CD
 		fprintf(debug_SCD_file, "\n\nRead file CDC 1 data sector :\n");
@@ -811,25 +908,15 @@ int FILE_Read_One_LBA_CDC(void)
 			int forceNoDecode = 0;
 #endif
 
-			int fileNeedsClose = 0;
-			FILE* decodedFile = GetMP3TrackFile(index, &fileNeedsClose, &where_read);
+			// copy audio data to buffer
+			int outRead = MP3_Read_Track(index, cp_buf, 588*4);
 
-			if(decodedFile || forceNoDecode)
+			if(outRead >= 0 || forceNoDecode)
 			{
-				// copy audio data to buffer
-				int outRead = 0;
-				if(decodedFile)
-				{
-					fseek(decodedFile, where_read, SEEK_SET);
-					outRead = fread(cp_buf, 1, 588*4, decodedFile);
-				}
 				if(outRead < 588*4)
 					memset(cp_buf, 0, 588*4); // failed to read, use silence
 
 				Write_CD_Audio((short *) cp_buf, 44100, 2, 588);
-
-				if(fileNeedsClose)
-					fclose(decodedFile);
 			}
 			else // stream it
 			{
@@ -867,8 +954,7 @@ int FILE_Read_One_LBA_CDC(void)
 				if(where_read < 0) where_read = 0;
 
 				// copy audio data to buffer
-				fseek(Tracks[index].F, where_read, SEEK_SET);
-				fread(cp_buf, 1, 588*4, Tracks[index].F);
+				FILE_Read_Track(index, where_read, cp_buf, 588*4);
 				Write_CD_Audio((short *) cp_buf, 44100, 2, 588);
 			}
 		}
@@ -13,10 +13,18 @@ extern "C" {
 
 struct _file_track {
 	FILE *F;
-	FILE *F_decoded;
 	int Length;
 	int Type;
 	char filename [512];
+
+	// FILE_Read_Track: the whole file mapped in memory, or if it can't be, a block read ahead from it.
+	// Only set on the first track using F when several tracks share a file.
+	const unsigned char *Map;
+	int Map_Size;
+	void *Map_Handle;
+	unsigned char *Cache;
+	int Cache_Pos;
+	int Cache_Len;
 };
 
 extern struct _file_track Tracks[100];
@@ -33,6 +41,7 @@ int Load_CUE(char *buf, char *cue_name);
 void Get_CUE_ISO_Filename(char *fnamebuf, int fnamebuf_size, char *cue_name);
 //int FILE_Read_One_CD_LBA(int lba);
 int FILE_Read_One_LBA_CDC(void);
+int FILE_Read_Track(int index, int pos, void *dest, int size);
 int FILE_Play_CD_LBA(int async);
 
 
@@ -11,6 +11,7 @@
 #include "Mem_S68K.h"
 #include "save.h"
 #include "misc.h"
+#include "startup_prof.h"
 
 int File_Add_Delay = 0;
 
@@ -245,9 +246,9 @@ int Init_CD_Driver(void)
 	debug_SCD_file = fopen("SCD.log", "w");
 #endif
 
-	// ASPI support
+	// ASPI support (not for -batch runs, they only play images)
 	
-	ASPI_Init();
+	if (!Batch_Startup) ASPI_Init();
 
 //	if (ASPI_Init() == 0)
 //	{
@@ -36,8 +36,6 @@ extern void Put_Info(char *Message, int Duration);
 extern void Put_Info_NonImmediate(char *Message, int Duration);
 extern char Gens_Path[1024];
 extern char played_tracks_linear [105];
-#define PRELOADED_MP3_DIRECTORY "temp"
-#define PRELOADED_MP3_FILENAME "\\track%02d.pcm"
 
 int MP3_Init(void)
 {
@@ -182,6 +180,8 @@ int MP3_Find_Frame(FILE *f, int pos_wanted)
 }
 
 
+int Decode_MP3(char *buf_in, int size);
+
 int MP3_Update_IN(void)
 {
 	char buf_in[8 * 1024];
@@ -229,13 +229,13 @@ int MP3_Update_IN(void)
 	if(fatal_mp3_error)
 		return 1;
 
-	if (decodeMP3(&mp, buf_in, size_read, buf_out, 8 * 1024, (int*)&Current_OUT_Size) != MP3_OK)
+	if (Decode_MP3(buf_in, size_read) != MP3_OK)
 	{
 		fseek(Tracks[Track_Played].F, Current_IN_Pos, SEEK_SET);
 		size_read = fread(buf_in, 1, 8 * 1024, Tracks[Track_Played].F);
 		Current_IN_Pos += size_read;
 
-		if (decodeMP3(&mp, buf_in, size_read, buf_out, 8 * 1024, (int*)&Current_OUT_Size) != MP3_OK)
+		if (Decode_MP3(buf_in, size_read) != MP3_OK)
 		{
 			fatal_mp3_error = 1;
 			return 1;
@@ -253,28 +253,248 @@ int MP3_Update_OUT(void)
 	if(fatal_mp3_error)
 		return 1;
 
-	if(decodeMP3(&mp, NULL, 0, buf_out, 8 * 1024, (int*)&Current_OUT_Size) != MP3_OK)
+	if(Decode_MP3(NULL, 0) != MP3_OK)
 		return MP3_Update_IN();
 
 	return 0;
 }
 
-void Delete_Preloaded_MP3(int track)
+// Decoded MP3 tracks
+// Each MP3 track is decoded once to 44.1 kHz 16 bit stereo PCM and kept in memory, in blocks that never
+// move, so the emulation can read the start of a track while the rest of it is still being decoded.
+// A decoded track is also saved in a cache on disk (Gens_Path\mp3cache) named by a hash of the MP3 file,
+// so the next run, or another instance playing the same game, loads it instead of decoding it again.
+// Load_ISO queues every MP3 track of the CD, the ones the movie plays first. The memory used by complete
+// tracks is kept under MP3_CACHE_MAX by dropping the ones read least recently; they come back from the
+// disk cache if they are played again.
+// mpglib keeps its decoding state in globals (gmp, wordpointer, bitindex), so decodeMP3 can't run on
+// several threads at once: the tracks are decoded one after the other by one thread, and every
+// decodeMP3 call is made with decoderCriticalSection held.
+
+#define MP3_CACHE_DIRECTORY "mp3cache"
+#define MP3_CACHE_MAX (256 * 1024 * 1024)
+#define MP3_BLOCK_SIZE (1024 * 1024)
+#define MP3_MAX_BLOCKS 1024		// 1 GB, about 100 minutes
+
+}
+
+#ifdef _WIN32
+
+class CriticalSection
+{
+	CRITICAL_SECTION m_cs;
+public:
+	CriticalSection() {
+		::InitializeCriticalSection(&m_cs);
+	}
+	~CriticalSection() {
+		::DeleteCriticalSection(&m_cs);
+	}
+	void Lock() {
+		::EnterCriticalSection(&m_cs);
+	}
+	void Unlock() {
+		::LeaveCriticalSection(&m_cs);
+	}
+};
+
+#else // single threaded
+
+class CriticalSection
 {
-	char str [128];
-	SetCurrentDirectory(Gens_Path);
-	_mkdir(PRELOADED_MP3_DIRECTORY);
-	sprintf(str, PRELOADED_MP3_DIRECTORY PRELOADED_MP3_FILENAME, track+1);
-	_unlink(str);
+public:
+	void Lock() {}
+	void Unlock() {}
+};
+
+#endif
+
+class AutoCriticalSection
+{
+	CriticalSection* m_pCS;
+public:
+	AutoCriticalSection(CriticalSection& pCS) : m_pCS(&pCS) {
+		m_pCS->Lock();
+	}
+	~AutoCriticalSection() {
+		m_pCS->Unlock();
+	}
+};
+
+extern "C" {
+
+CriticalSection decoderCriticalSection;	// decodeMP3
+CriticalSection decodedCriticalSection;	// allocating and freeing Decoded
+
+struct MP3_Decoded
+{
+	char *Block[MP3_MAX_BLOCKS];
+	volatile int Size;		// bytes decoded so far
+	volatile int Done;		// the whole track is there
+	DWORD Last_Read;
+};
+static MP3_Decoded *Decoded[100];
+
+static int Decoded_Complete(int track)
+{
+	return Decoded[track] && Decoded[track]->Done;
+}
+
+// Free track, decodedCriticalSection held
+static void Free_Decoded(int track)
+{
+	MP3_Decoded *d = Decoded[track];
+	int i;
+
+	if(!d)
+		return;
+	for(i = 0; i < MP3_MAX_BLOCKS && d->Block[i]; i++)
+		free(d->Block[i]);
+	delete d;
+	Decoded[track] = NULL;
+}
+
+// Drop the complete tracks read least recently until they use at most MP3_CACHE_MAX
+static void Trim_Decoded(int keep)
+{
+	AutoCriticalSection lock (decodedCriticalSection);
+
+	for(;;)
+	{
+		unsigned int total = 0;
+		int track, oldest = -1;
+
+		for(track = 0; track < 100; track++)
+		{
+			if(!Decoded_Complete(track))
+				continue;
+			total += Decoded[track]->Size;
+			if(track != keep && track != Track_Played
+			&& (oldest < 0 || Decoded[track]->Last_Read < Decoded[oldest]->Last_Read))
+				oldest = track;
+		}
+		if(total <= MP3_CACHE_MAX || oldest < 0)
+			return;
+		Free_Decoded(oldest);
+	}
+}
+
+// Only called by the thread decoding the track
+static int Append_Decoded(MP3_Decoded *d, const char *data, int size)
+{
+	while(size > 0)
+	{
+		int block = d->Size / MP3_BLOCK_SIZE, offset = d->Size % MP3_BLOCK_SIZE;
+		int len = MP3_BLOCK_SIZE - offset < size ? MP3_BLOCK_SIZE - offset : size;
+
+		if(block >= MP3_MAX_BLOCKS)
+			return 0;
+		if(!d->Block[block] && !(d->Block[block] = (char *) malloc(MP3_BLOCK_SIZE)))
+			return 0;
+		memcpy(d->Block[block] + offset, data, len);
+		MemoryBarrier();
+		d->Size += len;		// readers only look at what's before Size
+		data += len;
+		size -= len;
+	}
+	return 1;
+}
+
+// Copy size bytes at pos of the decoded track to dest. Returns the number of bytes copied
+// (less than size at the end of the track), -2 if they aren't decoded yet, -1 if the track isn't there
+static int Read_Decoded(int track, int pos, char *dest, int size)
+{
+	AutoCriticalSection lock (decodedCriticalSection);
+	MP3_Decoded *d = Decoded[track];
+	int copied = 0;
+
+	if(!d)
+		return -1;
+	if(d->Size < pos + size && !d->Done)
+		return -2;
+
+	while(copied < size && pos < d->Size)
+	{
+		int offset = pos % MP3_BLOCK_SIZE;
+		int len = MP3_BLOCK_SIZE - offset;
+		if(len > size - copied) len = size - copied;
+		if(len > d->Size - pos) len = d->Size - pos;
+		memcpy(dest + copied, d->Block[pos / MP3_BLOCK_SIZE] + offset, len);
+		copied += len;
+		pos += len;
+	}
+	d->Last_Read = timeGetTime();
+	return copied;
 }
 
 void Delete_Preloaded_MP3s(void)
 {
+	AutoCriticalSection lock (decodedCriticalSection);
 	int i;
+
 	for(i = 0; i < 100; i++)
-		Delete_Preloaded_MP3(i);
+		Free_Decoded(i);
+}
+
+// Name of the disk cache file of an MP3 file: FNV-1a of its contents
+static int MP3_Cache_Filename(char *str, const char *mp3_name)
+{
+	unsigned long long hash = 14695981039346656037ULL;
+	unsigned char buf[64 * 1024];
+	int size, i;
+	FILE *f = fopen(mp3_name, "rb");
+
+	if(!f)
+		return 0;
+	while((size = fread(buf, 1, sizeof(buf), f)) > 0)
+		for(i = 0; i < size; i++)
+			hash = (hash ^ buf[i]) * 1099511628211ULL;
+	fclose(f);
+
+	sprintf(str, "%s\\" MP3_CACHE_DIRECTORY "\\%08X%08X.pcm", Gens_Path, (unsigned int) (hash >> 32), (unsigned int) hash);
+	return 1;
+}
+
+static void Save_MP3_Cache(MP3_Decoded *d, const char *cache_name)
+{
+	char tmp_name[1100];
+	FILE *f;
+	int pos, ok = 1;
+
+	sprintf(tmp_name, "%s.%u.tmp", cache_name, (unsigned int) GetCurrentProcessId());
+	if(!(f = fopen(tmp_name, "wb")))
+		return;
+	for(pos = 0; pos < d->Size && ok; pos += MP3_BLOCK_SIZE)
+	{
+		int len = d->Size - pos < MP3_BLOCK_SIZE ? d->Size - pos : MP3_BLOCK_SIZE;
+		ok = fwrite(d->Block[pos / MP3_BLOCK_SIZE], 1, len, f) == (size_t) len;
+	}
+	if(fclose(f) || !ok)
+	{
+		DeleteFile(tmp_name);
+		return;
+	}
+
+	// another instance may have saved the same track in the meantime, theirs is the same
+	if(!MoveFile(tmp_name, cache_name))
+		DeleteFile(tmp_name);
+}
+
+static int Load_MP3_Cache(MP3_Decoded *d, const char *cache_name)
+{
+	static char buf[MP3_BLOCK_SIZE];
+	FILE *f = fopen(cache_name, "rb");
+	int size;
 
-	_rmdir(PRELOADED_MP3_DIRECTORY); // this will only delete the directory if it's empty, which is good. but it won't delete the directory if Windows Explorer has acquired and leaked the directory handle as it loves to do, which is bad. oh well.
+	if(!f)
+		return 0;
+	while((size = fread(buf, 1, MP3_BLOCK_SIZE, f)) > 0)
+	{
+		if(!Append_Decoded(d, buf, size))
+			break;
+	}
+	fclose(f);
+	return d->Size > 0;
 }
 
 int noTracksQueued = 1;
@@ -282,105 +502,119 @@ int noTracksQueued = 1;
 bool Preload_MP3_Synchronous_Cancel;
 int Preload_MP3_Synchronous_Cancel_Exception = -1;
 bool Waiting_For_Preload_MP3_Synchronous = false;
-void Preload_MP3_Synchronous(FILE** filePtr, int track)
-{
-	if(filePtr && track >= 0 && track < 100)
-	{
-		if(!*filePtr && Tracks[track].Type == TYPE_MP3)
-		{
-			char str [1024], msg [256];
-			int prevTrack = Track_Played;
-			FILE* file = NULL;
 
-			SetCurrentDirectory(Gens_Path);
-			_mkdir(PRELOADED_MP3_DIRECTORY);
+#define PRELOAD_CANCELLED (Preload_MP3_Synchronous_Cancel && track != Preload_MP3_Synchronous_Cancel_Exception)
 
-			sprintf(str, PRELOADED_MP3_DIRECTORY PRELOADED_MP3_FILENAME, track+1);
+void Preload_MP3_Synchronous(int track)
+{
+	if(track >= 0 && track < 100 && !Decoded[track] && Tracks[track].Type == TYPE_MP3)
+	{
+		char cache_name [1100], msg [256];
+		int cached;
+		MP3_Decoded *d;
+		FILE* in;
 
 #ifdef _WIN32
-			sprintf(msg, "Loading track %02d MP3", track+1);
-			Put_Info_NonImmediate(msg, 100);
+		sprintf(msg, "Loading track %02d MP3", track+1);
+		Put_Info_NonImmediate(msg, 100);
 #else
-			sprintf(msg, "Preloading track %02d MP3", track+1);
-			Put_Info(msg, 100);
+		sprintf(msg, "Preloading track %02d MP3", track+1);
+		Put_Info(msg, 100);
 #endif
 
-			if(Preload_MP3_Synchronous_Cancel)
-				return;
+		if(Preload_MP3_Synchronous_Cancel)
+			return;
 
-			//Tracks[track].F_decoded = fopen(str, "wb+");
-			if(preloaded_tracks[track] == 3)
-				file = fopen(str, "r+b");
-			else
-				file = fopen(str, "w+b");
+		preloaded_tracks[track] = 3;
 
-			if(Preload_MP3_Synchronous_Cancel && track != Preload_MP3_Synchronous_Cancel_Exception)
-			{
-				if(file)
-					fclose(file);
-				return;
-			}
+		// the decoder reads its own handle, Tracks[track].F is used by MP3_Update_IN
+		if(!(in = fopen(Tracks[track].filename, "rb")))
+		{
+			preloaded_tracks[track] = 0;
+			return;
+		}
 
-			preloaded_tracks[track] = 3;
+		d = new MP3_Decoded;
+		memset(d, 0, sizeof(*d));
+		{
+			AutoCriticalSection lock (decodedCriticalSection);
+			Decoded[track] = d;
+		}
 
-			if(file)
+		cached = MP3_Cache_Filename(cache_name, Tracks[track].filename);
+		if(cached && Load_MP3_Cache(d, cache_name))
+		{
+			d->Done = 1;
+		}
+		else
+		{
+			// decode the whole track
+
+			static const int inSize = 588*4, outSize = 8192;
+			char temp_in_buf[inSize], temp_out_buf[outSize];
+			int inRead = 0, outRead = 0;
+			int ok = MP3_OK, failed = 0;
+			mpstr temp_mp;
+			InitMP3(&temp_mp);
+			int inStartPos = MP3_Find_Frame(in, 0);
+			fseek(in, inStartPos, SEEK_SET);
+			int iter = 0;
+
+			while(ok == MP3_OK && !PRELOAD_CANCELLED)
 			{
-				// decode mp3 to the temporary file
-
-				static const int inSize = 588*4, outSize = 8192;
-				char temp_in_buf[inSize], temp_out_buf[outSize];
-				int inRead = 0, outRead = 0;
-				int ok = MP3_OK;
-				mpstr temp_mp;
-				InitMP3(&temp_mp);
-				int inStartPos = MP3_Find_Frame(Tracks[track].F, 0);
-				fseek(file, 0, SEEK_END);
-				int outStartPos = ftell(file);
-				int outPos = 0;
-				fseek(Tracks[track].F, inStartPos, SEEK_SET);
-				int iter = 0;
-
-				while(ok == MP3_OK && !(Preload_MP3_Synchronous_Cancel && track != Preload_MP3_Synchronous_Cancel_Exception))
+				inRead = fread(temp_in_buf, 1, inSize, in);
 				{
-					inRead = fread(temp_in_buf, 1, inSize, Tracks[track].F);
+					AutoCriticalSection lock (decoderCriticalSection);
 					ok = decodeMP3(&temp_mp, temp_in_buf, inRead, temp_out_buf, outSize, (int*)&outRead);
-					if(outPos >= outStartPos)
-						fwrite(temp_out_buf, outRead, 1, file);
-					outPos += outRead;
+				}
+				// outRead is left from the previous frame when decodeMP3 fails at the end, the
+				// decoded tracks have always had that frame twice
+				if(!Append_Decoded(d, temp_out_buf, outRead))
+				{
+					failed = 1;
+					break;
+				}
 
-					++iter;
+				++iter;
 
 #ifdef _WIN32
-					// even with "lowest priority" set on this thread, on win32,
-					// it still prevents other threads from doing processing for long enough
-					// to cause stuttering problems, even with multiple CPU cores present,
-					// so voluntarily give up control of the thread by sleeping every few decoding iterations
-					if(!Waiting_For_Preload_MP3_Synchronous)
-						if(iter % 16 == 0)
-							Sleep(10);
-						else
-							Sleep(0);
+				// even with "lowest priority" set on this thread, on win32,
+				// it still prevents other threads from doing processing for long enough
+				// to cause stuttering problems, even with multiple CPU cores present,
+				// so voluntarily give up control of the thread by sleeping every few decoding iterations
+				if(!Waiting_For_Preload_MP3_Synchronous)
+					if(iter % 16 == 0)
+						Sleep(10);
+					else
+						Sleep(0);
 #endif
-				}
+			}
+			ExitMP3(&temp_mp);
 
-				if((Preload_MP3_Synchronous_Cancel && track != Preload_MP3_Synchronous_Cancel_Exception)
-				|| ferror(file)) // if we got some error (out of disk space?) give up on pre-loading the MP3
-				{
-					fclose(file);
-					file = NULL;
-				}
+			if(PRELOAD_CANCELLED || failed) // cancelled, or out of memory
+			{
+				AutoCriticalSection lock (decodedCriticalSection);
+				Free_Decoded(track);
+				d = NULL;
 			}
 			else
 			{
-				// couldn't open, maybe another instance of Gens has it open? if so use that
-				file = fopen(str, "rb");
+				d->Done = 1;
+				if(cached)
+				{
+					SetCurrentDirectory(Gens_Path);
+					_mkdir(MP3_CACHE_DIRECTORY);
+					Save_MP3_Cache(d, cache_name);
+				}
 			}
-
-			*filePtr = file;
 		}
+		fclose(in);
+
+		if(d)
+			Trim_Decoded(track);
 	}
-	if(!(Preload_MP3_Synchronous_Cancel && track != Preload_MP3_Synchronous_Cancel_Exception))
-		preloaded_tracks[track] = (filePtr && *filePtr) ? 1 : 0;
+	if(!PRELOAD_CANCELLED)
+		preloaded_tracks[track] = Decoded_Complete(track) ? 1 : 0;
 }
 
 
@@ -392,43 +626,12 @@ void Preload_MP3_Synchronous(FILE** filePtr, int track)
 #include <algorithm>
 extern "C" {
 
-class CriticalSection
-{
-	CRITICAL_SECTION m_cs;
-public:
-	CriticalSection() {
-		::InitializeCriticalSection(&m_cs);
-	}
-	~CriticalSection() {
-		::DeleteCriticalSection(&m_cs);
-	}
-	void Lock() {
-		::EnterCriticalSection(&m_cs);
-	}
-	void Unlock() {
-		::LeaveCriticalSection(&m_cs);
-	}
-};
-
-class AutoCriticalSection
-{
-	CriticalSection* m_pCS;
-public:
-	AutoCriticalSection(CriticalSection& pCS) : m_pCS(&pCS) {
-		m_pCS->Lock();
-	}
-	~AutoCriticalSection() {
-		m_pCS->Unlock();
-	}
-};
-
 CriticalSection preloadingCriticalSection;
 #define ENTER_CRIT_SECT do{ AutoCriticalSection acs (preloadingCriticalSection);
 #define EXIT_CRIT_SECT } while(0);
 
 struct PreloadMP3ThreadArg
 {
-	FILE** filePtr;
 	int track;
 	int sortPriority;
 
@@ -455,7 +658,7 @@ DWORD Preload_MP3_Thread(LPVOID lpThreadParameter)
 		preloadMP3ThreadArgs.pop_back();
 		EXIT_CRIT_SECT
 
-		Preload_MP3_Synchronous(curThreadArgs.filePtr, curThreadArgs.track);
+		Preload_MP3_Synchronous(curThreadArgs.track);
 
 		ENTER_CRIT_SECT
 		if(Preload_MP3_Synchronous_Cancel)
@@ -466,15 +669,14 @@ DWORD Preload_MP3_Thread(LPVOID lpThreadParameter)
 				preloadMP3ThreadArgs.insert(preloadMP3ThreadArgs.end()-1, curThreadArgs);
 			Preload_MP3_Synchronous_Cancel = false;
 		}
-		curThreadArgs.filePtr = NULL;
 		curThreadArgs.track = -1;
 		EXIT_CRIT_SECT
 	}
 }
 
-void Preload_MP3(FILE** filePtr, int track)
+void Preload_MP3(int track)
 {
-	if(!filePtr || *filePtr || Tracks[track].Type != TYPE_MP3)
+	if(Decoded[track] || Tracks[track].Type != TYPE_MP3)
 		return;
 
 	ENTER_CRIT_SECT
@@ -487,7 +689,7 @@ void Preload_MP3(FILE** filePtr, int track)
 	}
 	if(preloadMP3ThreadArgs.empty() || track != preloadMP3ThreadArgs.back().track)
 	{
-		PreloadMP3ThreadArg args = {filePtr, track};
+		PreloadMP3ThreadArg args = {track};
 		preloadMP3ThreadArgs.push_back(args);
 	}
 	noTracksQueued = 0;
@@ -501,42 +703,63 @@ void Preload_MP3(FILE** filePtr, int track)
 	}
 }
 
-void Preload_Used_MP3s(void)
+// Queue all the MP3 tracks, without cancelling the one being decoded
+static void Queue_MP3(int track, int sortPriority)
 {
-	int track;
-	for(track = 0; track < 100; track++)
-		if(preloaded_tracks[track] > 1)
-			Preload_MP3(&Tracks[track].F_decoded, track);
+	if(Decoded[track] || Tracks[track].Type != TYPE_MP3)
+		return;
 
 	ENTER_CRIT_SECT
+	if(track == curThreadArgs.track)
+		return;
+	for(unsigned int i = 0; i < preloadMP3ThreadArgs.size(); i++)
+		if(preloadMP3ThreadArgs[i].track == track)
+			return;
+	PreloadMP3ThreadArg args = {track, sortPriority};
+	preloadMP3ThreadArgs.push_back(args);
+	noTracksQueued = 0;
+	EXIT_CRIT_SECT
+}
+
+void Preload_Used_MP3s(void)
+{
+	int track;
 
-	// sort so that the smallest MP3 files load first
+	// the tracks the movie plays first, then the smallest MP3 files first
 
-	for(unsigned int i = 0; i < preloadMP3ThreadArgs.size(); i++)
+	for(track = 0; track < 100; track++)
 	{
-		const char* filename = Tracks[preloadMP3ThreadArgs[i].track].filename;
+		const char* filename = Tracks[track].filename;
+		int sortPriority = 0;
 		FILE* file;
 		if(filename && filename[0] && (file = fopen(filename, "rb")))
 		{
 			fseek(file, 0, SEEK_END);
-			preloadMP3ThreadArgs[i].sortPriority = ftell(file);
+			sortPriority = ftell(file);
 			fclose(file);
 		}
-		else
-		{
-			preloadMP3ThreadArgs[i].sortPriority = 0;
-		}
+		if(preloaded_tracks[track] <= 1)
+			sortPriority |= 0x40000000;
+		Queue_MP3(track, sortPriority);
 	}
-	std::sort(preloadMP3ThreadArgs.begin(), preloadMP3ThreadArgs.end());
 
+	ENTER_CRIT_SECT
+	std::sort(preloadMP3ThreadArgs.begin(), preloadMP3ThreadArgs.end());
 	EXIT_CRIT_SECT
+
+	if(!noTracksQueued && !s_preloadingMP3Thread)
+	{
+		s_preloadingMP3Thread = ::CreateThread(NULL, 0, (LPTHREAD_START_ROUTINE) Preload_MP3_Thread, (LPVOID) NULL, CREATE_SUSPENDED, NULL);
+		::SetThreadPriority(s_preloadingMP3Thread, THREAD_PRIORITY_LOWEST);
+		::ResumeThread(s_preloadingMP3Thread);
+	}
 }
 
 #else // no support for threaded MP3 loading on this platform
 
-void Preload_MP3(FILE** filePtr, int track)
+void Preload_MP3(int track)
 {
-	Preload_MP3_Synchronous(filePtr, track);
+	Preload_MP3_Synchronous(track);
 }
 
 void Preload_Used_MP3s(void)
@@ -544,7 +767,7 @@ void Preload_Used_MP3s(void)
 	int track;
 	for(track = 0; track < 100; track++)
 		if(preloaded_tracks[track])
-			Preload_MP3(&Tracks[track].F_decoded, track);
+			Preload_MP3(track);
 }
 
 #endif
@@ -564,55 +787,32 @@ void MP3_CancelAllPreloading(void)
 	}
 }
 
-FILE* GetMP3TrackFile(int trackIndex, int* pDontLeaveFileOpen, int* pWhere_read)
+int MP3_Read_Track(int trackIndex, char *buf, int size)
 {
-	FILE* decodedFile = Tracks[trackIndex].F_decoded;
-	int usePartiallyDecodedFile = 0;
-	char str [1024];
-
 	int curTrack = LBA_to_Track(SCD.Cur_LBA);
 	int lbaOffset = SCD.Cur_LBA - Track_to_LBA(curTrack);
 	int lba = lbaOffset;
-	int outRead = 0;
-	int forceNoDecode = 0;
+	int where_read, copied;
 
-	int& where_read = *pWhere_read;
 	where_read = (lba) * 588*4 + 16;
 	if(where_read < 0) where_read = 0;
 
+	copied = Read_Decoded(trackIndex, where_read, buf, size);
+
 #ifdef _WIN32
-	if(!decodedFile)
+	if(copied < 0)
 	{
 		Waiting_For_Preload_MP3_Synchronous = true;
-		Preload_MP3(&Tracks[trackIndex].F_decoded, trackIndex);
+		Preload_MP3(trackIndex);
 
 		DWORD tgtime = timeGetTime(); //Modif N - give frame advance sound:
 		bool soundCleared = false;
 
-		sprintf(str, "%s/" PRELOADED_MP3_DIRECTORY PRELOADED_MP3_FILENAME, Gens_Path, trackIndex+1);
-		while(!usePartiallyDecodedFile)
+		while((copied = Read_Decoded(trackIndex, where_read, buf, size)) < 0)
 		{
-			if(!decodedFile)
-				decodedFile = fopen(str, "rb");
-			if(decodedFile)
-			{
-				int decodedSize;
-				fseek(decodedFile, 0, SEEK_END);
-				decodedSize = ftell(decodedFile);
-				if(decodedSize >= where_read + 588*4)
-					usePartiallyDecodedFile = 1;
-			}
-			if(!usePartiallyDecodedFile && noTracksQueued)
-			{
-				if(decodedFile)
-					fclose(decodedFile);
-				decodedFile = NULL;
+			if(noTracksQueued)
 				break;
-			}
-#ifdef _WIN32
-			if(!usePartiallyDecodedFile)
-				Sleep(5);
-#endif // win32
+			Sleep(5);
 
 			if(!soundCleared && timeGetTime() - tgtime >= 125) //eliminate stutter
 			{
@@ -621,14 +821,18 @@ FILE* GetMP3TrackFile(int trackIndex, int* pDontLeaveFileOpen, int* pWhere_read)
 				soundCleared = true;
 			}
 		}
-		if(!decodedFile)
-			decodedFile = Tracks[trackIndex].F_decoded;
 		Waiting_For_Preload_MP3_Synchronous = false;
 	}
 #endif // threaded
 
-	*pDontLeaveFileOpen = usePartiallyDecodedFile;
-	return decodedFile;
+	return copied < 0 ? -1 : copied;
+}
+
+// decodeMP3 on mp, the MP3 being streamed
+int Decode_MP3(char *buf_in, int size)
+{
+	AutoCriticalSection lock (decoderCriticalSection);
+	return decodeMP3(&mp, buf_in, size, buf_out, 8 * 1024, (int*)&Current_OUT_Size);
 }
 
 int MP3_Play(int track, int lba_pos, int async)
@@ -649,10 +853,10 @@ int MP3_Play(int track, int lba_pos, int async)
 
 	if(!async)
 	{
-		Preload_MP3(&Tracks[Track_Played].F_decoded, Track_Played);
+		Preload_MP3(Track_Played);
 	}
 
-	if(async && !Tracks[Track_Played].F_decoded)
+	if(async && !Decoded_Complete(Track_Played))
 	{
 		// start playing MP3 "asynchronously", decoding on the fly... but it won't reliably produce the same sound samples under the same circumstances
 		Current_IN_Pos = MP3_Find_Frame(Tracks[Track_Played].F, lba_pos);
@@ -10,6 +10,7 @@ extern "C" {
 	 uint32 hook_value_cd;
 	 uint32 hook_pc;
 	 uint32 hook_pc_cd;
+	 uint32 hook_enabled = 1;	// main 68000 calls the hooks (see Update_Hook_Enabled)
 }
 
 #define defhook(name)\
@@ -0,0 +1,189 @@
+// Per-frame subsystem profiler
+// PROF_SCOPE(stage) charges the time from the rdtsc at its start to the one at its end to a stage,
+// and gives the time back to the stage it was called from, so each stage only counts its own time.
+// Frame_Prof_Begin/End (Update_Frame_Hook and Update_Frame_Fast_Hook) bracket the frames: the scopes
+// only count inside them and what isn't in any stage is PROF_OTHER. Every Frames frames the average
+// per frame of each stage is written as a CSV or JSON row. The rdtsc ticks are converted with the
+// QueryPerformanceCounter time since the file was opened.
+
+#include <windows.h>
+#include <stdio.h>
+#include <string.h>
+#include "frame_prof.h"
+#include "vdp_io.h"
+
+extern unsigned long FrameCount;
+
+int Prof_Active = 0;
+int Prof_Stage = PROF_OTHER;
+unsigned long long Prof_Last = 0;
+unsigned long long Prof_Ticks[PROF_STAGES];
+unsigned int Prof_Calls[PROF_STAGES];
+
+#ifdef FRAME_PROFILER
+
+static const char *Stage_Name[PROF_STAGES] =
+{
+	"other", "m68k", "z80", "s68k", "sh2", "line", "screen", "sound",
+	"lua", "plugin", "automation", "ram_search"
+};
+
+static FILE *Prof_File = NULL;
+static int Prof_Json;
+static int Prof_Frames = 60;
+static int Prof_Rows;
+static int Prof_Depth;
+
+static unsigned long long Frame_Start;
+static unsigned long long Window_Ticks, Window_Max;
+static int Window_Frames;
+
+static LARGE_INTEGER Open_Time;
+static unsigned long long Open_Tsc;
+
+static const char *System_Name(void)
+{
+	if(_32X_Started)
+		return "32x";
+	if(SegaCD_Started)
+		return "segacd";
+	return "genesis";
+}
+
+static void Write_Row(void)
+{
+	LARGE_INTEGER now, freq;
+	double tsc_per_us, us;
+	int i;
+
+	QueryPerformanceCounter(&now);
+	QueryPerformanceFrequency(&freq);
+	us = (double)(now.QuadPart - Open_Time.QuadPart) * 1000000.0 / (double)freq.QuadPart;
+	tsc_per_us = us > 0 ? (double)(__rdtsc() - Open_Tsc) / us : 1.0;
+
+	if(Prof_Json)
+	{
+		fprintf(Prof_File, "%s\n{\"frame\":%lu,\"frames\":%d,\"system\":\"%s\",\"frame_us\":%.1f,\"max_frame_us\":%.1f,\"us\":{",
+			Prof_Rows ? "," : "", FrameCount, Window_Frames, System_Name(),
+			Window_Ticks / tsc_per_us / Window_Frames, Window_Max / tsc_per_us);
+		for(i = 0; i < PROF_STAGES; i++)
+			fprintf(Prof_File, "%s\"%s\":%.1f", i ? "," : "", Stage_Name[i], Prof_Ticks[i] / tsc_per_us / Window_Frames);
+		fprintf(Prof_File, "},\"calls\":{");
+		for(i = 0; i < PROF_STAGES; i++)
+			fprintf(Prof_File, "%s\"%s\":%.1f", i ? "," : "", Stage_Name[i], (double)Prof_Calls[i] / Window_Frames);
+		fprintf(Prof_File, "}}");
+	}
+	else
+	{
+		fprintf(Prof_File, "%lu,%d,%s,%.1f,%.1f", FrameCount, Window_Frames, System_Name(),
+			Window_Ticks / tsc_per_us / Window_Frames, Window_Max / tsc_per_us);
+		for(i = 0; i < PROF_STAGES; i++)
+			fprintf(Prof_File, ",%.1f", Prof_Ticks[i] / tsc_per_us / Window_Frames);
+		fprintf(Prof_File, "\n");
+	}
+	Prof_Rows++;
+
+	memset(Prof_Ticks, 0, sizeof(Prof_Ticks));
+	memset(Prof_Calls, 0, sizeof(Prof_Calls));
+	Window_Ticks = Window_Max = 0;
+	Window_Frames = 0;
+}
+
+int Frame_Prof_Open(const char *path, int frames)
+{
+	const char *ext = strrchr(path, '.');
+	int i;
+
+	Prof_File = fopen(path, "w");
+	if(!Prof_File)
+	{
+		fprintf(stderr, "profile: can't create %s\n", path);
+		return 0;
+	}
+
+	Prof_Json = ext && !_stricmp(ext, ".json");
+	if(frames > 0)
+		Prof_Frames = frames;
+	Prof_Rows = 0;
+
+	if(Prof_Json)
+	{
+		fprintf(Prof_File, "{\"window\":%d,\"stages\":[", Prof_Frames);
+		for(i = 0; i < PROF_STAGES; i++)
+			fprintf(Prof_File, "%s\"%s\"", i ? "," : "", Stage_Name[i]);
+		fprintf(Prof_File, "],\"rows\":[");
+	}
+	else
+	{
+		fprintf(Prof_File, "frame,frames,system,frame_us,max_frame_us");
+		for(i = 0; i < PROF_STAGES; i++)
+			fprintf(Prof_File, ",%s_us", Stage_Name[i]);
+		fprintf(Prof_File, "\n");
+	}
+
+	memset(Prof_Ticks, 0, sizeof(Prof_Ticks));
+	memset(Prof_Calls, 0, sizeof(Prof_Calls));
+	Window_Ticks = Window_Max = 0;
+	Window_Frames = 0;
+
+	QueryPerformanceCounter(&Open_Time);
+	Open_Tsc = __rdtsc();
+	return 1;
+}
+
+void Frame_Prof_Close(void)
+{
+	if(!Prof_File)
+		return;
+
+	Prof_Active = 0;
+	if(Window_Frames)
+		Write_Row();
+	if(Prof_Json)
+		fprintf(Prof_File, "\n]}\n");
+	fclose(Prof_File);
+	Prof_File = NULL;
+}
+
+void Frame_Prof_Begin(void)
+{
+	// Update_Frame_Hook can be reentered from Lua (emu.frameadvance), count the outer frame only
+	if(!Prof_File || Prof_Depth++)
+		return;
+
+	Prof_Stage = PROF_OTHER;
+	Prof_Last = Frame_Start = __rdtsc();
+	Prof_Active = 1;
+}
+
+void Frame_Prof_End(void)
+{
+	unsigned long long frame;
+
+	if(!Prof_File || --Prof_Depth)
+		return;
+
+	Prof_Switch(PROF_OTHER);
+	Prof_Active = 0;
+
+	frame = Prof_Last - Frame_Start;
+	Window_Ticks += frame;
+	if(frame > Window_Max)
+		Window_Max = frame;
+	if(++Window_Frames == Prof_Frames)
+		Write_Row();
+}
+
+#else
+
+int Frame_Prof_Open(const char *path, int frames)
+{
+	fprintf(stderr, "profile: built without FRAME_PROFILER, %s not written\n", path);
+	return 0;
+}
+
+void Frame_Prof_Close(void) {}
+void Frame_Prof_Begin(void) {}
+void Frame_Prof_End(void) {}
+
+#endif
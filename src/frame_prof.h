@@ -0,0 +1,85 @@
+#ifndef FRAME_PROF_H
+#define FRAME_PROF_H
+
+// Per-frame subsystem profiler (frame_prof.cpp)
+// Comment out to build without it: PROF_SCOPE then compiles to nothing and -profile-out is ignored
+#define FRAME_PROFILER
+
+// Where the frame time goes. The time of a stage doesn't include the stages it calls,
+// what's left of the frame is PROF_OTHER.
+enum {
+	PROF_OTHER = 0,		// frame code outside the stages below (DMA, I/O, interrupts, CD timers)
+	PROF_M68K,			// main 68000
+	PROF_Z80,
+	PROF_S68K,			// Sega CD 68000
+	PROF_SH2,			// both 32X SH2s
+	PROF_LINE,			// Render_Line_Selected / Render_Line_32X
+	PROF_SCREEN,		// Render_MD_Screen / Render_MD_Screen32X
+	PROF_SOUND,			// YM2612, PSG, PWM, PCM, CD audio and the sound dumps
+	PROF_LUA,			// registered Lua callbacks
+	PROF_PLUGIN,		// plugin frame hooks
+	PROF_AUTOMATION,	// Automation_OnFrame (screenshots, state dumps, compares)
+	PROF_RAM_SEARCH,	// Update_RAM_Search and the RAM history
+	PROF_STAGES
+};
+
+extern int Prof_Active;					// profiling and inside a frame
+extern int Prof_Stage;
+extern unsigned long long Prof_Last;		// time stamp of the last stage change
+extern unsigned long long Prof_Ticks[PROF_STAGES];
+extern unsigned int Prof_Calls[PROF_STAGES];
+
+// Output file, .json for JSON, anything else is CSV; one row per Frames frames
+int Frame_Prof_Open(const char *path, int frames);
+void Frame_Prof_Close(void);
+void Frame_Prof_Begin(void);
+void Frame_Prof_End(void);
+
+#ifdef FRAME_PROFILER
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+
+static inline int Prof_Switch(int stage)
+{
+	unsigned long long now = __rdtsc();
+	int prev = Prof_Stage;
+
+	Prof_Ticks[prev] += now - Prof_Last;
+	Prof_Last = now;
+	Prof_Stage = stage;
+	return prev;
+}
+
+struct Prof_Scope
+{
+	int Prev;
+
+	Prof_Scope(int stage)
+	{
+		Prev = -1;
+		if(Prof_Active)
+		{
+			Prof_Calls[stage]++;
+			Prev = Prof_Switch(stage);
+		}
+	}
+	~Prof_Scope()
+	{
+		if(Prev >= 0 && Prof_Active)
+			Prof_Switch(Prev);
+	}
+};
+
+#define PROF_SCOPE(stage)	Prof_Scope prof_scope_(stage)
+
+#else
+
+#define PROF_SCOPE(stage)
+
+#endif
+
+#endif
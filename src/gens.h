@@ -68,6 +68,13 @@ void Reset_32X();
 int Do_32X_Frame_No_VDP(void);
 int Do_32X_Frame(void);
 
+// How Do_32X_Frame interleaves the 68000 and the SH2s
+enum {
+	_32X_SYNC_STRICT = 0,	// fixed short turns
+	_32X_SYNC_ADAPTIVE,		// longer turns while they don't access the 32X system registers
+};
+extern int _32X_Sync;
+
 int Init_SegaCD(char *iso_name);
 int Reload_SegaCD(char *iso_name);
 void Reset_SegaCD(void);
@@ -0,0 +1,100 @@
+// Native plugin interface for Gens-rr
+// Plugins are shared libraries (DLLs) loaded at startup with -plugin path.
+// They register callbacks for memory/exec/DMA/frame events and get direct
+// pointers to emulated memory, which makes whole-RAM instrumentation practical
+// where the Lua memory hooks would be too slow.
+//
+// This header is the whole ABI: plain C, no C++ types, and structs only ever grow
+// at the end (check api_version / struct_size before using newer fields).
+
+#ifndef GENS_PLUGIN_H
+#define GENS_PLUGIN_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define GENS_PLUGIN_API_VERSION 1
+
+#ifdef _WIN32
+#define GENS_PLUGIN_EXPORT __declspec(dllexport)
+#else
+#define GENS_PLUGIN_EXPORT
+#endif
+
+// Hook types for register_mem_hook
+enum GensPluginHookType {
+    GENS_HOOK_WRITE     = 0,  // main 68000 write
+    GENS_HOOK_READ      = 1,  // main 68000 read
+    GENS_HOOK_EXEC      = 2,  // main 68000 instruction about to execute (size is always 2)
+    GENS_HOOK_WRITE_SUB = 3,  // Sega CD sub 68000 write
+    GENS_HOOK_READ_SUB  = 4,  // Sega CD sub 68000 read
+    GENS_HOOK_EXEC_SUB  = 5,  // Sega CD sub 68000 instruction about to execute
+    GENS_HOOK_COUNT
+};
+
+// Memory access / exec callback
+// address - 24-bit address accessed (for exec hooks, the PC)
+// size    - access size in bytes (1, 2 or 4)
+// value   - value read or written (0 for exec hooks)
+// pc      - PC of the instruction doing the access
+typedef void (*GensMemHookFunc)(void* userdata, uint32_t address, uint32_t size, uint32_t value, uint32_t pc);
+
+// VDP DMA callback (same values BinTrace_DMA gets)
+// dst_type - 0 = VRAM, 1 = CRAM, 2 = VSRAM
+typedef void (*GensDMAHookFunc)(void* userdata, uint32_t src, uint32_t dst, uint32_t len, uint32_t dst_type, uint32_t pc);
+
+// Called once per emulated frame, after the frame finishes and after Lua's emu.registerafter callbacks
+typedef void (*GensFrameHookFunc)(void* userdata, uint32_t frame);
+
+struct GensPluginHost {
+    uint32_t api_version;          // GENS_PLUGIN_API_VERSION of the host
+    uint32_t struct_size;          // sizeof(struct GensPluginHost) of the host
+
+    // Direct pointers to emulated memory.
+    // 68000-side memory (Ram_68k, VRam, Rom_Data) is stored as little-endian 16-bit words,
+    // so the byte at even address A lives at ptr[A ^ 1].
+    uint8_t*  ram_68k;             // 64 KB work RAM (0xFF0000)
+    uint8_t*  ram_z80;             // 8 KB Z80 RAM (0xA00000), not byte-swapped
+    uint8_t*  vram;                // 64 KB VRAM (call vram_written after writing through it)
+    uint16_t* cram;                // 64 CRAM entries
+    uint8_t*  vsram;               // VSRAM
+    uint8_t*  rom;                 // cartridge ROM
+    const uint32_t* rom_size;      // current ROM size in bytes (changes when a ROM is loaded)
+
+    // CPU contexts: main68k_context / sub68k_context (struct S68000CONTEXT in Star_68k.h)
+    // and M_Z80 (Z80_CONTEXT in z80.h). Registers can be read inside any callback.
+    void* main68k_context;
+    void* sub68k_context;
+    void* z80_context;
+
+    // Callback registration. start/end are inclusive address bounds.
+    // Return a handle (> 0) for unregister_hook, or 0 on failure.
+    int  (*register_mem_hook)(int type, uint32_t start, uint32_t end, GensMemHookFunc func, void* userdata);
+    int  (*register_dma_hook)(GensDMAHookFunc func, void* userdata);
+    int  (*register_frame_hook)(GensFrameHookFunc func, void* userdata);
+    void (*unregister_hook)(int handle);
+
+    // Writes a line to stderr, prefixed with "plugin: "
+    void (*log)(const char* message);
+
+    // Tells the renderers that [address, address + length) of vram was written through the pointer above,
+    // so the C++ renderer decodes those tiles again (VRAM writes through the VDP ports don't need it)
+    void (*vram_written)(uint32_t address, uint32_t length);
+};
+
+// Every plugin must export this. Return 0 to refuse loading (the DLL is then unloaded).
+typedef int  (*GensPluginInitFunc)(const struct GensPluginHost* host);
+#define GENS_PLUGIN_INIT_NAME "GensPlugin_Init"
+
+// Optional, called before the emulator exits.
+typedef void (*GensPluginShutdownFunc)(void);
+#define GENS_PLUGIN_SHUTDOWN_NAME "GensPlugin_Shutdown"
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GENS_PLUGIN_H
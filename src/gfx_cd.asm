@@ -780,7 +780,7 @@ section .text align=64
 
 	ALIGN4
 
-	Table_Jump_Rot
+	DECL Table_Jump_Rot
 		dd .Norm_D16_S1, .Titled_D16_S1
 		dd .Norm_D32_S1, .Titled_D32_S1
 		dd .Norm_D16_S16, .Titled_D16_S16
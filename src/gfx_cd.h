@@ -18,11 +18,30 @@ extern struct {
 } Rot_Comp;
 
 extern int Table_Rot_Time[4 * 4 * 4];
+extern int Table_Jump_Rot[4 * 8];
 extern int Stamp_Map_Adr, Buffer_Adr, Vector_Adr, Jmp_Adr, Float_Part, Draw_Speed;
 extern int XS, YS, DXS, DYS, XD, YD, XD_Mul, H_Dot;
 
 void Init_RS_GFX(void);
 int Calcul_Rot_Comp(void);
+void Update_Rot(void);
+
+// Portable version of Calcul_Rot_Comp / Update_Rot (gfx_cd_c.cpp), same image buffer output
+void Calcul_Rot_Comp_C(void);
+void Update_Rot_C(void);
+
+// Which stamp rotation/scaling Calcul_Rot_Comp_Selected / Update_Rot_Selected use (called from Mem_S68k.asm)
+enum {
+	GFX_CD_RENDERER_ASM = 0,	// Calcul_Rot_Comp / Update_Rot (gfx_cd.asm)
+	GFX_CD_RENDERER_C,			// Calcul_Rot_Comp_C / Update_Rot_C
+	GFX_CD_RENDERER_VERIFY,		// both, report when the word RAM differs and keep the asm result
+};
+extern int GFX_CD_Renderer;
+extern int GFX_CD_Verify_Mismatches;
+
+void Calcul_Rot_Comp_Selected(void);
+void Update_Rot_Selected(void);
+void GFX_CD_Verify_Report(void);
 
 #ifdef __cplusplus
 };
@@ -0,0 +1,473 @@
+// Portable version of the Sega CD stamp rotation/scaling (Calcul_Rot_Comp and Update_Rot, gfx_cd.asm)
+// Draws the same image buffer as the asm, one trace vector line at a time: the source positions,
+// stamp map indexes and screen clipping of a whole line are computed first (4 dots at a time with SSE2),
+// then the stamp dots are fetched and written to the image buffer with the priority mode.
+// The timing (Float_Part, Draw_Speed, V_Dot) and the registers are shared with the asm,
+// so GFX_CD_RENDERER_VERIFY can run both on the same operation and compare the word RAM.
+
+#include <windows.h>
+#include <stdio.h>
+#include <string.h>
+#include "gfx_cd.h"
+#include "Mem_S68k.h"
+#include "Star_68k.h"
+
+// the line setup uses SSE2 when the compiler targets it
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+   #define GFX_CD_SSE2
+   #include <emmintrin.h>
+#endif
+
+#define WORD_RAM_MASK (256 * 1024 - 1)
+#define OUT_OF_SCREEN 0x80000000
+
+extern unsigned long FrameCount;
+
+int GFX_CD_Renderer = GFX_CD_RENDERER_ASM;
+int GFX_CD_Verify_Mismatches = 0;
+
+// Where the asm keeps absolute pointers (Stamp_Map_Adr, Vector_Adr, Jmp_Adr) the C version works on
+// word RAM offsets. They're taken from the asm globals at each call and put back after it, so the
+// savestates (which only have the globals) resume in either version. The vector offset isn't wrapped
+// so that it can be compared with the asm one, the reads wrap it.
+static struct
+{
+	unsigned int Stamp_Map;
+	unsigned int Vector;
+	unsigned int Mode;		// index of Table_Jump_Rot: titled, 32x32 dot, 16x16 screen, priority mode << 3
+} Rot_C;
+
+// per line: stamp map index of each dot (OUT_OF_SCREEN when clipped) and its position in the stamp (py << 8 | px)
+static unsigned int Line_Map[512];
+static unsigned int Line_Dot[512];
+
+// stamp dot (u, v) of the screen dot (px, py) for each orientation (H flip << 2 | rotation):
+// u = (swap ? py : px) ^ (flip u ? size - 1 : 0), v = (swap ? px : py) ^ (flip v ? size - 1 : 0)
+static const unsigned char Orient_Swap[8] = {0, 1, 0, 1, 0, 1, 0, 1};
+static const unsigned char Orient_Flip_U[8] = {0, 1, 1, 0, 1, 1, 0, 0};
+static const unsigned char Orient_Flip_V[8] = {0, 0, 1, 1, 0, 1, 1, 0};
+
+// verify mode timings (QueryPerformanceCounter ticks) and work done
+static LARGE_INTEGER Verify_Ticks_Asm, Verify_Ticks_C;
+static unsigned int Verify_Lines, Verify_Ops;
+
+
+static inline unsigned int Read_Word_Ram(unsigned int adr)
+{
+	return *(unsigned short *)(Ram_Word_2M + (adr & WORD_RAM_MASK));
+}
+
+static inline unsigned int Word_Ram_Base(void)
+{
+	return (unsigned int)(size_t)Ram_Word_2M;
+}
+
+static void Rot_C_From_Asm(void)
+{
+	unsigned int i;
+
+	Rot_C.Stamp_Map = (unsigned int)Stamp_Map_Adr - Word_Ram_Base();
+	Rot_C.Vector = (unsigned int)Vector_Adr - Word_Ram_Base();
+	// the last 8 entries are the first 8 again, priority mode 3 draws like 0
+	for(i = 0; i < 4 * 8 && Table_Jump_Rot[i] != Jmp_Adr; i++) {}
+	Rot_C.Mode = i & 0x1F;
+}
+
+static void Rot_C_To_Asm(void)
+{
+	Stamp_Map_Adr = (int)(Word_Ram_Base() + Rot_C.Stamp_Map);
+	Vector_Adr = (int)(Word_Ram_Base() + Rot_C.Vector);
+	Jmp_Adr = Table_Jump_Rot[Rot_C.Mode];
+}
+
+
+// Source position, stamp map index and clipping of every dot of the line.
+// x and y have 11 bits of fraction, the masks and shifts are the ones of MAKE_IMAGE_LINE.
+static void Setup_Line(unsigned int x, unsigned int y, int dx, int dy, int n)
+{
+	const int dot32 = (Rot_C.Mode >> 1) & 1;
+	const int scr16 = (Rot_C.Mode >> 2) & 1;
+	const unsigned int map_shift = 15 + dot32;
+	const unsigned int map_mask = (scr16 ? 0xFF : 0x0F) >> dot32;
+	const unsigned int row_shift = (scr16 ? 8 : 4) - dot32;
+	const unsigned int dot_mask = dot32 ? 31 : 15;
+	const unsigned int range = (Rot_C.Mode & 1) ? 0 : (scr16 ? 0x00800000 : 0x00F80000);
+	int i = 0;
+
+#ifdef GFX_CD_SSE2
+	const __m128i v_map_shift = _mm_cvtsi32_si128(map_shift);
+	const __m128i v_row_shift = _mm_cvtsi32_si128(row_shift);
+	const __m128i v_map_mask = _mm_set1_epi32(map_mask);
+	const __m128i v_dot_mask = _mm_set1_epi32(dot_mask);
+	const __m128i v_range = _mm_set1_epi32(range);
+	const __m128i v_out = _mm_set1_epi32(OUT_OF_SCREEN);
+	const __m128i v_dx = _mm_set1_epi32(dx * 4), v_dy = _mm_set1_epi32(dy * 4);
+	__m128i vx = _mm_set_epi32(x + dx * 3, x + dx * 2, x + dx, x);
+	__m128i vy = _mm_set_epi32(y + dy * 3, y + dy * 2, y + dy, y);
+
+	for(; i < n; i += 4)
+	{
+		__m128i sx = _mm_and_si128(_mm_srl_epi32(vx, v_map_shift), v_map_mask);
+		__m128i sy = _mm_and_si128(_mm_srl_epi32(vy, v_map_shift), v_map_mask);
+		__m128i in = _mm_cmpeq_epi32(_mm_and_si128(_mm_or_si128(vx, vy), v_range), _mm_setzero_si128());
+		__m128i map = _mm_or_si128(_mm_sll_epi32(sy, v_row_shift), sx);
+		__m128i px = _mm_and_si128(_mm_srli_epi32(vx, 11), v_dot_mask);
+		__m128i py = _mm_and_si128(_mm_srli_epi32(vy, 11), v_dot_mask);
+
+		_mm_storeu_si128((__m128i *)(Line_Map + i), _mm_or_si128(map, _mm_andnot_si128(in, v_out)));
+		_mm_storeu_si128((__m128i *)(Line_Dot + i), _mm_or_si128(_mm_slli_epi32(py, 8), px));
+
+		vx = _mm_add_epi32(vx, v_dx);
+		vy = _mm_add_epi32(vy, v_dy);
+	}
+#else
+	for(; i < n; i++, x += dx, y += dy)
+	{
+		unsigned int map = (((y >> map_shift) & map_mask) << row_shift) | ((x >> map_shift) & map_mask);
+
+		Line_Map[i] = ((x | y) & range) ? (map | OUT_OF_SCREEN) : map;
+		Line_Dot[i] = (((y >> 11) & dot_mask) << 8) | ((x >> 11) & dot_mask);
+	}
+#endif
+}
+
+
+// Stamp dots of the line (MAKE_IMAGE_PIXEL), stamp 0 and clipped dots are 0. Stamp data is 4 bits
+// per dot in columns of 8 dots, 16 or 32 lines of 4 bytes, byte swapped. The dots are written to the
+// image buffer from the dot IB_Offset & 7 of the cell column at buf: underwrite only fills dots that
+// are 0, overwrite doesn't write the dots that are 0. Each dot is fetched after the previous one is
+// written like the asm does, the image buffer may overlap the stamps.
+static void Draw_Dots(unsigned int buf, int n)
+{
+	const unsigned int dot32 = (Rot_C.Mode >> 1) & 1;
+	const unsigned int dot_mask = dot32 ? 31 : 15;
+	const unsigned int col_size = dot32 ? 128 : 64;
+	const unsigned int next_col = ((Rot_Comp.IB_V_Cell_Size & 0x1F) << 5) + 32;
+	const unsigned int prio = (Rot_C.Mode >> 3) & 3;
+	unsigned int xd = Rot_Comp.IB_Offset & 7;
+	unsigned int swap[8], flip_u[8], flip_v[8];
+	int i;
+
+	for(i = 0; i < 8; i++)
+	{
+		swap[i] = Orient_Swap[i] ? dot_mask : 0;
+		flip_u[i] = Orient_Flip_U[i] ? dot_mask : 0;
+		flip_v[i] = Orient_Flip_V[i] ? dot_mask : 0;
+	}
+
+	for(i = 0; i < n; i++)
+	{
+		const unsigned int map = Line_Map[i];
+		unsigned char *dst = Ram_Word_2M + ((buf + ((xd >> 1) ^ 1)) & WORD_RAM_MASK);
+		unsigned int pix = 0;
+
+		if(!(map & OUT_OF_SCREEN))
+		{
+			const unsigned int data = *(unsigned short *)(Ram_Word_2M + Rot_C.Stamp_Map + map * 2);
+
+			if(data & 0x7FF)
+			{
+				const unsigned int px = Line_Dot[i] & 0xFF, py = Line_Dot[i] >> 8;
+				const unsigned int t = (px ^ py) & swap[data >> 13];
+				const unsigned int u = px ^ t ^ flip_u[data >> 13];
+				const unsigned int v = py ^ t ^ flip_v[data >> 13];
+
+				// 32x32 dot stamps with one of the low 2 bits of the number set end past the word RAM,
+				// the asm reads Ram_Word_1M there
+				const unsigned int adr = ((data & 0x7FF) << 7) + (u >> 3) * col_size + v * 4 + (((u >> 1) & 3) ^ 1);
+				pix = (Ram_Word_2M[adr & WORD_RAM_MASK] >> ((~u & 1) << 2)) & 0xF;
+			}
+		}
+
+		if(xd & 1)
+		{
+			if(!(prio == 1 && (*dst & 0x0F)) && !(prio == 2 && !pix))
+				*dst = (unsigned char)((*dst & 0xF0) | pix);
+		}
+		else
+		{
+			if(!(prio == 1 && (*dst & 0xF0)) && !(prio == 2 && !pix))
+				*dst = (unsigned char)((*dst & 0x0F) | (pix << 4));
+		}
+
+		if(++xd == 8)
+		{
+			xd = 0;
+			buf += next_col;
+		}
+	}
+}
+
+
+// MAKE_IMAGE: one line of the operation, from the next trace vector
+static void Draw_Line(void)
+{
+	const unsigned int x = (Read_Word_Ram(Rot_C.Vector) << 8) & 0x00FFFF00;
+	const unsigned int y = Read_Word_Ram(Rot_C.Vector + 2) << 8;
+	const int dx = (short)Read_Word_Ram(Rot_C.Vector + 4);
+	const int dy = (short)Read_Word_Ram(Rot_C.Vector + 6);
+	const int n = Rot_Comp.IB_H_Dot_Size & 0x1FF;
+
+	Rot_C.Vector += 8;
+	if(!n)
+		return;
+
+	Setup_Line(x, y, dx, dy, n);
+	Draw_Dots((Rot_Comp.IB_Adr & 0xFFF8) * 4 + YD * 4, n);
+}
+
+
+// Update_Rot without the interrupt, returns 1 when the operation is completed
+static int Update_Rot_Lines(void)
+{
+	unsigned int lines;
+
+	if(Rot_Comp.IB_V_Dot_Size & 0xFF)
+	{
+		if(!(Float_Part & 0xFFFF0000))
+		{
+			Float_Part += Draw_Speed;
+			return 0;
+		}
+
+		lines = (unsigned int)Float_Part >> 16;
+		Float_Part = (Float_Part & 0xFFFF) + Draw_Speed;
+
+		for(;;)
+		{
+			Draw_Line();
+			YD++;
+			Rot_Comp.IB_V_Dot_Size = (Rot_Comp.IB_V_Dot_Size & ~0xFF) | ((Rot_Comp.IB_V_Dot_Size - 1) & 0xFF);
+
+			if(!(Rot_Comp.IB_V_Dot_Size & 0xFF))
+				break;
+			if(!--lines)
+				return 0;
+		}
+	}
+
+	Rot_Comp.Stamp_Size &= 0x7FFF;
+	Rot_Comp.IB_V_Dot_Size = 0;				// GFX completed
+	return 1;
+}
+
+// Update_Rot_Lines on the operation the asm globals describe
+static int Update_Rot_Lines_Asm(void)
+{
+	int done;
+
+	Rot_C_From_Asm();
+	done = Update_Rot_Lines();
+	Vector_Adr = (int)(Word_Ram_Base() + Rot_C.Vector);
+	return done;
+}
+
+static void GFX_Completed_Int(void)
+{
+	if(Int_Mask_S68K & 0x02)
+		sub68k_interrupt(1, -1);
+}
+
+// Calcul_Rot_Comp without the interrupt, returns 1 when the operation is already completed
+static int Calcul_Rot_Lines(void)
+{
+	if((Ram_Word_State & 0xFF) > 1)
+		return 0;
+
+	XD_Mul = (Rot_Comp.IB_V_Cell_Size & 0x1F) * 4 + 4;
+	YD = (Rot_Comp.IB_Offset >> 3) & 7;
+	Rot_C.Vector = (Rot_Comp.Vector_Adr & 0xFFFE) * 4;
+	Rot_C.Mode = ((Rot_Comp.Stamp_Size & 7) | S68K_Mem_PM) & 0x1F;
+
+	Draw_Speed = Float_Part = Table_Rot_Time[(Rot_Comp.IB_H_Dot_Size & 0x1FF) >> 3];
+	Rot_Comp.Stamp_Size |= 0x8000;			// we start a new GFX operation
+
+	switch(Rot_Comp.Stamp_Size & 6)
+	{
+		case 0:		// 16x16 dot, 1x1 screen
+			Rot_C.Stamp_Map = (Rot_Comp.Stamp_Map_Adr & 0xFF80) * 4;
+			break;
+		case 2:		// 32x32 dot, 1x1 screen
+			Rot_C.Stamp_Map = (Rot_Comp.Stamp_Map_Adr & 0xFFE0) * 4;
+			break;
+		case 4:		// 16x16 dot, 16x16 screen
+			Rot_C.Stamp_Map = 0x20000;
+			break;
+		default:	// 32x32 dot, 16x16 screen
+			Rot_C.Stamp_Map = (Rot_Comp.Stamp_Map_Adr & 0xE000) * 4;
+			break;
+	}
+
+	Rot_C_To_Asm();
+	return Update_Rot_Lines_Asm();
+}
+
+
+void Calcul_Rot_Comp_C(void)
+{
+	if(Calcul_Rot_Lines())
+		GFX_Completed_Int();
+}
+
+void Update_Rot_C(void)
+{
+	if(Update_Rot_Lines_Asm())
+		GFX_Completed_Int();
+}
+
+
+#define VERIFY_MAX_REPORTS 32
+
+// State the rotation/scaling reads and writes (the asm line scratch globals are set again for each line)
+struct Rot_State
+{
+	unsigned int Regs[8];
+	int Float_Part, Draw_Speed, YD;
+	unsigned int Stamp_Map, Vector;
+	int Jmp_Adr;
+};
+
+static void Save_Rot_State(Rot_State *s)
+{
+	memcpy(s->Regs, &Rot_Comp, sizeof(s->Regs));
+	s->Float_Part = Float_Part;
+	s->Draw_Speed = Draw_Speed;
+	s->YD = YD;
+	s->Stamp_Map = (unsigned int)Stamp_Map_Adr - Word_Ram_Base();
+	s->Vector = (unsigned int)Vector_Adr - Word_Ram_Base();
+	s->Jmp_Adr = Jmp_Adr;
+}
+
+static void Load_Rot_State(const Rot_State *s)
+{
+	memcpy(&Rot_Comp, s->Regs, sizeof(s->Regs));
+	Float_Part = s->Float_Part;
+	Draw_Speed = s->Draw_Speed;
+	YD = s->YD;
+	Stamp_Map_Adr = (int)(Word_Ram_Base() + s->Stamp_Map);
+	Vector_Adr = (int)(Word_Ram_Base() + s->Vector);
+	Jmp_Adr = s->Jmp_Adr;
+}
+
+// Runs the asm with its interrupt and then the C version from the same state,
+// reports when the word RAM or the state differ and keeps the asm result
+static void Verify(int start)
+{
+	static unsigned char ram_in[256 * 1024], ram_asm[256 * 1024];
+	const int draws = start || !(Rot_Comp.IB_V_Dot_Size & 0xFF) || (Float_Part & 0xFFFF0000);
+	const unsigned int lines_in = Rot_Comp.IB_V_Dot_Size & 0xFF;
+	LARGE_INTEGER t0, t1, t2, t3;
+	Rot_State in, out_asm, out_c;
+
+	// nothing starts in 1M mode, leave the vector where both have it
+	if(start && (Ram_Word_State & 0xFF) > 1)
+	{
+		Calcul_Rot_Comp();
+		return;
+	}
+
+	// only the calls that draw lines can change the word RAM
+	if(draws)
+		memcpy(ram_in, Ram_Word_2M, sizeof(ram_in));
+	Save_Rot_State(&in);
+
+	QueryPerformanceCounter(&t0);
+	if(start)
+		Calcul_Rot_Comp();
+	else
+		Update_Rot();
+	QueryPerformanceCounter(&t1);
+
+	Save_Rot_State(&out_asm);
+	if(draws)
+	{
+		memcpy(ram_asm, Ram_Word_2M, sizeof(ram_asm));
+		memcpy(Ram_Word_2M, ram_in, sizeof(ram_in));
+	}
+	Load_Rot_State(&in);
+
+	QueryPerformanceCounter(&t2);
+	if(start)
+		Calcul_Rot_Lines();
+	else
+		Update_Rot_Lines_Asm();
+	QueryPerformanceCounter(&t3);
+
+	Save_Rot_State(&out_c);
+
+	Verify_Ticks_Asm.QuadPart += t1.QuadPart - t0.QuadPart;
+	Verify_Ticks_C.QuadPart += t3.QuadPart - t2.QuadPart;
+	Verify_Lines += (lines_in - (out_asm.Regs[6] & 0xFF)) & 0xFF;
+	if(start)
+		Verify_Ops++;
+
+	if(!memcmp(&out_asm, &out_c, sizeof(out_asm)) && (!draws || !memcmp(ram_asm, Ram_Word_2M, sizeof(ram_asm))))
+		return;
+
+	if(++GFX_CD_Verify_Mismatches <= VERIFY_MAX_REPORTS)
+	{
+		unsigned int i;
+		for(i = 0; draws && i < sizeof(ram_asm) && ram_asm[i] == Ram_Word_2M[i]; i++) {}
+
+		if(draws && i < sizeof(ram_asm))
+			fprintf(stderr, "scd gfx verify: frame %lu: word RAM %05X is %02X, asm has %02X (stamp size %04X, vector %05X)\n",
+				FrameCount, i, Ram_Word_2M[i], ram_asm[i], in.Regs[0] & 0xFFFF, in.Vector);
+		else
+			fprintf(stderr, "scd gfx verify: frame %lu: state differs, V dot %02X / %02X, float part %08X / %08X, vector %05X / %05X (C / asm)\n",
+				FrameCount, out_c.Regs[6] & 0xFF, out_asm.Regs[6] & 0xFF, out_c.Float_Part, out_asm.Float_Part, out_c.Vector, out_asm.Vector);
+		if(GFX_CD_Verify_Mismatches == VERIFY_MAX_REPORTS)
+			fprintf(stderr, "scd gfx verify: further mismatches are only counted\n");
+	}
+
+	// keep going with the reference output
+	if(draws)
+		memcpy(Ram_Word_2M, ram_asm, sizeof(ram_asm));
+	Load_Rot_State(&out_asm);
+}
+
+void GFX_CD_Verify_Report(void)
+{
+	LARGE_INTEGER freq;
+
+	if(GFX_CD_Renderer != GFX_CD_RENDERER_VERIFY || !Verify_Ops)
+		return;
+
+	QueryPerformanceFrequency(&freq);
+	fprintf(stderr, "scd gfx verify: %u operations, %u lines, asm %.3f ms, C %.3f ms, %d mismatches\n",
+		Verify_Ops, Verify_Lines,
+		Verify_Ticks_Asm.QuadPart * 1000.0 / freq.QuadPart, Verify_Ticks_C.QuadPart * 1000.0 / freq.QuadPart,
+		GFX_CD_Verify_Mismatches);
+}
+
+
+void Calcul_Rot_Comp_Selected(void)
+{
+	switch(GFX_CD_Renderer)
+	{
+		case GFX_CD_RENDERER_C:
+			Calcul_Rot_Comp_C();
+			break;
+		case GFX_CD_RENDERER_VERIFY:
+			Verify(1);
+			break;
+		default:
+			Calcul_Rot_Comp();
+			break;
+	}
+}
+
+void Update_Rot_Selected(void)
+{
+	switch(GFX_CD_Renderer)
+	{
+		case GFX_CD_RENDERER_C:
+			Update_Rot_C();
+			break;
+		case GFX_CD_RENDERER_VERIFY:
+			Verify(0);
+			break;
+		default:
+			Update_Rot();
+			break;
+	}
+}
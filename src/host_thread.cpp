@@ -0,0 +1,56 @@
+// Win32 version of host_thread.h
+
+#include <windows.h>
+#include "host_thread.h"
+
+static DWORD WINAPI Thread_Proc(LPVOID param)
+{
+	((void (*)(void))param)();
+	return 0;
+}
+
+Host_Handle Host_Thread_Start(void (*Proc)(void))
+{
+	return CreateThread(NULL, 0, Thread_Proc, (LPVOID)Proc, 0, NULL);
+}
+
+void Host_Thread_Join(Host_Handle Thread)
+{
+	WaitForSingleObject(Thread, INFINITE);
+	CloseHandle(Thread);
+}
+
+Host_Handle Host_Event_Create(void)
+{
+	return CreateEvent(NULL, FALSE, FALSE, NULL);
+}
+
+void Host_Event_Set(Host_Handle Event)
+{
+	SetEvent(Event);
+}
+
+void Host_Event_Wait(Host_Handle Event)
+{
+	WaitForSingleObject(Event, INFINITE);
+}
+
+void Host_Event_Close(Host_Handle Event)
+{
+	CloseHandle(Event);
+}
+
+long Host_Atomic_Increment(volatile long *Value)
+{
+	return InterlockedIncrement(Value);
+}
+
+void Host_Atomic_Store(volatile long *Value, long New_Value)
+{
+	InterlockedExchange(Value, New_Value);
+}
+
+void Host_Pause(void)
+{
+	YieldProcessor();
+}
@@ -0,0 +1,26 @@
+#ifndef HOST_THREAD_H
+#define HOST_THREAD_H
+
+// Threads, events and atomic counters for the portable sources (host_thread.cpp has the Win32 version)
+
+typedef void *Host_Handle;
+
+// thread running Proc, 0 when it can't be started
+Host_Handle Host_Thread_Start(void (*Proc)(void));
+// wait for the thread to return and close it
+void Host_Thread_Join(Host_Handle Thread);
+
+// auto-reset event: a wait returns once per set
+Host_Handle Host_Event_Create(void);
+void Host_Event_Set(Host_Handle Event);
+void Host_Event_Wait(Host_Handle Event);
+void Host_Event_Close(Host_Handle Event);
+
+// full barriers, like the Interlocked functions
+long Host_Atomic_Increment(volatile long *Value);
+void Host_Atomic_Store(volatile long *Value, long New_Value);
+
+// hint for a spin-wait loop
+void Host_Pause(void);
+
+#endif
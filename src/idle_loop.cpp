@@ -0,0 +1,928 @@
+// Idle loop skipping for the Genesis 68000 and Z80 and the 32X SH2s
+// Games spend most of a frame in loops like "tst.b ($FFxxxx).w / beq.s *-4" waiting for the V-Int handler.
+// Nothing else runs while a CPU has its time slice (the other CPU, VDP and interrupts are only updated
+// between main68k_exec / z80_Exec calls), so such a loop keeps reading the same values until the slice ends.
+// A loop is only taken if it is made of instructions that read RAM or ROM and write nothing but data
+// registers and flags, and it is run for two iterations first: if the registers, flags and cycle count
+// of both are the same, every further iteration is the same too and the ones that fit before the end
+// of the slice are skipped by adding their cycles. What's left of the slice is run as usual, so the CPU
+// ends up in exactly the state it would have without the skip.
+// Not done while anything watches every instruction or memory access (traces, Lua or plugin hooks).
+// On the 32X the same holds for a turn of Exec_32X_Turns: an SH2 waiting on a communication port or
+// SDRAM for the other CPUs can't see them write before its turn is over.
+
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include "idle_loop.h"
+#include "m68k_verify.h"
+#include "z80_verify.h"
+#include "frame_prof.h"
+#include "Star_68k.h"
+#include "Mem_M68k.h"
+#include "Mem_Z80.h"
+#include "z80.h"
+#include "automation.h"
+#include "bintrace.h"
+#include "plugin.h"
+#include "luascript.h"
+#include "SH2.h"
+#include "Mem_SH2.h"
+
+#define NO_BRANCH		0xFFFFFFFF
+#define MAX_LOOP_BYTES	32
+#define MAX_LOOP_INSNS	8
+#define VERIFY_MAX_REPORTS	32
+
+extern unsigned long FrameCount;
+extern bool trace_map;
+extern bool hook_trace;
+
+int Idle_Skip = IDLE_SKIP_OFF;
+int Idle_Skip_Mismatches = 0;
+unsigned int Idle_Skipped_Cycles_M68K = 0;
+unsigned int Idle_Skipped_Cycles_Z80 = 0;
+unsigned int Idle_Skipped_Cycles_SH2 = 0;
+
+static int Observed()
+{
+	return trace_map || hook_trace || TraceActive || TraceBreakpointPC || BinTraceActive
+		|| PluginMemHooksActive[GENS_HOOK_READ] || PluginMemHooksActive[GENS_HOOK_EXEC]
+		|| AnyRegisteredLuaMemHook(LUAMEMHOOK_READ) || AnyRegisteredLuaMemHook(LUAMEMHOOK_EXEC);
+}
+
+static void Report(const char *cpu, unsigned int head, unsigned int pc, unsigned int odo, unsigned int odo_skip)
+{
+	if(++Idle_Skip_Mismatches > VERIFY_MAX_REPORTS)
+		return;
+
+	fprintf(stderr, "idle verify: frame %lu %s loop at %06X: ran to pc %06X cycle %u, skip gives pc %06X cycle %u\n",
+		FrameCount, cpu, head, pc, odo, head, odo_skip);
+	if(Idle_Skip_Mismatches == VERIFY_MAX_REPORTS)
+		fprintf(stderr, "idle verify: further mismatches are only counted\n");
+}
+
+
+// 68000
+
+struct State_68K
+{
+	unsigned int dreg[8];
+	unsigned int areg[8];
+	unsigned int asp;
+	unsigned int sr;
+	unsigned int xflag;
+};
+
+static void Get_State_68K(State_68K *s)
+{
+	memcpy(s->dreg, main68k_context.dreg, sizeof(s->dreg));
+	memcpy(s->areg, main68k_context.areg, sizeof(s->areg));
+	s->asp = main68k_context.asp;
+	s->sr = main68k_context.sr;
+	s->xflag = main68k_context.xflag;
+}
+
+static inline unsigned int RW_68K(unsigned int adr)
+{
+	return M68K_RW(adr & 0xFFFFFF) & 0xFFFF;
+}
+
+// RAM or cartridge space, reading either has no side effect
+static int Readable_68K(unsigned int adr, int size)
+{
+	adr &= 0xFFFFFF;
+	if(size > 1 && (adr & 1))
+		return 0;
+	return adr >= 0xE00000 || adr + size <= 0x400000;
+}
+
+// Length of the extension words of a source <ea> that reads a data register, immediate data
+// (if imm), RAM or ROM, -1 for anything else. ext is the address of the extension words.
+static int Src_68K(int ea, int size, int imm, unsigned int ext)
+{
+	unsigned int adr;
+	int len;
+
+	switch(ea >> 3)
+	{
+		case 0:		// Dn
+			return 0;
+		case 2:		// (An)
+			adr = main68k_context.areg[ea & 7];
+			len = 0;
+			break;
+		case 5:		// (d16,An)
+			adr = main68k_context.areg[ea & 7] + (short)RW_68K(ext);
+			len = 2;
+			break;
+		case 7:
+			switch(ea & 7)
+			{
+				case 0:	adr = (short)RW_68K(ext); len = 2; break;					// (xxx).w
+				case 1:	adr = (RW_68K(ext) << 16) | RW_68K(ext + 2); len = 4; break;	// (xxx).l
+				case 2:	adr = ext + (short)RW_68K(ext); len = 2; break;				// (d16,PC)
+				case 4:	return imm ? (size == 4 ? 4 : 2) : -1;						// #imm
+				default: return -1;
+			}
+			break;
+		default:
+			return -1;
+	}
+
+	return Readable_68K(adr, size) ? len : -1;
+}
+
+// Length of the instruction at pc if it can be part of an idle loop, 0 if not.
+// The address registers are never written, so the addresses checked here hold for the whole loop.
+// *target is set to the destination of a branch, NO_BRANCH for anything else.
+static int Decode_68K(unsigned int pc, unsigned int *target)
+{
+	static const int Move_Size[4] = {0, 1, 4, 2};
+	unsigned int op = RW_68K(pc);
+	int size = 1 << ((op >> 6) & 3);
+	int len;
+
+	*target = NO_BRANCH;
+
+	if(op == 0x4E71)											// NOP
+		return 2;
+
+	if((op & 0xF000) == 0x6000 && (op & 0x0F00) != 0x0100)		// Bcc / BRA (not BSR)
+	{
+		if((op & 0xFF) == 0)
+		{
+			*target = (pc + 2 + (short)RW_68K(pc + 2)) & 0xFFFFFF;
+			return 4;
+		}
+		if((op & 0xFF) == 0xFF)
+			return 0;
+		*target = (pc + 2 + (signed char)op) & 0xFFFFFF;
+		return 2;
+	}
+
+	if((op & 0xFF00) == 0x4A00 && (op & 0xC0) != 0xC0)			// TST <ea>
+	{
+		len = Src_68K(op & 0x3F, size, 0, pc + 2);
+		return len < 0 ? 0 : 2 + len;
+	}
+
+	if((op & 0xFF00) == 0x0C00 && (op & 0xC0) != 0xC0)			// CMPI #imm,<ea>
+	{
+		int imm = size == 4 ? 4 : 2;
+		len = Src_68K(op & 0x3F, size, 0, pc + 2 + imm);
+		return len < 0 ? 0 : 2 + imm + len;
+	}
+
+	if(((op & 0xFF00) == 0x0000 || (op & 0xFF00) == 0x0200) && (op & 0xC0) != 0xC0 && (op & 0x38) == 0)
+		return 2 + (size == 4 ? 4 : 2);							// ORI / ANDI #imm,Dn
+
+	if((op & 0xFFC0) == 0x0800)									// BTST #n,<ea>
+	{
+		len = Src_68K(op & 0x3F, (op & 0x38) ? 1 : 4, 0, pc + 4);
+		return len < 0 ? 0 : 4 + len;
+	}
+
+	if((op & 0xF1C0) == 0x0100 && (op & 0x38) != 0x08)			// BTST Dn,<ea> (not MOVEP)
+	{
+		len = Src_68K(op & 0x3F, (op & 0x38) ? 1 : 4, 0, pc + 2);
+		return len < 0 ? 0 : 2 + len;
+	}
+
+	if((op & 0xC1C0) == 0x0000 && (op & 0x3000))					// MOVE <ea>,Dn
+	{
+		len = Src_68K(op & 0x3F, Move_Size[(op >> 12) & 3], 1, pc + 2);
+		return len < 0 ? 0 : 2 + len;
+	}
+
+	if(((op & 0xF000) == 0xB000 || (op & 0xF000) == 0xC000 || (op & 0xF000) == 0x8000)
+		&& !(op & 0x0100) && (op & 0xC0) != 0xC0)				// CMP / AND / OR <ea>,Dn
+	{
+		len = Src_68K(op & 0x3F, size, 1, pc + 2);
+		return len < 0 ? 0 : 2 + len;
+	}
+
+	return 0;
+}
+
+// Find the loop pc is in: [*head, *end) decodes as idle loop instructions
+// with a single branch at the end going back to *head
+static int Find_Loop_68K(unsigned int pc, unsigned int *head, unsigned int *end)
+{
+	unsigned int a = pc, target, t;
+	int len, n;
+
+	for(n = 0; ; n++)
+	{
+		if(n == MAX_LOOP_INSNS || a - pc >= MAX_LOOP_BYTES)
+			return 0;
+		if(!(len = Decode_68K(a, &target)))
+			return 0;
+		a += len;
+		if(target != NO_BRANCH)
+			break;
+	}
+	if(target > pc || a - target > MAX_LOOP_BYTES)
+		return 0;
+
+	// from the branch target the instructions have to line up with pc and the branch
+	for(t = target, n = 0; t < a; t += len, n++)
+	{
+		unsigned int branch;
+		if(n == MAX_LOOP_INSNS || !(len = Decode_68K(t, &branch)))
+			return 0;
+		if(branch != NO_BRANCH && t + len != a)
+			return 0;
+		if(t < pc && t + len > pc)
+			return 0;
+	}
+	if(t != a)
+		return 0;
+
+	*head = target;
+	*end = a;
+	return 1;
+}
+
+// Run the 68000 one instruction at a time, as main68k_exec(Odo) would, until it is back at head.
+// 0 if it left [head, end) or the time slice ended first.
+static int Run_To_Head_68K(unsigned int head, unsigned int end, int Odo)
+{
+	for(int n = 0; n <= MAX_LOOP_INSNS; n++)
+	{
+		unsigned int odo = main68k_readOdometer();
+		if(odo >= (unsigned int)Odo)
+			return 0;
+		main68k_exec(odo + 1);
+
+		unsigned int pc = main68k_readPC() & 0xFFFFFF;
+		if(pc == head)
+			return 1;
+		if(pc < head || pc >= end)
+			return 0;
+	}
+	return 0;
+}
+
+static void Skip_Idle_M68K(int Odo)
+{
+	unsigned int head, end, odo, period;
+	State_68K s1, s2;
+
+	if(main68k_context.interrupts[0] & 0x10)		// stopped, main68k_exec already skips to the end
+		return;
+	if(!Find_Loop_68K(main68k_readPC() & 0xFFFFFF, &head, &end))
+		return;
+
+	if(!Run_To_Head_68K(head, end, Odo))
+		return;
+	odo = main68k_readOdometer();
+	if(!Run_To_Head_68K(head, end, Odo))
+		return;
+	period = main68k_readOdometer() - odo;
+	Get_State_68K(&s1);
+	odo = main68k_readOdometer();
+	if(!Run_To_Head_68K(head, end, Odo))
+		return;
+	Get_State_68K(&s2);
+	if(main68k_readOdometer() - odo != period || memcmp(&s1, &s2, sizeof(s1)))
+		return;
+
+	odo = main68k_readOdometer();
+	if(odo >= (unsigned int)Odo)
+		return;
+	unsigned int skip = (Odo - odo - 1) / period * period;
+	if(!skip)
+		return;
+	Idle_Skipped_Cycles_M68K += skip;
+
+	if(Idle_Skip == IDLE_SKIP_VERIFY)
+	{
+		main68k_exec(odo + skip);
+		Get_State_68K(&s2);
+		unsigned int pc = main68k_readPC() & 0xFFFFFF;
+		if(pc != head || main68k_readOdometer() != odo + skip || memcmp(&s1, &s2, sizeof(s1)))
+			Report("68000", head, pc, main68k_readOdometer(), odo + skip);
+		return;
+	}
+
+	main68k_addCycles(skip);
+}
+
+void Idle_M68K_Exec(int Odo)
+{
+	PROF_SCOPE(PROF_M68K);
+
+	if(Idle_Skip && !Observed())
+		Skip_Idle_M68K(Odo);
+	if(M68K_Core == M68K_CORE_VERIFY)
+		M68K_Verify_Exec(Odo);
+	else
+		main68k_exec(Odo);
+}
+
+
+// Z80
+
+#define Z80_HALTED	0x02
+#define Z80_FAULTED	0x10
+
+// registers from AF to IM, PC included
+#define Z80_STATE_SIZE	offsetof(Z80_CONTEXT, IntVect)
+
+static inline unsigned int RB_Z80(unsigned int adr)
+{
+	return Ram_Z80[adr & 0x1FFF];
+}
+
+// Z80 RAM and its mirror
+static inline int Readable_Z80(unsigned int adr)
+{
+	return (adr & 0xFFFF) < 0x4000;
+}
+
+// Length of the instruction at pc if it can be part of an idle loop (reads Z80 RAM, writes only A and F), 0 if not.
+// *target is set to the destination of a jump, NO_BRANCH for anything else.
+static int Decode_Z80(unsigned int pc, unsigned int *target)
+{
+	unsigned int op = RB_Z80(pc);
+	unsigned int idx;
+
+	*target = NO_BRANCH;
+
+	switch(op)
+	{
+		case 0x00:										// NOP
+		case 0x07: case 0x0F: case 0x17: case 0x1F:		// RLCA / RRCA / RLA / RRA
+			return 1;
+
+		case 0x0A:										// LD A,(BC)
+			return Readable_Z80(M_Z80.BC.w.BC) ? 1 : 0;
+		case 0x1A:										// LD A,(DE)
+			return Readable_Z80(M_Z80.DE.w.DE) ? 1 : 0;
+		case 0x3A:										// LD A,(nn)
+			return Readable_Z80(RB_Z80(pc + 1) | (RB_Z80(pc + 2) << 8)) ? 3 : 0;
+
+		case 0x3E:										// LD A,n
+		case 0xC6: case 0xCE: case 0xD6: case 0xDE:		// ADD / ADC / SUB / SBC A,n
+		case 0xE6: case 0xEE: case 0xF6: case 0xFE:		// AND / XOR / OR / CP n
+			return 2;
+
+		case 0x18: case 0x20: case 0x28: case 0x30: case 0x38:	// JR (cc,)e
+			*target = (pc + 2 + (signed char)RB_Z80(pc + 1)) & 0xFFFF;
+			return 2;
+
+		case 0xC3: case 0xC2: case 0xCA: case 0xD2: case 0xDA:	// JP (cc,)nn
+		case 0xE2: case 0xEA: case 0xF2: case 0xFA:
+			*target = RB_Z80(pc + 1) | (RB_Z80(pc + 2) << 8);
+			return 3;
+
+		case 0xCB:										// BIT b,r / BIT b,(HL)
+			op = RB_Z80(pc + 1);
+			if((op & 0xC0) != 0x40)
+				return 0;
+			return (op & 7) != 6 || Readable_Z80(M_Z80.HL.w.HL) ? 2 : 0;
+
+		case 0xDD: case 0xFD:
+			idx = (op == 0xDD ? M_Z80.IX.w.IX : M_Z80.IY.w.IY) + (signed char)RB_Z80(pc + 2);
+			op = RB_Z80(pc + 1);
+			if(op == 0x7E || (op & 0xC7) == 0x86)		// LD A,(IX+d) / ALU A,(IX+d)
+				return Readable_Z80(idx) ? 3 : 0;
+			if(op == 0xCB && (RB_Z80(pc + 3) & 0xC7) == 0x46)	// BIT b,(IX+d)
+				return Readable_Z80(idx) ? 4 : 0;
+			return 0;
+	}
+
+	if((op & 0xF8) == 0x78 || (op & 0xC0) == 0x80)		// LD A,r / ALU A,r and their (HL) forms
+		return (op & 7) != 6 || Readable_Z80(M_Z80.HL.w.HL) ? 1 : 0;
+
+	return 0;
+}
+
+static int Find_Loop_Z80(unsigned int pc, unsigned int *head, unsigned int *end)
+{
+	unsigned int a = pc, target, t;
+	int len, n;
+
+	if(pc >= 0x4000)
+		return 0;
+
+	for(n = 0; ; n++)
+	{
+		if(n == MAX_LOOP_INSNS || a - pc >= MAX_LOOP_BYTES)
+			return 0;
+		if(!(len = Decode_Z80(a, &target)))
+			return 0;
+		a += len;
+		if(target != NO_BRANCH)
+			break;
+	}
+	if(target > pc || a - target > MAX_LOOP_BYTES)
+		return 0;
+
+	for(t = target, n = 0; t < a; t += len, n++)
+	{
+		unsigned int branch;
+		if(n == MAX_LOOP_INSNS || !(len = Decode_Z80(t, &branch)))
+			return 0;
+		if(branch != NO_BRANCH && t + len != a)
+			return 0;
+		if(t < pc && t + len > pc)
+			return 0;
+	}
+	if(t != a)
+		return 0;
+
+	*head = target;
+	*end = a;
+	return 1;
+}
+
+static int Run_To_Head_Z80(unsigned int head, unsigned int end, int Odo)
+{
+	for(int n = 0; n <= MAX_LOOP_INSNS; n++)
+	{
+		unsigned int odo = z80_Read_Odo(&M_Z80);
+		if(odo >= (unsigned int)Odo)
+			return 0;
+		Z80_Core_Exec(odo + 1);
+
+		unsigned int pc = z80_Get_PC(&M_Z80) & 0xFFFF;
+		if(pc == head)
+			return 1;
+		if(pc < head || pc >= end)
+			return 0;
+	}
+	return 0;
+}
+
+static void Skip_Idle_Z80(int Odo)
+{
+	unsigned int head, end, odo, period;
+	unsigned char s1[Z80_STATE_SIZE];
+
+	if(M_Z80.Status & (Z80_HALTED | Z80_FAULTED))
+		return;
+	if(!Find_Loop_Z80(z80_Get_PC(&M_Z80) & 0xFFFF, &head, &end))
+		return;
+
+	if(!Run_To_Head_Z80(head, end, Odo))
+		return;
+	odo = z80_Read_Odo(&M_Z80);
+	if(!Run_To_Head_Z80(head, end, Odo))
+		return;
+	period = z80_Read_Odo(&M_Z80) - odo;
+	memcpy(s1, &M_Z80, sizeof(s1));
+	odo = z80_Read_Odo(&M_Z80);
+	if(!Run_To_Head_Z80(head, end, Odo))
+		return;
+	if(z80_Read_Odo(&M_Z80) - odo != period || memcmp(s1, &M_Z80, sizeof(s1)))
+		return;
+
+	odo = z80_Read_Odo(&M_Z80);
+	if(odo >= (unsigned int)Odo)
+		return;
+	unsigned int skip = (Odo - odo - 1) / period * period;
+	if(!skip)
+		return;
+	Idle_Skipped_Cycles_Z80 += skip;
+
+	if(Idle_Skip == IDLE_SKIP_VERIFY)
+	{
+		Z80_Core_Exec(odo + skip);
+		unsigned int pc = z80_Get_PC(&M_Z80) & 0xFFFF;
+		if(pc != head || z80_Read_Odo(&M_Z80) != odo + skip || memcmp(s1, &M_Z80, sizeof(s1)))
+			Report("Z80", head, pc, z80_Read_Odo(&M_Z80), odo + skip);
+		return;
+	}
+
+	z80_Set_Odo(&M_Z80, odo + skip);
+}
+
+void Idle_Z80_Exec(int Odo)
+{
+	PROF_SCOPE(PROF_Z80);
+
+	if(Idle_Skip && !Observed())
+		Skip_Idle_Z80(Odo);
+	Z80_Core_Exec(Odo);
+}
+
+
+// SH2
+
+#define SH2_HALTED	0x02
+#define SH2_DISABLE	0x04
+#define SH2_FAULTED	0x10
+
+struct State_SH2
+{
+	UINT32 R[0x10];
+	STATREG SR;
+	UINT32 GBR;
+	UINT32 MACH;
+	UINT32 MACL;
+	UINT32 PR;
+	UINT32 PC;
+};
+
+static void Get_State_SH2(SH2_CONTEXT *sh2, State_SH2 *s)
+{
+	memcpy(s->R, sh2->R, sizeof(s->R));
+	s->SR = sh2->SR;
+	s->GBR = sh2->GBR;
+	s->MACH = sh2->MACH;
+	s->MACL = sh2->MACL;
+	s->PR = sh2->PR;
+	s->PC = sh2->PC;
+}
+
+// SH2_Exec runs the FRT and WDT at the end with the length of the slice it was asked for, not the
+// cycles executed. Run one instruction at a time they would fall behind, so the stepping here leaves
+// them (and the interrupts they raise) alone, and Idle_SH2_Exec gives them the cycles at the end.
+struct Timers_SH2
+{
+	UINT32 FRTCNT;
+	UINT8 FRTCSR;
+	UINT32 WDTCNT;
+	UINT8 WDTSR;
+	UINT8 WDTRST;
+	INTSTR INT;
+	UINT8 INT_QUEUE[0x20];
+};
+
+static void Exec_Untimed_SH2(SH2_CONTEXT *sh2, unsigned int odo)
+{
+	Timers_SH2 t;
+
+	t.FRTCNT = sh2->FRTCNT;
+	t.FRTCSR = sh2->FRTCSR;
+	t.WDTCNT = sh2->WDTCNT;
+	t.WDTSR = sh2->WDTSR;
+	t.WDTRST = sh2->WDTRST;
+	t.INT = sh2->INT;
+	memcpy(t.INT_QUEUE, sh2->INT_QUEUE, sizeof(t.INT_QUEUE));
+
+	SH2_Exec(sh2, odo);
+
+	sh2->FRTCNT = t.FRTCNT;
+	sh2->FRTCSR = t.FRTCSR;
+	sh2->WDTCNT = t.WDTCNT;
+	sh2->WDTSR = t.WDTSR;
+	sh2->WDTRST = t.WDTRST;
+	sh2->INT = t.INT;
+	memcpy(sh2->INT_QUEUE, t.INT_QUEUE, sizeof(t.INT_QUEUE));
+}
+
+// Run the timers for cycles without running the SH2: a halted SH2 only updates them.
+// IMask is raised so that an interrupt they raise waits for the next SH2_Exec, as it would have.
+static void Credit_Timers_SH2(SH2_CONTEXT *sh2, unsigned int cycles)
+{
+	unsigned int odo = SH2_Read_Odo(sh2);
+	UINT32 status = sh2->Status;
+	UINT8 imask = sh2->SR.IMask;
+
+	sh2->Status |= SH2_HALTED;
+	sh2->SR.IMask = 0xFF;
+	SH2_Exec(sh2, odo + cycles);
+	sh2->SR.IMask = imask;
+	sh2->Status = status;
+	SH2_Write_Odo(sh2, odo);
+}
+
+// SDRAM, cartridge ROM, boot ROM and the communication ports, memory stored big endian that reads
+// without side effects (a communication port read is still counted for -32x-sync adaptive).
+// NULL for anything else.
+static const unsigned char *Mem_SH2(SH2_CONTEXT *sh2, unsigned int adr, int size)
+{
+	if(adr & (size - 1))
+		return NULL;
+
+	switch(adr >> 24)
+	{
+		case 0x06: case 0x26:
+			return &_32X_Ram[adr & 0x3FFFF];
+		case 0x02: case 0x22:
+			return &_32X_Rom[adr & 0x3FFFFF];
+		case 0x00: case 0x20:
+			if((adr & 0xFFFFFF) < 0x400)
+				return sh2 == &M_SH2 ? &_32X_MSH2_Rom[adr & 0x3FF] : &_32X_SSH2_Rom[adr & 0x3FF];
+			if((adr & 0xFFFFF0) == 0x4020)
+				return &_32X_Comm[adr & 0xF];
+			break;
+	}
+	return NULL;
+}
+
+static inline int Readable_SH2(SH2_CONTEXT *sh2, unsigned int adr, int size)
+{
+	return Mem_SH2(sh2, adr, size) != NULL;
+}
+
+struct Insn_SH2
+{
+	unsigned int target;	// destination of a branch, NO_BRANCH for anything else
+	unsigned int addr;		// registers an address is taken from, bit n for Rn
+	unsigned int written;	// registers written
+};
+
+// 1 if op (not a branch) at pc can be part of a poll loop: it reads SDRAM, ROM or the
+// communication ports and writes nothing but general registers and T
+static int Decode_Op_SH2(SH2_CONTEXT *sh2, unsigned int pc, unsigned int op, Insn_SH2 *in)
+{
+	unsigned int n = (op >> 8) & 0xF;
+	unsigned int m = (op >> 4) & 0xF;
+	int size;
+
+	in->addr = 0;
+	in->written = 0;
+
+	switch(op >> 12)
+	{
+		case 0x0:
+			if(op == 0x0009)										// NOP
+				return 1;
+			if((op & 0xF) >= 0xC && (op & 0xF) <= 0xE)				// MOV.x @(R0,Rm),Rn
+			{
+				size = 1 << ((op & 0xF) - 0xC);
+				in->addr = (1 << 0) | (1 << m);
+				in->written = 1 << n;
+				return Readable_SH2(sh2, sh2->R[0] + sh2->R[m], size);
+			}
+			return 0;
+
+		case 0x2:
+			switch(op & 0xF)
+			{
+				case 0x8: case 0xC:									// TST / CMP/STR Rm,Rn
+					return 1;
+				case 0x9: case 0xA: case 0xB:						// AND / XOR / OR Rm,Rn
+					in->written = 1 << n;
+					return 1;
+			}
+			return 0;
+
+		case 0x3:
+			switch(op & 0xF)
+			{
+				case 0x0: case 0x2: case 0x3: case 0x6: case 0x7:	// CMP/EQ / HS / GE / HI / GT Rm,Rn
+					return 1;
+			}
+			return 0;
+
+		case 0x4:
+			switch(op & 0xFF)
+			{
+				case 0x11: case 0x15:								// CMP/PZ / CMP/PL Rn
+					return 1;
+				case 0x00: case 0x01: case 0x08: case 0x09:			// SHLL / SHLR / SHLL2 / SHLR2 Rn
+				case 0x18: case 0x19: case 0x28: case 0x29:			// SHLL8 / SHLR8 / SHLL16 / SHLR16 Rn
+					in->written = 1 << n;
+					return 1;
+			}
+			return 0;
+
+		case 0x5:													// MOV.L @(disp,Rm),Rn
+			in->addr = 1 << m;
+			in->written = 1 << n;
+			return Readable_SH2(sh2, sh2->R[m] + (op & 0xF) * 4, 4);
+
+		case 0x6:
+			switch(op & 0xF)
+			{
+				case 0x0: case 0x1: case 0x2:						// MOV.x @Rm,Rn
+					in->addr = 1 << m;
+					in->written = 1 << n;
+					return Readable_SH2(sh2, sh2->R[m], 1 << (op & 3));
+				case 0x3: case 0x7: case 0x8: case 0x9:				// MOV / NOT / SWAP.B / SWAP.W Rm,Rn
+				case 0xC: case 0xD: case 0xE: case 0xF:				// EXTU / EXTS Rm,Rn
+					in->written = 1 << n;
+					return 1;
+			}
+			return 0;
+
+		case 0x8:
+			switch(n)
+			{
+				case 0x4: case 0x5:									// MOV.B / MOV.W @(disp,Rm),R0
+					size = n - 3;
+					in->addr = 1 << m;
+					in->written = 1 << 0;
+					return Readable_SH2(sh2, sh2->R[m] + (op & 0xF) * size, size);
+				case 0x8:											// CMP/EQ #imm,R0
+					return 1;
+			}
+			return 0;
+
+		case 0x9:													// MOV.W @(disp,PC),Rn
+			in->written = 1 << n;
+			return Readable_SH2(sh2, pc + 4 + (op & 0xFF) * 2, 2);
+
+		case 0xC:
+			switch(n)
+			{
+				case 0x4: case 0x5: case 0x6:						// MOV.x @(disp,GBR),R0
+					size = 1 << (n - 4);
+					in->written = 1 << 0;
+					return Readable_SH2(sh2, sh2->GBR + (op & 0xFF) * size, size);
+				case 0x8:											// TST #imm,R0
+					return 1;
+				case 0x9: case 0xA: case 0xB:						// AND / XOR / OR #imm,R0
+					in->written = 1 << 0;
+					return 1;
+			}
+			return 0;
+
+		case 0xD:													// MOV.L @(disp,PC),Rn
+			in->written = 1 << n;
+			return Readable_SH2(sh2, ((pc + 4) & ~3) + (op & 0xFF) * 4, 4);
+
+		case 0xE:													// MOV #imm,Rn
+			in->written = 1 << n;
+			return 1;
+	}
+
+	return 0;
+}
+
+static int Fetch_SH2(SH2_CONTEXT *sh2, unsigned int pc, unsigned int *op)
+{
+	const unsigned char *p = Mem_SH2(sh2, pc, 2);
+
+	if(!p)
+		return 0;
+	*op = (p[0] << 8) | p[1];
+	return 1;
+}
+
+// Length of the instruction at pc if it can be part of a poll loop, 0 if not.
+// A delayed branch is taken together with its delay slot (length 4), as SH2_Exec runs them.
+static int Decode_SH2(SH2_CONTEXT *sh2, unsigned int pc, Insn_SH2 *in)
+{
+	unsigned int op;
+	Insn_SH2 slot;
+
+	in->target = NO_BRANCH;
+	if(!Fetch_SH2(sh2, pc, &op))
+		return 0;
+
+	switch(op & 0xFF00)
+	{
+		case 0x8900: case 0x8B00:									// BT / BF
+			in->addr = 0;
+			in->written = 0;
+			in->target = pc + 4 + (signed char)op * 2;
+			return 2;
+
+		case 0x8D00: case 0x8F00:									// BT/S / BF/S
+			in->target = pc + 4 + (signed char)op * 2;
+			break;
+
+		default:
+			if((op & 0xF000) != 0xA000)
+				return Decode_Op_SH2(sh2, pc, op, in) ? 2 : 0;
+			in->target = pc + 4 + ((int)(op << 20) >> 19);			// BRA
+			break;
+	}
+
+	if(!Fetch_SH2(sh2, pc + 2, &op) || !Decode_Op_SH2(sh2, pc + 2, op, &slot))
+		return 0;
+	in->addr = slot.addr;
+	in->written = slot.written;
+	return 4;
+}
+
+// As Find_Loop_68K. The registers the loop takes addresses from must not be written in it,
+// so the addresses checked by Decode_SH2 hold for the whole loop.
+static int Find_Loop_SH2(SH2_CONTEXT *sh2, unsigned int pc, unsigned int *head, unsigned int *end)
+{
+	unsigned int a = pc, t, addr = 0, written = 0;
+	Insn_SH2 in;
+	int len, n;
+
+	for(n = 0; ; n++)
+	{
+		if(n == MAX_LOOP_INSNS || a - pc >= MAX_LOOP_BYTES)
+			return 0;
+		if(!(len = Decode_SH2(sh2, a, &in)))
+			return 0;
+		a += len;
+		if(in.target != NO_BRANCH)
+			break;
+	}
+	if(in.target > pc || a - in.target > MAX_LOOP_BYTES)
+		return 0;
+
+	for(t = in.target, n = 0; t < a; t += len, n++)
+	{
+		Insn_SH2 i;
+		if(n == MAX_LOOP_INSNS || !(len = Decode_SH2(sh2, t, &i)))
+			return 0;
+		if(i.target != NO_BRANCH && t + len != a)
+			return 0;
+		if(t < pc && t + len > pc)
+			return 0;
+		addr |= i.addr;
+		written |= i.written;
+	}
+	if(t != a || (addr & written))
+		return 0;
+
+	*head = in.target;
+	*end = a;
+	return 1;
+}
+
+// SH2_Get_PC is the address of the next instruction + 4
+static inline unsigned int PC_SH2(SH2_CONTEXT *sh2)
+{
+	return SH2_Get_PC(sh2) - 4;
+}
+
+static int Run_To_Head_SH2(SH2_CONTEXT *sh2, unsigned int head, unsigned int end, int Odo)
+{
+	for(int n = 0; n <= MAX_LOOP_INSNS; n++)
+	{
+		unsigned int odo = SH2_Read_Odo(sh2);
+		if(odo >= (unsigned int)Odo)
+			return 0;
+		Exec_Untimed_SH2(sh2, odo + 1);
+
+		unsigned int pc = PC_SH2(sh2);
+		if(pc == head)
+			return 1;
+		if(pc < head || pc >= end)
+			return 0;
+	}
+	return 0;
+}
+
+static void Skip_Idle_SH2(SH2_CONTEXT *sh2, int Odo)
+{
+	unsigned int head, end, odo, period;
+	State_SH2 s1, s2;
+
+	if(sh2->Status & (SH2_HALTED | SH2_DISABLE | SH2_FAULTED))
+		return;
+	if(sh2->INT.Prio > sh2->SR.IMask)			// SH2_Exec takes the interrupt first
+		return;
+	if((sh2->WDTSR & 0x60) == 0x60)				// watchdog mode, an overflow can reset the SH2
+		return;
+	if(!Find_Loop_SH2(sh2, PC_SH2(sh2), &head, &end))
+		return;
+
+	if(!Run_To_Head_SH2(sh2, head, end, Odo))
+		return;
+	odo = SH2_Read_Odo(sh2);
+	if(!Run_To_Head_SH2(sh2, head, end, Odo))
+		return;
+	period = SH2_Read_Odo(sh2) - odo;
+	Get_State_SH2(sh2, &s1);
+	odo = SH2_Read_Odo(sh2);
+	if(!Run_To_Head_SH2(sh2, head, end, Odo))
+		return;
+	Get_State_SH2(sh2, &s2);
+	if(SH2_Read_Odo(sh2) - odo != period || memcmp(&s1, &s2, sizeof(s1)))
+		return;
+
+	odo = SH2_Read_Odo(sh2);
+	if(odo >= (unsigned int)Odo)
+		return;
+	unsigned int skip = (Odo - odo - 1) / period * period;
+	if(!skip)
+		return;
+	Idle_Skipped_Cycles_SH2 += skip;
+
+	if(Idle_Skip == IDLE_SKIP_VERIFY)
+	{
+		Exec_Untimed_SH2(sh2, odo + skip);
+		Get_State_SH2(sh2, &s2);
+		unsigned int pc = PC_SH2(sh2);
+		if(pc != head || SH2_Read_Odo(sh2) != odo + skip || memcmp(&s1, &s2, sizeof(s1)))
+			Report(sh2 == &M_SH2 ? "MSH2" : "SSH2", head, pc, SH2_Read_Odo(sh2), odo + skip);
+		return;
+	}
+
+	SH2_Write_Odo(sh2, odo + skip);
+}
+
+void Idle_SH2_Exec(SH2_CONTEXT *sh2, int Odo)
+{
+	PROF_SCOPE(PROF_SH2);
+	unsigned int start = SH2_Read_Odo(sh2), odo, owed = 0;
+
+	if(Idle_Skip && !Observed())
+	{
+		Skip_Idle_SH2(sh2, Odo);
+
+		// the timers are owed what one SH2_Exec(sh2, Odo) would have given them minus what the
+		// SH2_Exec below gives
+		odo = SH2_Read_Odo(sh2);
+		if(odo != start)
+			owed = (odo < (unsigned int)Odo ? odo : (unsigned int)Odo) - start;
+	}
+
+	SH2_Exec(sh2, Odo);
+	if(owed)
+		Credit_Timers_SH2(sh2, owed);
+}
@@ -0,0 +1,23 @@
+#ifndef IDLE_LOOP_H
+#define IDLE_LOOP_H
+
+#include "SH2.h"
+
+// Idle loop skipping for the Genesis 68000 and Z80 and the 32X SH2s (idle_loop.cpp)
+enum {
+	IDLE_SKIP_OFF = 0,
+	IDLE_SKIP_ON,		// skip the iterations of a polling loop that can't end before the time slice does
+	IDLE_SKIP_VERIFY,	// find the same loops but run them, report when the CPU doesn't end up where the skip would put it
+};
+extern int Idle_Skip;
+extern int Idle_Skip_Mismatches;
+extern unsigned int Idle_Skipped_Cycles_M68K;
+extern unsigned int Idle_Skipped_Cycles_Z80;
+extern unsigned int Idle_Skipped_Cycles_SH2;
+
+// main68k_exec / z80_Exec(&M_Z80) / SH2_Exec with idle loop skipping when Idle_Skip is set
+void Idle_M68K_Exec(int Odo);
+void Idle_Z80_Exec(int Odo);
+void Idle_SH2_Exec(SH2_CONTEXT *sh2, int Odo);
+
+#endif
@@ -13,6 +13,9 @@
 #include "io.h"
 #include "ym2612.h"
 #include "resource.h"
+#include "ram_history.h"
+#include "tracer.h"
+#include "frame_prof.h"
 #include <assert.h>
 #include <vector>
 #include <map>
@@ -25,6 +28,9 @@
 extern int (*Update_Frame)();
 extern int (*Update_Frame_Fast)();
 extern unsigned int ReadValueAtHardwareAddress(unsigned int address, unsigned int size);
+extern unsigned int ReadBytesAtHardwareAddress(unsigned int address, unsigned char* dst, unsigned int length);
+extern unsigned int HardwareAddressSpan(unsigned int address);
+extern void CopyFromSoftwareAddress(unsigned char* dst, const unsigned char* src, unsigned int length, int byteSwapped);
 extern bool ReadCellAtVDPAddress(unsigned short address, unsigned char *cell);
 extern bool ReadVDPPaletteLine(unsigned short line, unsigned short *pal);
 extern bool WriteCellToVDPAddress(unsigned short address, unsigned char *cell);
@@ -2049,6 +2055,396 @@ DEFINE_LUA_FUNCTION(memory_readbyterange, "address,length")
 
 	return 1;
 }
+// byte buffers are userdata holding a plain copy of some emulated memory,
+// in hardware (big-endian) byte order, for scripts that need to look at large ranges every frame
+// without building a Lua table with one entry per byte.
+// they can be read as strings, sliced, hashed, and compared against each other natively.
+static const char* byteBufferMetatableName = "gens.bytebuffer";
+
+struct LuaByteBuffer
+{
+	unsigned int length;
+	unsigned char data [1]; // actually length bytes
+};
+
+static unsigned char* NewByteBuffer(lua_State* L, unsigned int length)
+{
+	LuaByteBuffer* buffer = (LuaByteBuffer*)lua_newuserdata(L, sizeof(LuaByteBuffer) + length);
+	buffer->length = length;
+	luaL_getmetatable(L, byteBufferMetatableName);
+	lua_setmetatable(L, -2);
+	return buffer->data;
+}
+
+// accepts either a byte buffer or a string
+static const unsigned char* CheckByteData(lua_State* L, int idx, unsigned int& length)
+{
+	if(lua_type(L,idx) == LUA_TSTRING)
+	{
+		size_t len;
+		const char* str = lua_tolstring(L,idx,&len);
+		length = (unsigned int)len;
+		return (const unsigned char*)str;
+	}
+	LuaByteBuffer* buffer = (LuaByteBuffer*)luaL_checkudata(L, idx, byteBufferMetatableName);
+	length = buffer->length;
+	return buffer->data;
+}
+
+// converts 1-based, possibly negative [i,j] arguments to a 0-based [start,end) range, like string.sub does
+static void GetByteRangeArgs(lua_State* L, int idx, unsigned int length, unsigned int& start, unsigned int& end)
+{
+	int i = luaL_optinteger(L, idx, 1);
+	int j = luaL_optinteger(L, idx+1, -1);
+	if(i < 0) i += length + 1;
+	if(j < 0) j += length + 1;
+	if(i < 1) i = 1;
+	if(j > (int)length) j = length;
+	start = i - 1;
+	end = (j >= i) ? j : start;
+}
+
+// memory.readbytes(address, length)
+// returns a byte buffer with the bytes at the given address range, in hardware byte order.
+// unlike memory.readbyterange, invalid addresses read as 0 instead of nil.
+// the range stops at the end of the address space it starts in (68000 or 32X SDRAM).
+DEFINE_LUA_FUNCTION(memory_readbytes, "address,length")
+{
+	unsigned int address = luaL_checkinteger(L,1);
+	int length = luaL_checkinteger(L,2);
+	if(length < 0)
+	{
+		address += length;
+		length = -length;
+	}
+	length = (int)min((unsigned int)length, HardwareAddressSpan(address));
+	unsigned char* data = NewByteBuffer(L, length);
+	ReadBytesAtHardwareAddress(address, data, length);
+	return 1;
+}
+
+// vdp.readvram([address[, length]])
+// returns a byte buffer with the contents of VRAM (by default all 64 KB), in hardware byte order.
+DEFINE_LUA_FUNCTION(vdp_readvram, "[address[,length]]")
+{
+	unsigned int address = luaL_optinteger(L,1,0) & 0xFFFF;
+	int length = luaL_optinteger(L,2,0x10000 - address);
+	length = (int)min((unsigned int)max(length, 0), 0x10000 - address);
+	unsigned char* data = NewByteBuffer(L, length);
+	CopyFromSoftwareAddress(data, VRam + address, length, true);
+	return 1;
+}
+
+// buffer:len()
+DEFINE_LUA_FUNCTION(bytebuffer_len, "buffer")
+{
+	unsigned int length;
+	CheckByteData(L, 1, length);
+	lua_pushinteger(L, length);
+	return 1;
+}
+
+// buffer:string([i[, j]])
+// returns the bytes from i to j (1-based, inclusive) as a Lua string
+DEFINE_LUA_FUNCTION(bytebuffer_string, "buffer[,i[,j]]")
+{
+	unsigned int length, start, end;
+	const unsigned char* data = CheckByteData(L, 1, length);
+	GetByteRangeArgs(L, 2, length, start, end);
+	lua_pushlstring(L, (const char*)data + start, end - start);
+	return 1;
+}
+
+// buffer:sub([i[, j]])
+// returns a new byte buffer with the bytes from i to j (1-based, inclusive)
+DEFINE_LUA_FUNCTION(bytebuffer_sub, "buffer[,i[,j]]")
+{
+	unsigned int length, start, end;
+	const unsigned char* data = CheckByteData(L, 1, length);
+	GetByteRangeArgs(L, 2, length, start, end);
+	memcpy(NewByteBuffer(L, end - start), data + start, end - start);
+	return 1;
+}
+
+// buffer:byte([i[, j]])
+// returns the byte values from i to j (default j = i), like string.byte
+DEFINE_LUA_FUNCTION(bytebuffer_byte, "buffer[,i[,j]]")
+{
+	unsigned int length;
+	const unsigned char* data = CheckByteData(L, 1, length);
+	int i = luaL_optinteger(L, 2, 1);
+	if(i < 0) i += length + 1;
+	int j = luaL_optinteger(L, 3, i);
+	if(j < 0) j += length + 1;
+	if(i < 1) i = 1;
+	if(j > (int)length) j = length;
+	if(i > j)
+		return 0;
+	int n = j - i + 1;
+	luaL_checkstack(L, n, "byte buffer slice too large");
+	for(int k = i - 1; k < j; k++)
+		lua_pushinteger(L, data[k]);
+	return n;
+}
+
+// buffer:word(i), buffer:dword(i)
+// returns the big-endian unsigned value starting at byte i (1-based)
+static int bytebuffer_readvalue(lua_State* L, unsigned int size)
+{
+	unsigned int length;
+	const unsigned char* data = CheckByteData(L, 1, length);
+	int i = luaL_checkinteger(L, 2);
+	if(i < 1 || (unsigned int)i + size - 1 > length)
+		return 0;
+	unsigned int value = 0;
+	for(unsigned int k = 0; k < size; k++)
+		value = (value << 8) | data[i - 1 + k];
+	lua_pushnumber(L, value);
+	return 1;
+}
+DEFINE_LUA_FUNCTION(bytebuffer_word, "buffer,i")
+{
+	return bytebuffer_readvalue(L, 2);
+}
+DEFINE_LUA_FUNCTION(bytebuffer_dword, "buffer,i")
+{
+	return bytebuffer_readvalue(L, 4);
+}
+
+// buffer:hash()
+// returns a 32-bit FNV-1a hash of the contents
+DEFINE_LUA_FUNCTION(bytebuffer_hash, "buffer")
+{
+	unsigned int length;
+	const unsigned char* data = CheckByteData(L, 1, length);
+	unsigned int hash = 2166136261u;
+	for(unsigned int i = 0; i < length; i++)
+		hash = (hash ^ data[i]) * 16777619u;
+	lua_pushnumber(L, hash);
+	return 1;
+}
+
+// buffer:firstdiff(other)
+// returns the index of the first byte that differs from other (a byte buffer or string),
+// or nil if they are identical. if one is a prefix of the other, returns the index just past the shorter one.
+DEFINE_LUA_FUNCTION(bytebuffer_firstdiff, "buffer,other")
+{
+	unsigned int lengthA, lengthB;
+	const unsigned char* a = CheckByteData(L, 1, lengthA);
+	const unsigned char* b = CheckByteData(L, 2, lengthB);
+	unsigned int length = min(lengthA, lengthB);
+	unsigned int i = 0;
+	while(i + 4 <= length && !memcmp(a+i, b+i, 4))
+		i += 4;
+	while(i < length && a[i] == b[i])
+		i++;
+	if(i == length && lengthA == lengthB)
+		return 0;
+	lua_pushinteger(L, i + 1);
+	return 1;
+}
+
+// buffer:diff(other[, maxcount])
+// returns an array of the indices of bytes that differ from other (a byte buffer or string),
+// and the total number of differing bytes (which may be larger than the array if maxcount is given).
+// only the overlapping part of the two is compared.
+DEFINE_LUA_FUNCTION(bytebuffer_diff, "buffer,other[,maxcount]")
+{
+	unsigned int lengthA, lengthB;
+	const unsigned char* a = CheckByteData(L, 1, lengthA);
+	const unsigned char* b = CheckByteData(L, 2, lengthB);
+	unsigned int maxCount = luaL_optinteger(L, 3, 0x7FFFFFFF);
+	unsigned int length = min(lengthA, lengthB);
+
+	lua_newtable(L);
+	unsigned int count = 0;
+	unsigned int i = 0;
+	while(i < length)
+	{
+		// skip identical stretches a word at a time
+		if(!(i & 3) && i + 4 <= length && !memcmp(a+i, b+i, 4))
+		{
+			i += 4;
+			continue;
+		}
+		if(a[i] != b[i])
+		{
+			if(count < maxCount)
+			{
+				lua_pushinteger(L, i + 1);
+				lua_rawseti(L, -2, count + 1);
+			}
+			count++;
+		}
+		i++;
+	}
+	lua_pushinteger(L, count);
+	return 2;
+}
+
+static int bytebuffer_eq(lua_State* L)
+{
+	unsigned int lengthA, lengthB;
+	const unsigned char* a = CheckByteData(L, 1, lengthA);
+	const unsigned char* b = CheckByteData(L, 2, lengthB);
+	lua_pushboolean(L, lengthA == lengthB && !memcmp(a, b, lengthA));
+	return 1;
+}
+
+static int bytebuffer_tostring(lua_State* L)
+{
+	unsigned int length;
+	CheckByteData(L, 1, length);
+	lua_pushfstring(L, "bytebuffer: %d bytes", length);
+	return 1;
+}
+
+static const struct luaL_reg bytebuffer_methods [] =
+{
+	{"len", bytebuffer_len},
+	{"string", bytebuffer_string},
+	{"sub", bytebuffer_sub},
+	{"byte", bytebuffer_byte},
+	{"word", bytebuffer_word},
+	{"dword", bytebuffer_dword},
+	{"hash", bytebuffer_hash},
+	{"firstdiff", bytebuffer_firstdiff},
+	{"diff", bytebuffer_diff},
+	{NULL, NULL}
+};
+
+static void registerByteBuffer(lua_State* L)
+{
+	luaL_newmetatable(L, byteBufferMetatableName);
+	lua_newtable(L);
+	luaL_register(L, NULL, bytebuffer_methods);
+	lua_setfield(L, -2, "__index");
+	lua_pushcfunction(L, bytebuffer_len);
+	lua_setfield(L, -2, "__len");
+	lua_pushcfunction(L, bytebuffer_eq);
+	lua_setfield(L, -2, "__eq");
+	lua_pushcfunction(L, bytebuffer_tostring);
+	lua_setfield(L, -2, "__tostring");
+	lua_pop(L, 1);
+}
+
+// ramhistory.start([address[, size]])
+// starts recording the given range of RAM (by default the 64 KB of 68000 RAM) at the end of every frame,
+// discarding any previous recording
+DEFINE_LUA_FUNCTION(ramhistory_start, "[address[,size]]")
+{
+	unsigned int address = luaL_optinteger(L,1,0xFF0000);
+	unsigned int size = luaL_optinteger(L,2,0x10000);
+	if(!RamHistory_Start(address, size))
+		luaL_error(L, "invalid range for ramhistory.start");
+	return 0;
+}
+DEFINE_LUA_FUNCTION(ramhistory_stop, "")
+{
+	RamHistory_Stop();
+	return 0;
+}
+DEFINE_LUA_FUNCTION(ramhistory_clear, "")
+{
+	RamHistory_Clear();
+	return 0;
+}
+// count, firstframe, lastframe = ramhistory.frames()
+DEFINE_LUA_FUNCTION(ramhistory_frames, "")
+{
+	int firstFrame, lastFrame;
+	int count = RamHistory_GetFrames(&firstFrame, &lastFrame);
+	lua_pushinteger(L, count);
+	lua_pushinteger(L, firstFrame);
+	lua_pushinteger(L, lastFrame);
+	return 3;
+}
+// ramhistory.value(address, frame[, size[, signed]])
+// returns the value the item had at the end of a recorded frame, or nil
+DEFINE_LUA_FUNCTION(ramhistory_value, "address,frame[,size[,signed]]")
+{
+	unsigned int address = luaL_checkinteger(L,1);
+	int frame = luaL_checkinteger(L,2);
+	int size = 1;
+	if(!lua_isnoneornil(L,3))
+	{
+		size = lua_isnumber(L,3) ? lua_tointeger(L,3) : RamHistory_SizeFromName(luaL_checkstring(L,3));
+		if(size != 1 && size != 2 && size != 4)
+			luaL_error(L, "size must be 1, 2, 4, \"b\", \"w\" or \"d\"");
+	}
+	int isSigned = lua_toboolean(L,4);
+	int value;
+	if(!RamHistory_GetValue(address, frame, size, isSigned, &value))
+		return 0;
+	if(size == 4 && !isSigned)
+		lua_pushnumber(L, (unsigned int)value); // out of range for pushinteger
+	else
+		lua_pushinteger(L, value);
+	return 1;
+}
+// ramhistory.search(query)
+// query is either a table {op=, size=, signed=, value=, frames={...}, exact=, from=, to=}
+// or the same thing as a string "op=increased,size=w,frames=120;340;560,exact=1"
+// returns an array of the matching addresses
+DEFINE_LUA_FUNCTION(ramhistory_search, "query")
+{
+	RamHistoryQuery query;
+	if(lua_type(L,1) == LUA_TSTRING)
+	{
+		const char* error = RamHistory_ParseQuery(lua_tostring(L,1), query);
+		if(error)
+			luaL_error(L, "bad ramhistory query: %s", error);
+	}
+	else
+	{
+		luaL_checktype(L, 1, LUA_TTABLE);
+		RamHistory_ParseQuery("op=changed", query); // defaults
+
+		lua_getfield(L, 1, "op");
+		if((query.op = RamHistory_OpFromName(luaL_optstring(L, -1, ""))) < 0)
+			luaL_error(L, "bad ramhistory query: unknown op");
+		lua_getfield(L, 1, "size");
+		if(!lua_isnil(L, -1))
+		{
+			query.size = lua_isnumber(L, -1) ? lua_tointeger(L, -1) : RamHistory_SizeFromName(lua_tostring(L, -1));
+			if(query.size != 1 && query.size != 2 && query.size != 4)
+				luaL_error(L, "bad ramhistory query: size must be 1, 2, 4, \"b\", \"w\" or \"d\"");
+		}
+		lua_getfield(L, 1, "signed");
+		query.isSigned = lua_toboolean(L, -1);
+		lua_getfield(L, 1, "value");
+		lua_Number value = luaL_optnumber(L, -1, 0);
+		query.value = (value < 0) ? (int)value : (int)(unsigned int)value; // allow unsigned dwords
+		lua_getfield(L, 1, "exact");
+		query.exact = lua_toboolean(L, -1);
+		lua_getfield(L, 1, "from");
+		query.firstFrame = luaL_optinteger(L, -1, -1);
+		lua_getfield(L, 1, "to");
+		query.lastFrame = luaL_optinteger(L, -1, -1);
+		lua_getfield(L, 1, "frames");
+		if(lua_istable(L, -1))
+		{
+			int n = lua_objlen(L, -1);
+			for(int i = 1; i <= n; i++)
+			{
+				lua_rawgeti(L, -1, i);
+				query.frames.push_back(lua_tointeger(L, -1));
+				lua_pop(L, 1);
+			}
+		}
+		lua_settop(L, 1);
+	}
+
+	std::vector<unsigned int> results = RamHistory_Search(query);
+	lua_createtable(L, results.size(), 0);
+	for(unsigned int i = 0; i < results.size(); i++)
+	{
+		lua_pushinteger(L, results[i]);
+		lua_rawseti(L, -2, i+1);
+	}
+	return 1;
+}
+
 DEFINE_LUA_FUNCTION(memory_writebyterange, "address,[length,]data")
 {
 	int address = luaL_checkinteger(L,1);
@@ -2242,6 +2638,25 @@ DEFINE_LUA_FUNCTION(memory_setregister, "cpu_dot_registername_string,value")
 }
 
 
+static const char* rawSnapshotMetatableName = "gens.rawsnapshot";
+
+// anonymous savestates created with savestate.create("raw") hold a raw snapshot
+// (see Save_Snapshot_To_Buffer) instead of a portable savestate, and are tagged with this metatable
+static bool IsRawSnapshot(lua_State* L, int idx)
+{
+	if(!lua_getmetatable(L, idx))
+		return false;
+	luaL_getmetatable(L, rawSnapshotMetatableName);
+	bool isRaw = lua_rawequal(L, -1, -2) != 0;
+	lua_pop(L, 2);
+	return isRaw;
+}
+
+// savestate.create([location])
+// returns a savestate object for the given savestate file number,
+// or a new in-memory/anonymous savestate if no location is given.
+// if location is "raw" then the anonymous savestate uses the raw snapshot format,
+// which is much faster to save and load but is only valid until the emulator closes or the game changes
 DEFINE_LUA_FUNCTION(state_create, "[location]")
 {
 	if(lua_isnumber(L,1))
@@ -2252,6 +2667,19 @@ DEFINE_LUA_FUNCTION(state_create, "[location]")
 		return 1;
 	}
 
+	if(lua_type(L,1) == LUA_TSTRING && !stricmp(lua_tostring(L,1), "raw"))
+	{
+		int len = Get_Snapshot_Length();
+		if (!Game)
+			len += max(SEGACD_LENGTH_EX, G32X_LENGTH_EX);
+
+		unsigned char* snapshotBuffer = (unsigned char*)lua_newuserdata(L, len + 16); // 16 is for performance alignment reasons
+		snapshotBuffer[((16 - (int)snapshotBuffer) & 15)] = 0;
+		luaL_newmetatable(L, rawSnapshotMetatableName);
+		lua_setmetatable(L, -2);
+		return 1;
+	}
+
 	int len = GENESIS_STATE_LENGTH;
 	if (SegaCD_Started) len += SEGACD_LENGTH_EX;
 	if (_32X_Started) len += G32X_LENGTH_EX;
@@ -2304,7 +2732,14 @@ DEFINE_LUA_FUNCTION(state_save, "location[,option]")
 			if(stateBuffer)
 			{
 				stateBuffer += ((16 - (int)stateBuffer) & 15); // for performance alignment reasons
-				Save_State_To_Buffer(stateBuffer);
+				if(IsRawSnapshot(L,1))
+				{
+					if((int)lua_objlen(L,1) - 16 < Get_Snapshot_Length())
+						luaL_error(L, "raw savestate was created for a different system");
+					Save_Snapshot_To_Buffer(stateBuffer);
+				}
+				else
+					Save_State_To_Buffer(stateBuffer);
 			}
 		}	return 0;
 	}
@@ -2354,10 +2789,12 @@ DEFINE_LUA_FUNCTION(state_load, "location[,option]")
 			if(stateBuffer)
 			{
 				stateBuffer += ((16 - (int)stateBuffer) & 15); // for performance alignment reasons
-				if(stateBuffer[0])
-					Load_State_From_Buffer(stateBuffer);
-				else // the first byte of a valid savestate is never 0
+				if(!stateBuffer[0]) // the first byte of a valid savestate is never 0
 					luaL_error(L, "attempted to load an anonymous savestate before saving it");
+				else if(!IsRawSnapshot(L,1))
+					Load_State_From_Buffer(stateBuffer);
+				else if(!Load_Snapshot_From_Buffer(stateBuffer))
+					luaL_error(L, "raw savestate was saved from a different system");
 			}
 		}	return 0;
 	}
@@ -4028,6 +4465,7 @@ static const struct luaL_reg memorylib [] =
 	{"readdword", memory_readdword},
 	{"readdwordsigned", memory_readdwordsigned},
 	{"readbyterange", memory_readbyterange},
+	{"readbytes", memory_readbytes},
 	{"writebyte", memory_writebyte},
 	{"writeword", memory_writeword},
 	{"writedword", memory_writedword},
@@ -4148,6 +4586,17 @@ static const struct luaL_reg vdplib [] =
 	{"writecell", vdp_writecell},
 	{"readpalette", vdp_readpalette},
 	{"writepalette", vdp_writepalette},
+	{"readvram", vdp_readvram},
+	{NULL, NULL}
+};
+static const struct luaL_reg ramhistorylib [] =
+{
+	{"start", ramhistory_start},
+	{"stop", ramhistory_stop},
+	{"clear", ramhistory_clear},
+	{"frames", ramhistory_frames},
+	{"value", ramhistory_value},
+	{"search", ramhistory_search},
 	{NULL, NULL}
 };
 
@@ -4310,9 +4759,11 @@ void registerLibs(lua_State* L)
 	luaL_register(L, "sound", soundlib);
 	luaL_register(L, "bit", bit_funcs); // LuaBitOp library
 	luaL_register(L, "vdp", vdplib);
+	luaL_register(L, "ramhistory", ramhistorylib);
 	luaL_register(L, "tile", tilelib);
 	luaL_register(L, "palette", pallib);
 	luaL_register(L, "pal", pallib);
+	registerByteBuffer(L);
 	lua_settop(L, 0); // clean the stack, because each call to luaL_register leaves a table on top
 	
 	// register a few utility functions outside of libraries (in the global namespace)
@@ -4898,6 +5349,7 @@ static void CalculateMemHookRegions(LuaMemHookType hookType)
 		++iter;
 	}
 	hookedRegions[hookType].Calculate(hookedBytes);
+	Update_Hook_Enabled();
 }
 
 
@@ -4969,10 +5421,17 @@ void CallRegisteredLuaMemHook(unsigned int address, int size, unsigned int value
 	}
 }
 
+bool AnyRegisteredLuaMemHook(LuaMemHookType hookType)
+{
+	return hookedRegions[hookType].NotEmpty() != 0;
+}
+
 
 
 void CallRegisteredLuaFunctions(LuaCallID calltype)
 {
+	PROF_SCOPE(PROF_LUA);
+
 	assert((unsigned int)calltype < (unsigned int)LUACALL_COUNT);
 	const char* idstring = luaCallIDStrings[calltype];
 
@@ -51,6 +51,7 @@ enum LuaMemHookType
 	LUAMEMHOOK_COUNT
 };
 void CallRegisteredLuaMemHook(unsigned int address, int size, unsigned int value, LuaMemHookType hookType);
+bool AnyRegisteredLuaMemHook(LuaMemHookType hookType); // a script hooks some address for this type of access
 
 struct LuaSaveData
 {
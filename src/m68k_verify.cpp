@@ -0,0 +1,223 @@
+// Lockstep check of the C++ 68000 core (Starscream -cpp output) against main68k.asm
+// Before each instruction the asm context is copied to the C++ core, which runs the instruction on
+// a shadow of the memory: ROM, RAM and anything else the fetch map covers are read from the emulator,
+// writes are only logged. Then the asm runs the same instruction for real and the registers, cycle
+// count and RAM writes are compared. Instructions that touch I/O or take an interrupt are only run by
+// the asm, since the shadow can't give the C++ core the same values without the side effects.
+
+#include <stdio.h>
+#include <string.h>
+#include "m68k_verify.h"
+#include "Mem_M68k.h"
+#include "Star_68k.h"
+
+extern unsigned long FrameCount;
+
+int M68K_Core = M68K_CORE_ASM;
+int M68K_Verify_Mismatches = 0;
+
+#define VERIFY_MAX_REPORTS 32
+#define SHADOW_MAX_WRITES 128
+
+static unsigned int Shadow_IO;				// the instruction read or wrote something the shadow doesn't have
+static unsigned int Shadow_Writes;
+static struct { unsigned short Adr; unsigned char Data; } Shadow_Write[SHADOW_MAX_WRITES];
+
+static unsigned int Verify_Steps, Verify_Skipped;
+
+static unsigned int Shadow_RB(unsigned int adr)
+{
+	const struct STARSCREAM_PROGRAMREGION *r;
+	int i;
+
+	adr &= 0xFFFFFF;
+	if(adr >= 0xE00000)
+	{
+		for(i = Shadow_Writes - 1; i >= 0; i--)
+			if(Shadow_Write[i].Adr == (adr & 0xFFFF))
+				return Shadow_Write[i].Data;
+		return Ram_68k[(adr & 0xFFFF) ^ 1];
+	}
+
+	if(!(SRAM_ON && (int)adr >= SRAM_Start && (int)adr <= SRAM_End))
+	{
+		for(r = main68k_context.fetch; r->lowaddr != 0xFFFFFFFF; r++)
+			if(adr >= r->lowaddr && adr <= r->highaddr)
+				return *(unsigned short *)(r->offset + (adr & ~1)) >> ((adr & 1) ? 0 : 8) & 0xFF;
+	}
+
+	Shadow_IO = 1;
+	return 0;
+}
+
+static unsigned char Shadow_Read_Byte(unsigned int adr)
+{
+	return (unsigned char)Shadow_RB(adr);
+}
+
+static unsigned short Shadow_Read_Word(unsigned int adr)
+{
+	return (unsigned short)(Shadow_RB(adr) << 8 | Shadow_RB(adr + 1));
+}
+
+static void Shadow_Write_Byte(unsigned int adr, unsigned char data)
+{
+	adr &= 0xFFFFFF;
+	if(adr < 0xE00000 || Shadow_Writes == SHADOW_MAX_WRITES)
+	{
+		Shadow_IO = 1;
+		return;
+	}
+	Shadow_Write[Shadow_Writes].Adr = (unsigned short)adr;
+	Shadow_Write[Shadow_Writes].Data = data;
+	Shadow_Writes++;
+}
+
+static void Shadow_Write_Word(unsigned int adr, unsigned short data)
+{
+	Shadow_Write_Byte(adr, (unsigned char)(data >> 8));
+	Shadow_Write_Byte(adr + 1, (unsigned char)data);
+}
+
+static unsigned char Shadow_Int_Ack(void)
+{
+	Shadow_IO = 1;
+	return 0;
+}
+
+#define STAR_READ_BYTE Shadow_Read_Byte
+#define STAR_READ_WORD Shadow_Read_Word
+#define STAR_WRITE_BYTE Shadow_Write_Byte
+#define STAR_WRITE_WORD Shadow_Write_Word
+#define STAR_INT_ACK Shadow_Int_Ack
+#define STAR_HOOKS 0
+#include "../Starscream/Main68k/main68kc.cpp"
+
+
+static int Compare(const S68000CONTEXT *c, unsigned int code_c, unsigned int code_asm, unsigned int *ram_adr)
+{
+	const S68000CONTEXT *a = &main68k_context;
+	unsigned int i, j;
+
+	if(code_c != code_asm || memcmp(c->dreg, a->dreg, sizeof(a->dreg)) || memcmp(c->areg, a->areg, sizeof(a->areg))
+		|| c->asp != a->asp || c->pc != a->pc || c->sr != a->sr || c->odometer != a->odometer
+		|| c->interrupts[0] != a->interrupts[0])
+		return 1;
+
+	// the last write to each byte is what the RAM should have now
+	for(i = 0; i < Shadow_Writes; i++)
+	{
+		for(j = i + 1; j < Shadow_Writes && Shadow_Write[j].Adr != Shadow_Write[i].Adr; j++) {}
+		if(j == Shadow_Writes && Ram_68k[Shadow_Write[i].Adr ^ 1] != Shadow_Write[i].Data)
+		{
+			*ram_adr = Shadow_Write[i].Adr;
+			return 2;
+		}
+	}
+	return 0;
+}
+
+static void Report(int what, const S68000CONTEXT *in, const S68000CONTEXT *c, unsigned int ram_adr)
+{
+	const S68000CONTEXT *a = &main68k_context;
+	int i;
+
+	if(++M68K_Verify_Mismatches > VERIFY_MAX_REPORTS)
+		return;
+
+	fprintf(stderr, "m68k verify: frame %lu: instruction at %06X (%04X)",
+		FrameCount, in->pc & 0xFFFFFF, main68kc_fetch(in->pc));
+	if(what == 2)
+	{
+		fprintf(stderr, ": RAM FF%04X is %02X, asm has %02X\n",
+			ram_adr, Shadow_RB(0xFF0000 | ram_adr), Ram_68k[ram_adr ^ 1]);
+	}
+	else
+	{
+		fprintf(stderr, ", C / asm:");
+		for(i = 0; i < 8; i++)
+			if(c->dreg[i] != a->dreg[i])
+				fprintf(stderr, " D%d %08X/%08X", i, c->dreg[i], a->dreg[i]);
+		for(i = 0; i < 8; i++)
+			if(c->areg[i] != a->areg[i])
+				fprintf(stderr, " A%d %08X/%08X", i, c->areg[i], a->areg[i]);
+		if(c->asp != a->asp)
+			fprintf(stderr, " USP/SSP %08X/%08X", c->asp, a->asp);
+		if(c->pc != a->pc)
+			fprintf(stderr, " PC %06X/%06X", c->pc, a->pc);
+		if(c->sr != a->sr)
+			fprintf(stderr, " SR %04X/%04X", c->sr, a->sr);
+		if(c->odometer != a->odometer)
+			fprintf(stderr, " cycles %u/%u", c->odometer - in->odometer, a->odometer - in->odometer);
+		if(c->interrupts[0] != a->interrupts[0])
+			fprintf(stderr, " int %02X/%02X", c->interrupts[0], a->interrupts[0]);
+		fprintf(stderr, "\n");
+	}
+	if(M68K_Verify_Mismatches == VERIFY_MAX_REPORTS)
+		fprintf(stderr, "m68k verify: further mismatches are only counted\n");
+}
+
+void M68K_Verify_Exec(int Odo)
+{
+	static int initialized = 0;
+	S68000CONTEXT in, out_c;
+	unsigned int code_c, code_asm, ram_adr = 0, level;
+	int what;
+
+	if(!initialized)
+	{
+		main68kc_init();
+		initialized = 1;
+	}
+
+	while((int)main68k_context.odometer < Odo)
+	{
+		// stopped: the asm just counts the cycles
+		if(main68k_context.interrupts[0] & 0x10)
+		{
+			main68k_exec(Odo);
+			return;
+		}
+
+		// an interrupt is taken first: Int_Ack has side effects, leave it to the asm
+		level = main68k_context.interrupts[0] & 7;
+		if(level == 7 || level > ((main68k_context.sr >> 8) & 7u))
+		{
+			Verify_Skipped++;
+			if(main68k_exec(main68k_context.odometer + 1) != 0x80000000)
+				return;
+			continue;
+		}
+
+		memcpy(&in, &main68k_context, sizeof(in));
+		memcpy(&main68kc_context, &in, sizeof(in));
+		Shadow_IO = 0;
+		Shadow_Writes = 0;
+		code_c = main68kc_exec(in.odometer + 1);
+		memcpy(&out_c, &main68kc_context, sizeof(out_c));
+
+		code_asm = main68k_exec(in.odometer + 1);
+
+		if(Shadow_IO)
+			Verify_Skipped++;
+		else
+		{
+			Verify_Steps++;
+			what = Compare(&out_c, code_c, code_asm, &ram_adr);
+			if(what)
+				Report(what, &in, &out_c, ram_adr);
+		}
+
+		if(code_asm != 0x80000000)
+			return;
+	}
+}
+
+void M68K_Verify_Report(void)
+{
+	if(M68K_Core != M68K_CORE_VERIFY || !(Verify_Steps + Verify_Skipped))
+		return;
+
+	fprintf(stderr, "m68k verify: %u instructions compared, %u run by the asm only (I/O or interrupt), %d mismatches\n",
+		Verify_Steps, Verify_Skipped, M68K_Verify_Mismatches);
+}
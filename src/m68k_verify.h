@@ -0,0 +1,16 @@
+#ifndef M68K_VERIFY_H
+#define M68K_VERIFY_H
+
+// Main 68000 core selection (m68k_verify.cpp)
+enum {
+	M68K_CORE_ASM = 0,	// main68k.asm
+	M68K_CORE_VERIFY,	// run every instruction with the C++ core (main68kc.cpp) too, report when it ends up elsewhere
+};
+extern int M68K_Core;
+extern int M68K_Verify_Mismatches;
+
+// main68k_exec, stepping one instruction at a time and checking each against the C++ core
+void M68K_Verify_Exec(int Odo);
+void M68K_Verify_Report(void);
+
+#endif
@@ -1,6 +1,7 @@
 #include <stdio.h>
 #include <windows.h>
 #include "net.h"
+#include "startup_prof.h"
 
 HINSTANCE Kaillera_HDLL;
 int Kaillera_Initialised;
@@ -58,7 +59,7 @@ int WINAPI Empty_Kaillera_End_Game()
 
 int Init_Network(void)
 {
-	Kaillera_HDLL = LoadLibrary("kailleraclient.dll");
+	Kaillera_HDLL = Batch_Startup ? NULL : LoadLibrary("kailleraclient.dll");	// no netplay in -batch runs
 
 	if (Kaillera_HDLL != NULL)
 	{
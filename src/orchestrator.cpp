@@ -0,0 +1,857 @@
+// Parallel variant runs (-variants)
+// The orchestrator reads the manifest, turns each variant into one IPS patch and puts them, with every
+// numbered screenshot and state dump of the reference directory, into one named shared memory block.
+// Then it keeps -workers copies of Gens running: each gets the rest of the command line with -batch,
+// its own screenshot directory and -worker-slot, which names the block and the variant. The variants
+// are handed out one at a time from a single queue as workers finish, so a long variant only holds up
+// its own core. A worker runs one variant and exits: a crash or a hang stays in that variant, and
+// nothing has to be reset between variants.
+// The worker patches the ROM as it loads it (Set_Rom_Patch), compares with the shared reference
+// (Orchestrator_Reference) and writes its first differences and exit reason into its slot at exit.
+// A worker that exits without doing that crashed, one that runs longer than -worker-timeout is killed.
+
+#include <windows.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <string>
+#include <vector>
+#include <map>
+#include "orchestrator.h"
+#include "automation.h"
+#include "Rom.h"
+
+extern unsigned long FrameCount;
+
+#define ORCH_VERSION 1
+
+struct Orch_Header
+{
+	char Magic[4];					// "GORC"
+	unsigned int Version;
+	unsigned int Variants;
+	unsigned int Ref_Frames;
+	unsigned int Table_Size;		// header, variants, reference index and patches, mapped whole by the workers
+	unsigned int Reserved;
+	unsigned long long Data_Size;	// reference files, after the table
+};
+
+struct Orch_Variant
+{
+	char Name[64];
+	unsigned int Patch_Offset;		// IPS patch in the table
+	unsigned int Patch_Size;
+	// written by the worker as it exits
+	volatile LONG Done;
+	int First_Visual;
+	int First_Memory;
+	int Frames;
+	char Exit[24];
+};
+
+struct Orch_Ref
+{
+	unsigned int Frame;
+	unsigned int Png_Size;
+	unsigned int State_Size;
+	unsigned int Reserved;
+	unsigned long long Png_Offset;	// from the start of the block, 0 if the reference doesn't have it
+	unsigned long long State_Offset;
+};
+
+// Worker side
+static HANDLE Worker_Map = NULL;
+static unsigned char *Worker_Table = NULL;
+static Orch_Variant *Worker_Variant = NULL;
+static void *Ref_View = NULL;
+
+
+//--------------------------------------------------------------------------------------------
+// Manifest
+
+struct Variant
+{
+	std::string Name;
+	std::vector<unsigned char> Patch;	// IPS records only, "PATCH" and "EOF" are added in the block
+};
+
+static int Hex_Digit(int c)
+{
+	if (c >= '0' && c <= '9') return c - '0';
+	c = tolower(c);
+	if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+	return -1;
+}
+
+// ADDR=BYTES
+static int Parse_Address_Patch(const std::string &spec, std::vector<unsigned char> &patch)
+{
+	size_t eq = spec.find('=');
+	const char *p = spec.c_str();
+	std::vector<unsigned char> bytes;
+	unsigned int adr = 0;
+	int d;
+
+	if (!strncmp(p, "0x", 2) || !strncmp(p, "0X", 2)) p += 2;
+	else if (*p == '$') p++;
+	if (p == spec.c_str() + eq)
+		return 0;
+	for (; p < spec.c_str() + eq; p++)
+	{
+		if ((d = Hex_Digit(*p)) < 0 || adr > 0xFFFFF)
+			return 0;
+		adr = adr << 4 | d;
+	}
+
+	p = spec.c_str() + eq + 1;
+	if (!_stricmp(p, "rts"))
+	{
+		bytes.push_back(0x4E);
+		bytes.push_back(0x75);
+	}
+	else
+	{
+		for (; p[0] && p[1]; p += 2)
+		{
+			if (Hex_Digit(p[0]) < 0 || Hex_Digit(p[1]) < 0)
+				return 0;
+			bytes.push_back((unsigned char)(Hex_Digit(p[0]) << 4 | Hex_Digit(p[1])));
+		}
+		if (*p || bytes.empty() || bytes.size() > 0xFFFF)
+			return 0;
+	}
+
+	// an IPS record at 0x454F46 would read as the end of the patch
+	if (adr == 0x454F46)
+	{
+		fprintf(stderr, "orchestrator: can't patch at 0x454F46 (\"EOF\" in an IPS patch), start one byte earlier\n");
+		return 0;
+	}
+
+	patch.push_back((unsigned char)(adr >> 16));
+	patch.push_back((unsigned char)(adr >> 8));
+	patch.push_back((unsigned char)adr);
+	patch.push_back((unsigned char)(bytes.size() >> 8));
+	patch.push_back((unsigned char)bytes.size());
+	patch.insert(patch.end(), bytes.begin(), bytes.end());
+	return 1;
+}
+
+// The records of an IPS file
+static int Read_IPS_File(const char *path, std::vector<unsigned char> &patch)
+{
+	std::vector<unsigned char> data;
+	unsigned char buf[4096];
+	size_t n, pos = 5, len;
+	FILE *f;
+
+	f = fopen(path, "rb");
+	if (!f)
+	{
+		fprintf(stderr, "orchestrator: can't open %s\n", path);
+		return 0;
+	}
+	while ((n = fread(buf, 1, sizeof(buf), f)) > 0)
+		data.insert(data.end(), buf, buf + n);
+	fclose(f);
+
+	if (data.size() < 5 || memcmp(&data[0], "PATCH", 5))
+	{
+		fprintf(stderr, "orchestrator: %s isn't an IPS patch\n", path);
+		return 0;
+	}
+	while (pos + 3 <= data.size() && memcmp(&data[pos], "EOF", 3))
+	{
+		if (pos + 5 > data.size())
+			break;
+		len = data[pos + 3] << 8 | data[pos + 4];
+		pos += 5 + (len ? len : 3);
+	}
+	if (pos + 3 > data.size())
+	{
+		fprintf(stderr, "orchestrator: %s is truncated\n", path);
+		return 0;
+	}
+	patch.insert(patch.end(), data.begin() + 5, data.begin() + pos);
+	return 1;
+}
+
+// Whitespace separated, "quoted" tokens may have spaces
+static void Split_Line(const char *line, std::vector<std::string> &tokens)
+{
+	const char *p = line, *end;
+
+	tokens.clear();
+	for (;;)
+	{
+		while (*p && isspace((unsigned char)*p)) p++;
+		if (!*p || *p == '#')
+			break;
+		if (*p == '"')
+		{
+			end = strchr(++p, '"');
+			if (!end) end = p + strlen(p);
+			tokens.push_back(std::string(p, end));
+			p = *end ? end + 1 : end;
+		}
+		else
+		{
+			for (end = p; *end && !isspace((unsigned char)*end); end++);
+			tokens.push_back(std::string(p, end));
+			p = end;
+		}
+	}
+}
+
+// The name is also the variant's output directory: a name already used (case aside, as on the file
+// system), e.g. two fix.ips in different directories, gets the variant number appended
+static void Unique_Name(std::string &name, const std::vector<Variant> &variants)
+{
+	const std::string base = name;
+	char suffix[16];
+	size_t i, n = variants.size() + 1;
+
+	for (i = 0; i < variants.size(); )
+	{
+		if (_stricmp(variants[i].Name.c_str(), name.c_str()))
+		{
+			i++;
+			continue;
+		}
+		sprintf(suffix, "_%u", (unsigned int)n++);
+		name = base.substr(0, 63 - strlen(suffix)) + suffix;
+		i = 0;
+	}
+	if (name != base)
+		fprintf(stderr, "orchestrator: variant name %s is already used, this one is %s\n", base.c_str(), name.c_str());
+}
+
+static int Read_Manifest(const char *path, std::vector<Variant> &variants)
+{
+	std::vector<std::string> tokens;
+	char line[2048];
+	int line_num = 0, ok = 1;
+	size_t i, first;
+	FILE *f;
+
+	f = fopen(path, "r");
+	if (!f)
+	{
+		fprintf(stderr, "orchestrator: can't open %s\n", path);
+		return 0;
+	}
+
+	while (fgets(line, sizeof(line), f))
+	{
+		line_num++;
+		Split_Line(line, tokens);
+		if (tokens.empty())
+			continue;
+
+		Variant v;
+
+		// a single spec names the variant after itself (the IPS file without its directory and extension)
+		first = tokens.size() > 1 ? 1 : 0;
+		if (first)
+			v.Name = tokens[0];
+		else if (tokens[0].find('=') != std::string::npos)
+			v.Name = tokens[0];
+		else
+		{
+			size_t slash = tokens[0].find_last_of("\\/"), dot;
+			v.Name = tokens[0].substr(slash == std::string::npos ? 0 : slash + 1);
+			dot = v.Name.rfind('.');
+			if (dot != std::string::npos && dot > 0)
+				v.Name.erase(dot);
+		}
+		for (i = 0; i < v.Name.size(); i++)
+			if (strchr("\\/:*?\"<>|=", v.Name[i]))
+				v.Name[i] = '_';
+		if (v.Name.size() > 63)
+			v.Name.resize(63);
+
+		for (i = first; i < tokens.size(); i++)
+		{
+			if (tokens[i].find('=') != std::string::npos ? !Parse_Address_Patch(tokens[i], v.Patch) : !Read_IPS_File(tokens[i].c_str(), v.Patch))
+			{
+				fprintf(stderr, "orchestrator: %s line %d: bad patch \"%s\"\n", path, line_num, tokens[i].c_str());
+				ok = 0;
+			}
+		}
+		Unique_Name(v.Name, variants);
+		variants.push_back(v);
+	}
+	fclose(f);
+
+	if (ok && variants.empty())
+	{
+		fprintf(stderr, "orchestrator: no variants in %s\n", path);
+		ok = 0;
+	}
+	return ok;
+}
+
+
+//--------------------------------------------------------------------------------------------
+// Reference data
+
+struct Ref_Files
+{
+	std::string Png, State;
+	unsigned int Png_Size, State_Size;
+	Ref_Files() : Png_Size(0), State_Size(0) {}
+};
+
+// The numbered files Automation_OnFrame writes in record mode: 000060.png, 000060.genstate
+static void Scan_Reference(const char *dir, const char *ext, std::map<unsigned int, Ref_Files> &refs)
+{
+	WIN32_FIND_DATA fd;
+	HANDLE find;
+	char pattern[1024];
+	std::string title;
+	size_t i;
+
+	_snprintf(pattern, sizeof(pattern), "%s\\*%s", dir, ext);
+	pattern[sizeof(pattern) - 1] = 0;
+	find = FindFirstFile(pattern, &fd);
+	if (find == INVALID_HANDLE_VALUE)
+		return;
+	do
+	{
+		title = fd.cFileName;
+		if (title.size() <= strlen(ext) || _stricmp(title.c_str() + title.size() - strlen(ext), ext))
+			continue;
+		title.resize(title.size() - strlen(ext));
+		for (i = 0; i < title.size() && isdigit((unsigned char)title[i]); i++);
+		if (i < title.size())
+			continue;
+
+		Ref_Files &r = refs[(unsigned int)atoi(title.c_str())];
+		if (ext[1] == 'p')
+		{
+			r.Png = std::string(dir) + "\\" + fd.cFileName;
+			r.Png_Size = fd.nFileSizeLow;
+		}
+		else
+		{
+			r.State = std::string(dir) + "\\" + fd.cFileName;
+			r.State_Size = fd.nFileSizeLow;
+		}
+	} while (FindNextFile(find, &fd));
+	FindClose(find);
+}
+
+static DWORD Granularity(void)
+{
+	SYSTEM_INFO si;
+
+	GetSystemInfo(&si);
+	return si.dwAllocationGranularity;
+}
+
+// Reads path into the block at offset, through a view of just that part
+static int Copy_To_Block(HANDLE map, unsigned long long offset, const std::string &path, unsigned int size)
+{
+	unsigned long long base = offset & ~(unsigned long long)(Granularity() - 1);
+	unsigned char *view;
+	FILE *f;
+	int ok;
+
+	f = fopen(path.c_str(), "rb");
+	if (!f)
+		return 0;
+	view = (unsigned char *)MapViewOfFile(map, FILE_MAP_WRITE, (DWORD)(base >> 32), (DWORD)base, (SIZE_T)(offset - base + size));
+	if (!view)
+	{
+		fclose(f);
+		return 0;
+	}
+	ok = fread(view + (offset - base), 1, size, f) == size;
+	UnmapViewOfFile(view);
+	fclose(f);
+	return ok;
+}
+
+
+//--------------------------------------------------------------------------------------------
+// Orchestrator
+
+// Takes out "opt value" (or just "opt" when has_value is 0) wherever it is on the command line
+// Returns the last value taken out, without its quotes
+static std::string Remove_Option(std::string &cmd, const char *opt, int has_value)
+{
+	std::string value;
+	size_t pos = 0, end, begin;
+
+	while ((pos = cmd.find(opt, pos)) != std::string::npos)
+	{
+		end = pos + strlen(opt);
+		if ((pos && cmd[pos - 1] != ' ') || (end < cmd.size() && cmd[end] != ' '))
+		{
+			pos = end;
+			continue;
+		}
+		if (has_value)
+		{
+			while (end < cmd.size() && cmd[end] == ' ') end++;
+			if (end < cmd.size() && cmd[end] == '"')
+			{
+				begin = end + 1;
+				end = cmd.find('"', begin);
+				value = cmd.substr(begin, end == std::string::npos ? std::string::npos : end - begin);
+				end = end == std::string::npos ? cmd.size() : end + 1;
+			}
+			else
+			{
+				begin = end;
+				while (end < cmd.size() && cmd[end] != ' ') end++;
+				value = cmd.substr(begin, end - begin);
+			}
+		}
+		cmd.erase(pos, end - pos);
+	}
+	return value;
+}
+
+// The output files and directories a worker writes, moved into its variant's directory so that
+// workers running at the same time don't write over each other
+static const char *Output_Options[] = {"-hash-out", "-profile-out", "-bench-out", "-trace-log", "-bintrace",
+	"-ramhist-out", "-dump-state-dir", NULL};
+
+// A CSV field, quoted when it has to be
+static std::string Csv_Field(const char *text)
+{
+	std::string field;
+
+	if (!strpbrk(text, ",\"\r\n"))
+		return text;
+	field = "\"";
+	for (; *text; text++)
+	{
+		if (*text == '"')
+			field += '"';
+		field += *text;
+	}
+	field += '"';
+	return field;
+}
+
+static int Write_Results(const char *path, const std::vector<Variant> &variants, const Orch_Variant *slot,
+	const std::vector<DWORD> &exit_code, const std::vector<double> &seconds)
+{
+	const char *ext = strrchr(path, '.');
+	int json = ext && !_stricmp(ext, ".json");
+	size_t i;
+	FILE *f;
+
+	f = fopen(path, "w");
+	if (!f)
+	{
+		fprintf(stderr, "orchestrator: can't create %s\n", path);
+		return 0;
+	}
+
+	if (json)
+		fprintf(f, "{\"variants\":[");
+	else
+		fprintf(f, "variant,first_visual_diff,first_memory_diff,frames,exit,exit_code,seconds\n");
+
+	for (i = 0; i < variants.size(); i++)
+	{
+		const char *exit_reason = slot[i].Done ? slot[i].Exit : "crash";
+		int frames = slot[i].Done ? slot[i].Frames : -1;
+
+		if (json)
+			fprintf(f, "%s\n{\"variant\":\"%s\",\"first_visual_diff\":%d,\"first_memory_diff\":%d,\"frames\":%d,\"exit\":\"%s\",\"exit_code\":%lu,\"seconds\":%.1f}",
+				i ? "," : "", slot[i].Name, slot[i].First_Visual, slot[i].First_Memory, frames, exit_reason, exit_code[i], seconds[i]);
+		else
+			fprintf(f, "%s,%d,%d,%d,%s,%lu,%.1f\n",
+				Csv_Field(slot[i].Name).c_str(), slot[i].First_Visual, slot[i].First_Memory, frames, exit_reason, exit_code[i], seconds[i]);
+	}
+
+	if (json)
+		fprintf(f, "\n]}\n");
+	fclose(f);
+	return 1;
+}
+
+int Orchestrator_Run(const char *manifest, const char *results, int workers, int timeout,
+	const char *reference_dir, const char *output_dir, const char *cmdline)
+{
+	std::vector<Variant> variants;
+	std::map<unsigned int, Ref_Files> refs;
+	std::map<unsigned int, Ref_Files>::iterator it;
+	std::string base, cmd, dir, outputs[sizeof(Output_Options) / sizeof(Output_Options[0])], file;
+	std::vector<DWORD> exit_code;
+	std::vector<double> seconds;
+	std::vector<DWORD> start;
+	HANDLE proc[MAXIMUM_WAIT_OBJECTS];
+	int proc_variant[MAXIMUM_WAIT_OBJECTS];
+	char exe[MAX_PATH], map_name[64], results_path[1024];
+	unsigned int table_size, patch_size = 0, i;
+	unsigned long long data_size = 0, offset;
+	unsigned char *table;
+	Orch_Header *head;
+	Orch_Variant *slot;
+	Orch_Ref *ref;
+	HANDLE map = NULL;
+	SYSTEM_INFO si;
+	DWORD r, wait, elapsed, limit = timeout > 0 ? (DWORD)timeout * 1000 : 0;
+	size_t slash;
+	int next = 0, running = 0, finished = 0, k, ok;
+
+	if (!Read_Manifest(manifest, variants))
+		return 0;
+
+	if (workers <= 0)
+	{
+		GetSystemInfo(&si);
+		workers = si.dwNumberOfProcessors;
+	}
+	if (workers > MAXIMUM_WAIT_OBJECTS)
+		workers = MAXIMUM_WAIT_OBJECTS;
+
+	if (results && results[0])
+		strncpy(results_path, results, sizeof(results_path) - 1);
+	else
+		_snprintf(results_path, sizeof(results_path) - 1, "%s\\results.csv", output_dir);
+	results_path[sizeof(results_path) - 1] = 0;
+
+	// the reference, read once here instead of once per frame in every worker
+	if (reference_dir && reference_dir[0])
+	{
+		Scan_Reference(reference_dir, ".png", refs);
+		Scan_Reference(reference_dir, ".genstate", refs);
+	}
+
+	for (i = 0; i < variants.size(); i++)
+		patch_size += variants[i].Patch.size() + 8;
+	table_size = sizeof(Orch_Header) + variants.size() * sizeof(Orch_Variant) + refs.size() * sizeof(Orch_Ref) + patch_size;
+	table_size = (table_size + 7) & ~7;
+	for (it = refs.begin(); it != refs.end(); ++it)
+		data_size += (unsigned long long)it->second.Png_Size + it->second.State_Size;
+
+	_snprintf(map_name, sizeof(map_name), "Gens_Orchestrator_%lu", GetCurrentProcessId());
+	map = CreateFileMapping(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE,
+		(DWORD)((table_size + data_size) >> 32), (DWORD)(table_size + data_size), map_name);
+	if (!map && data_size)
+	{
+		fprintf(stderr, "orchestrator: not enough memory to share the reference (%I64u MB), the workers read the files\n", data_size >> 20);
+		refs.clear();
+		data_size = 0;
+		table_size = (sizeof(Orch_Header) + variants.size() * sizeof(Orch_Variant) + patch_size + 7) & ~7;
+		map = CreateFileMapping(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, 0, table_size, map_name);
+	}
+	if (!map)
+	{
+		fprintf(stderr, "orchestrator: can't create the shared memory\n");
+		return 0;
+	}
+	table = (unsigned char *)MapViewOfFile(map, FILE_MAP_WRITE, 0, 0, table_size);
+	if (!table)
+	{
+		fprintf(stderr, "orchestrator: can't map the shared memory\n");
+		CloseHandle(map);
+		return 0;
+	}
+
+	head = (Orch_Header *)table;
+	slot = (Orch_Variant *)(head + 1);
+	ref = (Orch_Ref *)(slot + variants.size());
+	memcpy(head->Magic, "GORC", 4);
+	head->Version = ORCH_VERSION;
+	head->Variants = variants.size();
+	head->Ref_Frames = refs.size();
+	head->Table_Size = table_size;
+	head->Data_Size = data_size;
+
+	offset = (unsigned char *)(ref + refs.size()) - table;
+	for (i = 0; i < variants.size(); i++)
+	{
+		strncpy(slot[i].Name, variants[i].Name.c_str(), sizeof(slot[i].Name) - 1);
+		slot[i].Patch_Offset = (unsigned int)offset;
+		slot[i].Patch_Size = variants[i].Patch.size() + 8;
+		memcpy(table + offset, "PATCH", 5);
+		if (!variants[i].Patch.empty())
+			memcpy(table + offset + 5, &variants[i].Patch[0], variants[i].Patch.size());
+		memcpy(table + offset + 5 + variants[i].Patch.size(), "EOF", 3);
+		offset += slot[i].Patch_Size;
+		slot[i].First_Visual = slot[i].First_Memory = -1;
+	}
+
+	offset = table_size;
+	for (i = 0, it = refs.begin(); it != refs.end(); ++it, i++)
+	{
+		ref[i].Frame = it->first;
+		if (it->second.Png_Size && Copy_To_Block(map, offset, it->second.Png, it->second.Png_Size))
+		{
+			ref[i].Png_Offset = offset;
+			ref[i].Png_Size = it->second.Png_Size;
+		}
+		offset += it->second.Png_Size;
+		if (it->second.State_Size && Copy_To_Block(map, offset, it->second.State, it->second.State_Size))
+		{
+			ref[i].State_Offset = offset;
+			ref[i].State_Size = it->second.State_Size;
+		}
+		offset += it->second.State_Size;
+	}
+	if (!refs.empty())
+		fprintf(stderr, "orchestrator: %u reference frames shared (%I64u MB)\n", (unsigned int)refs.size(), data_size >> 20);
+
+	// the worker command line: ours without the orchestrator's options, with an output directory per variant
+	base = cmdline;
+	Remove_Option(base, "-variants", 1);
+	Remove_Option(base, "-results", 1);
+	Remove_Option(base, "-workers", 1);
+	Remove_Option(base, "-worker-slot", 1);
+	Remove_Option(base, "-screenshot-dir", 1);
+	Remove_Option(base, "-startup-report", 1);
+	Remove_Option(base, "-worker-timeout", 1);
+	Remove_Option(base, "-batch", 0);
+	for (k = 0; Output_Options[k]; k++)
+		outputs[k] = Remove_Option(base, Output_Options[k], 1);
+	GetModuleFileName(NULL, exe, sizeof(exe));
+	CreateDirectory(output_dir, NULL);
+
+	exit_code.resize(variants.size(), 0);
+	seconds.resize(variants.size(), 0.0);
+	start.resize(variants.size(), 0);
+	fprintf(stderr, "orchestrator: %u variants, %d workers\n", (unsigned int)variants.size(), workers);
+
+	while (next < (int)variants.size() || running)
+	{
+		while (running < workers && next < (int)variants.size())
+		{
+			STARTUPINFO si_proc;
+			PROCESS_INFORMATION pi;
+			char slot_arg[96];
+
+			dir = std::string(output_dir) + "\\" + slot[next].Name;
+			CreateDirectory(dir.c_str(), NULL);
+			_snprintf(slot_arg, sizeof(slot_arg), "%s:%d", map_name, next);
+			slot_arg[sizeof(slot_arg) - 1] = 0;
+			cmd = "\"" + std::string(exe) + "\" " + base + " -batch -screenshot-dir \"" + dir + "\" -worker-slot " + slot_arg;
+			for (k = 0; Output_Options[k]; k++)
+			{
+				if (outputs[k].empty())
+					continue;
+				slash = outputs[k].find_last_of("\\/", outputs[k].find_last_not_of("\\/"));
+				file = outputs[k].substr(slash == std::string::npos ? 0 : slash + 1);
+				cmd += std::string(" ") + Output_Options[k] + " \"" + dir + "\\" + file + "\"";
+			}
+
+			memset(&si_proc, 0, sizeof(si_proc));
+			si_proc.cb = sizeof(si_proc);
+			std::vector<char> cmd_buf(cmd.begin(), cmd.end());
+			cmd_buf.push_back(0);
+			start[next] = GetTickCount();
+			if (CreateProcess(exe, &cmd_buf[0], NULL, NULL, FALSE, 0, NULL, NULL, &si_proc, &pi))
+			{
+				CloseHandle(pi.hThread);
+				proc[running] = pi.hProcess;
+				proc_variant[running] = next;
+				running++;
+			}
+			else
+			{
+				fprintf(stderr, "orchestrator: can't start a worker for %s\n", slot[next].Name);
+				strcpy(slot[next].Exit, "not_started");
+				slot[next].Done = 1;
+				finished++;
+			}
+			next++;
+		}
+		if (!running)
+			break;
+
+		// until the first worker finishes or the oldest one runs out of time
+		wait = INFINITE;
+		if (limit)
+		{
+			for (k = 0; k < running; k++)
+			{
+				elapsed = GetTickCount() - start[proc_variant[k]];
+				elapsed = elapsed < limit ? limit - elapsed : 0;
+				if (elapsed < wait)
+					wait = elapsed;
+			}
+		}
+		r = WaitForMultipleObjects(running, proc, FALSE, wait);
+		if (r == WAIT_TIMEOUT)
+		{
+			// killed here, reaped as they come out of the wait above
+			for (k = 0; k < running; k++)
+			{
+				i = proc_variant[k];
+				if (GetTickCount() - start[i] < limit || WaitForSingleObject(proc[k], 0) == WAIT_OBJECT_0)
+					continue;
+				TerminateProcess(proc[k], WAIT_TIMEOUT);
+				WaitForSingleObject(proc[k], INFINITE);
+				if (!slot[i].Done)
+				{
+					strcpy(slot[i].Exit, "timeout");
+					slot[i].Done = 1;
+				}
+			}
+			continue;
+		}
+		if (r >= WAIT_OBJECT_0 + (DWORD)running)
+		{
+			fprintf(stderr, "orchestrator: lost track of the workers\n");
+			break;
+		}
+		k = r - WAIT_OBJECT_0;
+		i = proc_variant[k];
+		GetExitCodeProcess(proc[k], &exit_code[i]);
+		seconds[i] = (GetTickCount() - start[i]) / 1000.0;
+		CloseHandle(proc[k]);
+		proc[k] = proc[running - 1];
+		proc_variant[k] = proc_variant[running - 1];
+		running--;
+		finished++;
+
+		fprintf(stderr, "orchestrator: %d/%u %s: %s\n", finished, (unsigned int)variants.size(), slot[i].Name, slot[i].Done ? slot[i].Exit : "crash");
+	}
+
+	// only if we broke out of the loop
+	for (k = 0; k < running; k++)
+	{
+		TerminateProcess(proc[k], 1);
+		CloseHandle(proc[k]);
+	}
+
+	ok = Write_Results(results_path, variants, slot, exit_code, seconds);
+	UnmapViewOfFile(table);
+	CloseHandle(map);
+	return ok;
+}
+
+
+//--------------------------------------------------------------------------------------------
+// Worker
+
+int Orchestrator_Worker_Open(const char *slot)
+{
+	const char *colon = strrchr(slot, ':');
+	Orch_Header head, *h;
+	std::string name;
+	unsigned int index;
+	void *view;
+
+	if (!colon)
+	{
+		fprintf(stderr, "orchestrator: bad worker slot %s\n", slot);
+		return 0;
+	}
+	name.assign(slot, colon);
+	index = (unsigned int)atoi(colon + 1);
+
+	Worker_Map = OpenFileMapping(FILE_MAP_ALL_ACCESS, FALSE, name.c_str());
+	if (!Worker_Map)
+	{
+		fprintf(stderr, "orchestrator: can't open %s\n", name.c_str());
+		return 0;
+	}
+
+	// the header says how much to map
+	view = MapViewOfFile(Worker_Map, FILE_MAP_READ, 0, 0, sizeof(Orch_Header));
+	if (view)
+	{
+		memcpy(&head, view, sizeof(head));
+		UnmapViewOfFile(view);
+	}
+	if (!view || memcmp(head.Magic, "GORC", 4) || head.Version != ORCH_VERSION || index >= head.Variants)
+	{
+		fprintf(stderr, "orchestrator: %s isn't from this version of Gens\n", slot);
+		CloseHandle(Worker_Map);
+		Worker_Map = NULL;
+		return 0;
+	}
+
+	Worker_Table = (unsigned char *)MapViewOfFile(Worker_Map, FILE_MAP_ALL_ACCESS, 0, 0, head.Table_Size);
+	if (!Worker_Table)
+	{
+		CloseHandle(Worker_Map);
+		Worker_Map = NULL;
+		return 0;
+	}
+	h = (Orch_Header *)Worker_Table;
+	Worker_Variant = (Orch_Variant *)(h + 1) + index;
+
+	Set_Rom_Patch(Worker_Table + Worker_Variant->Patch_Offset, Worker_Variant->Patch_Size);
+	return 1;
+}
+
+void Orchestrator_Worker_Close(void)
+{
+	if (!Worker_Variant)
+		return;
+
+	Worker_Variant->First_Visual = FirstDiffFrame;
+	Worker_Variant->First_Memory = FirstMemoryDiffFrame;
+	Worker_Variant->Frames = (int)FrameCount;
+	strncpy(Worker_Variant->Exit, ExitReason ? ExitReason : "closed", sizeof(Worker_Variant->Exit) - 1);
+	InterlockedExchange(&Worker_Variant->Done, 1);
+
+	Set_Rom_Patch(NULL, 0);
+	if (Ref_View)
+		UnmapViewOfFile(Ref_View);
+	UnmapViewOfFile(Worker_Table);
+	CloseHandle(Worker_Map);
+	Ref_View = NULL;
+	Worker_Table = NULL;
+	Worker_Variant = NULL;
+	Worker_Map = NULL;
+}
+
+int Orchestrator_Reference(int frame, const char *ext, const unsigned char **data, int *size)
+{
+	const Orch_Header *h = (const Orch_Header *)Worker_Table;
+	const Orch_Ref *ref;
+	unsigned long long offset, base;
+	unsigned int lo, hi, mid, len;
+
+	if (!Worker_Table || !h->Ref_Frames || frame < 0)
+		return 0;
+
+	ref = (const Orch_Ref *)((const Orch_Variant *)(h + 1) + h->Variants);
+	lo = 0;
+	hi = h->Ref_Frames;
+	while (lo < hi)
+	{
+		mid = (lo + hi) / 2;
+		if (ref[mid].Frame < (unsigned int)frame)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	if (lo >= h->Ref_Frames || ref[lo].Frame != (unsigned int)frame)
+		return 0;
+
+	if (!_stricmp(ext, ".png"))
+	{
+		offset = ref[lo].Png_Offset;
+		len = ref[lo].Png_Size;
+	}
+	else
+	{
+		offset = ref[lo].State_Offset;
+		len = ref[lo].State_Size;
+	}
+	if (!offset)
+		return 0;
+
+	// one file mapped at a time, the block can be bigger than the address space
+	if (Ref_View)
+		UnmapViewOfFile(Ref_View);
+	base = offset & ~(unsigned long long)(Granularity() - 1);
+	Ref_View = MapViewOfFile(Worker_Map, FILE_MAP_READ, (DWORD)(base >> 32), (DWORD)base, (SIZE_T)(offset - base + len));
+	if (!Ref_View)
+		return 0;
+
+	*data = (const unsigned char *)Ref_View + (offset - base);
+	*size = (int)len;
+	return 1;
+}
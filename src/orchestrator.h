@@ -0,0 +1,26 @@
+#ifndef ORCHESTRATOR_H
+#define ORCHESTRATOR_H
+
+// Parallel variant runs (orchestrator.cpp)
+// -variants runs the rest of the command line once per variant of the ROM in worker processes, as many
+// at a time as -workers (default: one per core), and writes the first screenshot and memory difference
+// of each variant and why it stopped to one results file. A worker still running after timeout seconds
+// (0 for no limit) is killed and its variant recorded as "timeout". The reference screenshots and state dumps
+// are read once into shared memory, the workers compare with that instead of reading the files.
+
+// Manifest: one variant per line, "name spec..." (or just "spec"), # for comments. A spec is either
+// ADDR=BYTES (hex file offset and hex bytes, or ADDR=rts) or the path of an IPS file.
+// Returns 0 if nothing was run (bad manifest, no variants, can't create results).
+int Orchestrator_Run(const char *manifest, const char *results, int workers, int timeout,
+	const char *reference_dir, const char *output_dir, const char *cmdline);
+
+// Worker side, slot is the -worker-slot argument the orchestrator gave it.
+// Open has to come before the ROM is loaded, the variant is a patch applied to it while loading.
+int Orchestrator_Worker_Open(const char *slot);
+// Stores this run's result for the orchestrator (from End_All)
+void Orchestrator_Worker_Close(void);
+// Reference file of frame with extension ext (".png" or ".genstate") from the shared copy, valid until
+// the next call. Returns 0 when this isn't a worker or the shared copy doesn't have it (read the file then).
+int Orchestrator_Reference(int frame, const char *ext, const unsigned char **data, int *size);
+
+#endif
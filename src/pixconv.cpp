@@ -0,0 +1,104 @@
+// Line colour conversions (see pixconv.h)
+// The palette lookups stay table loads, unrolled so the loads overlap and stored 4 or 8 pixels at
+// a time. Recalculate_Palettes builds each component from that component alone (except greyscale and
+// the pink background), so a pshufb version with a 16 byte table per component is possible, but after
+// the shadow/highlight adjustment it measured about 1.5x slower than these loads: the colours of a
+// frame stay in L1. The RGB unpacking is done on 8 pixels per SSE2 register.
+
+#include "pixconv.h"
+
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+   #define PIXCONV_SSE2
+   #include <emmintrin.h>
+#endif
+
+void PixConv_Pal32(unsigned int *dst, const unsigned short *src, const unsigned int *pal, int count)
+{
+	int i = 0;
+
+#ifdef PIXCONV_SSE2
+	for(; i + 4 <= count; i += 4)
+	{
+		unsigned int p0 = pal[src[i + 0]], p1 = pal[src[i + 1]];
+		unsigned int p2 = pal[src[i + 2]], p3 = pal[src[i + 3]];
+		_mm_storeu_si128((__m128i *)(dst + i), _mm_set_epi32((int)p3, (int)p2, (int)p1, (int)p0));
+	}
+#endif
+	for(; i < count; i++)
+		dst[i] = pal[src[i]];
+}
+
+void PixConv_Pal16(unsigned short *dst, const unsigned short *src, const unsigned short *pal, int count)
+{
+	int i = 0;
+
+#ifdef PIXCONV_SSE2
+	for(; i + 8 <= count; i += 8)
+	{
+		__m128i p = _mm_set_epi16((short)pal[src[i + 7]], (short)pal[src[i + 6]], (short)pal[src[i + 5]], (short)pal[src[i + 4]],
+			(short)pal[src[i + 3]], (short)pal[src[i + 2]], (short)pal[src[i + 1]], (short)pal[src[i + 0]]);
+		_mm_storeu_si128((__m128i *)(dst + i), p);
+	}
+#endif
+	for(; i < count; i++)
+		dst[i] = pal[src[i]];
+}
+
+void PixConv_16To32(unsigned int *dst, const unsigned short *src, int count, int mode555)
+{
+	int i = 0;
+
+#ifdef PIXCONV_SSE2
+	// per 16 bit pixel: red and green land in the high word, blue in the low word
+	const __m128i r_mask = _mm_set1_epi16(mode555 ? 0x7C00 : (short)0xF800);
+	const __m128i g_mask = _mm_set1_epi16(mode555 ? 0x03E0 : 0x07E0);
+	const __m128i b_mask = _mm_set1_epi16(0x001F);
+	const __m128i alpha = _mm_set1_epi16((short)0xFF00);
+
+	for(; i + 8 <= count; i += 8)
+	{
+		__m128i p = _mm_loadu_si128((const __m128i *)(src + i));
+		__m128i r = _mm_and_si128(p, r_mask);
+		__m128i g = _mm_and_si128(p, g_mask);
+		__m128i b = _mm_slli_epi16(_mm_and_si128(p, b_mask), 3);
+		__m128i hi, lo;
+
+		if(mode555)
+		{
+			// hi word: 0xFF00 | R << 3, lo word: G << 6 | B << 3
+			hi = _mm_or_si128(alpha, _mm_srli_epi16(r, 7));
+			lo = _mm_or_si128(_mm_slli_epi16(g, 6), b);
+		}
+		else
+		{
+			// hi word: 0xFF00 | R, lo word: G << 5 | B << 3
+			hi = _mm_or_si128(alpha, _mm_srli_epi16(r, 8));
+			lo = _mm_or_si128(_mm_slli_epi16(g, 5), b);
+		}
+
+		_mm_storeu_si128((__m128i *)(dst + i), _mm_unpacklo_epi16(lo, hi));
+		_mm_storeu_si128((__m128i *)(dst + i + 4), _mm_unpackhi_epi16(lo, hi));
+	}
+#endif
+	for(; i < count; i++)
+	{
+		unsigned int p = src[i];
+		if(mode555)
+			dst[i] = 0xFF000000 | ((p & 0x7C00) << 9) | ((p & 0x03E0) << 6) | ((p & 0x001F) << 3);
+		else
+			dst[i] = 0xFF000000 | ((p & 0xF800) << 8) | ((p & 0x07E0) << 5) | ((p & 0x001F) << 3);
+	}
+}
+
+void PixConv_32To32(unsigned int *dst, const unsigned int *src, int count)
+{
+	int i = 0;
+
+#ifdef PIXCONV_SSE2
+	const __m128i alpha = _mm_set1_epi32((int)0xFF000000);
+	for(; i + 4 <= count; i += 4)
+		_mm_storeu_si128((__m128i *)(dst + i), _mm_or_si128(_mm_loadu_si128((const __m128i *)(src + i)), alpha));
+#endif
+	for(; i < count; i++)
+		dst[i] = src[i] | 0xFF000000;
+}
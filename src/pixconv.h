@@ -0,0 +1,18 @@
+#ifndef PIXCONV_H
+#define PIXCONV_H
+
+// Whole line colour conversions for the frame output and the screenshot/compare paths, same results
+// as the per pixel code (Palette32 / Palette, DrawUtil). The RGB conversions use SSE2 where the
+// compiler targets it, the palette ones are unrolled table lookups.
+
+// Screen_16X (0ahsbbbbggggrrrr) through a 0x8000 entries palette
+void PixConv_Pal32(unsigned int *dst, const unsigned short *src, const unsigned int *pal, int count);
+void PixConv_Pal16(unsigned short *dst, const unsigned short *src, const unsigned short *pal, int count);
+
+// RGB565 (or RGB555 when mode555) to 0xFFRRGGBB, like DrawUtil::Pix16To32 / Pix15To32 with alpha set
+void PixConv_16To32(unsigned int *dst, const unsigned short *src, int count, int mode555);
+
+// 32 bit pixels with the alpha set to 0xFF
+void PixConv_32To32(unsigned int *dst, const unsigned int *src, int count);
+
+#endif
@@ -0,0 +1,309 @@
+// Native plugin interface implementation for Gens-rr
+// Loads plugin DLLs and dispatches core hook events to their callbacks
+
+#include <windows.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "plugin.h"
+#include "Cpu_68k.h"
+#include "Mem_M68k.h"
+#include "Mem_Z80.h"
+#include "vdp_io.h"
+#include "vdp_rend.h"
+#include "z80.h"
+#include "tracer.h"
+#include "frame_prof.h"
+
+// Global state
+int PluginMemHooksActive[GENS_HOOK_COUNT] = {0};
+int PluginDMAHooksActive = 0;
+int PluginFrameHooksActive = 0;
+
+// Internal state
+struct PluginMemHook {
+    int handle;
+    uint32_t start;
+    uint32_t end;
+    GensMemHookFunc func;     // NULL once unregistered (removed when not dispatching)
+    void* userdata;
+};
+
+struct PluginEventHook {
+    int handle;
+    void* func;               // GensDMAHookFunc or GensFrameHookFunc, NULL once unregistered
+    void* userdata;
+};
+
+struct LoadedPlugin {
+    HMODULE module;
+    GensPluginShutdownFunc shutdown;
+};
+
+static std::vector<PluginMemHook> mem_hooks[GENS_HOOK_COUNT];
+static uint32_t mem_hooks_low[GENS_HOOK_COUNT];   // lowest start address hooked per type
+static uint32_t mem_hooks_high[GENS_HOOK_COUNT];  // highest end address hooked per type
+static std::vector<PluginEventHook> dma_hooks;
+static std::vector<PluginEventHook> frame_hooks;
+static std::vector<LoadedPlugin> plugins;
+static GensPluginHost host;
+static int next_handle = 1;
+static int dispatch_depth = 0;    // callbacks may unregister hooks while we iterate
+static int needs_compact = 0;
+
+static void update_active_flags()
+{
+    for (int type = 0; type < GENS_HOOK_COUNT; type++)
+    {
+        uint32_t low = 0xFFFFFFFF, high = 0;
+        for (size_t i = 0; i < mem_hooks[type].size(); i++)
+        {
+            const PluginMemHook& hook = mem_hooks[type][i];
+            if (!hook.func) continue;
+            if (hook.start < low) low = hook.start;
+            if (hook.end > high) high = hook.end;
+        }
+        mem_hooks_low[type] = low;
+        mem_hooks_high[type] = high;
+        PluginMemHooksActive[type] = (low <= high);
+    }
+
+    PluginDMAHooksActive = 0;
+    for (size_t i = 0; i < dma_hooks.size(); i++)
+        if (dma_hooks[i].func) PluginDMAHooksActive = 1;
+
+    PluginFrameHooksActive = 0;
+    for (size_t i = 0; i < frame_hooks.size(); i++)
+        if (frame_hooks[i].func) PluginFrameHooksActive = 1;
+
+    Update_Hook_Enabled();
+}
+
+static void compact_hooks()
+{
+    if (dispatch_depth > 0 || !needs_compact)
+        return;
+
+    for (int type = 0; type < GENS_HOOK_COUNT; type++)
+    {
+        std::vector<PluginMemHook>& hooks = mem_hooks[type];
+        size_t out = 0;
+        for (size_t i = 0; i < hooks.size(); i++)
+            if (hooks[i].func) hooks[out++] = hooks[i];
+        hooks.resize(out);
+    }
+
+    std::vector<PluginEventHook>* eventLists[2] = { &dma_hooks, &frame_hooks };
+    for (int list = 0; list < 2; list++)
+    {
+        std::vector<PluginEventHook>& hooks = *eventLists[list];
+        size_t out = 0;
+        for (size_t i = 0; i < hooks.size(); i++)
+            if (hooks[i].func) hooks[out++] = hooks[i];
+        hooks.resize(out);
+    }
+
+    needs_compact = 0;
+}
+
+// Host callbacks handed to plugins
+
+static int host_register_mem_hook(int type, uint32_t start, uint32_t end, GensMemHookFunc func, void* userdata)
+{
+    if (type < 0 || type >= GENS_HOOK_COUNT || !func || end < start)
+        return 0;
+
+    PluginMemHook hook;
+    hook.handle = next_handle++;
+    hook.start = start & 0xFFFFFF;
+    hook.end = end & 0xFFFFFF;
+    hook.func = func;
+    hook.userdata = userdata;
+    mem_hooks[type].push_back(hook);
+
+    update_active_flags();
+    return hook.handle;
+}
+
+static int register_event_hook(std::vector<PluginEventHook>& hooks, void* func, void* userdata)
+{
+    if (!func)
+        return 0;
+
+    PluginEventHook hook;
+    hook.handle = next_handle++;
+    hook.func = func;
+    hook.userdata = userdata;
+    hooks.push_back(hook);
+
+    update_active_flags();
+    return hook.handle;
+}
+
+static int host_register_dma_hook(GensDMAHookFunc func, void* userdata)
+{
+    return register_event_hook(dma_hooks, (void*)func, userdata);
+}
+
+static int host_register_frame_hook(GensFrameHookFunc func, void* userdata)
+{
+    return register_event_hook(frame_hooks, (void*)func, userdata);
+}
+
+static void host_unregister_hook(int handle)
+{
+    for (int type = 0; type < GENS_HOOK_COUNT; type++)
+        for (size_t i = 0; i < mem_hooks[type].size(); i++)
+            if (mem_hooks[type][i].handle == handle)
+                mem_hooks[type][i].func = NULL;
+
+    for (size_t i = 0; i < dma_hooks.size(); i++)
+        if (dma_hooks[i].handle == handle)
+            dma_hooks[i].func = NULL;
+
+    for (size_t i = 0; i < frame_hooks.size(); i++)
+        if (frame_hooks[i].handle == handle)
+            frame_hooks[i].func = NULL;
+
+    needs_compact = 1;
+    update_active_flags();
+    compact_hooks();
+}
+
+static void host_log(const char* message)
+{
+    fprintf(stderr, "plugin: %s\n", message);
+}
+
+static void host_vram_written(uint32_t address, uint32_t length)
+{
+    Tile_Cache_Invalidate_Range(address, length);
+}
+
+static void init_host()
+{
+    if (host.api_version)
+        return;
+
+    memset(&host, 0, sizeof(host));
+    host.api_version = GENS_PLUGIN_API_VERSION;
+    host.struct_size = sizeof(host);
+
+    host.ram_68k = Ram_68k;
+    host.ram_z80 = Ram_Z80;
+    host.vram = VRam;
+    host.cram = CRam;
+    host.vsram = VSRam;
+    host.rom = Rom_Data;
+    host.rom_size = &Rom_Size;
+
+    host.main68k_context = &main68k_context;
+    host.sub68k_context = &sub68k_context;
+    host.z80_context = &M_Z80;
+
+    host.register_mem_hook = host_register_mem_hook;
+    host.register_dma_hook = host_register_dma_hook;
+    host.register_frame_hook = host_register_frame_hook;
+    host.unregister_hook = host_unregister_hook;
+    host.log = host_log;
+    host.vram_written = host_vram_written;
+}
+
+int Plugin_Load(const char* path)
+{
+    init_host();
+
+    HMODULE module = LoadLibraryA(path);
+    if (!module)
+    {
+        fprintf(stderr, "failed to load plugin \"%s\" (error %lu)\n", path, GetLastError());
+        return 0;
+    }
+
+    GensPluginInitFunc init = (GensPluginInitFunc)GetProcAddress(module, GENS_PLUGIN_INIT_NAME);
+    if (!init)
+    {
+        fprintf(stderr, "plugin \"%s\" does not export %s\n", path, GENS_PLUGIN_INIT_NAME);
+        FreeLibrary(module);
+        return 0;
+    }
+
+    if (!init(&host))
+    {
+        fprintf(stderr, "plugin \"%s\" refused to initialize\n", path);
+        FreeLibrary(module);
+        return 0;
+    }
+
+    LoadedPlugin plugin;
+    plugin.module = module;
+    plugin.shutdown = (GensPluginShutdownFunc)GetProcAddress(module, GENS_PLUGIN_SHUTDOWN_NAME);
+    plugins.push_back(plugin);
+    return 1;
+}
+
+void Plugin_UnloadAll()
+{
+    for (size_t i = 0; i < plugins.size(); i++)
+    {
+        if (plugins[i].shutdown)
+            plugins[i].shutdown();
+    }
+
+    // hooks point into the DLLs, drop them before unloading
+    for (int type = 0; type < GENS_HOOK_COUNT; type++)
+        mem_hooks[type].clear();
+    dma_hooks.clear();
+    frame_hooks.clear();
+    update_active_flags();
+
+    for (size_t i = 0; i < plugins.size(); i++)
+        FreeLibrary(plugins[i].module);
+    plugins.clear();
+}
+
+void Plugin_MemHook(int type, uint32_t address, uint32_t size, uint32_t value, uint32_t pc)
+{
+    // performance critical: called for every access of a hooked type
+    uint32_t last = address + size - 1;
+    if (last < mem_hooks_low[type] || address > mem_hooks_high[type])
+        return;
+
+    dispatch_depth++;
+    std::vector<PluginMemHook>& hooks = mem_hooks[type];
+    for (size_t i = 0; i < hooks.size(); i++)
+    {
+        // a copy: the callback can add a hook, which may reallocate the vector
+        const PluginMemHook hook = hooks[i];
+        if (hook.func && last >= hook.start && address <= hook.end)
+            hook.func(hook.userdata, address, size, value, pc);
+    }
+    dispatch_depth--;
+    compact_hooks();
+}
+
+void Plugin_DMAHook(uint32_t src, uint32_t dst, uint32_t len, uint32_t dst_type, uint32_t pc)
+{
+    dispatch_depth++;
+    for (size_t i = 0; i < dma_hooks.size(); i++)
+    {
+        if (dma_hooks[i].func)
+            ((GensDMAHookFunc)dma_hooks[i].func)(dma_hooks[i].userdata, src, dst, len, dst_type, pc);
+    }
+    dispatch_depth--;
+    compact_hooks();
+}
+
+void Plugin_FrameHook(uint32_t frame)
+{
+    PROF_SCOPE(PROF_PLUGIN);
+
+    dispatch_depth++;
+    for (size_t i = 0; i < frame_hooks.size(); i++)
+    {
+        if (frame_hooks[i].func)
+            ((GensFrameHookFunc)frame_hooks[i].func)(frame_hooks[i].userdata, frame);
+    }
+    dispatch_depth--;
+    compact_hooks();
+}
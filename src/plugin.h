@@ -0,0 +1,30 @@
+// Host side of the native plugin interface (see gens_plugin.h)
+
+#ifndef PLUGIN_H
+#define PLUGIN_H
+
+#include <stdint.h>
+#include "gens_plugin.h"
+
+// Per hook type flag, nonzero when any plugin has a hook of that type.
+// Checked inline so unhooked accesses cost a single compare.
+extern int PluginMemHooksActive[GENS_HOOK_COUNT];
+extern int PluginDMAHooksActive;
+extern int PluginFrameHooksActive;
+
+// Load a plugin DLL and call its init function
+// Returns: 1 on success, 0 on failure (error printed to stderr)
+int Plugin_Load(const char* path);
+
+// Call shutdown on all plugins and unload them
+void Plugin_UnloadAll();
+
+// Dispatch (called from the core hooks in tracer.cpp / tracer_cd.cpp)
+void Plugin_MemHook(int type, uint32_t address, uint32_t size, uint32_t value, uint32_t pc);
+void Plugin_DMAHook(uint32_t src, uint32_t dst, uint32_t len, uint32_t dst_type, uint32_t pc);
+void Plugin_FrameHook(uint32_t frame);
+
+#define PLUGIN_MEM_HOOK(type, address, size, value, pc) \
+    do { if (PluginMemHooksActive[type]) Plugin_MemHook(type, address, size, value, pc); } while (0)
+
+#endif // PLUGIN_H
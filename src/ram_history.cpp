@@ -0,0 +1,1505 @@
+// RAM search and RAM history implementation for Gens-rr emulator
+//
+// RAM search:
+//
+// A few notes about this implementation of a RAM search window:
+//
+// Speed of update was one of the highest priories.
+// This is because I wanted the RAM search window to be able to
+// update every single value in RAM every single frame, and
+// keep track of the exact number of frames across which each value has changed,
+// without causing the emulation to run noticeably slower than normal.
+//
+// The data representation was changed from one entry per valid address
+// to one entry per contiguous range of uneliminated addresses
+// which references uniform pools of per-address properties.
+// - This saves time when there are many items because
+//   it minimizes the amount of data that needs to be stored and processed per address.
+// - It also saves time when there are few items because
+//   it ensures that no time is wasted in iterating through
+//   addresses that have already been eliminated from the search.
+//
+// The worst-case scenario is when every other item has been
+// eliminated from the search, maximizing the number of regions.
+// This implementation manages to handle even that pathological case
+// acceptably well. In fact, it still updates faster than the previous implementation.
+// The time spent setting up or clearing such a large number of regions
+// is somewhat horrendous, but it seems reasonable to have poor worst-case speed
+// during these sporadic "setup" steps to achieve an all-around faster per-update speed.
+// (You can test this case by performing the search: Modulo 2 Is Specific Address 0)
+//
+// RAM history: each recorded frame stores bit planes over the recorded bytes (changed,
+// increased) plus the new values of the bytes that changed. Planes are kept sparse: a
+// summary bitmap says which 32-byte blocks changed and only those plane words are stored.
+// Byte-sized change predicates are evaluated 32 addresses at a time directly on the
+// planes; everything else replays the values frame by frame through the same
+// comparison functions the RAM search uses.
+
+#include "gens.h"
+#include "mem_m68k.h"
+#include "mem_s68k.h"
+#include "mem_sh2.h"
+#include "mem_z80.h"
+#include "vdp_io.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <algorithm>
+#include "ram_history.h"
+#include "ram_search.h"
+#include "frame_prof.h"
+#ifdef _WIN32
+	#include "BaseTsd.h"
+	typedef INT_PTR intptr_t;
+#else
+	#include "stdint.h"
+#endif
+
+// the per-frame change counting uses SSE2 when the compiler targets it (the default for VS2012 and later)
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+   #define RAM_SEARCH_SSE2
+   #include <emmintrin.h>
+#endif
+
+
+struct MemoryRegion
+{
+	unsigned int hardwareAddress; // hardware address of the start of this region
+	unsigned int size; // number of bytes to the end of this region
+	unsigned char* softwareAddress; // pointer to the start of the live emulator source values for this region
+	BOOL byteSwapped; // true if this is a byte-swapped region of memory
+
+	unsigned int virtualIndex; // index into s_prevValues, s_curValues, and s_numChanges, valid after being initialized in RamSearch_ResetRegions()
+	unsigned int itemIndex; // index into the item list, valid when s_itemIndicesInvalid is false
+};
+
+ALIGN16 static unsigned char s_prevValues [MAX_RAM_SIZE+4] = {0}; // values at last search or reset
+ALIGN16 static unsigned char s_curValues [MAX_RAM_SIZE+4] = {0}; // values at last frame update
+ALIGN16 static unsigned short s_numChanges [MAX_RAM_SIZE+4] = {0}; // number of changes of the item starting at this virtual index address
+ALIGN16 static unsigned char s_changedBytes [MAX_RAM_SIZE+4+16] = {0}; // scratch for the frame update, 0xFF where a byte differs from s_curValues
+static MemoryRegion* s_itemIndexToRegionPointer [MAX_RAM_SIZE+4] = {0}; // used for random access into the memory list (trading memory size to get speed here, too bad it's so much memory), only valid when s_itemIndicesInvalid is false
+static BOOL s_itemIndicesInvalid = true; // if true, the link from listbox items to memory regions (s_itemIndexToRegionPointer) and the link from memory regions to list box items (MemoryRegion::itemIndex) both need to be recalculated
+static BOOL s_prevValuesNeedUpdate = true; // if true, the "prev" values should be updated using the "cur" values on the next frame update signaled
+static unsigned int s_maxItemIndex = 0; // max currently valid item index, the listbox sometimes tries to update things past the end of the list so we need to know this to ignore those attempts
+
+static const MemoryRegion s_prgRegion    = {  0x020000, SEGACD_RAM_PRG_SIZE, (unsigned char*)Ram_Prg,     true};
+static const MemoryRegion s_word1MRegion = {  0x200000, SEGACD_1M_RAM_SIZE,  (unsigned char*)Ram_Word_1M, true};
+static const MemoryRegion s_word2MRegion = {  0x200000, SEGACD_2M_RAM_SIZE,  (unsigned char*)Ram_Word_2M, true};
+static const MemoryRegion s_z80Region    = {  0xA00000, Z80_RAM_SIZE,        (unsigned char*)Ram_Z80,     true};
+static const MemoryRegion s_68kRegion    = {  0xFF0000, _68K_RAM_SIZE,       (unsigned char*)Ram_68k,     true};
+static const MemoryRegion s_32xRegion    = {0x06000000, _32X_RAM_SIZE,       (unsigned char*)_32X_Ram,    false};
+
+// list of contiguous uneliminated memory regions, in listbox order
+// (a vector because the frame update walks it every frame; searches rebuild it instead of splitting in place)
+typedef std::vector<MemoryRegion> MemoryList;
+static MemoryList s_activeMemoryRegions;
+
+// for undo support (could be better, but this way was really easy)
+static MemoryList s_activeMemoryRegionsBackup;
+
+static const int tooManyRegionsForUndo = 10000;
+
+void RamSearch_ResetRegions()
+{
+	s_activeMemoryRegions.clear();
+	if(Game)
+	{
+		s_activeMemoryRegions.push_back(s_68kRegion);
+		s_activeMemoryRegions.push_back(s_z80Region);
+		if(SegaCD_Started)
+		{
+			s_activeMemoryRegions.push_back(s_prgRegion);
+			s_activeMemoryRegions.push_back((Ram_Word_State & 0x2) ? s_word1MRegion : s_word2MRegion);
+		}
+		if(_32X_Started)
+		{
+			s_activeMemoryRegions.push_back(s_32xRegion);
+		}
+	}
+
+	int nextVirtualIndex = 0;
+	for(MemoryList::iterator iter = s_activeMemoryRegions.begin(); iter != s_activeMemoryRegions.end(); ++iter)
+	{
+		MemoryRegion& region = *iter;
+		region.virtualIndex = nextVirtualIndex;
+		assert(((intptr_t)region.softwareAddress & 1) == 0 && "somebody need to reimplement ReadValueAtSoftwareAddress()");
+		nextVirtualIndex = region.virtualIndex + region.size;
+	}
+	assert(nextVirtualIndex <= MAX_RAM_SIZE);
+	s_itemIndicesInvalid = TRUE;
+}
+
+void RamSearch_ClearRegions()
+{
+	s_activeMemoryRegions.clear();
+	s_itemIndicesInvalid = TRUE;
+}
+
+// eliminates a range of hardware addresses from a region
+// returns 3 if it split the region (region keeps the start, tailRegion receives the rest)
+// returns 2 if it erased the entire region
+// returns 1 if it shrank the region
+// returns 0 if it had no effect
+// warning: don't call anything that takes an itemIndex in a loop that calls DeactivateRegion...
+//   doing so would be tremendously slow because removing regions invalidates the index cache
+static int DeactivateRegion(MemoryRegion& region, MemoryRegion& tailRegion, unsigned int hardwareAddress, unsigned int size)
+{
+	if(hardwareAddress + size <= region.hardwareAddress || hardwareAddress >= region.hardwareAddress + region.size)
+	{
+		// region is unaffected
+		return 0;
+	}
+	else if(hardwareAddress > region.hardwareAddress && hardwareAddress + size >= region.hardwareAddress + region.size)
+	{
+		// erase end of region
+		region.size = hardwareAddress - region.hardwareAddress;
+		return 1;
+	}
+	else if(hardwareAddress <= region.hardwareAddress && hardwareAddress + size < region.hardwareAddress + region.size)
+	{
+		// erase start of region
+		int eraseSize = (hardwareAddress + size) - region.hardwareAddress;
+		region.hardwareAddress += eraseSize;
+		region.size -= eraseSize;
+		region.softwareAddress += eraseSize;
+		region.virtualIndex += eraseSize;
+		return 1;
+	}
+	else if(hardwareAddress <= region.hardwareAddress && hardwareAddress + size >= region.hardwareAddress + region.size)
+	{
+		// erase entire region
+		return 2;
+	}
+	else //if(hardwareAddress > region.hardwareAddress && hardwareAddress + size < region.hardwareAddress + region.size)
+	{
+		// split region
+		int eraseSize = (hardwareAddress + size) - region.hardwareAddress;
+		MemoryRegion region2 = {region.hardwareAddress + eraseSize, region.size - eraseSize, region.softwareAddress + eraseSize, region.byteSwapped, region.virtualIndex + eraseSize};
+		region.size = hardwareAddress - region.hardwareAddress;
+		tailRegion = region2;
+		return 3;
+	}
+}
+
+// eliminates every item that fails the given test from the search results
+// this has the same effect as calling DeactivateRegion on each failing item in order,
+// but builds a new list in one pass instead of inserting into the middle of the old one
+// the tester is called as test(virtualIndex, hardwareAddress) and returns false to eliminate
+template<typename stepType, typename Tester>
+void PruneRegionsT(const Tester& test)
+{
+	MemoryList survivors;
+	survivors.reserve(s_activeMemoryRegions.size());
+
+	for(MemoryList::iterator iter = s_activeMemoryRegions.begin(); iter != s_activeMemoryRegions.end(); ++iter)
+	{
+		MemoryRegion region = *iter;
+		bool alive = true;
+		bool split;
+		do
+		{
+			split = false;
+			int startSkipSize = ((unsigned int)(sizeof(stepType) - region.hardwareAddress)) % sizeof(stepType);
+			unsigned int start = region.virtualIndex + startSkipSize;
+			unsigned int end = region.virtualIndex + region.size;
+			for(unsigned int i = start, hwaddr = region.hardwareAddress; i < end; i += sizeof(stepType), hwaddr += sizeof(stepType))
+			{
+				if(!test(i, hwaddr))
+				{
+					MemoryRegion tailRegion;
+					int result = DeactivateRegion(region, tailRegion, hwaddr, sizeof(stepType));
+					if(result == 2)
+					{
+						alive = false;
+						break;
+					}
+					if(result == 3)
+					{
+						// keep the start and continue with the rest as a fresh region
+						survivors.push_back(region);
+						region = tailRegion;
+						split = true;
+						break;
+					}
+				}
+			}
+		} while(split);
+
+		if(alive)
+			survivors.push_back(region);
+	}
+
+	s_activeMemoryRegions.swap(survivors);
+	s_itemIndicesInvalid = TRUE;
+}
+
+// warning: can be slow
+static void CalculateItemIndices(int itemSize)
+{
+	unsigned int itemIndex = 0;
+	for(MemoryList::iterator iter = s_activeMemoryRegions.begin(); iter != s_activeMemoryRegions.end(); ++iter)
+	{
+		MemoryRegion& region = *iter;
+		region.itemIndex = itemIndex;
+		int startSkipSize = ((unsigned int)(itemSize - region.hardwareAddress)) % itemSize;
+		unsigned int start = startSkipSize;
+		unsigned int end = region.size;
+		for(unsigned int i = start; i < end; i += itemSize)
+			s_itemIndexToRegionPointer[itemIndex++] = &region;
+	}
+	s_maxItemIndex = itemIndex;
+	s_itemIndicesInvalid = FALSE;
+}
+
+// compares live memory against s_curValues for virtual indices [indexStart, indexEnd),
+// marks the bytes that differ in s_changedBytes, and updates s_curValues below copyEnd
+// returns true if any byte changed
+template<int swapXOR>
+bool FindChangedBytes(const unsigned char* sourceAddr, unsigned int indexStart, unsigned int indexEnd, unsigned int copyEnd)
+{
+	unsigned int i = indexStart;
+	unsigned int anyChanged = 0;
+
+#ifdef RAM_SEARCH_SSE2
+	// go one byte at a time until i is 16-aligned, which also makes it even for the byte swap below
+	for(; i < indexEnd && (i & 15); i++)
+	{
+		unsigned char value = sourceAddr[i^swapXOR];
+		unsigned char changed = (s_curValues[i] != value) ? 0xFF : 0;
+		s_changedBytes[i] = changed;
+		anyChanged |= changed;
+		if(i < copyEnd)
+			s_curValues[i] = value;
+	}
+
+	const __m128i zero = _mm_setzero_si128();
+	for(; i + 16 <= indexEnd; i += 16)
+	{
+		__m128i cur = _mm_loadu_si128((const __m128i*)(s_curValues + i));
+		__m128i src = _mm_loadu_si128((const __m128i*)(sourceAddr + i));
+		if(swapXOR)
+			src = _mm_or_si128(_mm_slli_epi16(src, 8), _mm_srli_epi16(src, 8));
+		__m128i same = _mm_cmpeq_epi8(cur, src);
+		if(_mm_movemask_epi8(same) == 0xFFFF)
+		{
+			// nothing changed here, the common case
+			_mm_storeu_si128((__m128i*)(s_changedBytes + i), zero);
+			continue;
+		}
+		_mm_storeu_si128((__m128i*)(s_changedBytes + i), _mm_cmpeq_epi8(same, zero));
+		anyChanged = 1;
+		if(i + 16 <= copyEnd)
+			_mm_storeu_si128((__m128i*)(s_curValues + i), src);
+		else
+			for(unsigned int j = i; j < copyEnd; j++)
+				s_curValues[j] = sourceAddr[j^swapXOR];
+	}
+#endif
+
+	for(; i < indexEnd; i++)
+	{
+		unsigned char value = sourceAddr[i^swapXOR];
+		unsigned char changed = (s_curValues[i] != value) ? 0xFF : 0;
+		s_changedBytes[i] = changed;
+		anyChanged |= changed;
+		if(i < copyEnd)
+			s_curValues[i] = value;
+	}
+
+	return anyChanged != 0;
+}
+
+// increases the change count of each entry in [indexStart, indexEnd) once
+// if any of the compareSize bytes starting at that entry is marked in s_changedBytes
+template<int compareSize>
+void CountChangedEntries(unsigned int indexStart, unsigned int indexEnd)
+{
+	unsigned int i = indexStart;
+
+#ifdef RAM_SEARCH_SSE2
+	for(; i < indexEnd && (i & 15); i++)
+	{
+		unsigned char changed = s_changedBytes[i];
+		for(int k = 1; k < compareSize; k++)
+			changed |= s_changedBytes[i+k];
+		if(changed)
+			s_numChanges[i]++;
+	}
+
+	for(; i + 16 <= indexEnd; i += 16)
+	{
+		__m128i changed = _mm_loadu_si128((const __m128i*)(s_changedBytes + i));
+		for(int k = 1; k < compareSize; k++)
+			changed = _mm_or_si128(changed, _mm_loadu_si128((const __m128i*)(s_changedBytes + i + k)));
+		if(!_mm_movemask_epi8(changed))
+			continue;
+
+		// widen the 0xFF flags to 16 bits and subtract -1 to increment
+		__m128i* counts = (__m128i*)(s_numChanges + i);
+		_mm_storeu_si128(counts,     _mm_sub_epi16(_mm_loadu_si128(counts),     _mm_unpacklo_epi8(changed, changed)));
+		_mm_storeu_si128(counts + 1, _mm_sub_epi16(_mm_loadu_si128(counts + 1), _mm_unpackhi_epi8(changed, changed)));
+	}
+#endif
+
+	for(; i < indexEnd; i++)
+	{
+		unsigned char changed = s_changedBytes[i];
+		for(int k = 1; k < compareSize; k++)
+			changed |= s_changedBytes[i+k];
+		if(changed)
+			//if(s_numChanges[i] != 0xFFFF)
+				s_numChanges[i]++; // increase change count
+	}
+}
+
+template<typename stepType, typename compareType, int swapXOR>
+void UpdateRegionT(const MemoryRegion& region, const MemoryRegion* nextRegionPtr)
+{
+	if(s_prevValuesNeedUpdate)
+		memcpy(s_prevValues + region.virtualIndex, s_curValues + region.virtualIndex, region.size + sizeof(compareType) - sizeof(stepType));
+
+	unsigned int startSkipSize = ((unsigned int)(sizeof(stepType) - region.hardwareAddress)) % sizeof(stepType);
+
+	unsigned char* sourceAddr = region.softwareAddress - region.virtualIndex;
+	unsigned int indexStart = region.virtualIndex + startSkipSize;
+	unsigned int indexEnd = region.virtualIndex + region.size;
+
+	if(sizeof(compareType) == 1)
+	{
+		if(FindChangedBytes<swapXOR>(sourceAddr, indexStart, indexEnd, indexEnd))
+			CountChangedEntries<1>(indexStart, indexEnd);
+	}
+	else // it's more complicated for non-byte sizes because:
+	{    // - more than one byte can affect a given change count entry
+	     // - when more than one of those bytes changes simultaneously the entry's change count should only increase by 1
+	     // - a few of those bytes can be outside the region
+	     // so first find which bytes changed, then count each entry once if any of its bytes did
+
+		unsigned int endSkipSize = ((unsigned int)(startSkipSize - region.size)) % sizeof(stepType);
+		unsigned int lastIndexToRead = indexEnd + endSkipSize + sizeof(compareType) - sizeof(stepType);
+		unsigned int lastIndexToCopy = lastIndexToRead;
+		if(nextRegionPtr)
+		{
+			const MemoryRegion& nextRegion = *nextRegionPtr;
+			int nextStartSkipSize = ((unsigned int)(sizeof(stepType) - nextRegion.hardwareAddress)) % sizeof(stepType);
+			unsigned int nextIndexStart = nextRegion.virtualIndex + nextStartSkipSize;
+			if(lastIndexToCopy > nextIndexStart)
+				lastIndexToCopy = nextIndexStart;
+		}
+
+		if(FindChangedBytes<swapXOR>(sourceAddr, indexStart, lastIndexToRead, lastIndexToCopy))
+		{
+			// entries near the end only see the bytes that were read
+			for(unsigned int i = 0; i < sizeof(compareType); i++)
+				s_changedBytes[lastIndexToRead + i] = 0;
+			CountChangedEntries<sizeof(compareType)>(indexStart, indexEnd);
+		}
+	}
+}
+
+template<typename stepType, typename compareType>
+void UpdateRegionsT()
+{
+	for(MemoryList::iterator iter = s_activeMemoryRegions.begin(); iter != s_activeMemoryRegions.end();)
+	{
+		const MemoryRegion& region = *iter;
+		++iter;
+		const MemoryRegion* nextRegion = (iter == s_activeMemoryRegions.end()) ? NULL : &*iter;
+
+		if(region.byteSwapped)
+			UpdateRegionT<stepType, compareType, 1>(region, nextRegion);
+		else
+			UpdateRegionT<stepType, compareType, 0>(region, nextRegion);
+	}
+
+	s_prevValuesNeedUpdate = false;
+}
+
+template<typename stepType, typename compareType>
+int CountRegionItemsT()
+{
+	if(sizeof(stepType) == 1)
+	{
+		if(s_activeMemoryRegions.empty())
+			return 0;
+
+		if(s_itemIndicesInvalid)
+			CalculateItemIndices(sizeof(stepType));
+
+		MemoryRegion& lastRegion = s_activeMemoryRegions.back();
+		return lastRegion.itemIndex + lastRegion.size;
+	}
+	else // the branch above is faster but won't work if the step size isn't 1
+	{
+		int total = 0;
+		for(MemoryList::iterator iter = s_activeMemoryRegions.begin(); iter != s_activeMemoryRegions.end(); ++iter)
+		{
+			MemoryRegion& region = *iter;
+			int startSkipSize = ((unsigned int)(sizeof(stepType) - region.hardwareAddress)) % sizeof(stepType);
+			total += (region.size - startSkipSize + (sizeof(stepType)-1)) / sizeof(stepType);
+		}
+		return total;
+	}
+}
+
+// returns information about the item in the form of a "fake" region
+// that has the item in it and nothing else
+template<typename stepType, typename compareType>
+void ItemIndexToVirtualRegion(unsigned int itemIndex, MemoryRegion& virtualRegion)
+{
+	if(s_itemIndicesInvalid)
+		CalculateItemIndices(sizeof(stepType));
+
+	if(itemIndex >= s_maxItemIndex)
+	{
+		memset(&virtualRegion, 0, sizeof(MemoryRegion));
+		return;
+	}
+
+	const MemoryRegion* regionPtr = s_itemIndexToRegionPointer[itemIndex];
+	const MemoryRegion& region = *regionPtr;
+
+	int bytesWithinRegion = (itemIndex - region.itemIndex) * sizeof(stepType);
+	int startSkipSize = ((unsigned int)(sizeof(stepType) - region.hardwareAddress)) % sizeof(stepType);
+	bytesWithinRegion += startSkipSize;
+	
+	virtualRegion.size = sizeof(compareType);
+	virtualRegion.hardwareAddress = region.hardwareAddress + bytesWithinRegion;
+	virtualRegion.softwareAddress = region.softwareAddress + bytesWithinRegion;
+	virtualRegion.virtualIndex = region.virtualIndex + bytesWithinRegion;
+	virtualRegion.byteSwapped = region.byteSwapped;
+	virtualRegion.itemIndex = itemIndex;
+	return;
+}
+
+template<typename stepType, typename compareType>
+unsigned int ItemIndexToVirtualIndex(unsigned int itemIndex)
+{
+	MemoryRegion virtualRegion;
+	ItemIndexToVirtualRegion<stepType,compareType>(itemIndex, virtualRegion);
+	return virtualRegion.virtualIndex;
+}
+
+template<typename T>
+T ReadBigEndian(const unsigned char* data)
+{
+	T rv = 0;
+	for(int i = 0; i < sizeof(T); i++)
+	{
+		rv <<= 8;
+		rv |= *data++;
+	}
+	return rv;
+}
+template<> signed char ReadBigEndian(const unsigned char* data) { return *data; }
+template<> unsigned char ReadBigEndian(const unsigned char* data) { return *data; }
+
+
+template<typename stepType, typename compareType>
+compareType GetPrevValueFromVirtualIndex(unsigned int virtualIndex)
+{
+	return ReadBigEndian<compareType>(s_prevValues + virtualIndex);
+	//return *(compareType*)(s_prevValues+virtualIndex);
+}
+template<typename stepType, typename compareType>
+compareType GetCurValueFromVirtualIndex(unsigned int virtualIndex)
+{
+	return ReadBigEndian<compareType>(s_curValues + virtualIndex);
+//	return *(compareType*)(s_curValues+virtualIndex);
+}
+template<typename stepType, typename compareType>
+unsigned short GetNumChangesFromVirtualIndex(unsigned int virtualIndex)
+{
+	unsigned short num = s_numChanges[virtualIndex];
+	//for(unsigned int i = 1; i < sizeof(stepType); i++)
+	//	if(num < s_numChanges[virtualIndex+i])
+	//		num = s_numChanges[virtualIndex+i];
+	return num;
+}
+
+template<typename stepType, typename compareType>
+compareType GetPrevValueFromItemIndex(unsigned int itemIndex)
+{
+	int virtualIndex = ItemIndexToVirtualIndex<stepType,compareType>(itemIndex);
+	return GetPrevValueFromVirtualIndex<stepType,compareType>(virtualIndex);
+}
+template<typename stepType, typename compareType>
+compareType GetCurValueFromItemIndex(unsigned int itemIndex)
+{
+	int virtualIndex = ItemIndexToVirtualIndex<stepType,compareType>(itemIndex);
+	return GetCurValueFromVirtualIndex<stepType,compareType>(virtualIndex);
+}
+template<typename stepType, typename compareType>
+unsigned short GetNumChangesFromItemIndex(unsigned int itemIndex)
+{
+	int virtualIndex = ItemIndexToVirtualIndex<stepType,compareType>(itemIndex);
+	return GetNumChangesFromVirtualIndex<stepType,compareType>(virtualIndex);
+}
+template<typename stepType, typename compareType>
+unsigned int GetHardwareAddressFromItemIndex(unsigned int itemIndex)
+{
+	MemoryRegion virtualRegion;
+	ItemIndexToVirtualRegion<stepType,compareType>(itemIndex, virtualRegion);
+	return virtualRegion.hardwareAddress;
+}
+
+// this one might be unreliable, haven't used it much
+template<typename stepType, typename compareType>
+unsigned int HardwareAddressToItemIndex(unsigned int hardwareAddress)
+{
+	if(s_itemIndicesInvalid)
+		CalculateItemIndices(sizeof(stepType));
+
+	for(MemoryList::iterator iter = s_activeMemoryRegions.begin(); iter != s_activeMemoryRegions.end(); ++iter)
+	{
+		MemoryRegion& region = *iter;
+		if(hardwareAddress >= region.hardwareAddress && hardwareAddress < region.hardwareAddress + region.size)
+		{
+			int indexWithinRegion = (hardwareAddress - region.hardwareAddress) / sizeof(stepType);
+			return region.itemIndex + indexWithinRegion;
+		}
+	}
+
+	return -1;
+}
+
+
+
+
+// workaround for a parser error in MSVC that sometimes deletes a comma preceeding a macro
+// this macro takes a type and a signed/unsigned modifier, and returns the same type with that modifier whether or not the compiler decides to delete the comma between them
+template<typename T, typename ignored=void>
+struct DummyType { typedef T t; };
+#define COMMAHACK(sign, type) DummyType<sign type, sign>::t
+#ifdef _MSC_VER
+#pragma warning(disable : 4114) // disable "same modifier used twice" warning that otherwise would get issued when the compiler bug happens
+#endif
+
+// it's ugly but I can't think of a better way to call these functions that isn't also slower, since
+// I need the current values of these arguments to determine which primitive types are used within the function
+#define CALL_WITH_T_SIZE_TYPES(functionName, sizeTypeID, isSigned, requireAligned, ...) \
+	(sizeTypeID == 'b' \
+		? (isSigned \
+			? functionName<char, COMMAHACK(signed,char)>(__VA_ARGS__) \
+			: functionName<char, COMMAHACK(unsigned,char)>(__VA_ARGS__)) \
+	: sizeTypeID == 'w' \
+		? (isSigned \
+			? (requireAligned \
+				? functionName<short, COMMAHACK(signed,short)>(__VA_ARGS__) \
+				: functionName<char, COMMAHACK(signed,short)>(__VA_ARGS__)) \
+			: (requireAligned \
+				? functionName<short, COMMAHACK(unsigned,short)>(__VA_ARGS__) \
+				: functionName<char, COMMAHACK(unsigned,short)>(__VA_ARGS__))) \
+	: sizeTypeID == 'd' \
+		? (isSigned \
+			? (requireAligned \
+				? functionName<short, COMMAHACK(signed,long)>(__VA_ARGS__) \
+				: functionName<char, COMMAHACK(signed,long)>(__VA_ARGS__)) \
+			: (requireAligned \
+				? functionName<short, COMMAHACK(unsigned,long)>(__VA_ARGS__) \
+				: functionName<char, COMMAHACK(unsigned,long)>(__VA_ARGS__))) \
+	: functionName<char, COMMAHACK(signed,char)>(__VA_ARGS__))
+
+// version that takes a forced comparison type
+#define CALL_WITH_T_STEP(functionName, sizeTypeID, sign,type, requireAligned, ...) \
+	(sizeTypeID == 'b' \
+		? functionName<char, COMMAHACK(sign,type)>(__VA_ARGS__) \
+	: sizeTypeID == 'w' \
+		? (requireAligned \
+			? functionName<short, COMMAHACK(sign,type)>(__VA_ARGS__) \
+			: functionName<char, COMMAHACK(sign,type)>(__VA_ARGS__)) \
+	: sizeTypeID == 'd' \
+		? (requireAligned \
+			? functionName<short, COMMAHACK(sign,type)>(__VA_ARGS__) \
+			: functionName<char, COMMAHACK(sign,type)>(__VA_ARGS__)) \
+	: functionName<char, COMMAHACK(sign,type)>(__VA_ARGS__))
+
+
+// basic comparison functions:
+template <typename T> inline bool LessCmp (T x, T y, T i)        { return x < y; }
+template <typename T> inline bool MoreCmp (T x, T y, T i)        { return x > y; }
+template <typename T> inline bool LessEqualCmp (T x, T y, T i)   { return x <= y; }
+template <typename T> inline bool MoreEqualCmp (T x, T y, T i)   { return x >= y; }
+template <typename T> inline bool EqualCmp (T x, T y, T i)       { return x == y; }
+template <typename T> inline bool UnequalCmp (T x, T y, T i)     { return x != y; }
+template <typename T> inline bool DiffByCmp (T x, T y, T p)      { return x - y == p || y - x == p; }
+template <typename T> inline bool ModIsCmp (T x, T y, T p)       { return p && x % p == y; }
+
+// compare-to type functions:
+template<typename stepType, typename T>
+struct RelativeTester
+{
+	bool(*cmpFun)(T,T,T); T param;
+	bool operator()(unsigned int i, unsigned int hwaddr) const { return cmpFun(GetCurValueFromVirtualIndex<stepType,T>(i), GetPrevValueFromVirtualIndex<stepType,T>(i), param); }
+};
+template<typename stepType, typename T>
+struct SpecificTester
+{
+	bool(*cmpFun)(T,T,T); T value; T param;
+	bool operator()(unsigned int i, unsigned int hwaddr) const { return cmpFun(GetCurValueFromVirtualIndex<stepType,T>(i), value, param); }
+};
+template<typename stepType, typename T>
+struct AddressTester
+{
+	bool(*cmpFun)(T,T,T); T address; T param;
+	bool operator()(unsigned int i, unsigned int hwaddr) const { return cmpFun(hwaddr, address, param); }
+};
+template<typename stepType, typename T>
+struct ChangesTester
+{
+	bool(*cmpFun)(T,T,T); T changes; T param;
+	bool operator()(unsigned int i, unsigned int hwaddr) const { return cmpFun(GetNumChangesFromVirtualIndex<stepType,T>(i), changes, param); }
+};
+
+template<typename stepType, typename T>
+void SearchRelative (bool(*cmpFun)(T,T,T), T ignored, T param)
+{
+	RelativeTester<stepType,T> test = {cmpFun, param};
+	PruneRegionsT<stepType>(test);
+}template<typename stepType, typename T>
+void SearchSpecific (bool(*cmpFun)(T,T,T), T value, T param)
+{
+	SpecificTester<stepType,T> test = {cmpFun, value, param};
+	PruneRegionsT<stepType>(test);
+}template<typename stepType, typename T>
+void SearchAddress (bool(*cmpFun)(T,T,T), T address, T param)
+{
+	AddressTester<stepType,T> test = {cmpFun, address, param};
+	PruneRegionsT<stepType>(test);
+}template<typename stepType, typename T>
+void SearchChanges (bool(*cmpFun)(T,T,T), T changes, T param)
+{
+	ChangesTester<stepType,T> test = {cmpFun, changes, param};
+	PruneRegionsT<stepType>(test);
+}
+
+static int ItemSize(char size, int aligned)
+{
+	return (size == 'b' || !aligned) ? 1 : 2;
+}
+
+int RamSearch_NumRegions()
+{
+	return (int)s_activeMemoryRegions.size();
+}
+
+int RamSearch_NumItems(char size, int isSigned, int aligned)
+{
+	CalculateItemIndices(ItemSize(size, aligned));
+	return CALL_WITH_T_SIZE_TYPES(CountRegionItemsT, size, isSigned, aligned);
+}
+
+void RamSearch_Update(char size, int isSigned, int aligned)
+{
+	CALL_WITH_T_SIZE_TYPES(UpdateRegionsT, size, isSigned, aligned);
+}
+
+void RamSearch_SetPrevValuesNeedUpdate(int needUpdate)
+{
+	s_prevValuesNeedUpdate = needUpdate;
+}
+
+int RamSearch_PrevValuesNeedUpdate()
+{
+	return s_prevValuesNeedUpdate;
+}
+
+void RamSearch_CopyCurToPrev()
+{
+	memcpy(s_prevValues, s_curValues, sizeof(s_prevValues));
+}
+
+void RamSearch_ResetChanges()
+{
+	memset(s_numChanges, 0, sizeof(s_numChanges));
+}
+
+void RamSearch_Prune(char c, char o, char size, int isSigned, int aligned, int v, int p)
+{
+	// repetition-reducing macros
+	#define DO_SEARCH(sf) \
+	switch (o) \
+	{ \
+		case '<': DO_SEARCH_2(LessCmp,sf); break; \
+		case '>': DO_SEARCH_2(MoreCmp,sf); break; \
+		case '=': DO_SEARCH_2(EqualCmp,sf); break; \
+		case '!': DO_SEARCH_2(UnequalCmp,sf); break; \
+		case 'l': DO_SEARCH_2(LessEqualCmp,sf); break; \
+		case 'm': DO_SEARCH_2(MoreEqualCmp,sf); break; \
+		case 'd': DO_SEARCH_2(DiffByCmp,sf); break; \
+		case '%': DO_SEARCH_2(ModIsCmp,sf); break; \
+		default: assert(!"Invalid operator for this search type."); break; \
+	}
+
+	// perform the search, eliminating nonmatching values
+	switch (c)
+	{
+		#define DO_SEARCH_2(CmpFun,sf) CALL_WITH_T_SIZE_TYPES(sf, size, isSigned, aligned, CmpFun,v,p)
+		case 'r': DO_SEARCH(SearchRelative); break;
+		case 's': DO_SEARCH(SearchSpecific); break;
+
+		#undef DO_SEARCH_2
+		#define DO_SEARCH_2(CmpFun,sf) CALL_WITH_T_STEP(sf, size, unsigned,int, aligned, CmpFun,v,p);
+		case 'a': DO_SEARCH(SearchAddress); break;
+
+		#undef DO_SEARCH_2
+		#define DO_SEARCH_2(CmpFun,sf) CALL_WITH_T_STEP(sf, size, unsigned,short, aligned, CmpFun,v,p);
+		case 'n': DO_SEARCH(SearchChanges); break;
+
+		default: assert(!"Invalid search comparison type."); break;
+	}
+
+	s_prevValuesNeedUpdate = true;
+}
+
+template<typename stepType, typename T>
+bool CompareRelativeAtItem (bool(*cmpFun)(T,T,T), int itemIndex, T ignored, T param)
+{
+	return cmpFun(GetCurValueFromItemIndex<stepType,T>(itemIndex), GetPrevValueFromItemIndex<stepType,T>(itemIndex), param);
+}
+template<typename stepType, typename T>
+bool CompareSpecificAtItem (bool(*cmpFun)(T,T,T), int itemIndex, T value, T param)
+{
+	return cmpFun(GetCurValueFromItemIndex<stepType,T>(itemIndex), value, param);
+}
+template<typename stepType, typename T>
+bool CompareAddressAtItem (bool(*cmpFun)(T,T,T), int itemIndex, T address, T param)
+{
+	return cmpFun(GetHardwareAddressFromItemIndex<stepType,T>(itemIndex), address, param);
+}
+template<typename stepType, typename T>
+bool CompareChangesAtItem (bool(*cmpFun)(T,T,T), int itemIndex, T changes, T param)
+{
+	return cmpFun(GetNumChangesFromItemIndex<stepType,T>(itemIndex), changes, param);
+}
+
+int RamSearch_IsSatisfied(unsigned int itemIndex, char c, char o, char size, int isSigned, int aligned, int value, int param)
+{
+	switch (c)
+	{
+		#undef DO_SEARCH_2
+		#define DO_SEARCH_2(CmpFun,sf) return CALL_WITH_T_SIZE_TYPES(sf, size,isSigned,aligned, CmpFun,itemIndex,value,param);
+		case 'r': DO_SEARCH(CompareRelativeAtItem); break;
+		case 's': DO_SEARCH(CompareSpecificAtItem); break;
+
+		#undef DO_SEARCH_2
+		#define DO_SEARCH_2(CmpFun,sf) return CALL_WITH_T_STEP(sf, size, unsigned,int, aligned, CmpFun,itemIndex,value,param);
+		case 'a': DO_SEARCH(CompareAddressAtItem); break;
+
+		#undef DO_SEARCH_2
+		#define DO_SEARCH_2(CmpFun,sf) return CALL_WITH_T_STEP(sf, size, unsigned,short, aligned, CmpFun,itemIndex,value,param);
+		case 'n': DO_SEARCH(CompareChangesAtItem); break;
+	}
+	return 0;
+}
+
+unsigned int RamSearch_GetAddress(unsigned int itemIndex, char size, int aligned)
+{
+	return CALL_WITH_T_SIZE_TYPES(GetHardwareAddressFromItemIndex, size, 0, aligned, itemIndex);
+}
+
+unsigned int RamSearch_GetItemIndex(unsigned int address, char size, int aligned)
+{
+	return CALL_WITH_T_SIZE_TYPES(HardwareAddressToItemIndex, size, 0, aligned, address);
+}
+
+int RamSearch_GetCurValue(unsigned int itemIndex, char size, int isSigned, int aligned)
+{
+	return CALL_WITH_T_SIZE_TYPES(GetCurValueFromItemIndex, size, isSigned, aligned, itemIndex);
+}
+
+int RamSearch_GetPrevValue(unsigned int itemIndex, char size, int isSigned, int aligned)
+{
+	return CALL_WITH_T_SIZE_TYPES(GetPrevValueFromItemIndex, size, isSigned, aligned, itemIndex);
+}
+
+unsigned short RamSearch_GetNumChanges(unsigned int itemIndex, char size, int aligned)
+{
+	return CALL_WITH_T_SIZE_TYPES(GetNumChangesFromItemIndex, size, 0, aligned, itemIndex);
+}
+
+void RamSearch_EliminateRanges(const std::vector<RamSearchRange>& ranges, void (*progress)(int percent))
+{
+	// the ranges are in the same order as the regions,
+	// so build the surviving regions into a new list as we go
+	MemoryList survivors;
+	survivors.reserve(s_activeMemoryRegions.size() + ranges.size());
+	MemoryList::iterator iter = s_activeMemoryRegions.begin();
+	MemoryRegion region;
+	bool haveRegion = false; // true if region holds the (partly eliminated) region we're working on
+	int numRanges = (int)ranges.size();
+	for(int i = 0, j = 16; i < numRanges; ++i, --j)
+	{
+		unsigned int addr = ranges[i].addr;
+		unsigned int size = ranges[i].size;
+		bool affected = false;
+		for(;;)
+		{
+			if(!haveRegion)
+			{
+				if(iter == s_activeMemoryRegions.end())
+					break;
+				region = *iter++;
+				haveRegion = true;
+			}
+			MemoryRegion tailRegion;
+			int affNow = DeactivateRegion(region, tailRegion, addr, size);
+			if(affNow == 3)
+			{
+				survivors.push_back(region);
+				region = tailRegion;
+			}
+			else if(affNow == 2)
+			{
+				haveRegion = false;
+			}
+			else if(affNow || !affected)
+			{
+				survivors.push_back(region);
+				haveRegion = false;
+			}
+			if(affNow)
+				affected = true;
+			else if(affected)
+				break;
+		}
+
+		if(!j && progress) progress(i * 100 / numRanges), j = 16;
+	}
+	if(haveRegion)
+		survivors.push_back(region);
+	survivors.insert(survivors.end(), iter, s_activeMemoryRegions.end());
+	s_activeMemoryRegions.swap(survivors);
+	s_itemIndicesInvalid = TRUE;
+}
+
+int RamSearch_SaveUndo()
+{
+	if(s_activeMemoryRegions.size() < tooManyRegionsForUndo)
+	{
+		s_activeMemoryRegionsBackup = s_activeMemoryRegions;
+		return 1;
+	}
+	return 0;
+}
+
+void RamSearch_ClearUndo()
+{
+	s_activeMemoryRegionsBackup.clear();
+}
+
+int RamSearch_Undo()
+{
+	s_itemIndicesInvalid = TRUE;
+	if(s_activeMemoryRegions.size() < tooManyRegionsForUndo)
+	{
+		s_activeMemoryRegions.swap(s_activeMemoryRegionsBackup);
+		return 1;
+	}
+	s_activeMemoryRegions = s_activeMemoryRegionsBackup;
+	return 0;
+}
+
+inline bool IsInRange(unsigned int x, unsigned int min, unsigned int size)
+{
+	x -= min;
+	return x < size;
+}
+
+// copies a range of bytes out of an emulated memory array into big-endian (hardware) order
+void CopyFromSoftwareAddress(unsigned char* dst, const unsigned char* src, unsigned int length, int byteSwapped)
+{
+	if(!byteSwapped)
+	{
+		memcpy(dst, src, length);
+		return;
+	}
+
+	// the source is stored as little-endian words, so swap each pair of bytes
+	if(length && ((intptr_t)src & 1))
+	{
+		*dst++ = *((const unsigned char*)((intptr_t)src++^1));
+		length--;
+	}
+	const unsigned short* srcWords = (const unsigned short*)src;
+	for(unsigned int i = 0; i + 1 < length; i += 2)
+	{
+		unsigned short word = *srcWords++;
+		dst[i+0] = (unsigned char)(word >> 8);
+		dst[i+1] = (unsigned char)(word & 0xFF);
+	}
+	if(length & 1)
+		dst[length-1] = *((const unsigned char*)((intptr_t)(src+length-1)^1));
+}
+
+// number of bytes from address to the end of the address space it's in
+// (the 68000's 24 bits, or the 32X SDRAM), 0 outside of them.
+unsigned int HardwareAddressSpan(unsigned int address)
+{
+	if((address & ~0xFFFFFF) == ~0xFFFFFF)
+		address &= 0xFFFFFF;
+	if(address < 0x1000000)
+		return 0x1000000 - address;
+	if(IsInRange(address, s_32xRegion.hardwareAddress, s_32xRegion.size))
+		return s_32xRegion.hardwareAddress + s_32xRegion.size - address;
+	return 0;
+}
+
+// bulk version of ReadValueAtHardwareAddress,
+// copies length bytes starting at address into dst in big-endian (hardware) order.
+// bytes at invalid addresses are set to 0.
+// returns the number of bytes that came from valid addresses.
+unsigned int ReadBytesAtHardwareAddress(unsigned int address, unsigned char* dst, unsigned int length)
+{
+	if((address & ~0xFFFFFF) == ~0xFFFFFF)
+		address &= 0xFFFFFF;
+
+	MemoryRegion regions [6];
+	int numRegions = 0;
+	regions[numRegions++] = s_68kRegion;
+	regions[numRegions++] = s_z80Region;
+	if(SegaCD_Started)
+	{
+		regions[numRegions++] = s_prgRegion;
+		regions[numRegions++] = (Ram_Word_State & 0x2) ? s_word1MRegion : s_word2MRegion;
+	}
+	MemoryRegion romRegion = {0x0, Rom_Size, (unsigned char*)Rom_Data, true};
+	regions[numRegions++] = romRegion;
+	if(_32X_Started)
+		regions[numRegions++] = s_32xRegion;
+
+	unsigned int numValid = 0;
+	while(length)
+	{
+		// find the region containing this address, or else the distance to the next one
+		unsigned int chunk = length;
+		const MemoryRegion* found = NULL;
+		for(int i = 0; i < numRegions; i++)
+		{
+			const MemoryRegion& region = regions[i];
+			if(IsInRange(address, region.hardwareAddress, region.size))
+			{
+				found = &region;
+				chunk = (std::min)(chunk, region.hardwareAddress + region.size - address);
+				break;
+			}
+			if(region.hardwareAddress > address)
+				chunk = (std::min)(chunk, region.hardwareAddress - address);
+		}
+
+		if(found)
+		{
+			CopyFromSoftwareAddress(dst, found->softwareAddress + (address - found->hardwareAddress), chunk, found->byteSwapped);
+			numValid += chunk;
+		}
+		else
+		{
+			memset(dst, 0, chunk);
+		}
+
+		dst += chunk;
+		address += chunk;
+		length -= chunk;
+	}
+	return numValid;
+}
+
+// RAM history state
+int RamHistoryActive = 0;
+int RamHistoryStartFrame = -1;
+int RamHistoryEndFrame = 0;
+unsigned int RamHistoryAddress = 0xFF0000;
+unsigned int RamHistorySize = 0x10000;
+char RamHistoryQueryText[1024] = "";
+char RamHistoryOutPath[1024] = "";
+
+#define RAMHIST_KEYFRAME_INTERVAL 256                // frames between full copies (for random access)
+#define RAMHIST_MAX_BYTES (512 * 1024 * 1024)        // stop recording past this much history
+#define RAMHIST_MAX_SIZE (16 * 1024 * 1024)          // largest range that can be recorded
+
+// Internal state
+struct FrameRecord {
+	int frame;                           // FrameCount at the end of this frame
+	std::vector<unsigned int> planes;    // summary bitmap, then changed words, then increased words
+	unsigned int numWords;               // number of changed (and increased) words stored
+	std::vector<unsigned char> values;   // new values of the changed bytes, in address order
+	std::vector<unsigned char> keyframe; // full copy every RAMHIST_KEYFRAME_INTERVAL frames
+};
+
+static std::vector<FrameRecord> frames;
+static unsigned int rec_address = 0;
+static unsigned int rec_size = 0;
+static unsigned int rec_words = 0;          // plane words (32 bytes each)
+static unsigned int rec_summary_words = 0;  // summary bitmap words
+static unsigned int total_bytes = 0;
+static std::vector<unsigned char> prev_values;
+static std::vector<unsigned char> cur_values;
+static int cmdline_started = 0;
+static int cmdline_finished = 0;
+
+// index of the lowest set bit (x must be nonzero)
+static inline int lowest_bit(unsigned int x)
+{
+	static const int debruijn[32] = {
+		0, 1, 28, 2, 29, 14, 24, 3, 30, 22, 20, 15, 25, 17, 4, 8,
+		31, 27, 13, 23, 21, 19, 16, 7, 26, 12, 18, 6, 11, 5, 10, 9
+	};
+	return debruijn[((x & (0 - x)) * 0x077CB531u) >> 27];
+}
+
+static void record_frame(int frameCount)
+{
+	ReadBytesAtHardwareAddress(rec_address, &cur_values[0], rec_size);
+
+	frames.push_back(FrameRecord());
+	FrameRecord& rec = frames.back();
+	rec.frame = frameCount;
+	rec.numWords = 0;
+
+	if (frames.size() > 1)
+	{
+		std::vector<unsigned int> changedWords, increasedWords;
+		rec.planes.assign(rec_summary_words, 0);
+
+		for (unsigned int w = 0; w < rec_words; w++)
+		{
+			unsigned int base = w * 32;
+			unsigned int count = (std::min)(32u, rec_size - base);
+			if (memcmp(&prev_values[base], &cur_values[base], count) == 0)
+				continue;
+
+			unsigned int changed = 0, increased = 0;
+			for (unsigned int b = 0; b < count; b++)
+			{
+				unsigned char value = cur_values[base + b];
+				if (value != prev_values[base + b])
+				{
+					changed |= 1u << b;
+					if (value > prev_values[base + b])
+						increased |= 1u << b;
+					rec.values.push_back(value);
+				}
+			}
+			rec.planes[w >> 5] |= 1u << (w & 31);
+			changedWords.push_back(changed);
+			increasedWords.push_back(increased);
+		}
+
+		rec.numWords = (unsigned int)changedWords.size();
+		rec.planes.insert(rec.planes.end(), changedWords.begin(), changedWords.end());
+		rec.planes.insert(rec.planes.end(), increasedWords.begin(), increasedWords.end());
+	}
+
+	if ((frames.size() - 1) % RAMHIST_KEYFRAME_INTERVAL == 0)
+		rec.keyframe = cur_values;
+
+	total_bytes += sizeof(FrameRecord) + rec.planes.size() * sizeof(unsigned int) + rec.values.size() + rec.keyframe.size();
+	prev_values.swap(cur_values);
+
+	if (total_bytes > RAMHIST_MAX_BYTES)
+	{
+		fprintf(stderr, "ram history: stopped recording at frame %d, history is too large\n", frameCount);
+		RamHistoryActive = 0;
+	}
+}
+
+// applies the changes of frame index f to values, which must hold frame f-1
+static void apply_frame(size_t f, unsigned char* values)
+{
+	const FrameRecord& rec = frames[f];
+	if (rec.numWords == 0)
+		return;
+
+	const unsigned int* summary = &rec.planes[0];
+	const unsigned int* changed = summary + rec_summary_words;
+	const unsigned char* newValue = &rec.values[0];
+
+	for (unsigned int sw = 0; sw < rec_summary_words; sw++)
+	{
+		for (unsigned int blocks = summary[sw]; blocks; blocks &= blocks - 1)
+		{
+			unsigned int base = (sw * 32 + lowest_bit(blocks)) * 32;
+			for (unsigned int bits = *changed++; bits; bits &= bits - 1)
+				values[base + lowest_bit(bits)] = *newValue++;
+		}
+	}
+}
+
+// expands the sparse planes of frame index f into dense rec_words-sized arrays
+static void expand_planes(size_t f, unsigned int* changedOut, unsigned int* increasedOut)
+{
+	memset(changedOut, 0, rec_words * sizeof(unsigned int));
+	memset(increasedOut, 0, rec_words * sizeof(unsigned int));
+
+	const FrameRecord& rec = frames[f];
+	if (rec.numWords == 0)
+		return;
+
+	const unsigned int* summary = &rec.planes[0];
+	const unsigned int* changed = summary + rec_summary_words;
+	const unsigned int* increased = changed + rec.numWords;
+
+	for (unsigned int sw = 0; sw < rec_summary_words; sw++)
+	{
+		for (unsigned int blocks = summary[sw]; blocks; blocks &= blocks - 1)
+		{
+			unsigned int w = sw * 32 + lowest_bit(blocks);
+			changedOut[w] = *changed++;
+			increasedOut[w] = *increased++;
+		}
+	}
+}
+
+// size letter of the RAM search for an item size in bytes
+static char size_type(int size)
+{
+	return size == 1 ? 'b' : size == 2 ? 'w' : 'd';
+}
+
+// reads a big-endian item as the comparison type of the RAM search
+template<typename stepType, typename T>
+int ReadItemT(const unsigned char* data)
+{
+	return (int)ReadBigEndian<T>(data);
+}
+
+static int is_change_op(int op)
+{
+	return op == RAMHIST_CHANGED || op == RAMHIST_UNCHANGED || op == RAMHIST_INCREASED
+		|| op == RAMHIST_DECREASED || op == RAMHIST_CHANGED_BY;
+}
+
+// replays the values frame by frame and tests the remaining candidates,
+// items are read and compared like the RAM search does
+template<typename stepType, typename T>
+void ReplaySearchT(const RamHistoryQuery& query, const std::vector<int>& required, std::vector<unsigned int>& candidates)
+{
+	bool (*cmpFun)(T,T,T);
+	switch (query.op)
+	{
+		case RAMHIST_CHANGED:       cmpFun = UnequalCmp<T>; break;
+		case RAMHIST_UNCHANGED:     cmpFun = EqualCmp<T>; break;
+		case RAMHIST_INCREASED:     cmpFun = MoreCmp<T>; break;
+		case RAMHIST_DECREASED:     cmpFun = LessCmp<T>; break;
+		case RAMHIST_CHANGED_BY:    cmpFun = EqualCmp<T>; break; // on the difference
+		case RAMHIST_EQUAL:         cmpFun = EqualCmp<T>; break;
+		case RAMHIST_NOT_EQUAL:     cmpFun = UnequalCmp<T>; break;
+		case RAMHIST_LESS:          cmpFun = LessCmp<T>; break;
+		case RAMHIST_GREATER:       cmpFun = MoreCmp<T>; break;
+		case RAMHIST_LESS_EQUAL:    cmpFun = LessEqualCmp<T>; break;
+		default:                    cmpFun = MoreEqualCmp<T>; break;
+	}
+	int changeOp = is_change_op(query.op);
+	T operand = (T)query.value;
+
+	size_t numFrames = frames.size();
+	std::vector<unsigned char> values = frames[0].keyframe;
+	std::vector<unsigned char> prev(values.size());
+
+	for (size_t f = 0; f < numFrames; f++)
+	{
+		if (f > 0)
+		{
+			if (required[f] >= 0 && changeOp)
+				memcpy(&prev[0], &values[0], values.size());
+			apply_frame(f, &values[0]);
+		}
+		if (required[f] < 0)
+			continue;
+
+		for (unsigned int w = 0; w < rec_words; w++)
+		{
+			for (unsigned int bits = candidates[w]; bits; bits &= bits - 1)
+			{
+				int bit = lowest_bit(bits);
+				unsigned int offset = w * 32 + bit;
+				T cur = ReadBigEndian<T>(&values[offset]);
+				int result;
+				if (query.op == RAMHIST_CHANGED_BY)
+					result = cmpFun((T)(cur - ReadBigEndian<T>(&prev[offset])), operand, 0);
+				else if (changeOp)
+					result = cmpFun(cur, ReadBigEndian<T>(&prev[offset]), 0);
+				else
+					result = cmpFun(cur, operand, 0);
+				if (result != required[f])
+					candidates[w] &= ~(1u << bit);
+			}
+		}
+	}
+}
+
+int RamHistory_Start(unsigned int address, unsigned int size)
+{
+	if (size == 0 || size > RAMHIST_MAX_SIZE)
+		return 0;
+
+	RamHistory_Clear();
+
+	rec_address = address;
+	rec_size = size;
+	rec_words = (size + 31) / 32;
+	rec_summary_words = (rec_words + 31) / 32;
+	prev_values.assign(size, 0);
+	cur_values.assign(size, 0);
+
+	RamHistoryActive = 1;
+	return 1;
+}
+
+void RamHistory_Stop()
+{
+	RamHistoryActive = 0;
+}
+
+void RamHistory_Clear()
+{
+	RamHistoryActive = 0;
+	frames.clear();
+	total_bytes = 0;
+}
+
+int RamHistory_OnFrame(int frameCount)
+{
+	PROF_SCOPE(PROF_RAM_SEARCH);
+
+	// Command-line recording, possibly delayed
+	if (RamHistoryStartFrame >= 0 && !cmdline_started && frameCount >= RamHistoryStartFrame)
+	{
+		cmdline_started = 1;
+		if (!RamHistory_Start(RamHistoryAddress, RamHistorySize))
+			fprintf(stderr, "ram history: invalid range %06X:%X\n", RamHistoryAddress, RamHistorySize);
+	}
+
+	if (!RamHistoryActive)
+		return 0;
+
+	record_frame(frameCount);
+
+	// the end frame, or the size limit stopped the recording early
+	if (cmdline_started && ((RamHistoryEndFrame > 0 && frameCount >= RamHistoryEndFrame) || !RamHistoryActive))
+	{
+		RamHistory_Finish();
+		return 1;
+	}
+
+	return 0;
+}
+
+void RamHistory_Finish()
+{
+	if (!cmdline_started || cmdline_finished)
+		return;
+	cmdline_finished = 1;
+	RamHistory_Stop();
+
+	if (RamHistoryQueryText[0])
+	{
+		RamHistoryQuery query;
+		const char* error = RamHistory_ParseQuery(RamHistoryQueryText, query);
+		if (error)
+		{
+			fprintf(stderr, "ram history: bad query \"%s\": %s\n", RamHistoryQueryText, error);
+		}
+		else
+		{
+			std::vector<unsigned int> results = RamHistory_Search(query);
+			fprintf(stderr, "ram history: %u matches over %u frames\n", (unsigned int)results.size(), (unsigned int)frames.size());
+			if (RamHistoryOutPath[0] && !RamHistory_WriteResults(RamHistoryOutPath, results))
+				fprintf(stderr, "ram history: could not write \"%s\"\n", RamHistoryOutPath);
+		}
+	}
+}
+
+int RamHistory_GetFrames(int* firstFrame, int* lastFrame)
+{
+	if (firstFrame) *firstFrame = frames.empty() ? 0 : frames.front().frame;
+	if (lastFrame) *lastFrame = frames.empty() ? 0 : frames.back().frame;
+	return (int)frames.size();
+}
+
+int RamHistory_GetValue(unsigned int address, int frame, int size, int isSigned, int* value)
+{
+	if (size != 1 && size != 2 && size != 4)
+		return 0;
+	unsigned int offset = address - rec_address;
+	if (offset >= rec_size || offset + size > rec_size)
+		return 0;
+
+	// latest recording of that frame number (loading a state can repeat frame numbers)
+	size_t f = frames.size();
+	while (f > 0 && frames[f - 1].frame != frame)
+		f--;
+	if (f == 0)
+		return 0;
+	f--;
+
+	size_t key = f - f % RAMHIST_KEYFRAME_INTERVAL;
+	std::vector<unsigned char> values = frames[key].keyframe;
+	for (size_t i = key + 1; i <= f; i++)
+		apply_frame(i, &values[0]);
+
+	*value = CALL_WITH_T_SIZE_TYPES(ReadItemT, size_type(size), isSigned, true, &values[offset]);
+	return 1;
+}
+
+int RamHistory_OpFromName(const char* name)
+{
+	static const char* const names[] = {
+		"changed", "unchanged", "increased", "decreased", "changedby",
+		"equal", "notequal", "less", "greater", "lessequal", "greaterequal",
+	};
+	for (int i = 0; i < (int)(sizeof(names) / sizeof(names[0])); i++)
+		if (!strcmp(name, names[i]))
+			return i;
+	return -1;
+}
+
+int RamHistory_SizeFromName(const char* name)
+{
+	if (!strcmp(name, "b") || !strcmp(name, "1")) return 1;
+	if (!strcmp(name, "w") || !strcmp(name, "2")) return 2;
+	if (!strcmp(name, "d") || !strcmp(name, "l") || !strcmp(name, "4")) return 4;
+	return -1;
+}
+
+const char* RamHistory_ParseQuery(const char* text, RamHistoryQuery& query)
+{
+	query.op = -1;
+	query.size = 1;
+	query.isSigned = 0;
+	query.value = 0;
+	query.frames.clear();
+	query.exact = 0;
+	query.firstFrame = -1;
+	query.lastFrame = -1;
+
+	char buffer[1024];
+	strncpy(buffer, text, sizeof(buffer) - 1);
+	buffer[sizeof(buffer) - 1] = '\0';
+
+	for (char* pair = strtok(buffer, ","); pair; pair = strtok(NULL, ","))
+	{
+		char* value = strchr(pair, '=');
+		if (!value)
+			return "expected key=value";
+		*value++ = '\0';
+
+		if (!strcmp(pair, "op"))
+		{
+			if ((query.op = RamHistory_OpFromName(value)) < 0)
+				return "unknown op";
+		}
+		else if (!strcmp(pair, "size"))
+		{
+			if ((query.size = RamHistory_SizeFromName(value)) < 0)
+				return "size must be b, w or d";
+		}
+		else if (!strcmp(pair, "signed"))
+			query.isSigned = atoi(value) != 0;
+		else if (!strcmp(pair, "value"))
+			query.value = (int)strtoul(value, NULL, 0);
+		else if (!strcmp(pair, "exact"))
+			query.exact = atoi(value) != 0;
+		else if (!strcmp(pair, "from"))
+			query.firstFrame = atoi(value);
+		else if (!strcmp(pair, "to"))
+			query.lastFrame = atoi(value);
+		else if (!strcmp(pair, "frames"))
+		{
+			for (char* end = value; *value; value = end)
+			{
+				query.frames.push_back((int)strtol(value, &end, 10));
+				if (*end == ';')
+					end++;
+				else if (*end)
+					return "frames must be separated by ';'";
+			}
+		}
+		else
+			return "unknown key";
+	}
+
+	if (query.op < 0)
+		return "missing op";
+	return NULL;
+}
+
+std::vector<unsigned int> RamHistory_Search(const RamHistoryQuery& query)
+{
+	std::vector<unsigned int> results;
+	size_t numFrames = frames.size();
+	int size = query.size;
+	if (numFrames == 0 || (size != 1 && size != 2 && size != 4))
+		return results;
+
+	int firstFrame = query.firstFrame < 0 ? frames.front().frame : query.firstFrame;
+	int lastFrame = query.lastFrame < 0 ? frames.back().frame : query.lastFrame;
+	int changeOp = is_change_op(query.op);
+
+	// which recorded frames to evaluate, and what the predicate must be on each
+	std::vector<int> required(numFrames, -1); // -1 = don't care, 0 = must be false, 1 = must be true
+	std::vector<int> wanted(query.frames);
+	std::sort(wanted.begin(), wanted.end());
+	for (size_t f = 0; f < numFrames; f++)
+	{
+		int frame = frames[f].frame;
+		if (frame < firstFrame || frame > lastFrame || (changeOp && f == 0))
+			continue;
+		if (wanted.empty() || std::binary_search(wanted.begin(), wanted.end(), frame))
+			required[f] = 1;
+		else if (query.exact)
+			required[f] = 0;
+	}
+
+	// candidate bitset over byte offsets, starting with every aligned item
+	std::vector<unsigned int> candidates(rec_words, 0);
+	for (unsigned int offset = (size - rec_address % size) % size; offset + size <= rec_size; offset += size)
+		candidates[offset >> 5] |= 1u << (offset & 31);
+
+	if (size == 1 && (query.op == RAMHIST_CHANGED || query.op == RAMHIST_UNCHANGED
+		|| (!query.isSigned && (query.op == RAMHIST_INCREASED || query.op == RAMHIST_DECREASED))))
+	{
+		// byte-sized change predicates come straight from the bit planes, 32 addresses per step
+		std::vector<unsigned int> changed(rec_words), increased(rec_words);
+		for (size_t f = 1; f < numFrames; f++)
+		{
+			if (required[f] < 0)
+				continue;
+			expand_planes(f, &changed[0], &increased[0]);
+			for (unsigned int w = 0; w < rec_words; w++)
+			{
+				unsigned int bits;
+				switch (query.op)
+				{
+					case RAMHIST_CHANGED:   bits = changed[w]; break;
+					case RAMHIST_UNCHANGED: bits = ~changed[w]; break;
+					case RAMHIST_INCREASED: bits = increased[w]; break;
+					default:                bits = changed[w] & ~increased[w]; break;
+				}
+				candidates[w] &= required[f] ? bits : ~bits;
+			}
+		}
+	}
+	else
+	{
+		// everything else replays the values and tests the remaining candidates
+		CALL_WITH_T_SIZE_TYPES(ReplaySearchT, size_type(size), query.isSigned, true, query, required, candidates);
+	}
+
+	for (unsigned int w = 0; w < rec_words; w++)
+		for (unsigned int bits = candidates[w]; bits; bits &= bits - 1)
+			results.push_back(rec_address + w * 32 + lowest_bit(bits));
+	return results;
+}
+
+int RamHistory_WriteResults(const char* path, const std::vector<unsigned int>& results)
+{
+	FILE* file = fopen(path, "w");
+	if (!file)
+		return 0;
+	for (size_t i = 0; i < results.size(); i++)
+		fprintf(file, "%06X\n", results[i]);
+	fclose(file);
+	return 1;
+}
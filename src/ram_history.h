@@ -0,0 +1,150 @@
+// RAM search and RAM history search for Gens-rr emulator
+// The RAM search narrows down the live RAM one comparison at a time; the RAM search
+// window (ram_search.cpp) is a view of it. The RAM history records a range of RAM
+// every frame over a movie segment and runs predicate searches across the whole
+// recording ("increased on exactly these frames").
+// No UI dependencies: the history is driven from Lua (ramhistory.*) and the command line (-ramhist-*).
+
+#ifndef RAM_HISTORY_H
+#define RAM_HISTORY_H
+
+#include <vector>
+
+// RAM search
+// Items are described by a size letter ('b', 'w' or 'd'), signedness, and whether
+// word and long items have to start at even addresses (aligned). Item indices count
+// the remaining items in address order.
+
+struct RamSearchRange {
+	unsigned int addr;
+	unsigned int size;
+};
+
+// Make every RAM address of the running game searchable again
+void RamSearch_ResetRegions();
+
+// Eliminate every address
+void RamSearch_ClearRegions();
+
+// Number of contiguous address ranges and of items left
+int RamSearch_NumRegions();
+int RamSearch_NumItems(char size, int isSigned, int aligned);
+
+// Read the current values and count the changes, called once per frame
+void RamSearch_Update(char size, int isSigned, int aligned);
+
+// Whether the next update also copies the current values to the previous ones
+void RamSearch_SetPrevValuesNeedUpdate(int needUpdate);
+int RamSearch_PrevValuesNeedUpdate();
+void RamSearch_CopyCurToPrev();
+void RamSearch_ResetChanges();
+
+// Eliminate the items that fail a comparison
+//   c: 'r' previous value, 's' specific value (v), 'a' address (v), 'n' number of changes (v)
+//   o: '<' '>' '=' '!' 'l' (<=) 'm' (>=) 'd' (differs by p) '%' (modulo p is v)
+void RamSearch_Prune(char c, char o, char size, int isSigned, int aligned, int v, int p);
+
+// Whether an item passes the comparison
+// Returns: nonzero if it does
+int RamSearch_IsSatisfied(unsigned int itemIndex, char c, char o, char size, int isSigned, int aligned, int value, int param);
+
+// Item accessors
+// Returns: the address of an item / the item at an address (-1 if eliminated)
+unsigned int RamSearch_GetAddress(unsigned int itemIndex, char size, int aligned);
+unsigned int RamSearch_GetItemIndex(unsigned int address, char size, int aligned);
+int RamSearch_GetCurValue(unsigned int itemIndex, char size, int isSigned, int aligned);
+int RamSearch_GetPrevValue(unsigned int itemIndex, char size, int isSigned, int aligned);
+unsigned short RamSearch_GetNumChanges(unsigned int itemIndex, char size, int aligned);
+
+// Eliminate address ranges, which must be in ascending order
+// progress (if not NULL) is called with 0-100 now and then
+void RamSearch_EliminateRanges(const std::vector<RamSearchRange>& ranges, void (*progress)(int percent));
+
+// Undo: save the current list of addresses, swap it with the saved one
+// Returns: SaveUndo 0 if the list is too long to save; Undo 0 if it was too long to keep for redo
+int RamSearch_SaveUndo();
+void RamSearch_ClearUndo();
+int RamSearch_Undo();
+
+// RAM history
+
+// Predicate operators
+enum RamHistoryOp {
+	RAMHIST_CHANGED = 0,     // value differs from the previous recorded frame
+	RAMHIST_UNCHANGED,
+	RAMHIST_INCREASED,
+	RAMHIST_DECREASED,
+	RAMHIST_CHANGED_BY,      // value - previous value == query value
+	RAMHIST_EQUAL,           // value at the end of the frame compared against query value
+	RAMHIST_NOT_EQUAL,
+	RAMHIST_LESS,
+	RAMHIST_GREATER,
+	RAMHIST_LESS_EQUAL,
+	RAMHIST_GREATER_EQUAL,
+};
+
+struct RamHistoryQuery {
+	int op;                  // RamHistoryOp
+	int size;                // item size in bytes (1, 2 or 4), items are aligned to their size
+	int isSigned;            // compare values as signed
+	int value;               // operand for CHANGED_BY and the value comparisons
+	std::vector<int> frames; // frame numbers the predicate must hold on (empty = every frame in the window)
+	int exact;               // also require the predicate to be false on every other frame in the window
+	int firstFrame;          // window of frames to look at (inclusive, -1 = from the start of the recording)
+	int lastFrame;           // (-1 = to the end of the recording)
+};
+
+// Global state variables (command-line driven recording)
+extern int RamHistoryActive;            // Recording is currently active
+extern int RamHistoryStartFrame;        // Frame to start recording (-1 = not set up from the command line)
+extern int RamHistoryEndFrame;          // Frame to stop recording (0 = no limit)
+extern unsigned int RamHistoryAddress;  // First hardware address recorded (default 0xFF0000)
+extern unsigned int RamHistorySize;     // Number of bytes recorded (default 64 KB)
+extern char RamHistoryQueryText[1024];  // Query to run when the command-line recording ends
+extern char RamHistoryOutPath[1024];    // Where to write the query results
+
+// Start a new recording of [address, address+size), discarding the previous one
+// Returns: 1 on success, 0 if the range is invalid
+int RamHistory_Start(unsigned int address, unsigned int size);
+
+// Stop recording (the history stays available for searches)
+void RamHistory_Stop();
+
+// Discard the recording
+void RamHistory_Clear();
+
+// Called every emulated frame, records a frame while active
+// Returns: 1 when a command-line recording has finished and written its results (the caller should exit)
+int RamHistory_OnFrame(int frameCount);
+
+// Run the command-line query and write its results if that hasn't happened yet
+// (a recording without an end frame, called on exit)
+void RamHistory_Finish();
+
+// Recorded frame range
+// Returns: number of frames recorded, first/last frame numbers through the pointers
+int RamHistory_GetFrames(int* firstFrame, int* lastFrame);
+
+// Value of an item at the end of a recorded frame (big-endian, like memory.readword)
+// Returns: 1 on success, 0 if the frame or address was not recorded
+int RamHistory_GetValue(unsigned int address, int frame, int size, int isSigned, int* value);
+
+// Operator and size names used by the query text and the Lua table form
+// Returns: RamHistoryOp / size in bytes, or -1 if unknown
+int RamHistory_OpFromName(const char* name);
+int RamHistory_SizeFromName(const char* name);
+
+// Parse a query from text, comma-separated key=value pairs:
+//   op=increased,size=w,signed=1,value=3,frames=120;340;560,exact=1,from=100,to=900
+// Returns: NULL on success, otherwise an error message
+const char* RamHistory_ParseQuery(const char* text, RamHistoryQuery& query);
+
+// Run a query over the recording
+// Returns: the hardware addresses of the matching items, in ascending order
+std::vector<unsigned int> RamHistory_Search(const RamHistoryQuery& query);
+
+// Write search results as one hex address per line
+// Returns: 1 on success, 0 on failure
+int RamHistory_WriteResults(const char* path, const std::vector<unsigned int>& results);
+
+#endif // RAM_HISTORY_H
@@ -1,28 +1,6 @@
-// A few notes about this implementation of a RAM search window:
-//
-// Speed of update was one of the highest priories.
-// This is because I wanted the RAM search window to be able to
-// update every single value in RAM every single frame, and
-// keep track of the exact number of frames across which each value has changed,
-// without causing the emulation to run noticeably slower than normal.
-//
-// The data representation was changed from one entry per valid address
-// to one entry per contiguous range of uneliminated addresses
-// which references uniform pools of per-address properties.
-// - This saves time when there are many items because
-//   it minimizes the amount of data that needs to be stored and processed per address.
-// - It also saves time when there are few items because
-//   it ensures that no time is wasted in iterating through
-//   addresses that have already been eliminated from the search.
-//
-// The worst-case scenario is when every other item has been
-// eliminated from the search, maximizing the number of regions.
-// This implementation manages to handle even that pathological case
-// acceptably well. In fact, it still updates faster than the previous implementation.
-// The time spent setting up or clearing such a large number of regions
-// is somewhat horrendous, but it seems reasonable to have poor worst-case speed
-// during these sporadic "setup" steps to achieve an all-around faster per-update speed.
-// (You can test this case by performing the search: Modulo 2 Is Specific Address 0)
+// RAM search window
+// The search itself (the list of uneliminated addresses, their values and change counts,
+// and the comparisons) is in ram_history.cpp; this file shows it and drives it from the controls.
 
 #include "resource.h"
 #include "gens.h"
@@ -32,8 +10,10 @@
 #include "misc.h"
 #include "mem_z80.h"
 #include "vdp_io.h"
+#include "vdp_rend.h"
 #include "save.h"
 #include "ram_search.h"
+#include "ram_history.h"
 #include "hexeditor.h"
 #include "g_main.h"
 #include <assert.h>
@@ -41,7 +21,7 @@
 #include "G_dsound.h"
 #include "ramwatch.h"
 #include "luascript.h"
-#include <list>
+#include "frame_prof.h"
 #include <vector>
 #ifdef _WIN32
    #include "BaseTsd.h"
@@ -50,523 +30,14 @@
    #include "stdint.h"
 #endif
 
-
-struct MemoryRegion
-{
-	unsigned int hardwareAddress; // hardware address of the start of this region
-	unsigned int size; // number of bytes to the end of this region
-	unsigned char* softwareAddress; // pointer to the start of the live emulator source values for this region
-	BOOL byteSwapped; // true if this is a byte-swapped region of memory
-
-	unsigned int virtualIndex; // index into s_prevValues, s_curValues, and s_numChanges, valid after being initialized in ResetMemoryRegions()
-	unsigned int itemIndex; // index into listbox items, valid when s_itemIndicesInvalid is false
-};
-
-ALIGN16 static unsigned char s_prevValues [MAX_RAM_SIZE+4] = {0}; // values at last search or reset
-ALIGN16 static unsigned char s_curValues [MAX_RAM_SIZE+4] = {0}; // values at last frame update
-ALIGN16 static unsigned short s_numChanges [MAX_RAM_SIZE+4] = {0}; // number of changes of the item starting at this virtual index address
-static MemoryRegion* s_itemIndexToRegionPointer [MAX_RAM_SIZE+4] = {0}; // used for random access into the memory list (trading memory size to get speed here, too bad it's so much memory), only valid when s_itemIndicesInvalid is false
-static BOOL s_itemIndicesInvalid = true; // if true, the link from listbox items to memory regions (s_itemIndexToRegionPointer) and the link from memory regions to list box items (MemoryRegion::itemIndex) both need to be recalculated
-static BOOL s_prevValuesNeedUpdate = true; // if true, the "prev" values should be updated using the "cur" values on the next frame update signaled
-static unsigned int s_maxItemIndex = 0; // max currently valid item index, the listbox sometimes tries to update things past the end of the list so we need to know this to ignore those attempts
-
-static const MemoryRegion s_prgRegion    = {  0x020000, SEGACD_RAM_PRG_SIZE, (unsigned char*)Ram_Prg,     true};
-static const MemoryRegion s_word1MRegion = {  0x200000, SEGACD_1M_RAM_SIZE,  (unsigned char*)Ram_Word_1M, true};
-static const MemoryRegion s_word2MRegion = {  0x200000, SEGACD_2M_RAM_SIZE,  (unsigned char*)Ram_Word_2M, true};
-static const MemoryRegion s_z80Region    = {  0xA00000, Z80_RAM_SIZE,        (unsigned char*)Ram_Z80,     true};
-static const MemoryRegion s_68kRegion    = {  0xFF0000, _68K_RAM_SIZE,       (unsigned char*)Ram_68k,     true};
-static const MemoryRegion s_32xRegion    = {0x06000000, _32X_RAM_SIZE,       (unsigned char*)_32X_Ram,    false};
-
-// list of contiguous uneliminated memory regions
-typedef std::list<MemoryRegion> MemoryList;
-static MemoryList s_activeMemoryRegions;
-
-// for undo support (could be better, but this way was really easy)
-static MemoryList s_activeMemoryRegionsBackup;
 static int s_undoType = 0; // 0 means can't undo, 1 means can undo, 2 means can redo
 
 void RamSearchSaveUndoStateIfNotTooBig(HWND hDlg);
-static const int tooManyRegionsForUndo = 10000;
 
 void ResetMemoryRegions()
 {
 	Clear_Sound_Buffer();
-
-	s_activeMemoryRegions.clear();
-	if(Game)
-	{
-		s_activeMemoryRegions.push_back(s_68kRegion);
-		s_activeMemoryRegions.push_back(s_z80Region);
-		if(SegaCD_Started)
-		{
-			s_activeMemoryRegions.push_back(s_prgRegion);
-			s_activeMemoryRegions.push_back((Ram_Word_State & 0x2) ? s_word1MRegion : s_word2MRegion);
-		}
-		if(_32X_Started)
-		{
-			s_activeMemoryRegions.push_back(s_32xRegion);
-		}
-	}
-
-	int nextVirtualIndex = 0;
-	for(MemoryList::iterator iter = s_activeMemoryRegions.begin(); iter != s_activeMemoryRegions.end(); ++iter)
-	{
-		MemoryRegion& region = *iter;
-		region.virtualIndex = nextVirtualIndex;
-		assert(((intptr_t)region.softwareAddress & 1) == 0 && "somebody need to reimplement ReadValueAtSoftwareAddress()");
-		nextVirtualIndex = region.virtualIndex + region.size;
-	}
-	assert(nextVirtualIndex <= MAX_RAM_SIZE);
-}
-
-// eliminates a range of hardware addresses from the search results
-// returns 2 if it changed the region and moved the iterator to another region
-// returns 1 if it changed the region but didn't move the iterator
-// returns 0 if it had no effect
-// warning: don't call anything that takes an itemIndex in a loop that calls DeactivateRegion...
-//   doing so would be tremendously slow because DeactivateRegion invalidates the index cache
-int DeactivateRegion(MemoryRegion& region, MemoryList::iterator& iter, unsigned int hardwareAddress, unsigned int size)
-{
-	if(hardwareAddress + size <= region.hardwareAddress || hardwareAddress >= region.hardwareAddress + region.size)
-	{
-		// region is unaffected
-		return 0;
-	}
-	else if(hardwareAddress > region.hardwareAddress && hardwareAddress + size >= region.hardwareAddress + region.size)
-	{
-		// erase end of region
-		region.size = hardwareAddress - region.hardwareAddress;
-		return 1;
-	}
-	else if(hardwareAddress <= region.hardwareAddress && hardwareAddress + size < region.hardwareAddress + region.size)
-	{
-		// erase start of region
-		int eraseSize = (hardwareAddress + size) - region.hardwareAddress;
-		region.hardwareAddress += eraseSize;
-		region.size -= eraseSize;
-		region.softwareAddress += eraseSize;
-		region.virtualIndex += eraseSize;
-		return 1;
-	}
-	else if(hardwareAddress <= region.hardwareAddress && hardwareAddress + size >= region.hardwareAddress + region.size)
-	{
-		// erase entire region
-		iter = s_activeMemoryRegions.erase(iter);
-		s_itemIndicesInvalid = TRUE;
-		return 2;
-	}
-	else //if(hardwareAddress > region.hardwareAddress && hardwareAddress + size < region.hardwareAddress + region.size)
-	{
-		// split region
-		int eraseSize = (hardwareAddress + size) - region.hardwareAddress;
-		MemoryRegion region2 = {region.hardwareAddress + eraseSize, region.size - eraseSize, region.softwareAddress + eraseSize, region.byteSwapped, region.virtualIndex + eraseSize};
-		region.size = hardwareAddress - region.hardwareAddress;
-		iter = s_activeMemoryRegions.insert(++iter, region2);
-		s_itemIndicesInvalid = TRUE;
-		return 2;
-	}
-}
-
-/*
-// eliminates a range of hardware addresses from the search results
-// this is a simpler but usually slower interface for the above function
-void DeactivateRegion(unsigned int hardwareAddress, unsigned int size)
-{
-	for(MemoryList::iterator iter = s_activeMemoryRegions.begin(); iter != s_activeMemoryRegions.end(); )
-	{
-		MemoryRegion& region = *iter;
-		if(2 != DeactivateRegion(region, iter, hardwareAddress, size))
-			++iter;
-	}
-}
-*/
-
-// warning: can be slow
-void CalculateItemIndices(int itemSize)
-{
-	unsigned int itemIndex = 0;
-	for(MemoryList::iterator iter = s_activeMemoryRegions.begin(); iter != s_activeMemoryRegions.end(); ++iter)
-	{
-		MemoryRegion& region = *iter;
-		region.itemIndex = itemIndex;
-		int startSkipSize = ((unsigned int)(itemSize - region.hardwareAddress)) % itemSize;
-		unsigned int start = startSkipSize;
-		unsigned int end = region.size;
-		for(unsigned int i = start; i < end; i += itemSize)
-			s_itemIndexToRegionPointer[itemIndex++] = &region;
-	}
-	s_maxItemIndex = itemIndex;
-	s_itemIndicesInvalid = FALSE;
-}
-
-template<typename stepType, typename compareType, int swapXOR>
-void UpdateRegionT(const MemoryRegion& region, const MemoryRegion* nextRegionPtr)
-{
-	if(s_prevValuesNeedUpdate)
-		memcpy(s_prevValues + region.virtualIndex, s_curValues + region.virtualIndex, region.size + sizeof(compareType) - sizeof(stepType));
-
-	unsigned int startSkipSize = ((unsigned int)(sizeof(stepType) - region.hardwareAddress)) % sizeof(stepType);
-
-	unsigned char* sourceAddr = region.softwareAddress - region.virtualIndex;
-	unsigned int indexStart = region.virtualIndex + startSkipSize;
-	unsigned int indexEnd = region.virtualIndex + region.size;
-
-	if(sizeof(compareType) == 1)
-	{
-		for(unsigned int i = indexStart; i < indexEnd; i++)
-		{
-			if(s_curValues[i] != sourceAddr[i^swapXOR]) // if value changed
-			{
-				s_curValues[i] = sourceAddr[i^swapXOR]; // update value
-				//if(s_numChanges[i] != 0xFFFF)
-					s_numChanges[i]++; // increase change count
-			}
-		}
-	}
-	else // it's more complicated for non-byte sizes because:
-	{    // - more than one byte can affect a given change count entry
-	     // - when more than one of those bytes changes simultaneously the entry's change count should only increase by 1
-	     // - a few of those bytes can be outside the region
-
-		unsigned int endSkipSize = ((unsigned int)(startSkipSize - region.size)) % sizeof(stepType);
-		unsigned int lastIndexToRead = indexEnd + endSkipSize + sizeof(compareType) - sizeof(stepType);
-		unsigned int lastIndexToCopy = lastIndexToRead;
-		if(nextRegionPtr)
-		{
-			const MemoryRegion& nextRegion = *nextRegionPtr;
-			int nextStartSkipSize = ((unsigned int)(sizeof(stepType) - nextRegion.hardwareAddress)) % sizeof(stepType);
-			unsigned int nextIndexStart = nextRegion.virtualIndex + nextStartSkipSize;
-			if(lastIndexToCopy > nextIndexStart)
-				lastIndexToCopy = nextIndexStart;
-		}
-
-		unsigned int nextValidChange [sizeof(compareType)];
-		for(unsigned int i = 0; i < sizeof(compareType); i++)
-			nextValidChange[i] = indexStart + i;
-
-		for(unsigned int i = indexStart, j = 0; i < lastIndexToRead; i++, j++)
-		{
-			if(s_curValues[i] != sourceAddr[i^swapXOR]) // if value of this byte changed
-			{
-				if(i < lastIndexToCopy)
-					s_curValues[i] = sourceAddr[i^swapXOR]; // update value
-				for(int k = 0; k < sizeof(compareType); k++) // loop through the previous entries that contain this byte
-				{
-					if(i >= indexEnd+k)
-						continue;
-					int m = (j-k+sizeof(compareType)) & (sizeof(compareType)-1);
-					if(nextValidChange[m] <= i) // if we didn't already increase the change count for this entry
-					{
-						//if(s_numChanges[i-k] != 0xFFFF)
-							s_numChanges[i-k]++; // increase the change count for this entry
-						nextValidChange[m] = i-k+sizeof(compareType); // and remember not to increase it again
-					}
-				}
-			}
-		}
-	}
-}
-
-template<typename stepType, typename compareType>
-void UpdateRegionsT()
-{
-	for(MemoryList::iterator iter = s_activeMemoryRegions.begin(); iter != s_activeMemoryRegions.end();)
-	{
-		const MemoryRegion& region = *iter;
-		++iter;
-		const MemoryRegion* nextRegion = (iter == s_activeMemoryRegions.end()) ? NULL : &*iter;
-
-		if(region.byteSwapped)
-			UpdateRegionT<stepType, compareType, 1>(region, nextRegion);
-		else
-			UpdateRegionT<stepType, compareType, 0>(region, nextRegion);
-	}
-
-	s_prevValuesNeedUpdate = false;
-}
-
-template<typename stepType, typename compareType>
-int CountRegionItemsT()
-{
-	if(sizeof(stepType) == 1)
-	{
-		if(s_activeMemoryRegions.empty())
-			return 0;
-
-		if(s_itemIndicesInvalid)
-			CalculateItemIndices(sizeof(stepType));
-
-		MemoryRegion& lastRegion = s_activeMemoryRegions.back();
-		return lastRegion.itemIndex + lastRegion.size;
-	}
-	else // the branch above is faster but won't work if the step size isn't 1
-	{
-		int total = 0;
-		for(MemoryList::iterator iter = s_activeMemoryRegions.begin(); iter != s_activeMemoryRegions.end(); ++iter)
-		{
-			MemoryRegion& region = *iter;
-			int startSkipSize = ((unsigned int)(sizeof(stepType) - region.hardwareAddress)) % sizeof(stepType);
-			total += (region.size - startSkipSize + (sizeof(stepType)-1)) / sizeof(stepType);
-		}
-		return total;
-	}
-}
-
-// returns information about the item in the form of a "fake" region
-// that has the item in it and nothing else
-template<typename stepType, typename compareType>
-void ItemIndexToVirtualRegion(unsigned int itemIndex, MemoryRegion& virtualRegion)
-{
-	if(s_itemIndicesInvalid)
-		CalculateItemIndices(sizeof(stepType));
-
-	if(itemIndex >= s_maxItemIndex)
-	{
-		memset(&virtualRegion, 0, sizeof(MemoryRegion));
-		return;
-	}
-
-	const MemoryRegion* regionPtr = s_itemIndexToRegionPointer[itemIndex];
-	const MemoryRegion& region = *regionPtr;
-
-	int bytesWithinRegion = (itemIndex - region.itemIndex) * sizeof(stepType);
-	int startSkipSize = ((unsigned int)(sizeof(stepType) - region.hardwareAddress)) % sizeof(stepType);
-	bytesWithinRegion += startSkipSize;
-	
-	virtualRegion.size = sizeof(compareType);
-	virtualRegion.hardwareAddress = region.hardwareAddress + bytesWithinRegion;
-	virtualRegion.softwareAddress = region.softwareAddress + bytesWithinRegion;
-	virtualRegion.virtualIndex = region.virtualIndex + bytesWithinRegion;
-	virtualRegion.byteSwapped = region.byteSwapped;
-	virtualRegion.itemIndex = itemIndex;
-	return;
-}
-
-template<typename stepType, typename compareType>
-unsigned int ItemIndexToVirtualIndex(unsigned int itemIndex)
-{
-	MemoryRegion virtualRegion;
-	ItemIndexToVirtualRegion<stepType,compareType>(itemIndex, virtualRegion);
-	return virtualRegion.virtualIndex;
-}
-
-template<typename T>
-T ReadBigEndian(const unsigned char* data)
-{
-	T rv = 0;
-	for(int i = 0; i < sizeof(T); i++)
-	{
-		rv <<= 8;
-		rv |= *data++;
-	}
-	return rv;
-}
-template<> signed char ReadBigEndian(const unsigned char* data) { return *data; }
-template<> unsigned char ReadBigEndian(const unsigned char* data) { return *data; }
-
-
-template<typename stepType, typename compareType>
-compareType GetPrevValueFromVirtualIndex(unsigned int virtualIndex)
-{
-	return ReadBigEndian<compareType>(s_prevValues + virtualIndex);
-	//return *(compareType*)(s_prevValues+virtualIndex);
-}
-template<typename stepType, typename compareType>
-compareType GetCurValueFromVirtualIndex(unsigned int virtualIndex)
-{
-	return ReadBigEndian<compareType>(s_curValues + virtualIndex);
-//	return *(compareType*)(s_curValues+virtualIndex);
-}
-template<typename stepType, typename compareType>
-unsigned short GetNumChangesFromVirtualIndex(unsigned int virtualIndex)
-{
-	unsigned short num = s_numChanges[virtualIndex];
-	//for(unsigned int i = 1; i < sizeof(stepType); i++)
-	//	if(num < s_numChanges[virtualIndex+i])
-	//		num = s_numChanges[virtualIndex+i];
-	return num;
-}
-
-template<typename stepType, typename compareType>
-compareType GetPrevValueFromItemIndex(unsigned int itemIndex)
-{
-	int virtualIndex = ItemIndexToVirtualIndex<stepType,compareType>(itemIndex);
-	return GetPrevValueFromVirtualIndex<stepType,compareType>(virtualIndex);
-}
-template<typename stepType, typename compareType>
-compareType GetCurValueFromItemIndex(unsigned int itemIndex)
-{
-	int virtualIndex = ItemIndexToVirtualIndex<stepType,compareType>(itemIndex);
-	return GetCurValueFromVirtualIndex<stepType,compareType>(virtualIndex);
-}
-template<typename stepType, typename compareType>
-unsigned short GetNumChangesFromItemIndex(unsigned int itemIndex)
-{
-	int virtualIndex = ItemIndexToVirtualIndex<stepType,compareType>(itemIndex);
-	return GetNumChangesFromVirtualIndex<stepType,compareType>(virtualIndex);
-}
-template<typename stepType, typename compareType>
-unsigned int GetHardwareAddressFromItemIndex(unsigned int itemIndex)
-{
-	MemoryRegion virtualRegion;
-	ItemIndexToVirtualRegion<stepType,compareType>(itemIndex, virtualRegion);
-	return virtualRegion.hardwareAddress;
-}
-
-// this one might be unreliable, haven't used it much
-template<typename stepType, typename compareType>
-unsigned int HardwareAddressToItemIndex(unsigned int hardwareAddress)
-{
-	if(s_itemIndicesInvalid)
-		CalculateItemIndices(sizeof(stepType));
-
-	for(MemoryList::iterator iter = s_activeMemoryRegions.begin(); iter != s_activeMemoryRegions.end(); ++iter)
-	{
-		MemoryRegion& region = *iter;
-		if(hardwareAddress >= region.hardwareAddress && hardwareAddress < region.hardwareAddress + region.size)
-		{
-			int indexWithinRegion = (hardwareAddress - region.hardwareAddress) / sizeof(stepType);
-			return region.itemIndex + indexWithinRegion;
-		}
-	}
-
-	return -1;
-}
-
-
-
-
-// workaround for a parser error in MSVC that sometimes deletes a comma preceeding a macro
-// this macro takes a type and a signed/unsigned modifier, and returns the same type with that modifier whether or not the compiler decides to delete the comma between them
-template<typename T, typename ignored=void>
-struct DummyType { typedef T t; };
-#define COMMAHACK(sign, type) DummyType<sign type, sign>::t
-#ifdef _MSC_VER
-#pragma warning(disable : 4114) // disable "same modifier used twice" warning that otherwise would get issued when the compiler bug happens
-#endif
-
-// it's ugly but I can't think of a better way to call these functions that isn't also slower, since
-// I need the current values of these arguments to determine which primitive types are used within the function
-#define CALL_WITH_T_SIZE_TYPES(functionName, sizeTypeID, isSigned, requireAligned, ...) \
-	(sizeTypeID == 'b' \
-		? (isSigned \
-			? functionName<char, COMMAHACK(signed,char)>(__VA_ARGS__) \
-			: functionName<char, COMMAHACK(unsigned,char)>(__VA_ARGS__)) \
-	: sizeTypeID == 'w' \
-		? (isSigned \
-			? (requireAligned \
-				? functionName<short, COMMAHACK(signed,short)>(__VA_ARGS__) \
-				: functionName<char, COMMAHACK(signed,short)>(__VA_ARGS__)) \
-			: (requireAligned \
-				? functionName<short, COMMAHACK(unsigned,short)>(__VA_ARGS__) \
-				: functionName<char, COMMAHACK(unsigned,short)>(__VA_ARGS__))) \
-	: sizeTypeID == 'd' \
-		? (isSigned \
-			? (requireAligned \
-				? functionName<short, COMMAHACK(signed,long)>(__VA_ARGS__) \
-				: functionName<char, COMMAHACK(signed,long)>(__VA_ARGS__)) \
-			: (requireAligned \
-				? functionName<short, COMMAHACK(unsigned,long)>(__VA_ARGS__) \
-				: functionName<char, COMMAHACK(unsigned,long)>(__VA_ARGS__))) \
-	: functionName<char, COMMAHACK(signed,char)>(__VA_ARGS__))
-
-// version that takes a forced comparison type
-#define CALL_WITH_T_STEP(functionName, sizeTypeID, sign,type, requireAligned, ...) \
-	(sizeTypeID == 'b' \
-		? functionName<char, COMMAHACK(sign,type)>(__VA_ARGS__) \
-	: sizeTypeID == 'w' \
-		? (requireAligned \
-			? functionName<short, COMMAHACK(sign,type)>(__VA_ARGS__) \
-			: functionName<char, COMMAHACK(sign,type)>(__VA_ARGS__)) \
-	: sizeTypeID == 'd' \
-		? (requireAligned \
-			? functionName<short, COMMAHACK(sign,type)>(__VA_ARGS__) \
-			: functionName<char, COMMAHACK(sign,type)>(__VA_ARGS__)) \
-	: functionName<char, COMMAHACK(sign,type)>(__VA_ARGS__))
-
-
-// basic comparison functions:
-template <typename T> inline bool LessCmp (T x, T y, T i)        { return x < y; }
-template <typename T> inline bool MoreCmp (T x, T y, T i)        { return x > y; }
-template <typename T> inline bool LessEqualCmp (T x, T y, T i)   { return x <= y; }
-template <typename T> inline bool MoreEqualCmp (T x, T y, T i)   { return x >= y; }
-template <typename T> inline bool EqualCmp (T x, T y, T i)       { return x == y; }
-template <typename T> inline bool UnequalCmp (T x, T y, T i)     { return x != y; }
-template <typename T> inline bool DiffByCmp (T x, T y, T p)      { return x - y == p || y - x == p; }
-template <typename T> inline bool ModIsCmp (T x, T y, T p)       { return p && x % p == y; }
-
-// compare-to type functions:
-template<typename stepType, typename T>
-void SearchRelative (bool(*cmpFun)(T,T,T), T ignored, T param)
-{
-	for(MemoryList::iterator iter = s_activeMemoryRegions.begin(); iter != s_activeMemoryRegions.end(); )
-	{
-		MemoryRegion& region = *iter;
-		int startSkipSize = ((unsigned int)(sizeof(stepType) - region.hardwareAddress)) % sizeof(stepType);
-		unsigned int start = region.virtualIndex + startSkipSize;
-		unsigned int end = region.virtualIndex + region.size;
-		for(unsigned int i = start, hwaddr = region.hardwareAddress; i < end; i += sizeof(stepType), hwaddr += sizeof(stepType))
-			if(!cmpFun(GetCurValueFromVirtualIndex<stepType,T>(i), GetPrevValueFromVirtualIndex<stepType,T>(i), param))
-				if(2 == DeactivateRegion(region, iter, hwaddr, sizeof(stepType)))
-					goto outerContinue;
-		++iter;
-outerContinue:
-		continue;
-	}
-}
-template<typename stepType, typename T>
-void SearchSpecific (bool(*cmpFun)(T,T,T), T value, T param)
-{
-	for(MemoryList::iterator iter = s_activeMemoryRegions.begin(); iter != s_activeMemoryRegions.end(); )
-	{
-		MemoryRegion& region = *iter;
-		int startSkipSize = ((unsigned int)(sizeof(stepType) - region.hardwareAddress)) % sizeof(stepType);
-		unsigned int start = region.virtualIndex + startSkipSize;
-		unsigned int end = region.virtualIndex + region.size;
-		for(unsigned int i = start, hwaddr = region.hardwareAddress; i < end; i += sizeof(stepType), hwaddr += sizeof(stepType))
-			if(!cmpFun(GetCurValueFromVirtualIndex<stepType,T>(i), value, param))
-				if(2 == DeactivateRegion(region, iter, hwaddr, sizeof(stepType)))
-					goto outerContinue;
-		++iter;
-outerContinue:
-		continue;
-	}
-}
-template<typename stepType, typename T>
-void SearchAddress (bool(*cmpFun)(T,T,T), T address, T param)
-{
-	for(MemoryList::iterator iter = s_activeMemoryRegions.begin(); iter != s_activeMemoryRegions.end(); )
-	{
-		MemoryRegion& region = *iter;
-		int startSkipSize = ((unsigned int)(sizeof(stepType) - region.hardwareAddress)) % sizeof(stepType);
-		unsigned int start = region.virtualIndex + startSkipSize;
-		unsigned int end = region.virtualIndex + region.size;
-		for(unsigned int i = start, hwaddr = region.hardwareAddress; i < end; i += sizeof(stepType), hwaddr += sizeof(stepType))
-			if(!cmpFun(hwaddr, address, param))
-				if(2 == DeactivateRegion(region, iter, hwaddr, sizeof(stepType)))
-					goto outerContinue;
-		++iter;
-outerContinue:
-		continue;
-	}
-}
-template<typename stepType, typename T>
-void SearchChanges (bool(*cmpFun)(T,T,T), T changes, T param)
-{
-	for(MemoryList::iterator iter = s_activeMemoryRegions.begin(); iter != s_activeMemoryRegions.end(); )
-	{
-		MemoryRegion& region = *iter;
-		int startSkipSize = ((unsigned int)(sizeof(stepType) - region.hardwareAddress)) % sizeof(stepType);
-		unsigned int start = region.virtualIndex + startSkipSize;
-		unsigned int end = region.virtualIndex + region.size;
-		for(unsigned int i = start, hwaddr = region.hardwareAddress; i < end; i += sizeof(stepType), hwaddr += sizeof(stepType))
-			if(!cmpFun(GetNumChangesFromVirtualIndex<stepType,T>(i), changes, param))
-				if(2 == DeactivateRegion(region, iter, hwaddr, sizeof(stepType)))
-					goto outerContinue;
-		++iter;
-outerContinue:
-		continue;
-	}
+	RamSearch_ResetRegions();
 }
 
 char rs_c='s';
@@ -581,40 +52,7 @@ int last_rs_regions = -1;
 
 void prune(char c,char o,char t,int v,int p)
 {
-	// repetition-reducing macros
-	#define DO_SEARCH(sf) \
-	switch (o) \
-	{ \
-		case '<': DO_SEARCH_2(LessCmp,sf); break; \
-		case '>': DO_SEARCH_2(MoreCmp,sf); break; \
-		case '=': DO_SEARCH_2(EqualCmp,sf); break; \
-		case '!': DO_SEARCH_2(UnequalCmp,sf); break; \
-		case 'l': DO_SEARCH_2(LessEqualCmp,sf); break; \
-		case 'm': DO_SEARCH_2(MoreEqualCmp,sf); break; \
-		case 'd': DO_SEARCH_2(DiffByCmp,sf); break; \
-		case '%': DO_SEARCH_2(ModIsCmp,sf); break; \
-		default: assert(!"Invalid operator for this search type."); break; \
-	}
-
-	// perform the search, eliminating nonmatching values
-	switch (c)
-	{
-		#define DO_SEARCH_2(CmpFun,sf) CALL_WITH_T_SIZE_TYPES(sf, rs_type_size, t, noMisalign, CmpFun,v,p)
-		case 'r': DO_SEARCH(SearchRelative); break;
-		case 's': DO_SEARCH(SearchSpecific); break;
-
-		#undef DO_SEARCH_2
-		#define DO_SEARCH_2(CmpFun,sf) CALL_WITH_T_STEP(sf, rs_type_size, unsigned,int, noMisalign, CmpFun,v,p);
-		case 'a': DO_SEARCH(SearchAddress); break;
-
-		#undef DO_SEARCH_2
-		#define DO_SEARCH_2(CmpFun,sf) CALL_WITH_T_STEP(sf, rs_type_size, unsigned,short, noMisalign, CmpFun,v,p);
-		case 'n': DO_SEARCH(SearchChanges); break;
-
-		default: assert(!"Invalid search comparison type."); break;
-	}
-
-	s_prevValuesNeedUpdate = true;
+	RamSearch_Prune(c, o, rs_type_size, t, noMisalign, v, p);
 
 	int prevNumItems = last_rs_possible;
 
@@ -627,29 +65,6 @@ void prune(char c,char o,char t,int v,int p)
 }
 
 
-
-
-template<typename stepType, typename T>
-bool CompareRelativeAtItem (bool(*cmpFun)(T,T,T), int itemIndex, T ignored, T param)
-{
-	return cmpFun(GetCurValueFromItemIndex<stepType,T>(itemIndex), GetPrevValueFromItemIndex<stepType,T>(itemIndex), param);
-}
-template<typename stepType, typename T>
-bool CompareSpecificAtItem (bool(*cmpFun)(T,T,T), int itemIndex, T value, T param)
-{
-	return cmpFun(GetCurValueFromItemIndex<stepType,T>(itemIndex), value, param);
-}
-template<typename stepType, typename T>
-bool CompareAddressAtItem (bool(*cmpFun)(T,T,T), int itemIndex, T address, T param)
-{
-	return cmpFun(GetHardwareAddressFromItemIndex<stepType,T>(itemIndex), address, param);
-}
-template<typename stepType, typename T>
-bool CompareChangesAtItem (bool(*cmpFun)(T,T,T), int itemIndex, T changes, T param)
-{
-	return cmpFun(GetNumChangesFromItemIndex<stepType,T>(itemIndex), changes, param);
-}
-
 int ReadControlInt(int controlID, bool forceHex, BOOL& success)
 {
 	int rv = 0;
@@ -773,23 +188,7 @@ bool IsSatisfied(int itemIndex)
 {
 	if(!rs_val_valid)
 		return true;
-	int o = rs_o;
-	switch (rs_c)
-	{
-		#undef DO_SEARCH_2
-		#define DO_SEARCH_2(CmpFun,sf) return CALL_WITH_T_SIZE_TYPES(sf, rs_type_size,(rs_t=='s'),noMisalign, CmpFun,itemIndex,rs_val,rs_param);
-		case 'r': DO_SEARCH(CompareRelativeAtItem); break;
-		case 's': DO_SEARCH(CompareSpecificAtItem); break;
-
-		#undef DO_SEARCH_2
-		#define DO_SEARCH_2(CmpFun,sf) return CALL_WITH_T_STEP(sf, rs_type_size, unsigned,int, noMisalign, CmpFun,itemIndex,rs_val,rs_param);
-		case 'a': DO_SEARCH(CompareAddressAtItem); break;
-
-		#undef DO_SEARCH_2
-		#define DO_SEARCH_2(CmpFun,sf) return CALL_WITH_T_STEP(sf, rs_type_size, unsigned,short, noMisalign, CmpFun,itemIndex,rs_val,rs_param);
-		case 'n': DO_SEARCH(CompareChangesAtItem); break;
-	}
-	return false;
+	return RamSearch_IsSatisfied(itemIndex, rs_c, rs_o, rs_type_size, rs_t=='s', noMisalign, rs_val, rs_param) != 0;
 }
 
 
@@ -983,6 +382,7 @@ bool WriteCellToVDPAddress(unsigned short address, unsigned char *cell) {
 
 	Byte_Swap(cell,32);
 	memcpy(&(VRam[address]),cell,32);
+	Tile_Cache_Invalidate_Range(address, 32);
 	return true;
 }
 
@@ -1063,13 +463,10 @@ void UpdatePossibilities(int rs_possible, int regions);
 
 void CompactAddrs()
 {
-	int size = (rs_type_size=='b' || !noMisalign) ? 1 : 2;
 	int prevResultCount = ResultCount;
 
-	CalculateItemIndices(size);
-
-	ResultCount = CALL_WITH_T_SIZE_TYPES(CountRegionItemsT, rs_type_size,rs_t=='s',noMisalign);
-	UpdatePossibilities(ResultCount, (int)s_activeMemoryRegions.size());
+	ResultCount = RamSearch_NumItems(rs_type_size, rs_t=='s', noMisalign);
+	UpdatePossibilities(ResultCount, RamSearch_NumRegions());
 
 	if(ResultCount != prevResultCount)
 		ListView_SetItemCount(GetDlgItem(RamSearchHWnd,IDC_RAMLIST),ResultCount);
@@ -1077,49 +474,49 @@ void CompactAddrs()
 
 void soft_reset_address_info ()
 {
-	s_prevValuesNeedUpdate = false;
+	RamSearch_SetPrevValuesNeedUpdate(false);
 	ResetMemoryRegions();
 	if(!RamSearchHWnd)
 	{
-		s_activeMemoryRegions.clear();
+		RamSearch_ClearRegions();
 		ResultCount = 0;
 	}
 	else
 	{
-		// force s_prevValues to be valid
+		// force the previous values to be valid
 		signal_new_frame();
-		s_prevValuesNeedUpdate = true;
+		RamSearch_SetPrevValuesNeedUpdate(true);
 		signal_new_frame();
 	}
-	memset(s_numChanges, 0, sizeof(s_numChanges));
+	RamSearch_ResetChanges();
 	CompactAddrs();
 }
 void reset_address_info ()
 {
 	SetRamSearchUndoType(RamSearchHWnd, 0);
-	s_activeMemoryRegionsBackup.clear(); // not necessary, but we'll take the time hit here instead of at the next thing that sets up an undo
-	memcpy(s_prevValues, s_curValues, sizeof(s_prevValues));
-	s_prevValuesNeedUpdate = false;
+	RamSearch_ClearUndo(); // not necessary, but we'll take the time hit here instead of at the next thing that sets up an undo
+	RamSearch_CopyCurToPrev();
+	RamSearch_SetPrevValuesNeedUpdate(false);
 	ResetMemoryRegions();
 	if(!RamSearchHWnd)
 	{
-		s_activeMemoryRegions.clear();
+		RamSearch_ClearRegions();
 		ResultCount = 0;
 	}
 	else
 	{
-		// force s_prevValues to be valid
+		// force the previous values to be valid
 		signal_new_frame();
-		s_prevValuesNeedUpdate = true;
+		RamSearch_SetPrevValuesNeedUpdate(true);
 		signal_new_frame();
 	}
-	memset(s_numChanges, 0, sizeof(s_numChanges));
+	RamSearch_ResetChanges();
 	CompactAddrs();
 }
 
 void signal_new_frame ()
 {
-	CALL_WITH_T_SIZE_TYPES(UpdateRegionsT, rs_type_size,rs_t=='s',noMisalign);
+	RamSearch_Update(rs_type_size, rs_t=='s', noMisalign);
 }
 
 
@@ -1166,8 +563,8 @@ void signal_new_size ()
 	unsigned int itemsPerPage = ListView_GetCountPerPage(lv);
 	unsigned int oldTopIndex = ListView_GetTopIndex(lv);
 	unsigned int oldSelectionIndex = ListView_GetSelectionMark(lv);
-	unsigned int oldTopAddr = CALL_WITH_T_SIZE_TYPES(GetHardwareAddressFromItemIndex, rs_last_type_size,rs_t=='s',rs_last_no_misalign, oldTopIndex);
-	unsigned int oldSelectionAddr = CALL_WITH_T_SIZE_TYPES(GetHardwareAddressFromItemIndex, rs_last_type_size,rs_t=='s',rs_last_no_misalign, oldSelectionIndex);
+	unsigned int oldTopAddr = RamSearch_GetAddress(oldTopIndex, rs_last_type_size, rs_last_no_misalign);
+	unsigned int oldSelectionAddr = RamSearch_GetAddress(oldSelectionIndex, rs_last_type_size, rs_last_no_misalign);
 
 	std::vector<AddrRange> selHardwareAddrs;
 	if(numberOfItemsChanged)
@@ -1181,7 +578,7 @@ void signal_new_size ()
 		for(int i = 0; i < selCount; ++i)
 		{
 			watchIndex = ListView_GetNextItem(lv, watchIndex, LVNI_SELECTED);
-			int addr = CALL_WITH_T_SIZE_TYPES(GetHardwareAddressFromItemIndex, rs_last_type_size,rs_t=='s',rs_last_no_misalign, watchIndex);
+			int addr = RamSearch_GetAddress(watchIndex, rs_last_type_size, rs_last_no_misalign);
 			if(!selHardwareAddrs.empty() && addr == selHardwareAddrs.back().End())
 				selHardwareAddrs.back().size += size;
 			else if (!(noMisalign && oldSize < newSize && addr % newSize != 0))
@@ -1197,7 +594,7 @@ void signal_new_size ()
 	if(numberOfItemsChanged)
 	{
 		// restore selection ranges
-		unsigned int newTopIndex = CALL_WITH_T_SIZE_TYPES(HardwareAddressToItemIndex, rs_type_size,rs_t=='s',noMisalign, oldTopAddr);
+		unsigned int newTopIndex = RamSearch_GetItemIndex(oldTopAddr, rs_type_size, noMisalign);
 		unsigned int newBottomIndex = newTopIndex + itemsPerPage - 1;
 		SendMessage(lv, WM_SETREDRAW, FALSE, 0);
 		ListView_SetItemState(lv, -1, 0, LVIS_SELECTED|LVIS_FOCUSED); // deselect all
@@ -1205,10 +602,10 @@ void signal_new_size ()
 		{
 			// calculate index ranges of this selection
 			const AddrRange& range = selHardwareAddrs[i];
-			int selRangeTop = CALL_WITH_T_SIZE_TYPES(HardwareAddressToItemIndex, rs_type_size,rs_t=='s',noMisalign, range.addr);
+			int selRangeTop = RamSearch_GetItemIndex(range.addr, rs_type_size, noMisalign);
 			int selRangeBottom = -1;
 			for(int endAddr = range.End()-1; endAddr >= selRangeTop && selRangeBottom == -1; endAddr--)
-				selRangeBottom = CALL_WITH_T_SIZE_TYPES(HardwareAddressToItemIndex, rs_type_size,rs_t=='s',noMisalign, endAddr);
+				selRangeBottom = RamSearch_GetItemIndex(endAddr, rs_type_size, noMisalign);
 			if(selRangeBottom == -1)
 				selRangeBottom = selRangeTop;
 			if(selRangeTop == -1)
@@ -1280,6 +677,8 @@ LRESULT CustomDraw (LPARAM lParam)
 extern "C" int disableRamSearchUpdate;
 void Update_RAM_Search() //keeps RAM values up to date in the search and watch windows
 {
+	PROF_SCOPE(PROF_RAM_SEARCH);
+
 	if(disableRamSearchUpdate)
 		return;
 
@@ -1299,11 +698,11 @@ void Update_RAM_Search() //keeps RAM values up to date in the search and watch w
 				AutoSearchAutoRetry = true;
 		}
 		reset_address_info();
-		prevValuesNeededUpdate = s_prevValuesNeedUpdate;
+		prevValuesNeededUpdate = RamSearch_PrevValuesNeedUpdate() != 0;
 	}
 	else
 	{
-		prevValuesNeededUpdate = s_prevValuesNeedUpdate;
+		prevValuesNeededUpdate = RamSearch_PrevValuesNeedUpdate() != 0;
 
 		if (RamSearchHWnd)
 		{
@@ -1324,7 +723,7 @@ void Update_RAM_Search() //keeps RAM values up to date in the search and watch w
 	if(RamSearchHWnd)
 	{
 		HWND lv = GetDlgItem(RamSearchHWnd,IDC_RAMLIST);
-		if(prevValuesNeededUpdate != s_prevValuesNeedUpdate)
+		if(prevValuesNeededUpdate != (RamSearch_PrevValuesNeedUpdate() != 0))
 		{
 			// previous values got updated, refresh everything visible
 			ListView_Update(lv, -1);
@@ -1338,7 +737,7 @@ void Update_RAM_Search() //keeps RAM values up to date in the search and watch w
 			int start = -1;
 			for(int i = top; i <= top+count; i++)
 			{
-				int changeNum = CALL_WITH_T_SIZE_TYPES(GetNumChangesFromItemIndex, rs_type_size,rs_t=='s',noMisalign, i); //s_numChanges[i];
+				int changeNum = RamSearch_GetNumChanges(i, rs_type_size, noMisalign);
 				int changed = changeNum != changes[i-top];
 				if(changed)
 					changes[i-top] = changeNum;
@@ -1384,6 +783,11 @@ inline void UpdateRamSearchProgressBar(int percent)
 	}
 }
 
+static void UpdateRamSearchEliminateProgress(int percent)
+{
+	UpdateRamSearchProgressBar(50 + percent / 2);
+}
+
 static void SelectEditControl(int controlID)
 {
 	HWND hEdit = GetDlgItem(RamSearchHWnd,controlID);
@@ -1513,7 +917,7 @@ LRESULT CALLBACK RamSearchProc(HWND hDlg, UINT uMsg, WPARAM wParam, LPARAM lPara
 					break;
 			}
 
-			s_prevValuesNeedUpdate = true;
+			RamSearch_SetPrevValuesNeedUpdate(true);
 
 			SendDlgItemMessage(hDlg,IDC_C_AUTOSEARCH,BM_SETCHECK,AutoSearch?BST_CHECKED:BST_UNCHECKED,0);
 			//const char* names[5] = {"Address","Value","Previous","Changes","Notes"};
@@ -1544,7 +948,7 @@ LRESULT CALLBACK RamSearchProc(HWND hDlg, UINT uMsg, WPARAM wParam, LPARAM lPara
 
 			// force possibility count to refresh
 			last_rs_possible--;
-			UpdatePossibilities(ResultCount, (int)s_activeMemoryRegions.size());
+			UpdatePossibilities(ResultCount, RamSearch_NumRegions());
 			
 			rs_val_valid = Set_RS_Val();
 
@@ -1581,13 +985,13 @@ LRESULT CALLBACK RamSearchProc(HWND hDlg, UINT uMsg, WPARAM wParam, LPARAM lPara
 					{
 						case 0:
 						{
-							int addr = CALL_WITH_T_SIZE_TYPES(GetHardwareAddressFromItemIndex, rs_type_size,rs_t=='s',noMisalign, iNum);
+							int addr = RamSearch_GetAddress(iNum, rs_type_size, noMisalign);
 							sprintf(num,"%08X",addr);
 							Item->item.pszText = num;
 						}	return true;
 						case 1:
 						{
-							int i = CALL_WITH_T_SIZE_TYPES(GetCurValueFromItemIndex, rs_type_size,rs_t=='s',noMisalign, iNum);
+							int i = RamSearch_GetCurValue(iNum, rs_type_size, rs_t=='s', noMisalign);
 							const char* formatString = ((rs_t=='s') ? "%d" : (rs_t=='u') ? "%u" : (rs_type_size=='d' ? "%08X" : rs_type_size=='w' ? "%04X" : "%02X"));
 							switch (rs_type_size)
 							{
@@ -1600,7 +1004,7 @@ LRESULT CALLBACK RamSearchProc(HWND hDlg, UINT uMsg, WPARAM wParam, LPARAM lPara
 						}	return true;
 						case 2:
 						{
-							int i = CALL_WITH_T_SIZE_TYPES(GetPrevValueFromItemIndex, rs_type_size,rs_t=='s',noMisalign, iNum);
+							int i = RamSearch_GetPrevValue(iNum, rs_type_size, rs_t=='s', noMisalign);
 							const char* formatString = ((rs_t=='s') ? "%d" : (rs_t=='u') ? "%u" : (rs_type_size=='d' ? "%08X" : rs_type_size=='w' ? "%04X" : "%02X"));
 							switch (rs_type_size)
 							{
@@ -1613,7 +1017,7 @@ LRESULT CALLBACK RamSearchProc(HWND hDlg, UINT uMsg, WPARAM wParam, LPARAM lPara
 						}	return true;
 						case 3:
 						{
-							int i = CALL_WITH_T_SIZE_TYPES(GetNumChangesFromItemIndex, rs_type_size,rs_t=='s',noMisalign, iNum);
+							int i = RamSearch_GetNumChanges(iNum, rs_type_size, noMisalign);
 							sprintf(num,"%d",i);
 
 							Item->item.pszText = num;
@@ -1797,7 +1201,7 @@ LRESULT CALLBACK RamSearchProc(HWND hDlg, UINT uMsg, WPARAM wParam, LPARAM lPara
 					{rv = true; break;}
 				}
 				case IDC_C_RESET_CHANGES:
-					memset(s_numChanges, 0, sizeof(s_numChanges));
+					RamSearch_ResetChanges();
 					ListView_Update(GetDlgItem(hDlg,IDC_RAMLIST), -1);
 					//SetRamSearchUndoType(hDlg, 0);
 					{rv = true; break;}
@@ -1805,18 +1209,10 @@ LRESULT CALLBACK RamSearchProc(HWND hDlg, UINT uMsg, WPARAM wParam, LPARAM lPara
 					if(s_undoType>0)
 					{
 						Clear_Sound_Buffer();
-						if(s_activeMemoryRegions.size() < tooManyRegionsForUndo)
-						{
-							MemoryList tempMemoryList = s_activeMemoryRegions;
-							s_activeMemoryRegions = s_activeMemoryRegionsBackup;
-							s_activeMemoryRegionsBackup = tempMemoryList;
+						if(RamSearch_Undo())
 							SetRamSearchUndoType(hDlg, 3 - s_undoType);
-						}
 						else
-						{
-							s_activeMemoryRegions = s_activeMemoryRegionsBackup;
 							SetRamSearchUndoType(hDlg, -1);
-						}
 						CompactAddrs();
 						ListView_SetItemState(GetDlgItem(hDlg,IDC_RAMLIST), -1, 0, LVIS_SELECTED); // deselect all
 						ListView_SetSelectionMark(GetDlgItem(hDlg,IDC_RAMLIST), 0);
@@ -1871,7 +1267,7 @@ invalid_field:
 					while (watchItemIndex >= 0)
 					{
 						AddressWatcher tempWatch;
-						tempWatch.Address = CALL_WITH_T_SIZE_TYPES(GetHardwareAddressFromItemIndex, rs_type_size,rs_t=='s',noMisalign, watchItemIndex);
+						tempWatch.Address = RamSearch_GetAddress(watchItemIndex, rs_type_size, noMisalign);
 						tempWatch.Size = rs_type_size;
 						tempWatch.Type = rs_t;
 						tempWatch.WrongEndian = 0; //Replace when I get little endian working
@@ -1903,15 +1299,18 @@ invalid_field:
 
 					// time-saving trick #1:
 					// condense the selected items into an array of address ranges
-					std::vector<AddrRange> selHardwareAddrs;
+					std::vector<RamSearchRange> selHardwareAddrs;
 					for(int i = 0, j = 1024; i < selCount; ++i, --j)
 					{
 						watchIndex = ListView_GetNextItem(ramListControl, watchIndex, LVNI_SELECTED);
-						int addr = CALL_WITH_T_SIZE_TYPES(GetHardwareAddressFromItemIndex, rs_type_size,rs_t=='s',noMisalign, watchIndex);
-						if(!selHardwareAddrs.empty() && addr == selHardwareAddrs.back().End())
+						unsigned int addr = RamSearch_GetAddress(watchIndex, rs_type_size, noMisalign);
+						if(!selHardwareAddrs.empty() && addr == selHardwareAddrs.back().addr + selHardwareAddrs.back().size)
 							selHardwareAddrs.back().size += size;
 						else
-							selHardwareAddrs.push_back(AddrRange(addr,size));
+						{
+							RamSearchRange range = {addr, (unsigned int)size};
+							selHardwareAddrs.push_back(range);
+						}
 
 						if(!j) UpdateRamSearchProgressBar(i * 50 / selCount), j = 1024;
 					}
@@ -1919,28 +1318,9 @@ invalid_field:
 					// now deactivate the ranges
 
 					// time-saving trick #2:
-					// take advantage of the fact that the listbox items must be in the same order as the regions
-					MemoryList::iterator iter = s_activeMemoryRegions.begin();
-					int numHardwareAddrRanges = selHardwareAddrs.size();
-					for(int i = 0, j = 16; i < numHardwareAddrRanges; ++i, --j)
-					{
-						int addr = selHardwareAddrs[i].addr;
-						int size = selHardwareAddrs[i].size;
-						bool affected = false;
-						while(iter != s_activeMemoryRegions.end())
-						{
-							MemoryRegion& region = *iter;
-							int affNow = DeactivateRegion(region, iter, addr, size);
-							if(affNow)
-								affected = true;
-							else if(affected)
-								break;
-							if(affNow != 2)
-								++iter;
-						}
-
-						if(!j) UpdateRamSearchProgressBar(50 + (i * 50 / selCount)), j = 16;
-					}
+					// take advantage of the fact that the listbox items must be in the same order as the regions,
+					// and build the surviving regions into a new list as we go
+					RamSearch_EliminateRanges(selHardwareAddrs, UpdateRamSearchEliminateProgress);
 					UpdateRamSearchTitleBar();
 
 					// careful -- if the above two time-saving tricks aren't working,
@@ -2061,13 +1441,5 @@ void SetRamSearchUndoType(HWND hDlg, int type)
 
 void RamSearchSaveUndoStateIfNotTooBig(HWND hDlg)
 {
-	if(s_activeMemoryRegions.size() < tooManyRegionsForUndo)
-	{
-		s_activeMemoryRegionsBackup = s_activeMemoryRegions;
-		SetRamSearchUndoType(hDlg, 1);
-	}
-	else
-	{
-		SetRamSearchUndoType(hDlg, 0);
-	}
+	SetRamSearchUndoType(hDlg, RamSearch_SaveUndo() ? 1 : 0);
 }
@@ -33,10 +33,14 @@ void prune(char Search, char Operater, char Type, int Value, int OperatorParamet
 void CompactAddrs();
 void reset_address_info();
 void signal_new_frame();
+void ResetMemoryRegions();
 void signal_new_size();
 void UpdateRamSearchTitleBar(int percent = 0);
 void SetRamSearchUndoType(HWND hDlg, int type);
 unsigned int ReadValueAtHardwareAddress(unsigned int address, unsigned int size);
+unsigned int ReadBytesAtHardwareAddress(unsigned int address, unsigned char* dst, unsigned int length);
+unsigned int HardwareAddressSpan(unsigned int address);
+void CopyFromSoftwareAddress(unsigned char* dst, const unsigned char* src, unsigned int length, int byteSwapped);
 bool ReadCellAtVDPAddress(unsigned short address, unsigned char *cell);
 bool WriteValueAtHardwareRAMAddress(unsigned int address, unsigned int value, unsigned int size, bool hookless=false);
 bool IsHardwareRAMAddressValid(unsigned int address);
@@ -560,6 +560,222 @@ int Save_State_To_Buffer (unsigned char *buf)
 
 	return len;
 }
+
+// Raw snapshots: in-process only, never written to disk.
+// Unlike Save_State_To_Buffer these skip the GST layout entirely and memcpy the
+// live core structures into the buffer, so they are only valid for the session
+// (and system mode) that created them. Meant for Lua branching and rewind,
+// where the same state is saved and loaded many times per second.
+
+struct SnapshotRegion
+{
+	void* ptr;
+	unsigned int size;
+};
+
+#define SNAPSHOT_REGION(x) { (void*)&(x), sizeof(x) }
+
+static const SnapshotRegion Genesis_Snapshot_Regions [] =
+{
+	SNAPSHOT_REGION(Ram_68k),
+	SNAPSHOT_REGION(VRam),
+	{ (void*)CRam, 64 * 4 }, // the asm reserves less than the C declaration says (see vdp_io.h)
+	SNAPSHOT_REGION(VSRam),
+	SNAPSHOT_REGION(Ram_Z80),
+	SNAPSHOT_REGION(H_Counter_Table),
+	SNAPSHOT_REGION(YM2612),
+	SNAPSHOT_REGION(PSG),
+	SNAPSHOT_REGION(M_Z80),
+	{ (void*)&Controller_1_State, 448 }, // same block as Export_Genesis (Controller_1_State .. Controller_2D_Z)
+	SNAPSHOT_REGION(VDP_Reg),
+	SNAPSHOT_REGION(Ctrl),
+	SNAPSHOT_REGION(VDP_Status),
+	SNAPSHOT_REGION(VDP_Int),
+	SNAPSHOT_REGION(VDP_Current_Line),
+	SNAPSHOT_REGION(VDP_Num_Lines),
+	SNAPSHOT_REGION(VDP_Num_Vis_Lines),
+	SNAPSHOT_REGION(DMAT_Length),
+	SNAPSHOT_REGION(DMAT_Type),
+	SNAPSHOT_REGION(DMAT_Tmp),
+	SNAPSHOT_REGION(SRAM_Start),
+	SNAPSHOT_REGION(SRAM_End),
+	SNAPSHOT_REGION(SRAM_ON),
+	SNAPSHOT_REGION(SRAM_Write),
+	SNAPSHOT_REGION(SRAM_Custom),
+	SNAPSHOT_REGION(Bank_M68K),
+	SNAPSHOT_REGION(Bank_Z80),
+	SNAPSHOT_REGION(S68K_State),
+	SNAPSHOT_REGION(Z80_State),
+	SNAPSHOT_REGION(Last_BUS_REQ_Cnt),
+	SNAPSHOT_REGION(Last_BUS_REQ_St),
+	SNAPSHOT_REGION(Fake_Fetch),
+	SNAPSHOT_REGION(Game_Mode),
+	SNAPSHOT_REGION(CPU_Mode),
+	SNAPSHOT_REGION(CPL_M68K),
+	SNAPSHOT_REGION(CPL_S68K),
+	SNAPSHOT_REGION(CPL_Z80),
+	SNAPSHOT_REGION(Cycles_S68K),
+	SNAPSHOT_REGION(Cycles_M68K),
+	SNAPSHOT_REGION(Cycles_Z80),
+	SNAPSHOT_REGION(Gen_Mode),
+	SNAPSHOT_REGION(Gen_Version),
+	SNAPSHOT_REGION(FrameCount),
+	SNAPSHOT_REGION(LagCount),
+	SNAPSHOT_REGION(LagCountPersistent),
+	SNAPSHOT_REGION(Lag_Frame),
+};
+
+#define SNAPSHOT_ALIGN(x) (((x) + 15) & ~15)
+
+struct SnapshotHeader
+{
+	char magic[4];             // "RSNP" (first byte is never 0, same convention as savestates)
+	unsigned int systems;      // Genesis_Started | SegaCD_Started << 1 | _32X_Started << 2
+	unsigned int length;       // total bytes used, including this header
+	unsigned int sramSaved;    // SRAM block present (only when the game has SRAM, like Export_Genesis)
+	unsigned char vdpRegs[24]; // register values to replay through Set_VDP_Reg on load
+	unsigned char reserved[8];
+};
+
+static unsigned int Snapshot_Systems()
+{
+	return (Genesis_Started ? 1 : 0) | (SegaCD_Started ? 2 : 0) | (_32X_Started ? 4 : 0);
+}
+
+int Get_Snapshot_Length(void)
+{
+	unsigned int len = SNAPSHOT_ALIGN(sizeof(SnapshotHeader));
+	for(unsigned int i = 0; i < sizeof(Genesis_Snapshot_Regions) / sizeof(*Genesis_Snapshot_Regions); i++)
+		len += SNAPSHOT_ALIGN(Genesis_Snapshot_Regions[i].size);
+	len += SNAPSHOT_ALIGN(sizeof(S68000CONTEXT));
+	len += SNAPSHOT_ALIGN(sizeof(SRAM));
+
+	// the add-on hardware still goes through the portable exporters (see Save_Snapshot_To_Buffer)
+	if (SegaCD_Started) len += SEGACD_LENGTH_EX;
+	if (_32X_Started) len += G32X_LENGTH_EX;
+
+	return len;
+}
+
+int Save_Snapshot_To_Buffer(unsigned char *buf)
+{
+	assert((((int)buf)&15) == 0); // want this for alignment performance reasons
+	if (!Game)
+		return 0;
+
+	VDP_Render_Sync();
+
+	unsigned char* bufStart = buf;
+	SnapshotHeader* header = (SnapshotHeader*)buf;
+	memcpy(header->magic, "RSNP", 4);
+	header->systems = Snapshot_Systems();
+	header->sramSaved = (SRAM_End != SRAM_Start);
+
+	// same register bytes Export_Genesis writes at 0xFA, but computed without touching VDP_Reg
+	unsigned int dmaSrcHigh = ((VDP_Reg.DMA_Address >> 16) & 0xFF) | (Ctrl.DMA_Mode & 0xC0);
+	const unsigned int* reg = &VDP_Reg.Set1;
+	for(int i = 0; i < 19; i++)
+		header->vdpRegs[i] = (unsigned char)reg[i];
+	header->vdpRegs[19] = (unsigned char)(VDP_Reg.DMA_Length & 0xFF);
+	header->vdpRegs[20] = (unsigned char)((VDP_Reg.DMA_Length >> 8) & 0xFF);
+	header->vdpRegs[21] = (unsigned char)(VDP_Reg.DMA_Address & 0xFF);
+	header->vdpRegs[22] = (unsigned char)((VDP_Reg.DMA_Address >> 8) & 0xFF);
+	header->vdpRegs[23] = (unsigned char)dmaSrcHigh;
+	buf += SNAPSHOT_ALIGN(sizeof(SnapshotHeader));
+
+	VRam_Flag = 1; // full reconstruction of cached sprite table (same as Export_Genesis)
+
+	for(unsigned int i = 0; i < sizeof(Genesis_Snapshot_Regions) / sizeof(*Genesis_Snapshot_Regions); i++)
+	{
+		const SnapshotRegion& region = Genesis_Snapshot_Regions[i];
+		memcpy(buf, region.ptr, region.size);
+		buf += SNAPSHOT_ALIGN(region.size);
+	}
+
+	main68k_GetContext(buf);
+	buf += SNAPSHOT_ALIGN(sizeof(S68000CONTEXT));
+
+	if(header->sramSaved)
+	{
+		memcpy(buf, SRAM, sizeof(SRAM));
+		buf += SNAPSHOT_ALIGN(sizeof(SRAM));
+	}
+
+	// Import_SegaCD/Import_32X resynchronise CD audio and the SH2s on load,
+	// so those parts keep using the exporters instead of a plain memcpy.
+	Version = LATEST_SAVESTATE_VERSION;
+	if (SegaCD_Started)
+	{
+		memset(buf, 0, SEGACD_LENGTH_EX);
+		Export_SegaCD(buf);
+		buf += SEGACD_LENGTH_EX;
+	}
+	if (_32X_Started)
+	{
+		memset(buf, 0, G32X_LENGTH_EX);
+		Export_32X(buf);
+		buf += G32X_LENGTH_EX;
+	}
+
+	header->length = buf - bufStart;
+	return header->length;
+}
+
+int Load_Snapshot_From_Buffer(const unsigned char *buf)
+{
+	assert((((int)buf)&15) == 0); // want this for alignment performance reasons
+	if (!Game)
+		return 0;
+
+	VDP_Render_Sync();
+
+	const SnapshotHeader* header = (const SnapshotHeader*)buf;
+	if (memcmp(header->magic, "RSNP", 4) || header->systems != Snapshot_Systems())
+		return 0;
+
+	if ((MainMovie.Status == MOVIE_PLAYING) || (MainMovie.Status == MOVIE_FINISHED))
+	{
+		fseek(MainMovie.File,0,SEEK_END);
+		MainMovie.LastFrame = ((ftell(MainMovie.File) - 64)/3);
+	}
+
+	frameadvSkipLag_Rewind_State_Buffer_Valid = false;
+
+	InBaseGenesis = 1;
+
+	// replay the registers first for their side effects, the raw copy below then overwrites VDP_Reg and Ctrl
+	for(int i = 0; i < 24; i++) Set_VDP_Reg(i, header->vdpRegs[i]);
+
+	const unsigned char* bufStart = buf;
+	buf += SNAPSHOT_ALIGN(sizeof(SnapshotHeader));
+
+	for(unsigned int i = 0; i < sizeof(Genesis_Snapshot_Regions) / sizeof(*Genesis_Snapshot_Regions); i++)
+	{
+		const SnapshotRegion& region = Genesis_Snapshot_Regions[i];
+		memcpy(region.ptr, buf, region.size);
+		buf += SNAPSHOT_ALIGN(region.size);
+	}
+	Tile_Cache_Invalidate();
+
+	memcpy(&Context_68K, buf, sizeof(S68000CONTEXT));
+	main68k_SetContext(&Context_68K);
+	buf += SNAPSHOT_ALIGN(sizeof(S68000CONTEXT));
+
+	if(header->sramSaved)
+	{
+		memcpy(SRAM, buf, sizeof(SRAM));
+		buf += SNAPSHOT_ALIGN(sizeof(SRAM));
+	}
+
+	Version = LATEST_SAVESTATE_VERSION;
+	if (SegaCD_Started)
+		buf += Import_SegaCD((unsigned char*)buf);
+	if (_32X_Started)
+		buf += Import_32X((unsigned char*)buf);
+
+	return buf - bufStart;
+}
+
 int Save_State (char *Name)
 {
 	int stateNumber = s_lastStateNumberGotten;
@@ -878,6 +1094,7 @@ int Import_Genesis(unsigned char * Data)
 //	VDP_Int = 0;
 //	DMAT_Length = 0;
 	int len = GENESIS_STATE_LENGTH;
+	VDP_Render_Sync();
 	Version = Data[0x50];
 	if (Version < 6) len -= 0x10000;
 
@@ -901,6 +1118,7 @@ int Import_Genesis(unsigned char * Data)
 		VRam[i + 0] = Data[i + 0x12478 + 1];
 		VRam[i + 1] = Data[i + 0x12478 + 0];
 	}
+	Tile_Cache_Invalidate();
 
 	YM2612_Restore(Data + 0x1E4);
 
@@ -1249,6 +1467,7 @@ void Export_Genesis(unsigned char * Data)
 	int i;
 
 	InBaseGenesis = 1;
+	VDP_Render_Sync();
 
 	//if(DMAT_Length)
 	  //WARNINGBOX("Saving during DMA transfer; savestate may be corrupt. Try advancing the frame and saving again.", "Warning");
@@ -45,6 +45,9 @@ FILE *Get_State_File();
 void Get_State_File_Name(char *name);
 int Load_State_From_Buffer(unsigned char *buf);
 int Save_State_To_Buffer(unsigned char *buf);
+int Get_Snapshot_Length(void);
+int Save_Snapshot_To_Buffer(unsigned char *buf);
+int Load_Snapshot_From_Buffer(const unsigned char *buf);
 int Load_State(char *Name);
 int Save_State(char *Name);
 int Import_Genesis(unsigned char *Data);
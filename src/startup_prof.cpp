@@ -0,0 +1,96 @@
+// Startup time report (-startup-report)
+// Marks are put between the steps of WinMain, Init and ParseCmdLine; each one charges the
+// QueryPerformanceCounter time since the previous mark to its stage. The time before WinMain
+// comes from the creation time of the process, which is only as precise as the system clock.
+// The report is written once the command line is done, before -bench-out runs, so the last
+// stage ends where the first frame starts.
+
+#include <windows.h>
+#include <stdio.h>
+#include <string.h>
+#include "startup_prof.h"
+
+int Batch_Startup = 0;
+
+#define MAX_STAGES 32
+
+static struct
+{
+	const char *Name;
+	double Ms;
+} Stage[MAX_STAGES];
+static int Stages;
+
+static LARGE_INTEGER Freq, Last;
+
+void Startup_Begin(void)
+{
+	FILETIME created, exited, kernel, user, now;
+	ULARGE_INTEGER c, n;
+
+	QueryPerformanceFrequency(&Freq);
+	QueryPerformanceCounter(&Last);
+	Stages = 0;
+
+	// FILETIMEs count 100 ns
+	GetSystemTimeAsFileTime(&now);
+	if(GetProcessTimes(GetCurrentProcess(), &created, &exited, &kernel, &user))
+	{
+		c.LowPart = created.dwLowDateTime;
+		c.HighPart = created.dwHighDateTime;
+		n.LowPart = now.dwLowDateTime;
+		n.HighPart = now.dwHighDateTime;
+		Stage[0].Name = "process";
+		Stage[0].Ms = n.QuadPart > c.QuadPart ? (double)(n.QuadPart - c.QuadPart) / 10000.0 : 0.0;
+		Stages = 1;
+	}
+}
+
+void Startup_Mark(const char *stage)
+{
+	LARGE_INTEGER now;
+
+	QueryPerformanceCounter(&now);
+	if(Freq.QuadPart && Stages < MAX_STAGES)
+	{
+		Stage[Stages].Name = stage;
+		Stage[Stages].Ms = (double)(now.QuadPart - Last.QuadPart) * 1000.0 / (double)Freq.QuadPart;
+		Stages++;
+	}
+	Last = now;
+}
+
+int Startup_Report(const char *path)
+{
+	const char *ext = strrchr(path, '.');
+	double total = 0;
+	FILE *f;
+	int i;
+
+	f = fopen(path, "w");
+	if(!f)
+	{
+		fprintf(stderr, "startup: can't create %s\n", path);
+		return 0;
+	}
+
+	for(i = 0; i < Stages; i++)
+		total += Stage[i].Ms;
+
+	if(ext && !_stricmp(ext, ".json"))
+	{
+		fprintf(f, "{\"batch\":%d,\"total_ms\":%.3f,\"stages\":[", Batch_Startup, total);
+		for(i = 0; i < Stages; i++)
+			fprintf(f, "%s\n{\"stage\":\"%s\",\"ms\":%.3f}", i ? "," : "", Stage[i].Name, Stage[i].Ms);
+		fprintf(f, "\n]}\n");
+	}
+	else
+	{
+		fprintf(f, "stage,ms\n");
+		for(i = 0; i < Stages; i++)
+			fprintf(f, "%s,%.3f\n", Stage[i].Name, Stage[i].Ms);
+		fprintf(f, "total,%.3f\n", total);
+	}
+	fclose(f);
+	return 1;
+}
@@ -0,0 +1,22 @@
+#ifndef STARTUP_PROF_H
+#define STARTUP_PROF_H
+
+// Startup time report (startup_prof.cpp)
+// Startup_Mark(stage) charges the time since the previous mark to stage; the first stage, "process",
+// is the time from the creation of the process to Startup_Begin (loader, DLLs, static constructors).
+
+// Batch startup (-batch): set in WinMain before Init from the raw command line. Skips what a
+// run without a user doesn't need: showing the window, DirectInput, DirectDraw (Bits32 and
+// Mode_555 come from the display mode instead), DirectSound, Kaillera and the ASPI CD drives.
+#ifdef __cplusplus
+extern "C" int Batch_Startup;
+#else
+extern int Batch_Startup;
+#endif
+
+void Startup_Begin(void);
+void Startup_Mark(const char *stage);
+// .json for JSON, anything else is CSV; the stages marked so far and the total
+int Startup_Report(const char *path);
+
+#endif
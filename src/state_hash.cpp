@@ -0,0 +1,344 @@
+// Per-frame machine state hashes, to check that a change (idle loop skipping, a new core or renderer)
+// doesn't change the emulation without diffing full state dumps.
+// Each section is hashed on its own (xxHash32 style, four 32-bit lanes) so a difference names the part
+// of the machine it shows up in first. Registers are hashed from their values only, never from the
+// pointers the cores keep in their contexts, so the hashes of two different builds can be compared.
+// Stream: "GHSH", version, section count, ROM checksum, then one record per frame:
+// the frame number and the hash of each section, all 32-bit little endian.
+
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include <algorithm>
+#include "state_hash.h"
+#include "state_dump.h"
+#include "Rom.h"
+#include "Star_68k.h"
+#include "Mem_M68k.h"
+#include "Mem_S68k.h"
+#include "Mem_SH2.h"
+#include "Mem_Z80.h"
+#include "z80.h"
+#include "vdp_io.h"
+#include "ym2612.h"
+#include "psg.h"
+
+#define HASH_VERSION 1
+
+static const char *Section_Name[HASH_SECTIONS] =
+{
+	"m68k", "m68k_ram", "z80", "z80_ram", "vram", "cram", "vsram", "vdp",
+	"ym2612", "psg", "sram", "cd_ram", "32x_ram"
+};
+
+struct Hash_Record
+{
+	unsigned int Frame;
+	unsigned int Hash[HASH_SECTIONS];
+};
+
+static FILE *Out_File = NULL;
+static std::vector<Hash_Record> Ref;		// sorted by frame, the repeats of a frame in the order they were written
+static std::vector<unsigned int> Ref_Seen;	// at the first record of a frame: how many times this run got to it
+static int Checking, Diverged;
+static unsigned int Ignore_Mask;
+static unsigned int Compared, Missing;
+
+#define PRIME1 0x9E3779B1U
+#define PRIME2 0x85EBCA77U
+#define PRIME3 0xC2B2AE3DU
+#define PRIME5 0x165667B1U
+#define ROTL32(x, r) (((x) << (r)) | ((x) >> (32 - (r))))
+
+static unsigned int Hash(const void *data, unsigned int size, unsigned int seed)
+{
+	const unsigned char *p = (const unsigned char *)data;
+	unsigned int v1 = seed + PRIME1 + PRIME2, v2 = seed + PRIME2, v3 = seed, v4 = seed - PRIME1;
+	unsigned int w[4], h, i;
+
+	for(i = 0; i + 16 <= size; i += 16)
+	{
+		memcpy(w, p + i, 16);
+		v1 = ROTL32(v1 + w[0] * PRIME2, 13) * PRIME1;
+		v2 = ROTL32(v2 + w[1] * PRIME2, 13) * PRIME1;
+		v3 = ROTL32(v3 + w[2] * PRIME2, 13) * PRIME1;
+		v4 = ROTL32(v4 + w[3] * PRIME2, 13) * PRIME1;
+	}
+	h = ROTL32(v1, 1) + ROTL32(v2, 7) + ROTL32(v3, 12) + ROTL32(v4, 18) + size;
+
+	for(; i < size; i++)
+		h = ROTL32(h + p[i] * PRIME5, 11) * PRIME1;
+
+	h ^= h >> 15;
+	h *= PRIME2;
+	h ^= h >> 13;
+	h *= PRIME3;
+	h ^= h >> 16;
+	return h;
+}
+
+static unsigned int Hash_M68K(void)
+{
+	struct S68000CONTEXT ctx;
+	unsigned int r[22];
+
+	main68k_GetContext(&ctx);
+	memcpy(r, ctx.dreg, 32);
+	memcpy(r + 8, ctx.areg, 32);
+	r[16] = ctx.asp;
+	r[17] = ctx.pc;
+	r[18] = ctx.sr;
+	r[19] = ctx.xflag;
+	memcpy(r + 20, ctx.interrupts, 8);
+	return Hash(r, sizeof(r), 0);
+}
+
+static unsigned int Hash_Z80(void)
+{
+	const Z80_CONTEXT *z = &M_Z80;
+	unsigned int r[20];
+
+	r[0] = z->AF.b.A;
+	r[1] = z->AF.b.F;
+	r[2] = z->AF.b.FXY;
+	r[3] = z->BC.w.BC;
+	r[4] = z->DE.w.DE;
+	r[5] = z->HL.w.HL;
+	r[6] = z->IX.w.IX;
+	r[7] = z->IY.w.IY;
+	r[8] = z->SP.w.SP;
+	r[9] = z80_Get_PC(&M_Z80);
+	r[10] = z->AF2.w.AF2;
+	r[11] = z->AF2.b.FXY2;
+	r[12] = z->BC2.w.BC2;
+	r[13] = z->DE2.w.DE2;
+	r[14] = z->HL2.w.HL2;
+	r[15] = z->IFF.d;
+	r[16] = z->R.d;
+	r[17] = z->I | z->IM << 8 | z->IntLine << 16;
+	r[18] = z->Status;
+	r[19] = z->CycleSup;
+	return Hash(r, sizeof(r), 0);
+}
+
+static unsigned int Hash_VDP(void)
+{
+	int r[6] = {VDP_Status, VDP_Int, DMAT_Length, DMAT_Type, DMAT_Tmp, VDP_Current_Line};
+	unsigned int h;
+
+	h = Hash(&VDP_Reg, sizeof(VDP_Reg), 0);
+	h = Hash(&Ctrl, sizeof(Ctrl), h);
+	return Hash(r, sizeof(r), h);
+}
+
+static void Hash_State(Hash_Record *rec, unsigned long frame)
+{
+	unsigned char ym2612[0x14d0];
+
+	rec->Frame = (unsigned int)frame;
+	rec->Hash[HASH_M68K] = Hash_M68K();
+	rec->Hash[HASH_M68K_RAM] = Hash(Ram_68k, sizeof(Ram_68k), 0);
+	rec->Hash[HASH_Z80] = Hash_Z80();
+	rec->Hash[HASH_Z80_RAM] = Hash(Ram_Z80, 8 * 1024, 0);
+	rec->Hash[HASH_VRAM] = Hash(VRam, sizeof(VRam), 0);
+	rec->Hash[HASH_CRAM] = Hash(CRam, 64 * 2, 0);
+	rec->Hash[HASH_VSRAM] = Hash(VSRam, 80, 0);
+	rec->Hash[HASH_VDP] = Hash_VDP();
+	YM2612_Save_Full(ym2612);
+	rec->Hash[HASH_YM2612] = Hash(ym2612, sizeof(ym2612), 0);
+	rec->Hash[HASH_PSG] = Hash(&PSG, sizeof(PSG), 0);
+	rec->Hash[HASH_SRAM] = Hash(SRAM, sizeof(SRAM), 0);
+
+	rec->Hash[HASH_CD_RAM] = 0;
+	if(SegaCD_Started)
+	{
+		rec->Hash[HASH_CD_RAM] = Hash(Ram_Prg, sizeof(Ram_Prg), 0);
+		if(Ram_Word_State & 0x2)
+			rec->Hash[HASH_CD_RAM] = Hash(Ram_Word_1M, sizeof(Ram_Word_1M), rec->Hash[HASH_CD_RAM]);
+		else
+			rec->Hash[HASH_CD_RAM] = Hash(Ram_Word_2M, sizeof(Ram_Word_2M), rec->Hash[HASH_CD_RAM]);
+	}
+	rec->Hash[HASH_32X_RAM] = _32X_Started ? Hash(_32X_Ram, sizeof(_32X_Ram), 0) : 0;
+}
+
+static unsigned int Rom_Checksum(void)
+{
+	return Game ? Game->Checksum : 0;
+}
+
+static bool Frame_Before(const Hash_Record &a, const Hash_Record &b)
+{
+	return a.Frame < b.Frame;
+}
+
+int State_Hash_Open(const char *out_path, const char *check_path)
+{
+	unsigned int head[4];
+	Hash_Record rec;
+	FILE *f;
+	int ok = 1;
+
+	if(check_path && check_path[0])
+	{
+		f = fopen(check_path, "rb");
+		if(!f)
+		{
+			fprintf(stderr, "hash check: can't open %s\n", check_path);
+			ok = 0;
+		}
+		else if(fread(head, sizeof(head), 1, f) != 1 || memcmp(head, "GHSH", 4) || head[1] != HASH_VERSION || head[2] != HASH_SECTIONS)
+		{
+			fprintf(stderr, "hash check: %s isn't a hash stream of this version\n", check_path);
+			fclose(f);
+			ok = 0;
+		}
+		else
+		{
+			if(head[3] != Rom_Checksum())
+				fprintf(stderr, "hash check: %s was made with another ROM (checksum %04X, this one %04X)\n",
+					check_path, head[3], Rom_Checksum());
+
+			Ref.clear();
+			while(fread(&rec, sizeof(rec), 1, f) == 1)
+				Ref.push_back(rec);
+			fclose(f);
+			// a reference run that loaded a state or rewound wrote some frames more than once
+			std::stable_sort(Ref.begin(), Ref.end(), Frame_Before);
+			Ref_Seen.assign(Ref.size(), 0);
+
+			Checking = 1;
+			Diverged = 0;
+			Compared = Missing = 0;
+		}
+	}
+
+	if(out_path && out_path[0])
+	{
+		Out_File = fopen(out_path, "wb");
+		if(!Out_File)
+		{
+			fprintf(stderr, "hash: can't create %s\n", out_path);
+			return 0;
+		}
+		memcpy(head, "GHSH", 4);
+		head[1] = HASH_VERSION;
+		head[2] = HASH_SECTIONS;
+		head[3] = Rom_Checksum();
+		fwrite(head, sizeof(head), 1, Out_File);
+	}
+	return ok;
+}
+
+void State_Hash_Ignore(const char *names)
+{
+	const char *p = names;
+	int i, len;
+
+	while(*p)
+	{
+		len = strcspn(p, ",");
+		for(i = 0; i < HASH_SECTIONS; i++)
+			if((int)strlen(Section_Name[i]) == len && !strncmp(p, Section_Name[i], len))
+				break;
+		if(i < HASH_SECTIONS)
+			Ignore_Mask |= 1 << i;
+		else
+			fprintf(stderr, "hash: unknown section \"%.*s\"\n", len, p);
+		p += len;
+		if(*p == ',')
+			p++;
+	}
+}
+
+// The n-th time this run gets to a frame is compared with the n-th record of that frame in the reference,
+// or its last one when this run repeats the frame more often
+static const Hash_Record *Find_Ref(unsigned int frame)
+{
+	unsigned int lo = 0, hi = Ref.size(), mid, first, n;
+
+	while(lo < hi)
+	{
+		mid = (lo + hi) / 2;
+		if(Ref[mid].Frame < frame)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	if(lo >= Ref.size() || Ref[lo].Frame != frame)
+		return NULL;
+
+	first = lo;
+	for(n = 1; first + n < Ref.size() && Ref[first + n].Frame == frame; n++) {}
+	return &Ref[first + std::min(Ref_Seen[first]++, n - 1)];
+}
+
+static void Report_Divergence(const Hash_Record *rec, const Hash_Record *ref)
+{
+	char name[64];
+	int i;
+
+	fprintf(stderr, "hash check: frame %u differs from the reference in", rec->Frame);
+	for(i = 0; i < HASH_SECTIONS; i++)
+		if(!(Ignore_Mask & (1 << i)) && rec->Hash[i] != ref->Hash[i])
+			fprintf(stderr, " %s", Section_Name[i]);
+	fprintf(stderr, "\n");
+
+	sprintf(name, "%u.check", rec->Frame);
+	if(StateDump_DumpStateToFile(StateDumpDir, name))
+		fprintf(stderr, "hash check: this run's state is in %s\\%s.genstate\n", StateDumpDir, name);
+	fprintf(stderr, "hash check: for the reference state, run it again with -dump-state-dir %s -dump-state-interval 1 -dump-state-start %u -dump-state-end %u\n",
+		StateDumpDir, rec->Frame, rec->Frame);
+}
+
+int State_Hash_OnFrame(unsigned long frame)
+{
+	Hash_Record rec;
+	const Hash_Record *ref;
+	int i;
+
+	if(!Out_File && (!Checking || Diverged))
+		return 0;
+
+	Hash_State(&rec, frame);
+
+	if(Out_File)
+		fwrite(&rec, sizeof(rec), 1, Out_File);
+
+	if(!Checking || Diverged)
+		return 0;
+
+	ref = Find_Ref(rec.Frame);
+	if(!ref)
+	{
+		Missing++;
+		return 0;
+	}
+	Compared++;
+	for(i = 0; i < HASH_SECTIONS; i++)
+	{
+		if(!(Ignore_Mask & (1 << i)) && rec.Hash[i] != ref->Hash[i])
+		{
+			Diverged = 1;
+			Report_Divergence(&rec, ref);
+			return 1;
+		}
+	}
+	return 0;
+}
+
+void State_Hash_Close(void)
+{
+	if(Out_File)
+	{
+		fclose(Out_File);
+		Out_File = NULL;
+	}
+	if(Checking)
+	{
+		fprintf(stderr, "hash check: %u frames compared, %u not in the reference, %s\n",
+			Compared, Missing, Diverged ? "diverged" : "no difference");
+		Checking = 0;
+		Ref.clear();
+		Ref_Seen.clear();
+	}
+}
@@ -0,0 +1,33 @@
+#ifndef STATE_HASH_H
+#define STATE_HASH_H
+
+// Per-frame machine state hashes (state_hash.cpp)
+// Every frame each section of the state below is hashed. -hash-out writes the hashes of the run,
+// -hash-check compares them with the hashes of a previous run and stops at the first frame that differs.
+
+enum {
+	HASH_M68K = 0,		// main 68000 registers
+	HASH_M68K_RAM,
+	HASH_Z80,			// Z80 registers
+	HASH_Z80_RAM,
+	HASH_VRAM,
+	HASH_CRAM,
+	HASH_VSRAM,
+	HASH_VDP,			// VDP registers, control port and DMA state
+	HASH_YM2612,
+	HASH_PSG,
+	HASH_SRAM,
+	HASH_CD_RAM,		// Sega CD program and word RAM, 0 without the Sega CD
+	HASH_32X_RAM,		// 32X SDRAM, 0 without the 32X
+	HASH_SECTIONS
+};
+
+// Hash stream to write, and/or the stream of a previous run to compare with
+int State_Hash_Open(const char *out_path, const char *check_path);
+// Comma separated section names that aren't compared (still written)
+void State_Hash_Ignore(const char *names);
+// After each frame; returns 1 at the first frame that differs from the reference
+int State_Hash_OnFrame(unsigned long frame);
+void State_Hash_Close(void);
+
+#endif
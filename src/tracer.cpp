@@ -10,6 +10,7 @@
 #include "tracer.h"
 #include "automation.h"
 #include "bintrace.h"
+#include "plugin.h"
 
 #define uint32 unsigned int
 
@@ -35,6 +36,7 @@ extern "C" {
 	extern uint32 hook_address;
 	extern uint32 hook_value;
 	extern uint32 hook_pc;
+	extern uint32 hook_enabled;
 	
 	unsigned int dma_src, dma_len;
 };
@@ -333,6 +335,15 @@ static void GensTrace_hook()
 	} // end STATES
 }
 
+// The main 68000 only calls the hooks while one of these uses them: a call costs more than most
+// instructions. Updated before each frame and when a Lua script or plugin changes its memory hooks.
+void Update_Hook_Enabled()
+{
+	hook_enabled = trace_map || hook_trace || TraceActive || TraceBreakpointPC || BinTraceActive
+		|| PluginMemHooksActive[GENS_HOOK_READ] || PluginMemHooksActive[GENS_HOOK_WRITE] || PluginMemHooksActive[GENS_HOOK_EXEC]
+		|| AnyRegisteredLuaMemHook(LUAMEMHOOK_READ) || AnyRegisteredLuaMemHook(LUAMEMHOOK_WRITE) || AnyRegisteredLuaMemHook(LUAMEMHOOK_EXEC);
+}
+
 void GensTrace()
 {
 	// Trace.txt
@@ -357,6 +368,7 @@ void GensTrace()
 	}
 
 	CallRegisteredLuaMemHook(hook_pc, 2, 0, LUAMEMHOOK_EXEC);
+	PLUGIN_MEM_HOOK(GENS_HOOK_EXEC, hook_pc, 2, 0, hook_pc);
 }
 
 static void trace_read_byte_internal()
@@ -425,6 +437,7 @@ void trace_read_byte()
 		BinTrace_MemAccess(EVT_READ, hook_pc, hook_address, hook_value, 1);
 
 	CallRegisteredLuaMemHook(hook_address, 1, hook_value, LUAMEMHOOK_READ);
+	PLUGIN_MEM_HOOK(GENS_HOOK_READ, hook_address, 1, hook_value, hook_pc);
 }
 
 static void trace_read_word_internal()
@@ -491,6 +504,7 @@ void trace_read_word()
 		BinTrace_MemAccess(EVT_READ, hook_pc, hook_address, hook_value, 2);
 
 	CallRegisteredLuaMemHook(hook_address, 2, hook_value, LUAMEMHOOK_READ);
+	PLUGIN_MEM_HOOK(GENS_HOOK_READ, hook_address, 2, hook_value, hook_pc);
 }
 
 
@@ -558,6 +572,7 @@ void trace_read_dword()
 		BinTrace_MemAccess(EVT_READ, hook_pc, hook_address, hook_value, 4);
 
 	CallRegisteredLuaMemHook(hook_address, 4, hook_value, LUAMEMHOOK_READ);
+	PLUGIN_MEM_HOOK(GENS_HOOK_READ, hook_address, 4, hook_value, hook_pc);
 }
 
 
@@ -632,6 +647,7 @@ void trace_write_byte()
 		BinTrace_MemAccess(EVT_WRITE, hook_pc, hook_address, hook_value, 1);
 
 	CallRegisteredLuaMemHook(hook_address, 1, hook_value, LUAMEMHOOK_WRITE);
+	PLUGIN_MEM_HOOK(GENS_HOOK_WRITE, hook_address, 1, hook_value, hook_pc);
 }
 
 
@@ -699,6 +715,7 @@ void trace_write_word()
 		BinTrace_MemAccess(EVT_WRITE, hook_pc, hook_address, hook_value, 2);
 
 	CallRegisteredLuaMemHook(hook_address, 2, hook_value, LUAMEMHOOK_WRITE);
+	PLUGIN_MEM_HOOK(GENS_HOOK_WRITE, hook_address, 2, hook_value, hook_pc);
 }
 
 
@@ -766,6 +783,7 @@ void trace_write_dword()
 		BinTrace_MemAccess(EVT_WRITE, hook_pc, hook_address, hook_value, 4);
 
 	CallRegisteredLuaMemHook(hook_address, 4, hook_value, LUAMEMHOOK_WRITE);
+	PLUGIN_MEM_HOOK(GENS_HOOK_WRITE, hook_address, 4, hook_value, hook_pc);
 }
 
 
@@ -922,6 +940,9 @@ void hook_dma()
 		uint8_t dst_type = hook_value & 3;  // 0=VRAM, 1=CRAM, 2=VSRAM
 		BinTrace_DMA(hook_pc, src, dst, len, dst_type);
 	}
+
+	if (PluginDMAHooksActive)
+		Plugin_DMAHook(VDP_Reg.DMA_Address << 1, Ctrl.Address, (VDP_Reg.DMA_Length << 1) & 0xFFFF, hook_value & 3, hook_pc);
 }
 
 
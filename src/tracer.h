@@ -34,4 +34,5 @@ const char * InitDebug();
 const char * InitDebug_cd();
 void DeInitDebug();
 void DeInitDebug_cd();
+void Update_Hook_Enabled();
 #endif
\ No newline at end of file
@@ -8,6 +8,7 @@
 #include "vdp_io.h"
 #include "luascript.h"
 #include "tracer.h"
+#include "plugin.h"
 
 #define uint32 unsigned int
 
@@ -341,6 +342,7 @@ void GensTrace_cd()
 		GensTrace_cd_hook();
 
 	CallRegisteredLuaMemHook(hook_pc_cd, 2, 0, LUAMEMHOOK_EXEC_SUB);
+	PLUGIN_MEM_HOOK(GENS_HOOK_EXEC_SUB, hook_pc_cd, 2, 0, hook_pc_cd);
 }
 
 
@@ -399,6 +401,7 @@ void trace_read_byte_cd()
 	if( hook_trace )
 		trace_read_byte_cd_internal();
 	CallRegisteredLuaMemHook(hook_address_cd, 1, hook_value_cd, LUAMEMHOOK_READ_SUB);
+	PLUGIN_MEM_HOOK(GENS_HOOK_READ_SUB, hook_address_cd, 1, hook_value_cd, hook_pc_cd);
 }
 
 
@@ -457,6 +460,7 @@ void trace_read_word_cd()
 	if( hook_trace )
 		trace_read_word_cd_internal();
 	CallRegisteredLuaMemHook(hook_address_cd, 2, hook_value_cd, LUAMEMHOOK_READ_SUB);
+	PLUGIN_MEM_HOOK(GENS_HOOK_READ_SUB, hook_address_cd, 2, hook_value_cd, hook_pc_cd);
 }
 
 
@@ -515,6 +519,7 @@ void trace_read_dword_cd()
 	if( hook_trace )
 		trace_read_dword_cd_internal();
 	CallRegisteredLuaMemHook(hook_address_cd, 4, hook_value_cd, LUAMEMHOOK_READ_SUB);
+	PLUGIN_MEM_HOOK(GENS_HOOK_READ_SUB, hook_address_cd, 4, hook_value_cd, hook_pc_cd);
 }
 
 
@@ -573,6 +578,7 @@ void trace_write_byte_cd()
 	if( hook_trace )
 		trace_write_byte_cd_internal();
 	CallRegisteredLuaMemHook(hook_address_cd, 1, hook_value_cd, LUAMEMHOOK_WRITE_SUB);
+	PLUGIN_MEM_HOOK(GENS_HOOK_WRITE_SUB, hook_address_cd, 1, hook_value_cd, hook_pc_cd);
 }
 
 
@@ -631,6 +637,7 @@ void trace_write_word_cd()
 	if( hook_trace )
 		trace_write_word_cd_internal();
 	CallRegisteredLuaMemHook(hook_address_cd, 2, hook_value_cd, LUAMEMHOOK_WRITE_SUB);
+	PLUGIN_MEM_HOOK(GENS_HOOK_WRITE_SUB, hook_address_cd, 2, hook_value_cd, hook_pc_cd);
 }
 
 
@@ -689,6 +696,7 @@ void trace_write_dword_cd()
 	if( hook_trace )
 		trace_write_dword_cd_internal();
 	CallRegisteredLuaMemHook(hook_address_cd, 4, hook_value_cd, LUAMEMHOOK_WRITE_SUB);
+	PLUGIN_MEM_HOOK(GENS_HOOK_WRITE_SUB, hook_address_cd, 4, hook_value_cd, hook_pc_cd);
 }
 
 #if 0
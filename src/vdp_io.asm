@@ -23,6 +23,9 @@ section .data align=64
 
 	extern _hook_vdp_reg
 
+	extern _VDP_Render_Sync_Status
+	extern _VDP_Render_Thread_On
+
 	extern Rom_Data
 	extern Rom_Size
 	extern Cell_Conv_Tab
@@ -218,6 +221,11 @@ section .bss align=64
 	DECL VRam_Flag
 	resd 1
 
+	; one bit per VRAM byte, set on every write, cleared by the C++ renderer
+	; when it re-decodes the tile (32 bits = one 8x8 tile)
+	DECL VRam_Dirty
+	resd 2048
+
 section .text align=64
 
 	extern _main68k_readOdometer
@@ -280,6 +288,9 @@ section .text align=64
 
 %%Loop
 	mov di, bx
+%if %2 < 1
+	bts [VRam_Dirty], edi
+%endif
 %if %1 < 1
 	mov ax, [Rom_Data + esi]
 	add esi, 2
@@ -369,6 +380,16 @@ section .text align=64
 		dec ecx
 		jnz .loop_VRam
 
+		mov ebx, VRam_Dirty
+		mov ecx, 2048
+		mov eax, -1
+	.loop_VRam_Dirty
+		mov [ebx], eax
+		add ebx, 4
+		dec ecx
+		jnz .loop_VRam_Dirty
+		xor eax, eax
+
 		mov ebx, CRam
 		mov ecx, 40
 	.loop_CRam
@@ -643,6 +664,10 @@ section .text align=64
 
 	;unsigned short Read_VDP_Status(void)
 	DECL Read_VDP_Status
+		test byte [_VDP_Render_Thread_On], 1
+		jnz short .Render_Sync
+
+	.Render_Synced
 		mov ax, [VDP_Status]
 		push ax
 		xor ax, 0xFF00
@@ -664,6 +689,16 @@ section .text align=64
 		or ax, 8
 		ret
 
+	ALIGN4
+
+	.Render_Sync							; sprite bits of the lines on the render thread
+		push ecx
+		push edx
+		call _VDP_Render_Sync_Status
+		pop edx
+		pop ecx
+		jmp short .Render_Synced
+
 	ALIGN32
 	
 	;unsigned char Read_VDP_H_Counter(void)
@@ -808,6 +843,7 @@ section .text align=64
 	
 	.WR_VRAM
 		mov ecx, ebx
+		bts [VRam_Dirty], ebx
 		shr ebx, 1
 		mov byte [VRam_Flag], 1
 		jnc short .Address_Even
@@ -864,6 +900,7 @@ section .text align=64
 		xor ebx, 1
 		or word [VDP_Status], 0x0002
 		mov [VRam + ebx], al
+		bts [VRam_Dirty], ebx
 		xor ebx, 1
 		mov dword [DMAT_Type], 0x2
 		and ecx, 0xFFFF
@@ -879,6 +916,7 @@ section .text align=64
 
 		.Loop
 			mov [VRam + ebx], ah					; VRam[Adr] = Fill Data
+			bts [VRam_Dirty], ebx
 			add bx, dx								; Adr = Adr + Auto_Inc
 			dec ecx									; un transfert de moins
 			jns short .Loop							; s'il en reste alors on continue
@@ -1272,6 +1310,7 @@ section .text align=64
 			mov al, [VRam + esi]					; ax = Src
 			inc si									; on augment pointeur Src de 1
 			mov [VRam + edi], al					; VRam[Dest] = Src.W
+			bts [VRam_Dirty], edi
 			add di, dx								; Adr = Adr + Auto_Inc
 			dec ecx									; un transfert de moins
 			jnz short .VRam_Copy_Loop				; si DMA Length >= 0 alors on continue le transfert DMA
@@ -48,6 +48,7 @@ extern int VDP_Num_Lines;
 extern int VDP_Num_Vis_Lines;
 extern int CRam_Flag;
 extern int VRam_Flag;
+extern unsigned int VRam_Dirty[2048]; // one bit per VRAM byte, set by every VRAM write (tile cache of vdp_rend_c.cpp)
 extern int VDP_Int;
 extern int VDP_Status;
 extern int DMAT_Length;
@@ -63,6 +64,23 @@ extern struct {
 	int DMA;
 } Ctrl;
 
+// Derived from the VDP registers by Set_VDP_Reg, read by the line renderers
+extern unsigned char *ScrA_Addr;
+extern unsigned char *ScrB_Addr;
+extern unsigned char *Win_Addr;
+extern unsigned char *Spr_Addr;
+extern unsigned char *H_Scroll_Addr;
+extern int H_Cell;
+extern int H_Win_Mul;
+extern int H_Pix;
+extern int H_Scroll_Mask;
+extern int H_Scroll_CMul;
+extern int H_Scroll_CMask;
+extern int V_Scroll_CMask;
+extern int V_Scroll_MMask;
+extern int Win_X_Pos;
+extern int Win_Y_Pos;
+
 void Reset_VDP(void);
 unsigned int Update_DMA(void);
 unsigned short Read_VDP_Data(void);
@@ -72,6 +72,35 @@ void Render_Line();
 void Post_Line();
 void Render_Line_32X();
 
+// Portable version of Render_Line (vdp_rend_c.cpp), same Screen_16X output
+void Render_Line_C();
+
+// Which Genesis line renderer Render_Line_Selected uses
+enum {
+	VDP_RENDERER_ASM = 0,	// Render_Line (vdp_rend.asm)
+	VDP_RENDERER_C,			// Render_Line_C
+	VDP_RENDERER_VERIFY,	// both, report lines where they differ and keep the asm result
+	VDP_RENDERER_THREAD,	// Render_Line_C on a second thread, one line or more behind
+};
+extern int VDP_Renderer;
+extern int VDP_Verify_Mismatches;
+extern int VDP_Render_Thread_On;
+
+void Render_Line_Selected();
+
+// Wait for the render thread to catch up and merge its sprite bits into VDP_Status.
+// Needed before VDP_Status or Screen_16X are looked at, does nothing without the render thread.
+void VDP_Render_Sync();
+// Same for the status port: only waits for the queued lines that can set sprite bits
+void VDP_Render_Sync_Status();
+// Finish the queued lines and end the render thread, the next queued line starts it again
+void VDP_Render_Stop();
+
+// Mark every tile as changed, for code writing to VRam directly instead of going through the VDP
+void Tile_Cache_Invalidate();
+// Same for the tiles in [address, address + length) only
+void Tile_Cache_Invalidate_Range(unsigned int address, unsigned int length);
+
 #ifdef __cplusplus
 };
 #endif
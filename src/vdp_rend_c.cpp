@@ -0,0 +1,1251 @@
+// Portable version of Render_Line (vdp_rend.asm)
+// Renders a Genesis line into Screen_16X exactly like the asm does, quirks included
+// (sprite masking and limits, window clipping, scroll A last cell masking, unwrapped VRAM reads),
+// so the two can be swapped at any line and checked against each other (VDP_RENDERER_VERIFY).
+// Pattern lines come from a cache of decoded tiles (one byte per pixel, normal and H flipped),
+// a tile is decoded again the first time it is used after vdp_io.asm marked it in VRam_Dirty.
+// With VDP_RENDERER_THREAD the lines are rendered on a second thread from a copy of the VDP state
+// taken when the line is due, one line or more behind the emulation.
+
+#include <stdio.h>
+#include <string.h>
+#include "vdp_io.h"
+#include "vdp_rend.h"
+#include "frame_prof.h"
+#include "host_thread.h"
+
+// the pattern line decoding and layer mixing use SSE2 when the compiler targets it
+#if defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2) || defined(__SSE2__)
+   #define VDP_REND_SSE2
+   #include <emmintrin.h>
+#endif
+
+// Screen_16X pixel flags (high byte of each word, shadow/highlight are in both bytes)
+#define HIGH_B 0x80
+#define SHAD_B 0x40
+#define SPR_B  0x20
+#define PRIO_B 0x02
+#define BACK_B 0x01
+
+extern unsigned long FrameCount;
+
+// Renderer state of vdp_rend.asm, only Spr_End lives across lines (the partial sprite update keeps it)
+extern "C" struct
+{
+	unsigned int Pattern_Adr;
+	unsigned int Line_7;
+	unsigned int X;
+	unsigned int Cell;
+	unsigned int Start_A;
+	unsigned int Length_A;
+	unsigned int Start_W;
+	unsigned int Length_W;
+	unsigned int Mask;
+	int Spr_End;
+	unsigned int Next_Cell;
+	unsigned int Palette;
+	unsigned int Borne;
+} Data_Misc;
+
+int VDP_Renderer = VDP_RENDERER_ASM;
+int VDP_Verify_Mismatches = 0;
+int VDP_Render_Thread_On = 0;
+
+// bit position of each pixel of a pattern line (VRAM is byte swapped)
+static const int Shift_N[8] = {12, 8, 4, 0, 28, 24, 20, 16};
+static const int Shift_F[8] = {16, 20, 24, 28, 0, 4, 8, 12};
+
+// decoded pattern lines: [VRAM address / 4][H flip], 8 pixels of one byte in screen order
+typedef unsigned int Tile_Line[2][2];
+static Tile_Line Tile_Cache[0x4000];
+static int VRam_Rewritten = 1;		// VRAM changed without going through vdp_io.asm (Tile_Cache_Invalidate)
+
+// same layout as Sprite_Struct (vdp_rend.h)
+struct Sprite_Info
+{
+	int Pos_X;
+	int Pos_Y;
+	unsigned int Size_X;
+	unsigned int Size_Y;
+	int Pos_X_Max;
+	int Pos_Y_Max;
+	unsigned int Num_Tile;
+	int dirt;
+};
+
+
+static void Decode_Line(unsigned int data, const int *shift, unsigned char *pix)
+{
+	for(int i = 0; i < 8; i++)
+		pix[i] = (unsigned char)((data >> shift[i]) & 0xF);
+}
+
+static inline int Line_Empty(const unsigned char *pix)
+{
+	return !(((const unsigned int *)pix)[0] | ((const unsigned int *)pix)[1]);
+}
+
+// the last scroll A pattern only keeps its first 8 - fine scroll pixels
+static inline const unsigned char *Clip_Line(const unsigned char *pix, unsigned int mask, unsigned int *clipped)
+{
+	unsigned char *out = (unsigned char *)clipped;
+
+	for(unsigned int i = 0; i < 8; i++)
+		out[i] = (i < 8 - mask) ? pix[i] : 0;
+	return out;
+}
+
+#ifdef VDP_REND_SSE2
+
+// 8 pixels of a pattern line as words
+static inline __m128i Load_Line(const unsigned char *pix)
+{
+	return _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)pix), _mm_setzero_si128());
+}
+
+static inline __m128i Select(__m128i mask, __m128i a, __m128i b)
+{
+	return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+#endif
+
+
+// Everything a line is rendered from. The members are named after the globals they are taken from,
+// Load() points them at the live emulator state, the render thread points them at its own copies.
+struct Line_Renderer
+{
+	unsigned char *VRam;
+	const unsigned short *CRam;				// LockedPalette when the palette is locked
+	const unsigned char *VSRam;
+	struct Reg_VDP_Type VDP_Reg;
+	unsigned char *ScrA_Addr, *ScrB_Addr, *Win_Addr, *Spr_Addr, *H_Scroll_Addr;
+	int H_Cell, H_Win_Mul, H_Pix, H_Pix_Begin;
+	int H_Scroll_Mask, H_Scroll_CMul, H_Scroll_CMask, V_Scroll_CMask, V_Scroll_MMask;
+	int Win_X_Pos, Win_Y_Pos;
+	int VDP_Current_Line;
+	int VRam_Flag;
+	char Sprite_Over, Sprite_Always_Top;
+	char Swap_Scroll_PriorityA, Swap_Scroll_PriorityB, Swap_Sprite_Priority;
+
+	// layer toggles (ScrollAOn, VScrollAl, ...) resolved once per line
+	struct
+	{
+		int B_Low, B_High;
+		int A_Low, A_High;
+		int Spr_Low, Spr_High;
+	} Layer_On;
+
+	// kept from line to line
+	Sprite_Info *Sprite_Struct;
+	int *Spr_End;
+	unsigned int *VRam_Dirty;
+	Tile_Line *Tile_Cache;
+	unsigned int Outside[2];				// a pattern line decoded from past the end of VRAM
+
+	// sprite overflow and collision bits for VDP_Status
+	int VDP_Status;
+
+	// decode the 8 lines of the 32 bytes tile holding this VRAM address
+	void Decode_Tile(unsigned int adr)
+	{
+		const unsigned int tile = adr >> 5;
+		const unsigned int *src = (const unsigned int *)(VRam + tile * 32);
+
+		for(int i = 0; i < 8; i++)
+		{
+			Decode_Line(src[i], Shift_N, (unsigned char *)Tile_Cache[tile * 8 + i][0]);
+			Decode_Line(src[i], Shift_F, (unsigned char *)Tile_Cache[tile * 8 + i][1]);
+		}
+		VRam_Dirty[tile] = 0;
+	}
+
+	// Returns: the decoded pattern line at this VRAM address (a multiple of 4)
+	const unsigned char *Get_Line(unsigned int adr, int flip)
+	{
+		// no wrap on VRAM, an interlaced pattern number above 0x3FF reads past it like the asm does
+		if(adr >= 0x10000)
+		{
+			Decode_Line(*(const unsigned int *)(VRam + adr), flip ? Shift_F : Shift_N, (unsigned char *)Outside);
+			return (const unsigned char *)Outside;
+		}
+
+		if(VRam_Dirty[adr >> 5])
+			Decode_Tile(adr);
+		return (const unsigned char *)Tile_Cache[adr >> 2][flip];
+	}
+
+	// Scroll B is drawn first: it clears its 8 pixels, then puts the pattern line over them
+	template<int PRIO, int HS>
+	void Put_Line_B(unsigned short *dst, const unsigned char *pix, unsigned int pal, int on)
+	{
+		const unsigned short back = (!PRIO && HS) ? 0x4040 : 0x0000;
+		const unsigned short add = PRIO ? 0x0300 : back + 0x0100;
+		int i;
+
+		if(!on || Line_Empty(pix))
+		{
+			for(i = 0; i < 8; i++)
+				dst[i] = back;
+			return;
+		}
+
+#ifdef VDP_REND_SSE2
+		__m128i p = Load_Line(pix);
+		__m128i trans = _mm_cmpeq_epi16(p, _mm_setzero_si128());
+		__m128i val = _mm_add_epi16(p, _mm_set1_epi16((short)(pal + add)));
+		_mm_storeu_si128((__m128i *)dst, Select(trans, _mm_set1_epi16(back), val));
+#else
+		for(i = 0; i < 8; i++)
+			dst[i] = pix[i] ? (unsigned short)(pix[i] + pal + add) : back;
+#endif
+	}
+
+	// Scroll A / window low priority: only over pixels without the priority bit
+	template<int HS>
+	void Put_Line_A_P0(unsigned short *dst, const unsigned char *pix, unsigned int pal)
+	{
+		if(!Layer_On.A_Low || Line_Empty(pix))
+			return;
+
+#ifdef VDP_REND_SSE2
+		__m128i p = Load_Line(pix);
+		__m128i d = _mm_loadu_si128((const __m128i *)dst);
+		__m128i trans = _mm_cmpeq_epi16(p, _mm_setzero_si128());
+		__m128i prio = _mm_cmpeq_epi16(_mm_and_si128(d, _mm_set1_epi16(PRIO_B << 8)), _mm_setzero_si128());
+		__m128i draw = _mm_andnot_si128(trans, prio);
+		__m128i val = _mm_add_epi16(p, _mm_set1_epi16((short)(pal + (BACK_B << 8))));
+		if(HS)
+			val = _mm_add_epi16(val, _mm_and_si128(_mm_srli_epi16(d, 8), _mm_set1_epi16(SHAD_B)));
+		val = _mm_or_si128(val, _mm_and_si128(d, _mm_set1_epi16((short)0xFF00)));
+		_mm_storeu_si128((__m128i *)dst, Select(draw, val, d));
+#else
+		for(int i = 0; i < 8; i++)
+		{
+			unsigned int p = pix[i];
+			unsigned int d = dst[i];
+			if(!p || (d & (PRIO_B << 8)))
+				continue;
+			if(HS)
+				p += (d >> 8) & SHAD_B;
+			dst[i] = (unsigned short)((d & 0xFF00) | (BACK_B << 8) | (p + pal));
+		}
+#endif
+	}
+
+	// Scroll A / window high priority: always on top of scroll B, and cancels its shadow
+	template<int HS>
+	void Put_Line_A_P1(unsigned short *dst, const unsigned char *pix, unsigned int pal)
+	{
+		int i;
+
+		if(!Layer_On.A_High)
+			return;
+		if(HS)
+		{
+			for(i = 0; i < 8; i++)
+				dst[i] &= 0xBFBF;
+		}
+		if(Line_Empty(pix))
+			return;
+
+#ifdef VDP_REND_SSE2
+		__m128i p = Load_Line(pix);
+		__m128i trans = _mm_cmpeq_epi16(p, _mm_setzero_si128());
+		__m128i val = _mm_add_epi16(p, _mm_set1_epi16((short)(pal + ((PRIO_B | BACK_B) << 8))));
+		_mm_storeu_si128((__m128i *)dst, Select(trans, _mm_loadu_si128((const __m128i *)dst), val));
+#else
+		for(i = 0; i < 8; i++)
+		{
+			if(pix[i])
+				dst[i] = (unsigned short)(pix[i] + pal + ((PRIO_B | BACK_B) << 8));
+		}
+#endif
+	}
+
+	// Sprite pattern line
+	// Returns: SPR_B if a pixel landed on another sprite (collision), 0 otherwise
+	template<int PRIO, int HS>
+	unsigned int Put_Line_Sprite(unsigned short *dst, const unsigned char *pix, unsigned int pal)
+	{
+		// pixels already taken: by a sprite, or also by a high priority plane for low priority sprites
+		const unsigned int busy = PRIO ? SPR_B : (SPR_B | PRIO_B);
+		const unsigned int shad_mask = PRIO ? HIGH_B : (HIGH_B | SHAD_B);
+
+		if(!(PRIO ? Layer_On.Spr_High : Layer_On.Spr_Low))
+			return 0;
+
+#ifdef VDP_REND_SSE2
+		__m128i p = Load_Line(pix);
+		__m128i d = _mm_loadu_si128((const __m128i *)dst);
+		__m128i hi = _mm_srli_epi16(d, 8);
+		__m128i trans = _mm_cmpeq_epi16(p, _mm_setzero_si128());
+		__m128i open = _mm_cmpeq_epi16(_mm_and_si128(hi, _mm_set1_epi16(busy)), _mm_setzero_si128());
+		__m128i draw = _mm_andnot_si128(trans, open);
+		__m128i blocked = _mm_andnot_si128(_mm_or_si128(trans, open), _mm_set1_epi16(-1));
+		__m128i v = _mm_add_epi16(p, _mm_set1_epi16((short)pal));
+		__m128i hit = _mm_and_si128(blocked, _mm_and_si128(d, _mm_set1_epi16(SPR_B << 8)));
+		__m128i val;
+
+		if(!PRIO)
+			d = _mm_or_si128(d, _mm_and_si128(blocked, _mm_set1_epi16(SPR_B << 8)));
+
+		if(HS)
+		{
+			// palette 3 colours 14 and 15 are the highlight and shadow operators
+			__m128i high = _mm_cmpeq_epi16(v, _mm_set1_epi16(0x3E));
+			__m128i shad = _mm_cmpeq_epi16(v, _mm_set1_epi16(0x3F));
+			__m128i op = _mm_and_si128(draw, _mm_or_si128(high, shad));
+			__m128i op_bits = _mm_or_si128(_mm_and_si128(high, _mm_set1_epi16((short)0x8080)), _mm_and_si128(shad, _mm_set1_epi16(0x4040)));
+			draw = _mm_andnot_si128(op, draw);
+			d = _mm_or_si128(d, _mm_and_si128(op, op_bits));
+			v = _mm_add_epi16(v, _mm_and_si128(hi, _mm_set1_epi16(shad_mask)));
+		}
+
+		val = _mm_or_si128(v, _mm_set1_epi16((SPR_B | BACK_B) << 8));
+		_mm_storeu_si128((__m128i *)dst, Select(draw, val, d));
+
+		return (_mm_movemask_epi8(_mm_cmpeq_epi16(hit, _mm_setzero_si128())) != 0xFFFF) ? SPR_B : 0;
+#else
+		unsigned int hit = 0;
+
+		for(int i = 0; i < 8; i++)
+		{
+			unsigned int p = pix[i];
+			unsigned int d = dst[i], hi = d >> 8;
+
+			if(!p)
+				continue;
+			if(hi & busy)
+			{
+				hit |= hi;
+				if(!PRIO)
+					dst[i] = (unsigned short)(d | (SPR_B << 8));
+				continue;
+			}
+
+			p += pal;
+			if(HS)
+			{
+				if(p == 0x3E)
+				{
+					dst[i] = (unsigned short)(d | 0x8080);
+					continue;
+				}
+				if(p == 0x3F)
+				{
+					dst[i] = (unsigned short)(d | 0x4040);
+					continue;
+				}
+				p += hi & shad_mask;
+			}
+			dst[i] = (unsigned short)(((SPR_B | BACK_B) << 8) | p);
+		}
+
+		return hit & SPR_B;
+#endif
+	}
+
+
+	// Pattern helpers (GET_PATTERN_INFO / GET_PATTERN_DATA)
+
+	unsigned int Get_Pattern_Info(const unsigned char *plane, unsigned int cell, unsigned int row)
+	{
+		return *(const unsigned short *)(plane + ((cell + (row << H_Scroll_CMul)) * 2));
+	}
+
+	template<int INTERLACE>
+	const unsigned char *Get_Pattern_Data(unsigned int info, unsigned int line7)
+	{
+		if(info & 0x1000)
+			line7 ^= 7;
+
+		if(INTERLACE)
+			return Get_Line(((info & 0x7FF) << 6) + line7 * 8, (info >> 11) & 1);
+		return Get_Line(((info & 0x7FF) << 5) + line7 * 4, (info >> 11) & 1);
+	}
+
+	template<int INTERLACE>
+	void Set_Y_Offset(unsigned int vscroll, unsigned int &row, unsigned int &line7)
+	{
+		if(INTERLACE)
+			vscroll >>= 1;
+		vscroll += VDP_Current_Line;
+		line7 = vscroll & 7;
+		row = (vscroll >> 3) & V_Scroll_CMask;
+	}
+
+	// 2 cell vertical scroll: a new value every other cell, cells outside of VSRAM keep the previous one
+	template<int INTERLACE, int SCROLL_A>
+	void Update_Y_Offset(unsigned int cell, unsigned int &row, unsigned int &line7)
+	{
+		if(cell & 0xFF81)
+			return;
+
+		if(SCROLL_A)
+			Set_Y_Offset<INTERLACE>(*(const unsigned int *)(VSRam + cell * 2), row, line7);
+		else
+			Set_Y_Offset<INTERLACE>(*(const unsigned short *)(VSRam + cell * 2 + 2), row, line7);
+	}
+
+	template<int HS>
+	void Put_Pattern_B(unsigned short *dst, unsigned int info, const unsigned char *pix)
+	{
+		const unsigned int pal = (info >> 9) & 0x30;
+
+		if(info & 0x8000)
+			Put_Line_B<1, HS>(dst, pix, pal, Layer_On.B_High);
+		else
+			Put_Line_B<0, HS>(dst, pix, pal, Layer_On.B_Low);
+	}
+
+	template<int HS>
+	void Put_Pattern_A(unsigned short *dst, unsigned int info, const unsigned char *pix)
+	{
+		const unsigned int pal = (info >> 9) & 0x30;
+
+		if(info & 0x8000)
+			Put_Line_A_P1<HS>(dst, pix, pal);
+		else
+			Put_Line_A_P0<HS>(dst, pix, pal);
+	}
+
+
+	// RENDER_LINE_SCROLL_B
+	template<int INTERLACE, int VCELL, int HS>
+	void Render_Line_Scroll_B(unsigned int base)
+	{
+		const unsigned int line = VDP_Current_Line;
+		unsigned int xscroll = *(const unsigned short *)(H_Scroll_Addr + (line & H_Scroll_Mask) * 4 + 2);
+		unsigned int cell = (xscroll ^ 0x3FF) >> 3;
+		unsigned int vcell = (cell & 1) - 2;		// starts on cell -2 or -1 for the V scroll
+		unsigned short *dst = Screen_16X + base + (xscroll & 7);
+		signed char count = (signed char)H_Cell;	// H_Cell + 1 patterns
+		unsigned int row, line7, info;
+
+		cell &= H_Scroll_CMask;
+		Set_Y_Offset<INTERLACE>(*(const unsigned int *)(VSRam + 2), row, line7);
+
+		for(;;)
+		{
+			info = Get_Pattern_Info(ScrB_Addr, cell, row);
+			if(Swap_Scroll_PriorityB & 1)
+				info ^= 0x8000;
+			Put_Pattern_B<HS>(dst, info, Get_Pattern_Data<INTERLACE>(info, line7));
+
+			vcell++;
+			cell = (cell + 1) & H_Scroll_CMask;
+			dst += 8;
+			if(--count < 0)
+				break;
+
+			if(VCELL)
+				Update_Y_Offset<INTERLACE, 0>(vcell, row, line7);
+		}
+	}
+
+	// RENDER_LINE_SCROLL_A_WIN
+	template<int INTERLACE, int VCELL, int HS>
+	void Render_Line_Scroll_A_Win(unsigned int base)
+	{
+		const unsigned int line = VDP_Current_Line;
+		unsigned int start_w, length_w, cell, info;
+		unsigned short *dst;
+
+		if(!(((VDP_Reg.Win_V_Pos & 0xFF) >> 7) ^ ((line >> 3) >= (unsigned int)Win_Y_Pos)))
+		{
+			// whole line is window
+			start_w = 0;
+			length_w = H_Cell;
+		}
+		else
+		{
+			int start_a, length_a;
+
+			if(VDP_Reg.Win_H_Pos & 0x80)
+			{
+				start_w = Win_X_Pos;
+				length_w = H_Cell - Win_X_Pos;
+				start_a = 0;
+				length_a = Win_X_Pos - 1;		// the last scroll A pattern is drawn separately
+			}
+			else
+			{
+				start_w = 0;
+				length_w = Win_X_Pos;
+				start_a = Win_X_Pos;
+				length_a = H_Cell - Win_X_Pos - 1;
+			}
+
+			if(length_a >= 0)
+			{
+				unsigned int xscroll = *(const unsigned int *)(H_Scroll_Addr + (line & H_Scroll_Mask) * 4);
+				unsigned int mask = xscroll & 7;
+				unsigned int vcell, row, line7;
+				signed char count = (signed char)length_a;
+
+				cell = (xscroll ^ 0x3FF) >> 3;
+				vcell = start_a + (cell & 1) - 2;
+				cell = (cell + start_a) & H_Scroll_CMask;
+				dst = Screen_16X + base + mask + start_a * 8;
+
+				if((int)vcell < 0)
+					Set_Y_Offset<INTERLACE>(*(const unsigned int *)VSRam, row, line7);
+				else
+					Set_Y_Offset<INTERLACE>(*(const unsigned int *)(VSRam + (vcell & V_Scroll_MMask) * 2), row, line7);
+
+				for(;;)
+				{
+					info = Get_Pattern_Info(ScrA_Addr, cell, row);
+					if(Swap_Scroll_PriorityA & 1)
+						info ^= 0x8000;
+					Put_Pattern_A<HS>(dst, info, Get_Pattern_Data<INTERLACE>(info, line7));
+
+					vcell++;
+					cell = (cell + 1) & H_Scroll_CMask;
+					dst += 8;
+					if(VCELL)
+						Update_Y_Offset<INTERLACE, 1>(vcell, row, line7);
+					if(--count < 0)
+						break;
+				}
+
+				// last pattern, clipped by the fine scroll
+				unsigned int clipped[2];
+				info = Get_Pattern_Info(ScrA_Addr, cell, row);
+				if(Swap_Scroll_PriorityA & 1)
+					info ^= 0x8000;
+				Put_Pattern_A<HS>(dst, info, Clip_Line(Get_Pattern_Data<INTERLACE>(info, line7), mask, clipped));
+
+				if(!(length_w & 0xFF))
+					return;
+			}
+		}
+
+		// window: no scrolling, no clipping, no priority swap
+		const unsigned char *pattern = Win_Addr + (((line >> 3) << H_Win_Mul) * 2);
+		const unsigned int line7 = line & 7;
+
+		dst = Screen_16X + base + start_w * 8 + 8;
+		cell = start_w;
+		do
+		{
+			info = *(const unsigned short *)(pattern + cell * 2);
+			Put_Pattern_A<HS>(dst, info, Get_Pattern_Data<INTERLACE>(info, line7));
+			cell++;
+			dst += 8;
+		} while(--length_w);
+	}
+
+
+	// MAKE_SPRITE_STRUCT: decode the sprite table following the link list, 80 sprites at most
+	template<int INTERLACE>
+	void Make_Sprite_Struct()
+	{
+		const unsigned char *spr = Spr_Addr;
+		int n = 0;
+
+		for(;;)
+		{
+			unsigned int pos_y = *(const unsigned short *)(spr + 0);
+			unsigned int pos_x = *(const unsigned short *)(spr + 6);
+			unsigned int size = spr[2 ^ 1];
+			unsigned int link = spr[3 ^ 1] & 0x7F;
+
+			if(INTERLACE)
+				pos_y >>= 1;
+
+			// the asm only stores the low byte of the sizes and the low word of the tile
+			Sprite_Struct[n].Pos_Y = (int)(pos_y & 0x1FF) - 0x80;
+			Sprite_Struct[n].Pos_X = (int)(pos_x & 0x1FF) - 0x80;
+			Sprite_Struct[n].Size_X = (Sprite_Struct[n].Size_X & ~0xFFu) | (((size >> 2) & 3) + 1);
+			Sprite_Struct[n].Size_Y = (Sprite_Struct[n].Size_Y & ~0xFFu) | (size & 3);
+			Sprite_Struct[n].Pos_X_Max = Sprite_Struct[n].Pos_X + (((size >> 2) & 3) + 1) * 8 - 1;
+			Sprite_Struct[n].Pos_Y_Max = Sprite_Struct[n].Pos_Y + (size & 3) * 8 + 7;
+			Sprite_Struct[n].Num_Tile = (Sprite_Struct[n].Num_Tile & ~0xFFFFu) | *(const unsigned short *)(spr + 4);
+			n++;
+
+			if(!link || n >= 80)
+				break;
+			spr = Spr_Addr + link * 8;
+		}
+
+		*Spr_End = (n - 1) * 32;
+	}
+
+	// MAKE_SPRITE_STRUCT_PARTIAL: only X and the first tile changed, Spr_End is kept
+	void Make_Sprite_Struct_Partial()
+	{
+		const unsigned char *spr = Spr_Addr;
+		int n = 0;
+
+		for(;;)
+		{
+			unsigned int size = spr[2 ^ 1];
+			unsigned int link = spr[3 ^ 1] & 0x7F;
+
+			Sprite_Struct[n].Num_Tile = (Sprite_Struct[n].Num_Tile & ~0xFFFFu) | *(const unsigned short *)(spr + 4);
+			Sprite_Struct[n].Pos_X = (int)(*(const unsigned short *)(spr + 6) & 0x1FF) - 0x80;
+			Sprite_Struct[n].Pos_X_Max = Sprite_Struct[n].Pos_X + (size & 0x0C) * 2 + 7;
+
+			if(!link || ++n >= 80)
+				break;
+			spr = Spr_Addr + link * 8;
+		}
+	}
+
+	int Sprite_On_Line(int n, int line)
+	{
+		return Sprite_Struct[n].Pos_Y <= line && Sprite_Struct[n].Pos_Y_Max >= line;
+	}
+
+	int Sprite_On_Screen(int n)
+	{
+		return Sprite_Struct[n].Pos_X < H_Pix && Sprite_Struct[n].Pos_X_Max >= 0;
+	}
+
+	// UPDATE_MASK_SPRITE: list the sprites to draw on the current line
+	// Returns: number of sprites put in visible
+	template<int LIMIT>
+	int Update_Mask_Sprite(int *visible)
+	{
+		const int line = VDP_Current_Line;
+		const int end = *Spr_End;
+		int cells = H_Cell;
+		int i = 0, n = 0;
+
+		// the first sprite on the line can't be a mask
+		while(!Sprite_On_Line(i, line))
+		{
+			if(++i * 32 > end)
+				return 0;
+		}
+		if(LIMIT)
+			cells -= (int)Sprite_Struct[i].Size_X;
+		if(Sprite_On_Screen(i))
+			visible[n++] = i;
+
+		for(i++; i * 32 <= end; )
+		{
+			if(Sprite_On_Line(i, line))
+			{
+				if(Sprite_Struct[i].Pos_X == -128)
+					return n;		// mask sprite, the next ones are hidden
+				if(LIMIT)
+					cells -= (int)Sprite_Struct[i].Size_X;
+				if(Sprite_On_Screen(i))
+					visible[n++] = i;
+			}
+			i++;
+
+			if(LIMIT && cells <= 0)
+			{
+				// out of sprite pixels, any other sprite on the line sets the overflow flag
+				for(; i * 32 <= end; i++)
+				{
+					if(Sprite_On_Line(i, line))
+					{
+						VDP_Status |= 0x40;
+						break;
+					}
+				}
+				return n;
+			}
+		}
+
+		return n;
+	}
+
+	// RENDER_LINE_SPR
+	template<int INTERLACE, int HS>
+	void Render_Line_Spr(unsigned int base)
+	{
+		int visible[80];
+		const int count = (Sprite_Over & 1) ? Update_Mask_Sprite<1>(visible) : Update_Mask_Sprite<0>(visible);
+		unsigned short *line_dst = Screen_16X + base + 8;
+
+		for(int k = 0; k < count; k++)
+		{
+			const int n = visible[k];
+			unsigned int info = Sprite_Struct[n].Num_Tile;
+			unsigned int y = VDP_Current_Line - Sprite_Struct[n].Pos_Y;
+			const unsigned int pal = ((info & 0xFFFF) >> 9) & 0x30;
+			unsigned int adr, stride, size_y, cell_y, row;
+			int prio, x;
+
+			if(Swap_Sprite_Priority & 1)
+				info ^= 0x8000;
+
+			row = y & 7;
+			cell_y = y & 0xF8;
+			if(INTERLACE)
+			{
+				size_y = Sprite_Struct[n].Size_Y << 6;
+				cell_y <<= 3;
+				adr = (info & 0x7FF) << 6;
+				stride = size_y + 64;
+			}
+			else
+			{
+				size_y = Sprite_Struct[n].Size_Y << 5;
+				cell_y <<= 2;
+				adr = (info & 0x7FF) << 5;
+				stride = size_y + 32;
+			}
+
+			if(info & 0x1000)
+			{
+				adr += size_y - cell_y;
+				row ^= 7;
+			}
+			else
+				adr += cell_y;
+			adr += row << (INTERLACE ? 3 : 2);
+
+			// patterns are stored by column, stride bytes apart
+			prio = (Sprite_Always_Top != 0) || (info & 0x8000);
+			if(info & 0x0800)
+			{
+				const int x_min = (Sprite_Struct[n].Pos_X > -7) ? Sprite_Struct[n].Pos_X : -7;
+
+				for(x = Sprite_Struct[n].Pos_X_Max - 7; x >= H_Pix; x -= 8)
+					adr += stride;
+				do
+				{
+					const unsigned char *pix = Get_Line(adr, 1);
+					if(prio)
+						VDP_Status |= Put_Line_Sprite<1, HS>(line_dst + x, pix, pal);
+					else
+						VDP_Status |= Put_Line_Sprite<0, HS>(line_dst + x, pix, pal);
+					x -= 8;
+					adr += stride;
+				} while(x >= x_min);
+			}
+			else
+			{
+				const int x_max = (Sprite_Struct[n].Pos_X_Max < H_Pix) ? Sprite_Struct[n].Pos_X_Max : H_Pix;
+
+				for(x = Sprite_Struct[n].Pos_X; x < -7; x += 8)
+					adr += stride;
+				do
+				{
+					const unsigned char *pix = Get_Line(adr, 0);
+					if(prio)
+						VDP_Status |= Put_Line_Sprite<1, HS>(line_dst + x, pix, pal);
+					else
+						VDP_Status |= Put_Line_Sprite<0, HS>(line_dst + x, pix, pal);
+					x += 8;
+					adr += stride;
+				} while(x < x_max);
+			}
+		}
+	}
+
+	// RENDER_LINE
+	template<int INTERLACE, int HS>
+	void Render_Line_Layers(unsigned int base)
+	{
+		if(VDP_Reg.Set3 & 4)
+		{
+			Render_Line_Scroll_B<INTERLACE, 1, HS>(base);
+			Render_Line_Scroll_A_Win<INTERLACE, 1, HS>(base);
+		}
+		else
+		{
+			Render_Line_Scroll_B<INTERLACE, 0, HS>(base);
+			Render_Line_Scroll_A_Win<INTERLACE, 0, HS>(base);
+		}
+		Render_Line_Spr<INTERLACE, HS>(base);
+	}
+
+	void Load()
+	{
+		VRam = ::VRam;
+		CRam = (PalLock & 1) ? LockedPalette : ::CRam;
+		VSRam = ::VSRam;
+		VDP_Reg = ::VDP_Reg;
+		ScrA_Addr = ::ScrA_Addr;
+		ScrB_Addr = ::ScrB_Addr;
+		Win_Addr = ::Win_Addr;
+		Spr_Addr = ::Spr_Addr;
+		H_Scroll_Addr = ::H_Scroll_Addr;
+		H_Cell = ::H_Cell;
+		H_Win_Mul = ::H_Win_Mul;
+		H_Pix = ::H_Pix;
+		H_Pix_Begin = ::H_Pix_Begin;
+		H_Scroll_Mask = ::H_Scroll_Mask;
+		H_Scroll_CMul = ::H_Scroll_CMul;
+		H_Scroll_CMask = ::H_Scroll_CMask;
+		V_Scroll_CMask = ::V_Scroll_CMask;
+		V_Scroll_MMask = ::V_Scroll_MMask;
+		Win_X_Pos = ::Win_X_Pos;
+		Win_Y_Pos = ::Win_Y_Pos;
+		VDP_Current_Line = ::VDP_Current_Line;
+		VRam_Flag = ::VRam_Flag;
+		Sprite_Over = (char)::Sprite_Over;
+		Sprite_Always_Top = ::Sprite_Always_Top;
+		Swap_Scroll_PriorityA = ::Swap_Scroll_PriorityA;
+		Swap_Scroll_PriorityB = ::Swap_Scroll_PriorityB;
+		Swap_Sprite_Priority = ::Swap_Sprite_Priority;
+
+		Layer_On.B_Low = (ScrollBOn & 1) && (VScrollBl & 1);
+		Layer_On.B_High = (ScrollBOn & 1) && (VScrollBh & 1);
+		Layer_On.A_Low = (ScrollAOn & 1) && (VScrollAl & 1);
+		Layer_On.A_High = (ScrollAOn & 1) && (VScrollAh & 1);
+		Layer_On.Spr_Low = (SpriteOn & 1) && (VSpritel & 1);
+		Layer_On.Spr_High = (SpriteOn & 1) && (VSpriteh & 1);
+
+		Sprite_Struct = (Sprite_Info *)::Sprite_Struct;
+		Spr_End = &Data_Misc.Spr_End;
+		VRam_Dirty = ::VRam_Dirty;
+		Tile_Cache = ::Tile_Cache;
+		VDP_Status = 0;
+	}
+
+	// rebuild the sprite table if the sprite attributes were written since the previous line
+	void Update_Sprite_Struct()
+	{
+		switch(VRam_Flag & 3)
+		{
+			case 1:
+			case 3:
+				if(VDP_Reg.Set4 & 4)
+					Make_Sprite_Struct<1>();
+				else
+					Make_Sprite_Struct<0>();
+				break;
+			case 2:
+				Make_Sprite_Struct_Partial();
+				break;
+		}
+	}
+
+	// Does the sprite table update of Render() without drawing and tells if the line can set the
+	// overflow bit (exact) or the collision bit (two sprites over the same column, not checking pixels).
+	// Returns: nonzero if Render() may set sprite bits in VDP_Status
+	int Sprite_Status_Possible()
+	{
+		int visible[80];
+		int count;
+
+		if(!(VDP_Reg.Set2 & 0x40))
+			return 0;
+
+		Update_Sprite_Struct();
+		VDP_Status = 0;
+		count = (Sprite_Over & 1) ? Update_Mask_Sprite<1>(visible) : Update_Mask_Sprite<0>(visible);
+		if(VDP_Status)
+		{
+			VDP_Status = 0;
+			return 1;
+		}
+
+		for(int k = 1; k < count; k++)
+		{
+			const Sprite_Info &a = Sprite_Struct[visible[k]];
+			for(int j = 0; j < k; j++)
+			{
+				const Sprite_Info &b = Sprite_Struct[visible[j]];
+				if(a.Pos_X <= b.Pos_X_Max && b.Pos_X <= a.Pos_X_Max)
+					return 1;
+			}
+		}
+		return 0;
+	}
+
+	void Render()
+	{
+		const unsigned int base = TAB336[VDP_Current_Line];
+		unsigned short *dst = Screen_16X + base + 8;
+
+		if(!(VDP_Reg.Set2 & 0x40))
+		{
+			// display off
+			const unsigned short fill = (VDP_Reg.Set4 & 0x08) ? 0x4040 : 0x0000;
+			for(int i = 0; i < 320; i++)
+				dst[i] = fill;
+		}
+		else
+		{
+			Update_Sprite_Struct();
+
+			switch(VDP_Reg.Set4 & 0x0C)
+			{
+				case 0x00: Render_Line_Layers<0, 0>(base); break;
+				case 0x04: Render_Line_Layers<1, 0>(base); break;
+				case 0x08: Render_Line_Layers<0, 1>(base); break;
+				case 0x0C: Render_Line_Layers<1, 1>(base); break;
+			}
+		}
+
+		// layer pixels to 0ahsbbbbggggrrrr, colour 0 of any palette shows the backdrop
+		const unsigned int backdrop = VDP_Reg.BG_Color & 0x3F;
+
+		for(int i = (160 - H_Pix_Begin) * 2; i > 0; i--, dst++)
+		{
+			unsigned int pixel = *dst;
+			unsigned int index = pixel & 0x3F;
+			if(!index)
+				index = backdrop;
+			*dst = (unsigned short)((CRam[index] & 0xEEE) | ((pixel & 0x1C0) << 6));
+		}
+	}
+};
+
+static Line_Renderer Main_Renderer;
+
+void Render_Line_C()
+{
+	Main_Renderer.Load();
+	Main_Renderer.Render();
+
+	VDP_Status |= Main_Renderer.VDP_Status;
+	if(VDP_Reg.Set2 & 0x40)
+		VRam_Flag &= ~0xFF;
+}
+
+void Tile_Cache_Invalidate()
+{
+	memset(VRam_Dirty, 0xFF, sizeof(VRam_Dirty));
+	VRam_Rewritten = 1;
+}
+
+void Tile_Cache_Invalidate_Range(unsigned int address, unsigned int length)
+{
+	if(!length)
+		return;
+	if(length > 0x10000)
+		length = 0x10000;
+
+	unsigned int tile = (address & 0xFFFF) >> 5;
+	unsigned int last = ((address & 0xFFFF) + length - 1) >> 5;
+	for(; tile <= last; tile++)
+		VRam_Dirty[tile & 0x7FF] = 0xFFFFFFFF;
+	VRam_Rewritten = 1;
+	VRam_Flag = 1;
+}
+
+
+// Verification: run both renderers on the same input, report the lines where they differ.
+// A line touches at most 344 words from its start (scroll B starts up to 7 pixels in and draws H_Cell + 1 patterns).
+#define VERIFY_SPAN 352
+#define VERIFY_MAX_REPORTS 32
+
+static void Render_Line_Verify()
+{
+	static unsigned short screen_in[VERIFY_SPAN], screen_asm[VERIFY_SPAN];
+	static unsigned char sprites_in[sizeof(Sprite_Struct)], sprites_asm[sizeof(Sprite_Struct)];
+	const unsigned int base = TAB336[VDP_Current_Line];
+	const unsigned int span = (base + VERIFY_SPAN <= 336 * 240) ? VERIFY_SPAN : 336 * 240 - base;
+	const int status_in = VDP_Status, vram_flag_in = VRam_Flag, spr_end_in = Data_Misc.Spr_End;
+	int status_asm, vram_flag_asm, spr_end_asm;
+
+	memcpy(screen_in, Screen_16X + base, span * 2);
+	memcpy(sprites_in, Sprite_Struct, sizeof(Sprite_Struct));
+
+	Render_Line();
+
+	memcpy(screen_asm, Screen_16X + base, span * 2);
+	memcpy(sprites_asm, Sprite_Struct, sizeof(Sprite_Struct));
+	status_asm = VDP_Status;
+	vram_flag_asm = VRam_Flag;
+	spr_end_asm = Data_Misc.Spr_End;
+
+	memcpy(Screen_16X + base, screen_in, span * 2);
+	memcpy(Sprite_Struct, sprites_in, sizeof(Sprite_Struct));
+	VDP_Status = status_in;
+	VRam_Flag = vram_flag_in;
+	Data_Misc.Spr_End = spr_end_in;
+
+	Render_Line_C();
+
+	if(!memcmp(screen_asm, Screen_16X + base, span * 2) && !memcmp(sprites_asm, Sprite_Struct, sizeof(Sprite_Struct))
+	&& status_asm == VDP_Status && vram_flag_asm == VRam_Flag && spr_end_asm == Data_Misc.Spr_End)
+		return;
+
+	if(++VDP_Verify_Mismatches <= VERIFY_MAX_REPORTS)
+	{
+		unsigned int i;
+		for(i = 0; i < span && screen_asm[i] == Screen_16X[base + i]; i++) {}
+
+		if(i < span)
+			fprintf(stderr, "vdp verify: frame %lu line %d: pixel %d is %04X, asm has %04X\n",
+				FrameCount, VDP_Current_Line, (int)i - 8, Screen_16X[base + i], screen_asm[i]);
+		else
+			fprintf(stderr, "vdp verify: frame %lu line %d: status %04X / sprite state differ, asm status %04X\n",
+				FrameCount, VDP_Current_Line, VDP_Status & 0xFFFF, status_asm & 0xFFFF);
+		if(VDP_Verify_Mismatches == VERIFY_MAX_REPORTS)
+			fprintf(stderr, "vdp verify: further mismatches are only counted\n");
+	}
+
+	// keep going with the reference output
+	memcpy(Screen_16X + base, screen_asm, span * 2);
+	memcpy(Sprite_Struct, sprites_asm, sizeof(Sprite_Struct));
+	VDP_Status = status_asm;
+	VRam_Flag = vram_flag_asm;
+	Data_Misc.Spr_End = spr_end_asm;
+}
+
+
+// Render thread (VDP_RENDERER_THREAD)
+// The emulation thread queues a job per line, with a copy of the VDP state and the VRAM tiles written
+// since the previous line. The render thread keeps its own VRAM, tile cache and sprite table and renders
+// the lines in order. The sprite overflow and collision bits only reach VDP_Status in VDP_Render_Sync
+// (savestates, the end of the frame) and VDP_Render_Sync_Status (status port reads), so the emulation
+// sees exactly what the in-line renderer gives. The emulation thread keeps its own sprite table in step
+// and marks the lines that can set those bits: a status read only waits for the last of these, games
+// polling the port for VBlank keep running ahead of the render thread. Only reads past the end of VRAM beyond CRam and VSRam
+// (interlaced pattern numbers above 0x3FF) see zeros instead of the memory that follows VRam.
+#define PIPE_JOBS	256
+#define PIPE_BLOCKS	4096		// 32 bytes VRAM tiles, twice the whole VRAM
+#define PIPE_TAIL	0x220		// CRam, VSRam_Over and VSRam follow VRam in vdp_io.asm
+#define PIPE_SPIN	20000		// polls before the render thread sleeps, more than a line of emulation
+
+struct Pipe_Job
+{
+	Line_Renderer Line;
+	long Block_End;				// VRAM tiles to copy before rendering the line
+	unsigned char Tail[PIPE_TAIL];
+	unsigned short Locked_Palette[0x40];
+};
+
+struct Pipe_Block
+{
+	unsigned int Tile;
+	unsigned int Data[8];
+};
+
+static Pipe_Job Pipe_Jobs[PIPE_JOBS];
+static Pipe_Block Pipe_Blocks[PIPE_BLOCKS];
+static unsigned char Pipe_VRam[0x30000];
+static unsigned int Pipe_Dirty[2048];
+static Tile_Line Pipe_Tile_Cache[0x4000];
+static Sprite_Info Pipe_Sprites[256];
+static int Pipe_Spr_End;
+static volatile int Pipe_Status;	// VDP_Status bits of the rendered lines, not merged yet
+static long Pipe_Sprite_Job;		// job count once the last line that can set sprite bits is rendered
+
+static volatile long Pipe_Posted, Pipe_Done;			// jobs queued / rendered
+static volatile long Pipe_Block_Head, Pipe_Block_Done;	// tiles queued / copied
+static volatile long Render_Sleeping, Emu_Waiting, Render_Stop;
+static Host_Handle Pipe_Job_Event, Pipe_Done_Event, Render_Thread_Handle;
+
+static void Render_Thread()
+{
+	int spin = 0;
+
+	for(;;)
+	{
+		if(Pipe_Done == Pipe_Posted)
+		{
+			if(Render_Stop)
+				break;
+			if(++spin < PIPE_SPIN)
+			{
+				Host_Pause();
+				continue;
+			}
+
+			// the emulation thread checks Render_Sleeping after queuing a job
+			Host_Atomic_Store(&Render_Sleeping, 1);
+			if(Pipe_Done == Pipe_Posted && !Render_Stop)
+				Host_Event_Wait(Pipe_Job_Event);
+			Host_Atomic_Store(&Render_Sleeping, 0);
+			continue;
+		}
+		spin = 0;
+
+		Pipe_Job &job = Pipe_Jobs[Pipe_Done & (PIPE_JOBS - 1)];
+		for(long i = Pipe_Block_Done; i != job.Block_End; i++)
+		{
+			const Pipe_Block &block = Pipe_Blocks[i & (PIPE_BLOCKS - 1)];
+			memcpy(Pipe_VRam + block.Tile * 32, block.Data, 32);
+			Pipe_Dirty[block.Tile] = 0xFFFFFFFF;
+		}
+		Pipe_Block_Done = job.Block_End;
+		memcpy(Pipe_VRam + 0x10000, job.Tail, PIPE_TAIL);
+
+		// only the marked lines set bits, the emulation thread waits for them before taking Pipe_Status
+		job.Line.Render();
+		if(job.Line.VDP_Status)
+			Pipe_Status |= job.Line.VDP_Status;
+
+		Host_Atomic_Increment(&Pipe_Done);
+		if(Emu_Waiting)
+			Host_Event_Set(Pipe_Done_Event);
+	}
+}
+
+// wait until the render thread finished the jobs before this job number
+static void Pipe_Wait(long job)
+{
+	while(Pipe_Done - job < 0)
+	{
+		Host_Atomic_Store(&Emu_Waiting, 1);
+		if(Pipe_Done - job < 0)
+			Host_Event_Wait(Pipe_Done_Event);
+		Host_Atomic_Store(&Emu_Waiting, 0);
+	}
+}
+
+static int Start_Render_Thread()
+{
+	const unsigned int cram = (unsigned int)((unsigned char *)CRam - VRam);
+	const unsigned int vsram = (unsigned int)(VSRam - VRam);
+	if(cram != 0x10000 || vsram < cram || vsram + 0x100 > 0x10000 + PIPE_TAIL)
+	{
+		fprintf(stderr, "vdp: unexpected CRam/VSRam layout, not using the render thread\n");
+		return 0;
+	}
+
+	memcpy(Pipe_Sprites, Sprite_Struct, sizeof(Pipe_Sprites));
+	Pipe_Spr_End = Data_Misc.Spr_End;
+	memset(Pipe_Dirty, 0xFF, sizeof(Pipe_Dirty));
+	Tile_Cache_Invalidate();		// the first line sends the whole VRAM
+
+	Render_Stop = 0;
+	Pipe_Job_Event = Host_Event_Create();
+	Pipe_Done_Event = Host_Event_Create();
+	Render_Thread_Handle = Host_Thread_Start(Render_Thread);
+	if(!Render_Thread_Handle)
+	{
+		fprintf(stderr, "vdp: can't start the render thread, rendering on the emulation thread\n");
+		Host_Event_Close(Pipe_Job_Event);
+		Host_Event_Close(Pipe_Done_Event);
+		return 0;
+	}
+
+	VDP_Render_Thread_On = 1;
+	return 1;
+}
+
+static void Render_Line_Queue()
+{
+	if(!VDP_Render_Thread_On && !Start_Render_Thread())
+	{
+		VDP_Renderer = VDP_RENDERER_C;
+		Render_Line_C();
+		return;
+	}
+
+	// the job slot is free once the render thread is done with the job PIPE_JOBS before
+	if(Pipe_Posted - Pipe_Done >= PIPE_JOBS)
+		Pipe_Wait(Pipe_Posted - PIPE_JOBS + 1);
+
+	Pipe_Job &job = Pipe_Jobs[Pipe_Posted & (PIPE_JOBS - 1)];
+	Line_Renderer &line = job.Line;
+	long head = Pipe_Block_Head;
+
+	// every VRAM write sets VRam_Flag too, no need to look at VRam_Dirty otherwise
+	if((VRam_Flag & 1) || VRam_Rewritten)
+	{
+		for(unsigned int tile = 0; tile < 2048; tile++)
+		{
+			if(!VRam_Dirty[tile])
+				continue;
+
+			// out of room: wait for all the queued lines, that leaves enough for the whole VRAM
+			if(head - Pipe_Block_Done >= PIPE_BLOCKS)
+				Pipe_Wait(Pipe_Posted);
+
+			Pipe_Block &block = Pipe_Blocks[head & (PIPE_BLOCKS - 1)];
+			block.Tile = tile;
+			memcpy(block.Data, VRam + tile * 32, 32);
+			VRam_Dirty[tile] = 0;
+			head++;
+		}
+		VRam_Rewritten = 0;
+	}
+	Pipe_Block_Head = head;
+	job.Block_End = head;
+	memcpy(job.Tail, VRam + 0x10000, PIPE_TAIL);
+
+	line.Load();
+	if(line.Sprite_Status_Possible())
+		Pipe_Sprite_Job = Pipe_Posted + 1;
+	line.VRam = Pipe_VRam;
+	line.VSRam = Pipe_VRam + (VSRam - VRam);
+	if(PalLock & 1)
+	{
+		memcpy(job.Locked_Palette, LockedPalette, sizeof(job.Locked_Palette));
+		line.CRam = job.Locked_Palette;
+	}
+	else
+		line.CRam = (const unsigned short *)(Pipe_VRam + 0x10000);
+	line.ScrA_Addr = Pipe_VRam + (ScrA_Addr - VRam);
+	line.ScrB_Addr = Pipe_VRam + (ScrB_Addr - VRam);
+	line.Win_Addr = Pipe_VRam + (Win_Addr - VRam);
+	line.Spr_Addr = Pipe_VRam + (Spr_Addr - VRam);
+	line.H_Scroll_Addr = Pipe_VRam + (H_Scroll_Addr - VRam);
+	line.Sprite_Struct = Pipe_Sprites;
+	line.Spr_End = &Pipe_Spr_End;
+	line.VRam_Dirty = Pipe_Dirty;
+	line.Tile_Cache = Pipe_Tile_Cache;
+
+	if(VDP_Reg.Set2 & 0x40)
+		VRam_Flag &= ~0xFF;
+
+	// the render thread checks Pipe_Posted after saying it sleeps
+	Host_Atomic_Increment(&Pipe_Posted);
+	if(Render_Sleeping)
+		Host_Event_Set(Pipe_Job_Event);
+}
+
+void VDP_Render_Sync()
+{
+	if(!VDP_Render_Thread_On)
+		return;
+
+	Pipe_Wait(Pipe_Posted);
+	VDP_Status |= Pipe_Status;
+	Pipe_Status = 0;
+}
+
+void VDP_Render_Sync_Status()
+{
+	if(!VDP_Render_Thread_On)
+		return;
+
+	// the lines after the last marked one don't touch Pipe_Status
+	Pipe_Wait(Pipe_Sprite_Job);
+	VDP_Status |= Pipe_Status;
+	Pipe_Status = 0;
+}
+
+void VDP_Render_Stop()
+{
+	if(!VDP_Render_Thread_On)
+		return;
+
+	// the render thread finishes the queued lines first
+	Host_Atomic_Store(&Render_Stop, 1);
+	Host_Event_Set(Pipe_Job_Event);
+	Host_Thread_Join(Render_Thread_Handle);
+	Host_Event_Close(Pipe_Job_Event);
+	Host_Event_Close(Pipe_Done_Event);
+
+	VDP_Status |= Pipe_Status;
+	Pipe_Status = 0;
+	VDP_Render_Thread_On = 0;
+}
+
+void Render_Line_Selected()
+{
+	PROF_SCOPE(PROF_LINE);
+
+	switch(VDP_Renderer)
+	{
+		case VDP_RENDERER_C:
+			Render_Line_C();
+			break;
+		case VDP_RENDERER_VERIFY:
+			Render_Line_Verify();
+			break;
+		case VDP_RENDERER_THREAD:
+			Render_Line_Queue();
+			break;
+		default:
+			Render_Line();
+			break;
+	}
+}
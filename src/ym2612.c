@@ -1850,53 +1850,15 @@ void Update_Chan_Algo7_LFO_Int(channel_ *CH, int **buf, int length)
  ***********************************************/
 
 
-// Initialisation de l'mulateur YM2612
-int YM2612_Init(int Clock, int Rate, int Interpolation)
+// Tables that don't depend on the clock or the rate (YM2612_Init is called again at every game start)
+
+static int Fixed_Tables_Done = 0;
+
+static void YM2612_Init_Fixed_Tables(void)
 {
 	int i, j;
 	double x;
 
-	if ((Rate == 0) || (Clock == 0)) return 1;
-
-	memset(&YM2612, 0, sizeof(YM2612));
-
-#if YM_DEBUG_LEVEL > 0
-	if (debug_file == NULL)
-	{
-		debug_file = fopen("ym2612.log", "w");
-		fprintf(debug_file, "YM2612 logging :\n\n");
-	}
-#endif
-
-	YM2612.Clock = Clock;
-	YM2612.Rate = Rate;
-
-	// 144 = 12 * (prescale * 2) = 12 * 6 * 2
-	// prescale set to 6 by default
-
-	YM2612.Frequence = ((double) YM2612.Clock / (double) YM2612.Rate) / 144.0;
-	YM2612.TimerBase = (int) (YM2612.Frequence * 4096.0);
-
-	if ((Interpolation) && (YM2612.Frequence > 1.0))
-	{
-		YM2612.Inter_Step = (unsigned int) ((1.0 / YM2612.Frequence) * (double) (0x4000));
-		YM2612.Inter_Cnt = 0;
-
-		// We recalculate rate and frequence after interpolation
-			
-		YM2612.Rate = YM2612.Clock / 144;
-		YM2612.Frequence = 1.0;
-	}
-	else
-	{
-		YM2612.Inter_Step = 0x4000;
-		YM2612.Inter_Cnt = 0;
-	}
-
-#if YM_DEBUG_LEVEL > 1
-	fprintf(debug_file, "YM2612 frequence = %g rate = %d  interp step = %.8X\n\n", YM2612.Frequence, YM2612.Rate, YM2612.Inter_Step);
-#endif
-
 	// Tableau TL :
 	// [0     -  4095] = +output  [4095  - ...] = +output overflow (fill with 0)
 	// [12288 - 16383] = -output  [16384 - ...] = -output overflow (fill with 0)
@@ -2027,6 +1989,63 @@ int YM2612_Init(int Clock, int Rate, int Interpolation)
 	j = ENV_LENGTH - 1;				// special case : volume off
 	j <<= ENV_LBITS;
 	SL_TAB[15] = j + ENV_DECAY;
+}
+
+
+// Initialisation de l'mulateur YM2612
+int YM2612_Init(int Clock, int Rate, int Interpolation)
+{
+	int i, j;
+	double x;
+
+	if ((Rate == 0) || (Clock == 0)) return 1;
+
+	memset(&YM2612, 0, sizeof(YM2612));
+
+#if YM_DEBUG_LEVEL > 0
+	if (debug_file == NULL)
+	{
+		debug_file = fopen("ym2612.log", "w");
+		fprintf(debug_file, "YM2612 logging :\n\n");
+	}
+#endif
+
+	YM2612.Clock = Clock;
+	YM2612.Rate = Rate;
+
+	// 144 = 12 * (prescale * 2) = 12 * 6 * 2
+	// prescale set to 6 by default
+
+	YM2612.Frequence = ((double) YM2612.Clock / (double) YM2612.Rate) / 144.0;
+	YM2612.TimerBase = (int) (YM2612.Frequence * 4096.0);
+
+	if ((Interpolation) && (YM2612.Frequence > 1.0))
+	{
+		YM2612.Inter_Step = (unsigned int) ((1.0 / YM2612.Frequence) * (double) (0x4000));
+		YM2612.Inter_Cnt = 0;
+
+		// We recalculate rate and frequence after interpolation
+			
+		YM2612.Rate = YM2612.Clock / 144;
+		YM2612.Frequence = 1.0;
+	}
+	else
+	{
+		YM2612.Inter_Step = 0x4000;
+		YM2612.Inter_Cnt = 0;
+	}
+
+#if YM_DEBUG_LEVEL > 1
+	fprintf(debug_file, "YM2612 frequence = %g rate = %d  interp step = %.8X\n\n", YM2612.Frequence, YM2612.Rate, YM2612.Inter_Step);
+#endif
+
+	// the tables that don't depend on the clock and rate only once
+
+	if (!Fixed_Tables_Done)
+	{
+		YM2612_Init_Fixed_Tables();
+		Fixed_Tables_Done = 1;
+	}
 
 	// Tableau Frequency Step
 
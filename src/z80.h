@@ -43,7 +43,11 @@ extern "C" {
 #endif
 
 #ifndef FASTCALL
+#if defined(_M_IX86) || defined(__i386__)
 #define FASTCALL __fastcall
+#else
+#define FASTCALL
+#endif
 #endif
 
 
@@ -343,6 +347,14 @@ UINT32 FASTCALL z80_Set_AF(Z80_CONTEXT *z80, UINT32 AF);
 UINT32 FASTCALL z80_Set_AF2(Z80_CONTEXT *z80, UINT32 AF2);
 
 
+/* C++ core (z80_c.cpp): the same functions, prefixed z80c_ next to z80.asm */
+/* or z80_ in place of it when Z80_C_CORE is defined */
+
+#ifndef Z80_C_CORE
+UINT32 FASTCALL z80c_Exec(Z80_CONTEXT *z80, int odo);
+#endif
+
+
 #ifdef __cplusplus
 };
 #endif
@@ -0,0 +1,3631 @@
+// Portable C++ version of the Z80 core (z80.asm)
+// Same context (Z80_CONTEXT), functions and cycle counts as the asm, opcode routine for opcode routine:
+// the handlers below have the names of the asm ones and the opcode tables are the asm tables, with
+// their quirks (DD/FD 1C/1D swapped, DD/FD FC = CALL P, DDCB/FDCB BIT on registers, RLD, SLL r...).
+// The flags are computed the way the x86 instructions used by the asm set them.
+// Built as z80c_* next to z80.asm (see z80_verify.cpp), or as z80_* with Z80_C_CORE defined
+// for builds without the asm. The memory access can be replaced with Z80C_READ_BYTE and co.
+//
+// Known differences with the asm:
+// - DAA with H set: the asm reads its result past the end of DAA_Table, the C++ core uses the table as meant.
+// - word accesses at 1FFF / 3FFF wrap to the start of the RAM instead of reading/writing past Ram_Z80.
+// - without 32 bit pointers, PC.d holds the Z80 address (BasePC is 0) and z80_Exec rebases it from Fetch.
+
+#include <stddef.h>
+#include <string.h>
+#include "z80.h"
+#include "Mem_Z80.h"
+
+#ifndef Z80C_NAME
+#ifdef Z80_C_CORE
+#define Z80C_NAME(x) z80_##x
+#else
+#define Z80C_NAME(x) z80c_##x
+#endif
+#endif
+
+// the context can keep host pointers, as the asm does: the same context works with both cores
+#if defined(_M_IX86) || defined(__i386__)
+#define Z80C_HOST_PC 1
+#else
+#define Z80C_HOST_PC 0
+#endif
+
+#define FLAG_C	0x01
+#define FLAG_N	0x02
+#define FLAG_P	0x04
+#define FLAG_X	0x08
+#define FLAG_H	0x10
+#define FLAG_Y	0x20
+#define FLAG_Z	0x40
+#define FLAG_S	0x80
+
+#define Z80_RUNNING	0x01
+#define Z80_HALTED	0x02
+#define Z80_FAULTED	0x10
+
+// what the handlers return besides a cycle count (NEXT)
+#define Z80C_CHAIN	-1		// go on with Chain_Table[PC[Chain_Ofs]] without checking the cycles (prefixes, DI, EI)
+#define Z80C_QUIT	-2		// z80_Exec_Really_Quit
+
+typedef int (*Z80C_OP)(void);
+
+// What the asm keeps in registers: the context (ebp), the based PC (esi) and the cycle counter (edi).
+// A, F and HL stay in the context.
+static Z80_CONTEXT *Z;
+static UINT8 *PC, *Base;
+static int Cycles;
+static UINT32 Quit_Halted;		// edx at z80_Exec_Really_Quit, HALTED bit adds the cycles left
+static const Z80C_OP *Chain_Table;
+static unsigned int Chain_Ofs;
+
+static UINT8 Def_Mem[0x10000];
+static UINT8 INC_Table[256], DEC_Table[256], SZP_Table[256];
+static UINT16 DAA_Table[2048];
+static int Tables_Built = 0;
+
+#define zA		(Z->AF.b.A)
+#define zF		(Z->AF.b.F)
+#define zFXY	(Z->AF.b.FXY)
+#define zB		(Z->BC.b.B)
+#define zC		(Z->BC.b.C)
+#define zD		(Z->DE.b.D)
+#define zE		(Z->DE.b.E)
+#define zH		(Z->HL.b.H)
+#define zL		(Z->HL.b.L)
+#define zhIX	(Z->IX.b.IXH)
+#define zlIX	(Z->IX.b.IXL)
+#define zhIY	(Z->IY.b.IYH)
+#define zlIY	(Z->IY.b.IYL)
+#define zBC		(Z->BC.w.BC)
+#define zDE		(Z->DE.w.DE)
+#define zHL		(Z->HL.w.HL)
+#define zIX		(Z->IX.w.IX)
+#define zIY		(Z->IY.w.IY)
+#define zSP		(Z->SP.w.SP)
+#define zI		(Z->I)
+#define zR		(Z->R.b.R1)
+#define zIFF1	(Z->IFF.b.IFF2)		// the asm uses IFF2 for both
+#define zIFF2	(Z->IFF.b.IFF2)
+
+#define DIR_I	1
+#define DIR_D	-1
+
+
+static void Build_Tables(void)
+{
+	int v, r, p, i, a, c, n, h, diff;
+
+	for(v = 0; v < 256; v++)
+	{
+		for(p = 0, i = v; i; i >>= 1)
+			p ^= i & 1;
+		SZP_Table[v] = (v & FLAG_S) | (v ? 0 : FLAG_Z) | (p ? 0 : FLAG_P);
+
+		r = (v + 1) & 0xFF;
+		INC_Table[v] = (r & (FLAG_S | FLAG_Y | FLAG_X)) | (r ? 0 : FLAG_Z)
+			| ((v & 0xF) == 0xF ? FLAG_H : 0) | (v == 0x7F ? FLAG_P : 0);
+		r = (v - 1) & 0xFF;
+		DEC_Table[v] = (r & (FLAG_S | FLAG_Y | FLAG_X)) | (r ? 0 : FLAG_Z)
+			| ((v & 0xF) == 0 ? FLAG_H : 0) | (v == 0x80 ? FLAG_P : 0) | FLAG_N;
+	}
+
+	// indexed by A | C << 8 | N << 9 | H << 10, F << 8 | A as in the asm table
+	for(i = 0; i < 2048; i++)
+	{
+		a = i & 0xFF;
+		c = (i >> 8) & 1;
+		n = (i >> 9) & 1;
+		h = (i >> 10) & 1;
+		diff = 0;
+		if(c || a > 0x99)
+		{
+			diff = 0x60;
+			c = 1;
+		}
+		if(h || (a & 0xF) > 9)
+			diff += 6;
+		r = (n ? a - diff : a + diff) & 0xFF;
+		h = n ? (h && (a & 0xF) < 6) : ((a & 0xF) > 9);
+		DAA_Table[i] = (UINT16)(((r & 0xA8) | SZP_Table[r] | (h ? FLAG_H : 0) | (n ? FLAG_N : 0) | c) << 8 | r);
+	}
+
+	Tables_Built = 1;
+}
+
+
+// Memory access, GENS_OPT version: the RAM is read and written directly, the rest goes through
+// the handlers with the cycle counter in CycleIO (z80_Read_Odo / z80_Add_Cycles / z80_Interrupt use it).
+
+#ifndef Z80C_READ_BYTE
+static inline UINT8 Z80C_Read_Byte(UINT32 adr)
+{
+	UINT8 data;
+
+	if(adr <= 0x3FFF)
+		return Ram_Z80[adr & 0x1FFF];
+	Z->CycleIO = Cycles;
+	data = Z->ReadB[(adr >> 8) & 0xFF](adr);
+	Cycles = Z->CycleIO;
+	return data;
+}
+
+static inline UINT16 Z80C_Read_Word(UINT32 adr)
+{
+	UINT16 data;
+
+	if(adr <= 0x3FFF)
+		return Ram_Z80[adr & 0x1FFF] | Ram_Z80[(adr + 1) & 0x1FFF] << 8;
+	Z->CycleIO = Cycles;
+	data = Z->ReadW[(adr >> 8) & 0xFF](adr);
+	Cycles = Z->CycleIO;
+	return data;
+}
+
+static inline void Z80C_Write_Byte(UINT32 adr, UINT8 data)
+{
+	if(adr <= 0x3FFF)
+	{
+		Ram_Z80[adr & 0x1FFF] = data;
+		return;
+	}
+	Z->CycleIO = Cycles;
+	Z->WriteB[(adr >> 8) & 0xFF](adr, data);
+	Cycles = Z->CycleIO;
+}
+
+static inline void Z80C_Write_Word(UINT32 adr, UINT16 data)
+{
+	if(adr <= 0x3FFF)
+	{
+		Ram_Z80[adr & 0x1FFF] = (UINT8)data;
+		Ram_Z80[(adr + 1) & 0x1FFF] = (UINT8)(data >> 8);
+		return;
+	}
+	Z->CycleIO = Cycles;
+	Z->WriteW[(adr >> 8) & 0xFF](adr, data);
+	Cycles = Z->CycleIO;
+}
+
+#define Z80C_READ_BYTE Z80C_Read_Byte
+#define Z80C_READ_WORD Z80C_Read_Word
+#define Z80C_WRITE_BYTE Z80C_Write_Byte
+#define Z80C_WRITE_WORD Z80C_Write_Word
+#endif
+
+#define READ_BYTE(adr)			Z80C_READ_BYTE(adr)
+#define READ_WORD(adr)			Z80C_READ_WORD(adr)
+#define WRITE_BYTE(adr, data)	Z80C_WRITE_BYTE(adr, data)
+#define WRITE_WORD(adr, data)	Z80C_WRITE_WORD(adr, data)
+
+// high byte of ecx after READ_BYTE, what BIT b,(HL) / (XY+d) leaves in the X/Y flags
+// (the asm has whatever the handler left in ecx when the address isn't RAM)
+#define READ_ADR_HIGH(adr)		(UINT8)(((adr) <= 0x3FFF ? (adr) & 0x1FFF : (adr)) >> 8)
+
+#define FETCH_WORD(ofs)			(UINT32)(PC[ofs] | PC[(ofs) + 1] << 8)
+#define XY_ADR(xy)				((z##xy + (INT8)PC[1]) & 0xFFFF)
+
+
+static inline void Rebase_PC(UINT32 adr)
+{
+	Base = Z->Fetch[adr >> 8];
+	PC = Base + adr;
+}
+
+static inline void Load_PC(void)
+{
+#if Z80C_HOST_PC
+	PC = (UINT8 *)(size_t)Z->PC.d;
+	Base = (UINT8 *)(size_t)Z->BasePC;
+#else
+	Rebase_PC(Z->PC.d & 0xFFFF);
+#endif
+}
+
+static inline void Store_PC(void)
+{
+#if Z80C_HOST_PC
+	Z->PC.d = (UINT32)(size_t)PC;
+	Z->BasePC = (UINT32)(size_t)Base;
+#else
+	Z->PC.d = (UINT32)(PC - Base);
+	Z->BasePC = 0;
+#endif
+}
+
+static inline UINT32 Logical_PC(void)
+{
+	return (UINT32)(PC - Base);
+}
+
+static inline void Push(UINT16 data)
+{
+	UINT32 sp = (Z->SP.d - 2) & 0xFFFF;
+
+	Z->SP.d = sp;
+	WRITE_WORD(sp, data);
+}
+
+static inline UINT16 Pop(void)
+{
+	UINT16 data = READ_WORD(Z->SP.d);
+
+	Z->SP.d = (Z->SP.d + 2) & 0xFFFF;
+	return data;
+}
+
+
+static void Do_NMI(void)
+{
+	Push((UINT16)Logical_PC());
+	zIFF1 = 0;
+	Z->IntLine &= ~0x80;
+	Z->Status &= ~Z80_HALTED;
+	Rebase_PC(0x66);
+}
+
+static void Do_INT(void)
+{
+	Push((UINT16)Logical_PC());
+	Z->Status &= ~Z80_HALTED;
+	Z->IntLine &= 0x80;
+	Z->IFF.d = 0;
+
+	if(Z->IM == 0)
+	{
+		Cycles -= 13;
+		Rebase_PC((UINT8)(Z->IntVect - 0xC7));		// assume we have a RST instruction
+	}
+	else if(Z->IM == 1)
+	{
+		Cycles -= 13;
+		Rebase_PC(0x38);
+	}
+	else
+	{
+		Cycles -= 19;
+		Rebase_PC(READ_WORD(zI << 8 | Z->IntVect));
+	}
+}
+
+static inline void Check_Int(void)
+{
+	UINT8 line = Z->IntLine;
+
+	if(!line)
+		return;
+	if(line & 0x80)
+		Do_NMI();
+	else if(line & zIFF1)
+		Do_INT();
+}
+
+
+// Flags of the 8 bit operations, as lahf leaves them after the x86 instruction
+
+static inline void OP_ADD(UINT8 v)
+{
+	UINT32 r = zA + v;
+
+	zF = (r & FLAG_S) | ((r & 0xFF) ? 0 : FLAG_Z) | ((zA ^ v ^ r) & FLAG_H) | (r >> 8)
+		| ((~(zA ^ v) & (zA ^ r) & 0x80) ? FLAG_P : 0);
+	zA = (UINT8)r;
+	zFXY = zA;
+}
+
+static inline void OP_ADC(UINT8 v)
+{
+	UINT32 r = zA + v + (zF & FLAG_C);
+
+	zF = (r & FLAG_S) | ((r & 0xFF) ? 0 : FLAG_Z) | ((zA ^ v ^ r) & FLAG_H) | (r >> 8)
+		| ((~(zA ^ v) & (zA ^ r) & 0x80) ? FLAG_P : 0);
+	zA = (UINT8)r;
+	zFXY = zA;
+}
+
+static inline UINT8 Sub_Flags(UINT8 v, UINT32 c)
+{
+	UINT32 r = zA - v - c;
+
+	zF = (r & FLAG_S) | ((r & 0xFF) ? 0 : FLAG_Z) | ((zA ^ v ^ r) & FLAG_H) | ((r >> 8) & FLAG_C)
+		| (((zA ^ v) & (zA ^ r) & 0x80) ? FLAG_P : 0) | FLAG_N;
+	return (UINT8)r;
+}
+
+static inline void OP_SUB(UINT8 v)
+{
+	zA = Sub_Flags(v, 0);
+	zFXY = zA;
+}
+
+static inline void OP_SBC(UINT8 v)
+{
+	zA = Sub_Flags(v, zF & FLAG_C);
+	zFXY = zA;
+}
+
+static inline void OP_CP(UINT8 v)
+{
+	Sub_Flags(v, 0);
+	zFXY = v;
+}
+
+static inline void OP_AND(UINT8 v)
+{
+	zA &= v;
+	zF = SZP_Table[zA] | FLAG_H;
+	zFXY = zA;
+}
+
+static inline void OP_OR(UINT8 v)
+{
+	zA |= v;
+	zF = SZP_Table[zA];
+	zFXY = zA;
+}
+
+static inline void OP_XOR(UINT8 v)
+{
+	zA ^= v;
+	zF = SZP_Table[zA];
+	zFXY = zA;
+}
+
+static inline UINT8 OP_INC(UINT8 v)
+{
+	zF = (zF & FLAG_C) | INC_Table[v];
+	zFXY = (UINT8)(v + 1);
+	return zFXY;
+}
+
+static inline UINT8 OP_DEC(UINT8 v)
+{
+	zF = (zF & FLAG_C) | DEC_Table[v];
+	zFXY = (UINT8)(v - 1);
+	return zFXY;
+}
+
+// CB rotations and shifts: RLC / RL / RRC / RR set S, Z, P from the result (test),
+// the shifts take the flags of the x86 shift. SLL gets the flags of SLA with P set, then bit 0.
+
+static inline UINT8 Rot_Flags(UINT8 r, UINT8 c)
+{
+	zF = SZP_Table[r] | c;
+	zFXY = r;
+	return r;
+}
+
+static inline UINT8 OP_RLC(UINT8 v)
+{
+	return Rot_Flags((UINT8)(v << 1 | v >> 7), v >> 7);
+}
+
+static inline UINT8 OP_RL(UINT8 v)
+{
+	return Rot_Flags((UINT8)(v << 1 | (zF & FLAG_C)), v >> 7);
+}
+
+static inline UINT8 OP_RRC(UINT8 v)
+{
+	return Rot_Flags((UINT8)(v >> 1 | v << 7), v & 1);
+}
+
+static inline UINT8 OP_RR(UINT8 v)
+{
+	return Rot_Flags((UINT8)(v >> 1 | (zF & FLAG_C) << 7), v & 1);
+}
+
+static inline UINT8 OP_SLA(UINT8 v)
+{
+	return Rot_Flags((UINT8)(v << 1), v >> 7);
+}
+
+static inline UINT8 OP_SRA(UINT8 v)
+{
+	return Rot_Flags((UINT8)(v >> 1 | (v & 0x80)), v & 1);
+}
+
+static inline UINT8 OP_SRL(UINT8 v)
+{
+	return Rot_Flags((UINT8)(v >> 1), v & 1);
+}
+
+static inline UINT8 OP_SLL(UINT8 v)
+{
+	Rot_Flags((UINT8)(v << 1), v >> 7);
+	zF |= FLAG_P;
+	return (UINT8)(v << 1 | 1);
+}
+
+// BIT b: X/Y come from the register for bits 3 and 5, from the address high byte for (HL) / (XY+d)
+static inline void OP_BIT(int b, UINT8 v, UINT8 xy)
+{
+	zF &= FLAG_C;
+	if(!(v & (1 << b)))
+	{
+		zFXY = 0;
+		zF |= FLAG_Z | FLAG_H | FLAG_P;
+	}
+	else if(b == 7)
+	{
+		zFXY = 0;
+		zF |= FLAG_S | FLAG_H;
+	}
+	else if(b == 5)
+	{
+		zFXY = xy;
+		zF |= FLAG_Y | FLAG_H;
+	}
+	else if(b == 3)
+	{
+		zFXY = xy;
+		zF |= FLAG_X | FLAG_H;
+	}
+	else
+	{
+		zFXY = 0;
+		zF |= FLAG_H;
+	}
+}
+
+#define OP_SET(b, v)	(UINT8)((v) | (1 << (b)))
+#define OP_RES(b, v)	(UINT8)((v) & ~(1 << (b)))
+
+
+// Opcode routines, same names, order and cycle counts as z80.asm
+
+static int PREFIXE_CB(void);
+static int PREFIXE_ED(void);
+static int PREFIXE_DD(void);
+static int PREFIXE_FD(void);
+static int PREFIXE_DDCB(void);
+static int PREFIXE_FDCB(void);
+
+static int Z80I_NOP(void)
+{
+	PC++;
+	return 4;
+}
+
+
+// Load 8 bits instruction
+
+#define LD_R_R(d, s)	\
+static int Z80I_LD_##d##_##s(void)	\
+{	\
+	PC++;	\
+	z##d = z##s;	\
+	return 4;	\
+}
+
+#define LD_R_N(d)	\
+static int Z80I_LD_##d##_N(void)	\
+{	\
+	z##d = PC[1];	\
+	PC += 2;	\
+	return 7;	\
+}
+
+#define LD_R_mHL(d)	\
+static int Z80I_LD_##d##_mHL(void)	\
+{	\
+	PC++;	\
+	z##d = READ_BYTE(zHL);	\
+	return 7;	\
+}
+
+#define LD_R_mXYd(r, xy)	\
+static int Z80I_LD_##r##_m##xy##d(void)	\
+{	\
+	UINT32 adr = XY_ADR(xy);	\
+	PC += 2;	\
+	z##r = READ_BYTE(adr);	\
+	return 15;	\
+}
+
+#define LD_mHL_R(s)	\
+static int Z80I_LD_mHL_##s(void)	\
+{	\
+	PC++;	\
+	WRITE_BYTE(zHL, z##s);	\
+	return 7;	\
+}
+
+#define LD_mXYd_R(s, xy)	\
+static int Z80I_LD_m##xy##d_##s(void)	\
+{	\
+	UINT32 adr = XY_ADR(xy);	\
+	PC += 2;	\
+	WRITE_BYTE(adr, z##s);	\
+	return 15;	\
+}
+
+static int Z80I_LD_mHL_N(void)
+{
+	UINT8 data = PC[1];
+
+	PC += 2;
+	WRITE_BYTE(zHL, data);
+	return 10;
+}
+
+#define LD_mXYd_N(xy)	\
+static int Z80I_LD_m##xy##d_N(void)	\
+{	\
+	UINT32 adr = XY_ADR(xy);	\
+	PC += 3;	\
+	WRITE_BYTE(adr, PC[-1]);	\
+	return 15;	\
+}
+
+static int Z80I_LD_A_mBC(void)
+{
+	PC++;
+	zA = READ_BYTE(zBC);
+	return 7;
+}
+
+static int Z80I_LD_A_mDE(void)
+{
+	PC++;
+	zA = READ_BYTE(zDE);
+	return 7;
+}
+
+static int Z80I_LD_A_mNN(void)
+{
+	UINT32 adr = FETCH_WORD(1);
+
+	PC += 3;
+	zA = READ_BYTE(adr);
+	return 13;
+}
+
+static int Z80I_LD_mBC_A(void)
+{
+	PC++;
+	WRITE_BYTE(zBC, zA);
+	return 7;
+}
+
+static int Z80I_LD_mDE_A(void)
+{
+	PC++;
+	WRITE_BYTE(zDE, zA);
+	return 7;
+}
+
+static int Z80I_LD_mNN_A(void)
+{
+	UINT32 adr = FETCH_WORD(1);
+
+	PC += 3;
+	WRITE_BYTE(adr, zA);
+	return 13;
+}
+
+static int Z80I_LD_A_I(void)
+{
+	zA = zI;
+	zF = (SZP_Table[zA] & (FLAG_S | FLAG_Z)) | (zF & FLAG_C) | zIFF2;
+	zFXY = zA;
+	PC += 2;
+	return 9;
+}
+
+// R is the odometer / 4 plus what was written to it
+static int Z80I_LD_A_R(void)
+{
+	UINT32 odo = Z->CycleCnt - (UINT32)Cycles + Z->CycleTD;
+
+	zA = (UINT8)((odo >> 2) + zR) & 0x7F;
+	zF = (zA ? 0 : FLAG_Z) | (zF & FLAG_C) | zIFF2;
+	zFXY = zA;
+	PC += 2;
+	return 9;
+}
+
+static int Z80I_LD_I_A(void)
+{
+	PC += 2;
+	zI = zA;
+	return 9;
+}
+
+static int Z80I_LD_R_A(void)
+{
+	PC += 2;
+	zR = zA;
+	return 9;
+}
+
+
+// Load 16 bits instruction
+
+#define LD_RR_NN(d)	\
+static int Z80I_LD_##d##_NN(void)	\
+{	\
+	z##d = (UINT16)FETCH_WORD(1);	\
+	PC += 3;	\
+	return 10;	\
+}
+
+static int Z80I_LD_HL_mNN(void)
+{
+	UINT32 adr = FETCH_WORD(1);
+
+	PC += 3;
+	zHL = READ_WORD(adr);
+	return 16;
+}
+
+#define LD_RR_mNN(d)	\
+static int Z80I_LD_##d##_mNN(void)	\
+{	\
+	UINT32 adr = FETCH_WORD(2);	\
+	PC += 4;	\
+	z##d = READ_WORD(adr);	\
+	return 20;	\
+}
+
+static int Z80I_LD2_HL_mNN(void)
+{
+	UINT32 adr = FETCH_WORD(2);
+
+	PC += 4;
+	zHL = READ_WORD(adr);
+	return 20;
+}
+
+#define LD_XY_mNN(d)	\
+static int Z80I_LD_##d##_mNN(void)	\
+{	\
+	UINT32 adr = FETCH_WORD(1);	\
+	PC += 3;	\
+	z##d = READ_WORD(adr);	\
+	return 16;	\
+}
+
+static int Z80I_LD_mNN_HL(void)
+{
+	UINT32 adr = FETCH_WORD(1);
+
+	PC += 3;
+	WRITE_WORD(adr, zHL);
+	return 16;
+}
+
+#define LD_mNN_RR(s)	\
+static int Z80I_LD_mNN_##s(void)	\
+{	\
+	UINT32 adr = FETCH_WORD(2);	\
+	PC += 4;	\
+	WRITE_WORD(adr, z##s);	\
+	return 20;	\
+}
+
+static int Z80I_LD2_mNN_HL(void)
+{
+	UINT32 adr = FETCH_WORD(2);
+
+	PC += 4;
+	WRITE_WORD(adr, zHL);
+	return 20;
+}
+
+#define LD_mNN_XY(s)	\
+static int Z80I_LD_mNN_##s(void)	\
+{	\
+	UINT32 adr = FETCH_WORD(1);	\
+	PC += 3;	\
+	WRITE_WORD(adr, z##s);	\
+	return 16;	\
+}
+
+#define LD_SP_RR(s)	\
+static int Z80I_LD_SP_##s(void)	\
+{	\
+	PC++;	\
+	zSP = z##s;	\
+	return 6;	\
+}
+
+// PUSH AF merges the X/Y flags kept in FXY
+static int Z80I_PUSH_AF(void)
+{
+	PC++;
+	Push((UINT16)(zA << 8 | (zF & ~(FLAG_X | FLAG_Y)) | (zFXY & (FLAG_X | FLAG_Y))));
+	return 11;
+}
+
+#define PUSH_RR(s)	\
+static int Z80I_PUSH_##s(void)	\
+{	\
+	PC++;	\
+	Push(z##s);	\
+	return 11;	\
+}
+
+static int Z80I_POP_AF(void)
+{
+	UINT16 data;
+
+	PC++;
+	data = Pop();
+	zF = (UINT8)data;
+	zFXY = (UINT8)data;
+	zA = (UINT8)(data >> 8);
+	return 10;
+}
+
+#define POP_RR(d)	\
+static int Z80I_POP_##d(void)	\
+{	\
+	PC++;	\
+	z##d = Pop();	\
+	return 10;	\
+}
+
+
+// Exchange, block transfert/search instruction
+
+static int Z80I_EX_DE_HL(void)
+{
+	UINT32 tmp = Z->HL.d;
+
+	PC++;
+	Z->HL.d = Z->DE.d;
+	Z->DE.d = tmp;
+	return 4;
+}
+
+static int Z80I_EX_AF_AF2(void)
+{
+	UINT16 af = Z->AF.w.AF;
+	UINT8 fxy = zFXY;
+
+	PC++;
+	Z->AF.w.AF = Z->AF2.w.AF2;
+	Z->AF2.w.AF2 = af;
+	zFXY = Z->AF2.b.FXY2;
+	Z->AF2.b.FXY2 = fxy;
+	return 4;
+}
+
+static int Z80I_EXX(void)
+{
+	UINT32 tmp;
+
+	tmp = Z->BC.d;
+	Z->BC.d = Z->BC2.d;
+	Z->BC2.d = tmp;
+	PC++;
+	tmp = Z->DE.d;
+	Z->DE.d = Z->DE2.d;
+	Z->DE2.d = tmp;
+	tmp = Z->HL.d;
+	Z->HL.d = Z->HL2.d;
+	Z->HL2.d = tmp;
+	return 4;
+}
+
+#define EX_mSP_DD(r)	\
+static int Z80I_EX_mSP_##r(void)	\
+{	\
+	UINT16 data;	\
+	PC++;	\
+	data = READ_WORD(Z->SP.d);	\
+	WRITE_WORD(Z->SP.d, z##r);	\
+	z##r = data;	\
+	return 19;	\
+}
+
+#define LDX(d)	\
+static int Z80I_LD##d(void)	\
+{	\
+	PC += 2;	\
+	WRITE_BYTE(zDE, READ_BYTE(zHL));	\
+	zF &= FLAG_S | FLAG_Z | FLAG_C;	\
+	zHL += DIR_##d;	\
+	zDE += DIR_##d;	\
+	if(--zBC)	\
+		zF |= FLAG_P;	\
+	return 16;	\
+}
+
+// runs until BC is 0 or the cycles are out, then the instruction is started again by the next z80_Exec
+#define LDXR(d)	\
+static int Z80I_LD##d##R(void)	\
+{	\
+	for(;;)	\
+	{	\
+		WRITE_BYTE(zDE, READ_BYTE(zHL));	\
+		zHL += DIR_##d;	\
+		zDE += DIR_##d;	\
+		if(!--zBC)	\
+			break;	\
+		Cycles -= 21;	\
+		if(Cycles < 0)	\
+		{	\
+			zF &= FLAG_S | FLAG_Z | FLAG_C;	\
+			Quit_Halted = zBC;	\
+			return Z80C_QUIT;	\
+		}	\
+	}	\
+	PC += 2;	\
+	zF &= FLAG_S | FLAG_Z | FLAG_C;	\
+	return 16;	\
+}
+
+#define CPX(d)	\
+static int Z80I_CP##d(void)	\
+{	\
+	UINT8 data, c;	\
+	PC += 2;	\
+	data = READ_BYTE(zHL);	\
+	c = zF & FLAG_C;	\
+	zHL += DIR_##d;	\
+	Sub_Flags(data, 0);	\
+	zF = (zF & (FLAG_S | FLAG_Z | FLAG_H | FLAG_N)) | c;	\
+	if(--zBC)	\
+		zF |= FLAG_P;	\
+	return 16;	\
+}
+
+#define CPXR(d)	\
+static int Z80I_CP##d##R(void)	\
+{	\
+	UINT8 data, c = zF & FLAG_C;	\
+	for(;;)	\
+	{	\
+		data = READ_BYTE(zHL);	\
+		zHL += DIR_##d;	\
+		if(!--zBC)	\
+		{	\
+			Sub_Flags(data, 0);	\
+			zF = (zF & (FLAG_S | FLAG_Z | FLAG_H | FLAG_N)) | c;	\
+			PC += 2;	\
+			return 18;	\
+		}	\
+		if(zA == data)	\
+		{	\
+			Sub_Flags(data, 0);	\
+			zF = (zF & (FLAG_S | FLAG_Z | FLAG_H | FLAG_N)) | c | FLAG_P;	\
+			PC += 2;	\
+			return 18;	\
+		}	\
+		Cycles -= 21;	\
+		if(Cycles < 0)	\
+		{	\
+			Sub_Flags(data, 0);	\
+			zF = (zF & (FLAG_S | FLAG_Z | FLAG_H | FLAG_N)) | c | FLAG_P;	\
+			Quit_Halted = data;	\
+			return Z80C_QUIT;	\
+		}	\
+	}	\
+}
+
+
+// Arithmetic / logic 8 bits instruction
+
+#define ARITH_A_R(op, s)	\
+static int Z80I_##op##_##s(void)	\
+{	\
+	PC++;	\
+	OP_##op(z##s);	\
+	return 4;	\
+}
+
+// the asm never loads dl for CP A/H/L, FXY gets the opcode byte
+#define ARITH_CP_OPCODE(s)	\
+static int Z80I_CP_##s(void)	\
+{	\
+	UINT8 op = PC[0];	\
+	PC++;	\
+	OP_CP(z##s);	\
+	zFXY = op;	\
+	return 4;	\
+}
+
+#define ARITH_A_N(op)	\
+static int Z80I_##op##_N(void)	\
+{	\
+	UINT8 data = PC[1];	\
+	PC += 2;	\
+	OP_##op(data);	\
+	return 7;	\
+}
+
+#define ARITH_A_mHL(op)	\
+static int Z80I_##op##_mHL(void)	\
+{	\
+	PC++;	\
+	OP_##op(READ_BYTE(zHL));	\
+	return 7;	\
+}
+
+#define ARITH_A_mXYd(op, xy)	\
+static int Z80I_##op##_m##xy##d(void)	\
+{	\
+	UINT32 adr = XY_ADR(xy);	\
+	PC += 2;	\
+	OP_##op(READ_BYTE(adr));	\
+	return 15;	\
+}
+
+#define INCDEC_R(op, r)	\
+static int Z80I_##op##_##r(void)	\
+{	\
+	PC++;	\
+	z##r = OP_##op(z##r);	\
+	return 4;	\
+}
+
+#define INCDEC_mHL(op)	\
+static int Z80I_##op##_mHL(void)	\
+{	\
+	UINT8 data;	\
+	PC++;	\
+	data = OP_##op(READ_BYTE(zHL));	\
+	WRITE_BYTE(zHL, data);	\
+	return 11;	\
+}
+
+#define INCDEC_mXYd(op, xy)	\
+static int Z80I_##op##_m##xy##d(void)	\
+{	\
+	UINT32 adr = XY_ADR(xy);	\
+	UINT8 data;	\
+	PC += 2;	\
+	data = OP_##op(READ_BYTE(adr));	\
+	WRITE_BYTE(adr, data);	\
+	return 22;	\
+}
+
+
+// Misc instruction
+
+static int Z80I_DAA(void)
+{
+	UINT16 r = DAA_Table[zA | (zF & (FLAG_C | FLAG_N)) << 8 | (zF & FLAG_H) << 6];
+
+	zA = (UINT8)r;
+	zF = (UINT8)(r >> 8);
+	PC++;
+	zFXY = zF;
+	return 4;
+}
+
+static int Z80I_CPL(void)
+{
+	PC++;
+	zA = ~zA;
+	zF |= FLAG_H | FLAG_N;
+	zFXY = zA;
+	return 4;
+}
+
+static int Z80I_NEG(void)
+{
+	UINT8 v = zA;
+
+	PC += 2;
+	zA = 0;
+	zA = Sub_Flags(v, 0);
+	zFXY = zA;
+	return 8;
+}
+
+static int Z80I_CCF(void)
+{
+	UINT8 c = zF & FLAG_C;
+
+	zF = ((zF ^ FLAG_C) & (FLAG_S | FLAG_Z | FLAG_P | FLAG_C)) | c << 4;
+	PC++;
+	return 4;
+}
+
+static int Z80I_SCF(void)
+{
+	zF = (zF & (FLAG_S | FLAG_Z | FLAG_P)) | FLAG_C;
+	PC++;
+	zFXY = zA;
+	return 4;
+}
+
+static int Z80I_HALT(void)
+{
+	Z->Status |= Z80_HALTED;
+	Cycles = -1;
+	PC++;
+	Quit_Halted = Z->Status;
+	return Z80C_QUIT;
+}
+
+static int Z80I_DI(void)
+{
+	Z->IFF.d = 0;
+	PC++;
+	Cycles -= 4;
+	Chain_Table = NULL;
+	Chain_Ofs = 0;
+	return Z80C_CHAIN;
+}
+
+// the interrupts are checked once the next instruction is done: its cycles are taken
+// from -4 and the ones left are put back from CycleSup by z80_Exec_Quit
+static int Z80I_EI(void)
+{
+	Z->CycleSup = Cycles;
+	PC++;
+	Z->IFF.d = FLAG_P | FLAG_P << 8;
+	Cycles = -4;
+	Chain_Table = NULL;
+	Chain_Ofs = 0;
+	return Z80C_CHAIN;
+}
+
+static int Z80I_IM0(void)
+{
+	PC += 2;
+	Z->IM = 0;
+	return 8;
+}
+
+static int Z80I_IM1(void)
+{
+	PC += 2;
+	Z->IM = 1;
+	return 8;
+}
+
+static int Z80I_IM2(void)
+{
+	PC += 2;
+	Z->IM = 2;
+	return 8;
+}
+
+
+// Arithmetic 16 bits instruction
+
+#define ADD_RR_RR(d, s)	\
+static int Z80I_ADD_##d##_##s(void)	\
+{	\
+	UINT32 a = z##d, b = z##s, r = a + b;	\
+	PC++;	\
+	zF = (zF & (FLAG_S | FLAG_Z | FLAG_P)) | (((a ^ b ^ r) >> 8) & FLAG_H) | (r >> 16);	\
+	z##d = (UINT16)r;	\
+	zFXY = (UINT8)(r >> 8);	\
+	return 11;	\
+}
+
+#define ADC_HL_RR(s)	\
+static int Z80I_ADC_HL_##s(void)	\
+{	\
+	UINT32 a = zHL, b = z##s, r = a + b + (zF & FLAG_C);	\
+	PC += 2;	\
+	zF = ((r >> 8) & FLAG_S) | (((a ^ b ^ r) >> 8) & FLAG_H) | ((r >> 16) & FLAG_C)	\
+		| ((~(a ^ b) & (a ^ r) & 0x8000) ? FLAG_P : 0) | ((r & 0xFFFF) ? 0 : FLAG_Z);	\
+	zHL = (UINT16)r;	\
+	zFXY = (UINT8)(r >> 8);	\
+	return 15;	\
+}
+
+#define SBC_HL_RR(s)	\
+static int Z80I_SBC_HL_##s(void)	\
+{	\
+	UINT32 a = zHL, b = z##s, r = a - b - (zF & FLAG_C);	\
+	PC += 2;	\
+	zF = ((r >> 8) & FLAG_S) | (((a ^ b ^ r) >> 8) & FLAG_H) | ((r >> 16) & FLAG_C)	\
+		| (((a ^ b) & (a ^ r) & 0x8000) ? FLAG_P : 0) | ((r & 0xFFFF) ? 0 : FLAG_Z) | FLAG_N;	\
+	zHL = (UINT16)r;	\
+	zFXY = (UINT8)(r >> 8);	\
+	return 15;	\
+}
+
+#define INCDEC_RR(op, r)	\
+static int Z80I_##op##_##r(void)	\
+{	\
+	z##r += DIR_##op;	\
+	PC++;	\
+	return 6;	\
+}
+
+#define DIR_INC	1
+#define DIR_DEC	-1
+
+
+// Rotate and shift instruction
+
+static int Z80I_RLCA(void)
+{
+	UINT8 c = zA >> 7;
+
+	zA = (UINT8)(zA << 1 | c);
+	zF = (zF & (FLAG_S | FLAG_Z | FLAG_P)) | c;
+	PC++;
+	zFXY = zA;
+	return 4;
+}
+
+static int Z80I_RLA(void)
+{
+	UINT8 c = zA >> 7;
+
+	PC++;
+	zA = (UINT8)(zA << 1 | (zF & FLAG_C));
+	zF = (zF & (FLAG_S | FLAG_Z | FLAG_P)) | c;
+	zFXY = zA;
+	return 4;
+}
+
+static int Z80I_RRCA(void)
+{
+	UINT8 c = zA & 1;
+
+	zA = (UINT8)(zA >> 1 | c << 7);
+	zF = (zF & (FLAG_S | FLAG_Z | FLAG_P)) | c;
+	PC++;
+	zFXY = zA;
+	return 4;
+}
+
+static int Z80I_RRA(void)
+{
+	UINT8 c = zA & 1;
+
+	PC++;
+	zA = (UINT8)(zA >> 1 | (zF & FLAG_C) << 7);
+	zF = (zF & (FLAG_S | FLAG_Z | FLAG_P)) | c;
+	zFXY = zA;
+	return 4;
+}
+
+#define ROT_R(op, r)	\
+static int Z80I_##op##_##r(void)	\
+{	\
+	PC += 2;	\
+	z##r = OP_##op(z##r);	\
+	return 8;	\
+}
+
+// SLL B/C/D/E: the asm stores the register before setting bit 0
+#define ROT_R_SLL_REG(r)	\
+static int Z80I_SLL_##r(void)	\
+{	\
+	PC += 2;	\
+	z##r = OP_SLL(z##r) & 0xFE;	\
+	return 8;	\
+}
+
+#define ROT_mHL(op)	\
+static int Z80I_##op##_mHL(void)	\
+{	\
+	UINT8 data;	\
+	PC += 2;	\
+	data = OP_##op(READ_BYTE(zHL));	\
+	WRITE_BYTE(zHL, data);	\
+	return 15;	\
+}
+
+#define ROT_mXYd(op, xy)	\
+static int Z80I_##op##_m##xy##d(void)	\
+{	\
+	UINT32 adr = XY_ADR(xy);	\
+	UINT8 data;	\
+	PC += 3;	\
+	data = OP_##op(READ_BYTE(adr));	\
+	WRITE_BYTE(adr, data);	\
+	return 23;	\
+}
+
+#define ROT_mXYd_R(op, xy, r)	\
+static int Z80I_##op##_m##xy##d_##r(void)	\
+{	\
+	UINT32 adr = XY_ADR(xy);	\
+	UINT8 data;	\
+	PC += 3;	\
+	data = OP_##op(READ_BYTE(adr));	\
+	z##r = data;	\
+	WRITE_BYTE(adr, data);	\
+	return 23;	\
+}
+
+// the low nibble of A isn't kept in (HL), the high one is
+static int Z80I_RLD(void)
+{
+	UINT8 data;
+
+	PC += 2;
+	data = READ_BYTE(zHL);
+	WRITE_BYTE(zHL, (UINT8)(data << 4 | (zA & 0xF0)));
+	zA = (zA & 0xF0) | data >> 4;
+	zF = SZP_Table[zA] | (zF & FLAG_C);
+	zFXY = zA;
+	return 18;
+}
+
+static int Z80I_RRD(void)
+{
+	UINT8 data;
+
+	PC += 2;
+	data = READ_BYTE(zHL);
+	WRITE_BYTE(zHL, (UINT8)(data >> 4 | zA << 4));
+	zA = (zA & 0xF0) | (data & 0x0F);
+	zF = SZP_Table[zA] | (zF & FLAG_C);
+	zFXY = zA;
+	return 18;
+}
+
+
+// Bits operation instruction
+
+#define BITb_R(b, r)	\
+static int Z80I_BIT##b##_##r(void)	\
+{	\
+	OP_BIT(b, z##r, z##r);	\
+	PC += 2;	\
+	return 8;	\
+}
+
+#define BITb_mHL(b)	\
+static int Z80I_BIT##b##_mHL(void)	\
+{	\
+	UINT32 adr = zHL;	\
+	OP_BIT(b, READ_BYTE(adr), READ_ADR_HIGH(adr));	\
+	PC += 2;	\
+	return 12;	\
+}
+
+#define BITb_mXYd(b, xy)	\
+static int Z80I_BIT##b##_m##xy##d(void)	\
+{	\
+	UINT32 adr = XY_ADR(xy);	\
+	OP_BIT(b, READ_BYTE(adr), READ_ADR_HIGH(adr));	\
+	PC += 3;	\
+	return 16;	\
+}
+
+#define SETRESb_R(op, b, r)	\
+static int Z80I_##op##b##_##r(void)	\
+{	\
+	z##r = OP_##op(b, z##r);	\
+	PC += 2;	\
+	return 8;	\
+}
+
+#define SETRESb_mHL(op, b)	\
+static int Z80I_##op##b##_mHL(void)	\
+{	\
+	UINT8 data;	\
+	PC += 2;	\
+	data = READ_BYTE(zHL);	\
+	WRITE_BYTE(zHL, OP_##op(b, data));	\
+	return 15;	\
+}
+
+#define SETRESb_mXYd(op, b, xy)	\
+static int Z80I_##op##b##_m##xy##d(void)	\
+{	\
+	UINT32 adr = XY_ADR(xy);	\
+	UINT8 data;	\
+	PC += 3;	\
+	data = READ_BYTE(adr);	\
+	WRITE_BYTE(adr, OP_##op(b, data));	\
+	return 19;	\
+}
+
+#define SETRESb_mXYd_R(op, b, xy, r)	\
+static int Z80I_##op##b##_m##xy##d_##r(void)	\
+{	\
+	UINT32 adr = XY_ADR(xy);	\
+	UINT8 data;	\
+	PC += 3;	\
+	data = READ_BYTE(adr);	\
+	data = OP_##op(b, data);	\
+	z##r = data;	\
+	WRITE_BYTE(adr, data);	\
+	return 19;	\
+}
+
+
+// Jump instruction
+
+static int Z80I_JP_NN(void)
+{
+	Rebase_PC(FETCH_WORD(1));
+	return 10;
+}
+
+#define JPcc_NN(cc, cond)	\
+static int Z80I_JP##cc##_NN(void)	\
+{	\
+	if(cond)	\
+		Rebase_PC(FETCH_WORD(1));	\
+	else	\
+		PC += 3;	\
+	return 10;	\
+}
+
+// JR doesn't rebase, the PC just moves in the same fetch region
+static int Z80I_JR_N(void)
+{
+	INT8 d = (INT8)PC[1];
+
+	PC += 2 + d;
+	return 12;
+}
+
+#define JRcc_N(cc, cond)	\
+static int Z80I_JR##cc##_N(void)	\
+{	\
+	if(cond)	\
+	{	\
+		PC += 2 + (INT8)PC[1];	\
+		return 12;	\
+	}	\
+	PC += 2;	\
+	return 7;	\
+}
+
+#define JP_RR(r)	\
+static int Z80I_JP_##r(void)	\
+{	\
+	Rebase_PC(z##r);	\
+	return 4;	\
+}
+
+static int Z80I_DJNZ(void)
+{
+	INT8 d = (INT8)PC[1];
+
+	if(--zB)
+	{
+		PC += 2 + d;
+		return 13;
+	}
+	PC += 2;
+	return 10;
+}
+
+
+// Call/Return instruction
+
+static int Z80I_CALL_NN(void)
+{
+	Push((UINT16)(Logical_PC() + 3));
+	Rebase_PC(FETCH_WORD(1));
+	return 17;
+}
+
+#define CALLcc_NN(cc, cond)	\
+static int Z80I_CALL##cc##_NN(void)	\
+{	\
+	if(!(cond))	\
+	{	\
+		PC += 3;	\
+		return 10;	\
+	}	\
+	Push((UINT16)(Logical_PC() + 3));	\
+	Rebase_PC(FETCH_WORD(1));	\
+	return 17;	\
+}
+
+static int Z80I_RET(void)
+{
+	Rebase_PC(Pop());
+	return 10;
+}
+
+#define RETcc(cc, cond)	\
+static int Z80I_RET##cc(void)	\
+{	\
+	if(!(cond))	\
+	{	\
+		PC++;	\
+		return 5;	\
+	}	\
+	Rebase_PC(Pop());	\
+	return 17;	\
+}
+
+// IFF1 = IFF2, nothing to do since the asm keeps both in IFF2
+static int Z80I_RETN(void)
+{
+	Rebase_PC(Pop());
+	return 14;
+}
+
+#define Z80I_RETI Z80I_RETN
+
+static int Z80I_RST(void)
+{
+	UINT32 adr = PC[0] & 0x38;
+
+	Push((UINT16)(Logical_PC() + 1));
+	Rebase_PC(adr);
+	return 11;
+}
+
+
+// Input/Output instruction
+// GENS_OPT: there are no ports, IN gives 0 (IN A,(n) leaves A as it is) and OUT does nothing
+
+static int Z80I_IN_mN(void)
+{
+	PC += 2;
+	return 11;
+}
+
+#define IN_R_mBC(r)	\
+static int Z80I_IN_##r##_mBC(void)	\
+{	\
+	PC += 2;	\
+	zF = (zF & FLAG_C) | FLAG_Z | FLAG_P;	\
+	z##r = 0;	\
+	zFXY = 0;	\
+	return 12;	\
+}
+
+static int Z80I_IN_F_mBC(void)
+{
+	PC += 2;
+	zF = (zF & FLAG_C) | FLAG_Z | FLAG_P;
+	zFXY = 0;
+	return 12;
+}
+
+// flags of INI / OUTI: S, Z, P of B - 1, H and C from the carry of C + 1 / L + data, N from bit 7 of data
+#define INX(d)	\
+static int Z80I_IN##d(void)	\
+{	\
+	PC += 2;	\
+	WRITE_BYTE(zHL, 0);	\
+	zHL += DIR_##d;	\
+	zB--;	\
+	zF = SZP_Table[zB];	\
+	return 16;	\
+}
+
+#define INXR(d)	\
+static int Z80I_IN##d##R(void)	\
+{	\
+	for(;;)	\
+	{	\
+		WRITE_BYTE(zHL, 0);	\
+		zHL += DIR_##d;	\
+		if(!--zB)	\
+			break;	\
+		Cycles -= 21;	\
+		if(Cycles < 0)	\
+		{	\
+			zF = zB & FLAG_S;	\
+			zFXY = zB;	\
+			Quit_Halted = zB;	\
+			return Z80C_QUIT;	\
+		}	\
+	}	\
+	zF = FLAG_Z | FLAG_P;	\
+	zFXY = 0;	\
+	PC += 2;	\
+	return 16;	\
+}
+
+static int Z80I_OUT_mN(void)
+{
+	PC += 2;
+	return 11;
+}
+
+#define OUT_mBC_R(r)	\
+static int Z80I_OUT_mBC_##r(void)	\
+{	\
+	PC += 2;	\
+	return 12;	\
+}
+
+static int Z80I_OUT_mBC_0(void)
+{
+	PC += 2;
+	return 12;
+}
+
+static inline UINT8 Out_Flags(UINT8 data)
+{
+	return (zL + data > 0xFF ? FLAG_H | FLAG_C : 0) | (data >> 7) << 1;
+}
+
+#define OUTX(d)	\
+static int Z80I_OUT##d(void)	\
+{	\
+	UINT8 data;	\
+	PC += 2;	\
+	data = READ_BYTE(zHL);	\
+	zHL += DIR_##d;	\
+	zB--;	\
+	zF = (SZP_Table[zB] & (FLAG_S | FLAG_Z | FLAG_P)) | Out_Flags(data);	\
+	return 16;	\
+}
+
+#define OUTXR(d)	\
+static int Z80I_OT##d##R(void)	\
+{	\
+	UINT8 data;	\
+	for(;;)	\
+	{	\
+		data = READ_BYTE(zHL);	\
+		zHL += DIR_##d;	\
+		if(!--zB)	\
+			break;	\
+		Cycles -= 21;	\
+		if(Cycles < 0)	\
+		{	\
+			zF = (zB & FLAG_S) | Out_Flags(data);	\
+			zFXY = zB;	\
+			Quit_Halted = zB;	\
+			return Z80C_QUIT;	\
+		}	\
+	}	\
+	zF = FLAG_Z | FLAG_P | Out_Flags(data);	\
+	zFXY = 0;	\
+	PC += 2;	\
+	return 16;	\
+}
+
+
+LD_R_R(A, A)
+LD_R_R(A, B)
+LD_R_R(A, C)
+LD_R_R(A, D)
+LD_R_R(A, E)
+LD_R_R(A, H)
+LD_R_R(A, L)
+LD_R_R(A, hIX)
+LD_R_R(A, lIX)
+LD_R_R(A, hIY)
+LD_R_R(A, lIY)
+LD_R_R(B, A)
+LD_R_R(B, B)
+LD_R_R(B, C)
+LD_R_R(B, D)
+LD_R_R(B, E)
+LD_R_R(B, H)
+LD_R_R(B, L)
+LD_R_R(B, hIX)
+LD_R_R(B, lIX)
+LD_R_R(B, hIY)
+LD_R_R(B, lIY)
+LD_R_R(C, A)
+LD_R_R(C, B)
+LD_R_R(C, C)
+LD_R_R(C, D)
+LD_R_R(C, E)
+LD_R_R(C, H)
+LD_R_R(C, L)
+LD_R_R(C, hIX)
+LD_R_R(C, lIX)
+LD_R_R(C, hIY)
+LD_R_R(C, lIY)
+LD_R_R(D, A)
+LD_R_R(D, B)
+LD_R_R(D, C)
+LD_R_R(D, D)
+LD_R_R(D, E)
+LD_R_R(D, H)
+LD_R_R(D, L)
+LD_R_R(D, hIX)
+LD_R_R(D, lIX)
+LD_R_R(D, hIY)
+LD_R_R(D, lIY)
+LD_R_R(E, A)
+LD_R_R(E, B)
+LD_R_R(E, C)
+LD_R_R(E, D)
+LD_R_R(E, E)
+LD_R_R(E, H)
+LD_R_R(E, L)
+LD_R_R(E, hIX)
+LD_R_R(E, lIX)
+LD_R_R(E, hIY)
+LD_R_R(E, lIY)
+LD_R_R(H, A)
+LD_R_R(H, B)
+LD_R_R(H, C)
+LD_R_R(H, D)
+LD_R_R(H, E)
+LD_R_R(H, H)
+LD_R_R(H, L)
+LD_R_R(L, A)
+LD_R_R(L, B)
+LD_R_R(L, C)
+LD_R_R(L, D)
+LD_R_R(L, E)
+LD_R_R(L, H)
+LD_R_R(L, L)
+LD_R_R(hIX, A)
+LD_R_R(hIX, B)
+LD_R_R(hIX, C)
+LD_R_R(hIX, D)
+LD_R_R(hIX, E)
+LD_R_R(hIX, L)
+LD_R_R(hIX, hIX)
+LD_R_R(lIX, A)
+LD_R_R(lIX, B)
+LD_R_R(lIX, C)
+LD_R_R(lIX, D)
+LD_R_R(lIX, E)
+LD_R_R(lIX, H)
+LD_R_R(lIX, lIX)
+LD_R_R(hIY, A)
+LD_R_R(hIY, B)
+LD_R_R(hIY, C)
+LD_R_R(hIY, D)
+LD_R_R(hIY, E)
+LD_R_R(hIY, L)
+LD_R_R(hIY, hIY)
+LD_R_R(lIY, A)
+LD_R_R(lIY, B)
+LD_R_R(lIY, C)
+LD_R_R(lIY, D)
+LD_R_R(lIY, E)
+LD_R_R(lIY, H)
+LD_R_R(lIY, lIY)
+
+LD_R_N(A)
+LD_R_N(B)
+LD_R_N(C)
+LD_R_N(D)
+LD_R_N(E)
+LD_R_N(H)
+LD_R_N(L)
+LD_R_N(hIX)
+LD_R_N(lIX)
+LD_R_N(hIY)
+LD_R_N(lIY)
+
+LD_R_mHL(A)
+LD_R_mHL(B)
+LD_R_mHL(C)
+LD_R_mHL(D)
+LD_R_mHL(E)
+LD_R_mHL(H)
+LD_R_mHL(L)
+
+LD_R_mXYd(A, IX)
+LD_R_mXYd(B, IX)
+LD_R_mXYd(C, IX)
+LD_R_mXYd(D, IX)
+LD_R_mXYd(E, IX)
+LD_R_mXYd(H, IX)
+LD_R_mXYd(L, IX)
+LD_R_mXYd(A, IY)
+LD_R_mXYd(B, IY)
+LD_R_mXYd(C, IY)
+LD_R_mXYd(D, IY)
+LD_R_mXYd(E, IY)
+LD_R_mXYd(H, IY)
+LD_R_mXYd(L, IY)
+
+LD_mHL_R(A)
+LD_mHL_R(B)
+LD_mHL_R(C)
+LD_mHL_R(D)
+LD_mHL_R(E)
+LD_mHL_R(H)
+LD_mHL_R(L)
+
+LD_mXYd_R(A, IX)
+LD_mXYd_R(B, IX)
+LD_mXYd_R(C, IX)
+LD_mXYd_R(D, IX)
+LD_mXYd_R(E, IX)
+LD_mXYd_R(H, IX)
+LD_mXYd_R(L, IX)
+LD_mXYd_R(A, IY)
+LD_mXYd_R(B, IY)
+LD_mXYd_R(C, IY)
+LD_mXYd_R(D, IY)
+LD_mXYd_R(E, IY)
+LD_mXYd_R(H, IY)
+LD_mXYd_R(L, IY)
+
+LD_mXYd_N(IX)
+LD_mXYd_N(IY)
+
+LD_RR_NN(BC)
+LD_RR_NN(DE)
+LD_RR_NN(HL)
+LD_RR_NN(SP)
+LD_RR_NN(IX)
+LD_RR_NN(IY)
+
+LD_RR_mNN(BC)
+LD_RR_mNN(DE)
+LD_RR_mNN(SP)
+
+LD_XY_mNN(IX)
+LD_XY_mNN(IY)
+
+LD_mNN_RR(BC)
+LD_mNN_RR(DE)
+LD_mNN_RR(SP)
+
+LD_mNN_XY(IX)
+LD_mNN_XY(IY)
+
+LD_SP_RR(HL)
+LD_SP_RR(IX)
+LD_SP_RR(IY)
+
+PUSH_RR(BC)
+PUSH_RR(DE)
+PUSH_RR(HL)
+PUSH_RR(IX)
+PUSH_RR(IY)
+
+POP_RR(BC)
+POP_RR(DE)
+POP_RR(HL)
+POP_RR(IX)
+POP_RR(IY)
+
+EX_mSP_DD(HL)
+EX_mSP_DD(IX)
+EX_mSP_DD(IY)
+
+LDX(I)
+LDX(D)
+
+LDXR(I)
+LDXR(D)
+
+CPX(I)
+CPX(D)
+
+CPXR(I)
+CPXR(D)
+
+ARITH_A_R(ADD, A)
+ARITH_A_R(ADD, B)
+ARITH_A_R(ADD, C)
+ARITH_A_R(ADD, D)
+ARITH_A_R(ADD, E)
+ARITH_A_R(ADD, H)
+ARITH_A_R(ADD, L)
+ARITH_A_R(ADD, lIX)
+ARITH_A_R(ADD, hIX)
+ARITH_A_R(ADD, lIY)
+ARITH_A_R(ADD, hIY)
+ARITH_A_R(ADC, A)
+ARITH_A_R(ADC, B)
+ARITH_A_R(ADC, C)
+ARITH_A_R(ADC, D)
+ARITH_A_R(ADC, E)
+ARITH_A_R(ADC, H)
+ARITH_A_R(ADC, L)
+ARITH_A_R(ADC, lIX)
+ARITH_A_R(ADC, hIX)
+ARITH_A_R(ADC, lIY)
+ARITH_A_R(ADC, hIY)
+ARITH_A_R(SUB, A)
+ARITH_A_R(SUB, B)
+ARITH_A_R(SUB, C)
+ARITH_A_R(SUB, D)
+ARITH_A_R(SUB, E)
+ARITH_A_R(SUB, H)
+ARITH_A_R(SUB, L)
+ARITH_A_R(SUB, lIX)
+ARITH_A_R(SUB, hIX)
+ARITH_A_R(SUB, lIY)
+ARITH_A_R(SUB, hIY)
+ARITH_A_R(SBC, A)
+ARITH_A_R(SBC, B)
+ARITH_A_R(SBC, C)
+ARITH_A_R(SBC, D)
+ARITH_A_R(SBC, E)
+ARITH_A_R(SBC, H)
+ARITH_A_R(SBC, L)
+ARITH_A_R(SBC, lIX)
+ARITH_A_R(SBC, hIX)
+ARITH_A_R(SBC, lIY)
+ARITH_A_R(SBC, hIY)
+
+ARITH_CP_OPCODE(A)
+
+ARITH_A_R(CP, B)
+ARITH_A_R(CP, C)
+ARITH_A_R(CP, D)
+ARITH_A_R(CP, E)
+
+ARITH_CP_OPCODE(H)
+ARITH_CP_OPCODE(L)
+
+ARITH_A_R(CP, lIX)
+ARITH_A_R(CP, hIX)
+ARITH_A_R(CP, lIY)
+ARITH_A_R(CP, hIY)
+
+ARITH_A_N(ADD)
+ARITH_A_N(ADC)
+ARITH_A_N(SUB)
+ARITH_A_N(SBC)
+ARITH_A_N(CP)
+
+ARITH_A_mHL(ADD)
+ARITH_A_mHL(ADC)
+ARITH_A_mHL(SUB)
+ARITH_A_mHL(SBC)
+ARITH_A_mHL(CP)
+
+ARITH_A_mXYd(ADD, IX)
+ARITH_A_mXYd(ADC, IX)
+ARITH_A_mXYd(SUB, IX)
+ARITH_A_mXYd(SBC, IX)
+ARITH_A_mXYd(CP, IX)
+ARITH_A_mXYd(ADD, IY)
+ARITH_A_mXYd(ADC, IY)
+ARITH_A_mXYd(SUB, IY)
+ARITH_A_mXYd(SBC, IY)
+ARITH_A_mXYd(CP, IY)
+
+ARITH_A_R(AND, A)
+ARITH_A_R(AND, B)
+ARITH_A_R(AND, C)
+ARITH_A_R(AND, D)
+ARITH_A_R(AND, E)
+ARITH_A_R(AND, H)
+ARITH_A_R(AND, L)
+ARITH_A_R(AND, lIX)
+ARITH_A_R(AND, hIX)
+ARITH_A_R(AND, lIY)
+ARITH_A_R(AND, hIY)
+ARITH_A_R(OR, A)
+ARITH_A_R(OR, B)
+ARITH_A_R(OR, C)
+ARITH_A_R(OR, D)
+ARITH_A_R(OR, E)
+ARITH_A_R(OR, H)
+ARITH_A_R(OR, L)
+ARITH_A_R(OR, lIX)
+ARITH_A_R(OR, hIX)
+ARITH_A_R(OR, lIY)
+ARITH_A_R(OR, hIY)
+ARITH_A_R(XOR, A)
+ARITH_A_R(XOR, B)
+ARITH_A_R(XOR, C)
+ARITH_A_R(XOR, D)
+ARITH_A_R(XOR, E)
+ARITH_A_R(XOR, H)
+ARITH_A_R(XOR, L)
+ARITH_A_R(XOR, lIX)
+ARITH_A_R(XOR, hIX)
+ARITH_A_R(XOR, lIY)
+ARITH_A_R(XOR, hIY)
+
+ARITH_A_N(AND)
+ARITH_A_N(OR)
+ARITH_A_N(XOR)
+
+ARITH_A_mHL(AND)
+ARITH_A_mHL(OR)
+ARITH_A_mHL(XOR)
+
+ARITH_A_mXYd(AND, IX)
+ARITH_A_mXYd(AND, IY)
+ARITH_A_mXYd(OR, IX)
+ARITH_A_mXYd(OR, IY)
+ARITH_A_mXYd(XOR, IX)
+ARITH_A_mXYd(XOR, IY)
+
+INCDEC_R(INC, A)
+INCDEC_R(INC, B)
+INCDEC_R(INC, C)
+INCDEC_R(INC, D)
+INCDEC_R(INC, E)
+INCDEC_R(INC, H)
+INCDEC_R(INC, L)
+INCDEC_R(INC, lIX)
+INCDEC_R(INC, hIX)
+INCDEC_R(INC, lIY)
+INCDEC_R(INC, hIY)
+INCDEC_R(DEC, A)
+INCDEC_R(DEC, B)
+INCDEC_R(DEC, C)
+INCDEC_R(DEC, D)
+INCDEC_R(DEC, E)
+INCDEC_R(DEC, H)
+INCDEC_R(DEC, L)
+INCDEC_R(DEC, lIX)
+INCDEC_R(DEC, hIX)
+INCDEC_R(DEC, lIY)
+INCDEC_R(DEC, hIY)
+
+INCDEC_mHL(INC)
+INCDEC_mHL(DEC)
+
+INCDEC_mXYd(INC, IX)
+INCDEC_mXYd(INC, IY)
+INCDEC_mXYd(DEC, IX)
+INCDEC_mXYd(DEC, IY)
+
+ADD_RR_RR(HL, BC)
+ADD_RR_RR(HL, DE)
+ADD_RR_RR(HL, HL)
+ADD_RR_RR(HL, SP)
+ADD_RR_RR(IX, BC)
+ADD_RR_RR(IX, DE)
+ADD_RR_RR(IX, IX)
+ADD_RR_RR(IX, SP)
+ADD_RR_RR(IY, BC)
+ADD_RR_RR(IY, DE)
+ADD_RR_RR(IY, IY)
+ADD_RR_RR(IY, SP)
+
+ADC_HL_RR(BC)
+ADC_HL_RR(DE)
+ADC_HL_RR(HL)
+ADC_HL_RR(SP)
+
+SBC_HL_RR(BC)
+SBC_HL_RR(DE)
+SBC_HL_RR(HL)
+SBC_HL_RR(SP)
+
+INCDEC_RR(INC, BC)
+INCDEC_RR(INC, DE)
+INCDEC_RR(INC, HL)
+INCDEC_RR(INC, IX)
+INCDEC_RR(INC, IY)
+INCDEC_RR(INC, SP)
+INCDEC_RR(DEC, BC)
+INCDEC_RR(DEC, DE)
+INCDEC_RR(DEC, HL)
+INCDEC_RR(DEC, IX)
+INCDEC_RR(DEC, IY)
+INCDEC_RR(DEC, SP)
+
+ROT_R(RLC, A)
+ROT_R(RLC, B)
+ROT_R(RLC, C)
+ROT_R(RLC, D)
+ROT_R(RLC, E)
+ROT_R(RLC, H)
+ROT_R(RLC, L)
+ROT_R(RL, A)
+ROT_R(RL, B)
+ROT_R(RL, C)
+ROT_R(RL, D)
+ROT_R(RL, E)
+ROT_R(RL, H)
+ROT_R(RL, L)
+ROT_R(RRC, A)
+ROT_R(RRC, B)
+ROT_R(RRC, C)
+ROT_R(RRC, D)
+ROT_R(RRC, E)
+ROT_R(RRC, H)
+ROT_R(RRC, L)
+ROT_R(RR, A)
+ROT_R(RR, B)
+ROT_R(RR, C)
+ROT_R(RR, D)
+ROT_R(RR, E)
+ROT_R(RR, H)
+ROT_R(RR, L)
+ROT_R(SLA, A)
+ROT_R(SLA, B)
+ROT_R(SLA, C)
+ROT_R(SLA, D)
+ROT_R(SLA, E)
+ROT_R(SLA, H)
+ROT_R(SLA, L)
+ROT_R(SLL, A)
+
+ROT_R_SLL_REG(B)
+ROT_R_SLL_REG(C)
+ROT_R_SLL_REG(D)
+ROT_R_SLL_REG(E)
+
+ROT_R(SLL, H)
+ROT_R(SLL, L)
+ROT_R(SRA, A)
+ROT_R(SRA, B)
+ROT_R(SRA, C)
+ROT_R(SRA, D)
+ROT_R(SRA, E)
+ROT_R(SRA, H)
+ROT_R(SRA, L)
+ROT_R(SRL, A)
+ROT_R(SRL, B)
+ROT_R(SRL, C)
+ROT_R(SRL, D)
+ROT_R(SRL, E)
+ROT_R(SRL, H)
+ROT_R(SRL, L)
+
+ROT_mHL(RLC)
+ROT_mHL(RL)
+ROT_mHL(RRC)
+ROT_mHL(RR)
+ROT_mHL(SLA)
+ROT_mHL(SLL)
+ROT_mHL(SRA)
+ROT_mHL(SRL)
+
+ROT_mXYd(RLC, IX)
+
+ROT_mXYd_R(RLC, IX, A)
+ROT_mXYd_R(RLC, IX, B)
+ROT_mXYd_R(RLC, IX, C)
+ROT_mXYd_R(RLC, IX, D)
+ROT_mXYd_R(RLC, IX, E)
+ROT_mXYd_R(RLC, IX, H)
+ROT_mXYd_R(RLC, IX, L)
+
+ROT_mXYd(RLC, IY)
+
+ROT_mXYd_R(RLC, IY, A)
+ROT_mXYd_R(RLC, IY, B)
+ROT_mXYd_R(RLC, IY, C)
+ROT_mXYd_R(RLC, IY, D)
+ROT_mXYd_R(RLC, IY, E)
+ROT_mXYd_R(RLC, IY, H)
+ROT_mXYd_R(RLC, IY, L)
+
+ROT_mXYd(RL, IX)
+
+ROT_mXYd_R(RL, IX, A)
+ROT_mXYd_R(RL, IX, B)
+ROT_mXYd_R(RL, IX, C)
+ROT_mXYd_R(RL, IX, D)
+ROT_mXYd_R(RL, IX, E)
+ROT_mXYd_R(RL, IX, H)
+ROT_mXYd_R(RL, IX, L)
+
+ROT_mXYd(RL, IY)
+
+ROT_mXYd_R(RL, IY, A)
+ROT_mXYd_R(RL, IY, B)
+ROT_mXYd_R(RL, IY, C)
+ROT_mXYd_R(RL, IY, D)
+ROT_mXYd_R(RL, IY, E)
+ROT_mXYd_R(RL, IY, H)
+ROT_mXYd_R(RL, IY, L)
+
+ROT_mXYd(RRC, IX)
+
+ROT_mXYd_R(RRC, IX, A)
+ROT_mXYd_R(RRC, IX, B)
+ROT_mXYd_R(RRC, IX, C)
+ROT_mXYd_R(RRC, IX, D)
+ROT_mXYd_R(RRC, IX, E)
+ROT_mXYd_R(RRC, IX, H)
+ROT_mXYd_R(RRC, IX, L)
+
+ROT_mXYd(RRC, IY)
+
+ROT_mXYd_R(RRC, IY, A)
+ROT_mXYd_R(RRC, IY, B)
+ROT_mXYd_R(RRC, IY, C)
+ROT_mXYd_R(RRC, IY, D)
+ROT_mXYd_R(RRC, IY, E)
+ROT_mXYd_R(RRC, IY, H)
+ROT_mXYd_R(RRC, IY, L)
+
+ROT_mXYd(RR, IX)
+
+ROT_mXYd_R(RR, IX, A)
+ROT_mXYd_R(RR, IX, B)
+ROT_mXYd_R(RR, IX, C)
+ROT_mXYd_R(RR, IX, D)
+ROT_mXYd_R(RR, IX, E)
+ROT_mXYd_R(RR, IX, H)
+ROT_mXYd_R(RR, IX, L)
+
+ROT_mXYd(RR, IY)
+
+ROT_mXYd_R(RR, IY, A)
+ROT_mXYd_R(RR, IY, B)
+ROT_mXYd_R(RR, IY, C)
+ROT_mXYd_R(RR, IY, D)
+ROT_mXYd_R(RR, IY, E)
+ROT_mXYd_R(RR, IY, H)
+ROT_mXYd_R(RR, IY, L)
+
+ROT_mXYd(SLA, IX)
+
+ROT_mXYd_R(SLA, IX, A)
+ROT_mXYd_R(SLA, IX, B)
+ROT_mXYd_R(SLA, IX, C)
+ROT_mXYd_R(SLA, IX, D)
+ROT_mXYd_R(SLA, IX, E)
+ROT_mXYd_R(SLA, IX, H)
+ROT_mXYd_R(SLA, IX, L)
+
+ROT_mXYd(SLA, IY)
+
+ROT_mXYd_R(SLA, IY, A)
+ROT_mXYd_R(SLA, IY, B)
+ROT_mXYd_R(SLA, IY, C)
+ROT_mXYd_R(SLA, IY, D)
+ROT_mXYd_R(SLA, IY, E)
+ROT_mXYd_R(SLA, IY, H)
+ROT_mXYd_R(SLA, IY, L)
+
+ROT_mXYd(SLL, IX)
+
+ROT_mXYd_R(SLL, IX, A)
+ROT_mXYd_R(SLL, IX, B)
+ROT_mXYd_R(SLL, IX, C)
+ROT_mXYd_R(SLL, IX, D)
+ROT_mXYd_R(SLL, IX, E)
+ROT_mXYd_R(SLL, IX, H)
+ROT_mXYd_R(SLL, IX, L)
+
+ROT_mXYd(SLL, IY)
+
+ROT_mXYd_R(SLL, IY, A)
+ROT_mXYd_R(SLL, IY, B)
+ROT_mXYd_R(SLL, IY, C)
+ROT_mXYd_R(SLL, IY, D)
+ROT_mXYd_R(SLL, IY, E)
+ROT_mXYd_R(SLL, IY, H)
+ROT_mXYd_R(SLL, IY, L)
+
+ROT_mXYd(SRA, IX)
+
+ROT_mXYd_R(SRA, IX, A)
+ROT_mXYd_R(SRA, IX, B)
+ROT_mXYd_R(SRA, IX, C)
+ROT_mXYd_R(SRA, IX, D)
+ROT_mXYd_R(SRA, IX, E)
+ROT_mXYd_R(SRA, IX, H)
+ROT_mXYd_R(SRA, IX, L)
+
+ROT_mXYd(SRA, IY)
+
+ROT_mXYd_R(SRA, IY, A)
+ROT_mXYd_R(SRA, IY, B)
+ROT_mXYd_R(SRA, IY, C)
+ROT_mXYd_R(SRA, IY, D)
+ROT_mXYd_R(SRA, IY, E)
+ROT_mXYd_R(SRA, IY, H)
+ROT_mXYd_R(SRA, IY, L)
+
+ROT_mXYd(SRL, IX)
+
+ROT_mXYd_R(SRL, IX, A)
+ROT_mXYd_R(SRL, IX, B)
+ROT_mXYd_R(SRL, IX, C)
+ROT_mXYd_R(SRL, IX, D)
+ROT_mXYd_R(SRL, IX, E)
+ROT_mXYd_R(SRL, IX, H)
+ROT_mXYd_R(SRL, IX, L)
+
+ROT_mXYd(SRL, IY)
+
+ROT_mXYd_R(SRL, IY, A)
+ROT_mXYd_R(SRL, IY, B)
+ROT_mXYd_R(SRL, IY, C)
+ROT_mXYd_R(SRL, IY, D)
+ROT_mXYd_R(SRL, IY, E)
+ROT_mXYd_R(SRL, IY, H)
+ROT_mXYd_R(SRL, IY, L)
+
+BITb_R(0, A)
+BITb_R(1, A)
+BITb_R(2, A)
+BITb_R(3, A)
+BITb_R(4, A)
+BITb_R(5, A)
+BITb_R(6, A)
+BITb_R(7, A)
+BITb_R(0, B)
+BITb_R(1, B)
+BITb_R(2, B)
+BITb_R(3, B)
+BITb_R(4, B)
+BITb_R(5, B)
+BITb_R(6, B)
+BITb_R(7, B)
+BITb_R(0, C)
+BITb_R(1, C)
+BITb_R(2, C)
+BITb_R(3, C)
+BITb_R(4, C)
+BITb_R(5, C)
+BITb_R(6, C)
+BITb_R(7, C)
+BITb_R(0, D)
+BITb_R(1, D)
+BITb_R(2, D)
+BITb_R(3, D)
+BITb_R(4, D)
+BITb_R(5, D)
+BITb_R(6, D)
+BITb_R(7, D)
+BITb_R(0, E)
+BITb_R(1, E)
+BITb_R(2, E)
+BITb_R(3, E)
+BITb_R(4, E)
+BITb_R(5, E)
+BITb_R(6, E)
+BITb_R(7, E)
+BITb_R(0, H)
+BITb_R(1, H)
+BITb_R(2, H)
+BITb_R(3, H)
+BITb_R(4, H)
+BITb_R(5, H)
+BITb_R(6, H)
+BITb_R(7, H)
+BITb_R(0, L)
+BITb_R(1, L)
+BITb_R(2, L)
+BITb_R(3, L)
+BITb_R(4, L)
+BITb_R(5, L)
+BITb_R(6, L)
+BITb_R(7, L)
+
+BITb_mHL(0)
+BITb_mHL(1)
+BITb_mHL(2)
+BITb_mHL(3)
+BITb_mHL(4)
+BITb_mHL(5)
+BITb_mHL(6)
+BITb_mHL(7)
+
+BITb_mXYd(0, IX)
+BITb_mXYd(1, IX)
+BITb_mXYd(2, IX)
+BITb_mXYd(3, IX)
+BITb_mXYd(4, IX)
+BITb_mXYd(5, IX)
+BITb_mXYd(6, IX)
+BITb_mXYd(7, IX)
+BITb_mXYd(0, IY)
+BITb_mXYd(1, IY)
+BITb_mXYd(2, IY)
+BITb_mXYd(3, IY)
+BITb_mXYd(4, IY)
+BITb_mXYd(5, IY)
+BITb_mXYd(6, IY)
+BITb_mXYd(7, IY)
+
+SETRESb_R(SET, 0, A)
+SETRESb_R(SET, 1, A)
+SETRESb_R(SET, 2, A)
+SETRESb_R(SET, 3, A)
+SETRESb_R(SET, 4, A)
+SETRESb_R(SET, 5, A)
+SETRESb_R(SET, 6, A)
+SETRESb_R(SET, 7, A)
+SETRESb_R(RES, 0, A)
+SETRESb_R(RES, 1, A)
+SETRESb_R(RES, 2, A)
+SETRESb_R(RES, 3, A)
+SETRESb_R(RES, 4, A)
+SETRESb_R(RES, 5, A)
+SETRESb_R(RES, 6, A)
+SETRESb_R(RES, 7, A)
+SETRESb_R(SET, 0, B)
+SETRESb_R(SET, 1, B)
+SETRESb_R(SET, 2, B)
+SETRESb_R(SET, 3, B)
+SETRESb_R(SET, 4, B)
+SETRESb_R(SET, 5, B)
+SETRESb_R(SET, 6, B)
+SETRESb_R(SET, 7, B)
+SETRESb_R(RES, 0, B)
+SETRESb_R(RES, 1, B)
+SETRESb_R(RES, 2, B)
+SETRESb_R(RES, 3, B)
+SETRESb_R(RES, 4, B)
+SETRESb_R(RES, 5, B)
+SETRESb_R(RES, 6, B)
+SETRESb_R(RES, 7, B)
+SETRESb_R(SET, 0, C)
+SETRESb_R(SET, 1, C)
+SETRESb_R(SET, 2, C)
+SETRESb_R(SET, 3, C)
+SETRESb_R(SET, 4, C)
+SETRESb_R(SET, 5, C)
+SETRESb_R(SET, 6, C)
+SETRESb_R(SET, 7, C)
+SETRESb_R(RES, 0, C)
+SETRESb_R(RES, 1, C)
+SETRESb_R(RES, 2, C)
+SETRESb_R(RES, 3, C)
+SETRESb_R(RES, 4, C)
+SETRESb_R(RES, 5, C)
+SETRESb_R(RES, 6, C)
+SETRESb_R(RES, 7, C)
+SETRESb_R(SET, 0, D)
+SETRESb_R(SET, 1, D)
+SETRESb_R(SET, 2, D)
+SETRESb_R(SET, 3, D)
+SETRESb_R(SET, 4, D)
+SETRESb_R(SET, 5, D)
+SETRESb_R(SET, 6, D)
+SETRESb_R(SET, 7, D)
+SETRESb_R(RES, 0, D)
+SETRESb_R(RES, 1, D)
+SETRESb_R(RES, 2, D)
+SETRESb_R(RES, 3, D)
+SETRESb_R(RES, 4, D)
+SETRESb_R(RES, 5, D)
+SETRESb_R(RES, 6, D)
+SETRESb_R(RES, 7, D)
+SETRESb_R(SET, 0, E)
+SETRESb_R(SET, 1, E)
+SETRESb_R(SET, 2, E)
+SETRESb_R(SET, 3, E)
+SETRESb_R(SET, 4, E)
+SETRESb_R(SET, 5, E)
+SETRESb_R(SET, 6, E)
+SETRESb_R(SET, 7, E)
+SETRESb_R(RES, 0, E)
+SETRESb_R(RES, 1, E)
+SETRESb_R(RES, 2, E)
+SETRESb_R(RES, 3, E)
+SETRESb_R(RES, 4, E)
+SETRESb_R(RES, 5, E)
+SETRESb_R(RES, 6, E)
+SETRESb_R(RES, 7, E)
+SETRESb_R(SET, 0, H)
+SETRESb_R(SET, 1, H)
+SETRESb_R(SET, 2, H)
+SETRESb_R(SET, 3, H)
+SETRESb_R(SET, 4, H)
+SETRESb_R(SET, 5, H)
+SETRESb_R(SET, 6, H)
+SETRESb_R(SET, 7, H)
+SETRESb_R(RES, 0, H)
+SETRESb_R(RES, 1, H)
+SETRESb_R(RES, 2, H)
+SETRESb_R(RES, 3, H)
+SETRESb_R(RES, 4, H)
+SETRESb_R(RES, 5, H)
+SETRESb_R(RES, 6, H)
+SETRESb_R(RES, 7, H)
+SETRESb_R(SET, 0, L)
+SETRESb_R(SET, 1, L)
+SETRESb_R(SET, 2, L)
+SETRESb_R(SET, 3, L)
+SETRESb_R(SET, 4, L)
+SETRESb_R(SET, 5, L)
+SETRESb_R(SET, 6, L)
+SETRESb_R(SET, 7, L)
+SETRESb_R(RES, 0, L)
+SETRESb_R(RES, 1, L)
+SETRESb_R(RES, 2, L)
+SETRESb_R(RES, 3, L)
+SETRESb_R(RES, 4, L)
+SETRESb_R(RES, 5, L)
+SETRESb_R(RES, 6, L)
+SETRESb_R(RES, 7, L)
+
+SETRESb_mHL(SET, 0)
+SETRESb_mHL(SET, 1)
+SETRESb_mHL(SET, 2)
+SETRESb_mHL(SET, 3)
+SETRESb_mHL(SET, 4)
+SETRESb_mHL(SET, 5)
+SETRESb_mHL(SET, 6)
+SETRESb_mHL(SET, 7)
+SETRESb_mHL(RES, 0)
+SETRESb_mHL(RES, 1)
+SETRESb_mHL(RES, 2)
+SETRESb_mHL(RES, 3)
+SETRESb_mHL(RES, 4)
+SETRESb_mHL(RES, 5)
+SETRESb_mHL(RES, 6)
+SETRESb_mHL(RES, 7)
+
+SETRESb_mXYd(SET, 0, IX)
+
+SETRESb_mXYd_R(SET, 0, IX, A)
+SETRESb_mXYd_R(SET, 0, IX, B)
+SETRESb_mXYd_R(SET, 0, IX, C)
+SETRESb_mXYd_R(SET, 0, IX, D)
+SETRESb_mXYd_R(SET, 0, IX, E)
+SETRESb_mXYd_R(SET, 0, IX, H)
+SETRESb_mXYd_R(SET, 0, IX, L)
+
+SETRESb_mXYd(SET, 1, IX)
+
+SETRESb_mXYd_R(SET, 1, IX, A)
+SETRESb_mXYd_R(SET, 1, IX, B)
+SETRESb_mXYd_R(SET, 1, IX, C)
+SETRESb_mXYd_R(SET, 1, IX, D)
+SETRESb_mXYd_R(SET, 1, IX, E)
+SETRESb_mXYd_R(SET, 1, IX, H)
+SETRESb_mXYd_R(SET, 1, IX, L)
+
+SETRESb_mXYd(SET, 2, IX)
+
+SETRESb_mXYd_R(SET, 2, IX, A)
+SETRESb_mXYd_R(SET, 2, IX, B)
+SETRESb_mXYd_R(SET, 2, IX, C)
+SETRESb_mXYd_R(SET, 2, IX, D)
+SETRESb_mXYd_R(SET, 2, IX, E)
+SETRESb_mXYd_R(SET, 2, IX, H)
+SETRESb_mXYd_R(SET, 2, IX, L)
+
+SETRESb_mXYd(SET, 3, IX)
+
+SETRESb_mXYd_R(SET, 3, IX, A)
+SETRESb_mXYd_R(SET, 3, IX, B)
+SETRESb_mXYd_R(SET, 3, IX, C)
+SETRESb_mXYd_R(SET, 3, IX, D)
+SETRESb_mXYd_R(SET, 3, IX, E)
+SETRESb_mXYd_R(SET, 3, IX, H)
+SETRESb_mXYd_R(SET, 3, IX, L)
+
+SETRESb_mXYd(SET, 4, IX)
+
+SETRESb_mXYd_R(SET, 4, IX, A)
+SETRESb_mXYd_R(SET, 4, IX, B)
+SETRESb_mXYd_R(SET, 4, IX, C)
+SETRESb_mXYd_R(SET, 4, IX, D)
+SETRESb_mXYd_R(SET, 4, IX, E)
+SETRESb_mXYd_R(SET, 4, IX, H)
+SETRESb_mXYd_R(SET, 4, IX, L)
+
+SETRESb_mXYd(SET, 5, IX)
+
+SETRESb_mXYd_R(SET, 5, IX, A)
+SETRESb_mXYd_R(SET, 5, IX, B)
+SETRESb_mXYd_R(SET, 5, IX, C)
+SETRESb_mXYd_R(SET, 5, IX, D)
+SETRESb_mXYd_R(SET, 5, IX, E)
+SETRESb_mXYd_R(SET, 5, IX, H)
+SETRESb_mXYd_R(SET, 5, IX, L)
+
+SETRESb_mXYd(SET, 6, IX)
+
+SETRESb_mXYd_R(SET, 6, IX, A)
+SETRESb_mXYd_R(SET, 6, IX, B)
+SETRESb_mXYd_R(SET, 6, IX, C)
+SETRESb_mXYd_R(SET, 6, IX, D)
+SETRESb_mXYd_R(SET, 6, IX, E)
+SETRESb_mXYd_R(SET, 6, IX, H)
+SETRESb_mXYd_R(SET, 6, IX, L)
+
+SETRESb_mXYd(SET, 7, IX)
+
+SETRESb_mXYd_R(SET, 7, IX, A)
+SETRESb_mXYd_R(SET, 7, IX, B)
+SETRESb_mXYd_R(SET, 7, IX, C)
+SETRESb_mXYd_R(SET, 7, IX, D)
+SETRESb_mXYd_R(SET, 7, IX, E)
+SETRESb_mXYd_R(SET, 7, IX, H)
+SETRESb_mXYd_R(SET, 7, IX, L)
+
+SETRESb_mXYd(RES, 0, IX)
+
+SETRESb_mXYd_R(RES, 0, IX, A)
+SETRESb_mXYd_R(RES, 0, IX, B)
+SETRESb_mXYd_R(RES, 0, IX, C)
+SETRESb_mXYd_R(RES, 0, IX, D)
+SETRESb_mXYd_R(RES, 0, IX, E)
+SETRESb_mXYd_R(RES, 0, IX, H)
+SETRESb_mXYd_R(RES, 0, IX, L)
+
+SETRESb_mXYd(RES, 1, IX)
+
+SETRESb_mXYd_R(RES, 1, IX, A)
+SETRESb_mXYd_R(RES, 1, IX, B)
+SETRESb_mXYd_R(RES, 1, IX, C)
+SETRESb_mXYd_R(RES, 1, IX, D)
+SETRESb_mXYd_R(RES, 1, IX, E)
+SETRESb_mXYd_R(RES, 1, IX, H)
+SETRESb_mXYd_R(RES, 1, IX, L)
+
+SETRESb_mXYd(RES, 2, IX)
+
+SETRESb_mXYd_R(RES, 2, IX, A)
+SETRESb_mXYd_R(RES, 2, IX, B)
+SETRESb_mXYd_R(RES, 2, IX, C)
+SETRESb_mXYd_R(RES, 2, IX, D)
+SETRESb_mXYd_R(RES, 2, IX, E)
+SETRESb_mXYd_R(RES, 2, IX, H)
+SETRESb_mXYd_R(RES, 2, IX, L)
+
+SETRESb_mXYd(RES, 3, IX)
+
+SETRESb_mXYd_R(RES, 3, IX, A)
+SETRESb_mXYd_R(RES, 3, IX, B)
+SETRESb_mXYd_R(RES, 3, IX, C)
+SETRESb_mXYd_R(RES, 3, IX, D)
+SETRESb_mXYd_R(RES, 3, IX, E)
+SETRESb_mXYd_R(RES, 3, IX, H)
+SETRESb_mXYd_R(RES, 3, IX, L)
+
+SETRESb_mXYd(RES, 4, IX)
+
+SETRESb_mXYd_R(RES, 4, IX, A)
+SETRESb_mXYd_R(RES, 4, IX, B)
+SETRESb_mXYd_R(RES, 4, IX, C)
+SETRESb_mXYd_R(RES, 4, IX, D)
+SETRESb_mXYd_R(RES, 4, IX, E)
+SETRESb_mXYd_R(RES, 4, IX, H)
+SETRESb_mXYd_R(RES, 4, IX, L)
+
+SETRESb_mXYd(RES, 5, IX)
+
+SETRESb_mXYd_R(RES, 5, IX, A)
+SETRESb_mXYd_R(RES, 5, IX, B)
+SETRESb_mXYd_R(RES, 5, IX, C)
+SETRESb_mXYd_R(RES, 5, IX, D)
+SETRESb_mXYd_R(RES, 5, IX, E)
+SETRESb_mXYd_R(RES, 5, IX, H)
+SETRESb_mXYd_R(RES, 5, IX, L)
+
+SETRESb_mXYd(RES, 6, IX)
+
+SETRESb_mXYd_R(RES, 6, IX, A)
+SETRESb_mXYd_R(RES, 6, IX, B)
+SETRESb_mXYd_R(RES, 6, IX, C)
+SETRESb_mXYd_R(RES, 6, IX, D)
+SETRESb_mXYd_R(RES, 6, IX, E)
+SETRESb_mXYd_R(RES, 6, IX, H)
+SETRESb_mXYd_R(RES, 6, IX, L)
+
+SETRESb_mXYd(RES, 7, IX)
+
+SETRESb_mXYd_R(RES, 7, IX, A)
+SETRESb_mXYd_R(RES, 7, IX, B)
+SETRESb_mXYd_R(RES, 7, IX, C)
+SETRESb_mXYd_R(RES, 7, IX, D)
+SETRESb_mXYd_R(RES, 7, IX, E)
+SETRESb_mXYd_R(RES, 7, IX, H)
+SETRESb_mXYd_R(RES, 7, IX, L)
+
+SETRESb_mXYd(SET, 0, IY)
+
+SETRESb_mXYd_R(SET, 0, IY, A)
+SETRESb_mXYd_R(SET, 0, IY, B)
+SETRESb_mXYd_R(SET, 0, IY, C)
+SETRESb_mXYd_R(SET, 0, IY, D)
+SETRESb_mXYd_R(SET, 0, IY, E)
+SETRESb_mXYd_R(SET, 0, IY, H)
+SETRESb_mXYd_R(SET, 0, IY, L)
+
+SETRESb_mXYd(SET, 1, IY)
+
+SETRESb_mXYd_R(SET, 1, IY, A)
+SETRESb_mXYd_R(SET, 1, IY, B)
+SETRESb_mXYd_R(SET, 1, IY, C)
+SETRESb_mXYd_R(SET, 1, IY, D)
+SETRESb_mXYd_R(SET, 1, IY, E)
+SETRESb_mXYd_R(SET, 1, IY, H)
+SETRESb_mXYd_R(SET, 1, IY, L)
+
+SETRESb_mXYd(SET, 2, IY)
+
+SETRESb_mXYd_R(SET, 2, IY, A)
+SETRESb_mXYd_R(SET, 2, IY, B)
+SETRESb_mXYd_R(SET, 2, IY, C)
+SETRESb_mXYd_R(SET, 2, IY, D)
+SETRESb_mXYd_R(SET, 2, IY, E)
+SETRESb_mXYd_R(SET, 2, IY, H)
+SETRESb_mXYd_R(SET, 2, IY, L)
+
+SETRESb_mXYd(SET, 3, IY)
+
+SETRESb_mXYd_R(SET, 3, IY, A)
+SETRESb_mXYd_R(SET, 3, IY, B)
+SETRESb_mXYd_R(SET, 3, IY, C)
+SETRESb_mXYd_R(SET, 3, IY, D)
+SETRESb_mXYd_R(SET, 3, IY, E)
+SETRESb_mXYd_R(SET, 3, IY, H)
+SETRESb_mXYd_R(SET, 3, IY, L)
+
+SETRESb_mXYd(SET, 4, IY)
+
+SETRESb_mXYd_R(SET, 4, IY, A)
+SETRESb_mXYd_R(SET, 4, IY, B)
+SETRESb_mXYd_R(SET, 4, IY, C)
+SETRESb_mXYd_R(SET, 4, IY, D)
+SETRESb_mXYd_R(SET, 4, IY, E)
+SETRESb_mXYd_R(SET, 4, IY, H)
+SETRESb_mXYd_R(SET, 4, IY, L)
+
+SETRESb_mXYd(SET, 5, IY)
+
+SETRESb_mXYd_R(SET, 5, IY, A)
+SETRESb_mXYd_R(SET, 5, IY, B)
+SETRESb_mXYd_R(SET, 5, IY, C)
+SETRESb_mXYd_R(SET, 5, IY, D)
+SETRESb_mXYd_R(SET, 5, IY, E)
+SETRESb_mXYd_R(SET, 5, IY, H)
+SETRESb_mXYd_R(SET, 5, IY, L)
+
+SETRESb_mXYd(SET, 6, IY)
+
+SETRESb_mXYd_R(SET, 6, IY, A)
+SETRESb_mXYd_R(SET, 6, IY, B)
+SETRESb_mXYd_R(SET, 6, IY, C)
+SETRESb_mXYd_R(SET, 6, IY, D)
+SETRESb_mXYd_R(SET, 6, IY, E)
+SETRESb_mXYd_R(SET, 6, IY, H)
+SETRESb_mXYd_R(SET, 6, IY, L)
+
+SETRESb_mXYd(SET, 7, IY)
+
+SETRESb_mXYd_R(SET, 7, IY, A)
+SETRESb_mXYd_R(SET, 7, IY, B)
+SETRESb_mXYd_R(SET, 7, IY, C)
+SETRESb_mXYd_R(SET, 7, IY, D)
+SETRESb_mXYd_R(SET, 7, IY, E)
+SETRESb_mXYd_R(SET, 7, IY, H)
+SETRESb_mXYd_R(SET, 7, IY, L)
+
+SETRESb_mXYd(RES, 0, IY)
+
+SETRESb_mXYd_R(RES, 0, IY, A)
+SETRESb_mXYd_R(RES, 0, IY, B)
+SETRESb_mXYd_R(RES, 0, IY, C)
+SETRESb_mXYd_R(RES, 0, IY, D)
+SETRESb_mXYd_R(RES, 0, IY, E)
+SETRESb_mXYd_R(RES, 0, IY, H)
+SETRESb_mXYd_R(RES, 0, IY, L)
+
+SETRESb_mXYd(RES, 1, IY)
+
+SETRESb_mXYd_R(RES, 1, IY, A)
+SETRESb_mXYd_R(RES, 1, IY, B)
+SETRESb_mXYd_R(RES, 1, IY, C)
+SETRESb_mXYd_R(RES, 1, IY, D)
+SETRESb_mXYd_R(RES, 1, IY, E)
+SETRESb_mXYd_R(RES, 1, IY, H)
+SETRESb_mXYd_R(RES, 1, IY, L)
+
+SETRESb_mXYd(RES, 2, IY)
+
+SETRESb_mXYd_R(RES, 2, IY, A)
+SETRESb_mXYd_R(RES, 2, IY, B)
+SETRESb_mXYd_R(RES, 2, IY, C)
+SETRESb_mXYd_R(RES, 2, IY, D)
+SETRESb_mXYd_R(RES, 2, IY, E)
+SETRESb_mXYd_R(RES, 2, IY, H)
+SETRESb_mXYd_R(RES, 2, IY, L)
+
+SETRESb_mXYd(RES, 3, IY)
+
+SETRESb_mXYd_R(RES, 3, IY, A)
+SETRESb_mXYd_R(RES, 3, IY, B)
+SETRESb_mXYd_R(RES, 3, IY, C)
+SETRESb_mXYd_R(RES, 3, IY, D)
+SETRESb_mXYd_R(RES, 3, IY, E)
+SETRESb_mXYd_R(RES, 3, IY, H)
+SETRESb_mXYd_R(RES, 3, IY, L)
+
+SETRESb_mXYd(RES, 4, IY)
+
+SETRESb_mXYd_R(RES, 4, IY, A)
+SETRESb_mXYd_R(RES, 4, IY, B)
+SETRESb_mXYd_R(RES, 4, IY, C)
+SETRESb_mXYd_R(RES, 4, IY, D)
+SETRESb_mXYd_R(RES, 4, IY, E)
+SETRESb_mXYd_R(RES, 4, IY, H)
+SETRESb_mXYd_R(RES, 4, IY, L)
+
+SETRESb_mXYd(RES, 5, IY)
+
+SETRESb_mXYd_R(RES, 5, IY, A)
+SETRESb_mXYd_R(RES, 5, IY, B)
+SETRESb_mXYd_R(RES, 5, IY, C)
+SETRESb_mXYd_R(RES, 5, IY, D)
+SETRESb_mXYd_R(RES, 5, IY, E)
+SETRESb_mXYd_R(RES, 5, IY, H)
+SETRESb_mXYd_R(RES, 5, IY, L)
+
+SETRESb_mXYd(RES, 6, IY)
+
+SETRESb_mXYd_R(RES, 6, IY, A)
+SETRESb_mXYd_R(RES, 6, IY, B)
+SETRESb_mXYd_R(RES, 6, IY, C)
+SETRESb_mXYd_R(RES, 6, IY, D)
+SETRESb_mXYd_R(RES, 6, IY, E)
+SETRESb_mXYd_R(RES, 6, IY, H)
+SETRESb_mXYd_R(RES, 6, IY, L)
+
+SETRESb_mXYd(RES, 7, IY)
+
+SETRESb_mXYd_R(RES, 7, IY, A)
+SETRESb_mXYd_R(RES, 7, IY, B)
+SETRESb_mXYd_R(RES, 7, IY, C)
+SETRESb_mXYd_R(RES, 7, IY, D)
+SETRESb_mXYd_R(RES, 7, IY, E)
+SETRESb_mXYd_R(RES, 7, IY, H)
+SETRESb_mXYd_R(RES, 7, IY, L)
+
+JPcc_NN(Z, (zF & FLAG_Z))
+JPcc_NN(NZ, !(zF & FLAG_Z))
+JPcc_NN(C, (zF & FLAG_C))
+JPcc_NN(NC, !(zF & FLAG_C))
+JPcc_NN(P, (zF & FLAG_P))
+JPcc_NN(NP, !(zF & FLAG_P))
+JPcc_NN(S, (zF & FLAG_S))
+JPcc_NN(NS, !(zF & FLAG_S))
+
+JRcc_N(Z, (zF & FLAG_Z))
+JRcc_N(NZ, !(zF & FLAG_Z))
+JRcc_N(C, (zF & FLAG_C))
+JRcc_N(NC, !(zF & FLAG_C))
+
+JP_RR(HL)
+JP_RR(IX)
+JP_RR(IY)
+
+CALLcc_NN(Z, (zF & FLAG_Z))
+CALLcc_NN(NZ, !(zF & FLAG_Z))
+CALLcc_NN(C, (zF & FLAG_C))
+CALLcc_NN(NC, !(zF & FLAG_C))
+CALLcc_NN(P, (zF & FLAG_P))
+CALLcc_NN(NP, !(zF & FLAG_P))
+CALLcc_NN(S, (zF & FLAG_S))
+CALLcc_NN(NS, !(zF & FLAG_S))
+
+RETcc(Z, (zF & FLAG_Z))
+RETcc(NZ, !(zF & FLAG_Z))
+RETcc(C, (zF & FLAG_C))
+RETcc(NC, !(zF & FLAG_C))
+RETcc(P, (zF & FLAG_P))
+RETcc(NP, !(zF & FLAG_P))
+RETcc(S, (zF & FLAG_S))
+RETcc(NS, !(zF & FLAG_S))
+
+IN_R_mBC(A)
+IN_R_mBC(B)
+IN_R_mBC(C)
+IN_R_mBC(D)
+IN_R_mBC(E)
+IN_R_mBC(H)
+IN_R_mBC(L)
+
+INX(I)
+INX(D)
+
+INXR(I)
+INXR(D)
+
+OUT_mBC_R(A)
+OUT_mBC_R(B)
+OUT_mBC_R(C)
+OUT_mBC_R(D)
+OUT_mBC_R(E)
+OUT_mBC_R(H)
+OUT_mBC_R(L)
+
+OUTX(I)
+OUTX(D)
+
+OUTXR(I)
+OUTXR(D)
+
+
+// Opcode tables, same as in z80.asm
+
+static const Z80C_OP OP_Table[256] =
+{
+	Z80I_NOP, Z80I_LD_BC_NN, Z80I_LD_mBC_A, Z80I_INC_BC,		// 00-03
+	Z80I_INC_B, Z80I_DEC_B, Z80I_LD_B_N, Z80I_RLCA,		// 04-07
+	Z80I_EX_AF_AF2, Z80I_ADD_HL_BC, Z80I_LD_A_mBC, Z80I_DEC_BC,		// 08-0B
+	Z80I_INC_C, Z80I_DEC_C, Z80I_LD_C_N, Z80I_RRCA,		// 0C-0F
+	Z80I_DJNZ, Z80I_LD_DE_NN, Z80I_LD_mDE_A, Z80I_INC_DE,		// 10-13
+	Z80I_INC_D, Z80I_DEC_D, Z80I_LD_D_N, Z80I_RLA,		// 14-17
+	Z80I_JR_N, Z80I_ADD_HL_DE, Z80I_LD_A_mDE, Z80I_DEC_DE,		// 18-1B
+	Z80I_INC_E, Z80I_DEC_E, Z80I_LD_E_N, Z80I_RRA,		// 1C-1F
+	Z80I_JRNZ_N, Z80I_LD_HL_NN, Z80I_LD_mNN_HL, Z80I_INC_HL,		// 20-23
+	Z80I_INC_H, Z80I_DEC_H, Z80I_LD_H_N, Z80I_DAA,		// 24-27
+	Z80I_JRZ_N, Z80I_ADD_HL_HL, Z80I_LD_HL_mNN, Z80I_DEC_HL,		// 28-2B
+	Z80I_INC_L, Z80I_DEC_L, Z80I_LD_L_N, Z80I_CPL,		// 2C-2F
+	Z80I_JRNC_N, Z80I_LD_SP_NN, Z80I_LD_mNN_A, Z80I_INC_SP,		// 30-33
+	Z80I_INC_mHL, Z80I_DEC_mHL, Z80I_LD_mHL_N, Z80I_SCF,		// 34-37
+	Z80I_JRC_N, Z80I_ADD_HL_SP, Z80I_LD_A_mNN, Z80I_DEC_SP,		// 38-3B
+	Z80I_INC_A, Z80I_DEC_A, Z80I_LD_A_N, Z80I_CCF,		// 3C-3F
+	Z80I_LD_B_B, Z80I_LD_B_C, Z80I_LD_B_D, Z80I_LD_B_E,		// 40-43
+	Z80I_LD_B_H, Z80I_LD_B_L, Z80I_LD_B_mHL, Z80I_LD_B_A,		// 44-47
+	Z80I_LD_C_B, Z80I_LD_C_C, Z80I_LD_C_D, Z80I_LD_C_E,		// 48-4B
+	Z80I_LD_C_H, Z80I_LD_C_L, Z80I_LD_C_mHL, Z80I_LD_C_A,		// 4C-4F
+	Z80I_LD_D_B, Z80I_LD_D_C, Z80I_LD_D_D, Z80I_LD_D_E,		// 50-53
+	Z80I_LD_D_H, Z80I_LD_D_L, Z80I_LD_D_mHL, Z80I_LD_D_A,		// 54-57
+	Z80I_LD_E_B, Z80I_LD_E_C, Z80I_LD_E_D, Z80I_LD_E_E,		// 58-5B
+	Z80I_LD_E_H, Z80I_LD_E_L, Z80I_LD_E_mHL, Z80I_LD_E_A,		// 5C-5F
+	Z80I_LD_H_B, Z80I_LD_H_C, Z80I_LD_H_D, Z80I_LD_H_E,		// 60-63
+	Z80I_LD_H_H, Z80I_LD_H_L, Z80I_LD_H_mHL, Z80I_LD_H_A,		// 64-67
+	Z80I_LD_L_B, Z80I_LD_L_C, Z80I_LD_L_D, Z80I_LD_L_E,		// 68-6B
+	Z80I_LD_L_H, Z80I_LD_L_L, Z80I_LD_L_mHL, Z80I_LD_L_A,		// 6C-6F
+	Z80I_LD_mHL_B, Z80I_LD_mHL_C, Z80I_LD_mHL_D, Z80I_LD_mHL_E,		// 70-73
+	Z80I_LD_mHL_H, Z80I_LD_mHL_L, Z80I_HALT, Z80I_LD_mHL_A,		// 74-77
+	Z80I_LD_A_B, Z80I_LD_A_C, Z80I_LD_A_D, Z80I_LD_A_E,		// 78-7B
+	Z80I_LD_A_H, Z80I_LD_A_L, Z80I_LD_A_mHL, Z80I_LD_A_A,		// 7C-7F
+	Z80I_ADD_B, Z80I_ADD_C, Z80I_ADD_D, Z80I_ADD_E,		// 80-83
+	Z80I_ADD_H, Z80I_ADD_L, Z80I_ADD_mHL, Z80I_ADD_A,		// 84-87
+	Z80I_ADC_B, Z80I_ADC_C, Z80I_ADC_D, Z80I_ADC_E,		// 88-8B
+	Z80I_ADC_H, Z80I_ADC_L, Z80I_ADC_mHL, Z80I_ADC_A,		// 8C-8F
+	Z80I_SUB_B, Z80I_SUB_C, Z80I_SUB_D, Z80I_SUB_E,		// 90-93
+	Z80I_SUB_H, Z80I_SUB_L, Z80I_SUB_mHL, Z80I_SUB_A,		// 94-97
+	Z80I_SBC_B, Z80I_SBC_C, Z80I_SBC_D, Z80I_SBC_E,		// 98-9B
+	Z80I_SBC_H, Z80I_SBC_L, Z80I_SBC_mHL, Z80I_SBC_A,		// 9C-9F
+	Z80I_AND_B, Z80I_AND_C, Z80I_AND_D, Z80I_AND_E,		// A0-A3
+	Z80I_AND_H, Z80I_AND_L, Z80I_AND_mHL, Z80I_AND_A,		// A4-A7
+	Z80I_XOR_B, Z80I_XOR_C, Z80I_XOR_D, Z80I_XOR_E,		// A8-AB
+	Z80I_XOR_H, Z80I_XOR_L, Z80I_XOR_mHL, Z80I_XOR_A,		// AC-AF
+	Z80I_OR_B, Z80I_OR_C, Z80I_OR_D, Z80I_OR_E,		// B0-B3
+	Z80I_OR_H, Z80I_OR_L, Z80I_OR_mHL, Z80I_OR_A,		// B4-B7
+	Z80I_CP_B, Z80I_CP_C, Z80I_CP_D, Z80I_CP_E,		// B8-BB
+	Z80I_CP_H, Z80I_CP_L, Z80I_CP_mHL, Z80I_CP_A,		// BC-BF
+	Z80I_RETNZ, Z80I_POP_BC, Z80I_JPNZ_NN, Z80I_JP_NN,		// C0-C3
+	Z80I_CALLNZ_NN, Z80I_PUSH_BC, Z80I_ADD_N, Z80I_RST,		// C4-C7
+	Z80I_RETZ, Z80I_RET, Z80I_JPZ_NN, PREFIXE_CB,		// C8-CB
+	Z80I_CALLZ_NN, Z80I_CALL_NN, Z80I_ADC_N, Z80I_RST,		// CC-CF
+	Z80I_RETNC, Z80I_POP_DE, Z80I_JPNC_NN, Z80I_OUT_mN,		// D0-D3
+	Z80I_CALLNC_NN, Z80I_PUSH_DE, Z80I_SUB_N, Z80I_RST,		// D4-D7
+	Z80I_RETC, Z80I_EXX, Z80I_JPC_NN, Z80I_IN_mN,		// D8-DB
+	Z80I_CALLC_NN, PREFIXE_DD, Z80I_SBC_N, Z80I_RST,		// DC-DF
+	Z80I_RETNP, Z80I_POP_HL, Z80I_JPNP_NN, Z80I_EX_mSP_HL,		// E0-E3
+	Z80I_CALLNP_NN, Z80I_PUSH_HL, Z80I_AND_N, Z80I_RST,		// E4-E7
+	Z80I_RETP, Z80I_JP_HL, Z80I_JPP_NN, Z80I_EX_DE_HL,		// E8-EB
+	Z80I_CALLP_NN, PREFIXE_ED, Z80I_XOR_N, Z80I_RST,		// EC-EF
+	Z80I_RETNS, Z80I_POP_AF, Z80I_JPNS_NN, Z80I_DI,		// F0-F3
+	Z80I_CALLNS_NN, Z80I_PUSH_AF, Z80I_OR_N, Z80I_RST,		// F4-F7
+	Z80I_RETS, Z80I_LD_SP_HL, Z80I_JPS_NN, Z80I_EI,		// F8-FB
+	Z80I_CALLS_NN, PREFIXE_FD, Z80I_CP_N, Z80I_RST		// FC-FF
+};
+
+static const Z80C_OP CB_Table[256] =
+{
+	Z80I_RLC_B, Z80I_RLC_C, Z80I_RLC_D, Z80I_RLC_E,		// 00-03
+	Z80I_RLC_H, Z80I_RLC_L, Z80I_RLC_mHL, Z80I_RLC_A,		// 04-07
+	Z80I_RRC_B, Z80I_RRC_C, Z80I_RRC_D, Z80I_RRC_E,		// 08-0B
+	Z80I_RRC_H, Z80I_RRC_L, Z80I_RRC_mHL, Z80I_RRC_A,		// 0C-0F
+	Z80I_RL_B, Z80I_RL_C, Z80I_RL_D, Z80I_RL_E,		// 10-13
+	Z80I_RL_H, Z80I_RL_L, Z80I_RL_mHL, Z80I_RL_A,		// 14-17
+	Z80I_RR_B, Z80I_RR_C, Z80I_RR_D, Z80I_RR_E,		// 18-1B
+	Z80I_RR_H, Z80I_RR_L, Z80I_RR_mHL, Z80I_RR_A,		// 1C-1F
+	Z80I_SLA_B, Z80I_SLA_C, Z80I_SLA_D, Z80I_SLA_E,		// 20-23
+	Z80I_SLA_H, Z80I_SLA_L, Z80I_SLA_mHL, Z80I_SLA_A,		// 24-27
+	Z80I_SRA_B, Z80I_SRA_C, Z80I_SRA_D, Z80I_SRA_E,		// 28-2B
+	Z80I_SRA_H, Z80I_SRA_L, Z80I_SRA_mHL, Z80I_SRA_A,		// 2C-2F
+	Z80I_SLL_B, Z80I_SLL_C, Z80I_SLL_D, Z80I_SLL_E,		// 30-33
+	Z80I_SLL_H, Z80I_SLL_L, Z80I_SLL_mHL, Z80I_SLL_A,		// 34-37
+	Z80I_SRL_B, Z80I_SRL_C, Z80I_SRL_D, Z80I_SRL_E,		// 38-3B
+	Z80I_SRL_H, Z80I_SRL_L, Z80I_SRL_mHL, Z80I_SRL_A,		// 3C-3F
+	Z80I_BIT0_B, Z80I_BIT0_C, Z80I_BIT0_D, Z80I_BIT0_E,		// 40-43
+	Z80I_BIT0_H, Z80I_BIT0_L, Z80I_BIT0_mHL, Z80I_BIT0_A,		// 44-47
+	Z80I_BIT1_B, Z80I_BIT1_C, Z80I_BIT1_D, Z80I_BIT1_E,		// 48-4B
+	Z80I_BIT1_H, Z80I_BIT1_L, Z80I_BIT1_mHL, Z80I_BIT1_A,		// 4C-4F
+	Z80I_BIT2_B, Z80I_BIT2_C, Z80I_BIT2_D, Z80I_BIT2_E,		// 50-53
+	Z80I_BIT2_H, Z80I_BIT2_L, Z80I_BIT2_mHL, Z80I_BIT2_A,		// 54-57
+	Z80I_BIT3_B, Z80I_BIT3_C, Z80I_BIT3_D, Z80I_BIT3_E,		// 58-5B
+	Z80I_BIT3_H, Z80I_BIT3_L, Z80I_BIT3_mHL, Z80I_BIT3_A,		// 5C-5F
+	Z80I_BIT4_B, Z80I_BIT4_C, Z80I_BIT4_D, Z80I_BIT4_E,		// 60-63
+	Z80I_BIT4_H, Z80I_BIT4_L, Z80I_BIT4_mHL, Z80I_BIT4_A,		// 64-67
+	Z80I_BIT5_B, Z80I_BIT5_C, Z80I_BIT5_D, Z80I_BIT5_E,		// 68-6B
+	Z80I_BIT5_H, Z80I_BIT5_L, Z80I_BIT5_mHL, Z80I_BIT5_A,		// 6C-6F
+	Z80I_BIT6_B, Z80I_BIT6_C, Z80I_BIT6_D, Z80I_BIT6_E,		// 70-73
+	Z80I_BIT6_H, Z80I_BIT6_L, Z80I_BIT6_mHL, Z80I_BIT6_A,		// 74-77
+	Z80I_BIT7_B, Z80I_BIT7_C, Z80I_BIT7_D, Z80I_BIT7_E,		// 78-7B
+	Z80I_BIT7_H, Z80I_BIT7_L, Z80I_BIT7_mHL, Z80I_BIT7_A,		// 7C-7F
+	Z80I_RES0_B, Z80I_RES0_C, Z80I_RES0_D, Z80I_RES0_E,		// 80-83
+	Z80I_RES0_H, Z80I_RES0_L, Z80I_RES0_mHL, Z80I_RES0_A,		// 84-87
+	Z80I_RES1_B, Z80I_RES1_C, Z80I_RES1_D, Z80I_RES1_E,		// 88-8B
+	Z80I_RES1_H, Z80I_RES1_L, Z80I_RES1_mHL, Z80I_RES1_A,		// 8C-8F
+	Z80I_RES2_B, Z80I_RES2_C, Z80I_RES2_D, Z80I_RES2_E,		// 90-93
+	Z80I_RES2_H, Z80I_RES2_L, Z80I_RES2_mHL, Z80I_RES2_A,		// 94-97
+	Z80I_RES3_B, Z80I_RES3_C, Z80I_RES3_D, Z80I_RES3_E,		// 98-9B
+	Z80I_RES3_H, Z80I_RES3_L, Z80I_RES3_mHL, Z80I_RES3_A,		// 9C-9F
+	Z80I_RES4_B, Z80I_RES4_C, Z80I_RES4_D, Z80I_RES4_E,		// A0-A3
+	Z80I_RES4_H, Z80I_RES4_L, Z80I_RES4_mHL, Z80I_RES4_A,		// A4-A7
+	Z80I_RES5_B, Z80I_RES5_C, Z80I_RES5_D, Z80I_RES5_E,		// A8-AB
+	Z80I_RES5_H, Z80I_RES5_L, Z80I_RES5_mHL, Z80I_RES5_A,		// AC-AF
+	Z80I_RES6_B, Z80I_RES6_C, Z80I_RES6_D, Z80I_RES6_E,		// B0-B3
+	Z80I_RES6_H, Z80I_RES6_L, Z80I_RES6_mHL, Z80I_RES6_A,		// B4-B7
+	Z80I_RES7_B, Z80I_RES7_C, Z80I_RES7_D, Z80I_RES7_E,		// B8-BB
+	Z80I_RES7_H, Z80I_RES7_L, Z80I_RES7_mHL, Z80I_RES7_A,		// BC-BF
+	Z80I_SET0_B, Z80I_SET0_C, Z80I_SET0_D, Z80I_SET0_E,		// C0-C3
+	Z80I_SET0_H, Z80I_SET0_L, Z80I_SET0_mHL, Z80I_SET0_A,		// C4-C7
+	Z80I_SET1_B, Z80I_SET1_C, Z80I_SET1_D, Z80I_SET1_E,		// C8-CB
+	Z80I_SET1_H, Z80I_SET1_L, Z80I_SET1_mHL, Z80I_SET1_A,		// CC-CF
+	Z80I_SET2_B, Z80I_SET2_C, Z80I_SET2_D, Z80I_SET2_E,		// D0-D3
+	Z80I_SET2_H, Z80I_SET2_L, Z80I_SET2_mHL, Z80I_SET2_A,		// D4-D7
+	Z80I_SET3_B, Z80I_SET3_C, Z80I_SET3_D, Z80I_SET3_E,		// D8-DB
+	Z80I_SET3_H, Z80I_SET3_L, Z80I_SET3_mHL, Z80I_SET3_A,		// DC-DF
+	Z80I_SET4_B, Z80I_SET4_C, Z80I_SET4_D, Z80I_SET4_E,		// E0-E3
+	Z80I_SET4_H, Z80I_SET4_L, Z80I_SET4_mHL, Z80I_SET4_A,		// E4-E7
+	Z80I_SET5_B, Z80I_SET5_C, Z80I_SET5_D, Z80I_SET5_E,		// E8-EB
+	Z80I_SET5_H, Z80I_SET5_L, Z80I_SET5_mHL, Z80I_SET5_A,		// EC-EF
+	Z80I_SET6_B, Z80I_SET6_C, Z80I_SET6_D, Z80I_SET6_E,		// F0-F3
+	Z80I_SET6_H, Z80I_SET6_L, Z80I_SET6_mHL, Z80I_SET6_A,		// F4-F7
+	Z80I_SET7_B, Z80I_SET7_C, Z80I_SET7_D, Z80I_SET7_E,		// F8-FB
+	Z80I_SET7_H, Z80I_SET7_L, Z80I_SET7_mHL, Z80I_SET7_A		// FC-FF
+};
+
+static const Z80C_OP ED_Table[256] =
+{
+	Z80I_NOP, Z80I_NOP, Z80I_NOP, Z80I_NOP,		// 00-03
+	Z80I_NOP, Z80I_NOP, Z80I_NOP, Z80I_NOP,		// 04-07
+	Z80I_NOP, Z80I_NOP, Z80I_NOP, Z80I_NOP,		// 08-0B
+	Z80I_NOP, Z80I_NOP, Z80I_NOP, Z80I_NOP,		// 0C-0F
+	Z80I_NOP, Z80I_NOP, Z80I_NOP, Z80I_NOP,		// 10-13
+	Z80I_NOP, Z80I_NOP, Z80I_NOP, Z80I_NOP,		// 14-17
+	Z80I_NOP, Z80I_NOP, Z80I_NOP, Z80I_NOP,		// 18-1B
+	Z80I_NOP, Z80I_NOP, Z80I_NOP, Z80I_NOP,		// 1C-1F
+	Z80I_NOP, Z80I_NOP, Z80I_NOP, Z80I_NOP,		// 20-23
+	Z80I_NOP, Z80I_NOP, Z80I_NOP, Z80I_NOP,		// 24-27
+	Z80I_NOP, Z80I_NOP, Z80I_NOP, Z80I_NOP,		// 28-2B
+	Z80I_NOP, Z80I_NOP, Z80I_NOP, Z80I_NOP,		// 2C-2F
+	Z80I_NOP, Z80I_NOP, Z80I_NOP, Z80I_NOP,		// 30-33
+	Z80I_NOP, Z80I_NOP, Z80I_NOP, Z80I_NOP,		// 34-37
+	Z80I_NOP, Z80I_NOP, Z80I_NOP, Z80I_NOP,		// 38-3B
+	Z80I_NOP, Z80I_NOP, Z80I_NOP, Z80I_NOP,		// 3C-3F
+	Z80I_IN_B_mBC, Z80I_OUT_mBC_B, Z80I_SBC_HL_BC, Z80I_LD_mNN_BC,		// 40-43
+	Z80I_NEG, Z80I_RETN, Z80I_IM0, Z80I_LD_I_A,		// 44-47
+	Z80I_IN_C_mBC, Z80I_OUT_mBC_C, Z80I_ADC_HL_BC, Z80I_LD_BC_mNN,		// 48-4B
+	Z80I_NEG, Z80I_RETI, Z80I_IM0, Z80I_LD_R_A,		// 4C-4F
+	Z80I_IN_D_mBC, Z80I_OUT_mBC_D, Z80I_SBC_HL_DE, Z80I_LD_mNN_DE,		// 50-53
+	Z80I_NEG, Z80I_RETN, Z80I_IM1, Z80I_LD_A_I,		// 54-57
+	Z80I_IN_E_mBC, Z80I_OUT_mBC_E, Z80I_ADC_HL_DE, Z80I_LD_DE_mNN,		// 58-5B
+	Z80I_NEG, Z80I_RETN, Z80I_IM2, Z80I_LD_A_R,		// 5C-5F
+	Z80I_IN_H_mBC, Z80I_OUT_mBC_H, Z80I_SBC_HL_HL, Z80I_LD2_mNN_HL,		// 60-63
+	Z80I_NEG, Z80I_RETN, Z80I_IM0, Z80I_RRD,		// 64-67
+	Z80I_IN_L_mBC, Z80I_OUT_mBC_L, Z80I_ADC_HL_HL, Z80I_LD2_HL_mNN,		// 68-6B
+	Z80I_NEG, Z80I_RETN, Z80I_IM0, Z80I_RLD,		// 6C-6F
+	Z80I_IN_F_mBC, Z80I_OUT_mBC_0, Z80I_SBC_HL_SP, Z80I_LD_mNN_SP,		// 70-73
+	Z80I_NEG, Z80I_RETN, Z80I_IM1, Z80I_NOP,		// 74-77
+	Z80I_IN_A_mBC, Z80I_OUT_mBC_A, Z80I_ADC_HL_SP, Z80I_LD_SP_mNN,		// 78-7B
+	Z80I_NEG, Z80I_RETN, Z80I_IM2, Z80I_NOP,		// 7C-7F
+	Z80I_NOP, Z80I_NOP, Z80I_NOP, Z80I_NOP,		// 80-83
+	Z80I_NOP, Z80I_NOP, Z80I_NOP, Z80I_NOP,		// 84-87
+	Z80I_NOP, Z80I_NOP, Z80I_NOP, Z80I_NOP,		// 88-8B
+	Z80I_NOP, Z80I_NOP, Z80I_NOP, Z80I_NOP,		// 8C-8F
+	Z80I_NOP, Z80I_NOP, Z80I_NOP, Z80I_NOP,		// 90-93
+	Z80I_NOP, Z80I_NOP, Z80I_NOP, Z80I_NOP,		// 94-97
+	Z80I_NOP, Z80I_NOP, Z80I_NOP, Z80I_NOP,		// 98-9B
+	Z80I_NOP, Z80I_NOP, Z80I_NOP, Z80I_NOP,		// 9C-9F
+	Z80I_LDI, Z80I_CPI, Z80I_INI, Z80I_OUTI,		// A0-A3
+	Z80I_NOP, Z80I_NOP, Z80I_NOP, Z80I_NOP,		// A4-A7
+	Z80I_LDD, Z80I_CPD, Z80I_IND, Z80I_OUTD,		// A8-AB
+	Z80I_NOP, Z80I_NOP, Z80I_NOP, Z80I_NOP,		// AC-AF
+	Z80I_LDIR, Z80I_CPIR, Z80I_INIR, Z80I_OTIR,		// B0-B3
+	Z80I_NOP, Z80I_NOP, Z80I_NOP, Z80I_NOP,		// B4-B7
+	Z80I_LDDR, Z80I_CPDR, Z80I_INDR, Z80I_OTDR,		// B8-BB
+	Z80I_NOP, Z80I_NOP, Z80I_NOP, Z80I_NOP,		// BC-BF
+	Z80I_NOP, Z80I_NOP, Z80I_NOP, Z80I_NOP,		// C0-C3
+	Z80I_NOP, Z80I_NOP, Z80I_NOP, Z80I_NOP,		// C4-C7
+	Z80I_NOP, Z80I_NOP, Z80I_NOP, Z80I_NOP,		// C8-CB
+	Z80I_NOP, Z80I_NOP, Z80I_NOP, Z80I_NOP,		// CC-CF
+	Z80I_NOP, Z80I_NOP, Z80I_NOP, Z80I_NOP,		// D0-D3
+	Z80I_NOP, Z80I_NOP, Z80I_NOP, Z80I_NOP,		// D4-D7
+	Z80I_NOP, Z80I_NOP, Z80I_NOP, Z80I_NOP,		// D8-DB
+	Z80I_NOP, Z80I_NOP, Z80I_NOP, Z80I_NOP,		// DC-DF
+	Z80I_NOP, Z80I_NOP, Z80I_NOP, Z80I_NOP,		// E0-E3
+	Z80I_NOP, Z80I_NOP, Z80I_NOP, Z80I_NOP,		// E4-E7
+	Z80I_NOP, Z80I_NOP, Z80I_NOP, Z80I_NOP,		// E8-EB
+	Z80I_NOP, Z80I_NOP, Z80I_NOP, Z80I_NOP,		// EC-EF
+	Z80I_NOP, Z80I_NOP, Z80I_NOP, Z80I_NOP,		// F0-F3
+	Z80I_NOP, Z80I_NOP, Z80I_NOP, Z80I_NOP,		// F4-F7
+	Z80I_NOP, Z80I_NOP, Z80I_NOP, Z80I_NOP,		// F8-FB
+	Z80I_NOP, Z80I_NOP, Z80I_NOP, Z80I_NOP		// FC-FF
+};
+
+static const Z80C_OP DD_Table[256] =
+{
+	Z80I_NOP, Z80I_LD_BC_NN, Z80I_LD_mBC_A, Z80I_INC_BC,		// 00-03
+	Z80I_INC_B, Z80I_DEC_B, Z80I_LD_B_N, Z80I_RLCA,		// 04-07
+	Z80I_EX_AF_AF2, Z80I_ADD_IX_BC, Z80I_LD_A_mBC, Z80I_DEC_BC,		// 08-0B
+	Z80I_INC_C, Z80I_DEC_C, Z80I_LD_C_N, Z80I_RRCA,		// 0C-0F
+	Z80I_DJNZ, Z80I_LD_DE_NN, Z80I_LD_mDE_A, Z80I_INC_DE,		// 10-13
+	Z80I_INC_D, Z80I_DEC_D, Z80I_LD_D_N, Z80I_RLA,		// 14-17
+	Z80I_JR_N, Z80I_ADD_IX_DE, Z80I_LD_A_mDE, Z80I_DEC_DE,		// 18-1B
+	Z80I_DEC_E, Z80I_INC_E, Z80I_LD_E_N, Z80I_RRA,		// 1C-1F
+	Z80I_JRNZ_N, Z80I_LD_IX_NN, Z80I_LD_mNN_IX, Z80I_INC_IX,		// 20-23
+	Z80I_INC_hIX, Z80I_DEC_hIX, Z80I_LD_hIX_N, Z80I_DAA,		// 24-27
+	Z80I_JRZ_N, Z80I_ADD_IX_IX, Z80I_LD_IX_mNN, Z80I_DEC_IX,		// 28-2B
+	Z80I_INC_lIX, Z80I_DEC_lIX, Z80I_LD_lIX_N, Z80I_CPL,		// 2C-2F
+	Z80I_JRNC_N, Z80I_LD_SP_NN, Z80I_LD_mNN_A, Z80I_INC_SP,		// 30-33
+	Z80I_INC_mIXd, Z80I_DEC_mIXd, Z80I_LD_mIXd_N, Z80I_SCF,		// 34-37
+	Z80I_JRC_N, Z80I_ADD_IX_SP, Z80I_LD_A_mNN, Z80I_DEC_SP,		// 38-3B
+	Z80I_INC_A, Z80I_DEC_A, Z80I_LD_A_N, Z80I_CCF,		// 3C-3F
+	Z80I_LD_B_B, Z80I_LD_B_C, Z80I_LD_B_D, Z80I_LD_B_E,		// 40-43
+	Z80I_LD_B_hIX, Z80I_LD_B_lIX, Z80I_LD_B_mIXd, Z80I_LD_B_A,		// 44-47
+	Z80I_LD_C_B, Z80I_LD_C_C, Z80I_LD_C_D, Z80I_LD_C_E,		// 48-4B
+	Z80I_LD_C_hIX, Z80I_LD_C_lIX, Z80I_LD_C_mIXd, Z80I_LD_C_A,		// 4C-4F
+	Z80I_LD_D_B, Z80I_LD_D_C, Z80I_LD_D_D, Z80I_LD_D_E,		// 50-53
+	Z80I_LD_D_hIX, Z80I_LD_D_lIX, Z80I_LD_D_mIXd, Z80I_LD_D_A,		// 54-57
+	Z80I_LD_E_B, Z80I_LD_E_C, Z80I_LD_E_D, Z80I_LD_E_E,		// 58-5B
+	Z80I_LD_E_hIX, Z80I_LD_E_lIX, Z80I_LD_E_mIXd, Z80I_LD_E_A,		// 5C-5F
+	Z80I_LD_hIX_B, Z80I_LD_hIX_C, Z80I_LD_hIX_D, Z80I_LD_hIX_E,		// 60-63
+	Z80I_LD_hIX_hIX, Z80I_LD_hIX_L, Z80I_LD_H_mIXd, Z80I_LD_hIX_A,		// 64-67
+	Z80I_LD_lIX_B, Z80I_LD_lIX_C, Z80I_LD_lIX_D, Z80I_LD_lIX_E,		// 68-6B
+	Z80I_LD_lIX_H, Z80I_LD_lIX_lIX, Z80I_LD_L_mIXd, Z80I_LD_lIX_A,		// 6C-6F
+	Z80I_LD_mIXd_B, Z80I_LD_mIXd_C, Z80I_LD_mIXd_D, Z80I_LD_mIXd_E,		// 70-73
+	Z80I_LD_mIXd_H, Z80I_LD_mIXd_L, Z80I_HALT, Z80I_LD_mIXd_A,		// 74-77
+	Z80I_LD_A_B, Z80I_LD_A_C, Z80I_LD_A_D, Z80I_LD_A_E,		// 78-7B
+	Z80I_LD_A_hIX, Z80I_LD_A_lIX, Z80I_LD_A_mIXd, Z80I_LD_A_A,		// 7C-7F
+	Z80I_ADD_B, Z80I_ADD_C, Z80I_ADD_D, Z80I_ADD_E,		// 80-83
+	Z80I_ADD_hIX, Z80I_ADD_lIX, Z80I_ADD_mIXd, Z80I_ADD_A,		// 84-87
+	Z80I_ADC_B, Z80I_ADC_C, Z80I_ADC_D, Z80I_ADC_E,		// 88-8B
+	Z80I_ADC_hIX, Z80I_ADC_lIX, Z80I_ADC_mIXd, Z80I_ADC_A,		// 8C-8F
+	Z80I_SUB_B, Z80I_SUB_C, Z80I_SUB_D, Z80I_SUB_E,		// 90-93
+	Z80I_SUB_hIX, Z80I_SUB_lIX, Z80I_SUB_mIXd, Z80I_SUB_A,		// 94-97
+	Z80I_SBC_B, Z80I_SBC_C, Z80I_SBC_D, Z80I_SBC_E,		// 98-9B
+	Z80I_SBC_hIX, Z80I_SBC_lIX, Z80I_SBC_mIXd, Z80I_SBC_A,		// 9C-9F
+	Z80I_AND_B, Z80I_AND_C, Z80I_AND_D, Z80I_AND_E,		// A0-A3
+	Z80I_AND_hIX, Z80I_AND_lIX, Z80I_AND_mIXd, Z80I_AND_A,		// A4-A7
+	Z80I_XOR_B, Z80I_XOR_C, Z80I_XOR_D, Z80I_XOR_E,		// A8-AB
+	Z80I_XOR_hIX, Z80I_XOR_lIX, Z80I_XOR_mIXd, Z80I_XOR_A,		// AC-AF
+	Z80I_OR_B, Z80I_OR_C, Z80I_OR_D, Z80I_OR_E,		// B0-B3
+	Z80I_OR_hIX, Z80I_OR_lIX, Z80I_OR_mIXd, Z80I_OR_A,		// B4-B7
+	Z80I_CP_B, Z80I_CP_C, Z80I_CP_D, Z80I_CP_E,		// B8-BB
+	Z80I_CP_hIX, Z80I_CP_lIX, Z80I_CP_mIXd, Z80I_CP_A,		// BC-BF
+	Z80I_RETNZ, Z80I_POP_BC, Z80I_JPNZ_NN, Z80I_JP_NN,		// C0-C3
+	Z80I_CALLNZ_NN, Z80I_PUSH_BC, Z80I_ADD_N, Z80I_RST,		// C4-C7
+	Z80I_RETZ, Z80I_RET, Z80I_JPZ_NN, PREFIXE_DDCB,		// C8-CB
+	Z80I_CALLZ_NN, Z80I_CALL_NN, Z80I_ADC_N, Z80I_RST,		// CC-CF
+	Z80I_RETNC, Z80I_POP_DE, Z80I_JPNC_NN, Z80I_OUT_mN,		// D0-D3
+	Z80I_CALLNC_NN, Z80I_PUSH_DE, Z80I_SUB_N, Z80I_RST,		// D4-D7
+	Z80I_RETC, Z80I_EXX, Z80I_JPC_NN, Z80I_IN_mN,		// D8-DB
+	Z80I_CALLC_NN, PREFIXE_DD, Z80I_SBC_N, Z80I_RST,		// DC-DF
+	Z80I_RETNP, Z80I_POP_IX, Z80I_JPNP_NN, Z80I_EX_mSP_IX,		// E0-E3
+	Z80I_CALLNP_NN, Z80I_PUSH_IX, Z80I_AND_N, Z80I_RST,		// E4-E7
+	Z80I_RETP, Z80I_JP_IX, Z80I_JPP_NN, Z80I_EX_DE_HL,		// E8-EB
+	Z80I_CALLP_NN, PREFIXE_ED, Z80I_XOR_N, Z80I_RST,		// EC-EF
+	Z80I_RETNS, Z80I_POP_AF, Z80I_JPNS_NN, Z80I_DI,		// F0-F3
+	Z80I_CALLNS_NN, Z80I_PUSH_AF, Z80I_OR_N, Z80I_RST,		// F4-F7
+	Z80I_RETS, Z80I_LD_SP_IX, Z80I_JPS_NN, Z80I_EI,		// F8-FB
+	Z80I_CALLNS_NN, PREFIXE_FD, Z80I_CP_N, Z80I_RST		// FC-FF
+};
+
+static const Z80C_OP DDCB_Table[256] =
+{
+	Z80I_RLC_mIXd_B, Z80I_RLC_mIXd_C, Z80I_RLC_mIXd_D, Z80I_RLC_mIXd_E,		// 00-03
+	Z80I_RLC_mIXd_H, Z80I_RLC_mIXd_L, Z80I_RLC_mIXd, Z80I_RLC_mIXd_A,		// 04-07
+	Z80I_RRC_mIXd_B, Z80I_RRC_mIXd_C, Z80I_RRC_mIXd_D, Z80I_RRC_mIXd_E,		// 08-0B
+	Z80I_RRC_mIXd_H, Z80I_RRC_mIXd_L, Z80I_RRC_mIXd, Z80I_RRC_mIXd_A,		// 0C-0F
+	Z80I_RL_mIXd_B, Z80I_RL_mIXd_C, Z80I_RL_mIXd_D, Z80I_RL_mIXd_E,		// 10-13
+	Z80I_RL_mIXd_H, Z80I_RL_mIXd_L, Z80I_RL_mIXd, Z80I_RL_mIXd_A,		// 14-17
+	Z80I_RR_mIXd_B, Z80I_RR_mIXd_C, Z80I_RR_mIXd_D, Z80I_RR_mIXd_E,		// 18-1B
+	Z80I_RR_mIXd_H, Z80I_RR_mIXd_L, Z80I_RR_mIXd, Z80I_RR_mIXd_A,		// 1C-1F
+	Z80I_SLA_mIXd_B, Z80I_SLA_mIXd_C, Z80I_SLA_mIXd_D, Z80I_SLA_mIXd_E,		// 20-23
+	Z80I_SLA_mIXd_H, Z80I_SLA_mIXd_L, Z80I_SLA_mIXd, Z80I_SLA_mIXd_A,		// 24-27
+	Z80I_SRA_mIXd_B, Z80I_SRA_mIXd_C, Z80I_SRA_mIXd_D, Z80I_SRA_mIXd_E,		// 28-2B
+	Z80I_SRA_mIXd_H, Z80I_SRA_mIXd_L, Z80I_SRA_mIXd, Z80I_SRA_mIXd_A,		// 2C-2F
+	Z80I_SLL_mIXd_B, Z80I_SLL_mIXd_C, Z80I_SLL_mIXd_D, Z80I_SLL_mIXd_E,		// 30-33
+	Z80I_SLL_mIXd_H, Z80I_SLL_mIXd_L, Z80I_SLL_mIXd, Z80I_SLL_mIXd_A,		// 34-37
+	Z80I_SRL_mIXd_B, Z80I_SRL_mIXd_C, Z80I_SRL_mIXd_D, Z80I_SRL_mIXd_E,		// 38-3B
+	Z80I_SRL_mIXd_H, Z80I_SRL_mIXd_L, Z80I_SRL_mIXd, Z80I_SRL_mIXd_A,		// 3C-3F
+	Z80I_BIT0_B, Z80I_BIT0_C, Z80I_BIT0_D, Z80I_BIT0_E,		// 40-43
+	Z80I_BIT0_H, Z80I_BIT0_L, Z80I_BIT0_mIXd, Z80I_BIT0_A,		// 44-47
+	Z80I_BIT1_B, Z80I_BIT1_C, Z80I_BIT1_D, Z80I_BIT1_E,		// 48-4B
+	Z80I_BIT1_H, Z80I_BIT1_L, Z80I_BIT1_mIXd, Z80I_BIT1_A,		// 4C-4F
+	Z80I_BIT2_B, Z80I_BIT2_C, Z80I_BIT2_D, Z80I_BIT2_E,		// 50-53
+	Z80I_BIT2_H, Z80I_BIT2_L, Z80I_BIT2_mIXd, Z80I_BIT2_A,		// 54-57
+	Z80I_BIT3_B, Z80I_BIT3_C, Z80I_BIT3_D, Z80I_BIT3_E,		// 58-5B
+	Z80I_BIT3_H, Z80I_BIT3_L, Z80I_BIT3_mIXd, Z80I_BIT3_A,		// 5C-5F
+	Z80I_BIT4_B, Z80I_BIT4_C, Z80I_BIT4_D, Z80I_BIT4_E,		// 60-63
+	Z80I_BIT4_H, Z80I_BIT4_L, Z80I_BIT4_mIXd, Z80I_BIT4_A,		// 64-67
+	Z80I_BIT5_B, Z80I_BIT5_C, Z80I_BIT5_D, Z80I_BIT5_E,		// 68-6B
+	Z80I_BIT5_H, Z80I_BIT5_L, Z80I_BIT5_mIXd, Z80I_BIT5_A,		// 6C-6F
+	Z80I_BIT6_B, Z80I_BIT6_C, Z80I_BIT6_D, Z80I_BIT6_E,		// 70-73
+	Z80I_BIT6_H, Z80I_BIT6_L, Z80I_BIT6_mIXd, Z80I_BIT6_A,		// 74-77
+	Z80I_BIT7_B, Z80I_BIT7_C, Z80I_BIT7_D, Z80I_BIT7_E,		// 78-7B
+	Z80I_BIT7_H, Z80I_BIT7_L, Z80I_BIT7_mIXd, Z80I_BIT7_A,		// 7C-7F
+	Z80I_RES0_mIXd_B, Z80I_RES0_mIXd_C, Z80I_RES0_mIXd_D, Z80I_RES0_mIXd_E,		// 80-83
+	Z80I_RES0_mIXd_H, Z80I_RES0_mIXd_L, Z80I_RES0_mIXd, Z80I_RES0_mIXd_A,		// 84-87
+	Z80I_RES1_mIXd_B, Z80I_RES1_mIXd_C, Z80I_RES1_mIXd_D, Z80I_RES1_mIXd_E,		// 88-8B
+	Z80I_RES1_mIXd_H, Z80I_RES1_mIXd_L, Z80I_RES1_mIXd, Z80I_RES1_mIXd_A,		// 8C-8F
+	Z80I_RES2_mIXd_B, Z80I_RES2_mIXd_C, Z80I_RES2_mIXd_D, Z80I_RES2_mIXd_E,		// 90-93
+	Z80I_RES2_mIXd_H, Z80I_RES2_mIXd_L, Z80I_RES2_mIXd, Z80I_RES2_mIXd_A,		// 94-97
+	Z80I_RES3_mIXd_B, Z80I_RES3_mIXd_C, Z80I_RES3_mIXd_D, Z80I_RES3_mIXd_E,		// 98-9B
+	Z80I_RES3_mIXd_H, Z80I_RES3_mIXd_L, Z80I_RES3_mIXd, Z80I_RES3_mIXd_A,		// 9C-9F
+	Z80I_RES4_mIXd_B, Z80I_RES4_mIXd_C, Z80I_RES4_mIXd_D, Z80I_RES4_mIXd_E,		// A0-A3
+	Z80I_RES4_mIXd_H, Z80I_RES4_mIXd_L, Z80I_RES4_mIXd, Z80I_RES4_mIXd_A,		// A4-A7
+	Z80I_RES5_mIXd_B, Z80I_RES5_mIXd_C, Z80I_RES5_mIXd_D, Z80I_RES5_mIXd_E,		// A8-AB
+	Z80I_RES5_mIXd_H, Z80I_RES5_mIXd_L, Z80I_RES5_mIXd, Z80I_RES5_mIXd_A,		// AC-AF
+	Z80I_RES6_mIXd_B, Z80I_RES6_mIXd_C, Z80I_RES6_mIXd_D, Z80I_RES6_mIXd_E,		// B0-B3
+	Z80I_RES6_mIXd_H, Z80I_RES6_mIXd_L, Z80I_RES6_mIXd, Z80I_RES6_mIXd_A,		// B4-B7
+	Z80I_RES7_mIXd_B, Z80I_RES7_mIXd_C, Z80I_RES7_mIXd_D, Z80I_RES7_mIXd_E,		// B8-BB
+	Z80I_RES7_mIXd_H, Z80I_RES7_mIXd_L, Z80I_RES7_mIXd, Z80I_RES7_mIXd_A,		// BC-BF
+	Z80I_SET0_mIXd_B, Z80I_SET0_mIXd_C, Z80I_SET0_mIXd_D, Z80I_SET0_mIXd_E,		// C0-C3
+	Z80I_SET0_mIXd_H, Z80I_SET0_mIXd_L, Z80I_SET0_mIXd, Z80I_SET0_mIXd_A,		// C4-C7
+	Z80I_SET1_mIXd_B, Z80I_SET1_mIXd_C, Z80I_SET1_mIXd_D, Z80I_SET1_mIXd_E,		// C8-CB
+	Z80I_SET1_mIXd_H, Z80I_SET1_mIXd_L, Z80I_SET1_mIXd, Z80I_SET1_mIXd_A,		// CC-CF
+	Z80I_SET2_mIXd_B, Z80I_SET2_mIXd_C, Z80I_SET2_mIXd_D, Z80I_SET2_mIXd_E,		// D0-D3
+	Z80I_SET2_mIXd_H, Z80I_SET2_mIXd_L, Z80I_SET2_mIXd, Z80I_SET2_mIXd_A,		// D4-D7
+	Z80I_SET3_mIXd_B, Z80I_SET3_mIXd_C, Z80I_SET3_mIXd_D, Z80I_SET3_mIXd_E,		// D8-DB
+	Z80I_SET3_mIXd_H, Z80I_SET3_mIXd_L, Z80I_SET3_mIXd, Z80I_SET3_mIXd_A,		// DC-DF
+	Z80I_SET4_mIXd_B, Z80I_SET4_mIXd_C, Z80I_SET4_mIXd_D, Z80I_SET4_mIXd_E,		// E0-E3
+	Z80I_SET4_mIXd_H, Z80I_SET4_mIXd_L, Z80I_SET4_mIXd, Z80I_SET4_mIXd_A,		// E4-E7
+	Z80I_SET5_mIXd_B, Z80I_SET5_mIXd_C, Z80I_SET5_mIXd_D, Z80I_SET5_mIXd_E,		// E8-EB
+	Z80I_SET5_mIXd_H, Z80I_SET5_mIXd_L, Z80I_SET5_mIXd, Z80I_SET5_mIXd_A,		// EC-EF
+	Z80I_SET6_mIXd_B, Z80I_SET6_mIXd_C, Z80I_SET6_mIXd_D, Z80I_SET6_mIXd_E,		// F0-F3
+	Z80I_SET6_mIXd_H, Z80I_SET6_mIXd_L, Z80I_SET6_mIXd, Z80I_SET6_mIXd_A,		// F4-F7
+	Z80I_SET7_mIXd_B, Z80I_SET7_mIXd_C, Z80I_SET7_mIXd_D, Z80I_SET7_mIXd_E,		// F8-FB
+	Z80I_SET7_mIXd_H, Z80I_SET7_mIXd_L, Z80I_SET7_mIXd, Z80I_SET7_mIXd_A		// FC-FF
+};
+
+static const Z80C_OP FD_Table[256] =
+{
+	Z80I_NOP, Z80I_LD_BC_NN, Z80I_LD_mBC_A, Z80I_INC_BC,		// 00-03
+	Z80I_INC_B, Z80I_DEC_B, Z80I_LD_B_N, Z80I_RLCA,		// 04-07
+	Z80I_EX_AF_AF2, Z80I_ADD_IY_BC, Z80I_LD_A_mBC, Z80I_DEC_BC,		// 08-0B
+	Z80I_INC_C, Z80I_DEC_C, Z80I_LD_C_N, Z80I_RRCA,		// 0C-0F
+	Z80I_DJNZ, Z80I_LD_DE_NN, Z80I_LD_mDE_A, Z80I_INC_DE,		// 10-13
+	Z80I_INC_D, Z80I_DEC_D, Z80I_LD_D_N, Z80I_RLA,		// 14-17
+	Z80I_JR_N, Z80I_ADD_IY_DE, Z80I_LD_A_mDE, Z80I_DEC_DE,		// 18-1B
+	Z80I_DEC_E, Z80I_INC_E, Z80I_LD_E_N, Z80I_RRA,		// 1C-1F
+	Z80I_JRNZ_N, Z80I_LD_IY_NN, Z80I_LD_mNN_IY, Z80I_INC_IY,		// 20-23
+	Z80I_INC_hIY, Z80I_DEC_hIY, Z80I_LD_hIY_N, Z80I_DAA,		// 24-27
+	Z80I_JRZ_N, Z80I_ADD_IY_IY, Z80I_LD_IY_mNN, Z80I_DEC_IY,		// 28-2B
+	Z80I_INC_lIY, Z80I_DEC_lIY, Z80I_LD_lIY_N, Z80I_CPL,		// 2C-2F
+	Z80I_JRNC_N, Z80I_LD_SP_NN, Z80I_LD_mNN_A, Z80I_INC_SP,		// 30-33
+	Z80I_INC_mIYd, Z80I_DEC_mIYd, Z80I_LD_mIYd_N, Z80I_SCF,		// 34-37
+	Z80I_JRC_N, Z80I_ADD_IY_SP, Z80I_LD_A_mNN, Z80I_DEC_SP,		// 38-3B
+	Z80I_INC_A, Z80I_DEC_A, Z80I_LD_A_N, Z80I_CCF,		// 3C-3F
+	Z80I_LD_B_B, Z80I_LD_B_C, Z80I_LD_B_D, Z80I_LD_B_E,		// 40-43
+	Z80I_LD_B_hIY, Z80I_LD_B_lIY, Z80I_LD_B_mIYd, Z80I_LD_B_A,		// 44-47
+	Z80I_LD_C_B, Z80I_LD_C_C, Z80I_LD_C_D, Z80I_LD_C_E,		// 48-4B
+	Z80I_LD_C_hIY, Z80I_LD_C_lIY, Z80I_LD_C_mIYd, Z80I_LD_C_A,		// 4C-4F
+	Z80I_LD_D_B, Z80I_LD_D_C, Z80I_LD_D_D, Z80I_LD_D_E,		// 50-53
+	Z80I_LD_D_hIY, Z80I_LD_D_lIY, Z80I_LD_D_mIYd, Z80I_LD_D_A,		// 54-57
+	Z80I_LD_E_B, Z80I_LD_E_C, Z80I_LD_E_D, Z80I_LD_E_E,		// 58-5B
+	Z80I_LD_E_hIY, Z80I_LD_E_lIY, Z80I_LD_E_mIYd, Z80I_LD_E_A,		// 5C-5F
+	Z80I_LD_hIY_B, Z80I_LD_hIY_C, Z80I_LD_hIY_D, Z80I_LD_hIY_E,		// 60-63
+	Z80I_LD_hIY_hIY, Z80I_LD_hIY_L, Z80I_LD_H_mIYd, Z80I_LD_hIY_A,		// 64-67
+	Z80I_LD_lIY_B, Z80I_LD_lIY_C, Z80I_LD_lIY_D, Z80I_LD_lIY_E,		// 68-6B
+	Z80I_LD_lIY_H, Z80I_LD_lIY_lIY, Z80I_LD_L_mIYd, Z80I_LD_lIY_A,		// 6C-6F
+	Z80I_LD_mIYd_B, Z80I_LD_mIYd_C, Z80I_LD_mIYd_D, Z80I_LD_mIYd_E,		// 70-73
+	Z80I_LD_mIYd_H, Z80I_LD_mIYd_L, Z80I_HALT, Z80I_LD_mIYd_A,		// 74-77
+	Z80I_LD_A_B, Z80I_LD_A_C, Z80I_LD_A_D, Z80I_LD_A_E,		// 78-7B
+	Z80I_LD_A_hIY, Z80I_LD_A_lIY, Z80I_LD_A_mIYd, Z80I_LD_A_A,		// 7C-7F
+	Z80I_ADD_B, Z80I_ADD_C, Z80I_ADD_D, Z80I_ADD_E,		// 80-83
+	Z80I_ADD_hIY, Z80I_ADD_lIY, Z80I_ADD_mIYd, Z80I_ADD_A,		// 84-87
+	Z80I_ADC_B, Z80I_ADC_C, Z80I_ADC_D, Z80I_ADC_E,		// 88-8B
+	Z80I_ADC_hIY, Z80I_ADC_lIY, Z80I_ADC_mIYd, Z80I_ADC_A,		// 8C-8F
+	Z80I_SUB_B, Z80I_SUB_C, Z80I_SUB_D, Z80I_SUB_E,		// 90-93
+	Z80I_SUB_hIY, Z80I_SUB_lIY, Z80I_SUB_mIYd, Z80I_SUB_A,		// 94-97
+	Z80I_SBC_B, Z80I_SBC_C, Z80I_SBC_D, Z80I_SBC_E,		// 98-9B
+	Z80I_SBC_hIY, Z80I_SBC_lIY, Z80I_SBC_mIYd, Z80I_SBC_A,		// 9C-9F
+	Z80I_AND_B, Z80I_AND_C, Z80I_AND_D, Z80I_AND_E,		// A0-A3
+	Z80I_AND_hIY, Z80I_AND_lIY, Z80I_AND_mIYd, Z80I_AND_A,		// A4-A7
+	Z80I_XOR_B, Z80I_XOR_C, Z80I_XOR_D, Z80I_XOR_E,		// A8-AB
+	Z80I_XOR_hIY, Z80I_XOR_lIY, Z80I_XOR_mIYd, Z80I_XOR_A,		// AC-AF
+	Z80I_OR_B, Z80I_OR_C, Z80I_OR_D, Z80I_OR_E,		// B0-B3
+	Z80I_OR_hIY, Z80I_OR_lIY, Z80I_OR_mIYd, Z80I_OR_A,		// B4-B7
+	Z80I_CP_B, Z80I_CP_C, Z80I_CP_D, Z80I_CP_E,		// B8-BB
+	Z80I_CP_hIY, Z80I_CP_lIY, Z80I_CP_mIYd, Z80I_CP_A,		// BC-BF
+	Z80I_RETNZ, Z80I_POP_BC, Z80I_JPNZ_NN, Z80I_JP_NN,		// C0-C3
+	Z80I_CALLNZ_NN, Z80I_PUSH_BC, Z80I_ADD_N, Z80I_RST,		// C4-C7
+	Z80I_RETZ, Z80I_RET, Z80I_JPZ_NN, PREFIXE_FDCB,		// C8-CB
+	Z80I_CALLZ_NN, Z80I_CALL_NN, Z80I_ADC_N, Z80I_RST,		// CC-CF
+	Z80I_RETNC, Z80I_POP_DE, Z80I_JPNC_NN, Z80I_OUT_mN,		// D0-D3
+	Z80I_CALLNC_NN, Z80I_PUSH_DE, Z80I_SUB_N, Z80I_RST,		// D4-D7
+	Z80I_RETC, Z80I_EXX, Z80I_JPC_NN, Z80I_IN_mN,		// D8-DB
+	Z80I_CALLC_NN, PREFIXE_DD, Z80I_SBC_N, Z80I_RST,		// DC-DF
+	Z80I_RETNP, Z80I_POP_IY, Z80I_JPNP_NN, Z80I_EX_mSP_IY,		// E0-E3
+	Z80I_CALLNP_NN, Z80I_PUSH_IY, Z80I_AND_N, Z80I_RST,		// E4-E7
+	Z80I_RETP, Z80I_JP_IY, Z80I_JPP_NN, Z80I_EX_DE_HL,		// E8-EB
+	Z80I_CALLP_NN, PREFIXE_ED, Z80I_XOR_N, Z80I_RST,		// EC-EF
+	Z80I_RETNS, Z80I_POP_AF, Z80I_JPNS_NN, Z80I_DI,		// F0-F3
+	Z80I_CALLNS_NN, Z80I_PUSH_AF, Z80I_OR_N, Z80I_RST,		// F4-F7
+	Z80I_RETS, Z80I_LD_SP_IY, Z80I_JPS_NN, Z80I_EI,		// F8-FB
+	Z80I_CALLNS_NN, PREFIXE_FD, Z80I_CP_N, Z80I_RST		// FC-FF
+};
+
+static const Z80C_OP FDCB_Table[256] =
+{
+	Z80I_RLC_mIYd_B, Z80I_RLC_mIYd_C, Z80I_RLC_mIYd_D, Z80I_RLC_mIYd_E,		// 00-03
+	Z80I_RLC_mIYd_H, Z80I_RLC_mIYd_L, Z80I_RLC_mIYd, Z80I_RLC_mIYd_A,		// 04-07
+	Z80I_RRC_mIYd_B, Z80I_RRC_mIYd_C, Z80I_RRC_mIYd_D, Z80I_RRC_mIYd_E,		// 08-0B
+	Z80I_RRC_mIYd_H, Z80I_RRC_mIYd_L, Z80I_RRC_mIYd, Z80I_RRC_mIYd_A,		// 0C-0F
+	Z80I_RL_mIYd_B, Z80I_RL_mIYd_C, Z80I_RL_mIYd_D, Z80I_RL_mIYd_E,		// 10-13
+	Z80I_RL_mIYd_H, Z80I_RL_mIYd_L, Z80I_RL_mIYd, Z80I_RL_mIYd_A,		// 14-17
+	Z80I_RR_mIYd_B, Z80I_RR_mIYd_C, Z80I_RR_mIYd_D, Z80I_RR_mIYd_E,		// 18-1B
+	Z80I_RR_mIYd_H, Z80I_RR_mIYd_L, Z80I_RR_mIYd, Z80I_RR_mIYd_A,		// 1C-1F
+	Z80I_SLA_mIYd_B, Z80I_SLA_mIYd_C, Z80I_SLA_mIYd_D, Z80I_SLA_mIYd_E,		// 20-23
+	Z80I_SLA_mIYd_H, Z80I_SLA_mIYd_L, Z80I_SLA_mIYd, Z80I_SLA_mIYd_A,		// 24-27
+	Z80I_SRA_mIYd_B, Z80I_SRA_mIYd_C, Z80I_SRA_mIYd_D, Z80I_SRA_mIYd_E,		// 28-2B
+	Z80I_SRA_mIYd_H, Z80I_SRA_mIYd_L, Z80I_SRA_mIYd, Z80I_SRA_mIYd_A,		// 2C-2F
+	Z80I_SLL_mIYd_B, Z80I_SLL_mIYd_C, Z80I_SLL_mIYd_D, Z80I_SLL_mIYd_E,		// 30-33
+	Z80I_SLL_mIYd_H, Z80I_SLL_mIYd_L, Z80I_SLL_mIYd, Z80I_SLL_mIYd_A,		// 34-37
+	Z80I_SRL_mIYd_B, Z80I_SRL_mIYd_C, Z80I_SRL_mIYd_D, Z80I_SRL_mIYd_E,		// 38-3B
+	Z80I_SRL_mIYd_H, Z80I_SRL_mIYd_L, Z80I_SRL_mIYd, Z80I_SRL_mIYd_A,		// 3C-3F
+	Z80I_BIT0_B, Z80I_BIT0_C, Z80I_BIT0_D, Z80I_BIT0_E,		// 40-43
+	Z80I_BIT0_H, Z80I_BIT0_L, Z80I_BIT0_mIYd, Z80I_BIT0_A,		// 44-47
+	Z80I_BIT1_B, Z80I_BIT1_C, Z80I_BIT1_D, Z80I_BIT1_E,		// 48-4B
+	Z80I_BIT1_H, Z80I_BIT1_L, Z80I_BIT1_mIYd, Z80I_BIT1_A,		// 4C-4F
+	Z80I_BIT2_B, Z80I_BIT2_C, Z80I_BIT2_D, Z80I_BIT2_E,		// 50-53
+	Z80I_BIT2_H, Z80I_BIT2_L, Z80I_BIT2_mIYd, Z80I_BIT2_A,		// 54-57
+	Z80I_BIT3_B, Z80I_BIT3_C, Z80I_BIT3_D, Z80I_BIT3_E,		// 58-5B
+	Z80I_BIT3_H, Z80I_BIT3_L, Z80I_BIT3_mIYd, Z80I_BIT3_A,		// 5C-5F
+	Z80I_BIT4_B, Z80I_BIT4_C, Z80I_BIT4_D, Z80I_BIT4_E,		// 60-63
+	Z80I_BIT4_H, Z80I_BIT4_L, Z80I_BIT4_mIYd, Z80I_BIT4_A,		// 64-67
+	Z80I_BIT5_B, Z80I_BIT5_C, Z80I_BIT5_D, Z80I_BIT5_E,		// 68-6B
+	Z80I_BIT5_H, Z80I_BIT5_L, Z80I_BIT5_mIYd, Z80I_BIT5_A,		// 6C-6F
+	Z80I_BIT6_B, Z80I_BIT6_C, Z80I_BIT6_D, Z80I_BIT6_E,		// 70-73
+	Z80I_BIT6_H, Z80I_BIT6_L, Z80I_BIT6_mIYd, Z80I_BIT6_A,		// 74-77
+	Z80I_BIT7_B, Z80I_BIT7_C, Z80I_BIT7_D, Z80I_BIT7_E,		// 78-7B
+	Z80I_BIT7_H, Z80I_BIT7_L, Z80I_BIT7_mIYd, Z80I_BIT7_A,		// 7C-7F
+	Z80I_RES0_mIYd_B, Z80I_RES0_mIYd_C, Z80I_RES0_mIYd_D, Z80I_RES0_mIYd_E,		// 80-83
+	Z80I_RES0_mIYd_H, Z80I_RES0_mIYd_L, Z80I_RES0_mIYd, Z80I_RES0_mIYd_A,		// 84-87
+	Z80I_RES1_mIYd_B, Z80I_RES1_mIYd_C, Z80I_RES1_mIYd_D, Z80I_RES1_mIYd_E,		// 88-8B
+	Z80I_RES1_mIYd_H, Z80I_RES1_mIYd_L, Z80I_RES1_mIYd, Z80I_RES1_mIYd_A,		// 8C-8F
+	Z80I_RES2_mIYd_B, Z80I_RES2_mIYd_C, Z80I_RES2_mIYd_D, Z80I_RES2_mIYd_E,		// 90-93
+	Z80I_RES2_mIYd_H, Z80I_RES2_mIYd_L, Z80I_RES2_mIYd, Z80I_RES2_mIYd_A,		// 94-97
+	Z80I_RES3_mIYd_B, Z80I_RES3_mIYd_C, Z80I_RES3_mIYd_D, Z80I_RES3_mIYd_E,		// 98-9B
+	Z80I_RES3_mIYd_H, Z80I_RES3_mIYd_L, Z80I_RES3_mIYd, Z80I_RES3_mIYd_A,		// 9C-9F
+	Z80I_RES4_mIYd_B, Z80I_RES4_mIYd_C, Z80I_RES4_mIYd_D, Z80I_RES4_mIYd_E,		// A0-A3
+	Z80I_RES4_mIYd_H, Z80I_RES4_mIYd_L, Z80I_RES4_mIYd, Z80I_RES4_mIYd_A,		// A4-A7
+	Z80I_RES5_mIYd_B, Z80I_RES5_mIYd_C, Z80I_RES5_mIYd_D, Z80I_RES5_mIYd_E,		// A8-AB
+	Z80I_RES5_mIYd_H, Z80I_RES5_mIYd_L, Z80I_RES5_mIYd, Z80I_RES5_mIYd_A,		// AC-AF
+	Z80I_RES6_mIYd_B, Z80I_RES6_mIYd_C, Z80I_RES6_mIYd_D, Z80I_RES6_mIYd_E,		// B0-B3
+	Z80I_RES6_mIYd_H, Z80I_RES6_mIYd_L, Z80I_RES6_mIYd, Z80I_RES6_mIYd_A,		// B4-B7
+	Z80I_RES7_mIYd_B, Z80I_RES7_mIYd_C, Z80I_RES7_mIYd_D, Z80I_RES7_mIYd_E,		// B8-BB
+	Z80I_RES7_mIYd_H, Z80I_RES7_mIYd_L, Z80I_RES7_mIYd, Z80I_RES7_mIYd_A,		// BC-BF
+	Z80I_SET0_mIYd_B, Z80I_SET0_mIYd_C, Z80I_SET0_mIYd_D, Z80I_SET0_mIYd_E,		// C0-C3
+	Z80I_SET0_mIYd_H, Z80I_SET0_mIYd_L, Z80I_SET0_mIYd, Z80I_SET0_mIYd_A,		// C4-C7
+	Z80I_SET1_mIYd_B, Z80I_SET1_mIYd_C, Z80I_SET1_mIYd_D, Z80I_SET1_mIYd_E,		// C8-CB
+	Z80I_SET1_mIYd_H, Z80I_SET1_mIYd_L, Z80I_SET1_mIYd, Z80I_SET1_mIYd_A,		// CC-CF
+	Z80I_SET2_mIYd_B, Z80I_SET2_mIYd_C, Z80I_SET2_mIYd_D, Z80I_SET2_mIYd_E,		// D0-D3
+	Z80I_SET2_mIYd_H, Z80I_SET2_mIYd_L, Z80I_SET2_mIYd, Z80I_SET2_mIYd_A,		// D4-D7
+	Z80I_SET3_mIYd_B, Z80I_SET3_mIYd_C, Z80I_SET3_mIYd_D, Z80I_SET3_mIYd_E,		// D8-DB
+	Z80I_SET3_mIYd_H, Z80I_SET3_mIYd_L, Z80I_SET3_mIYd, Z80I_SET3_mIYd_A,		// DC-DF
+	Z80I_SET4_mIYd_B, Z80I_SET4_mIYd_C, Z80I_SET4_mIYd_D, Z80I_SET4_mIYd_E,		// E0-E3
+	Z80I_SET4_mIYd_H, Z80I_SET4_mIYd_L, Z80I_SET4_mIYd, Z80I_SET4_mIYd_A,		// E4-E7
+	Z80I_SET5_mIYd_B, Z80I_SET5_mIYd_C, Z80I_SET5_mIYd_D, Z80I_SET5_mIYd_E,		// E8-EB
+	Z80I_SET5_mIYd_H, Z80I_SET5_mIYd_L, Z80I_SET5_mIYd, Z80I_SET5_mIYd_A,		// EC-EF
+	Z80I_SET6_mIYd_B, Z80I_SET6_mIYd_C, Z80I_SET6_mIYd_D, Z80I_SET6_mIYd_E,		// F0-F3
+	Z80I_SET6_mIYd_H, Z80I_SET6_mIYd_L, Z80I_SET6_mIYd, Z80I_SET6_mIYd_A,		// F4-F7
+	Z80I_SET7_mIYd_B, Z80I_SET7_mIYd_C, Z80I_SET7_mIYd_D, Z80I_SET7_mIYd_E,		// F8-FB
+	Z80I_SET7_mIYd_H, Z80I_SET7_mIYd_L, Z80I_SET7_mIYd, Z80I_SET7_mIYd_A		// FC-FF
+};
+
+
+// Prefixes: DD and FD take 4 cycles, CB and ED cost nothing by themselves
+
+static int PREFIXE_CB(void)
+{
+	Chain_Table = CB_Table;
+	Chain_Ofs = 1;
+	return Z80C_CHAIN;
+}
+
+static int PREFIXE_ED(void)
+{
+	Chain_Table = ED_Table;
+	Chain_Ofs = 1;
+	return Z80C_CHAIN;
+}
+
+static int PREFIXE_DD(void)
+{
+	Cycles -= 4;
+	PC++;
+	Chain_Table = DD_Table;
+	Chain_Ofs = 0;
+	return Z80C_CHAIN;
+}
+
+static int PREFIXE_DDCB(void)
+{
+	Chain_Table = DDCB_Table;
+	Chain_Ofs = 2;
+	return Z80C_CHAIN;
+}
+
+static int PREFIXE_FD(void)
+{
+	Cycles -= 4;
+	PC++;
+	Chain_Table = FD_Table;
+	Chain_Ofs = 0;
+	return Z80C_CHAIN;
+}
+
+static int PREFIXE_FDCB(void)
+{
+	Chain_Table = FDCB_Table;
+	Chain_Ofs = 2;
+	return Z80C_CHAIN;
+}
+
+
+// Runs the instructions until the cycles are out (z80_Exec_Quit) or an instruction quits by itself
+static void Run(void)
+{
+	const Z80C_OP *table = OP_Table;
+	unsigned int ofs = 0;
+	UINT32 sup;
+	int c;
+
+	for(;;)
+	{
+		c = table[PC[ofs]]();
+		if(c == Z80C_CHAIN)
+		{
+			table = Chain_Table ? Chain_Table : OP_Table;
+			ofs = Chain_Ofs;
+			continue;
+		}
+		if(c == Z80C_QUIT)
+			return;
+
+		table = OP_Table;
+		ofs = 0;
+		Cycles -= c;
+		if(Cycles >= 0)
+			continue;
+
+		// z80_Exec_Quit: cycles put aside by EI or an interrupt request
+		sup = Z->CycleSup;
+		Cycles += (int)sup;
+		Z->CycleSup = 0;
+		if(Cycles < 0)
+		{
+			Quit_Halted = sup;
+			return;
+		}
+		Check_Int();
+	}
+}
+
+
+// Public functions, same as in z80.asm
+
+static UINT8 FASTCALL Def_ReadB(UINT32 adr)
+{
+	return Def_Mem[adr & 0xFFFF];
+}
+
+static UINT16 FASTCALL Def_ReadW(UINT32 adr)
+{
+	return (UINT16)(Def_Mem[adr & 0xFFFF] | Def_Mem[(adr + 1) & 0xFFFF] << 8);
+}
+
+static void FASTCALL Def_WriteB(UINT32 adr, UINT8 data)
+{
+	Def_Mem[adr & 0xFFFF] = data;
+}
+
+static void FASTCALL Def_WriteW(UINT32 adr, UINT16 data)
+{
+	Def_Mem[adr & 0xFFFF] = (UINT8)data;
+	Def_Mem[(adr + 1) & 0xFFFF] = (UINT8)(data >> 8);
+}
+
+extern "C" UINT32 FASTCALL Z80C_NAME(Init)(Z80_CONTEXT *z80)
+{
+	int i;
+
+	if(!Tables_Built)
+		Build_Tables();
+
+	memset(z80, 0, sizeof(*z80));
+	memset(Def_Mem, 0, sizeof(Def_Mem));
+	for(i = 0; i < 0x100; i++)
+	{
+		z80->ReadB[i] = Def_ReadB;
+		z80->ReadW[i] = Def_ReadW;
+		z80->WriteB[i] = Def_WriteB;
+		z80->WriteW[i] = Def_WriteW;
+		z80->Fetch[i] = Def_Mem;
+	}
+	// IN_C and OUT_C have each other's type in z80.h
+	z80->IN_C = (Z80_WB *)Def_ReadB;
+	z80->OUT_C = (Z80_RB *)Def_WriteB;
+	return 0;
+}
+
+extern "C" UINT32 FASTCALL Z80C_NAME(Reset)(Z80_CONTEXT *z80)
+{
+	UINT32 odo = z80->CycleCnt;
+
+	memset(z80, 0, offsetof(Z80_CONTEXT, ReadB));
+	z80->CycleCnt = odo;
+
+	Z = z80;
+	Rebase_PC(0);
+	Store_PC();
+	z80->IX.d = 0xFFFF;
+	z80->IY.d = 0xFFFF;
+	z80->AF.d = 0x4000;
+	return 0;
+}
+
+extern "C" UINT32 Z80C_NAME(Add_ReadB)(Z80_CONTEXT *z80, UINT32 low_adr, UINT32 high_adr, Z80_RB *Func)
+{
+	for(low_adr &= 0xFF, high_adr &= 0xFF; low_adr <= high_adr; low_adr++)
+		z80->ReadB[low_adr] = Func;
+	return 0;
+}
+
+extern "C" UINT32 Z80C_NAME(Add_ReadW)(Z80_CONTEXT *z80, UINT32 low_adr, UINT32 high_adr, Z80_RW *Func)
+{
+	for(low_adr &= 0xFF, high_adr &= 0xFF; low_adr <= high_adr; low_adr++)
+		z80->ReadW[low_adr] = Func;
+	return 0;
+}
+
+extern "C" UINT32 Z80C_NAME(Add_WriteB)(Z80_CONTEXT *z80, UINT32 low_adr, UINT32 high_adr, Z80_WB *Func)
+{
+	for(low_adr &= 0xFF, high_adr &= 0xFF; low_adr <= high_adr; low_adr++)
+		z80->WriteB[low_adr] = Func;
+	return 0;
+}
+
+extern "C" UINT32 Z80C_NAME(Add_WriteW)(Z80_CONTEXT *z80, UINT32 low_adr, UINT32 high_adr, Z80_WW *Func)
+{
+	for(low_adr &= 0xFF, high_adr &= 0xFF; low_adr <= high_adr; low_adr++)
+		z80->WriteW[low_adr] = Func;
+	return 0;
+}
+
+// the region is based so that Fetch[PC >> 8] + PC points to the byte at PC
+extern "C" UINT32 Z80C_NAME(Add_Fetch)(Z80_CONTEXT *z80, UINT32 low_adr, UINT32 high_adr, UINT8 *Region)
+{
+	UINT8 *based;
+
+	low_adr &= 0xFF;
+	high_adr &= 0xFF;
+	based = Region - (low_adr << 8);
+	for(; low_adr <= high_adr; low_adr++)
+		z80->Fetch[low_adr] = based;
+	return 0;
+}
+
+extern "C" UINT32 FASTCALL Z80C_NAME(Read_Odo)(Z80_CONTEXT *z80)
+{
+	if(z80->Status & Z80_RUNNING)
+		return z80->CycleCnt + z80->CycleTD - z80->CycleIO;
+	return z80->CycleCnt;
+}
+
+extern "C" void FASTCALL Z80C_NAME(Clear_Odo)(Z80_CONTEXT *z80)
+{
+	z80->CycleCnt = 0;
+}
+
+extern "C" void FASTCALL Z80C_NAME(Set_Odo)(Z80_CONTEXT *z80, UINT32 Odo)
+{
+	z80->CycleCnt = Odo;
+}
+
+extern "C" void FASTCALL Z80C_NAME(Add_Cycles)(Z80_CONTEXT *z80, UINT32 cycles)
+{
+	if(z80->Status & Z80_RUNNING)
+		z80->CycleIO -= cycles;
+	else
+		z80->CycleCnt += cycles;
+}
+
+// Runs until the odometer reaches odo. The interrupt cycles taken on entry come out of the
+// slice without being counted in the odometer, as in the asm.
+// A halted Z80 just has its odometer moved to odo - 1.
+extern "C" UINT32 FASTCALL Z80C_NAME(Exec)(Z80_CONTEXT *z80, int odo)
+{
+	if((UINT32)odo <= z80->CycleCnt)
+		return (UINT32)-1;
+	// the asm would run a nested call on the registers it has in its own stack frame
+	if(z80->Status & Z80_RUNNING)
+		return 0;
+
+	if(!Tables_Built)
+		Build_Tables();
+
+	Z = z80;
+	Load_PC();
+	Cycles = (int)((UINT32)odo - z80->CycleCnt - 1);
+
+	Check_Int();
+	if(z80->Status & (Z80_HALTED | Z80_FAULTED))
+	{
+		if(z80->Status & Z80_HALTED)
+			z80->CycleCnt += Cycles;
+		return 0;
+	}
+
+	z80->CycleSup = 0;
+	z80->Status |= Z80_RUNNING;
+	z80->CycleTD = Cycles;
+	Run();
+
+	// z80_Exec_Really_Quit
+	z80->CycleCnt += z80->CycleTD - (UINT32)Cycles;
+	Store_PC();
+	z80->Status &= ~Z80_RUNNING;
+	if(Quit_Halted & Z80_HALTED)
+		z80->CycleCnt += Cycles;
+	return 0;
+}
+
+extern "C" UINT32 FASTCALL Z80C_NAME(NMI)(Z80_CONTEXT *z80)
+{
+	z80->IntVect = 0x66;
+	z80->IntLine = 0x80;
+	if(z80->Status & Z80_RUNNING)
+	{
+		z80->CycleSup = z80->CycleIO;
+		z80->CycleIO = 0;
+	}
+	return 0;
+}
+
+// IntLine gets FLAG_P so that it can be tested against IFF
+extern "C" UINT32 FASTCALL Z80C_NAME(Interrupt)(Z80_CONTEXT *z80, UINT32 vector)
+{
+	z80->IntVect = (UINT8)vector;
+	z80->IntLine = FLAG_P;
+	if(z80->Status & Z80_RUNNING)
+	{
+		z80->CycleSup = z80->CycleIO;
+		z80->CycleIO = 0;
+	}
+	return 0;
+}
+
+extern "C" UINT32 FASTCALL Z80C_NAME(Get_PC)(Z80_CONTEXT *z80)
+{
+	if(z80->Status & Z80_RUNNING)
+		return (UINT32)-1;
+	return z80->PC.d - z80->BasePC;
+}
+
+extern "C" UINT32 FASTCALL Z80C_NAME(Set_PC)(Z80_CONTEXT *z80, UINT32 PC)
+{
+	if(z80->Status & Z80_RUNNING)
+		return 0;
+	Z = z80;
+	Rebase_PC(PC & 0xFFFF);
+	Store_PC();
+	return 0;
+}
+
+// X and Y are kept in FXY, F has the other flags
+static UINT32 Get_AF(UINT8 a, UINT8 f, UINT8 fxy)
+{
+	return a << 8 | (f & ~(FLAG_X | FLAG_Y)) | (fxy & (FLAG_X | FLAG_Y));
+}
+
+extern "C" UINT32 FASTCALL Z80C_NAME(Get_AF)(Z80_CONTEXT *z80)
+{
+	if(z80->Status & Z80_RUNNING)
+		return (UINT32)-1;
+	return Get_AF(z80->AF.b.A, z80->AF.b.F, z80->AF.b.FXY);
+}
+
+extern "C" UINT32 FASTCALL Z80C_NAME(Get_AF2)(Z80_CONTEXT *z80)
+{
+	if(z80->Status & Z80_RUNNING)
+		return (UINT32)-1;
+	return Get_AF(z80->AF2.b.A2, z80->AF2.b.F2, z80->AF2.b.FXY2);
+}
+
+extern "C" UINT32 FASTCALL Z80C_NAME(Set_AF)(Z80_CONTEXT *z80, UINT32 AF)
+{
+	if(z80->Status & Z80_RUNNING)
+		return 0;
+	z80->AF.b.FXY = AF & (FLAG_X | FLAG_Y);
+	z80->AF.b.F = AF & ~(FLAG_X | FLAG_Y) & 0xFF;
+	z80->AF.b.A = (UINT8)(AF >> 8);
+	return 0;
+}
+
+extern "C" UINT32 FASTCALL Z80C_NAME(Set_AF2)(Z80_CONTEXT *z80, UINT32 AF2)
+{
+	if(z80->Status & Z80_RUNNING)
+		return 0;
+	z80->AF2.b.FXY2 = AF2 & (FLAG_X | FLAG_Y);
+	z80->AF2.b.F2 = AF2 & ~(FLAG_X | FLAG_Y) & 0xFF;
+	z80->AF2.b.A2 = (UINT8)(AF2 >> 8);
+	return 0;
+}
@@ -0,0 +1,211 @@
+// Z80 core selection and lockstep check of the C++ Z80 core (z80_c.cpp) against z80.asm
+// Both cores work on the same context (M_Z80), so the C++ core can replace z80_Exec on its own.
+// To check it, the context is copied before each instruction and the C++ core runs the instruction on
+// a shadow of the Z80 RAM: reads come from Ram_Z80, writes are only logged. Then the asm runs the same
+// instruction for real and the registers, cycle count and RAM writes are compared. Instructions that
+// touch the banked 68000 memory, the YM2612 or the PSG, or take an interrupt, are only run by the asm.
+
+#include <stdio.h>
+#include <string.h>
+#include "z80_verify.h"
+#include "Mem_Z80.h"
+#include "z80.h"
+
+extern unsigned long FrameCount;
+
+int Z80_Core = Z80_CORE_ASM;
+int Z80_Verify_Mismatches = 0;
+
+#define VERIFY_MAX_REPORTS 32
+#define SHADOW_MAX_WRITES 128
+
+static unsigned int Shadow_IO;				// the instruction read or wrote something the shadow doesn't have
+static unsigned int Shadow_Writes;
+static struct { unsigned short Adr; unsigned char Data; } Shadow_Write[SHADOW_MAX_WRITES];
+
+static unsigned int Verify_Steps, Verify_Skipped;
+
+static unsigned char Shadow_Read_Byte(unsigned int adr)
+{
+	int i;
+
+	if(adr > 0x3FFF)
+	{
+		Shadow_IO = 1;
+		return 0;
+	}
+	adr &= 0x1FFF;
+	for(i = Shadow_Writes - 1; i >= 0; i--)
+		if(Shadow_Write[i].Adr == adr)
+			return Shadow_Write[i].Data;
+	return Ram_Z80[adr];
+}
+
+static unsigned short Shadow_Read_Word(unsigned int adr)
+{
+	return (unsigned short)(Shadow_Read_Byte(adr) | Shadow_Read_Byte((adr & 0xE000) | ((adr + 1) & 0x1FFF)) << 8);
+}
+
+static void Shadow_Write_Byte(unsigned int adr, unsigned char data)
+{
+	if(adr > 0x3FFF || Shadow_Writes == SHADOW_MAX_WRITES)
+	{
+		Shadow_IO = 1;
+		return;
+	}
+	Shadow_Write[Shadow_Writes].Adr = (unsigned short)(adr & 0x1FFF);
+	Shadow_Write[Shadow_Writes].Data = data;
+	Shadow_Writes++;
+}
+
+static void Shadow_Write_Word(unsigned int adr, unsigned short data)
+{
+	Shadow_Write_Byte(adr, (unsigned char)data);
+	Shadow_Write_Byte((adr & 0xE000) | ((adr + 1) & 0x1FFF), (unsigned char)(data >> 8));
+}
+
+#define Z80C_NAME(x) z80v_##x
+#define Z80C_READ_BYTE Shadow_Read_Byte
+#define Z80C_READ_WORD Shadow_Read_Word
+#define Z80C_WRITE_BYTE Shadow_Write_Byte
+#define Z80C_WRITE_WORD Shadow_Write_Word
+#include "z80_c.cpp"
+
+
+static unsigned char Fetch_Byte(unsigned int adr)
+{
+	adr &= 0xFFFF;
+	return M_Z80.Fetch[adr >> 8][adr];
+}
+
+// DAA with H set: the asm reads its result past the end of DAA_Table, nothing to compare it with
+static int Asm_Only(unsigned int pc)
+{
+	unsigned int op, n;
+
+	for(n = 0, op = Fetch_Byte(pc); (op == 0xDD || op == 0xFD) && n < 4; n++)
+		op = Fetch_Byte(++pc);
+	return op == 0x27 && (M_Z80.AF.b.F & FLAG_H);
+}
+
+// the registers as the asm keeps them, X and Y flags in FXY
+#define Z80_REGS(X)	\
+	X(AF.b.A, "A") X(AF.b.F, "F") X(AF.b.FXY, "FXY") X(BC.w.BC, "BC") X(DE.w.DE, "DE") X(HL.w.HL, "HL")	\
+	X(IX.w.IX, "IX") X(IY.w.IY, "IY") X(SP.w.SP, "SP") X(PC.d, "PC") X(BasePC, "base")	\
+	X(AF2.w.AF2, "AF'") X(AF2.b.FXY2, "FXY'") X(BC2.w.BC2, "BC'") X(DE2.w.DE2, "DE'") X(HL2.w.HL2, "HL'")	\
+	X(IFF.d, "IFF") X(R.d, "R") X(I, "I") X(IM, "IM") X(IntLine, "int") X(Status, "status") X(CycleSup, "sup")
+
+static int Compare(const Z80_CONTEXT *c, unsigned int *ram_adr)
+{
+	const Z80_CONTEXT *a = &M_Z80;
+	unsigned int i, j;
+
+#define CMP_REG(r, name) if(c->r != a->r) return 1;
+	Z80_REGS(CMP_REG)
+#undef CMP_REG
+	if(c->CycleCnt != a->CycleCnt)
+		return 1;
+
+	// the last write to each byte is what the RAM should have now
+	for(i = 0; i < Shadow_Writes; i++)
+	{
+		for(j = i + 1; j < Shadow_Writes && Shadow_Write[j].Adr != Shadow_Write[i].Adr; j++) {}
+		if(j == Shadow_Writes && Ram_Z80[Shadow_Write[i].Adr] != Shadow_Write[i].Data)
+		{
+			*ram_adr = Shadow_Write[i].Adr;
+			return 2;
+		}
+	}
+	return 0;
+}
+
+static void Report(int what, unsigned int pc, const Z80_CONTEXT *in, const Z80_CONTEXT *c, unsigned int ram_adr)
+{
+	const Z80_CONTEXT *a = &M_Z80;
+
+	if(++Z80_Verify_Mismatches > VERIFY_MAX_REPORTS)
+		return;
+
+	fprintf(stderr, "z80 verify: frame %lu: instruction at %04X (%02X %02X %02X %02X)", FrameCount, pc,
+		Fetch_Byte(pc), Fetch_Byte(pc + 1), Fetch_Byte(pc + 2), Fetch_Byte(pc + 3));
+	if(what == 2)
+	{
+		fprintf(stderr, ": RAM %04X is %02X, asm has %02X\n",
+			ram_adr, Shadow_Read_Byte(ram_adr), Ram_Z80[ram_adr]);
+	}
+	else
+	{
+		fprintf(stderr, ", C / asm:");
+#define PRINT_REG(r, name) if(c->r != a->r) fprintf(stderr, " %s %X/%X", name, (unsigned int)c->r, (unsigned int)a->r);
+		Z80_REGS(PRINT_REG)
+#undef PRINT_REG
+		if(c->CycleCnt != a->CycleCnt)
+			fprintf(stderr, " cycles %u/%u", c->CycleCnt - in->CycleCnt, a->CycleCnt - in->CycleCnt);
+		fprintf(stderr, "\n");
+	}
+	if(Z80_Verify_Mismatches == VERIFY_MAX_REPORTS)
+		fprintf(stderr, "z80 verify: further mismatches are only counted\n");
+}
+
+static void Z80_Verify_Exec(int Odo)
+{
+	Z80_CONTEXT in, out_c;
+	unsigned int odo, pc, ram_adr = 0;
+	int what;
+
+	while((odo = z80_Read_Odo(&M_Z80)) < (unsigned int)Odo)
+	{
+		// halted: the asm just counts the cycles
+		if(M_Z80.Status & (Z80_HALTED | Z80_FAULTED))
+		{
+			z80_Exec(&M_Z80, Odo);
+			return;
+		}
+
+		// an interrupt is taken first, or the asm result can't be reproduced
+		pc = z80_Get_PC(&M_Z80) & 0xFFFF;
+		if((M_Z80.IntLine & 0x80) || (M_Z80.IntLine & M_Z80.IFF.b.IFF2) || Asm_Only(pc))
+		{
+			Verify_Skipped++;
+			z80_Exec(&M_Z80, odo + 1);
+			continue;
+		}
+
+		memcpy(&in, &M_Z80, sizeof(in));
+		memcpy(&out_c, &in, sizeof(out_c));
+		Shadow_IO = 0;
+		Shadow_Writes = 0;
+		z80v_Exec(&out_c, odo + 1);
+
+		z80_Exec(&M_Z80, odo + 1);
+
+		if(Shadow_IO)
+			Verify_Skipped++;
+		else
+		{
+			Verify_Steps++;
+			what = Compare(&out_c, &ram_adr);
+			if(what)
+				Report(what, pc, &in, &out_c, ram_adr);
+		}
+	}
+}
+
+void Z80_Core_Exec(int Odo)
+{
+	if(Z80_Core == Z80_CORE_VERIFY)
+		Z80_Verify_Exec(Odo);
+	else if(Z80_Core == Z80_CORE_C)
+		z80c_Exec(&M_Z80, Odo);
+	else
+		z80_Exec(&M_Z80, Odo);
+}
+
+void Z80_Verify_Report(void)
+{
+	if(Z80_Core != Z80_CORE_VERIFY || !(Verify_Steps + Verify_Skipped))
+		return;
+
+	fprintf(stderr, "z80 verify: %u instructions compared, %u run by the asm only (I/O, interrupt or DAA with H), %d mismatches\n",
+		Verify_Steps, Verify_Skipped, Z80_Verify_Mismatches);
+}
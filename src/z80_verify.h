@@ -0,0 +1,17 @@
+#ifndef Z80_VERIFY_H
+#define Z80_VERIFY_H
+
+// Z80 core selection (z80_verify.cpp)
+enum {
+	Z80_CORE_ASM = 0,	// z80.asm
+	Z80_CORE_C,			// the C++ core (z80_c.cpp) on the same context
+	Z80_CORE_VERIFY,	// run every instruction with both, report when the C++ core ends up elsewhere
+};
+extern int Z80_Core;
+extern int Z80_Verify_Mismatches;
+
+// z80_Exec(&M_Z80, Odo) with the selected core
+void Z80_Core_Exec(int Odo);
+void Z80_Verify_Report(void);
+
+#endif